@@ -0,0 +1,166 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+
+#include "Benchmarks/Benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/thread.hpp>
+#include <tbb/concurrent_queue.h>
+
+#include "Utils/ActiveObject.h"
+
+namespace {
+
+/*! utils::ActiveObject before it moved onto the shared executor, kept for
+ * comparison. Every instance owns a thread that polls its queue every
+ * millisecond.
+ */
+class LegacyActiveObject {
+public:
+    typedef std::function<void()> Message;
+
+    LegacyActiveObject() : done_(false) {
+        thread_ = boost::thread([=] { this->Run(); });
+    }
+
+    ~LegacyActiveObject() {
+        Send([&] { done_ = true; });
+        thread_.join();
+    }
+
+    void Send(Message message) {
+        message_queue_.push(message);
+        condition_.notify_one();
+    }
+
+private:
+    void Run() {
+        Message message;
+
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        while (! done_) {
+            if (condition_.timed_wait(lock, boost::get_system_time() + boost::posix_time::milliseconds(1),
+                    [this, &message] { return message_queue_.try_pop(message); })) {
+                message();
+            }
+        }
+    }
+
+    tbb::concurrent_queue<Message> message_queue_;
+
+    boost::thread thread_;
+    boost::condition_variable condition_;
+    boost::mutex mutex_;
+
+    bool done_;
+};
+
+// Roughly the active objects of a zone: a socket writer per service, the
+// event dispatcher, the spatial index and the database workers.
+const uint32_t kObjects = 16;
+const uint32_t kMessagesPerObject = 20000;
+
+// Wake latency is measured on an idle object, the pause lets it go to sleep.
+const uint32_t kWakeSamples = 200;
+const std::chrono::milliseconds kIdlePause(3);
+
+void WaitFor(const std::atomic<uint64_t>& counter, uint64_t value) {
+    while (counter.load(std::memory_order_acquire) < value) {
+        std::this_thread::yield();
+    }
+}
+
+template<typename Object>
+void RunThroughput(const char* variant) {
+    std::vector<std::unique_ptr<Object>> objects;
+
+    for (uint32_t i = 0; i < kObjects; ++i) {
+        objects.push_back(std::unique_ptr<Object>(new Object()));
+    }
+
+    std::atomic<uint64_t> handled(0);
+    uint64_t total = static_cast<uint64_t>(kObjects) * kMessagesPerObject;
+
+    benchmarks::Measurement measurement;
+    measurement.Start();
+
+    for (uint32_t message = 0; message < kMessagesPerObject; ++message) {
+        for (uint32_t i = 0; i < kObjects; ++i) {
+            objects[i]->Send([&handled] { handled.fetch_add(1, std::memory_order_release); });
+        }
+    }
+
+    WaitFor(handled, total);
+
+    measurement.Stop();
+
+    benchmarks::Report("active_object_send", variant, measurement, total);
+}
+
+template<typename Object>
+void RunWakeLatency(const char* variant) {
+    Object object;
+    std::atomic<uint64_t> handled(0);
+
+    benchmarks::Measurement measurement;
+
+    for (uint32_t sample = 1; sample <= kWakeSamples; ++sample) {
+        std::this_thread::sleep_for(kIdlePause);
+
+        measurement.Start();
+
+        object.Send([&handled] { handled.fetch_add(1, std::memory_order_release); });
+        WaitFor(handled, sample);
+
+        measurement.Stop();
+    }
+
+    benchmarks::Report("active_object_wake", variant, measurement, kWakeSamples);
+}
+
+}  // namespace
+
+namespace benchmarks {
+
+void RunActiveObjectBenchmark() {
+    RunThroughput<LegacyActiveObject>("legacy");
+    RunThroughput<utils::ActiveObject>("strand");
+
+    RunWakeLatency<LegacyActiveObject>("legacy");
+    RunWakeLatency<utils::ActiveObject>("strand");
+}
+
+}  // namespace benchmarks
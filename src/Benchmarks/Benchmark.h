@@ -0,0 +1,80 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_BENCHMARKS_BENCHMARK_H_
+#define SRC_BENCHMARKS_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*! \brief Micro benchmarks comparing new core code paths against the
+ * implementations they replace. Every benchmark is a plain function listed in
+ * main.cpp, run them all or name the ones to run on the command line.
+ */
+namespace benchmarks {
+
+/// \returns The number of heap allocations made by the process so far.
+uint64_t allocation_count();
+
+/*! Measures the wall time and heap allocations of a section of code.
+ */
+class Measurement {
+public:
+    Measurement();
+
+    /// Starts or resumes measuring.
+    void Start();
+
+    /// Pauses measuring, setup work between Stop and Start is not counted.
+    void Stop();
+
+    uint64_t elapsed_ns() const { return elapsed_ns_; }
+    uint64_t allocations() const { return allocations_; }
+
+private:
+    std::chrono::steady_clock::time_point started_at_;
+    uint64_t allocations_at_start_;
+
+    uint64_t elapsed_ns_;
+    uint64_t allocations_;
+};
+
+/**
+ * Prints a single result line.
+ *
+ * \param benchmark The benchmark the result belongs to.
+ * \param variant The implementation that was measured.
+ * \param measurement The measured section.
+ * \param operations The number of operations the section performed.
+ */
+void Report(const std::string& benchmark, const std::string& variant, const Measurement& measurement, uint64_t operations);
+
+}  // namespace benchmarks
+
+#endif  // SRC_BENCHMARKS_BENCHMARK_H_
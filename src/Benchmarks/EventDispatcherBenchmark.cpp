@@ -0,0 +1,216 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "Benchmarks/Benchmark.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "Common/EventDispatcherCore.h"
+
+using common::EventDispatcherCore;
+using common::EventListener;
+using common::EventListenerType;
+using common::EventQueue;
+using common::EventType;
+using common::IEventPtr;
+using common::SimpleEvent;
+
+namespace {
+
+/*! The tick loop of common::EventDispatcher before the timer wheel was added,
+ * kept for comparison. Every pending event is popped and pushed back on every
+ * tick and each delivery copies the listener list.
+ */
+class LegacyDispatcherCore {
+public:
+    explicit LegacyDispatcherCore(uint64_t current_time)
+        : current_timestep_(current_time)
+        , active_queue_(0) {}
+
+    void Connect(const EventType& event_type, EventListener listener) {
+        event_listener_map_[event_type].push_back(listener);
+    }
+
+    void Notify(IEventPtr triggered_event) {
+        if (!triggered_event->timestamp()) {
+            triggered_event->timestamp(current_timestep_);
+        }
+
+        event_queue_[active_queue_].push(triggered_event);
+    }
+
+    bool Tick(uint64_t new_timestep) {
+        if (current_timestep_ >= new_timestep) return false;
+
+        current_timestep_ = new_timestep;
+
+        int queue_to_process = active_queue_;
+        active_queue_ = (active_queue_ + 1) % 2;
+
+        while(event_queue_[queue_to_process].size() > 0) {
+            IEventPtr event_to_process = event_queue_[queue_to_process].top();
+            event_queue_[queue_to_process].pop();
+
+            if ((event_to_process->timestamp() + event_to_process->delay_ms()) <= current_timestep_) {
+                Deliver(event_to_process);
+            } else {
+                event_queue_[active_queue_].push(event_to_process);
+            }
+        }
+
+        return true;
+    }
+
+    bool Deliver(IEventPtr triggered_event) {
+        bool delivered = true;
+
+        auto listener_it = event_listener_map_.find(EventType(common::kWildCardHashString));
+
+        if (listener_it != event_listener_map_.end()) {
+            auto listeners = listener_it->second;
+
+            for (auto it = listeners.begin(), end = listeners.end(); it != end; ++it) {
+                (*it).second(triggered_event);
+            }
+        }
+
+        listener_it = event_listener_map_.find(triggered_event->event_type());
+
+        if (listener_it != event_listener_map_.end()) {
+            auto listeners = listener_it->second;
+
+            for (auto it = listeners.begin(), end = listeners.end(); it != end; ++it) {
+                if (!(*it).second(triggered_event)) {
+                    delivered = false;
+                }
+            }
+        }
+
+        triggered_event->consume(delivered);
+
+        IEventPtr next_event = triggered_event->next();
+
+        if (next_event) {
+            Notify(next_event);
+        }
+
+        return delivered;
+    }
+
+private:
+    std::map<EventType, std::list<EventListener>> event_listener_map_;
+
+    uint64_t current_timestep_;
+
+    EventQueue event_queue_[2];
+    int active_queue_;
+};
+
+// A zone's worth of buffs and state events: most events wait for seconds to
+// minutes, a few are delivered right away every tick.
+const uint32_t kPendingEvents = 20000;
+const uint32_t kImmediateEventsPerTick = 50;
+const uint32_t kTicks = 1000;
+const uint64_t kTickMs = 10;
+const uint64_t kMinDelayMs = 1000;
+const uint64_t kMaxDelayMs = 600000;
+
+template<typename Dispatcher>
+void RunScenario(const char* variant) {
+    const EventType delayed_type("benchmark_delayed_event");
+    const EventType immediate_type("benchmark_immediate_event");
+
+    Dispatcher dispatcher(1);
+    uint64_t delivered = 0;
+
+    // Every delayed event that fires is replaced by a new one, which keeps the
+    // number of pending events constant.
+    auto count = [&delivered] (IEventPtr) -> bool {
+        ++delivered;
+        return true;
+    };
+
+    dispatcher.Connect(delayed_type, EventListener(EventListenerType("delayed_listener"), count));
+    dispatcher.Connect(immediate_type, EventListener(EventListenerType("immediate_listener"), [] (IEventPtr) { return true; }));
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<uint64_t> delay(kMinDelayMs, kMaxDelayMs);
+
+    for (uint32_t i = 0; i < kPendingEvents; ++i) {
+        dispatcher.Notify(std::make_shared<SimpleEvent>(delayed_type, 0, delay(random)));
+    }
+
+    std::vector<IEventPtr> next_events;
+    next_events.reserve(kImmediateEventsPerTick + kPendingEvents);
+
+    benchmarks::Measurement measurement;
+    uint64_t replaced = 0;
+
+    for (uint32_t tick = 1; tick <= kTicks; ++tick) {
+        // Create this tick's events outside of the measured section, only the
+        // dispatcher's own work is of interest.
+        next_events.clear();
+
+        for (uint32_t i = 0; i < kImmediateEventsPerTick; ++i) {
+            next_events.push_back(std::make_shared<SimpleEvent>(immediate_type));
+        }
+
+        for (; replaced < delivered; ++replaced) {
+            next_events.push_back(std::make_shared<SimpleEvent>(delayed_type, 0, delay(random)));
+        }
+
+        measurement.Start();
+
+        for (auto it = next_events.begin(), end = next_events.end(); it != end; ++it) {
+            dispatcher.Notify(*it);
+        }
+
+        dispatcher.Tick(1 + tick * kTickMs);
+
+        measurement.Stop();
+    }
+
+    benchmarks::Report("event_dispatcher_tick", variant, measurement, kTicks);
+}
+
+}  // namespace
+
+namespace benchmarks {
+
+void RunEventDispatcherBenchmark() {
+    RunScenario<LegacyDispatcherCore>("legacy");
+    RunScenario<EventDispatcherCore>("timer_wheel");
+}
+
+}  // namespace benchmarks
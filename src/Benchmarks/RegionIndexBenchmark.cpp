@@ -0,0 +1,293 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+
+#include "Benchmarks/Benchmark.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "ZoneServer/RegionIndex.h"
+
+using zone::RegionBounds;
+using zone::RegionIndex;
+
+namespace {
+
+// The zmap grid the regions used to be bucketed in.
+const uint32_t kGridWidth = 410;
+const uint32_t kGridHeight = 410;
+const uint32_t kMapWidth = 16400;
+const uint32_t kMapHeight = 16400;
+
+struct Region {
+    uint64_t id;
+    float x;
+    float z;
+    float width;
+    float height;
+    uint64_t visits;
+};
+
+/*! The region upkeep of zmap before the region index was added, kept for
+ * comparison. Every id lookup scans the whole region multimap and the regions
+ * are listed per zmap cell.
+ */
+class LegacyRegionMap {
+public:
+    LegacyRegionMap() {
+        uint32_t i = 0;
+
+        for (uint32_t x = 0; x <= kGridWidth; ++x) {
+            for (uint32_t j = 0; j <= kGridHeight; ++j) {
+                lookup_[x][j] = i;
+                cells_.insert(std::make_pair(i, std::list<std::shared_ptr<Region>>()));
+                ++i;
+            }
+        }
+    }
+
+    void AddRegion(std::shared_ptr<Region> region) {
+        uint32_t low_x = static_cast<uint32_t>(region->x);
+        uint32_t low_z = static_cast<uint32_t>(region->z);
+        uint32_t width = static_cast<uint32_t>(region->width);
+        uint32_t height = static_cast<uint32_t>(region->height);
+
+        uint32_t lower_left = GetCellId(low_x, low_z);
+        uint32_t lower_right = GetCellId(low_x + width, low_z);
+        uint32_t upper_left = GetCellId(low_x, low_z + height);
+
+        int cell_count_z = (upper_left - lower_left) / kGridWidth;
+        int cell_count_x = (lower_right - lower_left);
+
+        for (int i = 0; i <= cell_count_z; ++i) {
+            for (int j = 0; j <= cell_count_x; ++j) {
+                auto it = cells_.find(lower_left + j + i * kGridWidth);
+                if (it != cells_.end()) {
+                    it->second.push_back(region);
+                }
+            }
+        }
+
+        regions_.insert(std::make_pair(region->id, region));
+    }
+
+    void UpdateRegions(float x, float z, std::set<uint64_t>& region_set) {
+        auto region_set_it = region_set.begin();
+
+        while (region_set_it != region_set.end()) {
+            auto region = FindRegion(*region_set_it);
+
+            if (!region || !IsInRegion(x, z, region)) {
+                region_set.erase(region_set_it++);
+                continue;
+            }
+
+            ++region_set_it;
+        }
+
+        std::list<std::shared_ptr<Region>>& list = cells_[GetCellId(x, z)];
+
+        std::for_each(list.begin(), list.end(), [&] (std::shared_ptr<Region> region) {
+            if (region_set.find(region->id) == region_set.end() && IsInRegion(x, z, region)) {
+                region_set.insert(region->id);
+                ++region->visits;
+            }
+        });
+    }
+
+private:
+    std::shared_ptr<Region> FindRegion(uint64_t id) {
+        auto it = std::find_if(regions_.begin(), regions_.end(), [id] (const std::multimap<uint32_t, std::shared_ptr<Region>>::value_type& entry) {
+            return entry.second->id == id;
+        });
+
+        return (it != regions_.end()) ? it->second : nullptr;
+    }
+
+    static bool IsInRegion(float x, float z, const std::shared_ptr<Region>& region) {
+        return x >= region->x && x <= region->x + region->height &&
+               z >= region->z && z <= region->z + region->width;
+    }
+
+    uint32_t GetCellId(float x, float z) {
+        return lookup_[((static_cast<uint32_t>(z) + (kMapWidth / 2)) / kGridWidth)][((static_cast<uint32_t>(x) + (kMapHeight / 2)) / kGridHeight)];
+    }
+
+    uint32_t lookup_[kGridWidth + 1][kGridHeight + 1];
+    std::map<uint32_t, std::list<std::shared_ptr<Region>>> cells_;
+    std::multimap<uint32_t, std::shared_ptr<Region>> regions_;
+};
+
+/*! The same upkeep on top of zone::RegionIndex, the way zmap does it now.
+ */
+class IndexedRegionMap {
+public:
+    IndexedRegionMap()
+        : index_(static_cast<float>(kMapWidth), 128.0f) {}
+
+    void AddRegion(std::shared_ptr<Region> region) {
+        index_.Insert(region->id, RegionBounds::FromExtents(region->x, region->z, region->width, region->height));
+        regions_[region->id] = region;
+    }
+
+    void UpdateRegions(float x, float z, std::set<uint64_t>& region_set) {
+        auto region_set_it = region_set.begin();
+
+        while (region_set_it != region_set.end()) {
+            if (regions_.find(*region_set_it) == regions_.end() || !index_.Contains(*region_set_it, x, z)) {
+                region_set.erase(region_set_it++);
+                continue;
+            }
+
+            ++region_set_it;
+        }
+
+        index_.Query(x, z, [this, &region_set] (uint64_t region_id) {
+            if (region_set.insert(region_id).second) {
+                ++regions_[region_id]->visits;
+            }
+        });
+    }
+
+private:
+    RegionIndex index_;
+    std::unordered_map<uint64_t, std::shared_ptr<Region>> regions_;
+};
+
+struct RegionKind {
+    uint32_t count;
+    float min_size;
+    float max_size;
+};
+
+// A busy planet: badge areas and camps are small, spawn regions and cities
+// cover large parts of the map.
+const RegionKind kRegionKinds[] = {
+    { 2000, 16.0f, 64.0f },     // badge
+    { 3000, 256.0f, 1024.0f },  // spawn
+    { 200, 512.0f, 1536.0f },   // city
+    { 1000, 8.0f, 32.0f },      // camp
+};
+
+const uint32_t kMovingObjects = 2000;
+const uint32_t kMovementsPerObject = 50;
+const float kStep = 8.0f;
+const float kPlayableHalfWidth = 7500.0f;
+
+std::vector<std::shared_ptr<Region>> CreateRegions() {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-kPlayableHalfWidth, kPlayableHalfWidth - 1600.0f);
+
+    std::vector<std::shared_ptr<Region>> regions;
+    uint64_t id = 1;
+
+    for (const RegionKind& kind : kRegionKinds) {
+        std::uniform_real_distribution<float> size(kind.min_size, kind.max_size);
+
+        for (uint32_t i = 0; i < kind.count; ++i) {
+            std::shared_ptr<Region> region = std::make_shared<Region>();
+            region->id = id++;
+            region->x = position(random);
+            region->z = position(random);
+            region->width = size(random);
+            region->height = size(random);
+            region->visits = 0;
+
+            regions.push_back(region);
+        }
+    }
+
+    return regions;
+}
+
+template<typename RegionMap>
+void RunScenario(const char* variant) {
+    RegionMap region_map;
+
+    std::vector<std::shared_ptr<Region>> regions = CreateRegions();
+    std::for_each(regions.begin(), regions.end(), [&region_map] (std::shared_ptr<Region> region) {
+        region_map.AddRegion(region);
+    });
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-kPlayableHalfWidth, kPlayableHalfWidth);
+    std::uniform_real_distribution<float> step(-kStep, kStep);
+
+    struct Mover {
+        float x;
+        float z;
+        std::set<uint64_t> regions;
+    };
+
+    std::vector<Mover> movers(kMovingObjects);
+    for (Mover& mover : movers) {
+        mover.x = position(random);
+        mover.z = position(random);
+        region_map.UpdateRegions(mover.x, mover.z, mover.regions);
+    }
+
+    // Pick the steps up front, only the region upkeep is measured.
+    std::vector<float> steps(kMovingObjects * kMovementsPerObject * 2);
+    std::generate(steps.begin(), steps.end(), [&] { return step(random); });
+
+    benchmarks::Measurement measurement;
+    measurement.Start();
+
+    auto next_step = steps.begin();
+    for (uint32_t movement = 0; movement < kMovementsPerObject; ++movement) {
+        for (Mover& mover : movers) {
+            mover.x = std::max(-kPlayableHalfWidth, std::min(kPlayableHalfWidth, mover.x + *next_step++));
+            mover.z = std::max(-kPlayableHalfWidth, std::min(kPlayableHalfWidth, mover.z + *next_step++));
+
+            region_map.UpdateRegions(mover.x, mover.z, mover.regions);
+        }
+    }
+
+    measurement.Stop();
+
+    benchmarks::Report("region_update", variant, measurement, kMovingObjects * kMovementsPerObject);
+}
+
+}  // namespace
+
+namespace benchmarks {
+
+void RunRegionIndexBenchmark() {
+    RunScenario<LegacyRegionMap>("legacy");
+    RunScenario<IndexedRegionMap>("region_index");
+}
+
+}  // namespace benchmarks
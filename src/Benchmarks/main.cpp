@@ -0,0 +1,138 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "Benchmarks/Benchmark.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations(0);
+
+}  // namespace
+
+// Count every heap allocation so benchmarks can report allocations per operation.
+void* operator new(std::size_t size) {
+    ++allocations;
+
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace benchmarks {
+
+void RunActiveObjectBenchmark();
+void RunEventDispatcherBenchmark();
+void RunRegionIndexBenchmark();
+
+uint64_t allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+Measurement::Measurement()
+    : allocations_at_start_(0)
+    , elapsed_ns_(0)
+    , allocations_(0) {}
+
+void Measurement::Start() {
+    allocations_at_start_ = allocation_count();
+    started_at_ = std::chrono::steady_clock::now();
+}
+
+void Measurement::Stop() {
+    auto elapsed = std::chrono::steady_clock::now() - started_at_;
+
+    elapsed_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    allocations_ += allocation_count() - allocations_at_start_;
+}
+
+void Report(const std::string& benchmark, const std::string& variant, const Measurement& measurement, uint64_t operations) {
+    if (!operations) {
+        operations = 1;
+    }
+
+    std::printf("%-24s %-12s %12.1f ns/op %10.2f allocs/op\n",
+        benchmark.c_str(), variant.c_str(),
+        static_cast<double>(measurement.elapsed_ns()) / operations,
+        static_cast<double>(measurement.allocations()) / operations);
+}
+
+}  // namespace benchmarks
+
+namespace {
+
+struct BenchmarkEntry {
+    const char* name;
+    void (*run)();
+};
+
+const BenchmarkEntry kBenchmarks[] = {
+    { "event_dispatcher", &benchmarks::RunEventDispatcherBenchmark },
+    { "active_object", &benchmarks::RunActiveObjectBenchmark },
+    { "region_index", &benchmarks::RunRegionIndexBenchmark },
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    //set stdout buffers to 0 to force instant flush
+    setvbuf( stdout, NULL, _IONBF, 0);
+
+    for (const BenchmarkEntry& entry : kBenchmarks) {
+        bool selected = (argc < 2);
+
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], entry.name) == 0) {
+                selected = true;
+            }
+        }
+
+        if (selected) {
+            entry.run();
+        }
+    }
+
+    return 0;
+}
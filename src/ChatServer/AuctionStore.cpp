@@ -0,0 +1,435 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "AuctionStore.h"
+
+#include <algorithm>
+
+//======================================================================================================================
+
+template<typename Index, typename Key>
+void AuctionStore::_unindex(Index& index, Key key, uint64 auctionId)
+{
+    std::pair<typename Index::iterator, typename Index::iterator> range = index.equal_range(key);
+
+    for(typename Index::iterator it = range.first; it != range.second; ++it)
+    {
+        if(it->second == auctionId)
+        {
+            index.erase(it);
+            return;
+        }
+    }
+}
+
+//======================================================================================================================
+
+void AuctionStore::insert(const AuctionItem& auction)
+{
+    AuctionMap::iterator it = mAuctions.find(auction.ItemID);
+
+    if(it != mAuctions.end())
+    {
+        _unindexAll(it->second);
+        it->second = auction;
+    }
+    else
+    {
+        mAuctions.insert(std::make_pair(auction.ItemID, auction));
+    }
+
+    mCategoryIndex.insert(std::make_pair(auction.Category >> 8, auction.ItemID));
+    mItemTypeIndex.insert(std::make_pair(auction.ItemTyp, auction.ItemID));
+    mRegionIndex.insert(std::make_pair(static_cast<uint32>(auction.RegionID), auction.ItemID));
+    mPlanetIndex.insert(std::make_pair(static_cast<uint32>(auction.PlanetID), auction.ItemID));
+    mBazaarIndex.insert(std::make_pair(auction.BazaarID, auction.ItemID));
+    mOwnerIndex.insert(std::make_pair(auction.OwnerID, auction.ItemID));
+
+    // only running listings and items in holding are handled by the expiry procedures
+    if(auction.AuctionTyp == TRMVendor_Auction || auction.AuctionTyp == TRMVendor_Instant || auction.AuctionTyp == TRMVendor_Ended)
+    {
+        mExpiry.push(std::make_pair(auction.EndTime, auction.ItemID));
+    }
+}
+
+//======================================================================================================================
+
+void AuctionStore::_unindexAll(const AuctionItem& auction)
+{
+    _unindex(mCategoryIndex, auction.Category >> 8, auction.ItemID);
+    _unindex(mItemTypeIndex, auction.ItemTyp, auction.ItemID);
+    _unindex(mRegionIndex, static_cast<uint32>(auction.RegionID), auction.ItemID);
+    _unindex(mPlanetIndex, static_cast<uint32>(auction.PlanetID), auction.ItemID);
+    _unindex(mBazaarIndex, auction.BazaarID, auction.ItemID);
+    _unindex(mOwnerIndex, auction.OwnerID, auction.ItemID);
+
+    // the expiry entry goes stale and is dropped lazily
+}
+
+//======================================================================================================================
+
+void AuctionStore::remove(uint64 auctionId)
+{
+    AuctionMap::iterator it = mAuctions.find(auctionId);
+
+    if(it == mAuctions.end())
+    {
+        return;
+    }
+
+    _unindexAll(it->second);
+    clearBids(auctionId);
+
+    mAuctions.erase(it);
+}
+
+//======================================================================================================================
+
+void AuctionStore::clear()
+{
+    mAuctions.clear();
+    mCategoryIndex.clear();
+    mItemTypeIndex.clear();
+    mRegionIndex.clear();
+    mPlanetIndex.clear();
+    mBazaarIndex.clear();
+    mOwnerIndex.clear();
+    mBidderIndex.clear();
+    mAuctionBidders.clear();
+    mExpiry = ExpiryHeap();
+}
+
+//======================================================================================================================
+
+const AuctionItem* AuctionStore::find(uint64 auctionId) const
+{
+    AuctionMap::const_iterator it = mAuctions.find(auctionId);
+
+    if(it == mAuctions.end())
+    {
+        return NULL;
+    }
+
+    return &it->second;
+}
+
+//======================================================================================================================
+
+void AuctionStore::setBid(uint64 auctionId, const std::string& bidderName, uint32 proxy, uint32 maxBid)
+{
+    if(bidderName.empty())
+    {
+        return;
+    }
+
+    AuctionBid& bid = mBidderIndex[bidderName][auctionId];
+    bid.Proxy	= proxy;
+    bid.MaxBid	= maxBid;
+
+    mAuctionBidders[auctionId].insert(bidderName);
+}
+
+//======================================================================================================================
+
+void AuctionStore::clearBids(uint64 auctionId)
+{
+    AuctionBidders::iterator it = mAuctionBidders.find(auctionId);
+
+    if(it == mAuctionBidders.end())
+    {
+        return;
+    }
+
+    std::set<std::string>::iterator nameIt = it->second.begin();
+    while(nameIt != it->second.end())
+    {
+        BidderIndex::iterator bidderIt = mBidderIndex.find(*nameIt);
+
+        if(bidderIt != mBidderIndex.end())
+        {
+            bidderIt->second.erase(auctionId);
+
+            if(bidderIt->second.empty())
+                mBidderIndex.erase(bidderIt);
+        }
+
+        ++nameIt;
+    }
+
+    mAuctionBidders.erase(it);
+}
+
+//======================================================================================================================
+
+const AuctionBid* AuctionStore::findBid(uint64 auctionId, const std::string& bidderName) const
+{
+    BidderIndex::const_iterator bidderIt = mBidderIndex.find(bidderName);
+
+    if(bidderIt == mBidderIndex.end())
+    {
+        return NULL;
+    }
+
+    BidMap::const_iterator it = bidderIt->second.find(auctionId);
+
+    if(it == bidderIt->second.end())
+    {
+        return NULL;
+    }
+
+    return &it->second;
+}
+
+//======================================================================================================================
+//
+// mirrors the WHERE clause the query headers handler used to build
+//
+
+bool AuctionStore::_matches(const AuctionItem& auction, const AuctionSearch& search) const
+{
+    if(auction.EndTime <= search.Now)
+        return false;
+
+    switch(search.RegionType)
+    {
+    case TRMVendor:
+        if(auction.BazaarID != search.BazaarID)
+            return false;
+        break;
+
+    case TRMRegion:
+        if(auction.RegionID != search.RegionID)
+            return false;
+        break;
+
+    case TRMPlanet:
+        if(auction.PlanetID != search.PlanetID)
+            return false;
+        break;
+
+    default:
+        break;
+    }
+
+    bool forSale = (auction.AuctionTyp == TRMVendor_Auction) || (auction.AuctionTyp == TRMVendor_Instant);
+
+    switch(search.Window)
+    {
+    case TRMVendor_AllAuctions:
+        if(!forSale)
+            return false;
+        break;
+
+    case TRMVendor_MySales:
+        if(!forSale || auction.OwnerID != search.CharID)
+            return false;
+        break;
+
+    case TRMVendor_MyBids:
+    {
+        if(!forSale || !findBid(auction.ItemID, search.CharName))
+            return false;
+    }
+    break;
+
+    case TRMVendor_AvailableItems:
+        if(auction.AuctionTyp != TRMVendor_Ended || auction.OwnerID != search.CharID)
+            return false;
+        break;
+
+    case TRMVendor_Offers:
+        if(auction.AuctionTyp != TRMVendor_Offer || search.CharName != auction.bidder_name || auction.BazaarID != search.BazaarID)
+            return false;
+        break;
+
+    case TRMVendor_ForSale:
+        if(!forSale || search.CharName != auction.bidder_name || auction.BazaarID != search.BazaarID)
+            return false;
+        break;
+
+    default:
+        break;
+    }
+
+    if(search.Category != 0)
+    {
+        // a main category has no subcategory bits set
+        if((search.Category << 24) == 0)
+        {
+            if((auction.Category >> 8) != (search.Category >> 8))
+                return false;
+        }
+        else if(auction.Category != search.Category)
+        {
+            return false;
+        }
+    }
+
+    if(search.ItemTyp != 0 && auction.ItemTyp != search.ItemTyp)
+        return false;
+
+    return true;
+}
+
+//======================================================================================================================
+
+bool AuctionStore::search(const AuctionSearch& search, AuctionResultList& results) const
+{
+    // narrow the candidates with the most selective index the search allows,
+    // _matches still applies every criterion afterwards
+    std::vector<uint64> candidates;
+    bool scanAll = false;
+
+    if(search.Window == TRMVendor_MySales || search.Window == TRMVendor_AvailableItems)
+    {
+        std::pair<Index64::const_iterator, Index64::const_iterator> range = mOwnerIndex.equal_range(search.CharID);
+        for(Index64::const_iterator it = range.first; it != range.second; ++it)
+            candidates.push_back(it->second);
+    }
+    else if(search.Window == TRMVendor_MyBids)
+    {
+        BidderIndex::const_iterator it = mBidderIndex.find(search.CharName);
+        if(it != mBidderIndex.end())
+        {
+            for(BidMap::const_iterator bidIt = it->second.begin(); bidIt != it->second.end(); ++bidIt)
+                candidates.push_back(bidIt->first);
+        }
+    }
+    else if(search.RegionType == TRMVendor || search.Window == TRMVendor_Offers || search.Window == TRMVendor_ForSale)
+    {
+        std::pair<Index64::const_iterator, Index64::const_iterator> range = mBazaarIndex.equal_range(search.BazaarID);
+        for(Index64::const_iterator it = range.first; it != range.second; ++it)
+            candidates.push_back(it->second);
+    }
+    else if(search.ItemTyp != 0)
+    {
+        std::pair<Index32::const_iterator, Index32::const_iterator> range = mItemTypeIndex.equal_range(search.ItemTyp);
+        for(Index32::const_iterator it = range.first; it != range.second; ++it)
+            candidates.push_back(it->second);
+    }
+    else if(search.Category != 0)
+    {
+        std::pair<Index32::const_iterator, Index32::const_iterator> range = mCategoryIndex.equal_range(search.Category >> 8);
+        for(Index32::const_iterator it = range.first; it != range.second; ++it)
+            candidates.push_back(it->second);
+    }
+    else if(search.RegionType == TRMRegion)
+    {
+        std::pair<Index32::const_iterator, Index32::const_iterator> range = mRegionIndex.equal_range(search.RegionID);
+        for(Index32::const_iterator it = range.first; it != range.second; ++it)
+            candidates.push_back(it->second);
+    }
+    else if(search.RegionType == TRMPlanet)
+    {
+        std::pair<Index32::const_iterator, Index32::const_iterator> range = mPlanetIndex.equal_range(search.PlanetID);
+        for(Index32::const_iterator it = range.first; it != range.second; ++it)
+            candidates.push_back(it->second);
+    }
+    else
+    {
+        scanAll = true;
+    }
+
+    uint32 skipped = 0;
+
+    if(scanAll)
+    {
+        for(AuctionMap::const_iterator it = mAuctions.begin(); it != mAuctions.end(); ++it)
+        {
+            if(!_matches(it->second, search))
+                continue;
+
+            if(skipped++ < search.Start)
+                continue;
+
+            if(results.size() == search.PageSize)
+                return true;
+
+            results.push_back(&it->second);
+        }
+
+        return false;
+    }
+
+    // page in auction id order, same as a full scan would
+    std::sort(candidates.begin(), candidates.end());
+
+    for(std::vector<uint64>::iterator it = candidates.begin(); it != candidates.end(); ++it)
+    {
+        AuctionMap::const_iterator auctionIt = mAuctions.find(*it);
+
+        if(auctionIt == mAuctions.end() || !_matches(auctionIt->second, search))
+            continue;
+
+        if(skipped++ < search.Start)
+            continue;
+
+        if(results.size() == search.PageSize)
+            return true;
+
+        results.push_back(&auctionIt->second);
+    }
+
+    return false;
+}
+
+//======================================================================================================================
+
+void AuctionStore::_discardStaleExpiry()
+{
+    // entries of removed or re-timed auctions are left in the heap, drop them once they surface
+    while(!mExpiry.empty())
+    {
+        AuctionMap::iterator it = mAuctions.find(mExpiry.top().second);
+
+        if(it != mAuctions.end() && it->second.EndTime == mExpiry.top().first)
+            return;
+
+        mExpiry.pop();
+    }
+}
+
+//======================================================================================================================
+
+bool AuctionStore::hasExpired(uint64 now)
+{
+    _discardStaleExpiry();
+
+    return !mExpiry.empty() && mExpiry.top().first <= now;
+}
+
+//======================================================================================================================
+
+void AuctionStore::popExpired(uint64 now, std::vector<uint64>& expired)
+{
+    while(hasExpired(now))
+    {
+        expired.push_back(mExpiry.top().second);
+        mExpiry.pop();
+    }
+}
@@ -0,0 +1,155 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_CHATSERVER_AUCTIONSTORE_H
+#define ANH_CHATSERVER_AUCTIONSTORE_H
+
+#include "TradeManagerHelp.h"
+
+#include "Utils/typedefs.h"
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+//======================================================================================================================
+//
+// The search criteria of an opAuctionQueryHeadersMessage, resolved against the requesting player
+//
+
+struct AuctionSearch
+{
+    AuctionSearch()
+        : RegionType(TRMGalaxy), BazaarID(0), RegionID(0), PlanetID(0), Window(TRMVendor_AllAuctions)
+        , CharID(0), Category(0), ItemTyp(0), Now(0), Start(0), PageSize(100) {}
+
+    uint32			RegionType;		// TRMRegionType
+    uint64			BazaarID;
+    uint32			RegionID;
+    uint32			PlanetID;
+    uint32			Window;			// TRMAuctionWindowType
+    uint64			CharID;
+    std::string		CharName;
+    uint32			Category;
+    uint32			ItemTyp;
+    uint64			Now;			// global tick in seconds, listings ending before are hidden
+    uint32			Start;
+    uint32			PageSize;
+};
+
+typedef std::vector<const AuctionItem*> AuctionResultList;
+
+//======================================================================================================================
+//
+// a row of commerce_bidhistory
+//
+
+struct AuctionBid
+{
+    uint32			Proxy;
+    uint32			MaxBid;
+};
+
+//======================================================================================================================
+//
+// Galaxy wide in memory copy of commerce_auction
+//
+// Loaded once when the ChatServer starts and kept in sync by the TradeManager as it writes
+// auctions to the db, so bazaar searches and paging never touch the database. Secondary
+// indexes cover the search criteria the client can send, and an expiry heap tells the
+// TradeManager when the db actually has listings to expire.
+//
+
+class AuctionStore
+{
+public:
+
+    AuctionStore() {}
+    ~AuctionStore() {}
+
+    // inserts the auction or replaces the one with the same ItemID, bids on it are kept
+    void				insert(const AuctionItem& auction);
+    // drops the auction and its bids
+    void				remove(uint64 auctionId);
+    void				clear();
+
+    const AuctionItem*	find(uint64 auctionId) const;
+    uint32				size() const { return static_cast<uint32>(mAuctions.size()); }
+
+    // bid history, used by the "my bids" window
+    void				setBid(uint64 auctionId, const std::string& bidderName, uint32 proxy, uint32 maxBid);
+    void				clearBids(uint64 auctionId);
+    const AuctionBid*	findBid(uint64 auctionId, const std::string& bidderName) const;
+
+    // fills results with at most search.PageSize matches starting at search.Start,
+    // ordered by auction id. Returns true when there are more matches after this page.
+    bool				search(const AuctionSearch& search, AuctionResultList& results) const;
+
+    // true when the earliest live listing ends at or before now (seconds)
+    bool				hasExpired(uint64 now);
+
+    // removes and returns the ids of all listings ending at or before now (seconds)
+    void				popExpired(uint64 now, std::vector<uint64>& expired);
+
+private:
+
+    typedef std::map<uint64, AuctionItem>							AuctionMap;
+    typedef std::multimap<uint32, uint64>							Index32;
+    typedef std::multimap<uint64, uint64>							Index64;
+    typedef std::map<uint64, AuctionBid>							BidMap;			// by auction id
+    typedef std::map<std::string, BidMap>							BidderIndex;
+    typedef std::map<uint64, std::set<std::string> >				AuctionBidders;
+    typedef std::pair<uint64, uint64>								ExpiryEntry;	// end time, auction id
+    typedef std::priority_queue<ExpiryEntry, std::vector<ExpiryEntry>, std::greater<ExpiryEntry> > ExpiryHeap;
+
+    bool				_matches(const AuctionItem& auction, const AuctionSearch& search) const;
+    void				_unindexAll(const AuctionItem& auction);
+    void				_discardStaleExpiry();
+
+    template<typename Index, typename Key>
+    void				_unindex(Index& index, Key key, uint64 auctionId);
+
+    AuctionMap			mAuctions;
+
+    Index32				mCategoryIndex;		// keyed by main category (Category >> 8)
+    Index32				mItemTypeIndex;
+    Index32				mRegionIndex;
+    Index32				mPlanetIndex;
+    Index64				mBazaarIndex;
+    Index64				mOwnerIndex;
+    BidderIndex			mBidderIndex;
+    AuctionBidders		mAuctionBidders;
+
+    ExpiryHeap			mExpiry;
+};
+
+#endif
@@ -60,6 +60,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DatabaseResult.h"
 
+#include "CharacterNameDirectory.h"
+#include "ChatManager.h"
 #include "ChatOpcodes.h"
 
 #ifdef WIN32
@@ -293,7 +295,9 @@ void CharacterAdminHandler::_processCreateCharacter(Message* message, DispatchCl
     strcat(sql, sql2);
 
     //Logging the character create sql for debugging purposes,beware this contains binary data
-    database_->executeAsyncProcedure(sql, [this, client] (DatabaseResult* result) {       
+    std::string first_name(characterInfo.mFirstName.getAnsi());
+
+    database_->executeAsyncProcedure(sql, [this, client, first_name] (DatabaseResult* result) {       
         // Vaalidate the input.
         if (! client || ! result) {
             return;
@@ -309,6 +313,7 @@ void CharacterAdminHandler::_processCreateCharacter(Message* message, DispatchCl
         uint64 query_result = result_set->getUInt64(1);
 
         if(query_result >= 0x0000000200000000ULL) {
+            gChatManager->getNameDirectory()->add(query_result, first_name);
             _sendCreateCharacterSuccess(query_result, client);
         } else {
             _sendCreateCharacterFailed(static_cast<uint32>(query_result), client);
@@ -0,0 +1,224 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "CharacterNameDirectory.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+
+// Fix for issues with glog redefining this constant
+#ifdef _WIN32
+#undef ERROR
+#endif
+#include <glog/logging.h>
+
+#include "Utils/bstring.h"
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DataBinding.h"
+
+namespace {
+// Character deletes are handled by the LoginServer, pick them up every 15 minutes.
+const uint64 kReloadInterval = 15 * 60 * 1000;
+
+// a row of the directory load
+struct NameRow {
+    uint64 id;
+    BString firstname;
+};
+}
+
+CharacterNameDirectory::CharacterNameDirectory(Database* database)
+    : database_(database)
+    , last_load_time_(0)
+    , loaded_(false)
+    , load_in_flight_(false)
+{
+    binding_ = database_->createDataBinding(2);
+    binding_->addField(DFT_uint64, offsetof(NameRow, id), 8, 0);
+    binding_->addField(DFT_bstring, offsetof(NameRow, firstname), 64, 1);
+}
+
+
+CharacterNameDirectory::~CharacterNameDirectory() {
+    database_->destroyDataBinding(binding_);
+}
+
+
+void CharacterNameDirectory::load() {
+    if (load_in_flight_) {
+        return;
+    }
+
+    load_in_flight_ = true;
+
+    std::string sql = std::string("SELECT id, firstname FROM ") + database_->galaxy() + ".characters";
+
+    database_->executeAsyncSql<NameRow>(sql, binding_, [this] (std::vector<NameRow>& rows) {
+        load_in_flight_ = false;
+
+        ids_by_folded_name_.clear();
+        ids_by_exact_name_.clear();
+        names_by_id_.clear();
+
+        ids_by_folded_name_.reserve(rows.size());
+        ids_by_exact_name_.reserve(rows.size());
+        names_by_id_.reserve(rows.size());
+
+        std::for_each(rows.begin(), rows.end(), [this] (const NameRow& row) {
+            insert_(row.id, row.firstname.getAnsi());
+        });
+
+        // Anything created, renamed or deleted after the query was issued
+        // may be missing from its result.
+        std::for_each(pending_changes_.begin(), pending_changes_.end(), [this] (const PendingChange& change) {
+            if (change.name.empty()) {
+                erase_(change.character_id);
+            } else {
+                insert_(change.character_id, change.name);
+            }
+        });
+        pending_changes_.clear();
+
+        loaded_ = true;
+
+        DLOG(INFO) << "Loaded " << names_by_id_.size() << " character names";
+    });
+}
+
+
+void CharacterNameDirectory::process(uint64 current_time) {
+    if (last_load_time_ == 0) {
+        last_load_time_ = current_time;
+        return;
+    }
+
+    if (current_time - last_load_time_ < kReloadInterval) {
+        return;
+    }
+
+    last_load_time_ = current_time;
+    load();
+}
+
+
+void CharacterNameDirectory::add(uint64 character_id, const std::string& name) {
+    insert_(character_id, name);
+
+    if (load_in_flight_) {
+        PendingChange change = {character_id, name};
+        pending_changes_.push_back(change);
+    }
+}
+
+
+void CharacterNameDirectory::rename(uint64 character_id, const std::string& new_name) {
+    // insert_ drops the old name entries of the character
+    add(character_id, new_name);
+}
+
+
+void CharacterNameDirectory::remove(uint64 character_id) {
+    erase_(character_id);
+
+    if (load_in_flight_) {
+        PendingChange change = {character_id, std::string()};
+        pending_changes_.push_back(change);
+    }
+}
+
+
+uint64 CharacterNameDirectory::findByName(const std::string& name) const {
+    auto it = ids_by_folded_name_.find(foldCase_(name));
+    return (it != ids_by_folded_name_.end()) ? it->second : 0;
+}
+
+
+uint64 CharacterNameDirectory::findByExactName(const std::string& name) const {
+    auto it = ids_by_exact_name_.find(name);
+    return (it != ids_by_exact_name_.end()) ? it->second : 0;
+}
+
+
+bool CharacterNameDirectory::getName(uint64 character_id, std::string& name) const {
+    auto it = names_by_id_.find(character_id);
+
+    if (it == names_by_id_.end()) {
+        return false;
+    }
+
+    name = it->second;
+    return true;
+}
+
+
+std::string CharacterNameDirectory::foldCase_(const std::string& name) {
+    std::string folded(name);
+    std::transform(folded.begin(), folded.end(), folded.begin(), [] (char c) {
+        return static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+    });
+    return folded;
+}
+
+
+void CharacterNameDirectory::insert_(uint64 character_id, const std::string& name) {
+    erase_(character_id);
+
+    if (name.empty()) {
+        return;
+    }
+
+    names_by_id_[character_id] = name;
+    ids_by_exact_name_[name] = character_id;
+
+    // Names are unique ignoring case, but don't let a stray duplicate
+    // hijack the lookup of an existing character.
+    ids_by_folded_name_.insert(std::make_pair(foldCase_(name), character_id));
+}
+
+
+void CharacterNameDirectory::erase_(uint64 character_id) {
+    auto it = names_by_id_.find(character_id);
+
+    if (it == names_by_id_.end()) {
+        return;
+    }
+
+    auto exact = ids_by_exact_name_.find(it->second);
+    if (exact != ids_by_exact_name_.end() && exact->second == character_id) {
+        ids_by_exact_name_.erase(exact);
+    }
+
+    auto folded = ids_by_folded_name_.find(foldCase_(it->second));
+    if (folded != ids_by_folded_name_.end() && folded->second == character_id) {
+        ids_by_folded_name_.erase(folded);
+    }
+
+    names_by_id_.erase(it);
+}
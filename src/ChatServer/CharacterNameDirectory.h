@@ -0,0 +1,122 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_CHATSERVER_CHARACTERNAMEDIRECTORY_H_
+#define SRC_CHATSERVER_CHARACTERNAMEDIRECTORY_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils/typedefs.h"
+
+class Database;
+class DataBinding;
+
+/*! Galaxy wide character name directory.
+ *
+ * Holds every character name of the galaxy in memory so that chat can resolve
+ * names to ids (and back) with a hash probe instead of a round trip to the
+ * characters table. The directory is loaded once at startup, kept current by
+ * the character create/rename/delete paths and reloaded in the background at a
+ * slow interval to pick up changes made by other servers (e.g. character deletes
+ * handled by the LoginServer).
+ *
+ * Until the first load completed the directory is empty, callers check
+ * isLoaded() and ask the characters table themselves until then.
+ */
+class CharacterNameDirectory {
+public:
+    explicit CharacterNameDirectory(Database* database);
+    ~CharacterNameDirectory();
+
+    /*! Issues an asynchronous (re)load of the full directory.
+     */
+    void load();
+
+    /*! Reloads the directory once the refresh interval has passed.
+     *
+     * \param current_time The current local time in milliseconds.
+     */
+    void process(uint64 current_time);
+
+    void add(uint64 character_id, const std::string& name);
+    void rename(uint64 character_id, const std::string& new_name);
+    void remove(uint64 character_id);
+
+    /*! Case insensitive name lookup.
+     *
+     * \return The character id or 0 if there is no such character.
+     */
+    uint64 findByName(const std::string& name) const;
+
+    /*! Case sensitive name lookup.
+     *
+     * \return The character id or 0 if there is no such character.
+     */
+    uint64 findByExactName(const std::string& name) const;
+
+    /*! Looks up the properly cased first name of a character.
+     *
+     * \return True if the character is known, in which case name is filled in.
+     */
+    bool getName(uint64 character_id, std::string& name) const;
+
+    bool isLoaded() const { return loaded_; }
+    size_t size() const { return names_by_id_.size(); }
+
+private:
+    typedef std::unordered_map<std::string, uint64> NameIndex;
+    typedef std::unordered_map<uint64, std::string> IdIndex;
+
+    // Changes made while a reload is in flight, replayed on top of its result.
+    struct PendingChange {
+        uint64 character_id;
+        std::string name;  // empty for a removal
+    };
+
+    static std::string foldCase_(const std::string& name);
+
+    void insert_(uint64 character_id, const std::string& name);
+    void erase_(uint64 character_id);
+
+    Database* database_;
+    DataBinding* binding_;
+
+    NameIndex ids_by_folded_name_;
+    NameIndex ids_by_exact_name_;
+    IdIndex names_by_id_;
+
+    std::vector<PendingChange> pending_changes_;
+
+    uint64 last_load_time_;
+    bool loaded_;
+    bool load_in_flight_;
+};
+
+#endif  // SRC_CHATSERVER_CHARACTERNAMEDIRECTORY_H_
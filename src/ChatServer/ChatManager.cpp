@@ -37,8 +37,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #undef ERROR
 #endif
 
+#include <algorithm>
 #include <cstring>
 #include <ctime>
+#include <string>
 
 #include <glog/logging.h>
 #include <cppconn/resultset.h>
@@ -58,12 +60,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/MessageFactory.h"
 
 #include "ChatServer/Channel.h"
+#include "ChatServer/CharacterNameDirectory.h"
 #include "ChatServer/ChatAvatarId.h"
 #include "ChatServer/ChatMessageLib.h"
 #include "ChatServer/ChatOpcodes.h"
 #include "ChatServer/GroupManager.h"
 #include "ChatServer/GroupObject.h"
 #include "ChatServer/Mail.h"
+#include "ChatServer/MailStore.h"
 #include "ChatServer/Player.h"
 
 //======================================================================================================================
@@ -75,7 +79,9 @@ ChatManager*	ChatManager::mSingleton = NULL;
 
 ChatManager::ChatManager(Database* database,MessageDispatch* dispatch) :
     mDatabase(database),
-    mMessageDispatch(dispatch)
+    mMessageDispatch(dispatch),
+    mNameDirectory(new CharacterNameDirectory(database)),
+    mMailStore(new MailStore(database))
 {
     mMainCategory = "SWG";
 
@@ -94,6 +100,7 @@ ChatManager::ChatManager(Database* database,MessageDispatch* dispatch) :
     asyncContainer = new ChatAsyncContainer(ChatQuery_PlanetNames);
     mDatabase->executeProcedureAsync(this,asyncContainer,"CALL %s.sp_ReturnChatPlanetNames();",mDatabase->galaxy());
     
+    mNameDirectory->load();
 }
 
 //======================================================================================================================
@@ -124,6 +131,11 @@ ChatManager::~ChatManager()
     _destroyDatabindings();
     _unregisterCallbacks();
 
+    delete mNameDirectory;
+
+    // flushed and drained by the ChatServer before it shuts down the handlers
+    delete mMailStore;
+
     mInsFlag = false;
     mSingleton = NULL;
 }
@@ -215,24 +227,6 @@ void ChatManager::_loadDatabindings()
     mOwnerBinding = mDatabase->createDataBinding(1);
     mOwnerBinding->addField(DFT_bstring, 0, 33, 5);
 
-    mMailBinding = mDatabase->createDataBinding(7);
-    mMailBinding->addField(DFT_uint32,	offsetof(Mail,mId),					4,		0);
-    mMailBinding->addField(DFT_bstring,	offsetof(Mail,mSender),				64,		1);
-    mMailBinding->addField(DFT_bstring,	offsetof(Mail,mSubject),			256,	2);
-    mMailBinding->addField(DFT_bstring,	offsetof(Mail,mText),				8192,	3);
-    mMailBinding->addField(DFT_uint32,	offsetof(Mail,mTime),				4,		4);
-    mMailBinding->addField(DFT_raw,		offsetof(Mail,mAttachmentRaw),		2048,	5);
-    mMailBinding->addField(DFT_uint32,	offsetof(Mail,mAttachmentSize),		4,		6);
-
-    mMailHeaderBinding = mDatabase->createDataBinding(5);
-    mMailHeaderBinding->addField(DFT_uint32,	offsetof(Mail,mId),			4,0);
-    mMailHeaderBinding->addField(DFT_bstring,	offsetof(Mail,mSender),		128,	1);
-    mMailHeaderBinding->addField(DFT_bstring,	offsetof(Mail,mSubject),	256,	2);
-    mMailHeaderBinding->addField(DFT_uint8,		offsetof(Mail,mStatus),		1,		3);
-    mMailHeaderBinding->addField(DFT_uint32,	offsetof(Mail,mTime),		4,		4);
-
-
-
 }
 
 //======================================================================================================================
@@ -241,8 +235,6 @@ void ChatManager::_destroyDatabindings()
 {
     mDatabase->destroyDataBinding(mPlayerBinding);
     mDatabase->destroyDataBinding(mChannelBinding);
-    mDatabase->destroyDataBinding(mMailBinding);
-    mDatabase->destroyDataBinding(mMailHeaderBinding);
 }
 
 //======================================================================================================================
@@ -436,7 +428,14 @@ void ChatManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
         DataBinding* binding = mDatabase->createDataBinding(1);
         binding->addField(DFT_uint64,0,8);
 
-        if(result->getRowCount())
+        if(result->getRowCount() && !asyncContainer->mSender)
+        {
+            result->getNextRow(binding,&receiverId);
+
+            // system mail, no sender to acknowledge or to be ignored
+            _queueSystemMail(asyncContainer->mMail,receiverId);
+        }
+        else if(result->getRowCount())
         {
             result->getNextRow(binding,&receiverId);
 
@@ -551,10 +550,20 @@ void ChatManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
             bIgnore = (it != ignoreList.end());
             if (bIgnore)
             {
-                mDatabase->executeProcedureAsync(NULL, NULL, "CALL %s.sp_DeleteMail(%u);", mDatabase->galaxy(),  asyncContainer->mRequestId);
-                
+                mMailStore->remove(asyncContainer->mRequestId);
             }
         }
+        if (!bIgnore)
+        {
+            MailHeader header;
+            header.id		= asyncContainer->mRequestId;
+            header.sender	= asyncContainer->mMail->mSender.getAnsi();
+            header.subject	= asyncContainer->mMail->mSubject.getAnsi();
+            header.time		= asyncContainer->mMail->mTime;
+            header.status	= MailStatus_New;
+
+            mMailStore->added(asyncContainer->mReceiverId, header);
+        }
         if ((receiver != NULL) && (!bIgnore))
         {
             // send out new mail notification, if not receiving mail from Ignored player.
@@ -584,58 +593,6 @@ void ChatManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
     }
     break;
 
-    case ChatQuery_MailById:
-    {
-        if(!result->getRowCount())
-        {
-            DLOG(WARNING) << " not found mail with id %u" << asyncContainer->mRequestId;
-            SAFE_DELETE(asyncContainer);
-            return;
-        }
-        Mail mail = Mail();
-        mail.mSubject.setLength(512);
-        mail.mText.setLength(8192);
-
-        result->getNextRow(mMailBinding,&mail);
-
-        memcpy(mail.mAttachments.getRawData(), mail.mAttachmentRaw, mail.mAttachmentSize);
-
-        mail.mAttachments.setLength(static_cast<uint16>(mail.mAttachmentSize >> 1));
-        mail.mSubject.convert(BSTRType_Unicode16);
-        mail.mText.convert(BSTRType_Unicode16);
-
-        gChatMessageLib->sendChatPersistantMessagetoClient(asyncContainer->mClient,&mail);
-
-        //mDatabase->ExecuteSqlAsync(NULL,NULL,"UPDATE chat_mail SET status = 1 WHERE id=%u", mail.mId);
-        mDatabase->executeProcedureAsync(NULL, NULL, "CALL %s.sp_MailStatusUpdate(%u)", mDatabase->galaxy(),  mail.mId);
-        
-
-    }
-    break;
-
-    case ChatQuery_MailHeaders:
-    {
-        Mail		mail;
-        uint64		count = result->getRowCount();
-
-        // Update client with all mail.
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->getNextRow(mMailHeaderBinding,&mail);
-            mail.mSubject.convert(BSTRType_Unicode16);
-
-            if(!mail.mStatus)
-            {
-                gChatMessageLib->sendChatPersistantMessagetoClient(asyncContainer->mClient,&mail, mail.mId,1,MailStatus_New);
-            }
-            else
-            {
-                gChatMessageLib->sendChatPersistantMessagetoClient(asyncContainer->mClient,&mail, mail.mId,1,MailStatus_Read);
-            }
-        }
-    }
-    break;
-
     case ChatQuery_PlayerFriends:
     {
         BString	name;
@@ -1036,16 +993,24 @@ void ChatManager::_processWhenLoaded(Message* message,DispatchClient* client)
             PlayerAccountMap::iterator accIt = mPlayerAccountMap.find(client->getAccountId());
             if (accIt != mPlayerAccountMap.end())
             {
-                // query mail headers
-                ChatAsyncContainer* asContainer = new ChatAsyncContainer(ChatQuery_MailHeaders);
-                asContainer->mClient = client;
-                asContainer->mReceiver = (*accIt).second;
-
                 // Update friends list
-                updateFriendsOnline(asContainer->mReceiver,true);
-
-                mDatabase->executeProcedureAsync(this,asContainer,"CALL %s.sp_ReturnChatMailHeaders(%"PRIu64");",mDatabase->galaxy(),asContainer->mReceiver->getCharId());
-                
+                updateFriendsOnline((*accIt).second,true);
+
+                // list our mail, cached from an earlier login or loaded now
+                uint64 charId = (*accIt).second->getCharId();
+
+                mMailStore->getHeaders(charId, [this, charId] (const std::vector<MailHeader>& headers) {
+                    Player* receiver = getPlayerbyId(charId);
+                    if (!receiver)
+                    {
+                        return;
+                    }
+
+                    for (auto& header : headers)
+                    {
+                        _sendMailHeader(receiver->getClient(), header, 1);
+                    }
+                });
             }
         }
         GroupObject* group = gGroupManager->getGroupById(player->getGroupId());
@@ -2214,6 +2179,13 @@ void ChatManager::_processAvatarId(Message* message,DispatchClient* client)
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 void ChatManager::sendSystemMailMessage(Mail* mail,uint64 recipient)
 {
+    std::string recipientName;
+    if(mNameDirectory->getName(recipient, recipientName))
+    {
+        _PersistentMessagebySystem(mail, 0, recipientName.c_str());
+        return;
+    }
+
     int8 sql[100];
     sprintf(sql, "SELECT firstname FROM %s.characters WHERE id LIKE %"PRIu64"",mDatabase->galaxy(), recipient);
 
@@ -2267,20 +2239,8 @@ void ChatManager::_processSystemMailMessage(Message* message,DispatchClient* cli
     mail->setAttachments(attachmentData);
 
 
-    //ok we will enter now a db call in order to get the recipients name
-
-    ChatAsyncContainer* asyncContainer = new ChatAsyncContainer(ChatQuery_QueryFirstName);
-    asyncContainer->mMail = mail;
-    asyncContainer->mMailCounter = 1;
-    asyncContainer->mReceiverId = ReceiverID;
-    asyncContainer->mClient = client;
-
-    int8 sql[100];
-    sprintf(sql, "SELECT firstname FROM %s.characters WHERE id LIKE %"PRIu64"",mDatabase->galaxy(), ReceiverID);
-
-    mDatabase->executeSqlAsync(this,asyncContainer,sql);
-
-
+    // resolves the recipients name through the name directory, falling back to the db
+    sendSystemMailMessage(mail, ReceiverID);
 }
 void ChatManager::_PersistentMessagebySystem(Mail* mail,DispatchClient* client, BString receiverStr)
 {
@@ -2302,40 +2262,18 @@ void ChatManager::_PersistentMessagebySystem(Mail* mail,DispatchClient* client,
 
     // Update: Let's go for that optimization. It's also more in line with the original implementation.
 
-    if (receiver != NULL)
-    {
-
-        ChatAsyncContainer* asyncContainer = new ChatAsyncContainer(ChatQuery_CreateMail);
-        asyncContainer->mMail = mail;
-        asyncContainer->mSender = sender;
-        asyncContainer->mMailCounter = mailId;
-        asyncContainer->mReceiverId = receiver->getCharId();
-
-        int8 sql[20000],*sqlPointer;
-        int8 footer[64];
-        int8 receiverStr[64];
-        sprintf(receiverStr,"',%"PRIu64",'",receiver->getCharId());
-        sprintf(footer,",%u,%"PRIu32")",(mail->mAttachments.getLength() << 1),mail->mTime);
-        sprintf(sql,"SELECT %s.sf_MailCreate('",mDatabase->galaxy());
-        sqlPointer = sql + strlen(sql);
-        sqlPointer += mDatabase->escapeString(sqlPointer,mail->getSender().getAnsi(),mail->getSender().getLength());
-        strcat(sql,receiverStr);
-        sqlPointer = sql + strlen(sql);
-        sqlPointer += mDatabase->escapeString(sqlPointer,mail->mSubject.getAnsi(),mail->mSubject.getLength());
-        *sqlPointer++ = '\'';
-        *sqlPointer++ = ',';
-        *sqlPointer++ = '\'';
-        sqlPointer += mDatabase->escapeString(sqlPointer,mail->mText.getAnsi(),mail->mText.getLength());
-        *sqlPointer++ = '\'';
-        *sqlPointer++ = ',';
-        *sqlPointer++ = '\'';
-        sqlPointer += mDatabase->escapeString(sqlPointer,mail->mAttachments.getRawData(),(mail->mAttachments.getLength() << 1));
-        *sqlPointer++ = '\'';
-        *sqlPointer++ = '\0';
-        strcat(sql,footer);
-
-        mDatabase->executeSqlAsyncNoArguments(this, asyncContainer, sql);
+    // Update: Offline receivers are resolved through the name directory, the db is only asked while it loads.
+    uint64 receiverId = (receiver != NULL) ? receiver->getCharId() : mNameDirectory->findByName(receiverStr.getAnsi());
 
+    if (receiverId != 0)
+    {
+        // auction and structure mail comes in bursts, the store writes it in batches
+        _queueSystemMail(mail, receiverId);
+    }
+    else if (mNameDirectory->isLoaded())
+    {
+        LOG(WARNING) << "System mail to unknown character [" << receiverStr.getAnsi() << "] dropped";
+        SAFE_DELETE(mail);
     }
     else
     {
@@ -2358,6 +2296,46 @@ void ChatManager::_PersistentMessagebySystem(Mail* mail,DispatchClient* client,
 
 
 
+//======================================================================================================================
+//
+// hands a system mail to the mail store, the receiver is told once it has been written
+//
+
+void ChatManager::_queueSystemMail(Mail* mail,uint64 receiverId)
+{
+    MailBody body;
+    body.id				= 0;
+    body.sender			= std::string(mail->mSender.getAnsi(), mail->mSender.getLength());
+    body.subject		= std::string(mail->mSubject.getAnsi(), mail->mSubject.getLength());
+    body.text			= std::string(mail->mText.getAnsi(), mail->mText.getLength());
+    body.attachments	= std::string(mail->mAttachments.getRawData(), mail->mAttachments.getLength() << 1);
+    body.time			= mail->mTime;
+
+    SAFE_DELETE(mail);
+
+    mMailStore->queueSystemMail(receiverId, body, [this, receiverId] (const MailHeader& header) {
+        if (Player* receiver = getPlayerbyId(receiverId))
+        {
+            _sendMailHeader(receiver->getClient(), header, 1);
+        }
+    });
+}
+
+//======================================================================================================================
+
+void ChatManager::_sendMailHeader(DispatchClient* client,const MailHeader& header,uint32 mailCounter)
+{
+    Mail mail;
+    mail.mSender	= header.sender.c_str();
+    mail.mSubject	= header.subject.c_str();
+    mail.mSubject.convert(BSTRType_Unicode16);
+    mail.mTime		= header.time;
+
+    gChatMessageLib->sendChatPersistantMessagetoClient(client, &mail, header.id, mailCounter, header.status);
+}
+
+//======================================================================================================================
+
 void ChatManager::_processPersistentMessageToServer(Message* message,DispatchClient* client)
 {
     BString msgText;      // mail text
@@ -2413,18 +2391,20 @@ void ChatManager::_processPersistentMessageToServer(Message* message,DispatchCli
     mail->setAttachments(attachmentData);
 
     // See comment at _PersistentMessagebySystem for this part of the code.
-    if (receiver != NULL)
+    uint64 receiverId = (receiver != NULL) ? receiver->getCharId() : mNameDirectory->findByName(targetName.getAnsi());
+
+    if (receiverId != 0)
     {
         ChatAsyncContainer* asyncContainer = new ChatAsyncContainer(ChatQuery_CreateMail);
         asyncContainer->mMail = mail;
         asyncContainer->mSender = sender;
         asyncContainer->mMailCounter = mailId;
-        asyncContainer->mReceiverId = receiver->getCharId();
+        asyncContainer->mReceiverId = receiverId;
 
         int8 sql[20000],*sqlPointer;
         int8 footer[64];
         int8 receiverStr[64];
-        sprintf(receiverStr,"',%"PRIu64",'",receiver->getCharId());
+        sprintf(receiverStr,"',%"PRIu64",'",receiverId);
         sprintf(footer,",%u,%"PRIu32")",(mail->mAttachments.getLength() << 1),mail->mTime);
         sprintf(sql, "SELECT %s.sf_MailCreate('%s", mDatabase->galaxy(), sender->getName().getAnsi());
         sqlPointer = sql + strlen(sql);
@@ -2446,6 +2426,12 @@ void ChatManager::_processPersistentMessageToServer(Message* message,DispatchCli
 
         mDatabase->executeSqlAsync(this,asyncContainer,sql);
     }
+    else if (mNameDirectory->isLoaded())
+    {
+        // no such character
+        gChatMessageLib->sendChatonPersistantMessage(client,mailId);
+        SAFE_DELETE(mail);
+    }
     else
     {
         ChatAsyncContainer* asyncContainer = new ChatAsyncContainer(ChatQuery_CheckCharacter);
@@ -2478,14 +2464,39 @@ void ChatManager::_processRequestPersistentMessage(Message* message,DispatchClie
     dbMailId = message->getUint32();
     message->getUint8();             // unknown, attachments ?
 
-    ChatAsyncContainer* asyncContainer = new ChatAsyncContainer(ChatQuery_MailById);
-    asyncContainer->mClient = client;
-    asyncContainer->mRequestId = dbMailId;
+    uint32 accountId = client->getAccountId();
 
-    int8 sql[256];
-    sprintf(sql, "CALL %s.sp_ReturnChatMailById(%"PRIu32");", mDatabase->galaxy(), dbMailId);
+    mMailStore->getBody(dbMailId, [this, accountId, dbMailId] (const MailBody* body) {
+        if (!body)
+        {
+            DLOG(WARNING) << " not found mail with id " << dbMailId;
+            return;
+        }
 
-    mDatabase->executeProcedureAsync(this,asyncContainer,sql);
+        Player* player = getPlayerByAccId(accountId);
+        if (!player)
+        {
+            return;
+        }
+
+        Mail mail = Mail();
+        mail.mId = body->id;
+        mail.mSender = body->sender.c_str();
+        mail.mSubject = body->subject.c_str();
+        mail.mText = body->text.c_str();
+        mail.mTime = body->time;
+
+        uint32 attachmentSize = std::min<uint32>(static_cast<uint32>(body->attachments.size()), sizeof(mail.mAttachmentRaw));
+        memcpy(mail.mAttachments.getRawData(), body->attachments.data(), attachmentSize);
+
+        mail.mAttachments.setLength(static_cast<uint16>(attachmentSize >> 1));
+        mail.mSubject.convert(BSTRType_Unicode16);
+        mail.mText.convert(BSTRType_Unicode16);
+
+        gChatMessageLib->sendChatPersistantMessagetoClient(player->getClient(),&mail);
+
+        mMailStore->markRead(body->id);
+    });
 }
 
 //======================================================================================================================
@@ -2500,7 +2511,7 @@ void ChatManager::_processDeletePersistentMessage(Message* message,DispatchClien
 
     message->getUint8();             // unknown, attachments ?
 
-    mDatabase->executeProcedureAsync(NULL, NULL, "CALL %s.sp_DeleteMail(%u);", mDatabase->galaxy(),  dbMailId);
+    mMailStore->remove(dbMailId);
 
     // acknowledge
     gMessageFactory->StartMessage();
@@ -2843,6 +2854,12 @@ void ChatManager::_processFindFriendMessage(Message* message,DispatchClient* cli
     BString unicodeName = friendName;
     friendName.convert(BSTRType_ANSI);
 
+    if(mNameDirectory->isLoaded())
+    {
+        _handleFindFriendDBReply(playerObject,mNameDirectory->findByName(friendName.getAnsi()),friendName);
+        return;
+    }
+
     ChatAsyncContainer* asyncContainer = new ChatAsyncContainer(ChatQuery_FindFriend);
     asyncContainer->mName = friendName.getAnsi();
     asyncContainer->mSender = playerObject;
@@ -2943,6 +2960,12 @@ void ChatManager::_handleFindFriendDBReply(Player* player,uint64 retCode,BString
 
 bool ChatManager::isValidName(BString name)
 {
+    if (mNameDirectory->isLoaded())
+    {
+        return mNameDirectory->findByName(name.getAnsi()) != 0;
+    }
+
+    // the directory is still loading, ask the db
     int8 sql[128];
     mDatabase->escapeString(sql, name.getAnsi(), name.getLength());
 
@@ -2959,6 +2982,12 @@ bool ChatManager::isValidName(BString name)
 
 bool ChatManager::isValidExactName(BString name)
 {
+    if (mNameDirectory->isLoaded())
+    {
+        return mNameDirectory->findByExactName(name.getAnsi()) != 0;
+    }
+
+    // the directory is still loading, ask the db
     int8 sql[128];
     mDatabase->escapeString(sql, name.getAnsi(), name.getLength());
     DatabaseResult* result = mDatabase->executeSynchSql("SELECT id FROM %s.characters WHERE BINARY firstname = '%s';",mDatabase->galaxy(), sql);
@@ -2973,37 +3002,40 @@ bool ChatManager::isValidExactName(BString name)
 
 BString* ChatManager::getFirstName(BString& name)
 {
-    BString* myName = NULL;
-    // BString realPlayerName;
-
     // Assume player is online.
     Player* realPlayer = getPlayerByName(name);
     if (realPlayer)
     {
-        myName = new BString(realPlayer->getName().getAnsi());
-        // myName(name);
-        // myName->initRawBSTR(realPlayer->getName().getAnsi(), BSTRType_ANSI);
+        return new BString(realPlayer->getName().getAnsi());
     }
-    else
-    {
-        // Get first name the hard way...
-        myName = new BString();
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_bstring,0,64);
-        int8 sql[128];
-        mDatabase->escapeString(sql, name.getAnsi(), name.getLength());
-        DatabaseResult* result = mDatabase->executeSynchSql("SELECT firstname FROM %s.characters WHERE LCASE(firstname)= '%s';",mDatabase->galaxy(), sql);
 
-        if (result->getRowCount() == 1)
+    if (mNameDirectory->isLoaded())
+    {
+        std::string firstName;
+        if (!mNameDirectory->getName(mNameDirectory->findByName(name.getAnsi()), firstName))
         {
-            // We found a username that matched the input.
-            // string theName;
-            result->getNextRow(binding,myName);
-            // result->GetNextRow(binding,&theName);
-            // myName->initRawBSTR(theName.getAnsi(),BSTRType_ANSI);
+            return new BString();
         }
-        mDatabase->destroyResult(result);
+
+        return new BString(firstName.c_str());
     }
+
+    // Get first name the hard way, the directory is still loading...
+    BString* myName = new BString();
+    DataBinding* binding = mDatabase->createDataBinding(1);
+    binding->addField(DFT_bstring,0,64);
+    int8 sql[128];
+    mDatabase->escapeString(sql, name.getAnsi(), name.getLength());
+    DatabaseResult* result = mDatabase->executeSynchSql("SELECT firstname FROM %s.characters WHERE LCASE(firstname)= '%s';",mDatabase->galaxy(), sql);
+
+    if (result->getRowCount() == 1)
+    {
+        // We found a username that matched the input.
+        result->getNextRow(binding,myName);
+    }
+    mDatabase->destroyResult(result);
+    mDatabase->destroyDataBinding(binding);
+
     return myName;
 }
 
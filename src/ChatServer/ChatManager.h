@@ -38,6 +38,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //======================================================================================================================
 
 class Channel;
+class CharacterNameDirectory;
+class MailStore;
+struct MailHeader;
 class ChatManager;
 class Database;
 class DataBinding;
@@ -66,8 +69,6 @@ enum ChatQuery
     ChatQuery_Player			= 0,
     ChatQuery_GalaxyName		= 1,
     ChatQuery_CreateMail		= 2,
-    ChatQuery_MailById			= 3,
-    ChatQuery_MailHeaders		= 4,
     ChatQuery_CheckCharacter	= 5,
     ChatQuery_Channels			= 6,
     ChatQuery_PlayerChannels	= 7,
@@ -143,6 +144,13 @@ public:
     Player*				getPlayerByAccId(uint32 accId);
     Player*				getPlayerbyId(uint64 id);
     Player*				getPlayerByName(BString name);
+
+    CharacterNameDirectory*	getNameDirectory() {
+        return mNameDirectory;
+    }
+    MailStore*			getMailStore() {
+        return mMailStore;
+    }
     const int8* getPlanetNameById(uint32 planetId) const {
         return mvPlanetNames[planetId].getAnsi();
     }
@@ -203,6 +211,8 @@ private:
     void			_processDeletePersistentMessage(Message* message,DispatchClient* client);
     void			_PersistentMessagebySystem(Mail* mail,DispatchClient* client, BString sender);
     void			_processSystemMailMessage(Message* message,DispatchClient* client);
+    void			_queueSystemMail(Mail* mail,uint64 receiverId);
+    void			_sendMailHeader(DispatchClient* client,const MailHeader& header,uint32 mailCounter);
 
     // friendlist
     void			_processFriendlistUpdate(Message* message,DispatchClient* client);
@@ -236,6 +246,8 @@ private:
 
     Database*				mDatabase;
     MessageDispatch*        mMessageDispatch;
+    CharacterNameDirectory*	mNameDirectory;
+    MailStore*				mMailStore;
     ChannelList				mvChannels;
     ChannelMap				mChannelMap;
     ChannelNameMap			mChannelNameMap;
@@ -251,8 +263,6 @@ private:
 
     DataBinding*			mPlayerBinding;
     DataBinding*			mChannelBinding;
-    DataBinding*			mMailBinding;
-    DataBinding*			mMailHeaderBinding;
     DataBinding*			mCreatorBinding;
     DataBinding*			mOwnerBinding;
 
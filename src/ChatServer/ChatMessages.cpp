@@ -1316,6 +1316,12 @@ void ChatMessageLib::sendChatRoomMessage(Channel* channel, BString galaxy, BStri
     loweredName.toLower();
     uint32 loweredNameCrc = loweredName.getCrc();
 
+    // every member gets the same payload, so it goes out once and the connectionserver fans it out
+    std::vector<uint32> recipients;
+    recipients.reserve(channel->getUserList()->size());
+
+    DispatchClient* sendClient = NULL;
+
     while (iter != channel->getUserList()->end())
     {
         // If sender present at recievers ignore list, don't send.
@@ -1334,23 +1340,30 @@ void ChatMessageLib::sendChatRoomMessage(Channel* channel, BString galaxy, BStri
             }
             else
             {
-                gMessageFactory->StartMessage();
-                gMessageFactory->addUint32(opChatRoomMessage);
-
-                gMessageFactory->addString(SWG);
-                gMessageFactory->addString(galaxy);
-                gMessageFactory->addString(sender);
-
-                gMessageFactory->addUint32(channel->getId());
-                gMessageFactory->addString(message);
-                gMessageFactory->addUint32(0);
-                Message* response = gMessageFactory->EndMessage();
-                client->SendChannelA(response, client->getAccountId(), CR_Client, 5);
-
+                recipients.push_back(client->getAccountId());
+                sendClient = client;
             }
         }
         ++iter;
     }
+
+    if (sendClient == NULL)
+    {
+        return;
+    }
+
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opChatRoomMessage);
+
+    gMessageFactory->addString(SWG);
+    gMessageFactory->addString(galaxy);
+    gMessageFactory->addString(sender);
+
+    gMessageFactory->addUint32(channel->getId());
+    gMessageFactory->addString(message);
+    gMessageFactory->addUint32(0);
+    Message* response = gMessageFactory->EndMessage();
+    sendClient->SendChannelAMulticast(response, recipients, 5);
 }
 
 //======================================================================================================================
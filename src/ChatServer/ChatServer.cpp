@@ -32,7 +32,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <glog/logging.h>
 // External references
+#include "CharacterNameDirectory.h"
 #include "ChatManager.h"
+#include "MailStore.h"
 #include "CSRManager.h"
 #include "GroupManager.h"
 #include "TradeManagerChat.h"
@@ -55,6 +57,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/MessageFactory.h"
 
 #include "Utils/utils.h"
+#include "Utils/Reactor.h"
 #include "Utils/clock.h"
 
 #include <boost/thread/thread.hpp>
@@ -68,6 +71,7 @@ ChatServer* gChatServer;
 
 ChatServer::ChatServer(int argc, char* argv[]) 
 	: BaseServer()
+	, mReactor(0)
 	, mNetworkManager(0)
 	, mDatabaseManager(0)
 	, mRouterService(0)
@@ -83,9 +87,11 @@ ChatServer::ChatServer(int argc, char* argv[])
 	config_files.push_back("config/chatserver.cfg");
 	LoadOptions_(argc, argv, config_files);
 
+    mReactor = new utils::Reactor(configuration_variables_map_["MainLoopTickInterval"].as<uint32_t>());
 
     // Create and startup our core services.
 	mDatabaseManager = new DatabaseManager(DatabaseConfig(configuration_variables_map_["DBMinThreads"].as<uint32_t>(), configuration_variables_map_["DBMaxThreads"].as<uint32_t>(), configuration_variables_map_["DBGlobalSchema"].as<std::string>(), configuration_variables_map_["DBGalaxySchema"].as<std::string>(), configuration_variables_map_["DBConfigSchema"].as<std::string>()));
+    mDatabaseManager->setReactor(mReactor);
 
     // Startup our core modules
 	MessageFactory::getSingleton(configuration_variables_map_["GlobalMessageHeap"].as<uint32_t>());
@@ -97,6 +103,7 @@ ChatServer::ChatServer(int argc, char* argv[])
 		configuration_variables_map_["ServerPacketWindowSize"].as<uint32_t>(), 
 		configuration_variables_map_["ClientPacketWindowSize"].as<uint32_t>(),
 		configuration_variables_map_["UdpBufferSize"].as<uint32_t>()));
+    mNetworkManager->setReactor(mReactor);
 
     // Connect to the DB and start listening for the RouterServer.
     mDatabase = mDatabaseManager->connect(DBTYPE_MYSQL,
@@ -159,6 +166,11 @@ ChatServer::~ChatServer()
     // We're shutting down, so update the DB again.
     _updateDBServerList(0);
 
+    // queued system mail and status changes still have to reach the db, run them
+    // and every other queued query while the handlers their callbacks use still exist
+    mChatManager->getMailStore()->flush();
+    mDatabase->drain();
+
     // Shutdown the various handlers
     delete mCharacterAdminHandler;
 
@@ -179,6 +191,8 @@ ChatServer::~ChatServer()
 
     delete mDatabaseManager;
 
+    delete mReactor;
+
     LOG(WARNING) << "ChatServer Shutdown Complete";
 }
 
@@ -197,6 +211,8 @@ void ChatServer::Process()
     mPlanetMapHandler->Process();
     mTradeManagerChatHandler->Process();
     mStructureManagerChatHandler->Process();
+    mChatManager->getNameDirectory()->process(Anh_Utils::Clock::getSingleton()->getLocalTime());
+    mChatManager->getMailStore()->process(Anh_Utils::Clock::getSingleton()->getLocalTime());
 
 
     // Heartbeat once in awhile
@@ -252,8 +268,12 @@ void ChatServer::_connectToConnectionServer()
     // Now connect to the ConnectionServer
     mClient = new DispatchClient();
 
-	LOG(INFO) << "New connection to " << processAddress.mAddress.getAnsi() << " on port " << processAddress.mPort;
-    mRouterService->Connect(mClient, processAddress.mAddress.getAnsi(), processAddress.mPort);
+    // prefer the local link when the connectionserver runs on this host
+    if(!mRouterService->ConnectLocal(mClient, configuration_variables_map_["LocalTransportPath"].as<std::string>()))
+    {
+        LOG(INFO) << "New connection to " << processAddress.mAddress.getAnsi() << " on port " << processAddress.mPort;
+        mRouterService->Connect(mClient, processAddress.mAddress.getAnsi(), processAddress.mPort);
+    }
 }
 
 //======================================================================================================================
@@ -288,9 +308,13 @@ int main(int argc, char* argv[])
 		// Since startup completed successfully, now set the atexit().  Otherwise we try to gracefully shutdown a failed startup, which usually fails anyway.
 		//atexit(handleExit);
 
-		// Main loop
+		utils::Reactor* reactor = gChatServer->getReactor();
+
+		// Main loop, sleeps until there is network or database work or a tick is due
 		while (!exit)
 		{
+			reactor->Wait();
+
 			gChatServer->Process();
 
 			if(Anh_Utils::kbhit())
@@ -298,8 +322,6 @@ int main(int argc, char* argv[])
 				if(std::cin.get() == 'q')
 					break;
 			}
-
-			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
 		}
 
 		// Shutdown things
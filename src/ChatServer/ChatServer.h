@@ -34,6 +34,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 //======================================================================================================================
 
+namespace utils {
+class Reactor;
+}
+
 class CharacterAdminHandler;
 class ChatManager;
 class CSRManager;
@@ -71,11 +75,16 @@ public:
 
     void    Process();
 
+    utils::Reactor*	getReactor() {
+        return mReactor;
+    }
+
 private:
 
     void    _updateDBServerList(uint32 status);
     void    _connectToConnectionServer();
 
+    utils::Reactor*               mReactor;
     NetworkManager*				  mNetworkManager;
     DatabaseManager*              mDatabaseManager;
 
@@ -351,15 +351,23 @@ void GroupObject::broadcastMessage(Message* message, bool ignoreLeader)
         listIt++;
     }
 
+    std::vector<uint32> recipients;
+    DispatchClient* sendClient = NULL;
+
     while(listIt != mMembers.end())
     {
-        gMessageFactory->StartMessage();
-        gMessageFactory->addData(message->getData(),message->getSize());
-        Message* messageCopy = gMessageFactory->EndMessage();
-        (*listIt)->getClient()->SendChannelA(messageCopy, (*listIt)->getClient()->getAccountId(), CR_Client, 5);
+        sendClient = (*listIt)->getClient();
+        recipients.push_back(sendClient->getAccountId());
         ++listIt;
     }
-    gMessageFactory->DestroyMessage(message);
+
+    if(sendClient == NULL)
+    {
+        gMessageFactory->DestroyMessage(message);
+        return;
+    }
+
+    sendClient->SendChannelAMulticast(message, recipients, 5);
 }
 
 //======================================================================================================================
@@ -383,6 +391,9 @@ void GroupObject::broadcastPlayerPositionNotification(Player* player)
 
     PlayerList::iterator listIt = mMembers.begin();
 
+    std::vector<uint32> recipients;
+    DispatchClient* sendClient = NULL;
+
     float squaredist;
     while(listIt != mMembers.end())
     {
@@ -401,15 +412,19 @@ void GroupObject::broadcastPlayerPositionNotification(Player* player)
                 && sqrt(squaredist) > 256)
         {
             // then advise it!
-            gMessageFactory->StartMessage();
-            gMessageFactory->addData(newMessage->getData(),newMessage->getSize());
-            Message* messageCopy = gMessageFactory->EndMessage();
-            (*listIt)->getClient()->SendChannelA(messageCopy, (*listIt)->getClient()->getAccountId(), CR_Client, 5);
+            sendClient = (*listIt)->getClient();
+            recipients.push_back(sendClient->getAccountId());
         }
         ++listIt;
     }
 
-    gMessageFactory->DestroyMessage(newMessage);
+    if(sendClient == NULL)
+    {
+        gMessageFactory->DestroyMessage(newMessage);
+        return;
+    }
+
+    sendClient->SendChannelAMulticast(newMessage, recipients, 5);
 
 }
 
@@ -434,21 +449,28 @@ void GroupObject::broadcastPlayerZoneNotification(Player* player)
 
     PlayerList::iterator listIt = mMembers.begin();
 
+    std::vector<uint32> recipients;
+    DispatchClient* sendClient = NULL;
+
     while(listIt != mMembers.end())
     {
         // if target matches our needs
         if((*listIt) != player)
         {
             // advise it!
-            gMessageFactory->StartMessage();
-            gMessageFactory->addData(newMessage->getData(),newMessage->getSize());
-            Message* messageCopy = gMessageFactory->EndMessage();
-            (*listIt)->getClient()->SendChannelA(messageCopy, (*listIt)->getClient()->getAccountId(), CR_Client, 5);
+            sendClient = (*listIt)->getClient();
+            recipients.push_back(sendClient->getAccountId());
         }
         ++listIt;
     }
 
-    gMessageFactory->DestroyMessage(newMessage);
+    if(sendClient == NULL)
+    {
+        gMessageFactory->DestroyMessage(newMessage);
+        return;
+    }
+
+    sendClient->SendChannelAMulticast(newMessage, recipients, 5);
 }
 
 //======================================================================================================================
@@ -0,0 +1,529 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+
+#include "MailStore.h"
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+
+// Fix for issues with glog redefining this constant
+#ifdef _WIN32
+#undef ERROR
+#endif
+#include <glog/logging.h>
+
+#include "ChatOpcodes.h"
+
+#include "Utils/bstring.h"
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/DataBinding.h"
+
+namespace {
+// Mail bodies kept after being read.
+const size_t kMaxCachedBodies = 1024;
+
+// System mail waits at most this long for others to share its insert.
+const uint64 kMailFlushInterval = 250;
+// Read marks and deletes are not urgent, they only have to reach the db eventually.
+const uint64 kStatusFlushInterval = 5000;
+
+const size_t kMaxMailPerStatement = 64;
+const size_t kMaxStatementSize = 512 * 1024;
+const size_t kMaxIdsPerStatement = 500;
+
+// a row of sp_ReturnChatMailHeaders
+struct HeaderRow {
+    uint32 id;
+    BString sender;
+    BString subject;
+    uint8 status;
+    uint32 time;
+};
+
+// a row of sp_ReturnChatMailById
+struct BodyRow {
+    uint32 id;
+    BString sender;
+    BString subject;
+    BString text;
+    uint32 time;
+    char attachments[2048];
+    uint32 attachment_size;
+};
+}
+
+
+MailStore::MailStore(Database* database)
+    : database_(database)
+    , last_mail_flush_time_(0)
+    , last_status_flush_time_(0)
+{
+    header_binding_ = database_->createDataBinding(5);
+    header_binding_->addField(DFT_uint32, offsetof(HeaderRow, id), 4, 0);
+    header_binding_->addField(DFT_bstring, offsetof(HeaderRow, sender), 128, 1);
+    header_binding_->addField(DFT_bstring, offsetof(HeaderRow, subject), 256, 2);
+    header_binding_->addField(DFT_uint8, offsetof(HeaderRow, status), 1, 3);
+    header_binding_->addField(DFT_uint32, offsetof(HeaderRow, time), 4, 4);
+
+    body_binding_ = database_->createDataBinding(7);
+    body_binding_->addField(DFT_uint32, offsetof(BodyRow, id), 4, 0);
+    body_binding_->addField(DFT_bstring, offsetof(BodyRow, sender), 64, 1);
+    body_binding_->addField(DFT_bstring, offsetof(BodyRow, subject), 256, 2);
+    body_binding_->addField(DFT_bstring, offsetof(BodyRow, text), 8192, 3);
+    body_binding_->addField(DFT_uint32, offsetof(BodyRow, time), 4, 4);
+    body_binding_->addField(DFT_raw, offsetof(BodyRow, attachments), sizeof(BodyRow::attachments), 5);
+    body_binding_->addField(DFT_uint32, offsetof(BodyRow, attachment_size), 4, 6);
+}
+
+
+MailStore::~MailStore() {
+    database_->destroyDataBinding(header_binding_);
+    database_->destroyDataBinding(body_binding_);
+}
+
+
+void MailStore::process(uint64 current_time) {
+    if (!outgoing_.empty() && current_time - last_mail_flush_time_ >= kMailFlushInterval) {
+        last_mail_flush_time_ = current_time;
+        flushMail_();
+    }
+
+    if (current_time - last_status_flush_time_ >= kStatusFlushInterval) {
+        last_status_flush_time_ = current_time;
+        flushReads_();
+        flushDeletes_();
+    }
+}
+
+
+void MailStore::flush() {
+    flushMail_();
+    flushReads_();
+    flushDeletes_();
+}
+
+
+void MailStore::getHeaders(uint64 recipient_id, const HeadersCallback& callback) {
+    auto it = recipients_.find(recipient_id);
+
+    if (it != recipients_.end() && it->second.loaded) {
+        touch_(it->second);
+        callback(it->second.headers);
+        return;
+    }
+
+    if (it == recipients_.end()) {
+        it = recipients_.insert(std::make_pair(recipient_id, Recipient())).first;
+        it->second.lru = recipient_lru_.insert(recipient_lru_.end(), recipient_id);
+    }
+
+    it->second.waiting.push_back(callback);
+
+    // someone else is already loading them
+    if (it->second.waiting.size() > 1) {
+        return;
+    }
+
+    loadHeaders_(recipient_id);
+}
+
+
+void MailStore::getBody(uint32 mail_id, const BodyCallback& callback) {
+    auto it = bodies_.find(mail_id);
+
+    if (it != bodies_.end()) {
+        body_lru_.splice(body_lru_.end(), body_lru_, it->second.lru);
+        callback(&it->second.body);
+        return;
+    }
+
+    std::vector<BodyCallback>& waiting = body_waiters_[mail_id];
+    waiting.push_back(callback);
+
+    if (waiting.size() > 1) {
+        return;
+    }
+
+    std::stringstream sql;
+    sql << "CALL " << database_->galaxy() << ".sp_ReturnChatMailById(" << mail_id << ");";
+
+    database_->executeAsyncProcedure(sql, [this, mail_id] (DatabaseResult* result) {
+        std::vector<BodyCallback> callbacks;
+        callbacks.swap(body_waiters_[mail_id]);
+        body_waiters_.erase(mail_id);
+
+        if (!result->getRowCount() || unflushed_deletes_.count(mail_id)) {
+            for (auto& callback : callbacks) {
+                callback(NULL);
+            }
+            return;
+        }
+
+        BodyRow row;
+        row.attachment_size = 0;
+        result->getNextRow(body_binding_, &row);
+
+        MailBody body;
+        body.id = row.id;
+        body.sender.assign(row.sender.getAnsi(), row.sender.getLength());
+        body.subject.assign(row.subject.getAnsi(), row.subject.getLength());
+        body.text.assign(row.text.getAnsi(), row.text.getLength());
+        body.time = row.time;
+        body.attachments.assign(row.attachments, std::min<size_t>(sizeof(row.attachments), row.attachment_size));
+
+        cacheBody_(body);
+
+        for (auto& callback : callbacks) {
+            callback(&body);
+        }
+    });
+}
+
+
+void MailStore::queueSystemMail(uint64 recipient_id, const MailBody& mail, const DeliveredCallback& callback) {
+    OutgoingMail outgoing;
+    outgoing.recipient_id = recipient_id;
+    outgoing.mail = mail;
+    outgoing.callback = callback;
+
+    outgoing_.push_back(outgoing);
+
+    if (outgoing_.size() >= kMaxMailPerStatement) {
+        flushMail_();
+    }
+}
+
+
+void MailStore::added(uint64 recipient_id, const MailHeader& header) {
+    auto it = recipients_.find(recipient_id);
+
+    // not cached, the next load reads it from the db
+    if (it == recipients_.end()) {
+        return;
+    }
+
+    insertHeader_(it->second, recipient_id, header);
+}
+
+
+void MailStore::markRead(uint32 mail_id) {
+    auto mail = recipient_by_mail_.find(mail_id);
+
+    if (mail != recipient_by_mail_.end()) {
+        Recipient& recipient = recipients_[mail->second];
+
+        for (auto& header : recipient.headers) {
+            if (header.id != mail_id) {
+                continue;
+            }
+
+            // read before, nothing to write
+            if (header.status == MailStatus_Read) {
+                return;
+            }
+
+            header.status = MailStatus_Read;
+            break;
+        }
+    }
+
+    queued_reads_.push_back(mail_id);
+    unflushed_reads_.insert(mail_id);
+
+    if (queued_reads_.size() >= kMaxIdsPerStatement) {
+        flushReads_();
+    }
+}
+
+
+void MailStore::remove(uint32 mail_id) {
+    auto mail = recipient_by_mail_.find(mail_id);
+
+    if (mail != recipient_by_mail_.end()) {
+        std::vector<MailHeader>& headers = recipients_[mail->second].headers;
+
+        headers.erase(std::remove_if(headers.begin(), headers.end(), [mail_id] (const MailHeader& header) {
+            return header.id == mail_id;
+        }), headers.end());
+
+        recipient_by_mail_.erase(mail);
+    }
+
+    auto body = bodies_.find(mail_id);
+
+    if (body != bodies_.end()) {
+        body_lru_.erase(body->second.lru);
+        bodies_.erase(body);
+    }
+
+    queued_deletes_.push_back(mail_id);
+    unflushed_deletes_.insert(mail_id);
+
+    if (queued_deletes_.size() >= kMaxIdsPerStatement) {
+        flushDeletes_();
+    }
+}
+
+
+void MailStore::loadHeaders_(uint64 recipient_id) {
+    std::stringstream sql;
+    sql << "CALL " << database_->galaxy() << ".sp_ReturnChatMailHeaders(" << recipient_id << ");";
+
+    database_->executeAsyncProcedure(sql, [this, recipient_id] (DatabaseResult* result) {
+        auto it = recipients_.find(recipient_id);
+
+        if (it == recipients_.end()) {
+            return;
+        }
+
+        Recipient& recipient = it->second;
+
+        // mail delivered while the load was running
+        std::vector<MailHeader> delivered;
+        delivered.swap(recipient.headers);
+
+        for (uint64 i = 0, count = result->getRowCount(); i < count; ++i) {
+            HeaderRow row;
+            result->getNextRow(header_binding_, &row);
+
+            MailHeader header;
+            header.id = row.id;
+            header.sender.assign(row.sender.getAnsi(), row.sender.getLength());
+            header.subject.assign(row.subject.getAnsi(), row.subject.getLength());
+            header.status = row.status ? MailStatus_Read : MailStatus_New;
+            header.time = row.time;
+
+            if (unflushed_deletes_.count(header.id)) {
+                continue;
+            }
+
+            if (unflushed_reads_.count(header.id)) {
+                header.status = MailStatus_Read;
+            }
+
+            insertHeader_(recipient, recipient_id, header);
+        }
+
+        for (auto& header : delivered) {
+            insertHeader_(recipient, recipient_id, header);
+        }
+
+        recipient.loaded = true;
+
+        std::vector<HeadersCallback> callbacks;
+        callbacks.swap(recipient.waiting);
+
+        for (auto& callback : callbacks) {
+            callback(recipient.headers);
+        }
+
+        evict_();
+    });
+}
+
+
+void MailStore::insertHeader_(Recipient& recipient, uint64 recipient_id, const MailHeader& header) {
+    auto existing = std::find_if(recipient.headers.begin(), recipient.headers.end(), [&header] (const MailHeader& cached) {
+        return cached.id == header.id;
+    });
+
+    if (existing != recipient.headers.end()) {
+        return;
+    }
+
+    recipient.headers.push_back(header);
+    recipient_by_mail_[header.id] = recipient_id;
+}
+
+
+void MailStore::touch_(Recipient& recipient) {
+    recipient_lru_.splice(recipient_lru_.end(), recipient_lru_, recipient.lru);
+}
+
+
+void MailStore::evict_() {
+    auto it = recipient_lru_.begin();
+
+    while (recipients_.size() > kMaxCachedRecipients && it != recipient_lru_.end()) {
+        auto recipient = recipients_.find(*it);
+
+        // still loading, someone is waiting for it
+        if (!recipient->second.loaded) {
+            ++it;
+            continue;
+        }
+
+        for (auto& header : recipient->second.headers) {
+            recipient_by_mail_.erase(header.id);
+        }
+
+        recipients_.erase(recipient);
+        it = recipient_lru_.erase(it);
+    }
+}
+
+
+void MailStore::cacheBody_(const MailBody& body) {
+    if (bodies_.count(body.id)) {
+        return;
+    }
+
+    CachedBody cached;
+    cached.body = body;
+    cached.lru = body_lru_.insert(body_lru_.end(), body.id);
+
+    bodies_.insert(std::make_pair(body.id, cached));
+
+    if (bodies_.size() > kMaxCachedBodies) {
+        bodies_.erase(body_lru_.front());
+        body_lru_.pop_front();
+    }
+}
+
+
+void MailStore::flushMail_() {
+    while (!outgoing_.empty()) {
+        std::shared_ptr<std::vector<OutgoingMail> > batch = std::make_shared<std::vector<OutgoingMail> >();
+
+        std::string sql("SELECT ");
+        size_t count = 0;
+
+        // sf_MailCreate returns the id of the new mail, one column per mail
+        while (count < outgoing_.size() && count < kMaxMailPerStatement && sql.size() < kMaxStatementSize) {
+            const OutgoingMail& outgoing = outgoing_[count];
+            const MailBody& mail = outgoing.mail;
+
+            std::stringstream call;
+            call << (count ? "," : "") << database_->galaxy() << ".sf_MailCreate('"
+                 << escape_(mail.sender) << "'," << outgoing.recipient_id << ",'"
+                 << escape_(mail.subject) << "','"
+                 << escape_(mail.text) << "','"
+                 << escape_(mail.attachments) << "',"
+                 << mail.attachments.size() << "," << mail.time << ")";
+
+            sql += call.str();
+            ++count;
+        }
+
+        batch->assign(outgoing_.begin(), outgoing_.begin() + count);
+        outgoing_.erase(outgoing_.begin(), outgoing_.begin() + count);
+
+        database_->executeAsyncSql(sql, [this, batch] (DatabaseResult* result) {
+            if (!result->getRowCount()) {
+                LOG(WARNING) << "Writing " << batch->size() << " system mails failed";
+                return;
+            }
+
+            std::vector<uint32> ids(batch->size());
+            DataBinding* binding = database_->createDataBinding(static_cast<uint16>(ids.size()));
+
+            for (uint32 i = 0; i < ids.size(); ++i) {
+                binding->addField(DFT_uint32, i * sizeof(uint32), 4, i);
+            }
+
+            result->getNextRow(binding, &ids[0]);
+            database_->destroyDataBinding(binding);
+
+            for (size_t i = 0; i < batch->size(); ++i) {
+                const OutgoingMail& outgoing = (*batch)[i];
+
+                MailHeader header;
+                header.id = ids[i];
+                header.sender = outgoing.mail.sender;
+                header.subject = outgoing.mail.subject;
+                header.time = outgoing.mail.time;
+                header.status = MailStatus_New;
+
+                added(outgoing.recipient_id, header);
+
+                if (outgoing.callback) {
+                    outgoing.callback(header);
+                }
+            }
+        });
+    }
+}
+
+
+void MailStore::flushReads_() {
+    if (queued_reads_.empty()) {
+        return;
+    }
+
+    std::shared_ptr<std::vector<uint32> > ids = std::make_shared<std::vector<uint32> >();
+    ids->swap(queued_reads_);
+
+    std::string sql = std::string("UPDATE ") + database_->galaxy() + ".chat_mail SET status = 1 WHERE id IN (" + idList_(*ids) + ")";
+
+    database_->executeAsyncSql(sql, [this, ids] (DatabaseResult*) {
+        for (uint32 id : *ids) {
+            unflushed_reads_.erase(id);
+        }
+    });
+}
+
+
+void MailStore::flushDeletes_() {
+    if (queued_deletes_.empty()) {
+        return;
+    }
+
+    std::shared_ptr<std::vector<uint32> > ids = std::make_shared<std::vector<uint32> >();
+    ids->swap(queued_deletes_);
+
+    std::string sql = std::string("DELETE FROM ") + database_->galaxy() + ".chat_mail WHERE id IN (" + idList_(*ids) + ")";
+
+    database_->executeAsyncSql(sql, [this, ids] (DatabaseResult*) {
+        for (uint32 id : *ids) {
+            unflushed_deletes_.erase(id);
+        }
+    });
+}
+
+
+std::string MailStore::escape_(const std::string& value) {
+    std::vector<char> escaped(value.size() * 2 + 1);
+    uint32 length = database_->escapeString(&escaped[0], value.data(), static_cast<uint32>(value.size()));
+
+    return std::string(&escaped[0], length);
+}
+
+
+std::string MailStore::idList_(const std::vector<uint32>& ids) {
+    std::stringstream list;
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        list << (i ? "," : "") << ids[i];
+    }
+
+    return list.str();
+}
@@ -0,0 +1,187 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_CHATSERVER_MAILSTORE_H_
+#define SRC_CHATSERVER_MAILSTORE_H_
+
+#include <functional>
+#include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils/typedefs.h"
+
+class Database;
+class DataBinding;
+
+/*! The part of a mail listed in the mail window.
+ */
+struct MailHeader {
+    uint32 id;
+    std::string sender;
+    std::string subject;  // ANSI, as stored
+    uint32 time;
+    uint8 status;         // mail_stats
+};
+
+/*! A full mail as read by its recipient.
+ */
+struct MailBody {
+    uint32 id;
+    std::string sender;
+    std::string subject;
+    std::string text;
+    std::string attachments;  // raw unicode16 data
+    uint32 time;
+};
+
+/*! Chat mail of the galaxy.
+ *
+ * Keeps the mail headers of recent recipients in memory, so a login lists its
+ * mail without calling sp_ReturnChatMailHeaders again. Mail bodies are fetched
+ * one at a time when read and the most recent ones are kept around.
+ *
+ * System mail (auction results, structure notices) is queued and written with
+ * a single statement per batch. Read marks and deletes are queued as well and
+ * flushed with one statement each per interval.
+ */
+class MailStore {
+public:
+    typedef std::function<void (const std::vector<MailHeader>& headers)> HeadersCallback;
+    typedef std::function<void (const MailBody* body)> BodyCallback;
+    typedef std::function<void (const MailHeader& header)> DeliveredCallback;
+
+    explicit MailStore(Database* database);
+    ~MailStore();
+
+    /*! Flushes queued mail, read marks and deletes once due.
+     *
+     * \param current_time The current local time in milliseconds.
+     */
+    void process(uint64 current_time);
+
+    /*! Writes everything queued right away.
+     */
+    void flush();
+
+    /*! Hands the headers of a recipient to the callback, loading them first
+     * unless they are cached.
+     */
+    void getHeaders(uint64 recipient_id, const HeadersCallback& callback);
+
+    /*! Hands the mail to the callback, null if there is no such mail.
+     */
+    void getBody(uint32 mail_id, const BodyCallback& callback);
+
+    /*! Queues a system mail. The callback runs once the mail has its id.
+     */
+    void queueSystemMail(uint64 recipient_id, const MailBody& mail, const DeliveredCallback& callback);
+
+    /*! Records mail written outside of the store.
+     */
+    void added(uint64 recipient_id, const MailHeader& header);
+
+    void markRead(uint32 mail_id);
+    void remove(uint32 mail_id);
+
+    size_t cachedRecipients() const { return recipients_.size(); }
+    size_t queuedMail() const { return outgoing_.size(); }
+
+    /*! Recipients whose headers stay cached, the least recently used are dropped first.
+     */
+    static const uint32 kMaxCachedRecipients = 4096;
+
+private:
+    typedef std::list<uint64> RecipientLru;
+
+    struct Recipient {
+        Recipient() : loaded(false) {}
+
+        std::vector<MailHeader> headers;
+        std::vector<HeadersCallback> waiting;
+        RecipientLru::iterator lru;
+        bool loaded;
+    };
+
+    struct OutgoingMail {
+        uint64 recipient_id;
+        MailBody mail;
+        DeliveredCallback callback;
+    };
+
+    struct CachedBody {
+        MailBody body;
+        std::list<uint32>::iterator lru;
+    };
+
+    typedef std::unordered_map<uint64, Recipient> RecipientMap;
+    typedef std::unordered_map<uint32, uint64> MailRecipientMap;
+    typedef std::unordered_map<uint32, CachedBody> BodyMap;
+    typedef std::unordered_map<uint32, std::vector<BodyCallback> > BodyWaiters;
+
+    void loadHeaders_(uint64 recipient_id);
+    void insertHeader_(Recipient& recipient, uint64 recipient_id, const MailHeader& header);
+    void touch_(Recipient& recipient);
+    void evict_();
+
+    void cacheBody_(const MailBody& body);
+
+    void flushMail_();
+    void flushReads_();
+    void flushDeletes_();
+
+    std::string escape_(const std::string& value);
+    static std::string idList_(const std::vector<uint32>& ids);
+
+    Database* database_;
+    DataBinding* header_binding_;
+    DataBinding* body_binding_;
+
+    RecipientMap recipients_;
+    RecipientLru recipient_lru_;
+    MailRecipientMap recipient_by_mail_;
+
+    BodyMap bodies_;
+    std::list<uint32> body_lru_;
+    BodyWaiters body_waiters_;
+
+    std::vector<OutgoingMail> outgoing_;
+    std::vector<uint32> queued_reads_;
+    std::vector<uint32> queued_deletes_;
+
+    // written by a statement that has not completed yet, applied to header loads
+    std::set<uint32> unflushed_reads_;
+    std::set<uint32> unflushed_deletes_;
+
+    uint64 last_mail_flush_time_;
+    uint64 last_status_flush_time_;
+};
+
+#endif  // SRC_CHATSERVER_MAILSTORE_H_
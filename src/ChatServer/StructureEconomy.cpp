@@ -0,0 +1,492 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "StructureEconomy.h"
+
+#include <map>
+
+//======================================================================================================================
+
+void StructureEconomy::setHarvester(const EconomyHarvesterRow& row)
+{
+    IndexMap::iterator it = mHarvesterIndex.find(row.mId);
+
+    if(it == mHarvesterIndex.end())
+    {
+        mHarvesterIndex.insert(std::make_pair(row.mId,mHarvesterIds.size()));
+
+        mHarvesterIds.push_back(row.mId);
+        mHarvesterResourceIds.push_back(row.mResourceId);
+        mHarvesterRates.push_back(row.mRate);
+        mHopperSizes.push_back(row.mHopperSize);
+        mHopperFills.push_back(row.mHopperFill);
+        mResourceActive.push_back(row.mResourceActive);
+        mHarvesterActive.push_back(1);
+        return;
+    }
+
+    size_t i = it->second;
+
+    mHarvesterResourceIds[i]	= row.mResourceId;
+    mHarvesterRates[i]			= row.mRate;
+    mHopperSizes[i]				= row.mHopperSize;
+    mHopperFills[i]				= row.mHopperFill;
+    mResourceActive[i]			= row.mResourceActive;
+    mHarvesterActive[i]			= 1;
+}
+
+//======================================================================================================================
+
+void StructureEconomy::setPower(const EconomyPowerRow& row)
+{
+    IndexMap::iterator it = mPowerIndex.find(row.mId);
+
+    if(it == mPowerIndex.end())
+    {
+        mPowerIndex.insert(std::make_pair(row.mId,mPowerIds.size()));
+
+        mPowerIds.push_back(row.mId);
+        mPower.push_back(row.mPower);
+        mPowerRates.push_back(row.mPowerRate);
+        mPowered.push_back(1);
+        return;
+    }
+
+    size_t i = it->second;
+
+    mPower[i]		= row.mPower;
+    mPowerRates[i]	= row.mPowerRate;
+    mPowered[i]		= 1;
+}
+
+//======================================================================================================================
+
+void StructureEconomy::setMaintenance(const EconomyMaintenanceRow& row)
+{
+    IndexMap::iterator it = mMaintenanceIndex.find(row.mId);
+
+    if(it == mMaintenanceIndex.end())
+    {
+        mMaintenanceIndex.insert(std::make_pair(row.mId,mMaintenanceIds.size()));
+
+        mMaintenanceIds.push_back(row.mId);
+        mOwners.push_back(row.mOwner);
+        mMaintenance.push_back(row.mMaintenance);
+        mMaintenanceRates.push_back(row.mMaintenanceRate);
+        mDamage.push_back(row.mDamage);
+        mMaxCondition.push_back(row.mMaxCondition);
+        mRepairCosts.push_back(row.mRepairCost);
+        mBankCredits.push_back(row.mBankCredits);
+        return;
+    }
+
+    size_t i = it->second;
+
+    mOwners[i]				= row.mOwner;
+    mMaintenance[i]			= row.mMaintenance;
+    mMaintenanceRates[i]	= row.mMaintenanceRate;
+    mDamage[i]				= row.mDamage;
+    mMaxCondition[i]		= row.mMaxCondition;
+    mRepairCosts[i]			= row.mRepairCost;
+    mBankCredits[i]			= row.mBankCredits;
+}
+
+//======================================================================================================================
+//
+// the listed harvesters are the active ones, switched off or destroyed harvesters drop out
+//
+void StructureEconomy::syncHarvesters(const std::vector<EconomyHarvesterState>& states, std::vector<uint64>& stale)
+{
+    std::map<uint64,const EconomyHarvesterState*> listed;
+
+    for(size_t i = 0; i < states.size(); i++)
+    {
+        listed.insert(std::make_pair(states[i].mId,&states[i]));
+    }
+
+    // backwards, the slot of a removed harvester is taken by one already checked
+    for(size_t i = mHarvesterIds.size(); i-- > 0;)
+    {
+        if(!listed.count(mHarvesterIds[i]))
+            _removeHarvester(i);
+    }
+
+    for(size_t i = 0; i < states.size(); i++)
+    {
+        const EconomyHarvesterState& state = states[i];
+        IndexMap::const_iterator it = mHarvesterIndex.find(state.mId);
+
+        // a new resource comes with a new rate
+        if(it == mHarvesterIndex.end() || mHarvesterResourceIds[it->second] != state.mResourceId)
+        {
+            stale.push_back(state.mId);
+            continue;
+        }
+
+        mResourceActive[it->second]		= state.mResourceActive;
+        mHarvesterActive[it->second]	= 1;
+    }
+}
+
+//======================================================================================================================
+
+void StructureEconomy::syncPower(const std::vector<uint64>& ids, std::vector<uint64>& stale)
+{
+    std::map<uint64,size_t> listed;
+
+    for(size_t i = 0; i < ids.size(); i++)
+    {
+        listed.insert(std::make_pair(ids[i],i));
+    }
+
+    for(size_t i = mPowerIds.size(); i-- > 0;)
+    {
+        if(!listed.count(mPowerIds[i]))
+            _removePower(i);
+    }
+
+    for(size_t i = 0; i < ids.size(); i++)
+    {
+        IndexMap::const_iterator it = mPowerIndex.find(ids[i]);
+
+        if(it == mPowerIndex.end())
+        {
+            stale.push_back(ids[i]);
+            continue;
+        }
+
+        mPowered[it->second] = 1;
+    }
+}
+
+//======================================================================================================================
+
+void StructureEconomy::syncMaintenance(const std::vector<uint64>& ids, std::vector<uint64>& stale)
+{
+    std::map<uint64,size_t> listed;
+
+    for(size_t i = 0; i < ids.size(); i++)
+    {
+        listed.insert(std::make_pair(ids[i],i));
+    }
+
+    for(size_t i = mMaintenanceIds.size(); i-- > 0;)
+    {
+        if(!listed.count(mMaintenanceIds[i]))
+            _removeMaintenance(i);
+    }
+
+    for(size_t i = 0; i < ids.size(); i++)
+    {
+        if(!mMaintenanceIndex.count(ids[i]))
+            stale.push_back(ids[i]);
+    }
+}
+
+//======================================================================================================================
+//
+// harvesters whose hopper fills up, the zone may have emptied it meanwhile
+//
+void StructureEconomy::getHarvestersDue(float minutes, std::vector<uint64>& ids) const
+{
+    for(size_t i = 0; i < mHarvesterIds.size(); i++)
+    {
+        if(mHarvesterActive[i] && mResourceActive[i] && mHopperFills[i] + mHarvesterRates[i] * minutes >= mHopperSizes[i])
+            ids.push_back(mHarvesterIds[i]);
+    }
+}
+
+//======================================================================================================================
+//
+// harvesters running out of power, the owner may have deposited some meanwhile
+//
+void StructureEconomy::getPowerDue(float hours, std::vector<uint64>& ids) const
+{
+    for(size_t i = 0; i < mPowerIds.size(); i++)
+    {
+        if(mPower[i] < static_cast<uint32>(mPowerRates[i] * hours))
+            ids.push_back(mPowerIds[i]);
+    }
+}
+
+//======================================================================================================================
+//
+// structures whose pool does not cover the maintenance, the bank and the condition are read with them
+//
+void StructureEconomy::getMaintenanceDue(float hours, std::vector<uint64>& ids) const
+{
+    for(size_t i = 0; i < mMaintenanceIds.size(); i++)
+    {
+        if(mMaintenance[i] < static_cast<uint32>(mMaintenanceRates[i] * hours / 168.0f))
+            ids.push_back(mMaintenanceIds[i]);
+    }
+}
+
+//======================================================================================================================
+
+void StructureEconomy::_removeHarvester(size_t index)
+{
+    size_t last = mHarvesterIds.size() - 1;
+
+    mHarvesterIndex.erase(mHarvesterIds[index]);
+
+    if(index != last)
+    {
+        mHarvesterIndex[mHarvesterIds[last]] = index;
+
+        mHarvesterIds[index]			= mHarvesterIds[last];
+        mHarvesterResourceIds[index]	= mHarvesterResourceIds[last];
+        mHarvesterRates[index]			= mHarvesterRates[last];
+        mHopperSizes[index]				= mHopperSizes[last];
+        mHopperFills[index]				= mHopperFills[last];
+        mResourceActive[index]			= mResourceActive[last];
+        mHarvesterActive[index]			= mHarvesterActive[last];
+    }
+
+    mHarvesterIds.pop_back();
+    mHarvesterResourceIds.pop_back();
+    mHarvesterRates.pop_back();
+    mHopperSizes.pop_back();
+    mHopperFills.pop_back();
+    mResourceActive.pop_back();
+    mHarvesterActive.pop_back();
+}
+
+//======================================================================================================================
+
+void StructureEconomy::_removePower(size_t index)
+{
+    size_t last = mPowerIds.size() - 1;
+
+    mPowerIndex.erase(mPowerIds[index]);
+
+    if(index != last)
+    {
+        mPowerIndex[mPowerIds[last]] = index;
+
+        mPowerIds[index]	= mPowerIds[last];
+        mPower[index]		= mPower[last];
+        mPowerRates[index]	= mPowerRates[last];
+        mPowered[index]		= mPowered[last];
+    }
+
+    mPowerIds.pop_back();
+    mPower.pop_back();
+    mPowerRates.pop_back();
+    mPowered.pop_back();
+}
+
+//======================================================================================================================
+
+void StructureEconomy::_removeMaintenance(size_t index)
+{
+    size_t last = mMaintenanceIds.size() - 1;
+
+    mMaintenanceIndex.erase(mMaintenanceIds[index]);
+
+    if(index != last)
+    {
+        mMaintenanceIndex[mMaintenanceIds[last]] = index;
+
+        mMaintenanceIds[index]		= mMaintenanceIds[last];
+        mOwners[index]				= mOwners[last];
+        mMaintenance[index]			= mMaintenance[last];
+        mMaintenanceRates[index]	= mMaintenanceRates[last];
+        mDamage[index]				= mDamage[last];
+        mMaxCondition[index]		= mMaxCondition[last];
+        mRepairCosts[index]			= mRepairCosts[last];
+        mBankCredits[index]			= mBankCredits[last];
+    }
+
+    mMaintenanceIds.pop_back();
+    mOwners.pop_back();
+    mMaintenance.pop_back();
+    mMaintenanceRates.pop_back();
+    mDamage.pop_back();
+    mMaxCondition.pop_back();
+    mRepairCosts.pop_back();
+    mBankCredits.pop_back();
+}
+
+//======================================================================================================================
+//
+// fills the hoppers of all active harvesters
+// a harvester shuts down once its hopper is full or its resource despawned
+//
+void StructureEconomy::advanceHarvesters(float minutes, EconomyHarvestResult& result)
+{
+    size_t count = mHarvesterIds.size();
+
+    // first pass is branch free so the compiler can vectorize it
+    std::vector<float> amounts(count);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        float space	= mHopperSizes[i] - mHopperFills[i];
+        float amount	= mHarvesterRates[i] * minutes * mResourceActive[i] * mHarvesterActive[i];
+
+        amounts[i] = (amount < space) ? amount : space;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if(!mHarvesterActive[i])
+            continue;
+
+        if(amounts[i] > 0.0f)
+        {
+            mHopperFills[i] += amounts[i];
+
+            result.mIds.push_back(mHarvesterIds[i]);
+            result.mResourceIds.push_back(mHarvesterResourceIds[i]);
+            result.mAmounts.push_back(amounts[i]);
+        }
+
+        if(!mResourceActive[i] || mHopperFills[i] >= mHopperSizes[i])
+        {
+            mHarvesterActive[i] = 0;
+            result.mShutdownIds.push_back(mHarvesterIds[i]);
+        }
+    }
+}
+
+//======================================================================================================================
+//
+// takes the hourly power from all active harvesters, those running dry shut down
+//
+void StructureEconomy::advancePower(float hours, EconomyPowerResult& result)
+{
+    size_t count = mPowerIds.size();
+
+    std::vector<uint32> used(count);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        uint32 due = static_cast<uint32>(mPowerRates[i] * hours) * mPowered[i];
+
+        used[i]		= (due < mPower[i]) ? due : mPower[i];
+        mPower[i]	-= used[i];
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if(!mPowered[i])
+            continue;
+
+        if(used[i])
+        {
+            result.mIds.push_back(mPowerIds[i]);
+            result.mUsed.push_back(used[i]);
+        }
+
+        if(used[i] < static_cast<uint32>(mPowerRates[i] * hours))
+        {
+            mPowered[i] = 0;
+            result.mShutdownIds.push_back(mPowerIds[i]);
+        }
+    }
+}
+
+//======================================================================================================================
+//
+// takes the maintenance from the structures pool, then from the owners bank
+// whatever cannot be paid damages the structure at its repair cost
+//
+void StructureEconomy::advanceMaintenance(float hours, EconomyMaintenanceResult& result)
+{
+    size_t count = mMaintenanceIds.size();
+
+    std::vector<uint32> due(count);
+    std::vector<uint32> fromPool(count);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        due[i]				= static_cast<uint32>(mMaintenanceRates[i] * hours / 168.0f);
+        fromPool[i]			= (due[i] < mMaintenance[i]) ? due[i] : mMaintenance[i];
+        mMaintenance[i]		-= fromPool[i];
+    }
+
+    // owners with several structures pay all of them from the same bank
+    std::map<uint64,uint32> banks;
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if(fromPool[i])
+        {
+            result.mIds.push_back(mMaintenanceIds[i]);
+            result.mUsed.push_back(fromPool[i]);
+        }
+
+        uint32 missing = due[i] - fromPool[i];
+
+        if(!missing)
+            continue;
+
+        std::map<uint64,uint32>::iterator bankIt = banks.find(mOwners[i]);
+
+        if(bankIt == banks.end())
+            bankIt = banks.insert(std::make_pair(mOwners[i],mBankCredits[i])).first;
+
+        uint32 fromBank = (missing < bankIt->second) ? missing : bankIt->second;
+
+        bankIt->second	-= fromBank;
+        missing			-= fromBank;
+
+        if(fromBank)
+        {
+            result.mBankOwners.push_back(mOwners[i]);
+            result.mBankUsed.push_back(fromBank);
+        }
+
+        if(!missing)
+        {
+            result.mNotifyIds.push_back(mMaintenanceIds[i]);
+            result.mNotifyStatus.push_back(EconomyMaintenance_FromBank);
+            continue;
+        }
+
+        uint32 repairCost	= mRepairCosts[i] ? mRepairCosts[i] : 1;
+        uint32 damage		= (missing + repairCost - 1) / repairCost;
+
+        if(mDamage[i] + damage > mMaxCondition[i])
+            damage = (mMaxCondition[i] > mDamage[i]) ? mMaxCondition[i] - mDamage[i] : 0;
+
+        mDamage[i] += damage;
+
+        if(damage)
+        {
+            result.mDamagedIds.push_back(mMaintenanceIds[i]);
+            result.mDamageAdded.push_back(damage);
+        }
+
+        result.mNotifyIds.push_back(mMaintenanceIds[i]);
+        result.mNotifyStatus.push_back((mDamage[i] >= mMaxCondition[i]) ? EconomyMaintenance_Condemned : EconomyMaintenance_Damaged);
+    }
+}
+
+//======================================================================================================================
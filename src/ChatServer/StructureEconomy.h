@@ -0,0 +1,218 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_CHATSERVER_STRUCTUREECONOMY_H
+#define ANH_CHATSERVER_STRUCTUREECONOMY_H
+
+#include "Utils/typedefs.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+//======================================================================================================================
+//
+// structure_attributes the economy reads and writes
+//
+
+enum EconomyAttribute
+{
+    EconomyAttribute_HopperSize		= 381,	// examine_hoppersize
+    EconomyAttribute_Maintenance	= 382,	// examine_maintenance
+    EconomyAttribute_Power			= 384	// examine_power
+};
+
+//======================================================================================================================
+//
+// rows as they come out of the economy queries
+//
+
+struct EconomyHarvesterRow
+{
+    uint64	mId;
+    uint64	mResourceId;
+    float	mRate;			// units per minute, already scaled by the resource concentration
+    float	mHopperSize;
+    float	mHopperFill;
+    uint8	mResourceActive;
+};
+
+// the part of an active harvester the zone changes, read every cycle
+struct EconomyHarvesterState
+{
+    uint64	mId;
+    uint64	mResourceId;
+    uint8	mResourceActive;
+};
+
+struct EconomyPowerRow
+{
+    uint64	mId;
+    uint32	mPower;
+    uint32	mPowerRate;		// per hour
+};
+
+struct EconomyMaintenanceRow
+{
+    uint64	mId;
+    uint64	mOwner;
+    uint32	mMaintenance;
+    uint32	mMaintenanceRate;	// per week
+    uint32	mDamage;
+    uint32	mMaxCondition;
+    uint32	mRepairCost;
+    uint32	mBankCredits;
+};
+
+//======================================================================================================================
+//
+// what a pass changed, written back in batches
+//
+
+struct EconomyHarvestResult
+{
+    std::vector<uint64>	mIds;
+    std::vector<uint64>	mResourceIds;
+    std::vector<float>	mAmounts;
+
+    std::vector<uint64>	mShutdownIds;		// hopper full or resource despawned
+};
+
+struct EconomyPowerResult
+{
+    std::vector<uint64>	mIds;
+    std::vector<uint32>	mUsed;
+
+    std::vector<uint64>	mShutdownIds;		// out of power
+};
+
+enum EconomyMaintenanceStatus
+{
+    EconomyMaintenance_Paid			= 0,
+    EconomyMaintenance_FromBank		= 1,
+    EconomyMaintenance_Damaged		= 2,
+    EconomyMaintenance_Condemned	= 3
+};
+
+struct EconomyMaintenanceResult
+{
+    std::vector<uint64>	mIds;
+    std::vector<uint32>	mUsed;
+
+    std::vector<uint64>	mBankOwners;
+    std::vector<uint32>	mBankUsed;
+
+    std::vector<uint64>	mDamagedIds;
+    std::vector<uint32>	mDamageAdded;
+
+    // structures whose owner needs to be told, with their EconomyMaintenanceStatus
+    std::vector<uint64>	mNotifyIds;
+    std::vector<uint32>	mNotifyStatus;
+};
+
+//======================================================================================================================
+//
+// Runs the harvester and maintenance economy of all player structures in memory.
+// The state is kept column wise so each tick is a single pass over flat arrays,
+// the chat handler writes the results back in batches.
+//
+// The state is loaded once and kept. Each cycle the chat handler only reads which structures
+// exist (and the resource of each active harvester), the sync calls drop the structures that
+// are gone and report the ids whose rows have to be read again: new ones, harvesters that
+// switched resources and those the next pass would shut down or damage. Deposits and
+// withdrawals the zone made since are picked up by that last read, before anything is
+// decided on them.
+//
+
+class StructureEconomy
+{
+public:
+
+    // adds the structure or replaces its state
+    void	setHarvester(const EconomyHarvesterRow& row);
+    void	setPower(const EconomyPowerRow& row);
+    void	setMaintenance(const EconomyMaintenanceRow& row);
+
+    // drops the structures not listed, stale receives the listed ones not loaded or changed
+    void	syncHarvesters(const std::vector<EconomyHarvesterState>& states, std::vector<uint64>& stale);
+    void	syncPower(const std::vector<uint64>& ids, std::vector<uint64>& stale);
+    void	syncMaintenance(const std::vector<uint64>& ids, std::vector<uint64>& stale);
+
+    // the structures the next pass would shut down or damage, their rows are read again first
+    void	getHarvestersDue(float minutes, std::vector<uint64>& ids) const;
+    void	getPowerDue(float hours, std::vector<uint64>& ids) const;
+    void	getMaintenanceDue(float hours, std::vector<uint64>& ids) const;
+
+    size_t	getHarvesterCount() const { return mHarvesterIds.size(); }
+    size_t	getPowerCount() const { return mPowerIds.size(); }
+    size_t	getMaintenanceCount() const { return mMaintenanceIds.size(); }
+
+    void	advanceHarvesters(float minutes, EconomyHarvestResult& result);
+    void	advancePower(float hours, EconomyPowerResult& result);
+    void	advanceMaintenance(float hours, EconomyMaintenanceResult& result);
+
+private:
+
+    typedef std::map<uint64,size_t>	IndexMap;
+
+    // swap the last structure into the slot
+    void	_removeHarvester(size_t index);
+    void	_removePower(size_t index);
+    void	_removeMaintenance(size_t index);
+
+    // harvesters
+    IndexMap				mHarvesterIndex;
+    std::vector<uint64>		mHarvesterIds;
+    std::vector<uint64>		mHarvesterResourceIds;
+    std::vector<float>		mHarvesterRates;
+    std::vector<float>		mHopperSizes;
+    std::vector<float>		mHopperFills;
+    std::vector<uint8>		mResourceActive;
+    std::vector<uint8>		mHarvesterActive;
+
+    // power
+    IndexMap				mPowerIndex;
+    std::vector<uint64>		mPowerIds;
+    std::vector<uint32>		mPower;
+    std::vector<uint32>		mPowerRates;
+    std::vector<uint8>		mPowered;
+
+    // maintenance
+    IndexMap				mMaintenanceIndex;
+    std::vector<uint64>		mMaintenanceIds;
+    std::vector<uint64>		mOwners;
+    std::vector<uint32>		mMaintenance;
+    std::vector<uint32>		mMaintenanceRates;
+    std::vector<uint32>		mDamage;
+    std::vector<uint32>		mMaxCondition;
+    std::vector<uint32>		mRepairCosts;
+    std::vector<uint32>		mBankCredits;
+};
+
+#endif
+
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "StructureManagerChat.h"
 #include "TradeManagerChat.h"
 
+#include "ZoneServer/PlayerEnums.h"
 #include "ZoneServer/TangibleEnums.h"
 
 // Fix for issues with glog redefining this constant
@@ -42,6 +43,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/QueryChain.h"
 
 #include "Common/atMacroString.h"
 #include "NetworkManager/DispatchClient.h"
@@ -54,8 +56,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <ctime>
+#include <map>
+#include <memory>
+#include <sstream>
 
 
 //=========================================================================================
@@ -63,6 +69,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 bool								StructureManagerChatHandler::mInsFlag    = false;
 StructureManagerChatHandler*		StructureManagerChatHandler::mSingleton  = NULL;
 
+// rows per batched economy write
+static const size_t					kEconomyBatchSize = 250;
+
 //=========================================================================================
 
 
@@ -353,478 +362,623 @@ void StructureManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseRe
     }
     break;
 
-    //=================================================
-    //
-    //we deducted the maintenance - or tried too
-    //read out the answer and proceed
-    case STRMQuery_DoneStructureMaintenance:
-    {
-        uint32 exitCode;
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint32,0,4);
-
-        if (!result->getRowCount()) {
-           	return;
-        }
-
-        //return codes :
-        // 0 everything ok
-        // 1 structure is out of maintenance  - taking maint out of the bank
-        // 2 structure got damaged
-        // 3 condition is zero
+    default:
+        break;
+    }
+    SAFE_DELETE(asynContainer);
+}
 
+//=======================================================================================================================
 
-        result->getNextRow(binding,&exitCode);
+//=======================================================================================================================
 
-        if(exitCode == 1)// 1 structure is out of maintenance
-        {
-            // get the Owners ID
-            int8 sql[500];
 
-            //inform the owner on the maintenance issue
-            sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, s.lastMail FROM %s.structures s INNER JOIN %s.structure_type_data st ON (s.type = st.type) INNER JOIN %s.planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),asynContainer->harvesterID);
-            StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailOOFMaint,0);
-            asyncContainer->harvesterID = asynContainer->harvesterID;
+//=======================================================================================================================
+void StructureManagerChatHandler::handleTimer(uint32 id, void* container)
+{
+    boost::mutex::scoped_lock lock(mTimerMutex);
+    mTimerEventQueue.push(id);
+}
 
-            mDatabase->executeSqlAsync(this,asyncContainer,sql);
+//=======================================================================================================================
+void StructureManagerChatHandler::processTimerEvents()
+{
+    uint64	startTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+    uint64	processTime = 0;
+    while(mTimerEventQueue.size() && processTime < mTimerQueueProcessTimeLimit)
+    {
+        boost::mutex::scoped_lock lock(mTimerMutex);
+        uint32 id = mTimerEventQueue.front();
+        mTimerEventQueue.pop();
+        lock.unlock();
 
+        switch(id)
+        {
+            //handles the harvesters Maintenance updates
+        case SRMTimer_CheckHarvesterMaintenance:
+        {
+            handleCheckHarvesterMaintenance();
         }
+        break;
 
-        if(exitCode == 2)// 2 structure got damaged
+        //handles the harvesters hopper and power -updates
+        case SRMTimer_CheckHarvesterHopper:
         {
-            // get the Owners ID
-            int8 sql[500];
-
-            //start by using power
-            sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, s.condition, s.lastMail FROM %s.structures s INNER JOIN %s.structure_type_data st ON (s.type = st.type) INNER JOIN %s.planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),asynContainer->harvesterID);
-            StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailDamage,0);
-            asyncContainer->harvesterID = asynContainer->harvesterID;
-
-            mDatabase->executeSqlAsync(this,asyncContainer,sql);
-
+            handleCheckHarvesterHopper();
         }
+        break;
 
-        if(exitCode == 3)// 1 structure is out of maintenance
+        case SRMTimer_CheckFactory:
         {
-            // get the Owners ID
-            int8 sql[500];
-
-            //start by using power
-            sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, st.maint_cost_wk, s.lastMail FROM %s.structures s INNER JOIN %s.structure_type_data st ON (s.type = st.type) INNER JOIN %s.planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),asynContainer->harvesterID);
-            StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailCondZero,0);
-            asyncContainer->harvesterID = asynContainer->harvesterID;
-
-            mDatabase->executeSqlAsync(this,asyncContainer,sql);
-
+            handleFactoryUpdate();
         }
+        break;
 
-
-        if(exitCode > 3)
+        case SRMTimer_CheckHarvesterPower:
         {
-            //unspecified db error
-
-            //most likely the structure reached condition zero and awaits destruction
+            handleCheckHarvesterPower();
         }
+        break;
 
+        default:
+            break;
+        }
 
-        mDatabase->destroyDataBinding(binding);
-
+        processTime = Anh_Utils::Clock::getSingleton()->getLocalTime() - startTime;
     }
-    break;
+}
 
-    case STRMQuery_DoneHarvesterUsePower:
-    {
-        uint32 exitCode;
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint32,0,4);
+//=======================================================================================================================
+//
+// the economy state is loaded once, each cycle only reads which harvesters run and re-reads the changed ones
+// power and hopper share the set of active harvesters
+//
+std::string StructureManagerChatHandler::_harvesterStateQuery()
+{
+    std::stringstream query;
+    query << "SELECT h.ID, h.ResourceID, r.active"
+          << " FROM " << mDatabase->galaxy() << ".harvesters h"
+          << " INNER JOIN " << mDatabase->galaxy() << ".resources r ON (r.id = h.ResourceID)"
+          << " WHERE h.active > 0";
 
-        if (!result->getRowCount()) {
-           	return;
-        }
+    return query.str();
+}
 
-        //return codes :
-        // 0 everything ok
-        // 1 structure is out of power
-        // 2
-        // 3 unspecified db error
+//=======================================================================================================================
 
+std::string StructureManagerChatHandler::_harvesterQuery(const std::vector<uint64>* ids)
+{
+    std::stringstream query;
+    query << "SELECT h.ID, h.ResourceID, h.rate, CAST(IFNULL(sa.value,3000) AS DECIMAL(12,2)),"
+          << " IFNULL((SELECT SUM(hr.quantity) FROM " << mDatabase->galaxy() << ".harvester_resources hr WHERE hr.ID = h.ID),0), r.active"
+          << " FROM " << mDatabase->galaxy() << ".harvesters h"
+          << " INNER JOIN " << mDatabase->galaxy() << ".resources r ON (r.id = h.ResourceID)"
+          << " LEFT JOIN " << mDatabase->galaxy() << ".structure_attributes sa ON (sa.structure_id = h.ID AND sa.attribute_id = " << EconomyAttribute_HopperSize << ")"
+          << " WHERE h.active > 0";
+
+    if(ids)
+        query << " AND h.ID IN (" << _buildIdList(*ids,0,ids->size()) << ")";
+
+    return query.str();
+}
 
-        result->getNextRow(binding,&exitCode);
+//=======================================================================================================================
 
-        // cant notify zone when no player is online
-        // zone will update harvesterstatus once per hour
+std::string StructureManagerChatHandler::_powerQuery(const std::vector<uint64>* ids)
+{
+    std::stringstream query;
+    query << "SELECT h.ID, CAST(IFNULL(sa.value,0) AS UNSIGNED), std.power_used"
+          << " FROM " << mDatabase->galaxy() << ".harvesters h"
+          << " INNER JOIN " << mDatabase->galaxy() << ".structures s ON (s.ID = h.ID)"
+          << " INNER JOIN " << mDatabase->galaxy() << ".structure_type_data std ON (std.type = s.type)"
+          << " LEFT JOIN " << mDatabase->galaxy() << ".structure_attributes sa ON (sa.structure_id = h.ID AND sa.attribute_id = " << EconomyAttribute_Power << ")"
+          << " WHERE h.active > 0";
+
+    if(ids)
+        query << " AND h.ID IN (" << _buildIdList(*ids,0,ids->size()) << ")";
+
+    return query.str();
+}
 
-        // only reason for us tzo handle this event here  would be if we wanted to inform the player
+//=======================================================================================================================
 
-        if(exitCode == 3)
-        {
-            //unspecified db error
-            LOG(WARNING) << "StructureManagerChat::HarvesterPowerUsage "<< asynContainer->harvesterID <<" unspecified db error" ;
-        }
+std::string StructureManagerChatHandler::_maintenanceQuery(const std::vector<uint64>* ids)
+{
+    std::stringstream query;
+    query << "SELECT s.ID, s.owner, CAST(IFNULL(sa.value,0) AS UNSIGNED), std.maint_cost_wk, s.condition, std.max_condition, std.repair_cost, IFNULL(b.credits,0)"
+          << " FROM " << mDatabase->galaxy() << ".structures s"
+          << " INNER JOIN " << mDatabase->galaxy() << ".structure_type_data std ON (std.type = s.type)"
+          << " LEFT JOIN " << mDatabase->galaxy() << ".structure_attributes sa ON (sa.structure_id = s.ID AND sa.attribute_id = " << EconomyAttribute_Maintenance << ")"
+          << " LEFT JOIN " << mDatabase->galaxy() << ".banks b ON (b.id = s.owner + " << BANK_OFFSET << ")";
 
+    if(ids)
+        query << " WHERE s.ID IN (" << _buildIdList(*ids,0,ids->size()) << ")";
 
-        mDatabase->destroyDataBinding(binding);
+    return query.str();
+}
 
-    }
-    break;
+//=======================================================================================================================
 
-    case STRMQuery_DoneFactoryUpdate:
+void StructureManagerChatHandler::_readHarvesterRows(DatabaseResult* result)
+{
+    EconomyHarvesterRow row;
+
+    DataBinding* binding = mDatabase->createDataBinding(6);
+    binding->addField(DFT_uint64,offsetof(EconomyHarvesterRow,mId),8,0);
+    binding->addField(DFT_uint64,offsetof(EconomyHarvesterRow,mResourceId),8,1);
+    binding->addField(DFT_float,offsetof(EconomyHarvesterRow,mRate),4,2);
+    binding->addField(DFT_float,offsetof(EconomyHarvesterRow,mHopperSize),4,3);
+    binding->addField(DFT_float,offsetof(EconomyHarvesterRow,mHopperFill),4,4);
+    binding->addField(DFT_uint8,offsetof(EconomyHarvesterRow,mResourceActive),1,5);
+
+    uint64 count = result->getRowCount();
+    for(uint64 i=0; i <count; i++)
     {
-        uint32 exitCode;
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint32,0,4);
-
-        uint64 count;
-        count = result->getRowCount();
-
-        //return codes :
-        // 0 everything ok
-        // 1
-        // 2
-        // 3
-
-
-        for(uint64 i=0; i <count; i++)
-        {
-            result->getNextRow(binding,&exitCode);
-
-            if(exitCode == 1)
-            {
-                //resource never existed in the first place
-            }
-            if(exitCode == 2)
-            {
-                //resource never existed in the first place
-            }
-            if(exitCode == 3)
-            {
-                //resource never existed in the first place
-            }
+        result->getNextRow(binding,&row);
+        mEconomy.setHarvester(row);
+    }
 
-        }
+    mDatabase->destroyDataBinding(binding);
+}
 
-        mDatabase->destroyDataBinding(binding);
+//=======================================================================================================================
 
+void StructureManagerChatHandler::_readPowerRows(DatabaseResult* result)
+{
+    EconomyPowerRow row;
 
-    }
-    break;
+    DataBinding* binding = mDatabase->createDataBinding(3);
+    binding->addField(DFT_uint64,offsetof(EconomyPowerRow,mId),8,0);
+    binding->addField(DFT_uint32,offsetof(EconomyPowerRow,mPower),4,1);
+    binding->addField(DFT_uint32,offsetof(EconomyPowerRow,mPowerRate),4,2);
 
-    case STRMQuery_DoneHarvestUpdate:
+    uint64 count = result->getRowCount();
+    for(uint64 i=0; i <count; i++)
     {
-        uint32 exitCode;
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint32,0,4);
+        result->getNextRow(binding,&row);
+        mEconomy.setPower(row);
+    }
 
-        uint64 count;
-        count = result->getRowCount();
+    mDatabase->destroyDataBinding(binding);
+}
 
-        //return codes :
-        // 0 everything ok
-        // 1 hopper full harvester turned of
-        // 2 resource isnt active anymore
-        // 3 resource doesnt exist in the first place
+//=======================================================================================================================
 
+void StructureManagerChatHandler::_readMaintenanceRows(DatabaseResult* result)
+{
+    EconomyMaintenanceRow row;
+
+    DataBinding* binding = mDatabase->createDataBinding(8);
+    binding->addField(DFT_uint64,offsetof(EconomyMaintenanceRow,mId),8,0);
+    binding->addField(DFT_uint64,offsetof(EconomyMaintenanceRow,mOwner),8,1);
+    binding->addField(DFT_uint32,offsetof(EconomyMaintenanceRow,mMaintenance),4,2);
+    binding->addField(DFT_uint32,offsetof(EconomyMaintenanceRow,mMaintenanceRate),4,3);
+    binding->addField(DFT_uint32,offsetof(EconomyMaintenanceRow,mDamage),4,4);
+    binding->addField(DFT_uint32,offsetof(EconomyMaintenanceRow,mMaxCondition),4,5);
+    binding->addField(DFT_uint32,offsetof(EconomyMaintenanceRow,mRepairCost),4,6);
+    binding->addField(DFT_uint32,offsetof(EconomyMaintenanceRow,mBankCredits),4,7);
+
+    uint64 count = result->getRowCount();
+    for(uint64 i=0; i <count; i++)
+    {
+        result->getNextRow(binding,&row);
+        mEconomy.setMaintenance(row);
+    }
 
-        for(uint64 i=0; i <count; i++)
-        {
-            result->getNextRow(binding,&exitCode);
+    mDatabase->destroyDataBinding(binding);
+}
 
-            if(exitCode == 1)
-            {
-                //resource never existed in the first place
-				DLOG(INFO ) << "StructureMabagerChat::Harvester "<<asynContainer->harvesterID << " hopper full";
-            }
-            if(exitCode == 2)
-            {
-                //resource never existed in the first place
-                DLOG(INFO) << "StructureMabagerChat::Harvester "<< asynContainer->harvesterID << " resourcechange";
-            }
-            if(exitCode == 3)
-            {
-                //resource never existed in the first place
-               DLOG(INFO) << "StructureMabagerChat::Harvester "<< asynContainer->harvesterID <<" harvested an invalid resource";
-            }
+//=======================================================================================================================
 
-        }
+std::vector<uint64> StructureManagerChatHandler::_readIds(DatabaseResult* result)
+{
+    std::vector<uint64> ids;
+    uint64 id;
 
-        mDatabase->destroyDataBinding(binding);
+    DataBinding* binding = mDatabase->createDataBinding(1);
+    binding->addField(DFT_uint64,0,8,0);
 
+    uint64 count = result->getRowCount();
+    for(uint64 i=0; i <count; i++)
+    {
+        result->getNextRow(binding,&id);
+        ids.push_back(id);
     }
-    break;
 
-    case STRMQuery_MaintenanceUpdate:
-    {
-        uint64 harvesterID;
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint64,0,8);
+    mDatabase->destroyDataBinding(binding);
+    return ids;
+}
 
-        uint64 count;
-        count = result->getRowCount();
+//=======================================================================================================================
+//
+// takes the hourly power from all active harvesters in one pass
+// harvesters about to run dry are read again first, their owners may have deposited power meanwhile
+//
+void StructureManagerChatHandler::handleCheckHarvesterPower()
+{
+    std::shared_ptr<std::vector<uint64> > stale(new std::vector<uint64>());
+    std::shared_ptr<bool> loadAll(new bool(false));
+
+    QueryChain::create(mDatabase)
+        ->then(_harvesterStateQuery(), [this, stale, loadAll] (DatabaseResult* result) {
+            std::vector<uint64> ids = _readIds(result);
+
+            *loadAll = !mEconomy.getPowerCount();
+
+            mEconomy.syncPower(ids,*stale);
+            mEconomy.getPowerDue(1.0f,*stale);
+            return true;
+        })
+        .thenBuild([this, stale, loadAll] () {
+            if(*loadAll)
+                return _powerQuery(NULL);
+
+            return stale->empty() ? std::string() : _powerQuery(stale.get());
+        }, [this] (DatabaseResult* result) {
+            _readPowerRows(result);
+            return true;
+        })
+        .finally([this] () {
+            EconomyPowerResult power;
+            mEconomy.advancePower(1.0f,power);
+
+            _writePowerResult(power);
+        })
+        .execute();
+}
 
-        for(uint64 i=0; i <count; i++)
-        {
-            result->getNextRow(binding,&harvesterID);
+//=======================================================================================================================
+//
+// fills the hoppers of all active harvesters in one pass, the hopper timer fires once a minute
+// harvesters whose hopper is about to fill up are read again first, the zone may have emptied them meanwhile
+//
+void StructureManagerChatHandler::handleCheckHarvesterHopper()
+{
+    std::shared_ptr<std::vector<uint64> > stale(new std::vector<uint64>());
+    std::shared_ptr<bool> loadAll(new bool(false));
 
-            int8 sql[100];
+    QueryChain::create(mDatabase)
+        ->then(_harvesterStateQuery(), [this, stale, loadAll] (DatabaseResult* result) {
+            std::vector<EconomyHarvesterState> states;
+            EconomyHarvesterState state;
 
-            // then use maintenance
-            sprintf(sql, "SELECT %s.sf_HarvesterUseMaintenance(%"PRIu64")", mDatabase->galaxy(),  harvesterID);
-            StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneStructureMaintenance,0);
-            asyncContainer->harvesterID = harvesterID;
+            DataBinding* binding = mDatabase->createDataBinding(3);
+            binding->addField(DFT_uint64,offsetof(EconomyHarvesterState,mId),8,0);
+            binding->addField(DFT_uint64,offsetof(EconomyHarvesterState,mResourceId),8,1);
+            binding->addField(DFT_uint8,offsetof(EconomyHarvesterState,mResourceActive),1,2);
 
-            mDatabase->executeSqlAsync(this,asyncContainer,sql);
+            uint64 count = result->getRowCount();
+            for(uint64 i=0; i <count; i++)
+            {
+                result->getNextRow(binding,&state);
+                states.push_back(state);
+            }
 
-        }
+            mDatabase->destroyDataBinding(binding);
 
-        mDatabase->destroyDataBinding(binding);
-    }
-    break;
+            *loadAll = !mEconomy.getHarvesterCount();
+
+            mEconomy.syncHarvesters(states,*stale);
+            mEconomy.getHarvestersDue(1.0f,*stale);
+            return true;
+        })
+        .thenBuild([this, stale, loadAll] () {
+            if(*loadAll)
+                return _harvesterQuery(NULL);
+
+            return stale->empty() ? std::string() : _harvesterQuery(stale.get());
+        }, [this] (DatabaseResult* result) {
+            _readHarvesterRows(result);
+            return true;
+        })
+        .finally([this] () {
+            EconomyHarvestResult harvest;
+            mEconomy.advanceHarvesters(1.0f,harvest);
+
+            _writeHarvestResult(harvest);
+        })
+        .execute();
+}
 
-    case STRMQuery_PowerUpdate:
-    {
-        uint64 harvesterID;
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint64,0,8);
+//=======================================================================================================================
+//
+// production needs the schematics which live in the db, so factories still run through sf_FactoryProduce
+// the function writes to the factories table, so it must not be called from a statement reading that table
+// (error 1442), the ids are read first and the function runs for a batch of them in one statement without FROM
+//
+void StructureManagerChatHandler::handleFactoryUpdate()
+{
+    std::stringstream query;
+    query << "SELECT f.ID FROM " << mDatabase->galaxy() << ".factories f WHERE f.active > 0";
 
-        uint64 count;
-        count = result->getRowCount();
+    mDatabase->executeAsyncSql(query, [this] (DatabaseResult* result) {
+        std::vector<uint64> ids = _readIds(result);
 
-        for(uint64 i=0; i <count; i++)
+        for(size_t first = 0; first < ids.size(); first += kEconomyBatchSize)
         {
-            result->getNextRow(binding,&harvesterID);
+            size_t last = std::min(first + kEconomyBatchSize, ids.size());
 
-            int8 sql[100];
+            std::stringstream produce;
+            produce << "SELECT ";
 
-            //start by using power
-            sprintf(sql, "SELECT %s.sf_HarvesterUsePower(%"PRIu64")", mDatabase->galaxy(), harvesterID);
-            StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneHarvesterUsePower,0);
-            asyncContainer->harvesterID = harvesterID;
-
-            mDatabase->executeSqlAsync(this,asyncContainer,sql);
-
-            //return codes :
-            // 0 everything ok
-            // 1 hopper full harvester turned of
-            // 2 resource isnt active anymore
-            // 3 resource doesnt exist in the first place
+            for(size_t i = first; i < last; i++)
+            {
+                produce << ((i != first) ? "," : "") << mDatabase->galaxy() << ".sf_FactoryProduce(" << ids[i] << ")";
+            }
 
+            uint16 columns = static_cast<uint16>(last - first);
+
+            mDatabase->executeAsyncSql(produce, [this, columns] (DatabaseResult* result) {
+                //return codes :
+                // 0 everything ok
+                // 1 single item created no crate
+                // 2 hopper full
+                // 3 other fault - attrib / table not found
+                std::vector<uint32> exitCodes(columns);
+
+                DataBinding* binding = mDatabase->createDataBinding(columns);
+                for(uint16 i = 0; i < columns; i++)
+                {
+                    binding->addField(DFT_uint32,i * sizeof(uint32),4,i);
+                }
+
+                if(result->getRowCount())
+                    result->getNextRow(binding,&exitCodes[0]);
+
+                mDatabase->destroyDataBinding(binding);
+
+                for(uint16 i = 0; i < columns; i++)
+                {
+                    if(exitCodes[i] == 3)
+                    {
+                        DLOG(INFO) << "StructureManagerChat::FactoryUpdate failed to produce";
+                    }
+                }
+            });
         }
+    });
+}
 
-        mDatabase->destroyDataBinding(binding);
-
-    }
-    break;
-
-    case STRMQuery_FactoryUpdate:
-    {
-        uint64 factoryID;
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint64,0,8);
-
-        uint64 count;
-        count = result->getRowCount();
-
-        for(uint64 i=0; i <count; i++)
-        {
-            result->getNextRow(binding,&factoryID);
-
-            int8 sql[100];
 
-            //now harvest
-            sprintf(sql, "SELECT %s.sf_FactoryProduce(%"PRIu64")", mDatabase->galaxy(), factoryID);
-            StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneFactoryUpdate,0);
-            asyncContainer->harvesterID = factoryID;
+//=======================================================================================================================
+//
+// takes the hourly maintenance off all structures in one pass
+// structures whose pool does not cover it are read again first, with the current bank and condition
+//
+void StructureManagerChatHandler::handleCheckHarvesterMaintenance()
+{
+    std::shared_ptr<std::vector<uint64> > stale(new std::vector<uint64>());
+    std::shared_ptr<bool> loadAll(new bool(false));
+
+    std::stringstream ids;
+    ids << "SELECT s.ID FROM " << mDatabase->galaxy() << ".structures s";
+
+    QueryChain::create(mDatabase)
+        ->then(ids.str(), [this, stale, loadAll] (DatabaseResult* result) {
+            std::vector<uint64> ids = _readIds(result);
+
+            *loadAll = !mEconomy.getMaintenanceCount();
+
+            mEconomy.syncMaintenance(ids,*stale);
+            mEconomy.getMaintenanceDue(1.0f,*stale);
+            return true;
+        })
+        .thenBuild([this, stale, loadAll] () {
+            if(*loadAll)
+                return _maintenanceQuery(NULL);
+
+            return stale->empty() ? std::string() : _maintenanceQuery(stale.get());
+        }, [this] (DatabaseResult* result) {
+            _readMaintenanceRows(result);
+            return true;
+        })
+        .finally([this] () {
+            EconomyMaintenanceResult maintenance;
+            mEconomy.advanceMaintenance(1.0f,maintenance);
+
+            _writeMaintenanceResult(maintenance);
+        })
+        .execute();
+}
 
-            mDatabase->executeSqlAsync(this,asyncContainer,sql);
+//=======================================================================================================================
+//
+// sql CASE expression mapping the ids [first,last) to their values
+//
+template<typename T>
+std::string StructureManagerChatHandler::_buildCase(const char* key, const std::vector<uint64>& ids, const std::vector<T>& values, size_t first, size_t last)
+{
+    std::stringstream query;
+    query << "CASE " << key;
 
-            //return codes :
-            // 0 everything ok
-            // 1 single item created no crate
-            // 2 hopper full
-            // 3 other fault - attrib / table not found
+    for(size_t i = first; i < last; i++)
+    {
+        query << " WHEN " << ids[i] << " THEN " << values[i];
+    }
 
-        }
+    query << " END";
+    return query.str();
+}
 
-        mDatabase->destroyDataBinding(binding);
+//=======================================================================================================================
 
-    }
-    break;
+std::string StructureManagerChatHandler::_buildIdList(const std::vector<uint64>& ids, size_t first, size_t last)
+{
+    std::stringstream query;
 
-    case STRMQuery_HopperUpdate:
+    for(size_t i = first; i < last; i++)
     {
-        
-        DataBinding* binding = mDatabase->createDataBinding(1);
-        binding->addField(DFT_uint64,0,8);
+        if(i != first)
+            query << ",";
 
-        uint64 count;
-        count = result->getRowCount();
-
-        for(uint64 i=0; i <count; i++)
-        {
-            // clear out the value
-            uint64 harvesterID = 0;
-
-            result->getNextRow(binding,&harvesterID);
-            if (harvesterID == 0)
-                continue;
+        query << ids[i];
+    }
 
-            int8 sql[100];
+    return query.str();
+}
 
-            //now harvest
-            sprintf(sql, "SELECT %s.sf_HarvestResource(%"PRIu64")", mDatabase->galaxy(), harvesterID);
-            StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneHarvestUpdate,0);
-            asyncContainer->harvesterID = harvesterID;
+//=======================================================================================================================
+//
+// changes are written relative to the current value, so deposits the zone makes meanwhile are not lost
+//
+void StructureManagerChatHandler::_writeHarvestResult(const EconomyHarvestResult& result)
+{
+    for(size_t first = 0; first < result.mIds.size(); first += kEconomyBatchSize)
+    {
+        size_t last = std::min(first + kEconomyBatchSize, result.mIds.size());
 
-            mDatabase->executeSqlAsync(this,asyncContainer,sql);
+        std::stringstream query;
+        query << "UPDATE " << mDatabase->galaxy() << ".harvester_resources"
+              << " SET quantity = quantity + " << _buildCase("ID",result.mIds,result.mAmounts,first,last)
+              << " WHERE ID IN (" << _buildIdList(result.mIds,first,last) << ")"
+              << " AND resourceID = " << _buildCase("ID",result.mIds,result.mResourceIds,first,last);
 
-            //return codes :
-            // 0 everything ok
-            // 1 hopper full harvester turned of
-            // 2 resource isnt active anymore
-            // 3 resource doesnt exist in the first place
+        mDatabase->executeAsyncSql(query.str().c_str());
+    }
 
+    _writeShutdowns(result.mShutdownIds);
+}
 
+//=======================================================================================================================
 
-        }
+void StructureManagerChatHandler::_writePowerResult(const EconomyPowerResult& result)
+{
+    for(size_t first = 0; first < result.mIds.size(); first += kEconomyBatchSize)
+    {
+        size_t last = std::min(first + kEconomyBatchSize, result.mIds.size());
 
-        mDatabase->destroyDataBinding(binding);
+        std::stringstream query;
+        query << "UPDATE " << mDatabase->galaxy() << ".structure_attributes"
+              << " SET value = GREATEST(0, CAST(value AS SIGNED) - " << _buildCase("structure_id",result.mIds,result.mUsed,first,last) << ")"
+              << " WHERE attribute_id = " << EconomyAttribute_Power << " AND structure_id IN (" << _buildIdList(result.mIds,first,last) << ")";
 
+        mDatabase->executeAsyncSql(query.str().c_str());
     }
-    break;
 
-    default:
-        break;
-    }
-    SAFE_DELETE(asynContainer);
+    _writeShutdowns(result.mShutdownIds);
 }
 
 //=======================================================================================================================
 
-//=======================================================================================================================
+void StructureManagerChatHandler::_writeMaintenanceResult(const EconomyMaintenanceResult& result)
+{
+    for(size_t first = 0; first < result.mIds.size(); first += kEconomyBatchSize)
+    {
+        size_t last = std::min(first + kEconomyBatchSize, result.mIds.size());
 
+        std::stringstream query;
+        query << "UPDATE " << mDatabase->galaxy() << ".structure_attributes"
+              << " SET value = GREATEST(0, CAST(value AS SIGNED) - " << _buildCase("structure_id",result.mIds,result.mUsed,first,last) << ")"
+              << " WHERE attribute_id = " << EconomyAttribute_Maintenance << " AND structure_id IN (" << _buildIdList(result.mIds,first,last) << ")";
 
-//=======================================================================================================================
-void StructureManagerChatHandler::handleTimer(uint32 id, void* container)
-{
-    boost::mutex::scoped_lock lock(mTimerMutex);
-    mTimerEventQueue.push(id);
-}
+        mDatabase->executeAsyncSql(query.str().c_str());
+    }
 
-//=======================================================================================================================
-void StructureManagerChatHandler::processTimerEvents()
-{
-    uint64	startTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
-    uint64	processTime = 0;
-    while(mTimerEventQueue.size() && processTime < mTimerQueueProcessTimeLimit)
+    std::vector<uint64> bankIds;
+    for(size_t i = 0; i < result.mBankOwners.size(); i++)
     {
-        boost::mutex::scoped_lock lock(mTimerMutex);
-        uint32 id = mTimerEventQueue.front();
-        mTimerEventQueue.pop();
-        lock.unlock();
+        bankIds.push_back(result.mBankOwners[i] + BANK_OFFSET);
+    }
 
-        switch(id)
-        {
-            //handles the harvesters Maintenance updates
-        case SRMTimer_CheckHarvesterMaintenance:
-        {
-            handleCheckHarvesterMaintenance();
-        }
-        break;
+    for(size_t first = 0; first < bankIds.size(); first += kEconomyBatchSize)
+    {
+        size_t last = std::min(first + kEconomyBatchSize, bankIds.size());
 
-        //handles the harvesters hopper and power -updates
-        case SRMTimer_CheckHarvesterHopper:
+        // an owner may show up more than once, sum them up per bank
+        std::map<uint64,uint32> used;
+        for(size_t i = first; i < last; i++)
         {
-            handleCheckHarvesterHopper();
+            used[bankIds[i]] += result.mBankUsed[i];
         }
-        break;
 
-        case SRMTimer_CheckFactory:
+        std::vector<uint64> ids;
+        std::vector<uint32> amounts;
+        for(std::map<uint64,uint32>::iterator it = used.begin(); it != used.end(); ++it)
         {
-            handleFactoryUpdate();
+            ids.push_back(it->first);
+            amounts.push_back(it->second);
         }
-        break;
 
-        case SRMTimer_CheckHarvesterPower:
-        {
-            handleCheckHarvesterPower();
-        }
-        break;
+        std::stringstream query;
+        query << "UPDATE " << mDatabase->galaxy() << ".banks"
+              << " SET credits = GREATEST(0, CAST(credits AS SIGNED) - " << _buildCase("id",ids,amounts,0,ids.size()) << ")"
+              << " WHERE id IN (" << _buildIdList(ids,0,ids.size()) << ")";
 
-        default:
-            break;
-        }
-
-        processTime = Anh_Utils::Clock::getSingleton()->getLocalTime() - startTime;
+        mDatabase->executeAsyncSql(query.str().c_str());
     }
-}
 
-//=======================================================================================================================
-//
-// iterates through the list of hoppers we need to update on a regular basis
-// and reads the relevant resource data - then sends it to the client
-//
-void StructureManagerChatHandler::handleCheckHarvesterPower()
-{
-
-    StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_PowerUpdate,0);
+    for(size_t first = 0; first < result.mDamagedIds.size(); first += kEconomyBatchSize)
+    {
+        size_t last = std::min(first + kEconomyBatchSize, result.mDamagedIds.size());
 
-    int8 sql[100];
-    sprintf(sql,"SELECT h.ID FROM %s.harvesters h WHERE h.active > 0 ",mDatabase->galaxy());
+        std::stringstream query;
+        query << "UPDATE " << mDatabase->galaxy() << ".structures"
+              << " SET `condition` = `condition` + " << _buildCase("ID",result.mDamagedIds,result.mDamageAdded,first,last)
+              << " WHERE ID IN (" << _buildIdList(result.mDamagedIds,first,last) << ")";
 
-    mDatabase->executeSqlAsync(this,asyncContainer,sql);
+        mDatabase->executeAsyncSql(query.str().c_str());
+    }
 
+    for(size_t i = 0; i < result.mNotifyIds.size(); i++)
+    {
+        _sendMaintenanceMail(result.mNotifyIds[i],result.mNotifyStatus[i]);
+    }
 }
 
-
 //=======================================================================================================================
-//
-// iterates through the list of hoppers we need to update on a regular basis
-// and reads the relevant resource data - then sends it to the client
-//
-void StructureManagerChatHandler::handleCheckHarvesterHopper()
-{
 
-    StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_HopperUpdate,0);
-
-    int8 sql[100];
-    sprintf(sql,"SELECT h.ID FROM %s.harvesters h WHERE h.active > 0 ",mDatabase->galaxy());
+void StructureManagerChatHandler::_writeShutdowns(const std::vector<uint64>& harvesterIds)
+{
+    for(size_t first = 0; first < harvesterIds.size(); first += kEconomyBatchSize)
+    {
+        size_t last = std::min(first + kEconomyBatchSize, harvesterIds.size());
 
-    mDatabase->executeSqlAsync(this,asyncContainer,sql);
+        std::stringstream query;
+        query << "UPDATE " << mDatabase->galaxy() << ".harvesters SET active = 0 WHERE ID IN (" << _buildIdList(harvesterIds,first,last) << ")";
 
+        mDatabase->executeAsyncSql(query.str().c_str());
+    }
 }
 
 //=======================================================================================================================
 //
-// iterates through the list of hoppers we need to update on a regular basis
-// and reads the relevant resource data - then sends it to the client
+// looks up what the owner needs to know about the structure and mails him
 //
-void StructureManagerChatHandler::handleFactoryUpdate()
+void StructureManagerChatHandler::_sendMaintenanceMail(uint64 structureId, uint32 status)
 {
+    int8 sql[500];
+    StructureManagerAsyncContainer* asyncContainer;
 
-    StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_FactoryUpdate,0);
-
-    int8 sql[100];
-    sprintf(sql,"SELECT f.ID FROM %s.factories f WHERE f.active > 0 ",mDatabase->galaxy());
-
-    mDatabase->executeSqlAsync(this,asyncContainer,sql);
-
-}
-
+    switch(status)
+    {
+    case EconomyMaintenance_FromBank:
+    {
+        //inform the owner on the maintenance issue
+        sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, s.lastMail FROM %s.structures s INNER JOIN %s.structure_type_data st ON (s.type = st.type) INNER JOIN %s.planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),structureId);
+        asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailOOFMaint,0);
+    }
+    break;
 
-//=======================================================================================================================
-//
-// iterates through all structures in structures.sql to take off maintenance
-//
-void StructureManagerChatHandler::handleCheckHarvesterMaintenance()
-{
+    case EconomyMaintenance_Damaged:
+    {
+        sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, s.condition, s.lastMail FROM %s.structures s INNER JOIN %s.structure_type_data st ON (s.type = st.type) INNER JOIN %s.planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),structureId);
+        asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailDamage,0);
+    }
+    break;
 
-    StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_MaintenanceUpdate,0);
+    case EconomyMaintenance_Condemned:
+    {
+        sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, st.maint_cost_wk, s.lastMail FROM %s.structures s INNER JOIN %s.structure_type_data st ON (s.type = st.type) INNER JOIN %s.planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),structureId);
+        asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailCondZero,0);
+    }
+    break;
 
-    int8 sql[100];
-    sprintf(sql,"SELECT s.ID FROM %s.structures s",mDatabase->galaxy());
+    default:
+        return;
+    }
 
+    asyncContainer->harvesterID = structureId;
     mDatabase->executeSqlAsync(this,asyncContainer,sql);
-
 }
 
 //=======================================================================================================================
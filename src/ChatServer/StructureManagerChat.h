@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "ChatManager.h"
 #include "ChatMessageLib.h"
+#include "StructureEconomy.h"
 //#include "TradeManagerHelp.h"
 
 #include "DatabaseManager/DatabaseCallback.h"
@@ -38,6 +39,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <boost/thread/mutex.hpp>
 
 #include <queue>
+#include <string>
 #include <vector>
 
 #if defined(__GNUC__)
@@ -133,6 +135,29 @@ private:
 
     void				handleFactoryUpdate();
 
+    // economy state, all structures or only the given ones
+    std::string			_harvesterStateQuery();
+    std::string			_harvesterQuery(const std::vector<uint64>* ids);
+    std::string			_powerQuery(const std::vector<uint64>* ids);
+    std::string			_maintenanceQuery(const std::vector<uint64>* ids);
+
+    void				_readHarvesterRows(DatabaseResult* result);
+    void				_readPowerRows(DatabaseResult* result);
+    void				_readMaintenanceRows(DatabaseResult* result);
+    std::vector<uint64>	_readIds(DatabaseResult* result);
+
+    // results of the economy passes, written back in batches
+    void				_writeHarvestResult(const EconomyHarvestResult& result);
+    void				_writePowerResult(const EconomyPowerResult& result);
+    void				_writeMaintenanceResult(const EconomyMaintenanceResult& result);
+    void				_writeShutdowns(const std::vector<uint64>& harvesterIds);
+
+    template<typename T>
+    std::string			_buildCase(const char* key, const std::vector<uint64>& ids, const std::vector<T>& values, size_t first, size_t last);
+    std::string			_buildIdList(const std::vector<uint64>& ids, size_t first, size_t last);
+
+    void				_sendMaintenanceMail(uint64 structureId, uint32 status);
+
 
     HarvesterList*		getHarvesterList() {
         return &mHarvesterList;
@@ -156,22 +181,16 @@ private:
 
     HarvesterList				mHarvesterList;
 
+    StructureEconomy			mEconomy;
+
 };
 
 enum STRMQueryType
 {
     STRMQuery_NULL						=	0,
-    STRMQuery_HopperUpdate				=	1,
-    STRMQuery_DoneHarvestUpdate			=	2,
-    STRMQuery_DoneHarvesterUsePower		=	3,
-    STRMQuery_DoneStructureMaintenance	=	4,
     STRMQuery_StructureMailOOFMaint		=	5,
     STRMQuery_StructureMailDamage		=	6,
-    STRMQuery_StructureMailCondZero		=	7,
-    STRMQuery_MaintenanceUpdate			=	8,
-    STRMQuery_PowerUpdate				=	9,
-    STRMQuery_FactoryUpdate				=	10,
-    STRMQuery_DoneFactoryUpdate			=	11
+    STRMQuery_StructureMailCondZero		=	7
 };
 
 class StructureManagerAsyncContainer
@@ -53,6 +53,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+
 #include <cstring>
 #include <ctime>
 
@@ -133,6 +135,8 @@ TradeManagerChatHandler::TradeManagerChatHandler(Database* database, MessageDisp
     asyncContainer = new TradeManagerAsyncContainer(TRMQuery_LoadBazaar, 0);
     mDatabase->executeProcedureAsync(this, asyncContainer, "CALL %s.sp_BazaarTerminalsGet();",mDatabase->galaxy());
     
+    // load all auctions and their bids, bazaar searches are answered from memory
+    _refreshAuctions(std::vector<uint64>());
 
     // load our global tick
     asyncContainer = new TradeManagerAsyncContainer(TRMQuery_LoadGlobalTick, 0);
@@ -270,6 +274,7 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
 
             // Delete from commerce_auction
             mDatabase->executeProcedureAsync(this, asyncContainer, "CALL %s.sp_BazaarAuctionDelete('%"PRIu64"');", mDatabase->galaxy(),  AuctionTemp.ItemID);
+            mAuctionStore.remove(AuctionTemp.ItemID);
 
             //send relevant info to Zoneserver for Itemcreation
             gChatMessageLib->processSendCreateItem(asynContainer->mClient, player->getCharId(),AuctionTemp.ItemID, AuctionTemp.ItemTyp, player->getPlanetId());
@@ -287,7 +292,8 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
 
     case TRMQuery_CreateAuction:
     {
-
+        // the listing now has its end time, region and category
+        _refreshAuctions(std::vector<uint64>(1, asynContainer->AuctionID));
     }
 
     break;
@@ -295,6 +301,9 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
     {
         //probably we should ponder letting the sf respond with 0 in case of everything ok and !0 in case of error
         gChatMessageLib->sendBidAuctionResponse(asynContainer->mClient, 0, asynContainer->AuctionID);
+
+        // pick up the new high bidder and bid history
+        _refreshAuctions(std::vector<uint64>(1, asynContainer->AuctionID));
     }
     break;
     case TRMQuery_GetDetails:
@@ -570,6 +579,8 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
             //send the relevant EMail
             gChatMessageLib->sendCancelAuctionMail(asynContainer->mClient, player->getCharId(), player->getCharId(), ItemName);
             mDatabase->destroyDataBinding(binding);
+
+            _refreshAuctions(std::vector<uint64>(1, asynContainer->AuctionID));
         }
         else
         {
@@ -603,15 +614,8 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
     }
     break;
 
-    case TRMQuery_AuctionQuery:
+    case TRMQuery_RefreshAuctions:
     {
-        //better check if theres a player???
-        //all auctions that fit the search criteria are loaded into memory - the query
-        //selects them based on the page count
-        //Lists are assembled of every single seller, bazaar and of the auctions
-        //every seller and bazaar name is only send once, regardlass how much
-        //auctions they have
-
         DataBinding* binding = mDatabase->createDataBinding(18);
         binding->addField(DFT_uint64,offsetof(AuctionItem,ItemID),8,0);
         binding->addField(DFT_uint64,offsetof(AuctionItem,OwnerID),8,1);
@@ -633,151 +637,80 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
         binding->addField(DFT_string,offsetof(AuctionItem,HighBidRaw) ,8, 17);
 
         uint64 count = result->getRowCount();
+        std::vector<uint64> loaded;
 
-        auction = new AuctionClass();
+        for(uint64 i = 0; i < count; i++)
+        {
+            AuctionItem auctionTemp = AuctionItem();
 
-        AuctionItem AuctionTemp;
-        //Not sure how to properly read this in. We perform a left join, because
-        //the data is not existing when nobody has bid on the item yet
+            //the bid columns come from a left join and are NULL when nobody has bid on the item yet
+            strcpy(auctionTemp.HighBidRaw,"0");
+            strcpy(auctionTemp.HighProxyRaw,"0");
 
-        strcpy(AuctionTemp.HighBidRaw,"0");
-        strcpy(AuctionTemp.HighProxyRaw,"0");
+            result->getNextRow(binding,&auctionTemp);
+            auctionTemp.HighBid = atoi(auctionTemp.HighBidRaw);
+            auctionTemp.HighProxy = atoi(auctionTemp.HighProxyRaw);
 
-        AuctionTemp.HighBid = 0;
-        AuctionTemp.HighProxy = 0;
-        for(uint64 i = 0; i < count; i++)
-        {
-            //assemble our string list
-            result->getNextRow(binding,&AuctionTemp);
-            AuctionTemp.HighBid = atoi(AuctionTemp.HighBidRaw);
-            AuctionTemp.HighProxy = atoi(AuctionTemp.HighProxyRaw);
-            auction->AddAuction(AuctionTemp);
-        }
-        //now that the lists are done we need to send the packet
-
-        gMessageFactory->StartMessage();
-        gMessageFactory->addUint32(opAuctionQueryHeadersResponseMessage);
-
-        gMessageFactory->addUint32(asynContainer->BazaarPage);//
-        gMessageFactory->addUint32(asynContainer->BazaarWindow );
-        //total of unique Terminals and unique sellers per terminal
-        //so here goes the total nr of strings
-        gMessageFactory->addUint32(auction->getStringCount());
-        ListStringList::iterator itL = auction->mListStringList.begin();
-        //that are all bazaars, sellers and bidders
-        while(itL != auction->mListStringList.end())
-        {
-            gMessageFactory->addString((*itL)->GetString());
-            itL++;
+            mAuctionStore.insert(auctionTemp);
+            loaded.push_back(auctionTemp.ItemID);
         }
 
-        //Nr of unique Auction Names (no auction name more than once)
-        gMessageFactory->addUint32(auction->NameStringCount);
+        //whatever we asked for and didnt get is gone from the db
+        std::sort(loaded.begin(), loaded.end());
 
-        BString s;
-        NameStringList::iterator itD = auction->mNameStringList.begin();
-        while(itD != auction->mNameStringList.end())
+        std::vector<uint64>::iterator it = asynContainer->mAuctionIds.begin();
+        while(it != asynContainer->mAuctionIds.end())
         {
-            s = (*itD)->GetName();
-            s.convert(BSTRType_Unicode16);
-            gMessageFactory->addString(s);
-            itD++;
+            if(!std::binary_search(loaded.begin(), loaded.end(), (*it)))
+                mAuctionStore.remove(*it);
+            it++;
         }
 
-        //finally here the total Nr of auctions
-        gMessageFactory->addUint32(auction->AuctionStringCount);
-        AuctionStringList::iterator itA = auction->mAuctionStringList.begin();
-        while(itA != auction->mAuctionStringList.end())
+        if(asynContainer->mAuctionIds.empty())
         {
+            LOG(INFO) << "Loaded " << count << " auctions";
+        }
 
-            //Item/AuctionID
-            gMessageFactory->addUint64((*itA)->GetAuctionID() );
-            //ListID of the Auctions name
-            gMessageFactory->addUint8(static_cast<uint8>((*itA)->GetNameListID()-1));
-
-            //the Items Price
-            gMessageFactory->addUint32((*itA)->GetPrice());
-
-            //remaining time in seconds
-            uint32 time = static_cast<uint32>((*itA)->GetTime()- (getGlobalTickCount()/1000));
-            gMessageFactory->addUint32(time);
-
-            //auction or instant??
-            gMessageFactory->addUint8((*itA)->GetType());
-
-            //List Id of the auctions bazaar string
-            gMessageFactory->addUint16(static_cast<uint16>((*itA)->GetBazaarListID()-1));
-
-            //Auction Owner ID
-            gMessageFactory->addUint64((*itA)->GetOwnerID());
-
-            //Auction Owner Namestring ID - first name is nr 1
-            gMessageFactory->addUint16(static_cast<uint16>((*itA)->GetSellerListID()-1));
-
-            //Category
-            gMessageFactory->addUint32((*itA)->GetCategory());
-
-            //listplace of the highbidder
-            gMessageFactory->addUint16(static_cast<uint16>((*itA)->GetBidderListID()));
-
-
-            gMessageFactory->addUint32((*itA)->GetBid());	// high bid My High Bid!!!!
-            gMessageFactory->addUint32((*itA)->GetProxy());	// my Proxy
-            gMessageFactory->addUint32((*itA)->GetBid());	// high bid My High Bid!!!!
-
-            gMessageFactory->addUint32((*itA)->GetCategory());// item type for proper text reference
-
-
-            gMessageFactory->addUint8(0);
-            //Ok now heres our bitmask
-            //1
-            //2
-            //4 = Premium
-            //8 = shows Accept bid AND Withdraw sale on own auctions
-            uint8 bitmap = 0;
-            bitmap = (bitmap | 8);//set bit
-            if (player->getCharId() == (*itA)->GetOwnerID()) {
-                //bitmap = (bitmap | 8);//set bit 4
-                if ((*itA)->GetType() == 2) {
-                    bitmap = (bitmap ^ 8);//unset bit 4 when not for sale anymore
-                }
-            }
-            if ((*itA)->GetPremium() == 1)
-                bitmap = (bitmap | 4);//set bit 2;
-            //bitmap = (bitmap | 2);//set bit
-
-
-            //	bitmap = (bitmap | 1);//set bit
-
+        mDatabase->destroyDataBinding(binding);
+    }
+    break;
 
-            gMessageFactory->addUint8(bitmap);//bitmask);
-            gMessageFactory->addUint8(0);
-            gMessageFactory->addUint8(0);
-            gMessageFactory->addUint32(0);
+    case TRMQuery_RefreshBids:
+    {
+        DataBinding* binding = mDatabase->createDataBinding(4);
+        binding->addField(DFT_uint64,offsetof(AuctionItem,ItemID),8,0);
+        binding->addField(DFT_string,offsetof(AuctionItem,bidder_name),32,1);
+        binding->addField(DFT_uint32,offsetof(AuctionItem,HighProxy),4,2);
+        binding->addField(DFT_uint32,offsetof(AuctionItem,HighBid),4,3);
 
-            itA++;
+        std::vector<uint64>::iterator it = asynContainer->mAuctionIds.begin();
+        while(it != asynContainer->mAuctionIds.end())
+        {
+            mAuctionStore.clearBids(*it);
+            it++;
         }
 
-        gMessageFactory->addUint16(static_cast<uint16>(asynContainer->Itemsstart));
-
-        uint32 pages = asynContainer->Itemsstart + static_cast<uint32>(count);
-        if ((pages-asynContainer->Itemsstart) < 100) {
-            pages = 0;
-        }
-        gMessageFactory->addUint16(static_cast<uint16>(pages));
+        uint64 count = result->getRowCount();
 
-        gMessageFactory->addUint32(0);
-        gMessageFactory->addUint32(0);
-        gMessageFactory->addUint32(0);
-        gMessageFactory->addUint32(0);
+        for(uint64 i = 0; i < count; i++)
+        {
+            AuctionItem bidTemp = AuctionItem();
+            result->getNextRow(binding,&bidTemp);
 
-        gMessageFactory->addUint32(0);
-        Message* newMessage = gMessageFactory->EndMessage();
-        asynContainer->mClient->SendChannelA(newMessage, asynContainer->mClient->getAccountId(),  CR_Client, 6);
+            mAuctionStore.setBid(bidTemp.ItemID, bidTemp.bidder_name, bidTemp.HighProxy, bidTemp.HighBid);
+        }
 
-        delete(auction);
         mDatabase->destroyDataBinding(binding);
+    }
+    break;
 
+    case TRMQuery_ExpiredHolding:
+    {
+        //the expired listings have new owners, states and end times by now
+        if(!asynContainer->mAuctionIds.empty())
+        {
+            _refreshAuctions(asynContainer->mAuctionIds);
+        }
     }
     break;
 
@@ -899,7 +832,8 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
         }
 
         //now move the auctions in their proper holding areas or delete the ones which have expired their holding date
-        TradeManagerAsyncContainer* asyncContainer = new TradeManagerAsyncContainer(TRMQuery_NULL,NULL);
+        TradeManagerAsyncContainer* asyncContainer = new TradeManagerAsyncContainer(TRMQuery_ExpiredHolding,NULL);
+        asyncContainer->mAuctionIds = asynContainer->mAuctionIds;
 
         mDatabase->executeProcedureAsync(this, asyncContainer, "CALL %s.sp_CommerceFindExpiredListing();",mDatabase->galaxy());
         
@@ -1024,6 +958,16 @@ void TradeManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseResult
             //let the zoneserver deal with the transaction and send the relevant Emails
             gChatMessageLib->sendBazaarTransactionMessage(asynContainer->mClient, *AuctionTemp, player->getCharId(), time, player, bazaarInfo);
 
+            //the zone hands the item to the buyer, take it off the market right away
+            if(const AuctionItem* sold = mAuctionStore.find(AuctionTemp->ItemID))
+            {
+                AuctionItem soldItem = *sold;
+                soldItem.OwnerID = player->getCharId();
+                soldItem.AuctionTyp = TRMVendor_Cancelled;
+                soldItem.EndTime = time;
+                mAuctionStore.insert(soldItem);
+            }
+
             SAFE_DELETE(AuctionTemp);
 
         }
@@ -1310,6 +1254,7 @@ void TradeManagerChatHandler::processAuctionBid(TradeManagerAsyncContainer* asyn
         sprintf(sql, "SELECT %s.sf_BidUpdate ('%"PRIu64"','%"PRIu32"','%"PRIu32"','%s')", mDatabase->galaxy(),  asynContainer->AuctionTemp->ItemID, asynContainer->MyBid, asynContainer->MyProxy, PlayerName);
         TradeManagerAsyncContainer* asyncContainer;
         asyncContainer = new TradeManagerAsyncContainer(TRMQuery_ACKRetrieval, asynContainer->mClient);
+        asyncContainer->AuctionID = asynContainer->AuctionTemp->ItemID;
         mDatabase->executeSqlAsync(this, asyncContainer, sql);
         
 
@@ -1485,13 +1430,6 @@ void TradeManagerChatHandler::processGetAuctionDetails(Message* message,Dispatch
 //=======================================================================================================================
 void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message* message,DispatchClient* client)
 {
-    TradeManagerAsyncContainer* asyncContainer;
-
-    //uint64 time = (getGlobalTickCount()/1000);
-
-    int8 sql[2024];
-    sprintf(sql,"SELECT c.auction_id, owner_id, c.bazaar_id, type, start, premium, category, itemtype, price, name, description, c.region_id, c.bidder_name, c.planet_id, firstname, bazaar_string, cbh.proxy_bid, cbh.max_bid FROM %s.commerce_auction c INNER JOIN %s.characters ch on (c.owner_id = ch.id) INNER join %s.commerce_bazaar cb ON (cb.bazaar_id = c.bazaar_id) left join %s.commerce_bidhistory cbh ON (cbh.bidder_name = c.bidder_name AND cbh.auction_id = c.auction_id) AND c.owner_id = ch.id  WHERE",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
-
     Player* player;
     PlayerAccountMap::iterator accIt = mPlayerAccountMap.find(client->getAccountId());
 
@@ -1521,187 +1459,213 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
     query.unknown2 = message->getUint8();
     query.start = message->getUint16();//nr of 1st auction to show
 
+    // the search is answered from the auction store, the criteria are the same
+    // the db query used to filter on
+
+    AuctionSearch search;
+    search.RegionType	= query.Region;
+    search.BazaarID		= query.vendorID;
+    search.RegionID		= TerminalRegionbyID(query.vendorID);
+    search.PlanetID		= player->getPlanetId();
+    search.Window		= query.Windowtype;
+    search.CharID		= player->getCharId();
+    search.CharName		= player->getName().getAnsi();
+    search.Category		= query.Category;
+    search.ItemTyp		= query.ItemTyp;
+    search.Now			= getGlobalTickCount() / 1000;
+    search.Start		= query.start;
+
+    AuctionResultList auctions;
+    bool more = mAuctionStore.search(search, auctions);
+
+    _sendAuctionQueryHeaders(client, player, query.Windowtype, query.start, auctions, more);
+}
 
-    // build our db Query
+//=======================================================================================================================
+void TradeManagerChatHandler::_sendAuctionQueryHeaders(DispatchClient* client, Player* player, uint32 window, uint32 start, const AuctionResultList& auctions, bool more)
+{
+    //Lists are assembled of every single seller, bazaar and of the auctions
+    //every seller and bazaar name is only send once, regardlass how much
+    //auctions they have
 
-    // the region to display
+    auction = new AuctionClass();
 
-    switch(query.Region)
+    AuctionResultList::const_iterator itR = auctions.begin();
+    while(itR != auctions.end())
     {
-    case TRMVendor:
-    {
-        sprintf(query.RegionQuery," (c.bazaar_id = %"PRIu64")",query.vendorID);
+        AuctionItem auctionTemp = *(*itR);
 
+        //in the bids window the player sees his own bid instead of the high bid
+        if(window == TRMVendor_MyBids)
+        {
+            if(const AuctionBid* bid = mAuctionStore.findBid(auctionTemp.ItemID, player->getName().getAnsi()))
+            {
+                auctionTemp.HighProxy = bid->Proxy;
+                auctionTemp.HighBid = bid->MaxBid;
+            }
+        }
+
+        auction->AddAuction(auctionTemp);
+        itR++;
     }
-    break;
 
-    case TRMRegion:
+    //now that the lists are done we need to send the packet
+
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opAuctionQueryHeadersResponseMessage);
+
+    gMessageFactory->addUint32((start / 100) + 1);//
+    gMessageFactory->addUint32(window);
+    //total of unique Terminals and unique sellers per terminal
+    //so here goes the total nr of strings
+    gMessageFactory->addUint32(auction->getStringCount());
+    ListStringList::iterator itL = auction->mListStringList.begin();
+    //that are all bazaars, sellers and bidders
+    while(itL != auction->mListStringList.end())
     {
-        //for now Planet
-        sprintf(query.RegionQuery," (c.region_id = %"PRIu32")",TerminalRegionbyID(query.vendorID));
+        gMessageFactory->addString((*itL)->GetString());
+        itL++;
     }
-    break;
 
-    case TRMPlanet:
-    {
-        sprintf(query.RegionQuery," (c.planet_id = %"PRIu32")",player->getPlanetId());
+    //Nr of unique Auction Names (no auction name more than once)
+    gMessageFactory->addUint32(auction->NameStringCount);
 
+    BString s;
+    NameStringList::iterator itD = auction->mNameStringList.begin();
+    while(itD != auction->mNameStringList.end())
+    {
+        s = (*itD)->GetName();
+        s.convert(BSTRType_Unicode16);
+        gMessageFactory->addString(s);
+        itD++;
     }
-    break;
 
-    case TRMGalaxy:
+    //finally here the total Nr of auctions
+    gMessageFactory->addUint32(auction->AuctionStringCount);
+    AuctionStringList::iterator itA = auction->mAuctionStringList.begin();
+    while(itA != auction->mAuctionStringList.end())
     {
-        sprintf(query.RegionQuery," (c.planet_id >= 0)");
 
-    }
-    default:
-        sprintf(query.RegionQuery," ");
-    }
+        //Item/AuctionID
+        gMessageFactory->addUint64((*itA)->GetAuctionID() );
+        //ListID of the Auctions name
+        gMessageFactory->addUint8(static_cast<uint8>((*itA)->GetNameListID()-1));
 
-    //need new table for bidding ??
+        //the Items Price
+        gMessageFactory->addUint32((*itA)->GetPrice());
 
-    // the kind of "hopper" to display auction hopper or stockroom or ownauctions or offers
+        //remaining time in seconds
+        uint32 time = static_cast<uint32>((*itA)->GetTime()- (getGlobalTickCount()/1000));
+        gMessageFactory->addUint32(time);
 
-    switch (query.Windowtype)
-    {
-    case TRMVendor_AllAuctions: //open up bazaar and look at it without a category
-    {
-        sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32"))", TRMVendor_Auction, TRMVendor_Instant);
+        //auction or instant??
+        gMessageFactory->addUint8((*itA)->GetType());
 
-    }
-    break;
+        //List Id of the auctions bazaar string
+        gMessageFactory->addUint16(static_cast<uint16>((*itA)->GetBazaarListID()-1));
 
-    case TRMVendor_MySales: //what Im selling at the bazaar
-    {
-        sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32"))AND", TRMVendor_Auction, TRMVendor_Instant);
-        int8 tmp[128];
-        sprintf(tmp," (c.owner_id = %"PRIu64")",player->getCharId());
-        strcat(query.WindowQuery,tmp);
+        //Auction Owner ID
+        gMessageFactory->addUint64((*itA)->GetOwnerID());
 
-    }
-    break;
+        //Auction Owner Namestring ID - first name is nr 1
+        gMessageFactory->addUint16(static_cast<uint16>((*itA)->GetSellerListID()-1));
 
-    case TRMVendor_MyBids: //auctions Im bidding on currently at the bazaar
-    {
-        sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32")) AND",TRMVendor_Auction,TRMVendor_Instant);
-        int8 tmp[128],end[128],*sqlPointer;
-        sprintf(tmp," (cbh.bidder_name = '");
-        sqlPointer = tmp + strlen(tmp);
-        sqlPointer += mDatabase->escapeString(sqlPointer,player->getName().getAnsi(),player->getName().getLength());
-        *sqlPointer++ = '\'';
-        *sqlPointer++ = '\0';
-        strcat(query.WindowQuery,tmp);
-        sprintf(end," )");
-        strcat(query.WindowQuery,end);
-        sprintf(sql,"SELECT c.auction_id, owner_id, c.bazaar_id, type, start, premium, category, itemtype, price, name, description, c.region_id, c.bidder_name, c.planet_id, firstname, bazaar_string, cbh.proxy_bid, cbh.max_bid FROM %s.commerce_auction c INNER JOIN %s.characters ch on (c.owner_id = ch.id) INNER join %s.commerce_bazaar cb ON (cb.bazaar_id = c.bazaar_id) inner join %s.commerce_bidhistory cbh ON (cbh.auction_id = c.auction_id) AND c.owner_id = ch.id WHERE",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
+        //Category
+        gMessageFactory->addUint32((*itA)->GetCategory());
 
-    }
-    break;
-    case TRMVendor_AvailableItems:
-    {
-        sprintf(query.WindowQuery," (c.type = %"PRIu32") AND (c.owner_id = %"PRIu64") ",TRMVendor_Ended,player->getCharId());
+        //listplace of the highbidder
+        gMessageFactory->addUint16(static_cast<uint16>((*itA)->GetBidderListID()));
 
 
-    }
-    break;
-    case TRMVendor_Offers:
-    {
-        sprintf(query.WindowQuery," (c.type = %"PRIu32") AND (c.bidder_name = %s) AND (c.bazaar_id = %"PRIu64")",TRMVendor_Offer,player->getName().getAnsi(),query.vendorID);
+        gMessageFactory->addUint32((*itA)->GetBid());	// high bid My High Bid!!!!
+        gMessageFactory->addUint32((*itA)->GetProxy());	// my Proxy
+        gMessageFactory->addUint32((*itA)->GetBid());	// high bid My High Bid!!!!
 
+        gMessageFactory->addUint32((*itA)->GetCategory());// item type for proper text reference
 
-    }
-    break;
-    case TRMVendor_ForSale:
-    {
-        sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32")) AND",TRMVendor_Auction,TRMVendor_Instant);
-        int8 tmp[128],end[128],*sqlPointer;
-        sprintf(tmp," (c.bidder_name = '");
-        sqlPointer = tmp + strlen(tmp);
-        sqlPointer += mDatabase->escapeString(sqlPointer,player->getName().getAnsi(),player->getName().getLength());
-        *sqlPointer++ = '\'';
-        *sqlPointer++ = '\0';
-        strcat(query.WindowQuery,tmp);
-        sprintf(end," ) AND");
-        strcat(query.WindowQuery,end);
-
-        sprintf(tmp," (c.bazaar_id = %"PRIu64")",query.vendorID);
-        strcat(query.WindowQuery,tmp);
-    }
-    break;
-    default:
-        sprintf(query.WindowQuery," ");
-    }
 
-    uint32 category;
-    category = query.Category;
-    //Were looking for a main category
+        gMessageFactory->addUint8(0);
+        //Ok now heres our bitmask
+        //1
+        //2
+        //4 = Premium
+        //8 = shows Accept bid AND Withdraw sale on own auctions
+        uint8 bitmap = 0;
+        bitmap = (bitmap | 8);//set bit
+        if (player->getCharId() == (*itA)->GetOwnerID()) {
+            //bitmap = (bitmap | 8);//set bit 4
+            if ((*itA)->GetType() == 2) {
+                bitmap = (bitmap ^ 8);//unset bit 4 when not for sale anymore
+            }
+        }
+        if ((*itA)->GetPremium() == 1)
+            bitmap = (bitmap | 4);//set bit 2;
+        //bitmap = (bitmap | 2);//set bit
 
-    if (category != 0)
-    {
-        if ((category << 24) == 0)
-        {
-            sprintf(query.CategoryQuery," ((c.category >> 8) = %"PRIu32")",(query.Category >> 8));
 
-        }
-        else
-        {
-            //were looking for a subcategory
-            sprintf(query.CategoryQuery," ((c.category) = %"PRIu32")",query.Category );
-        }
-    }
-    else sprintf(query.CategoryQuery," ");
+        //	bitmap = (bitmap | 1);//set bit
+
+
+        gMessageFactory->addUint8(bitmap);//bitmask);
+        gMessageFactory->addUint8(0);
+        gMessageFactory->addUint8(0);
+        gMessageFactory->addUint32(0);
 
-    if (query.ItemTyp != 0) {
-        sprintf(query.ItemTypQuery," (c.itemtype = %"PRIu32")",query.ItemTyp);
+        itA++;
     }
-    else
-        sprintf(query.ItemTypQuery," ");
 
-    int8 Limit[64];
-    uint32 StopTime;
-    StopTime = (static_cast<uint32>(getGlobalTickCount()) / 1000);
-    sprintf(Limit," AND (c.start > %"PRIu32") LIMIT %u, %u", StopTime,query.start, query.start+100);
+    gMessageFactory->addUint16(static_cast<uint16>(start));
 
-    //region or bazaar id
+    //start of the next page, 0 when this is the last one
+    uint32 pages = more ? start + static_cast<uint32>(auctions.size()) : 0;
+    gMessageFactory->addUint16(static_cast<uint16>(pages));
 
-    strcat(sql,query.RegionQuery); //
-    bool add = false;
+    gMessageFactory->addUint32(0);
+    gMessageFactory->addUint32(0);
+    gMessageFactory->addUint32(0);
+    gMessageFactory->addUint32(0);
 
-    if (strcmp(query.RegionQuery," ") != 0)
-        add = true;
+    gMessageFactory->addUint32(0);
+    Message* newMessage = gMessageFactory->EndMessage();
+    client->SendChannelA(newMessage, client->getAccountId(),  CR_Client, 6);
 
-    if (strcmp(query.WindowQuery, " ") != 0) {
-        if (add == true)
-            strcat(sql," AND ");
-        add = true;
-    }
-    strcat(sql,query.WindowQuery);
+    delete(auction);
+}
 
-    if (strcmp(query.CategoryQuery, " ") !=0 ) {
-        if (add == true)
-            strcat(sql," AND ");
-        add = true;
-    }
+//=======================================================================================================================
+void TradeManagerChatHandler::_refreshAuctions(const std::vector<uint64>& auctionIds)
+{
+    //reload the given auctions in batches, or all of them when no ids are given
+    std::vector<uint64>::const_iterator it = auctionIds.begin();
 
-    strcat(sql,query.CategoryQuery); //
+    do
+    {
+        TradeManagerAsyncContainer* auctionContainer = new TradeManagerAsyncContainer(TRMQuery_RefreshAuctions, NULL);
+        TradeManagerAsyncContainer* bidContainer = new TradeManagerAsyncContainer(TRMQuery_RefreshBids, NULL);
 
-    if (strcmp(query.ItemTypQuery, " ") !=0 ) {
-        if (add == true)
-            strcat(sql," AND ");
-        add = true;
-    }
+        int8 idList[1536] = "";
+        int8* idPointer = idList;
 
-    strcat(sql,query.ItemTypQuery); //
-    strcat(sql,Limit); //
+        while(it != auctionIds.end() && auctionContainer->mAuctionIds.size() < 64)
+        {
+            idPointer += sprintf(idPointer, "%s%"PRIu64"", auctionContainer->mAuctionIds.empty() ? "" : ",", (*it));
+            auctionContainer->mAuctionIds.push_back(*it);
+            it++;
+        }
+        bidContainer->mAuctionIds = auctionContainer->mAuctionIds;
 
-    asyncContainer = new TradeManagerAsyncContainer(TRMQuery_AuctionQuery,client);
-    div_t d;
-    d = div(query.start,100);
-    asyncContainer->BazaarPage = d.quot+1 ;
-    asyncContainer->BazaarWindow = query.Windowtype;
-    asyncContainer->Itemsstart = query.start;
-    mDatabase->executeSqlAsync(this,asyncContainer,sql);
-    
+        int8 where[1600] = "";
+        if(!auctionContainer->mAuctionIds.empty())
+            sprintf(where, " WHERE c.auction_id IN (%s)", idList);
+
+        int8 sql[2600];
+        sprintf(sql,"SELECT c.auction_id, owner_id, c.bazaar_id, type, start, premium, category, itemtype, price, name, description, c.region_id, c.bidder_name, c.planet_id, firstname, bazaar_string, cbh.proxy_bid, cbh.max_bid FROM %s.commerce_auction c INNER JOIN %s.characters ch on (c.owner_id = ch.id) INNER join %s.commerce_bazaar cb ON (cb.bazaar_id = c.bazaar_id) left join %s.commerce_bidhistory cbh ON (cbh.bidder_name = c.bidder_name AND cbh.auction_id = c.auction_id)%s",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),where);
+        mDatabase->executeSqlAsync(this, auctionContainer, sql);
+
+        sprintf(sql,"SELECT c.auction_id, c.bidder_name, c.proxy_bid, c.max_bid FROM %s.commerce_bidhistory c%s",mDatabase->galaxy(),where);
+        mDatabase->executeSqlAsync(this, bidContainer, sql);
+    }
+    while(it != auctionIds.end());
 }
 
 //=======================================================================================================================
@@ -1822,9 +1786,16 @@ void TradeManagerChatHandler::handleGlobalTickPreserve()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void TradeManagerChatHandler::handleCheckAuctions()
 {
+    uint64 time = getGlobalTickCount() / 1000;
+
+    //the auction store knows when the next listing runs out, dont bother the db before that
+    if(!mAuctionStore.hasExpired(time))
+        return;
+
     TradeManagerAsyncContainer* asyncContainer = new TradeManagerAsyncContainer(TRMQuery_ExpiredListing, NULL);
-    uint32 time = static_cast<uint32>(getGlobalTickCount());
-    mDatabase->executeProcedureAsync(this, asyncContainer, "CALL %s.sp_BazaarAuctionFindExpired(%"PRIu32");", mDatabase->galaxy(),  time/1000);
+    mAuctionStore.popExpired(time, asyncContainer->mAuctionIds);
+
+    mDatabase->executeProcedureAsync(this, asyncContainer, "CALL %s.sp_BazaarAuctionFindExpired(%"PRIu64");", mDatabase->galaxy(),  time);
     
 }
 
@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ANH_CHATSERVER_TradeManager_H
 #define ANH_CHATSERVER_TradeManager_H
 
+#include "AuctionStore.h"
 #include "ChatManager.h"
 #include "ChatMessageLib.h"
 #include "TradeManagerHelp.h"
@@ -129,6 +130,10 @@ private:
     void				handleGlobalTickUpdate();
     void				handleCheckAuctions();
 
+    // auction store, an empty id list reloads every auction
+    void				_refreshAuctions(const std::vector<uint64>& auctionIds);
+    void				_sendAuctionQueryHeaders(DispatchClient* client, Player* player, uint32 window, uint32 start, const AuctionResultList& auctions, bool more);
+
 
 
     static TradeManagerChatHandler*	mSingleton;
@@ -159,6 +164,7 @@ private:
     uint32						mBazaarMaxBid;
 
     AuctionList					mAuction;
+    AuctionStore				mAuctionStore;
 
 
 
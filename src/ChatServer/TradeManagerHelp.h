@@ -113,17 +113,10 @@ struct ListStringStruct
 struct Query
 {
     uint32 Region;
-    int8   RegionQuery[128];
-
     uint32 UpdateCounter;
     uint32 Windowtype;
-    int8   WindowQuery[256];
-
     uint32 Category;
-    int8   CategoryQuery[128];
-
     uint32 ItemTyp;
-    int8   ItemTypQuery[64];
 
     BString searchstring;
     uint32 unknown;
@@ -188,7 +181,10 @@ enum TRMQueryType
     TRMQuery_GetAttributeDetails		= 19,
     TRMQuery_ProcessBidAuction			= 20,
     TRMQuery_ProcessAuctionRefund		= 21,
-    TRMQuery_GetResAttributeDetails		= 22
+    TRMQuery_GetResAttributeDetails		= 22,
+    TRMQuery_RefreshAuctions			= 23,
+    TRMQuery_RefreshBids				= 24,
+    TRMQuery_ExpiredHolding				= 25
 };
 
 struct AuctionItem
@@ -283,6 +279,9 @@ public:
     uint32				price;
     BString				description;
     BString				tang;
+
+    // auctions to resync with the AuctionStore once the query is done
+    std::vector<uint64>	mAuctionIds;
 };
 
 //======================================================================================================================
@@ -0,0 +1,400 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ChatServer/AuctionStore.h"
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+AuctionItem makeAuction(uint64 id, uint64 owner_id = 100, uint64 bazaar_id = 200) {
+    AuctionItem auction;
+    memset(&auction, 0, sizeof(auction));
+
+    auction.ItemID = id;
+    auction.OwnerID = owner_id;
+    auction.BazaarID = bazaar_id;
+    auction.AuctionTyp = TRMVendor_Auction;
+    auction.EndTime = 1000;
+    auction.Category = 0x0100 | 0x01;
+    auction.ItemTyp = 7;
+    auction.RegionID = 3;
+    auction.PlanetID = 4;
+
+    return auction;
+}
+
+std::vector<uint64> ids(const AuctionResultList& results) {
+    std::vector<uint64> found;
+
+    for (AuctionResultList::const_iterator it = results.begin(); it != results.end(); ++it) {
+        found.push_back((*it)->ItemID);
+    }
+
+    return found;
+}
+
+std::vector<uint64> searchIds(const AuctionStore& store, const AuctionSearch& search) {
+    AuctionResultList results;
+    store.search(search, results);
+    return ids(results);
+}
+
+/*! One search per index the store narrows candidates with: owner, bidder,
+* bazaar, item type, category, region and planet.
+*/
+std::vector<AuctionSearch> searchesByIndex(const AuctionItem& auction, const std::string& bidder) {
+    std::vector<AuctionSearch> searches;
+
+    AuctionSearch search;
+    search.Window = TRMVendor_MySales;
+    search.CharID = auction.OwnerID;
+    searches.push_back(search);
+
+    search = AuctionSearch();
+    search.Window = TRMVendor_MyBids;
+    search.CharName = bidder;
+    searches.push_back(search);
+
+    search = AuctionSearch();
+    search.RegionType = TRMVendor;
+    search.BazaarID = auction.BazaarID;
+    searches.push_back(search);
+
+    search = AuctionSearch();
+    search.ItemTyp = auction.ItemTyp;
+    searches.push_back(search);
+
+    search = AuctionSearch();
+    search.Category = auction.Category;
+    searches.push_back(search);
+
+    search = AuctionSearch();
+    search.RegionType = TRMRegion;
+    search.RegionID = auction.RegionID;
+    searches.push_back(search);
+
+    search = AuctionSearch();
+    search.RegionType = TRMPlanet;
+    search.PlanetID = auction.PlanetID;
+    searches.push_back(search);
+
+    return searches;
+}
+
+/*! Replacing an auction moves it in every index instead of leaving the old
+* entries behind, and removing it drops it from all of them.
+*/
+TEST(AuctionStoreTests, InsertAndRemoveKeepTheIndexesConsistent) {
+    AuctionStore store;
+
+    AuctionItem first = makeAuction(1);
+    store.insert(first);
+    store.setBid(1, "han", 10, 20);
+
+    // the same auction again, now listed elsewhere by somebody else
+    AuctionItem moved = makeAuction(1, 101, 201);
+    moved.Category = 0x0200 | 0x02;
+    moved.ItemTyp = 8;
+    moved.RegionID = 5;
+    moved.PlanetID = 6;
+    store.insert(moved);
+    store.insert(moved);
+
+    EXPECT_EQ(1u, store.size());
+    ASSERT_TRUE(store.find(1) != NULL);
+    EXPECT_EQ(101u, store.find(1)->OwnerID);
+
+    // nothing is found where it was listed before, the bids moved along with it
+    std::vector<AuctionSearch> before = searchesByIndex(first, "nobody");
+    for (size_t i = 0; i < before.size(); ++i) {
+        EXPECT_TRUE(searchIds(store, before[i]).empty()) << "search " << i;
+    }
+
+    // every index returns the auction exactly once
+    std::vector<AuctionSearch> after = searchesByIndex(moved, "han");
+    for (size_t i = 0; i < after.size(); ++i) {
+        std::vector<uint64> found = searchIds(store, after[i]);
+        ASSERT_EQ(1u, found.size()) << "search " << i;
+        EXPECT_EQ(1u, found[0]);
+    }
+
+    store.remove(1);
+
+    EXPECT_EQ(0u, store.size());
+    EXPECT_TRUE(store.find(1) == NULL);
+    EXPECT_TRUE(store.findBid(1, "han") == NULL);
+
+    for (size_t i = 0; i < after.size(); ++i) {
+        EXPECT_TRUE(searchIds(store, after[i]).empty()) << "search " << i;
+    }
+
+    // removing an unknown auction is harmless
+    store.remove(42);
+    EXPECT_EQ(0u, store.size());
+}
+
+/*! Searches apply every filter, whichever index narrowed the candidates.
+*/
+TEST(AuctionStoreTests, SearchAppliesEveryFilter) {
+    AuctionStore store;
+
+    AuctionItem listed = makeAuction(1);
+    store.insert(listed);
+
+    AuctionItem otherType = makeAuction(2);
+    otherType.ItemTyp = 9;
+    store.insert(otherType);
+
+    AuctionItem subCategory = makeAuction(3);
+    subCategory.Category = 0x0100 | 0x02;
+    store.insert(subCategory);
+
+    AuctionItem otherCategory = makeAuction(4);
+    otherCategory.Category = 0x0300 | 0x01;
+    store.insert(otherCategory);
+
+    AuctionItem ended = makeAuction(5);
+    ended.EndTime = 50;
+    store.insert(ended);
+
+    AuctionItem inHolding = makeAuction(6);
+    inHolding.AuctionTyp = TRMVendor_Ended;
+    store.insert(inHolding);
+
+    AuctionItem otherBazaar = makeAuction(7, 100, 201);
+    otherBazaar.RegionID = 8;
+    otherBazaar.PlanetID = 9;
+    store.insert(otherBazaar);
+
+    AuctionItem offer = makeAuction(8);
+    offer.AuctionTyp = TRMVendor_Offer;
+    strcpy(offer.bidder_name, "leia");
+    store.insert(offer);
+
+    AuctionSearch search;
+    search.Now = 100;
+
+    // the whole galaxy, running listings only
+    std::vector<uint64> expected;
+    expected.push_back(1);
+    expected.push_back(2);
+    expected.push_back(3);
+    expected.push_back(4);
+    expected.push_back(7);
+    EXPECT_EQ(expected, searchIds(store, search));
+
+    // a main category matches its sub categories, a sub category only itself
+    search.Category = 0x0100;
+    expected.clear();
+    expected.push_back(1);
+    expected.push_back(2);
+    expected.push_back(3);
+    expected.push_back(7);
+    EXPECT_EQ(expected, searchIds(store, search));
+
+    search.Category = 0x0100 | 0x02;
+    EXPECT_EQ(std::vector<uint64>(1, 3), searchIds(store, search));
+
+    search.Category = 0;
+    search.ItemTyp = 9;
+    EXPECT_EQ(std::vector<uint64>(1, 2), searchIds(store, search));
+
+    search.ItemTyp = 7;
+    search.RegionType = TRMVendor;
+    search.BazaarID = 201;
+    EXPECT_EQ(std::vector<uint64>(1, 7), searchIds(store, search));
+
+    search = AuctionSearch();
+    search.Now = 100;
+    search.RegionType = TRMRegion;
+    search.RegionID = 8;
+    EXPECT_EQ(std::vector<uint64>(1, 7), searchIds(store, search));
+
+    search.RegionType = TRMPlanet;
+    search.PlanetID = 4;
+    search.ItemTyp = 9;
+    EXPECT_EQ(std::vector<uint64>(1, 2), searchIds(store, search));
+
+    // items in holding only show up for their owner
+    search = AuctionSearch();
+    search.Now = 100;
+    search.Window = TRMVendor_AvailableItems;
+    search.CharID = 100;
+    EXPECT_EQ(std::vector<uint64>(1, 6), searchIds(store, search));
+
+    search.CharID = 101;
+    EXPECT_TRUE(searchIds(store, search).empty());
+
+    // offers only for the vendor they were made to and the one who made them
+    search = AuctionSearch();
+    search.Now = 100;
+    search.Window = TRMVendor_Offers;
+    search.CharName = "leia";
+    search.BazaarID = 200;
+    EXPECT_EQ(std::vector<uint64>(1, 8), searchIds(store, search));
+
+    search.CharName = "han";
+    EXPECT_TRUE(searchIds(store, search).empty());
+}
+
+/*! Results come in pages of 100 in auction id order, the last page says
+* there is nothing more, whatever order the auctions were inserted in.
+*/
+TEST(AuctionStoreTests, PagesResultsInAuctionIdOrder) {
+    AuctionStore store;
+
+    // ids 1..250, inserted back to front and every other one for owner 100
+    for (uint64 id = 250; id >= 1; --id) {
+        store.insert(makeAuction(id, 100 + (id % 2)));
+    }
+
+    AuctionSearch galaxy;
+    AuctionSearch owner;
+    owner.Window = TRMVendor_MySales;
+    owner.CharID = 100;
+
+    AuctionSearch searches[] = { galaxy, owner };
+    const uint32 totals[] = { 250, 125 };
+    const uint32 page_counts[] = { 3, 2 };
+
+    for (size_t s = 0; s < 2; ++s) {
+        std::vector<uint64> all;
+        uint32 pages = 0;
+        bool more = true;
+
+        for (uint32 start = 0; more; start += 100) {
+            AuctionSearch page = searches[s];
+            page.Start = start;
+
+            AuctionResultList results;
+            more = store.search(page, results);
+
+            EXPECT_LE(results.size(), 100u);
+            if (more) {
+                EXPECT_EQ(100u, results.size());
+            }
+
+            std::vector<uint64> found = ids(results);
+            all.insert(all.end(), found.begin(), found.end());
+            ++pages;
+        }
+
+        EXPECT_EQ(page_counts[s], pages);
+        ASSERT_EQ(totals[s], all.size());
+
+        for (size_t i = 1; i < all.size(); ++i) {
+            EXPECT_LT(all[i - 1], all[i]);
+        }
+    }
+}
+
+/*! Bids are kept per bidder and auction, setting one again updates it and
+* clearing an auction's bids removes them for every bidder.
+*/
+TEST(AuctionStoreTests, SetsAndClearsBids) {
+    AuctionStore store;
+    store.insert(makeAuction(1));
+    store.insert(makeAuction(2));
+
+    store.setBid(1, "han", 10, 20);
+    store.setBid(1, "leia", 15, 30);
+    store.setBid(2, "han", 5, 5);
+
+    // nameless bidders are ignored
+    store.setBid(2, "", 1, 1);
+    EXPECT_TRUE(store.findBid(2, "") == NULL);
+
+    ASSERT_TRUE(store.findBid(1, "han") != NULL);
+    EXPECT_EQ(10u, store.findBid(1, "han")->Proxy);
+    EXPECT_EQ(20u, store.findBid(1, "han")->MaxBid);
+
+    store.setBid(1, "han", 25, 40);
+    EXPECT_EQ(25u, store.findBid(1, "han")->Proxy);
+    EXPECT_EQ(40u, store.findBid(1, "han")->MaxBid);
+
+    AuctionSearch myBids;
+    myBids.Window = TRMVendor_MyBids;
+    myBids.CharName = "han";
+
+    std::vector<uint64> expected;
+    expected.push_back(1);
+    expected.push_back(2);
+    EXPECT_EQ(expected, searchIds(store, myBids));
+
+    store.clearBids(1);
+
+    EXPECT_TRUE(store.findBid(1, "han") == NULL);
+    EXPECT_TRUE(store.findBid(1, "leia") == NULL);
+    ASSERT_TRUE(store.findBid(2, "han") != NULL);
+    EXPECT_EQ(std::vector<uint64>(1, 2), searchIds(store, myBids));
+
+    myBids.CharName = "leia";
+    EXPECT_TRUE(searchIds(store, myBids).empty());
+
+    // clearing twice is harmless
+    store.clearBids(1);
+    EXPECT_TRUE(store.findBid(2, "han") != NULL);
+}
+
+/*! Listings expire in end time order. Entries left behind by removed or
+* re-timed auctions are skipped, and offers or sold items never expire.
+*/
+TEST(AuctionStoreTests, PopsExpiredListings) {
+    AuctionStore store;
+
+    AuctionItem early = makeAuction(1);
+    early.EndTime = 10;
+    store.insert(early);
+
+    AuctionItem removed = makeAuction(2);
+    removed.EndTime = 5;
+    store.insert(removed);
+
+    AuctionItem extended = makeAuction(3);
+    extended.EndTime = 15;
+    store.insert(extended);
+    extended.EndTime = 100;
+    store.insert(extended);
+
+    AuctionItem offer = makeAuction(4);
+    offer.AuctionTyp = TRMVendor_Offer;
+    offer.EndTime = 1;
+    store.insert(offer);
+
+    AuctionItem late = makeAuction(5);
+    late.AuctionTyp = TRMVendor_Ended;
+    late.EndTime = 50;
+    store.insert(late);
+
+    store.remove(2);
+
+    EXPECT_FALSE(store.hasExpired(9));
+    EXPECT_TRUE(store.hasExpired(10));
+
+    std::vector<uint64> expired;
+    store.popExpired(20, expired);
+    EXPECT_EQ(std::vector<uint64>(1, 1), expired);
+
+    EXPECT_FALSE(store.hasExpired(49));
+
+    expired.clear();
+    store.popExpired(1000, expired);
+
+    std::vector<uint64> expected;
+    expected.push_back(5);
+    expected.push_back(3);
+    EXPECT_EQ(expected, expired);
+
+    EXPECT_FALSE(store.hasExpired(~0ULL));
+
+    // popping only drops the heap entries, the auctions stay until removed
+    EXPECT_EQ(4u, store.size());
+}
+
+}
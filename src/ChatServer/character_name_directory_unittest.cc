@@ -0,0 +1,144 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ChatServer/CharacterNameDirectory.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+const char kLoadQuery[] = "SELECT id, firstname FROM galaxy.characters";
+
+std::vector<std::string> rows(const char* first_id, const char* first_name, const char* second_id, const char* second_name) {
+    std::vector<std::string> cells;
+    cells.push_back(first_id);
+    cells.push_back(first_name);
+    cells.push_back(second_id);
+    cells.push_back(second_name);
+    return cells;
+}
+
+class CharacterNameDirectoryTest : public testing::Test {
+protected:
+    CharacterNameDirectoryTest()
+        : config_(1, 1, "global", "galaxy", "config")
+        , database_(memory_.getFactory(), config_)
+        , directory_(&database_)
+    {
+        memory_.setResult(kLoadQuery, 2, rows("8589934593", "Luke", "8589934594", "Leia"));
+    }
+
+    ~CharacterNameDirectoryTest() {
+        database_.drain();
+    }
+
+    size_t loadsSent() const {
+        std::vector<std::string> queries = memory_.getQueries();
+        return std::count(queries.begin(), queries.end(), std::string(kLoadQuery));
+    }
+
+    DatabaseImplementationMemory memory_;
+    DatabaseConfig config_;
+    Database database_;
+    CharacterNameDirectory directory_;
+};
+
+/*! The directory is empty and reports so until its first load completed,
+* callers ask the database until then.
+*/
+TEST_F(CharacterNameDirectoryTest, NotLoadedUntilTheFirstLoadCompletes) {
+    EXPECT_FALSE(directory_.isLoaded());
+
+    directory_.load();
+    EXPECT_FALSE(directory_.isLoaded());
+    EXPECT_EQ(0u, directory_.findByName("luke"));
+
+    database_.drain();
+    EXPECT_TRUE(directory_.isLoaded());
+    EXPECT_EQ(2u, directory_.size());
+}
+
+/*! Names resolve to ids ignoring case or exactly, ids resolve back to the
+* properly cased name.
+*/
+TEST_F(CharacterNameDirectoryTest, ResolvesNamesBothWays) {
+    directory_.load();
+    database_.drain();
+
+    EXPECT_EQ(8589934593u, directory_.findByName("lUKE"));
+    EXPECT_EQ(8589934593u, directory_.findByExactName("Luke"));
+    EXPECT_EQ(0u, directory_.findByExactName("luke"));
+    EXPECT_EQ(0u, directory_.findByName("Han"));
+
+    std::string name;
+    ASSERT_TRUE(directory_.getName(8589934594u, name));
+    EXPECT_EQ("Leia", name);
+    EXPECT_FALSE(directory_.getName(1, name));
+}
+
+/*! Characters created or deleted while a reload runs are applied on top of
+* its result, which may not contain them yet.
+*/
+TEST_F(CharacterNameDirectoryTest, ChangesDuringAReloadAreReplayed) {
+    directory_.load();
+    database_.drain();
+
+    directory_.load();
+    directory_.add(8589934595u, "Han");
+    directory_.remove(8589934594u);
+    database_.drain();
+
+    EXPECT_EQ(8589934595u, directory_.findByName("han"));
+    EXPECT_EQ(0u, directory_.findByName("leia"));
+    EXPECT_EQ(2u, directory_.size());
+
+    // only changes made during a reload are replayed
+    directory_.remove(8589934595u);
+    directory_.load();
+    database_.drain();
+
+    EXPECT_EQ(8589934594u, directory_.findByName("leia"));
+    EXPECT_EQ(2u, directory_.size());
+}
+
+/*! A renamed character is only found under its new name.
+*/
+TEST_F(CharacterNameDirectoryTest, RenamesDropTheOldName) {
+    directory_.load();
+    database_.drain();
+
+    directory_.rename(8589934593u, "Ben");
+
+    EXPECT_EQ(0u, directory_.findByName("luke"));
+    EXPECT_EQ(8589934593u, directory_.findByExactName("Ben"));
+    EXPECT_EQ(2u, directory_.size());
+}
+
+/*! The directory reloads once per interval, the first call only starts the
+* clock.
+*/
+TEST_F(CharacterNameDirectoryTest, ReloadsOncePerInterval) {
+    const uint64 interval = 15 * 60 * 1000;
+
+    directory_.process(1000);
+    directory_.process(1000 + interval - 1);
+    database_.drain();
+    EXPECT_EQ(0u, loadsSent());
+
+    directory_.process(1000 + interval);
+    database_.drain();
+    EXPECT_EQ(1u, loadsSent());
+    EXPECT_TRUE(directory_.isLoaded());
+}
+
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ChatServer/MailStore.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ChatServer/ChatOpcodes.h"
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+std::string headersQuery(uint64 recipient_id) {
+    std::stringstream sql;
+    sql << "CALL galaxy.sp_ReturnChatMailHeaders(" << recipient_id << ");";
+    return sql.str();
+}
+
+/*! Header rows of sp_ReturnChatMailHeaders: id, sender, subject, status, time.
+*/
+std::vector<std::string> headerRows() {
+    const char* cells[] = {
+        "1", "bazaar", "Sale", "0", "100",
+        "2", "bazaar", "Sale", "0", "101",
+        "3", "city", "Taxes", "1", "102"
+    };
+
+    return std::vector<std::string>(cells, cells + sizeof(cells) / sizeof(cells[0]));
+}
+
+class MailStoreTest : public testing::Test {
+protected:
+    MailStoreTest()
+        : config_(1, 1, "global", "galaxy", "config")
+        , database_(memory_.getFactory(), config_)
+        , store_(&database_)
+    {
+        memory_.setResult(headersQuery(7), 5, headerRows());
+    }
+
+    ~MailStoreTest() {
+        database_.drain();
+    }
+
+    size_t queriesSent(const std::string& sql) const {
+        std::vector<std::string> queries = memory_.getQueries();
+        return std::count(queries.begin(), queries.end(), sql);
+    }
+
+    std::vector<MailHeader> loadHeaders(uint64 recipient_id) {
+        std::vector<MailHeader> result;
+        store_.getHeaders(recipient_id, [&result] (const std::vector<MailHeader>& headers) { result = headers; });
+        database_.drain();
+
+        return result;
+    }
+
+    DatabaseImplementationMemory memory_;
+    DatabaseConfig config_;
+    Database database_;
+    MailStore store_;
+};
+
+/*! A second login of the same recipient while its headers load waits for the
+* first load instead of sending another one.
+*/
+TEST_F(MailStoreTest, ConcurrentLoadsShareOneQuery) {
+    size_t first = 0;
+    size_t second = 0;
+
+    store_.getHeaders(7, [&first] (const std::vector<MailHeader>& headers) { first = headers.size(); });
+    store_.getHeaders(7, [&second] (const std::vector<MailHeader>& headers) { second = headers.size(); });
+    database_.drain();
+
+    EXPECT_EQ(1u, queriesSent(headersQuery(7)));
+    EXPECT_EQ(3u, first);
+    EXPECT_EQ(3u, second);
+
+    // cached from now on
+    EXPECT_EQ(3u, loadHeaders(7).size());
+    EXPECT_EQ(1u, queriesSent(headersQuery(7)));
+}
+
+/*! Reads and deletes that have not reached the db yet are applied to the
+* headers loaded meanwhile, and are written by the next flush.
+*/
+TEST_F(MailStoreTest, UnflushedReadsAndDeletesApplyToLoadedHeaders) {
+    store_.markRead(1);
+    store_.remove(2);
+
+    std::vector<MailHeader> headers = loadHeaders(7);
+
+    ASSERT_EQ(2u, headers.size());
+    EXPECT_EQ(1u, headers[0].id);
+    EXPECT_EQ(MailStatus_Read, headers[0].status);
+    EXPECT_EQ(3u, headers[1].id);
+
+    EXPECT_EQ(0u, queriesSent("UPDATE galaxy.chat_mail SET status = 1 WHERE id IN (1)"));
+
+    store_.flush();
+    database_.drain();
+
+    EXPECT_EQ(1u, queriesSent("UPDATE galaxy.chat_mail SET status = 1 WHERE id IN (1)"));
+    EXPECT_EQ(1u, queriesSent("DELETE FROM galaxy.chat_mail WHERE id IN (2)"));
+}
+
+/*! Once the cache is full the recipient used least recently is dropped and
+* loaded again on its next login.
+*/
+TEST_F(MailStoreTest, EvictsTheLeastRecentlyUsedRecipient) {
+    for (uint64 id = 1; id <= MailStore::kMaxCachedRecipients; ++id) {
+        store_.getHeaders(id, [] (const std::vector<MailHeader>&) {});
+    }
+
+    database_.drain();
+    ASSERT_EQ(static_cast<size_t>(MailStore::kMaxCachedRecipients), store_.cachedRecipients());
+
+    // used again, the oldest one is now the second
+    loadHeaders(1);
+    loadHeaders(MailStore::kMaxCachedRecipients + 1);
+
+    EXPECT_EQ(static_cast<size_t>(MailStore::kMaxCachedRecipients), store_.cachedRecipients());
+
+    loadHeaders(1);
+    EXPECT_EQ(1u, queriesSent(headersQuery(1)));
+
+    loadHeaders(2);
+    EXPECT_EQ(2u, queriesSent(headersQuery(2)));
+}
+
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ChatServer/StructureEconomy.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+EconomyHarvesterRow harvester(uint64 id, uint64 resource_id, float fill) {
+    EconomyHarvesterRow row;
+    row.mId = id;
+    row.mResourceId = resource_id;
+    row.mRate = 10.0f;
+    row.mHopperSize = 100.0f;
+    row.mHopperFill = fill;
+    row.mResourceActive = 1;
+    return row;
+}
+
+EconomyHarvesterState state(uint64 id, uint64 resource_id) {
+    EconomyHarvesterState result;
+    result.mId = id;
+    result.mResourceId = resource_id;
+    result.mResourceActive = 1;
+    return result;
+}
+
+/*! Harvesters no longer listed are dropped, new ones and those that switched
+* resources have to be read again, the rest keep their state.
+*/
+TEST(StructureEconomyTests, SyncReportsNewAndChangedHarvesters) {
+    StructureEconomy economy;
+    economy.setHarvester(harvester(1, 50, 0.0f));
+    economy.setHarvester(harvester(2, 50, 0.0f));
+    economy.setHarvester(harvester(3, 50, 0.0f));
+
+    std::vector<EconomyHarvesterState> states;
+    states.push_back(state(3, 50));
+    states.push_back(state(2, 60));
+    states.push_back(state(4, 50));
+
+    std::vector<uint64> stale;
+    economy.syncHarvesters(states, stale);
+
+    EXPECT_EQ(2u, economy.getHarvesterCount());
+    ASSERT_EQ(2u, stale.size());
+    EXPECT_EQ(2u, stale[0]);
+    EXPECT_EQ(4u, stale[1]);
+}
+
+/*! Dropping a harvester moves the last one into its slot, the moved one
+* still harvests under its own id.
+*/
+TEST(StructureEconomyTests, RemovedHarvestersKeepTheOthersIntact) {
+    StructureEconomy economy;
+    economy.setHarvester(harvester(1, 50, 0.0f));
+    economy.setHarvester(harvester(2, 51, 0.0f));
+    economy.setHarvester(harvester(3, 52, 0.0f));
+
+    std::vector<EconomyHarvesterState> states;
+    states.push_back(state(2, 51));
+    states.push_back(state(3, 52));
+
+    std::vector<uint64> stale;
+    economy.syncHarvesters(states, stale);
+    EXPECT_TRUE(stale.empty());
+
+    // replaces the state of 3 instead of adding it again
+    economy.setHarvester(harvester(3, 52, 50.0f));
+    ASSERT_EQ(2u, economy.getHarvesterCount());
+
+    EconomyHarvestResult result;
+    economy.advanceHarvesters(1.0f, result);
+
+    ASSERT_EQ(2u, result.mIds.size());
+    for (size_t i = 0; i < result.mIds.size(); ++i) {
+        EXPECT_EQ(result.mIds[i] + 49, result.mResourceIds[i]);
+    }
+}
+
+/*! Only the harvesters whose hopper fills up this pass are read again, a
+* hopper the zone emptied meanwhile keeps running.
+*/
+TEST(StructureEconomyTests, HarvestersAboutToFillUpAreDue) {
+    StructureEconomy economy;
+    economy.setHarvester(harvester(1, 50, 95.0f));
+    economy.setHarvester(harvester(2, 50, 10.0f));
+
+    std::vector<uint64> due;
+    economy.getHarvestersDue(1.0f, due);
+
+    ASSERT_EQ(1u, due.size());
+    EXPECT_EQ(1u, due[0]);
+
+    economy.setHarvester(harvester(1, 50, 0.0f));
+
+    EconomyHarvestResult result;
+    economy.advanceHarvesters(1.0f, result);
+
+    EXPECT_EQ(2u, result.mIds.size());
+    EXPECT_TRUE(result.mShutdownIds.empty());
+}
+
+/*! Maintenance the pool does not cover comes from the bank read with the
+* structure, what the bank cannot pay damages it.
+*/
+TEST(StructureEconomyTests, UnpaidMaintenanceDamagesTheStructure) {
+    StructureEconomy economy;
+
+    EconomyMaintenanceRow row;
+    row.mId = 7;
+    row.mOwner = 8;
+    row.mMaintenance = 0;
+    row.mMaintenanceRate = 168 * 20;
+    row.mDamage = 0;
+    row.mMaxCondition = 1000;
+    row.mRepairCost = 2;
+    row.mBankCredits = 10;
+    economy.setMaintenance(row);
+
+    std::vector<uint64> due;
+    economy.getMaintenanceDue(1.0f, due);
+    ASSERT_EQ(1u, due.size());
+
+    EconomyMaintenanceResult result;
+    economy.advanceMaintenance(1.0f, result);
+
+    ASSERT_EQ(1u, result.mBankUsed.size());
+    EXPECT_EQ(10u, result.mBankUsed[0]);
+    ASSERT_EQ(1u, result.mDamageAdded.size());
+    EXPECT_EQ(5u, result.mDamageAdded[0]);
+}
+
+}
@@ -29,11 +29,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define SRC_COMMON_EVENTDISPATCHER_H_
 
 #include <cstdint>
-#include <functional>
-#include <list>
-#include <map>
-#include <queue>
-#include <set>
 #include <vector>
 
 #include <boost/thread.hpp>
@@ -41,6 +36,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/ActiveObject.h"
 #include "Utils/Singleton.h"
 #include "Common/Event.h"
+#include "Common/EventDispatcherCore.h"
 
 /*! \brief Common is a catch-all library containing primarily base classes and
  * classes used for maintaining application lifetimes.
@@ -50,24 +46,12 @@ namespace common {
 class EventDispatcher;
 #define gEventDispatcher utils::Singleton<common::EventDispatcher>::Instance()
 
-typedef std::function<bool (IEventPtr)> EventListenerCallback;
-
-// Use a HashString as the basis for EventListenerType's.
-typedef HashString EventListenerType;
-
-// Most of the time spent processing events will be iterating over a collection
-// of callbacks to notify about an event so we want to make use of std::list, however,
-// very infrequently we also want to be able to add and remove listeners and need a
-// way to identify them in the list so a std::pair is used as the node.
-typedef std::pair<EventListenerType, EventListenerCallback> EventListener;
-typedef std::list<EventListener> EventListenerList;
-typedef std::map<EventType, EventListenerList> EventListenerMap;
-typedef std::set<EventType> EventTypeSet;
-typedef std::priority_queue<IEventPtr, std::vector<IEventPtr>, CompareEventWeightLessThanPredicate> EventQueue;
-
 /*! \brief The event dispatcher is a facility for triggering events and passing messages
  * between different "modules" of code that may or may not be running on separate
  * processes or even separate physical machines.
+ *
+ * All calls are forwarded to an EventDispatcherCore running on the dispatcher's own
+ * thread.
  */
 class EventDispatcher {
 public:
@@ -139,6 +123,12 @@ public:
      */
     boost::unique_future<bool> Tick(uint64_t new_timestep);
 
+    /**
+     * Processes all queued events, unlike Tick no future is created for the result
+     * so advancing the dispatcher from a main loop does not allocate.
+     */
+    void Advance(uint64_t new_timestep);
+
     /**
      * Returns the current timestep as provided by the most recent call to Tick.
      *
@@ -153,29 +143,7 @@ private:
     /// Disable the default assignment operator.
     EventDispatcher& operator=(const EventDispatcher&);
 
-    bool ValidateEventType_(const EventType& event_type) const;
-    bool ValidateEventListenerType_(const EventListenerType& event_listener_type) const;
-    bool AddEventType_(const EventType& event_type);
-    void Disconnect_(const EventType& event_type, const EventListenerType& event_listener_type);
-    bool Deliver_(IEventPtr triggered_event);
-        
-    EventTypeSet event_type_set_;
-
-    EventListenerMap event_listener_map_;
-
-    uint64_t current_timestep_;
-    
-    // Uses a double buffered queue to prevent events that generate events from creating
-    // an infinite loop.
-
-    enum ClassConstants
-    {
-        kNumQueues = 2
-    };
-        
-    EventQueue event_queue_[kNumQueues];
-
-    int active_queue_;
+    EventDispatcherCore core_;
     
     utils::ActiveObject active_;
 };
@@ -0,0 +1,338 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "Common/EventDispatcherCore.h"
+
+#include <utility>
+
+namespace common {
+
+EventDispatcherCore::EventDispatcherCore(uint64_t current_time)
+    : current_timestep_(current_time)
+    , active_queue_(0)
+    , timer_wheel_(current_time) {}
+
+EventDispatcherCore::~EventDispatcherCore() {}
+
+void EventDispatcherCore::Connect(const EventType& event_type, EventListener listener) {
+    if (! ValidateEventType_(event_type)) {
+        return;
+    }
+
+    if (! AddEventType_(event_type)) {
+        return;
+    }
+
+    // Look for an entry and
+    auto map_it = event_listener_map_.find(event_type);
+
+    // Somehow the event type doesn't exist.
+    if (map_it == event_listener_map_.end()) {
+        return;
+    }
+
+    // Lookup the listener in the list to see if it already exists.
+    EventListenerList& listener_list = (*map_it).second;
+
+    for (auto list_it = listener_list.begin(), end = listener_list.end(); list_it != end; ++list_it) {
+        if ((*list_it).first.ident() == listener.first.ident()) {
+            return;
+        }
+    }
+
+    // EventType has been validated, the listener validated and doesn't already exist, add it.
+    listener_list.push_back(listener);
+}
+
+void EventDispatcherCore::Disconnect(const EventType& event_type, const EventListenerType& event_listener_type) {
+    // Make sure a valid event type was passed in.
+    if (! ValidateEventType_(event_type)) {
+        return;
+    }
+    // Make sure a valid event listener type was passed in.
+    if (! ValidateEventListenerType_(event_listener_type)) {
+        return;
+    }
+
+    // Look for an entry and
+    auto map_it = event_listener_map_.find(event_type);
+
+    // Somehow the event type doesn't exist.
+    if (map_it == event_listener_map_.end()) {
+        return;
+    }
+
+    // Lookup the listener in the list to see if it already exists.
+    EventListenerList& listener_list = (*map_it).second;
+
+    // Loop through until we find it, no need to worry about invalidating the iterator
+    // because after the erase it's never used again.
+    for (auto list_it = listener_list.begin(), end = listener_list.end(); list_it != end; ++list_it) {
+        if ((*list_it).first.ident() == event_listener_type.ident()) {
+            listener_list.erase(list_it);
+            break; // Item found and there is only one per list, break out.
+        }
+    }
+}
+
+void EventDispatcherCore::DisconnectFromAll(const EventListenerType& event_listener_type) {
+    // Make sure a valid event listener type was passed in.
+    if (! ValidateEventListenerType_(event_listener_type)) {
+        return;
+    }
+
+    // Use the known type lists to loop and call Disconnect for each.
+    for (auto type_it = event_type_set_.begin(), end = event_type_set_.end(); type_it != end; ++type_it) {
+        Disconnect(*type_it, event_listener_type);
+    }
+}
+
+std::vector<EventListener> EventDispatcherCore::GetListeners(const EventType& event_type) const {
+    if (! ValidateEventType_(event_type)) {
+        return std::vector<EventListener>();
+    }
+
+    EventListenerMap::const_iterator map_it = event_listener_map_.find(event_type);
+
+    // no listeners currently for this event type, so sad
+    if (map_it == event_listener_map_.end()) {
+        return std::vector<EventListener>();
+    }
+
+    return map_it->second;
+}
+
+std::vector<EventType> EventDispatcherCore::GetRegisteredEvents() const {
+    return std::vector<EventType>(event_type_set_.begin(), event_type_set_.end());
+}
+
+void EventDispatcherCore::Notify(IEventPtr triggered_event) {
+    // Sanity check on the event itself.
+    if (!triggered_event) return;
+
+    // If the timestamp for the event has not yet been set then set it.
+    if (!triggered_event->timestamp()) {
+        triggered_event->timestamp(current_timestep_);
+    }
+
+    event_queue_[active_queue_].push_back(std::move(triggered_event));
+}
+
+bool EventDispatcherCore::HasEvents() const {
+    return !event_queue_[active_queue_].empty() || !timer_wheel_.empty();
+}
+
+bool EventDispatcherCore::Tick(uint64_t new_timestep) {
+    // If we were passed the same time or a time in the past return false.
+    if (current_timestep_ >= new_timestep) return false;
+
+    current_timestep_ = new_timestep;
+
+    std::vector<IEventPtr>& queue_to_process = event_queue_[active_queue_];
+    active_queue_ = (active_queue_ + 1) % kNumQueues;
+
+    // Events queued since the last tick are either due already or get filed into the
+    // timer wheel, where they wait without being looked at until they are due.
+    for (auto it = queue_to_process.begin(), end = queue_to_process.end(); it != end; ++it) {
+        uint64_t due_time = (*it)->timestamp() + (*it)->delay_ms();
+
+        if (due_time <= current_timestep_) {
+            ready_queue_.push(std::move(*it));
+        } else {
+            timer_wheel_.Schedule(due_time, std::move(*it));
+        }
+    }
+
+    queue_to_process.clear();
+
+    timer_wheel_.Advance(current_timestep_, due_events_);
+
+    for (auto it = due_events_.begin(), end = due_events_.end(); it != end; ++it) {
+        ready_queue_.push(std::move(*it));
+    }
+
+    due_events_.clear();
+
+    // Deliver in order of priority, events triggered during delivery go to the
+    // other queue and are processed on the next tick.
+    while (!ready_queue_.empty()) {
+        IEventPtr event_to_process = ready_queue_.top();
+        ready_queue_.pop();
+
+        Deliver(event_to_process);
+    }
+
+    return true;
+}
+
+bool EventDispatcherCore::ValidateEventType_(const EventType& event_type) const {
+    // Make sure the string isn't empty.
+    if (event_type.ident_string().length() == 0) {
+        return false;
+    }
+
+    // If an event_type already exists verify that the text is the same so
+    // that no naming clashes occur.
+    EventTypeSet::const_iterator it = event_type_set_.find(event_type);
+
+    // Check whether or not the event is known.
+    if (it != event_type_set_.end()) {
+        // If the ident's don't match for whatever reason we failed.
+        if ((*it).ident() != event_type.ident()) {
+            return false;
+        }
+    }
+
+    // If all the tests have passed then return true for validation.
+    return true;
+}
+
+bool EventDispatcherCore::ValidateEventListenerType_(const EventListenerType& event_listener_type) const {
+    // Make sure the string isn't empty.
+    if (event_listener_type.ident_string().length() == 0) {
+        return false;
+    }
+
+    // If all the tests have passed then return true for validation.
+    return true;
+}
+
+bool EventDispatcherCore::AddEventType_(const EventType& event_type) {
+    // check / update type list
+    EventTypeSet::iterator it = event_type_set_.find(event_type);
+
+    // EventType already exists. Return true to indicate so.
+    if (it != event_type_set_.end()) {
+        return true;
+    }
+
+    // The EventType hasn't been registered before, attempt to insert it into the set.
+    std::pair<EventTypeSet::iterator, bool> set_insert_result = event_type_set_.insert(event_type);
+
+    // Insertion failed for some reason.
+    if (set_insert_result.second == false) {
+        return false;
+    }
+
+    // Somehow the insertion left the list empty, bail out.
+    if (set_insert_result.first == event_type_set_.end()) {
+        return false;
+    }
+
+    // Now ensure an empty list exists in the listener map for this type.
+    std::pair<EventListenerMap::iterator, bool> map_insert_result = event_listener_map_.insert(
+                std::pair<EventType, EventListenerList>(event_type, EventListenerList()));
+
+    // Could not insert into map.
+    if (map_insert_result.second == false) {
+        return false;
+    }
+
+    // Somehow the insertion left the map empty, bail out.
+    if (map_insert_result.first == event_listener_map_.end()) {
+        return false;
+    }
+
+    // The event type already existed or it was successfully inserted, either
+    // way it definitely exists in the set now.
+    return true;
+}
+
+bool EventDispatcherCore::Deliver(IEventPtr triggered_event) {
+    // Sanity check to make sure the event is valid.
+    if (!triggered_event) {
+        return false;
+    }
+
+    // Ensure the triggered event is a known valid type.
+    if (!ValidateEventType_(triggered_event->event_type())) {
+        return false;
+    }
+
+    // If the event's timestamp has not been set then set it.
+    if (!triggered_event->timestamp()) {
+        triggered_event->timestamp(current_timestep_);
+    }
+
+    // By default if an event isn't handled this method returns true.
+    bool delivered = true;
+
+    // Find the list of global listeners.
+    auto listener_it = event_listener_map_.find(EventType(kWildCardHashString));
+
+    if (listener_it != event_listener_map_.end()) {
+        // Get the list of global listeners to iterate over, connecting and disconnecting
+        // is never done from within a delivery so there is no need for a copy.
+        const EventListenerList& listeners = listener_it->second;
+
+        // Allow each global listener the opportunity to process the event.
+        for (auto it = listeners.begin(), end = listeners.end(); it != end; ++it) {
+            (*it).second(triggered_event);
+        }
+    }
+
+    // Find the list of listeners for this event type.
+    listener_it = event_listener_map_.find(triggered_event->event_type());
+
+    // If no listeners were found return false.
+    if (listener_it == event_listener_map_.end()) {
+        // Callbacks should be called here if no specific listeners were found.
+        triggered_event->consume(delivered);
+
+        IEventPtr next_event = triggered_event->next();
+
+        if (next_event) {
+            Notify(next_event);
+        }
+
+        return delivered;
+    }
+
+    // Get the list of listeners to iterate over.
+    const EventListenerList& listeners = listener_it->second;
+
+    // Allow each listener the opportunity to process the event, if it does set processed to true.
+    for (auto it = listeners.begin(), end = listeners.end(); it != end; ++it) {
+        if (!(*it).second(triggered_event)) {
+            delivered = false;
+        }
+    }
+
+    // If processing got this far then nothing failed so invoke the callback on the event.
+    triggered_event->consume(delivered);
+
+    IEventPtr next_event = triggered_event->next();
+
+    if (next_event) {
+        Notify(next_event);
+    }
+
+    return delivered;
+}
+
+}  // namespace common
@@ -0,0 +1,180 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_COMMON_EVENTDISPATCHERCORE_H_
+#define SRC_COMMON_EVENTDISPATCHERCORE_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "Common/Event.h"
+#include "Common/EventTimerWheel.h"
+
+namespace common {
+
+typedef std::function<bool (IEventPtr)> EventListenerCallback;
+
+// Use a HashString as the basis for EventListenerType's.
+typedef HashString EventListenerType;
+
+// Most of the time spent processing events will be iterating over a collection
+// of callbacks to notify about an event so they are kept in a flat std::vector,
+// adding and removing listeners is very infrequent in comparison. A std::pair is
+// used as the node to identify a listener when removing it.
+typedef std::pair<EventListenerType, EventListenerCallback> EventListener;
+typedef std::vector<EventListener> EventListenerList;
+typedef std::map<EventType, EventListenerList> EventListenerMap;
+typedef std::set<EventType> EventTypeSet;
+typedef std::priority_queue<IEventPtr, std::vector<IEventPtr>, CompareEventWeightLessThanPredicate> EventQueue;
+
+/*! \brief The single threaded heart of the EventDispatcher, it holds the listeners
+ * and the queued events and does the actual delivery.
+ *
+ * Delayed events are filed into an EventTimerWheel when they are first processed
+ * and stay there untouched until they are due. All queues keep their capacity
+ * between ticks so delivery does not allocate once the dispatcher has warmed up.
+ *
+ * Listeners are iterated in place, they must not connect or disconnect listeners
+ * directly on the core from within a delivery.
+ */
+class EventDispatcherCore {
+public:
+    explicit EventDispatcherCore(uint64_t current_time = 0);
+    ~EventDispatcherCore();
+
+    /**
+     * Connects an event listener to an event.
+     *
+     * \param event_type The event type to check for connected listeners.
+     * \param listener The listener interested in the event specified.
+     */
+    void Connect(const EventType& event_type, EventListener listener);
+
+    /**
+     * Disconnects an event listener from an event.
+     *
+     * \param event_type The event type to disconnect from.
+     * \param event_listener_type The type of the event listener being disconnected.
+     */
+    void Disconnect(const EventType& event_type, const EventListenerType& event_listener_type);
+
+    /**
+     * Disconnects an event listener from all events.
+     *
+     * \param event_listener_type The type of the event listener being disconnected.
+     */
+    void DisconnectFromAll(const EventListenerType& event_listener_type);
+
+    /**
+     * Gets all of the listeners connected to a specific event type.
+     *
+     * \param event_type The event type to check for connected listeners.
+     * \return A list of the connected listeners to the specified event.
+     */
+    std::vector<EventListener> GetListeners(const EventType& event_type) const;
+
+    /**
+     * Gets a list of all of the registered events.
+     *
+     * \returns A list of all the registered events.
+     */
+    std::vector<EventType> GetRegisteredEvents() const;
+
+    /**
+     * Queues an event to be delivered by the next call to Tick that reaches its due time.
+     *
+     * \param triggered_event The triggered event to be delivered.
+     */
+    void Notify(IEventPtr triggered_event);
+
+    /**
+     * Delivers an event immediately to all interested listeners.
+     *
+     * \param triggered_event The triggered event to be delivered.
+     * \returns False if the event was invalid or a listener failed to handle it.
+     */
+    bool Deliver(IEventPtr triggered_event);
+
+    /**
+     * \returns Returns true if their are events waiting, delayed or not.
+     */
+    bool HasEvents() const;
+
+    /**
+     * Processes all queued events that are due by the new timestep.
+     *
+     * \returns False if the new timestep is not past the current one.
+     */
+    bool Tick(uint64_t new_timestep);
+
+    /// \returns The current timestep as provided by the most recent call to Tick.
+    uint64_t current_timestep() const { return current_timestep_; }
+
+private:
+    /// Disable the default copy constructor.
+    EventDispatcherCore(const EventDispatcherCore&);
+
+    /// Disable the default assignment operator.
+    EventDispatcherCore& operator=(const EventDispatcherCore&);
+
+    bool ValidateEventType_(const EventType& event_type) const;
+    bool ValidateEventListenerType_(const EventListenerType& event_listener_type) const;
+    bool AddEventType_(const EventType& event_type);
+
+    EventTypeSet event_type_set_;
+
+    EventListenerMap event_listener_map_;
+
+    uint64_t current_timestep_;
+    
+    // Uses a double buffered queue to prevent events that generate events from creating
+    // an infinite loop.
+
+    enum ClassConstants
+    {
+        kNumQueues = 2
+    };
+        
+    std::vector<IEventPtr> event_queue_[kNumQueues];
+
+    int active_queue_;
+
+    EventTimerWheel timer_wheel_;
+
+    // Scratch space reused by every tick.
+    std::vector<IEventPtr> due_events_;
+    EventQueue ready_queue_;
+};
+
+}  // namespace common
+
+#endif  // SRC_COMMON_EVENTDISPATCHERCORE_H_
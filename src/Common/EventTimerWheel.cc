@@ -0,0 +1,126 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "Common/EventTimerWheel.h"
+
+#include <algorithm>
+
+namespace common {
+
+EventTimerWheel::EventTimerWheel(uint64_t current_time, uint64_t slot_ms, uint32_t slot_count)
+    : slots_(slot_count ? slot_count : 1)
+    , slot_ms_(slot_ms ? slot_ms : 1)
+    , current_slot_(current_time / slot_ms_)
+    , current_time_(current_time)
+    , size_(0) {}
+
+EventTimerWheel::~EventTimerWheel() {}
+
+void EventTimerWheel::Schedule(uint64_t due_time, IEventPtr event) {
+    Entry entry;
+    entry.due_time = due_time;
+    entry.event = std::move(event);
+
+    File_(entry);
+    ++size_;
+}
+
+void EventTimerWheel::Advance(uint64_t new_time, std::vector<IEventPtr>& due_events) {
+    if (new_time < current_time_) {
+        return;
+    }
+
+    uint64_t new_slot = new_time / slot_ms_;
+    uint64_t slot_count = slots_.size();
+
+    // Every slot that was passed completely is due as a whole, the slot the new time
+    // falls into only holds the events up to the new time. Passing more than one
+    // revolution means every slot is due.
+    if (new_slot - current_slot_ >= slot_count) {
+        for (auto it = slots_.begin(), end = slots_.end(); it != end; ++it) {
+            SweepSlot_(*it, new_time, due_events);
+        }
+    } else {
+        for (uint64_t slot = current_slot_; slot <= new_slot; ++slot) {
+            SweepSlot_(slots_[slot % slot_count], new_time, due_events);
+        }
+    }
+
+    current_slot_ = new_slot;
+    current_time_ = new_time;
+
+    // Move the events the wheel has come close enough to out of the overflow.
+    while (!overflow_.empty() && (overflow_.front().due_time / slot_ms_) < current_slot_ + slot_count) {
+        std::pop_heap(overflow_.begin(), overflow_.end(), CompareEntryDueGreaterThan());
+        Entry& entry = overflow_.back();
+
+        if (entry.due_time <= current_time_) {
+            due_events.push_back(std::move(entry.event));
+            --size_;
+        } else {
+            File_(entry);
+        }
+
+        overflow_.pop_back();
+    }
+}
+
+void EventTimerWheel::File_(Entry& entry) {
+    uint64_t slot = std::max(entry.due_time / slot_ms_, current_slot_);
+
+    if (slot - current_slot_ >= slots_.size()) {
+        overflow_.push_back(std::move(entry));
+        std::push_heap(overflow_.begin(), overflow_.end(), CompareEntryDueGreaterThan());
+        return;
+    }
+
+    slots_[slot % slots_.size()].push_back(std::move(entry));
+}
+
+void EventTimerWheel::SweepSlot_(Slot& slot, uint64_t new_time, std::vector<IEventPtr>& due_events) {
+    // Compact the entries that are not due yet to the front of the slot, clearing
+    // rather than shrinking keeps the slot's capacity around for the next revolution.
+    auto keep = slot.begin();
+
+    for (auto it = slot.begin(), end = slot.end(); it != end; ++it) {
+        if (it->due_time <= new_time) {
+            due_events.push_back(std::move(it->event));
+            --size_;
+        } else {
+            if (keep != it) {
+                *keep = std::move(*it);
+            }
+
+            ++keep;
+        }
+    }
+
+    slot.erase(keep, slot.end());
+}
+
+}  // namespace common
@@ -0,0 +1,120 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_COMMON_EVENTTIMERWHEEL_H_
+#define SRC_COMMON_EVENTTIMERWHEEL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Common/Event.h"
+
+namespace common {
+
+/*! \brief Holds delayed events until they are due.
+ *
+ * Events due within the wheel's horizon (slot_count * slot_ms) are filed into the
+ * slot of their due time, advancing the wheel only touches the slots that were
+ * passed. Events beyond the horizon wait in a heap ordered by due time and are
+ * moved into the wheel once it turns close enough, so a long delay is touched a
+ * handful of times instead of on every tick.
+ *
+ * Slots and the heap keep their capacity, in steady state neither scheduling nor
+ * advancing allocates.
+ */
+class EventTimerWheel {
+public:
+    /**
+     * \param current_time The time the wheel starts at.
+     * \param slot_ms The width of one slot in milliseconds.
+     * \param slot_count The number of slots in the wheel.
+     */
+    explicit EventTimerWheel(uint64_t current_time, uint64_t slot_ms = 4, uint32_t slot_count = 1024);
+    ~EventTimerWheel();
+
+    /**
+     * Files an event to be returned once the wheel is advanced to its due time.
+     *
+     * \param due_time The time the event becomes due, times already passed are
+     *      returned with the next advance.
+     * \param event The event to file.
+     */
+    void Schedule(uint64_t due_time, IEventPtr event);
+
+    /**
+     * Advances the wheel, appending every event due at or before the new time.
+     *
+     * \param new_time The time to advance to, ignored if it is in the past.
+     * \param due_events Receives the events that became due.
+     */
+    void Advance(uint64_t new_time, std::vector<IEventPtr>& due_events);
+
+    /// \returns The number of events waiting in the wheel.
+    size_t size() const { return size_; }
+
+    /// \returns True if no events are waiting in the wheel.
+    bool empty() const { return size_ == 0; }
+
+    /// \returns The time the wheel was last advanced to.
+    uint64_t current_time() const { return current_time_; }
+
+private:
+    /// Disable the default copy constructor.
+    EventTimerWheel(const EventTimerWheel&);
+
+    /// Disable the default assignment operator.
+    EventTimerWheel& operator=(const EventTimerWheel&);
+
+    struct Entry {
+        uint64_t due_time;
+        IEventPtr event;
+    };
+
+    struct CompareEntryDueGreaterThan {
+        bool operator() (const Entry& lhs, const Entry& rhs) const {
+            return lhs.due_time > rhs.due_time;
+        }
+    };
+
+    typedef std::vector<Entry> Slot;
+
+    void File_(Entry& entry);
+    void SweepSlot_(Slot& slot, uint64_t new_time, std::vector<IEventPtr>& due_events);
+
+    std::vector<Slot> slots_;
+    std::vector<Entry> overflow_;
+
+    uint64_t slot_ms_;
+    uint64_t current_slot_;
+    uint64_t current_time_;
+    size_t size_;
+};
+
+}  // namespace common
+
+#endif  // SRC_COMMON_EVENTTIMERWHEEL_H_
@@ -58,6 +58,9 @@ BaseServer::BaseServer()
     ("ServerPacketWindowSize", boost::program_options::value<uint32_t>()->default_value(800), "")
     ("ClientPacketWindowSize", boost::program_options::value<uint32_t>()->default_value(80), "")
     ("UdpBufferSize", boost::program_options::value<uint32_t>()->default_value(4096), "Kernel UDP Buffer")
+    ("MainLoopTickInterval", boost::program_options::value<uint32_t>()->default_value(10), "Milliseconds between simulation ticks, the main loop sleeps in between unless there is network or database work.")
+    ("LocalTransportPath", boost::program_options::value<std::string>()->default_value(""), "Unix socket used between the connectionserver and backend servers on the same host, empty to use udp only.")
+    ("CounterInterval", boost::program_options::value<uint32_t>()->default_value(0), "Seconds between writes of the message counters to the server_counters table the load generator reads, 0 disables counting and the writes. The table is created by tools/loadgen/loadgen_fixture.sql.")
     ("DBGlobalSchema", boost::program_options::value<std::string>()->default_value("swganh_static"), "")
     ("DBGalaxySchema", boost::program_options::value<std::string>()->default_value("swganh"), "")
     ("DBConfigSchema", boost::program_options::value<std::string>()->default_value("swganh_config"), "")
@@ -0,0 +1,126 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "Common/EventTimerWheel.h"
+
+using common::EventTimerWheel;
+using common::IEventPtr;
+using common::SimpleEvent;
+using common::EventType;
+
+namespace {
+
+IEventPtr MakeEvent() {
+    return std::make_shared<SimpleEvent>(EventType("wheel_event"));
+}
+
+TEST(EventTimerWheelTests, NewWheelIsEmpty) {
+    EventTimerWheel wheel(100);
+
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(uint64_t(100), wheel.current_time());
+}
+
+TEST(EventTimerWheelTests, EventsAreOnlyReturnedOnceDue) {
+    EventTimerWheel wheel(0, 4, 16);
+    std::vector<IEventPtr> due;
+
+    IEventPtr event = MakeEvent();
+    wheel.Schedule(10, event);
+
+    wheel.Advance(9, due);
+    EXPECT_TRUE(due.empty());
+    EXPECT_EQ(1u, wheel.size());
+
+    wheel.Advance(10, due);
+    ASSERT_EQ(1u, due.size());
+    EXPECT_EQ(event, due[0]);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(EventTimerWheelTests, PastDueEventsAreReturnedOnNextAdvance) {
+    EventTimerWheel wheel(100, 4, 16);
+    std::vector<IEventPtr> due;
+
+    wheel.Schedule(50, MakeEvent());
+    wheel.Advance(101, due);
+
+    EXPECT_EQ(1u, due.size());
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(EventTimerWheelTests, EventsBeyondHorizonAreReturnedWhenDue) {
+    // A horizon of 64ms, the event waits in the overflow until the wheel gets close.
+    EventTimerWheel wheel(0, 4, 16);
+    std::vector<IEventPtr> due;
+
+    wheel.Schedule(1000, MakeEvent());
+
+    for (uint64_t time = 10; time < 1000; time += 10) {
+        wheel.Advance(time, due);
+        ASSERT_TRUE(due.empty());
+    }
+
+    wheel.Advance(1000, due);
+    EXPECT_EQ(1u, due.size());
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(EventTimerWheelTests, AdvancingPastAFullRevolutionReturnsEverything) {
+    EventTimerWheel wheel(0, 4, 16);
+    std::vector<IEventPtr> due;
+
+    wheel.Schedule(5, MakeEvent());
+    wheel.Schedule(40, MakeEvent());
+    wheel.Schedule(63, MakeEvent());
+    wheel.Schedule(500, MakeEvent());
+    wheel.Schedule(5000, MakeEvent());
+
+    wheel.Advance(1000, due);
+
+    EXPECT_EQ(4u, due.size());
+    EXPECT_EQ(1u, wheel.size());
+}
+
+TEST(EventTimerWheelTests, AdvancingBackwardsDoesNothing) {
+    EventTimerWheel wheel(100, 4, 16);
+    std::vector<IEventPtr> due;
+
+    wheel.Schedule(90, MakeEvent());
+    wheel.Advance(50, due);
+
+    EXPECT_TRUE(due.empty());
+    EXPECT_EQ(uint64_t(100), wheel.current_time());
+}
+
+}
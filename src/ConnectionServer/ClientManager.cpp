@@ -31,6 +31,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "NetworkManager/Service.h"
 
+#include <sstream>
+
 // Fix for issues with glog redefining this constant
 #ifdef _WIN32
 #undef ERROR
@@ -45,6 +47,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/Message.h"
 #include "NetworkManager/MessageFactory.h"
 #include "NetworkManager/MessageOpcodes.h"
+#include "NetworkManager/MulticastEnvelope.h"
 
 //======================================================================================================================
 
@@ -65,6 +68,7 @@ ClientManager::ClientManager(Service* service, Database* database, MessageRouter
     mConnectionDispatch->RegisterMessageCallback(opClientIdMsg, this);
     mConnectionDispatch->RegisterMessageCallback(opSelectCharacter, this);
     mConnectionDispatch->RegisterMessageCallback(opClusterZoneTransferCharacter, this);
+    mConnectionDispatch->RegisterMessageCallback(opClusterMulticast, this);
 }
 
 //======================================================================================================================
@@ -75,6 +79,7 @@ ClientManager::~ClientManager(void)
     mConnectionDispatch->UnregisterMessageCallback(opClientIdMsg);
     mConnectionDispatch->UnregisterMessageCallback(opSelectCharacter);
     mConnectionDispatch->UnregisterMessageCallback(opClusterZoneTransferCharacter);
+    mConnectionDispatch->UnregisterMessageCallback(opClusterMulticast);
 }
 
 //======================================================================================================================
@@ -114,6 +119,52 @@ void ClientManager::SendMessageToClient(Message* message)
     }
 }
 
+//======================================================================================================================
+//
+// A backend server sends one payload together with the accounts that should receive it, we hand each local session
+// its own copy. The envelope itself belongs to the server session and is destroyed by the ConnectionDispatch.
+//
+
+void ClientManager::_processClusterMulticast(Message* message)
+{
+    MulticastEnvelope envelope;
+
+    if(!envelope.Read(message))
+    {
+        LOG(WARNING) << "ClientManager::_processClusterMulticast: malformed envelope of " << message->getSize() << " bytes";
+        return;
+    }
+
+    boost::recursive_mutex::scoped_lock lk(mServiceMutex);
+
+    // clients that logged out in the meantime are skipped
+    std::vector<ConnectionClient*> recipients = envelope.FindRecipients<ConnectionClient>([this] (uint32 accountId) -> ConnectionClient* {
+        PlayerClientMap::iterator iter = mPlayerClientMap.find(accountId);
+        return (iter != mPlayerClientMap.end()) ? (*iter).second : NULL;
+    });
+
+    //as in SendMessageToClient, dont hold the service mutex while the sessions lock their own
+    lk.unlock();
+
+    std::vector<ConnectionClient*>::iterator it = recipients.begin();
+
+    while(it != recipients.end())
+    {
+        Message* copy = envelope.CopyPayload();
+
+        if(envelope.getUnreliable())
+        {
+            (*it)->SendChannelAUnreliable(copy, envelope.getPriority());
+        }
+        else
+        {
+            (*it)->SendChannelA(copy, envelope.getPriority(), false);
+        }
+
+        ++it;
+    }
+}
+
 //======================================================================================================================
 //
 // handleserverdown
@@ -232,6 +283,11 @@ void ClientManager::handleDispatchMessage(uint32 opcode, Message* message, Conne
         _processClusterZoneTransferCharacter(client, message);
         break;
     }
+    case opClusterMulticast:
+    {
+        _processClusterMulticast(message);
+        break;
+    }
     }
 }
 
@@ -290,18 +346,45 @@ void ClientManager::_processClientIdMsg(ConnectionClient* client, Message* messa
 void ClientManager::_processSelectCharacter(ConnectionClient* client, Message* message)
 {
     uint64 characterId = message->getUint64();
+    uint32 accountId   = client->getAccountId();
 
-    DatabaseResult* result = mDatabase->executeSynchSql("SELECT planet_id FROM %s.characters WHERE id=%"PRIu64";",mDatabase->galaxy(), characterId);
+    // The message is gone by the time the planet lookup completes, keep a copy
+    // of it to forward to the zone.
+    std::vector<int8> selectData(message->getData(), message->getData() + message->getSize());
+
+    std::stringstream sql;
+    sql << "SELECT planet_id FROM " << mDatabase->galaxy() << ".characters WHERE id=" << characterId << ";";
 
-    uint32 serverId;
     DataBinding* binding = mDatabase->createDataBinding(1);
     binding->addField(DFT_uint32, 0, 4);
-    result->getNextRow(binding, &serverId);
 
-    client->setServerId(serverId + 8);  // server ids for zones are planetId + 8;
+    mDatabase->executeAsyncSql<uint32>(sql.str(), binding, [=] (std::vector<uint32>& rows) {
+        mDatabase->destroyDataBinding(binding);
+
+        if (rows.empty()) {
+            LOG(WARNING) << "Selected character " << characterId << " does not exist";
+            return;
+        }
 
-    mDatabase->destroyDataBinding(binding);
-    mDatabase->destroyResult(result);
+        // The client may have disconnected (and been deleted) while the query
+        // was in flight, only route for the client that is still logged in.
+        boost::recursive_mutex::scoped_lock lk(mServiceMutex);
+
+        PlayerClientMap::iterator iter = mPlayerClientMap.find(accountId);
+
+        if (iter == mPlayerClientMap.end() || (*iter).second != client) {
+            LOG(INFO) << "Account " << accountId << " disconnected before character " << characterId << " was selected";
+            return;
+        }
+
+        _routeSelectCharacter((*iter).second, characterId, rows[0], selectData);
+    });
+}
+
+
+void ClientManager::_routeSelectCharacter(ConnectionClient* client, uint64 characterId, uint32 serverId, const std::vector<int8>& selectData)
+{
+    client->setServerId(serverId + 8);  // server ids for zones are planetId + 8;
 
     // send an opClusterClientConnect message to zone server.
     gMessageFactory->StartMessage();
@@ -330,7 +413,7 @@ void ClientManager::_processSelectCharacter(ConnectionClient* client, Message* m
 
     // Now send the SelectCharacter message off to the zone server.
     gMessageFactory->StartMessage();
-    gMessageFactory->addData(message->getData(), message->getSize());
+    gMessageFactory->addData(&selectData[0], static_cast<uint16>(selectData.size()));
     Message* selectMessage = gMessageFactory->EndMessage();
 
     selectMessage->setAccountId(client->getAccountId());
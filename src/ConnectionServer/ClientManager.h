@@ -34,6 +34,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <boost/thread/recursive_mutex.hpp>
 #include <map>
+#include <vector>
 
 
 //======================================================================================================================
@@ -79,7 +80,9 @@ public:
 private:
     void						_processClientIdMsg(ConnectionClient* client, Message* message);
     void                        _processSelectCharacter(ConnectionClient* client, Message* message);
+    void                        _routeSelectCharacter(ConnectionClient* client, uint64 characterId, uint32 serverId, const std::vector<int8>& selectData);
     void                        _processClusterZoneTransferCharacter(ConnectionClient* client, Message* message);
+    void                        _processClusterMulticast(Message* message);
 
     void                        _handleQueryAuth(ConnectionClient* client, DatabaseResult* result);
     void                        _processAllowedChars(DatabaseCallback* callback,ConnectionClient* client);
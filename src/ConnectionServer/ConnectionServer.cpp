@@ -45,6 +45,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DatabaseManager.h"
@@ -52,6 +53,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/MessageFactory.h"
 #include "Utils/utils.h"
 #include "Utils/clock.h"
+#include "Utils/Reactor.h"
 
 //#include "stackwalker.h"
 #include <boost/thread/thread.hpp>
@@ -64,6 +66,7 @@ ConnectionServer* gConnectionServer = 0;
 
 ConnectionServer::ConnectionServer(int argc, char* argv[]) :
 	BaseServer(),
+    mReactor(0),
     mDatabaseManager(0),
     mDatabase(0),
     mNetworkManager(0),
@@ -75,7 +78,9 @@ ConnectionServer::ConnectionServer(int argc, char* argv[]) :
     mClientService(0),
     mServerService(0),
     mLocked(false),
-    mLastHeartbeat(0)
+    mLastHeartbeat(0),
+    mCounterInterval(0),
+    mLastCounterWrite(0)
 {
     Anh_Utils::Clock::Init();
     LOG(WARNING) << "ConnectionServer Startup";
@@ -94,6 +99,9 @@ ConnectionServer::ConnectionServer(int argc, char* argv[]) :
 	config_files.push_back("config/connectionserver.cfg");
 	LoadOptions_(argc, argv, config_files);
 
+    mReactor = new utils::Reactor(configuration_variables_map_["MainLoopTickInterval"].as<uint32_t>());
+    mCounterInterval = uint64(configuration_variables_map_["CounterInterval"].as<uint32_t>()) * 1000;
+
     // Startup our core modules
 	MessageFactory::getSingleton(configuration_variables_map_["GlobalMessageHeap"].as<uint32_t>());
 
@@ -104,14 +112,20 @@ ConnectionServer::ConnectionServer(int argc, char* argv[]) :
 		configuration_variables_map_["ServerPacketWindowSize"].as<uint32_t>(), 
 		configuration_variables_map_["ClientPacketWindowSize"].as<uint32_t>(),
 		configuration_variables_map_["UdpBufferSize"].as<uint32_t>()));
+    mNetworkManager->setReactor(mReactor);
 
     // Create our status service
     //clientservice
     mClientService = mNetworkManager->GenerateService((char*)configuration_variables_map_["BindAddress"].as<std::string>().c_str(), configuration_variables_map_["BindPort"].as<uint16_t>(),configuration_variables_map_["ClientServiceMessageHeap"].as<uint32_t>()*1024, false);//,5);
+    mClientService->setCountMessages(mCounterInterval != 0);
     //serverservice
     mServerService = mNetworkManager->GenerateService((char*)configuration_variables_map_["ClusterBindAddress"].as<std::string>().c_str(), configuration_variables_map_["ClusterBindPort"].as<uint16_t>(),configuration_variables_map_["ServerServiceMessageHeap"].as<uint32_t>()*1024, true);//,15);
 
+    // backend servers on this host may connect through a local link instead of udp
+    mServerService->ListenLocal(configuration_variables_map_["LocalTransportPath"].as<std::string>());
+
 	mDatabaseManager = new DatabaseManager(DatabaseConfig(configuration_variables_map_["DBMinThreads"].as<uint32_t>(), configuration_variables_map_["DBMaxThreads"].as<uint32_t>(), configuration_variables_map_["DBGlobalSchema"].as<std::string>(), configuration_variables_map_["DBGalaxySchema"].as<std::string>(), configuration_variables_map_["DBConfigSchema"].as<std::string>()));
+    mDatabaseManager->setReactor(mReactor);
 
     mDatabase = mDatabaseManager->connect(DBTYPE_MYSQL,
                                           (char*)(configuration_variables_map_["DBServer"].as<std::string>()).c_str(),
@@ -181,6 +195,8 @@ ConnectionServer::~ConnectionServer(void)
 
     MessageFactory::getSingleton()->destroySingleton();	// Delete message factory and call shutdown();
 
+    delete mReactor;
+
     LOG(WARNING) << "ConnectionServer Shutdown Complete";
 }
 
@@ -210,6 +226,26 @@ void ConnectionServer::Process(void)
         //gLogger->log(LogManager::NOTICE,"ConnectionServer Heartbeat. Connected Servers:%u Active Servers:%u", mServerManager->getConnectedServers(), mServerManager->getActiveServers());
     }
 
+    if (mCounterInterval && Anh_Utils::Clock::getSingleton()->getLocalTime() - mLastCounterWrite > mCounterInterval)
+    {
+        mLastCounterWrite = Anh_Utils::Clock::getSingleton()->getLocalTime();
+        _writeCounters();
+    }
+}
+
+//======================================================================================================================
+//
+// the load generator reports the server side throughput from these, only the
+// client traffic is counted as everything routed to the servers comes from it
+//
+
+void ConnectionServer::_writeCounters(void)
+{
+    std::stringstream sql;
+    sql << "REPLACE INTO " << mDatabase->galaxy() << ".server_counters VALUES ('connection', "
+        << mClientService->getMessagesReceived() << ", " << mClientService->getMessagesSent() << ", " << mLastCounterWrite << ");";
+
+    mDatabase->executeAsyncSql(sql);
 }
 
 //======================================================================================================================
@@ -259,9 +295,14 @@ int main(int argc, char* argv[])
 	try {
 		gConnectionServer = new ConnectionServer(argc, argv);
 
-		// Main loop
+		utils::Reactor* reactor = gConnectionServer->getReactor();
+
+		// Main loop, sleeps until there is network or database work or a tick is due
 		while(1)
 		{
+			// nothing here runs per simulation step, the tick only bounds how long we sleep
+			reactor->Wait();
+
 			gConnectionServer->Process();
 
 			if(Anh_Utils::kbhit())
@@ -272,9 +313,6 @@ int main(int argc, char* argv[])
 				else if(input == 'l')
 					gConnectionServer->ToggleLock();
 			}
-
-
-			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
 		}
 
 		// Shutdown things
@@ -35,6 +35,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 //======================================================================================================================
 
+namespace utils {
+class Reactor;
+}
+
 class DatabaseManager;
 class Database;
 class NetworkManager;
@@ -57,10 +61,16 @@ public:
     void	Process(void);
     void    ToggleLock();
 
+    utils::Reactor*	getReactor() {
+        return mReactor;
+    }
+
 private:
 
     void	_updateDBServerList(uint32 status);
+    void	_writeCounters(void);
 
+    utils::Reactor*			mReactor;
     DatabaseManager*		mDatabaseManager;
     Database*				mDatabase;
     NetworkManager*			mNetworkManager;
@@ -75,6 +85,8 @@ private:
     Service*				mServerService;
     bool					mLocked;
     uint64					mLastHeartbeat;
+    uint64					mCounterInterval;
+    uint64					mLastCounterWrite;
 };
 
 //======================================================================================================================
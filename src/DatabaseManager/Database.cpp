@@ -37,7 +37,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <cstdlib>
 #include <cstdio>
 #include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
 
+#include <boost/thread/thread.hpp>
 #include <glog/logging.h>
 
 #include "DatabaseManager/DataBinding.h"
@@ -45,24 +50,47 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/DatabaseCallback.h"
 #include "DatabaseManager/DatabaseImplementation.h"
 #include "DatabaseManager/DatabaseImplementationMySql.h"
+#include "DatabaseManager/DatabaseImplementationSnapshot.h"
 #include "DatabaseManager/DatabaseJob.h"
 #include "DatabaseManager/DatabaseType.h"
 #include "DatabaseManager/DatabaseWorkerThread.h"
+#include "DatabaseManager/DatabaseWorldImage.h"
 #include "DatabaseManager/Transaction.h"
 
+#include "Utils/Executor.h"
+#include "Utils/Reactor.h"
+
+
+namespace {
+
+DatabaseImplementation* createImplementation(DBType type, const std::string& host, uint16_t port, const std::string& user, const std::string& pass, const std::string& schema) {
+    switch (type) {
+        case DBTYPE_MYSQL: 
+            return new DatabaseImplementationMySql(host, port, user, pass, schema);
+    }
+
+    return nullptr;
+}
+
+}
+
 
 Database::Database(DBType type, const std::string& host, uint16_t port, const std::string& user, const std::string& pass, const std::string& schema, DatabaseConfig& config) 
-    : database_impl_(nullptr)
+    : Database([=] () { return createImplementation(type, host, port, user, pass, schema); }, config)
+{}
+
+
+Database::Database(ImplementationFactory factory, DatabaseConfig& config) 
+    : insert_running_(false)
+    , database_impl_(nullptr)
+    , reactor_(nullptr)
     , job_pool_(sizeof(DatabaseJob))
     , transaction_pool_(sizeof(Transaction))
 {
+    running_jobs_ = 0;
+
     // Create our own DatabaseImplementation for synchronous queries
-    // Create our DBImplementation object
-    switch (type) {
-        case DBTYPE_MYSQL: 
-            database_impl_.reset(new DatabaseImplementationMySql(host, port, user, pass, schema));
-            break;
-    }
+    database_impl_.reset(factory());
 
 	uint32_t min_threads = config.getDbMinThreads();
 	uint32_t max_threads = config.getDbMaxThreads();
@@ -74,9 +102,11 @@ Database::Database(DBType type, const std::string& host, uint16_t port, const st
     uint32_t const hardware_threads = boost::thread::hardware_concurrency();
     uint32_t const num_threads = std::min(hardware_threads != 0 ? hardware_threads : min_threads, max_threads);
 
+    worker_executor_.reset(new utils::Executor(num_threads));
+
     DatabaseWorkerThread* worker = nullptr;
     for (uint32_t i = 0; i < num_threads; i++) {
-        worker = new DatabaseWorkerThread(type, host, port, user, pass, schema);
+        worker = new DatabaseWorkerThread(*worker_executor_, factory());
         idle_worker_queue_.push(worker);
     }
 }
@@ -104,7 +134,7 @@ void Database::executeAsyncSql(const std::string& sql) {
     job->multi_job = false;
 
     // Add the job to our processList;
-    job_pending_queue_.push(job);
+    pushDatabaseJobPending(job);
 }
 void Database::executeAsyncSql(const std::stringstream& sql, AsyncDatabaseCallback callback) {    
     // just pass the stringstream string
@@ -119,7 +149,7 @@ void Database::executeAsyncSql(const std::string& sql, AsyncDatabaseCallback cal
     job->multi_job = false;
 
     // Add the job to our processList;
-    job_pending_queue_.push(job);
+    pushDatabaseJobPending(job);
 }
 
 void Database::executeAsyncProcedure(const std::stringstream& sql) {    
@@ -133,7 +163,7 @@ void Database::executeAsyncProcedure(const std::string& sql) {
     job->multi_job = true;
 
     // Add the job to our processList;
-    job_pending_queue_.push(job);
+    pushDatabaseJobPending(job);
 }
 
 void Database::executeAsyncProcedure(const std::stringstream& sql, AsyncDatabaseCallback callback) {    
@@ -148,17 +178,98 @@ void Database::executeAsyncProcedure(const std::string& sql, AsyncDatabaseCallba
     job->multi_job = true;
 
     // Add the job to our processList;
-    job_pending_queue_.push(job);
+    pushDatabaseJobPending(job);
+}
+
+
+void Database::executeAsyncInsertRow(const std::string& insert_prefix, const std::string& row) {
+    std::map<std::string, DatabaseJob*>::iterator it = open_inserts_.find(insert_prefix);
+
+    // the job stays open for more rows while it waits in the pending queue,
+    // only the main thread touches it until process() hands it to a worker
+    if (it != open_inserts_.end()) {
+        DatabaseJob* job = it->second;
+        job->query.append(",").append(row);
+
+        if (++job->insert_rows == kMaxInsertRows) {
+            open_inserts_.erase(it);
+        }
+
+        return;
+    }
+
+    DatabaseJob* job = new(job_pool_.ordered_malloc()) DatabaseJob();
+    job->query = insert_prefix + row;
+    job->multi_job = false;
+    job->insert_rows = 1;
+
+    open_inserts_[insert_prefix] = job;
+
+    pushDatabaseJobPending(job);
 }
 
 
 void Database::process() {
+    DatabaseJob* job = nullptr;
+
+    dispatchPendingJobs_();
+
+    // Now process any completed jobs.
+    int completed = job_complete_queue_.unsafe_size();
+    for (int i = 0; i < completed; ++i) {
+        // let our client handle the result, if theres a callback
+        if( job_complete_queue_.try_pop(job)) {
+            if (job->static_data && snapshot_writer_) {
+                recordStaticResult_(job);
+            }
+
+            if (job->world_image && world_image_) {
+                world_image_->record(job->query, job->result);
+            }
+
+            if (job->old_callback) {
+                job->old_callback->handleDatabaseJobComplete(job->client_reference, job->result);
+            }
+            
+            if (boost::optional<AsyncDatabaseCallback> c = job->callback) {
+                (*c)(job->result);
+            }
+
+            if (job->insert_rows) {
+                insert_running_ = false;
+            }
+
+            // Free the result and the job, the job owns its query and callback
+            // (and whatever the callback captured, such as a QueryChain).
+            destroyResult(job->result);
+            job->~DatabaseJob();
+            job_pool_.ordered_free(job);
+        }
+    }
+}
+
+
+void Database::drain() {
+    for (;;) {
+        process();
+
+        // a worker pushes its job to the complete queue before it counts down
+        if (!running_jobs_ && job_complete_queue_.empty() && job_pending_queue_.empty()) {
+            break;
+        }
+
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+}
+
+
+void Database::dispatchPendingJobs_() {
     DatabaseWorkerThread* worker = nullptr;
     DatabaseJob* job = nullptr;
 
     // Check to see if we have any idle workers/jobs and execute them.
     int process_count = std::min(idle_worker_queue_.unsafe_size(), job_pending_queue_.unsafe_size());
-    for (int i = 0; i < process_count; ++i) {
+    for (int i = 0; i < process_count && !insert_running_; ++i) {
         // Pop the worker and job off their queues.
         if (!idle_worker_queue_.try_pop(worker)) {
             continue;
@@ -169,6 +280,22 @@ void Database::process() {
             continue;
         }
 
+        // Later queries may update the inserted rows, they wait until the
+        // insert completed. No more rows can be added once it is running.
+        if (job->insert_rows) {
+            std::map<std::string, DatabaseJob*>::iterator it = open_inserts_.begin();
+            for (; it != open_inserts_.end(); ++it) {
+                if (it->second == job) {
+                    open_inserts_.erase(it);
+                    break;
+                }
+            }
+
+            insert_running_ = true;
+        }
+
+        ++running_jobs_;
+
         // Hand The job to the worker.
         worker->executeJob(job, [this] (DatabaseWorkerThread* worker, DatabaseJob* job) {
             // If this is a multi result (meaning a stored procedure was executed
@@ -183,28 +310,10 @@ void Database::process() {
                 idle_worker_queue_.push(worker);
             }
 
-            pushDatabaseJobComplete(job);      
+            pushDatabaseJobComplete(job);
+            --running_jobs_;
         });
     }
-
-    // Now process any completed jobs.
-    int completed = job_complete_queue_.unsafe_size();
-    for (int i = 0; i < completed; ++i) {
-        // let our client handle the result, if theres a callback
-        if( job_complete_queue_.try_pop(job)) {
-            if (job->old_callback) {
-                job->old_callback->handleDatabaseJobComplete(job->client_reference, job->result);
-            }
-            
-            if (boost::optional<AsyncDatabaseCallback> c = job->callback) {
-                (*c)(job->result);
-            }
-
-            // Free the result and the job
-            destroyResult(job->result);
-            job_pool_.ordered_free(job);
-        }
-    }
 }
 
 
@@ -251,8 +360,12 @@ void Database::executeSqlAsync(DatabaseCallback* callback,
     job->query = localSql;
     job->multi_job = false;
 
+    if (serveWorldImage_(job)) {
+        return;
+    }
+
     // Add the job to our processList;
-    job_pending_queue_.push(job);
+    pushDatabaseJobPending(job);
 }
 
 //the reasoning behind this is the following
@@ -276,8 +389,221 @@ void Database::executeSqlAsyncNoArguments(DatabaseCallback* callback,
     job->query = localSql;
     job->multi_job = false;
 
+    if (serveWorldImage_(job)) {
+        return;
+    }
+
     // Add the job to our processList;
-    job_pending_queue_.push(job);
+    pushDatabaseJobPending(job);
+}
+
+
+void Database::executeStaticSqlAsync(DatabaseCallback* callback, 
+                                     void* ref, const char* sql, ...)
+{
+    // format our sql string
+    va_list args;
+    va_start(args, sql);
+    char localSql[20192];
+    vsnprintf(localSql, sizeof(localSql), sql, args);
+    va_end(args);
+
+    // Setup our job.
+    DatabaseJob* job = new(job_pool_.ordered_malloc()) DatabaseJob();
+    job->old_callback = callback;
+    job->client_reference = ref;
+    job->query = localSql;
+    job->multi_job = false;
+    job->static_data = true;
+
+    // Snapshot hits skip the workers but still complete on the next process()
+    // call, callers see the same asynchronous behaviour either way.
+    if (snapshot_impl_ && !snapshot_writer_) {
+        if (DatabaseResult* result = snapshot_impl_->executeSql(job->query)) {
+            job->result = result;
+            pushDatabaseJobComplete(job);
+            return;
+        }
+
+        DLOG(INFO) << "Static data query not in snapshot: " << job->query;
+    }
+
+    // Add the job to our processList;
+    pushDatabaseJobPending(job);
+}
+
+
+bool Database::loadStaticSnapshot(const std::string& filename) {
+    std::unique_ptr<DatabaseImplementationSnapshot> snapshot(new DatabaseImplementationSnapshot(filename));
+
+    if (!snapshot->isOpen()) {
+        return false;
+    }
+
+    if (getStaticDataFingerprint(snapshot->getSourceTables()) != snapshot->getFingerprint()) {
+        LOG(WARNING) << "Static data snapshot " << filename << " is out of date, loading the static data from the database";
+        return false;
+    }
+
+    LOG(INFO) << "Mapped static data snapshot " << filename << " with " << snapshot->getTables().size() << " queries";
+
+    snapshot_impl_ = std::move(snapshot);
+    return true;
+}
+
+
+void Database::startStaticSnapshotExport(const std::string& filename) {
+    snapshot_writer_.reset(new DatabaseSnapshotWriter());
+    snapshot_export_file_ = filename;
+
+    // the queries of an out of date file are dropped, the export runs again for them
+    DatabaseImplementationSnapshot existing(filename);
+    if (existing.isOpen() && getStaticDataFingerprint(existing.getSourceTables()) == existing.getFingerprint()) {
+        snapshot_writer_->addTables(existing);
+    }
+}
+
+
+uint64_t Database::getStaticDataFingerprint(const std::vector<std::string>& tables) {
+    if (tables.empty()) {
+        return DatabaseSnapshotWriter::hashCells(std::vector<std::string>());
+    }
+
+    std::stringstream names, list;
+
+    for (std::vector<std::string>::const_iterator it = tables.begin(); it != tables.end(); ++it) {
+        names << (it == tables.begin() ? "'" : ",'") << database_impl_->escapeString(*it) << "'";
+        list << (it == tables.begin() ? "" : ",") << *it;
+    }
+
+    std::stringstream columns_sql;
+    columns_sql << "SELECT CONCAT(TABLE_SCHEMA, '.', TABLE_NAME), COLUMN_NAME, COLUMN_TYPE FROM information_schema.COLUMNS"
+                << " WHERE CONCAT(TABLE_SCHEMA, '.', TABLE_NAME) IN (" << names.str() << ")"
+                << " ORDER BY TABLE_SCHEMA, TABLE_NAME, ORDINAL_POSITION";
+
+    std::stringstream checksum_sql;
+    checksum_sql << "CHECKSUM TABLE " << list.str();
+
+    uint64_t fingerprint = DatabaseSnapshotWriter::hashCells(std::vector<std::string>());
+
+    std::string queries[] = { columns_sql.str(), checksum_sql.str() };
+    for (size_t i = 0; i < sizeof(queries) / sizeof(queries[0]); ++i) {
+        DatabaseResult* result = database_impl_->executeSql(queries[i]);
+
+        uint32_t columns = 0;
+        std::vector<std::string> cells;
+        DatabaseSnapshotWriter::readResult(result, columns, cells);
+
+        fingerprint = DatabaseSnapshotWriter::hashCells(cells, fingerprint);
+
+        if (result) {
+            database_impl_->destroyResult(result);
+        }
+    }
+
+    return fingerprint;
+}
+
+
+bool Database::finishStaticSnapshotExport() {
+    if (!snapshot_writer_) {
+        return false;
+    }
+
+    std::vector<std::string> queries;
+    snapshot_writer_->getQueries(queries);
+
+    std::set<std::string> source;
+    for (std::vector<std::string>::const_iterator it = queries.begin(); it != queries.end(); ++it) {
+        DatabaseSnapshotWriter::readSourceTables(*it, galaxy_, source);
+    }
+
+    std::vector<std::string> source_tables(source.begin(), source.end());
+    snapshot_writer_->setSource(source_tables, getStaticDataFingerprint(source_tables));
+
+    bool written = snapshot_writer_->write(snapshot_export_file_);
+
+    LOG_IF(INFO, written) << "Exported " << snapshot_writer_->getTableCount() << " static data queries to " << snapshot_export_file_;
+
+    snapshot_writer_.reset();
+    return written;
+}
+
+
+bool Database::startWorldImage(const std::string& filename, bool warm_boot) {
+    world_image_.reset(new DatabaseWorldImage(filename));
+
+    return warm_boot && world_image_->map();
+}
+
+
+void Database::finishWorldImageLoad(std::function<void (bool valid)> callback) {
+    if (!world_image_) {
+        callback(true);
+        return;
+    }
+
+    queueWorldImageQueries_(world_image_->finishLoad(callback));
+}
+
+
+void Database::refreshWorldImage() {
+    if (world_image_) {
+        queueWorldImageQueries_(world_image_->startRefresh());
+    }
+}
+
+
+void Database::writeWorldImage() {
+    if (world_image_) {
+        world_image_->writeNow(*database_impl_);
+    }
+}
+
+
+bool Database::serveWorldImage_(DatabaseJob* job) {
+    // only the binding based loaders read results a snapshot can serve
+    if (!world_image_ || !world_image_->isLoading() || !job->old_callback || !DatabaseWorldImage::isWorldQuery(job->query)) {
+        return false;
+    }
+
+    job->world_image = true;
+
+    if (DatabaseResult* result = world_image_->serve(job->query)) {
+        job->result = result;
+        pushDatabaseJobComplete(job);
+        return true;
+    }
+
+    return false;
+}
+
+
+void Database::queueWorldImageQueries_(const std::vector<std::string>& queries) {
+    // no callbacks, the results are only recorded
+    for (std::vector<std::string>::const_iterator it = queries.begin(); it != queries.end(); ++it) {
+        DatabaseJob* job = new(job_pool_.ordered_malloc()) DatabaseJob();
+        job->query = *it;
+        job->multi_job = false;
+        job->world_image = true;
+
+        pushDatabaseJobPending(job);
+    }
+}
+
+
+void Database::recordStaticResult_(DatabaseJob* job) {
+    // exports never serve from the snapshot, every result here came from the database
+    if (!job->result) {
+        return;
+    }
+
+    uint32_t columns = 0;
+    std::vector<std::string> cells;
+
+    if (DatabaseSnapshotWriter::readResult(job->result, columns, cells)) {
+        snapshot_writer_->addTable(job->query, columns, cells);
+    }
 }
 
 
@@ -313,11 +639,16 @@ void Database::executeProcedureAsync(DatabaseCallback* callback,
     job->multi_job = true;
 
     // Add the job to our processList
-    job_pending_queue_.push(job);
+    pushDatabaseJobPending(job);
 }
 
 
 void Database::destroyResult(DatabaseResult* result) {
+    if (result && result->isSnapshot()) {
+        DatabaseImplementationSnapshot::releaseResult(result);
+        return;
+    }
+
     DatabaseWorkerThread* worker = result->getWorkerReference();
     
     database_impl_->destroyResult(result);
@@ -376,6 +707,23 @@ bool Database::releaseBindingPoolMemory() {
     return(binding_factory_.releasePoolMemory());
 }
 
+void Database::setReactor(utils::Reactor* reactor) {
+    reactor_ = reactor;
+}
+
+void Database::pushDatabaseJobPending(DatabaseJob* job) {
+    job_pending_queue_.push(job);
+
+    // jobs are only handed to the workers from process()
+    if (reactor_) {
+        reactor_->Signal();
+    }
+}
+
 void Database::pushDatabaseJobComplete(DatabaseJob* job) {
     job_complete_queue_.push(job);
+
+    if (reactor_) {
+        reactor_->Signal();
+    }
 }
@@ -31,27 +31,39 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <cstdint>
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <queue>
 #include <string>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <boost/pool/pool.hpp>
 
+#include <tbb/atomic.h>
 #include <tbb/concurrent_queue.h>
 
 #include "DatabaseManager/DatabaseCallback.h"
 #include "DatabaseManager/DatabaseType.h"
 #include "DatabaseManager/DataBindingFactory.h"
 #include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseResult.h"
 
 struct DatabaseJob;
 class DataBinding;
 class DatabaseWorkerThread;
 class DatabaseImplementation;
+class DatabaseImplementationSnapshot;
 class DatabaseResult;
+class DatabaseSnapshotWriter;
+class DatabaseWorldImage;
 class Transaction;
 
+namespace utils {
+class Executor;
+class Reactor;
+}
+
 typedef tbb::concurrent_queue<DatabaseJob*> DatabaseJobQueue;
 typedef tbb::concurrent_queue<DatabaseWorkerThread*> DatabaseWorkerThreadQueue;
 
@@ -72,6 +84,19 @@ public:
 	* \param db_max_threads The maximum number of threads used to process database work.
     */
     Database(DBType type, const std::string& host, uint16_t port, const std::string& user, const std::string& pass, const std::string& schema, DatabaseConfig& config);
+
+    /*! Creates a new connection each time it is invoked, the caller takes ownership.
+    */
+    typedef std::function<DatabaseImplementation* ()> ImplementationFactory;
+
+    /*! Opens the synchronus connection and one connection per worker through
+    * the given factory, used to run against something other than a server
+    * (see DatabaseImplementationMemory).
+    *
+    * \param factory Creates the connections.
+    * \param config The thread and schema settings.
+    */
+    Database(ImplementationFactory factory, DatabaseConfig& config);
     ~Database();
 
     /*! Executes an asynchronus sql query.
@@ -102,6 +127,18 @@ public:
     */
     void executeAsyncSql(const std::string& sql, AsyncDatabaseCallback callback);
 
+    /*! Executes an asynchronus sql query and binds every row of the result to
+    * a T before invoking the specified callback on completion. Like all async
+    * callbacks it runs on the thread calling process().
+    *
+    * \param sql The sql query to run.
+    * \param binding The binding rules used for each row, owned by the caller
+    *   and it must outlive the query.
+    * \param callback The callback to invoke with the bound rows.
+    */
+    template<typename T>
+    void executeAsyncSql(const std::string& sql, DataBinding* binding, std::function<void (std::vector<T>& rows)> callback);
+
     /*! Executes an asynchronus stored procedure.
     *
     * \param sql The sql query to run.
@@ -130,9 +167,25 @@ public:
     */
     void executeAsyncProcedure(const std::string& sql, AsyncDatabaseCallback callback);
     
+    /*! Adds a row to a batched multi row INSERT. Rows with the same prefix
+    * are collected into one statement until a worker picks it up or it holds
+    * kMaxInsertRows rows. No query queued after a row is started before its
+    * statement completed, so updates to the new row can be queued right away.
+    *
+    * \param insert_prefix The statement up to the rows, such as 
+    *   "INSERT INTO galaxy.items (id,parent_id) VALUES ".
+    * \param row The row values, such as "(8,9)".
+    */
+    void executeAsyncInsertRow(const std::string& insert_prefix, const std::string& row);
+
     /*! Processes async queries.
     */
     void process();
+
+    /*! Runs process() until every queued query and its callback completed.
+    * Used on shutdown once the main loop stopped, so queued writes are not lost.
+    */
+    void drain();
     
     /*! Executes an sql query with an unspecified number of parameters.
     *
@@ -152,6 +205,71 @@ public:
     */
     void executeSqlAsyncNoArguments(DatabaseCallback* callback, void* ref, const char* sql);
 
+    /*! Executes an sql query asynchronusly that reads read-only game data. 
+    * The result is served from the static data snapshot when one is loaded 
+    * and contains the query, otherwise it is run against the database.
+    *
+    * \depricated This method is being phased out for a more type-safe solution.
+    */
+    void executeStaticSqlAsync(DatabaseCallback* callback, void* ref, const char* sql, ...);
+
+    /*! Maps a static data snapshot written by an earlier export. A snapshot
+    * whose fingerprint differs from the one of the database now is ignored.
+    *
+    * \param filename The snapshot file.
+    *
+    * \return Returns true if the snapshot was mapped.
+    */
+    bool loadStaticSnapshot(const std::string& filename);
+
+    /*! Computes the fingerprint of the given tables: their columns and types
+    * and the CHECKSUM TABLE of their rows, hashed in the order given.
+    *
+    * \param tables Schema qualified table names.
+    */
+    uint64_t getStaticDataFingerprint(const std::vector<std::string>& tables);
+
+    /*! Starts recording the results of static data queries. Queries already
+    * contained in an existing snapshot file are kept if it is still up to
+    * date, so several zones can export into the same file.
+    *
+    * \param filename The snapshot file to write.
+    */
+    void startStaticSnapshotExport(const std::string& filename);
+
+    /*! Writes the recorded static data queries and stops recording.
+    *
+    * \return Returns true if the snapshot was written.
+    */
+    bool finishStaticSnapshotExport();
+
+    /*! Starts capturing the world load into a world image, see DatabaseWorldImage.
+    *
+    * \param filename The image file.
+    * \param warm_boot Serve the world load from the image an earlier run wrote.
+    *
+    * \return Returns true if the world load is served from an image.
+    */
+    bool startWorldImage(const std::string& filename, bool warm_boot);
+
+    /*! Ends the world load. Writes the captured image, or validates the 
+    * served one against the database in the background.
+    *
+    * \param callback Invoked from process() once the world may go online,
+    *   with false if the served image was stale and had to be discarded.
+    *   Invoked right away if there is nothing to validate.
+    */
+    void finishWorldImageLoad(std::function<void (bool valid)> callback);
+
+    /*! Rebuilds the world image from the database in the background.
+    */
+    void refreshWorldImage();
+
+    /*! Rebuilds the world image from the database and writes it before 
+    * returning, used on a clean shutdown once all writes went through.
+    */
+    void writeWorldImage();
+
     /*! Executes an sql procedure with an unspecified number of parameters.
     *
     * \depricated This method is being phased out for a more type-safe solution.
@@ -240,6 +358,17 @@ public:
     */
     bool releaseBindingPoolMemory();
 
+    /*! Wakes the given reactor whenever a job is queued or completes, so a blocked
+    * main loop gets around to process().
+    *
+    * \param reactor The reactor of the main loop, nullptr to stop signalling.
+    */
+    void setReactor(utils::Reactor* reactor);
+
+    /*! The most rows executeAsyncInsertRow puts into one statement.
+    */
+    static const uint32_t kMaxInsertRows = 100;
+
     const char* global() { return global_.c_str(); }
     const char* galaxy() { return galaxy_.c_str(); }
     const char* config() { return config_.c_str(); }
@@ -251,15 +380,42 @@ private:
 
     DatabaseResult* executeSql(const char* sql, ...);
     
+    void pushDatabaseJobPending(DatabaseJob* job);
     void pushDatabaseJobComplete(DatabaseJob* job);
 
+    void recordStaticResult_(DatabaseJob* job);
+
+    void dispatchPendingJobs_();
+
+    bool serveWorldImage_(DatabaseJob* job);
+    void queueWorldImageQueries_(const std::vector<std::string>& queries);
+
     DataBindingFactory binding_factory_;
 
     DatabaseJobQueue job_pending_queue_;
     DatabaseJobQueue job_complete_queue_;
     DatabaseWorkerThreadQueue idle_worker_queue_;
 
+    // batched inserts still waiting for a worker, by statement prefix
+    std::map<std::string, DatabaseJob*> open_inserts_;
+
+    // a batched insert is running, nothing else is dispatched until it completed
+    bool insert_running_;
+
+    tbb::atomic<uint32_t> running_jobs_;
+
+    // Queries block, the workers get a pool of their own instead of the shared one.
+    std::unique_ptr<utils::Executor> worker_executor_;
+
     std::unique_ptr<DatabaseImplementation> database_impl_;  // Use this implementation for any syncronous calls.
+
+    std::unique_ptr<DatabaseImplementationSnapshot> snapshot_impl_;
+    std::unique_ptr<DatabaseSnapshotWriter> snapshot_writer_;
+    std::string snapshot_export_file_;
+
+    std::unique_ptr<DatabaseWorldImage> world_image_;
+
+    utils::Reactor* reactor_;
     
     boost::pool<boost::default_user_allocator_malloc_free> job_pool_;
     boost::pool<boost::default_user_allocator_malloc_free> transaction_pool_;
@@ -269,4 +425,18 @@ private:
     std::string config_;
 };
 
+
+template<typename T>
+void Database::executeAsyncSql(const std::string& sql, DataBinding* binding, std::function<void (std::vector<T>& rows)> callback) {
+    executeAsyncSql(sql, [binding, callback] (DatabaseResult* result) {
+        std::vector<T> rows(static_cast<size_t>(result->getRowCount()));
+
+        for (T& row : rows) {
+            result->getNextRow(binding, &row);
+        }
+
+        callback(rows);
+    });
+}
+
 #endif // ANH_DATABASEMANAGER_DATABASE_H
@@ -0,0 +1,103 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+
+#include "DatabaseManager/DatabaseResult.h"
+
+
+DatabaseImplementationMemory::DatabaseImplementationMemory()
+    : state_(std::make_shared<State>())
+{}
+
+
+DatabaseImplementationMemory::DatabaseImplementationMemory(std::shared_ptr<State> state)
+    : state_(state)
+{}
+
+
+std::function<DatabaseImplementation* ()> DatabaseImplementationMemory::getFactory() const {
+    std::shared_ptr<State> state = state_;
+
+    return [state] () -> DatabaseImplementation* {
+        return new DatabaseImplementationMemory(state);
+    };
+}
+
+
+void DatabaseImplementationMemory::setResult(const std::string& sql, uint32_t columns, std::vector<std::string> cells) {
+    boost::mutex::scoped_lock lock(state_->mutex);
+
+    std::pair<uint32_t, std::vector<std::string>>& result = state_->results[sql];
+    result.first = columns;
+    result.second.swap(cells);
+}
+
+
+void DatabaseImplementationMemory::setHandler(Handler handler) {
+    boost::mutex::scoped_lock lock(state_->mutex);
+    state_->handler = handler;
+}
+
+
+std::vector<std::string> DatabaseImplementationMemory::getQueries() const {
+    boost::mutex::scoped_lock lock(state_->mutex);
+    return state_->queries;
+}
+
+
+DatabaseResult* DatabaseImplementationMemory::executeSql(const std::string& sql, bool procedure) {
+    uint32_t columns = 0;
+    std::vector<std::string> cells;
+    Handler handler;
+
+    {
+        boost::mutex::scoped_lock lock(state_->mutex);
+        state_->queries.push_back(sql);
+
+        auto it = state_->results.find(sql);
+        if (it != state_->results.end()) {
+            columns = it->second.first;
+            cells = it->second.second;
+        } else {
+            handler = state_->handler;
+        }
+    }
+
+    // the handler runs unlocked, it may block to let a test order completions
+    if (handler && !handler(sql, columns, cells)) {
+        columns = 0;
+        cells.clear();
+    }
+
+    boost::mutex::scoped_lock lock(state_->mutex);
+
+    state_->tables.emplace_back(columns, cells);
+
+    return executeTable(state_->tables.back().getTable());
+}
@@ -0,0 +1,106 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONMEMORY_H
+#define ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONMEMORY_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "DatabaseManager/DatabaseImplementationSnapshot.h"
+
+/*! Answers queries from results held in memory instead of a database server 
+* and remembers every query it was sent. It stands in for the server in unit
+* tests of code built on Database.
+*
+* Every implementation created by the same factory shares its results and 
+* query log, so the synchronus connection and the workers of a Database see
+* the same data. Queries without a result get an empty one, which is what a
+* server returns for writes.
+*
+* \code
+* DatabaseImplementationMemory memory;
+* memory.setResult("SELECT id FROM characters", 1, { "8", "9" });
+* Database database(memory.getFactory(), config);
+* \endcode
+*/
+class DatabaseImplementationMemory : public DatabaseImplementationSnapshot {
+public:
+    /*! Invoked for queries without a fixed result, returning false answers
+    * with an empty result.
+    */
+    typedef std::function<bool (const std::string& sql, uint32_t& columns, std::vector<std::string>& cells)> Handler;
+
+    DatabaseImplementationMemory();
+
+    /*! Returns a factory creating connections that share the results and 
+    * query log of this one, for Database(ImplementationFactory, DatabaseConfig&).
+    */
+    std::function<DatabaseImplementation* ()> getFactory() const;
+
+    /*! Sets the result of a query, replacing an earlier result for the same query.
+    *
+    * \param sql The exact query text.
+    * \param columns The number of columns per row.
+    * \param cells The cell values, row by row.
+    */
+    void setResult(const std::string& sql, uint32_t columns, std::vector<std::string> cells);
+
+    /*! Sets the handler asked for queries without a fixed result.
+    */
+    void setHandler(Handler handler);
+
+    /*! Returns every query executed so far, in the order they were executed.
+    */
+    std::vector<std::string> getQueries() const;
+
+    DatabaseResult* executeSql(const std::string& sql, bool procedure = false);
+
+private:
+    struct State {
+        boost::mutex mutex;
+        std::map<std::string, std::pair<uint32_t, std::vector<std::string>>> results;
+        Handler handler;
+        std::vector<std::string> queries;
+
+        // results point into these until the implementation is destroyed
+        std::list<DatabaseMemoryTable> tables;
+    };
+
+    explicit DatabaseImplementationMemory(std::shared_ptr<State> state);
+
+    std::shared_ptr<State> state_;
+};
+
+#endif // ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONMEMORY_H
@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "DatabaseManager/DatabaseImplementationMySql.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -282,8 +283,9 @@ void DatabaseImplementationMySql::processFieldBinding_(
         }
                                   
         case DFT_raw: {
+            // raw columns hold binary data, copy past embedded zeros
             std::string tmp = result->getString(result_field_id);
-            strncpy(&((char*)object)[binding->getField(field_id).offset], tmp.c_str(), tmp.length());
+            memcpy(&((char*)object)[binding->getField(field_id).offset], tmp.data(), std::min<size_t>(tmp.length(), binding->getField(field_id).size));
             break;
         }
 
@@ -0,0 +1,696 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "DatabaseManager/DatabaseImplementationSnapshot.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+// Fix for issues with glog redefining this constant
+#ifdef ERROR
+#undef ERROR
+#endif
+
+#include <glog/logging.h>
+
+#include <cppconn/resultset.h>
+#include <cppconn/resultset_metadata.h>
+
+#include "Utils/bstring.h"
+
+#include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/DataBinding.h"
+
+namespace {
+
+const char kSnapshotMagic[8] = { 'A', 'N', 'H', 'S', 'D', 'A', 'T', 'A' };
+
+// magic, version, table count, source table count, fingerprint
+const uint64_t kHeaderSize = 28;
+
+// sql length, columns, rows, data length
+const uint64_t kTableHeaderSize = 16;
+
+uint64_t align4(uint64_t size) {
+    return (size + 3) & ~uint64_t(3);
+}
+
+uint32_t readUInt32(const char* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t readUInt64(const char* data) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+void writeUInt32(std::ofstream& file, uint32_t value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeUInt64(std::ofstream& file, uint64_t value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool isNameChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '`' || c == '$';
+}
+
+// reads the identifier or keyword starting at position, skipping whitespace before it
+std::string readWord(const std::string& sql, size_t& position) {
+    while (position < sql.length() && isspace(static_cast<unsigned char>(sql[position]))) {
+        ++position;
+    }
+
+    size_t begin = position;
+    while (position < sql.length() && isNameChar(sql[position])) {
+        ++position;
+    }
+
+    return sql.substr(begin, position - begin);
+}
+
+std::string upper(std::string word) {
+    std::transform(word.begin(), word.end(), word.begin(), toupper);
+    return word;
+}
+
+bool isClauseKeyword(const std::string& word) {
+    static const char* keywords[] = {
+        "WHERE", "ON", "USING", "INNER", "LEFT", "RIGHT", "OUTER", "CROSS", "NATURAL", "JOIN", "STRAIGHT_JOIN",
+        "ORDER", "GROUP", "HAVING", "LIMIT", "UNION", "FOR", "LOCK", "PROCEDURE", "INTO", "WINDOW"
+    };
+
+    std::string keyword = upper(word);
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); ++i) {
+        if (keyword == keywords[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void writePadding(std::ofstream& file, uint64_t size) {
+    static const char zero[4] = { 0, 0, 0, 0 };
+    file.write(zero, align4(size) - size);
+}
+
+}
+
+
+DatabaseMemoryTable::DatabaseMemoryTable(uint32_t columns, const std::vector<std::string>& cells) {
+    offsets_.reserve(cells.size() + 1);
+
+    for (std::vector<std::string>::const_iterator it = cells.begin(); it != cells.end(); ++it) {
+        offsets_.push_back(static_cast<uint32_t>(data_.length()));
+        data_.append(*it);
+    }
+
+    offsets_.push_back(static_cast<uint32_t>(data_.length()));
+
+    table_.columns = columns;
+    table_.rows    = columns ? static_cast<uint32_t>(cells.size() / columns) : 0;
+    table_.offsets = &offsets_[0];
+    table_.data    = data_.c_str();
+}
+
+
+const DatabaseSnapshotTable& DatabaseMemoryTable::getTable() const {
+    return table_;
+}
+
+
+DatabaseImplementationSnapshot::DatabaseImplementationSnapshot(const std::string& filename)
+    : fingerprint_(0)
+{
+    // file_mapping throws on a missing file, which is the common case before the first export
+    if (!std::ifstream(filename.c_str())) {
+        LOG(WARNING) << "Static data snapshot " << filename << " not found";
+        return;
+    }
+
+    try {
+        boost::interprocess::file_mapping file(filename.c_str(), boost::interprocess::read_only);
+        region_.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+    } catch(const boost::interprocess::interprocess_exception& e) {
+        LOG(WARNING) << "Unable to map static data snapshot " << filename << " : " << e.what();
+        return;
+    }
+
+    if (!parse_(static_cast<const char*>(region_->get_address()), region_->get_size())) {
+        LOG(WARNING) << "Discarding invalid or outdated static data snapshot " << filename;
+        tables_.clear();
+        source_tables_.clear();
+        region_.reset();
+    }
+}
+
+
+DatabaseImplementationSnapshot::DatabaseImplementationSnapshot()
+    : fingerprint_(0)
+{}
+
+
+DatabaseImplementationSnapshot::~DatabaseImplementationSnapshot() {}
+
+
+bool DatabaseImplementationSnapshot::isOpen() const {
+    return region_ != nullptr;
+}
+
+
+const DatabaseImplementationSnapshot::TableMap& DatabaseImplementationSnapshot::getTables() const {
+    return tables_;
+}
+
+
+const std::vector<std::string>& DatabaseImplementationSnapshot::getSourceTables() const {
+    return source_tables_;
+}
+
+
+uint64_t DatabaseImplementationSnapshot::getFingerprint() const {
+    return fingerprint_;
+}
+
+
+bool DatabaseImplementationSnapshot::parse_(const char* data, uint64_t size) {
+    if (size < kHeaderSize || memcmp(data, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        return false;
+    }
+
+    if (readUInt32(data + 8) != kVersion) {
+        return false;
+    }
+
+    uint32_t table_count  = readUInt32(data + 12);
+    uint32_t source_count = readUInt32(data + 16);
+    fingerprint_ = readUInt64(data + 20);
+
+    uint64_t position = kHeaderSize;
+
+    for (uint32_t i = 0; i < source_count; ++i) {
+        if (size - position < sizeof(uint32_t)) {
+            return false;
+        }
+
+        uint32_t name_length = readUInt32(data + position);
+        position += sizeof(uint32_t);
+
+        if (size - position < align4(name_length)) {
+            return false;
+        }
+
+        source_tables_.push_back(std::string(data + position, name_length));
+        position += align4(name_length);
+    }
+
+    for (uint32_t i = 0; i < table_count; ++i) {
+        if (size - position < kTableHeaderSize) {
+            return false;
+        }
+
+        uint32_t sql_length  = readUInt32(data + position);
+        uint32_t columns     = readUInt32(data + position + 4);
+        uint32_t rows        = readUInt32(data + position + 8);
+        uint32_t data_length = readUInt32(data + position + 12);
+        position += kTableHeaderSize;
+
+        uint64_t cells = uint64_t(rows) * columns;
+        uint64_t table_size = align4(sql_length) + (cells + 1) * sizeof(uint32_t) + align4(data_length);
+
+        if (size - position < table_size) {
+            return false;
+        }
+
+        std::string sql(data + position, sql_length);
+        position += align4(sql_length);
+
+        DatabaseSnapshotTable table;
+        table.columns = columns;
+        table.rows    = rows;
+        table.offsets = reinterpret_cast<const uint32_t*>(data + position);
+        position += (cells + 1) * sizeof(uint32_t);
+
+        table.data = data + position;
+        position += align4(data_length);
+
+        if (table.offsets[cells] != data_length) {
+            return false;
+        }
+
+        tables_[sql] = table;
+    }
+
+    return true;
+}
+
+
+DatabaseResult* DatabaseImplementationSnapshot::executeSql(const std::string& sql, bool procedure) {
+    TableMap::const_iterator it = tables_.find(sql);
+
+    if (it == tables_.end()) {
+        return nullptr;
+    }
+
+    return new(ResultPool::ordered_malloc()) DatabaseResult(*this, &it->second);
+}
+
+
+DatabaseResult* DatabaseImplementationSnapshot::executeTable(const DatabaseSnapshotTable& table) {
+    return new(ResultPool::ordered_malloc()) DatabaseResult(*this, &table);
+}
+
+
+void DatabaseImplementationSnapshot::destroyResult(DatabaseResult* result) {
+    releaseResult(result);
+}
+
+
+void DatabaseImplementationSnapshot::releaseResult(DatabaseResult* result) {
+    if (!result) {
+        LOG(WARNING) << "DatabaseResult is NULL";
+        return;
+    }
+
+    ResultPool::ordered_free(result);
+}
+
+
+void DatabaseImplementationSnapshot::getNextRow(DatabaseResult* result, DataBinding* binding, void* object) const {
+    const DatabaseSnapshotTable* table = result->snapshot_table_;
+
+    if (!table || result->snapshot_row_ >= table->rows) {
+        return;
+    }
+
+    uint64_t row_start = result->snapshot_row_ * table->columns;
+
+    for (uint32_t i = 0, field_count = binding->getFieldCount(); i < field_count; ++i) {
+        uint32_t column = binding->getField(i).column;
+
+        if (column >= table->columns) {
+            continue;
+        }
+
+        uint32_t begin = table->offsets[row_start + column];
+        uint32_t end   = table->offsets[row_start + column + 1];
+
+        processFieldBinding_(table->data + begin, end - begin, binding, i, object);
+    }
+
+    ++result->snapshot_row_;
+}
+
+
+void DatabaseImplementationSnapshot::resetRowIndex(DatabaseResult* result, uint64_t index) const {
+    if(!result) {
+        LOG(ERROR) << "Bad Ptr 'DatabaseResult* result' at DatabaseImplementationSnapshot::ResetRowIndex.";
+        return;
+    }
+
+    result->snapshot_row_ = index;
+}
+
+
+uint32_t DatabaseImplementationSnapshot::escapeString(char* target, const char* source, uint32_t length) {
+    // snapshot results are read only, nothing is ever sent to a server
+    strncpy(target, source, length);
+    target[length] = 0;
+
+    return length;
+}
+
+
+std::string DatabaseImplementationSnapshot::escapeString(const std::string& source) {
+    return source;
+}
+
+
+void DatabaseImplementationSnapshot::processFieldBinding_(
+    const char* value,
+    uint32_t length,
+    DataBinding* binding, 
+    uint32_t field_id,
+    void* object) const
+{
+    // cells are not null terminated inside the mapping
+    std::string tmp(value, length);
+    char* target = &((char*)object)[binding->getField(field_id).offset];
+
+    // same conversions MySQL Connector/C++ applies to text columns
+    switch (binding->getField(field_id).type) {
+        case DFT_int8: {
+            *((char*)target) = static_cast<char>(strtol(tmp.c_str(), NULL, 10));
+            break;
+        }
+
+        case DFT_uint8: {
+            *((unsigned char*)target) = static_cast<unsigned char>(strtoul(tmp.c_str(), NULL, 10));
+            break;
+        }
+
+        case DFT_int16: {
+            *((short*)target) = static_cast<short>(strtol(tmp.c_str(), NULL, 10));
+            break;
+        }
+
+        case DFT_uint16: {
+            *((unsigned short*)target) = static_cast<unsigned short>(strtoul(tmp.c_str(), NULL, 10));
+            break;
+        }
+
+        case DFT_int32: {
+            *((int*)target) = static_cast<int>(strtol(tmp.c_str(), NULL, 10));
+            break;
+        }
+
+        case DFT_uint32: {
+            *((uint32_t*)target) = static_cast<uint32_t>(strtoul(tmp.c_str(), NULL, 10));
+            break;
+        }
+
+        case DFT_int64: {
+            *((long long*)target) = strtoll(tmp.c_str(), NULL, 10);
+            break;
+        }
+
+        case DFT_uint64: {
+            *((unsigned long long*)target) = strtoull(tmp.c_str(), NULL, 10);
+            break;
+        }
+
+        case DFT_float: {
+            *((float*)target) = static_cast<float>(strtod(tmp.c_str(), NULL));
+            break;
+        }
+
+        case DFT_double: {
+            *((double*)target) = strtod(tmp.c_str(), NULL);
+            break;
+        }
+
+        case DFT_datetime: {
+            break;
+        }
+
+        case DFT_string: {
+            strncpy(target, tmp.c_str(), tmp.length());
+            target[tmp.length()] = 0;
+            break;
+        }
+
+        case DFT_bstring: {
+            BString* bindingString = reinterpret_cast<BString*>(target);
+            *bindingString = tmp.c_str();
+            break;
+        }
+
+        case DFT_raw: {
+            memcpy(target, tmp.data(), std::min<size_t>(tmp.length(), binding->getField(field_id).size));
+            break;
+        }
+
+        default: { break; }
+    }
+}
+
+
+DatabaseSnapshotWriter::DatabaseSnapshotWriter()
+    : fingerprint_(0)
+{}
+
+
+void DatabaseSnapshotWriter::addTable(const std::string& sql, uint32_t columns, std::vector<std::string> cells) {
+    Table& table = tables_[sql];
+    table.columns = columns;
+    table.cells.swap(cells);
+}
+
+
+void DatabaseSnapshotWriter::addTables(const DatabaseImplementationSnapshot& snapshot) {
+    const DatabaseImplementationSnapshot::TableMap& tables = snapshot.getTables();
+
+    for (DatabaseImplementationSnapshot::TableMap::const_iterator it = tables.begin(); it != tables.end(); ++it) {
+        const DatabaseSnapshotTable& source = it->second;
+        uint64_t cell_count = uint64_t(source.rows) * source.columns;
+
+        std::vector<std::string> cells;
+        cells.reserve(static_cast<size_t>(cell_count));
+
+        for (uint64_t i = 0; i < cell_count; ++i) {
+            cells.push_back(std::string(source.data + source.offsets[i], source.offsets[i + 1] - source.offsets[i]));
+        }
+
+        addTable(it->first, source.columns, cells);
+    }
+}
+
+
+bool DatabaseSnapshotWriter::readResult(DatabaseResult* result, uint32_t& columns, std::vector<std::string>& cells) {
+    cells.clear();
+
+    if (!result) {
+        return false;
+    }
+
+    if (const DatabaseSnapshotTable* table = result->snapshot_table_) {
+        uint64_t cell_count = uint64_t(table->rows) * table->columns;
+
+        columns = table->columns;
+        cells.reserve(static_cast<size_t>(cell_count));
+
+        for (uint64_t i = 0; i < cell_count; ++i) {
+            cells.push_back(std::string(table->data + table->offsets[i], table->offsets[i + 1] - table->offsets[i]));
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<sql::ResultSet>& result_set = result->getResultSet();
+
+    if (!result_set) {
+        return false;
+    }
+
+    columns = result_set->getMetaData()->getColumnCount();
+    cells.reserve(static_cast<size_t>(result_set->rowsCount()) * columns);
+
+    while (result_set->next()) {
+        for (uint32_t i = 1; i <= columns; ++i) {
+            cells.push_back(result_set->getString(i));
+        }
+    }
+
+    // hand the result to its callback as if it was never read
+    result_set->beforeFirst();
+
+    return true;
+}
+
+
+void DatabaseSnapshotWriter::readSourceTables(const std::string& sql, const std::string& schema, std::set<std::string>& tables) {
+    size_t position = 0;
+
+    while (position < sql.length()) {
+        std::string word = readWord(sql, position);
+
+        if (word.empty()) {
+            // punctuation, string literals and the like
+            ++position;
+            continue;
+        }
+
+        std::string keyword = upper(word);
+        if (keyword != "FROM" && keyword != "JOIN" && keyword != "STRAIGHT_JOIN") {
+            continue;
+        }
+
+        // FROM a [AS] x, b [AS] y ...
+        for (;;) {
+            std::string table = readWord(sql, position);
+
+            // a derived table, its own FROM is picked up as the scan goes on
+            if (table.empty()) {
+                break;
+            }
+
+            table.erase(std::remove(table.begin(), table.end(), '`'), table.end());
+            tables.insert(table.find('.') == std::string::npos ? schema + "." + table : table);
+
+            size_t next = position;
+            std::string alias = readWord(sql, next);
+
+            if (upper(alias) == "AS") {
+                position = next;
+                alias = readWord(sql, next);
+            }
+
+            if (!alias.empty() && !isClauseKeyword(alias)) {
+                position = next;
+            }
+
+            while (position < sql.length() && isspace(static_cast<unsigned char>(sql[position]))) {
+                ++position;
+            }
+
+            if (position >= sql.length() || sql[position] != ',') {
+                break;
+            }
+
+            ++position;
+        }
+    }
+}
+
+
+uint64_t DatabaseSnapshotWriter::hashCells(const std::vector<std::string>& cells, uint64_t hash) {
+    // FNV-1a over every cell and its length, so moving text between cells changes the hash
+    for (std::vector<std::string>::const_iterator cell = cells.begin(); cell != cells.end(); ++cell) {
+        uint32_t length = static_cast<uint32_t>(cell->length());
+
+        for (size_t i = 0; i < sizeof(length); ++i) {
+            hash = (hash ^ ((length >> (i * 8)) & 0xff)) * 1099511628211ULL;
+        }
+
+        for (std::string::const_iterator c = cell->begin(); c != cell->end(); ++c) {
+            hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+
+void DatabaseSnapshotWriter::setSource(const std::vector<std::string>& source_tables, uint64_t fingerprint) {
+    source_tables_ = source_tables;
+    fingerprint_ = fingerprint;
+}
+
+
+size_t DatabaseSnapshotWriter::getTableCount() const {
+    return tables_.size();
+}
+
+
+void DatabaseSnapshotWriter::getQueries(std::vector<std::string>& queries) const {
+    queries.clear();
+    queries.reserve(tables_.size());
+
+    for (std::map<std::string, Table>::const_iterator it = tables_.begin(); it != tables_.end(); ++it) {
+        queries.push_back(it->first);
+    }
+}
+
+
+bool DatabaseSnapshotWriter::write(const std::string& filename) const {
+    std::string temp_name = filename + ".tmp";
+
+    {
+        std::ofstream file(temp_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!file) {
+            LOG(WARNING) << "Unable to write static data snapshot " << temp_name;
+            return false;
+        }
+
+        file.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+        writeUInt32(file, DatabaseImplementationSnapshot::kVersion);
+        writeUInt32(file, static_cast<uint32_t>(tables_.size()));
+        writeUInt32(file, static_cast<uint32_t>(source_tables_.size()));
+        writeUInt64(file, fingerprint_);
+
+        for (std::vector<std::string>::const_iterator it = source_tables_.begin(); it != source_tables_.end(); ++it) {
+            writeUInt32(file, static_cast<uint32_t>(it->length()));
+            file.write(it->c_str(), it->length());
+            writePadding(file, it->length());
+        }
+
+        for (std::map<std::string, Table>::const_iterator it = tables_.begin(); it != tables_.end(); ++it) {
+            const Table& table = it->second;
+            uint32_t rows = table.columns ? static_cast<uint32_t>(table.cells.size() / table.columns) : 0;
+
+            std::vector<uint32_t> offsets;
+            offsets.reserve(table.cells.size() + 1);
+
+            uint32_t data_length = 0;
+            for (std::vector<std::string>::const_iterator cell = table.cells.begin(); cell != table.cells.end(); ++cell) {
+                offsets.push_back(data_length);
+                data_length += static_cast<uint32_t>(cell->length());
+            }
+            offsets.push_back(data_length);
+
+            writeUInt32(file, static_cast<uint32_t>(it->first.length()));
+            writeUInt32(file, table.columns);
+            writeUInt32(file, rows);
+            writeUInt32(file, data_length);
+
+            file.write(it->first.c_str(), it->first.length());
+            writePadding(file, it->first.length());
+
+            file.write(reinterpret_cast<const char*>(&offsets[0]), offsets.size() * sizeof(uint32_t));
+
+            for (std::vector<std::string>::const_iterator cell = table.cells.begin(); cell != table.cells.end(); ++cell) {
+                file.write(cell->c_str(), cell->length());
+            }
+            writePadding(file, data_length);
+        }
+
+        if (!file) {
+            LOG(WARNING) << "Unable to write static data snapshot " << temp_name;
+            file.close();
+            std::remove(temp_name.c_str());
+            return false;
+        }
+    }
+
+    // zones still mapping the old file keep their pages, rename only swaps the name
+    if (std::rename(temp_name.c_str(), filename.c_str()) != 0) {
+        std::remove(filename.c_str());
+
+        if (std::rename(temp_name.c_str(), filename.c_str()) != 0) {
+            LOG(WARNING) << "Unable to replace static data snapshot " << filename;
+            std::remove(temp_name.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
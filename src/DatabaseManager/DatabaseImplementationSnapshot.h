@@ -0,0 +1,232 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONSNAPSHOT_H
+#define ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONSNAPSHOT_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "DatabaseManager/DatabaseImplementation.h"
+
+namespace boost {
+namespace interprocess {
+class mapped_region;
+}
+}
+
+class DataBinding;
+class DatabaseResult;
+
+/*! One recorded query result inside a static data snapshot. Every cell is
+* stored as the text the server returned for it, cell (row, column) spans
+* data[offsets[n]] to data[offsets[n + 1]] with n = row * columns + column.
+*/
+struct DatabaseSnapshotTable {
+    uint32_t columns;
+    uint32_t rows;
+    const uint32_t* offsets;
+    const char* data;
+};
+
+/*! A table built at runtime from cell text, served like a snapshot table
+* through DatabaseImplementationSnapshot::executeTable.
+*/
+class DatabaseMemoryTable : private boost::noncopyable {
+public:
+    /*! \param columns The number of columns per row.
+    * \param cells The cell values, row by row.
+    */
+    DatabaseMemoryTable(uint32_t columns, const std::vector<std::string>& cells);
+
+    const DatabaseSnapshotTable& getTable() const;
+
+private:
+    std::vector<uint32_t> offsets_;
+    std::string data_;
+    DatabaseSnapshotTable table_;
+};
+
+/*! Serves the results of read-only game data queries out of a memory mapped
+* snapshot file instead of the database server. The file is mapped read only,
+* so zone processes sharing a snapshot share its pages.
+*
+* Results are looked up by their exact query text. Queries that are not part
+* of the snapshot make executeSql return a null pointer, the caller is expected
+* to fall back to the database then.
+*
+* The file also lists the tables the queries read and a fingerprint of their
+* columns and contents taken at export time, see Database::getStaticDataFingerprint.
+* A snapshot whose fingerprint no longer matches the database is out of date.
+*/
+class DatabaseImplementationSnapshot : public DatabaseImplementation, private boost::noncopyable {
+public:
+    typedef std::unordered_map<std::string, DatabaseSnapshotTable> TableMap;
+
+    /*! Bumped whenever the file layout changes, older files are ignored.
+    */
+    static const uint32_t kVersion = 2;
+
+    /*! Maps the snapshot file, check isOpen() for success.
+    *
+    * \param filename The snapshot to map.
+    */
+    explicit DatabaseImplementationSnapshot(const std::string& filename);
+
+    /*! Creates an empty snapshot, it only serves tables passed to executeTable.
+    */
+    DatabaseImplementationSnapshot();
+    ~DatabaseImplementationSnapshot();
+
+    /*! Returns true if a valid snapshot file was mapped.
+    */
+    bool isOpen() const;
+
+    /*! Returns the recorded tables keyed by their query text.
+    */
+    const TableMap& getTables() const;
+
+    /*! Returns the database tables the recorded queries read, schema qualified.
+    */
+    const std::vector<std::string>& getSourceTables() const;
+
+    /*! Returns the fingerprint of the source tables the snapshot was exported from.
+    */
+    uint64_t getFingerprint() const;
+
+    DatabaseResult* executeSql(const std::string& sql, bool procedure = false);
+
+    /*! Serves a result over a table owned by the caller, such as a 
+    * DatabaseMemoryTable. The table must outlive the result.
+    */
+    DatabaseResult* executeTable(const DatabaseSnapshotTable& table);
+
+    void destroyResult(DatabaseResult* result);
+
+    /*! Frees a result served by any snapshot, all snapshots share one result pool.
+    */
+    static void releaseResult(DatabaseResult* result);
+
+    void getNextRow(DatabaseResult* result, DataBinding* binding, void* object) const;
+    void resetRowIndex(DatabaseResult* result, uint64_t index = 0) const;
+
+    uint32_t escapeString(char* target, const char* source, uint32_t length);
+    std::string escapeString(const std::string& source);
+
+private:
+    bool parse_(const char* data, uint64_t size);
+    void processFieldBinding_(const char* value, uint32_t length, DataBinding* binding, uint32_t field_id, void* object) const;
+
+    std::unique_ptr<boost::interprocess::mapped_region> region_;
+    TableMap tables_;
+    std::vector<std::string> source_tables_;
+    uint64_t fingerprint_;
+};
+
+/*! Collects query results and writes them out as a static data snapshot.
+*/
+class DatabaseSnapshotWriter : private boost::noncopyable {
+public:
+    DatabaseSnapshotWriter();
+
+    /*! Adds the result of a query, replacing an earlier result for the same query.
+    *
+    * \param sql The exact query text the result belongs to.
+    * \param columns The number of columns per row.
+    * \param cells The cell values, row by row.
+    */
+    void addTable(const std::string& sql, uint32_t columns, std::vector<std::string> cells);
+
+    /*! Copies all tables of an existing snapshot, used to merge the queries of
+    * several zones into one file.
+    */
+    void addTables(const DatabaseImplementationSnapshot& snapshot);
+
+    /*! Reads every cell of a query result as text. Database results are
+    * rewound afterwards so their callback can still read them, snapshot 
+    * results are copied from their table.
+    *
+    * \param result The result to read.
+    * \param columns Receives the number of columns per row.
+    * \param cells Receives the cell values, row by row.
+    *
+    * \return Returns false if the result holds no readable rows.
+    */
+    static bool readResult(DatabaseResult* result, uint32_t& columns, std::vector<std::string>& cells);
+
+    /*! Adds the tables a query reads from (FROM and JOIN clauses) to a set.
+    * Names without a schema are qualified with the given one.
+    *
+    * \param sql The query text.
+    * \param schema The schema of unqualified table names.
+    * \param tables Receives the schema qualified table names.
+    */
+    static void readSourceTables(const std::string& sql, const std::string& schema, std::set<std::string>& tables);
+
+    /*! Hashes cell values into a fingerprint, the order of the cells matters.
+    */
+    static uint64_t hashCells(const std::vector<std::string>& cells, uint64_t hash = 14695981039346656037ULL);
+
+    /*! Sets the tables the recorded queries read and their fingerprint, both
+    * are stored with the snapshot.
+    */
+    void setSource(const std::vector<std::string>& source_tables, uint64_t fingerprint);
+
+    /*! Returns the number of queries recorded.
+    */
+    size_t getTableCount() const;
+
+    /*! Returns the text of every recorded query.
+    */
+    void getQueries(std::vector<std::string>& queries) const;
+
+    /*! Writes the snapshot, the file is replaced atomically.
+    *
+    * \return Returns true if the file was written.
+    */
+    bool write(const std::string& filename) const;
+
+private:
+    struct Table {
+        uint32_t columns;
+        std::vector<std::string> cells;
+    };
+
+    std::map<std::string, Table> tables_;
+    std::vector<std::string> source_tables_;
+    uint64_t fingerprint_;
+};
+
+#endif // ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONSNAPSHOT_H
@@ -30,6 +30,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <stdlib.h>
 #include <cstring>
+#include <cstdint>
+#include <string>
 
 #include <boost/optional.hpp>
 
@@ -45,6 +47,9 @@ public:
         , result(NULL)
         , client_reference(NULL)
         , multi_job(false) 
+        , static_data(false)
+        , world_image(false)
+        , insert_rows(0)
     {}
 
     boost::optional<AsyncDatabaseCallback> callback;
@@ -53,6 +58,11 @@ public:
     void* client_reference;
     std::string query;
     bool multi_job;
+    bool static_data;
+    bool world_image;
+
+    // rows collected into a batched insert, later jobs wait for it to complete
+    uint32_t insert_rows;
 };
 
 #endif // ANH_DATABASEMANAGER_DATABASEJOB_H
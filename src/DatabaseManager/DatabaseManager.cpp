@@ -40,6 +40,16 @@ void DatabaseManager::process() {
 }
 
 
+void DatabaseManager::setReactor(utils::Reactor* reactor) {
+    reactor_ = reactor;
+
+    std::for_each(database_list_.begin(), database_list_.end(), 
+        [reactor] (std::shared_ptr<Database> db) {
+            db->setReactor(reactor);
+        });
+}
+
+
 Database* DatabaseManager::connect(DBType type, 
                                    const std::string& host, 
                                    uint16_t port, 
@@ -49,6 +59,7 @@ Database* DatabaseManager::connect(DBType type,
 {
     // Create our new Database object and initiailzie it.
 	auto database = std::make_shared<Database>(type, host, port, user, pass, schema, database_configuration_);
+    database->setReactor(reactor_);
 
     // Add the new DB to our process list.
     database_list_.push_back(database);
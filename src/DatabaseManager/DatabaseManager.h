@@ -39,6 +39,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 class Database;
 
+namespace utils {
+class Reactor;
+}
+
 /*! Manages multiple database connections.
 */
 class DatabaseManager : private boost::noncopyable {
@@ -50,12 +54,19 @@ public:
 	 * \see DatabaseConfig
 	 */
 	explicit DatabaseManager(const DatabaseConfig& database_configuration)
-		: database_configuration_(database_configuration) { }
+		: database_configuration_(database_configuration)
+		, reactor_(nullptr) { }
 
     /*! Processes all current database connections.
     */
     void process();
 
+    /*! Lets all current and future database connections wake the given reactor.
+    *
+    * \see Database::setReactor
+    */
+    void setReactor(utils::Reactor* reactor);
+
     /*! Connects to a specified database.
     *
     * \param host The database host to connect to.
@@ -77,6 +88,7 @@ private:
     typedef std::list<std::shared_ptr<Database>> DatabaseList;
     DatabaseList database_list_;
 	DatabaseConfig database_configuration_;
+    utils::Reactor* reactor_;
 };
 
 #endif  // DATABASE_MANAGER_DATABASE_MANAGER_H_
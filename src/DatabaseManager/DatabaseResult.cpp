@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "DatabaseResult.h"
 #include "DatabaseImplementation.h"
+#include "DatabaseImplementationSnapshot.h"
 
 #include <cppconn/resultset.h>
 #include <cppconn/statement.h>
@@ -45,7 +46,17 @@ DatabaseResult::DatabaseResult(const DatabaseImplementation& impl, sql::Statemen
 	, statement_(statement)
     , impl_(impl)
     , worker_(nullptr)
-    , multi_result_(multi_result) {}
+    , multi_result_(multi_result)
+    , snapshot_table_(nullptr)
+    , snapshot_row_(0) {}
+
+
+DatabaseResult::DatabaseResult(const DatabaseImplementation& impl, const DatabaseSnapshotTable* table)
+    : impl_(impl)
+    , worker_(nullptr)
+    , multi_result_(false)
+    , snapshot_table_(table)
+    , snapshot_row_(0) {}
 
 
 DatabaseResult::~DatabaseResult() {}
@@ -88,9 +99,18 @@ bool DatabaseResult::isMultiResult() {
 
 
 uint64_t DatabaseResult::getRowCount() { 
+    if (snapshot_table_) {
+        return snapshot_table_->rows;
+    }
+
     return result_set_ ? result_set_->rowsCount() : 0; 
 }
 
+
+bool DatabaseResult::isSnapshot() {
+    return snapshot_table_ != nullptr;
+}
+
 #ifdef _WIN32
 #pragma warning(pop)
 #endif
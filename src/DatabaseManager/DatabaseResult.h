@@ -40,8 +40,10 @@ namespace sql {
 
 class Database;
 class DatabaseImplementation;
+class DatabaseImplementationSnapshot;
 class DataBinding;
 class DatabaseWorkerThread;
+struct DatabaseSnapshotTable;
 
 /*! A container class for database results. 
 */
@@ -58,6 +60,14 @@ public:
                    sql::Statement* statement, 
                    sql::ResultSet* result_set, 
                    bool multi_result);
+
+    /*! Sets up a database result that is served from a static data snapshot.
+    *
+    * \param impl The snapshot implementation holding the table.
+    * \param table The recorded result of the query.
+    */
+    DatabaseResult(const DatabaseImplementation& impl, 
+                   const DatabaseSnapshotTable* table);
     ~DatabaseResult();
     
     /*! Returns the statement was executed.
@@ -90,8 +100,15 @@ public:
     */
     uint64_t getRowCount();
 
+    /*! Returns whether this result was served from a static data snapshot, 
+    * such results have no statement or result set.
+    */
+    bool isSnapshot();
+
 private:
     friend class Database;
+    friend class DatabaseImplementationSnapshot;
+    friend class DatabaseSnapshotWriter;
 
     DatabaseResult();
 
@@ -105,6 +122,9 @@ private:
 
     DatabaseWorkerThread* worker_;
     bool multi_result_;
+
+    const DatabaseSnapshotTable* snapshot_table_;
+    uint64_t snapshot_row_;
 };
 
 #endif //MMOSERVER_DATABASEMANAGER_DATABASERESULT_H
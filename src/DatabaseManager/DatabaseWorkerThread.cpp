@@ -26,19 +26,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 #include "DatabaseManager/DatabaseWorkerThread.h"
 #include "DatabaseManager/Database.h"
-#include "DatabaseManager/DatabaseImplementationMySql.h"
+#include "DatabaseManager/DatabaseImplementation.h"
 #include "DatabaseManager/DatabaseJob.h"
 
 
-DatabaseWorkerThread::DatabaseWorkerThread(DBType type, const std::string& host, uint16_t port, const std::string& user, const std::string& pass, const std::string& schema)
-    : database_impl_(nullptr)
-{
-    switch (type) {
-        case DBTYPE_MYSQL:
-            database_impl_.reset(new DatabaseImplementationMySql(host, port, user, pass, schema));
-            break;
-    }
-}
+DatabaseWorkerThread::DatabaseWorkerThread(utils::Executor& executor, DatabaseImplementation* database_impl)
+    : active_(executor)
+    , database_impl_(database_impl)
+{}
 
 
 void DatabaseWorkerThread::executeJob(DatabaseJob* job, Callback callback) { 
@@ -37,38 +37,27 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Utils/ActiveObject.h"
 
-#include "DatabaseManager/DatabaseType.h"
-
 struct DatabaseJob;
 class DatabaseImplementation;
 
 
-/*! \brief An encapsulation of a thread dedicated to executing an sql query 
-* asynchronusly. 
+/*! \brief An encapsulation of a connection dedicated to executing an sql query 
+* asynchronusly. Jobs run one at a time on the executor the worker was given.
 */
 class DatabaseWorkerThread : private boost::noncopyable {
 public:
     typedef std::function<void (DatabaseWorkerThread*, DatabaseJob*)> Callback;
 
 public:
-    /*! Overloaded constructor takes in the managing Database instance and 
-    * connection details for starting a new connection.
+    /*! Overloaded constructor takes in the executor to run jobs on and the
+    * connection the jobs are executed with.
     * 
-    * \param type The type of database to connect to.
-    * \param host The hostname to connect to the database on.
-    * \param post The port to connect to the database on.
-    * \param user The username to connect to the database with.
-    * \param pass The password to connect to the database with.
-    * \param schema The schema to connect to to perform queries on.
+    * \param executor The executor that runs the jobs, it must outlive the worker.
+    * \param database_impl The connection of this worker, the worker takes ownership.
     */
-    DatabaseWorkerThread(DBType type, 
-                         const std::string& host, 
-                         uint16_t port, 
-                         const std::string& user, 
-                         const std::string& pass, 
-                         const std::string& schema);
-
-    /*! Executes a DatabaseJob asynchronusly on the worker's private thread.
+    DatabaseWorkerThread(utils::Executor& executor, DatabaseImplementation* database_impl);
+
+    /*! Executes a DatabaseJob asynchronusly on the worker's executor.
     *
     * \param job The database job to execute.
     * \param callback The callback to invoke once execution of the job 
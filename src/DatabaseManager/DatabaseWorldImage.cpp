@@ -0,0 +1,311 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "DatabaseManager/DatabaseWorldImage.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+// Fix for issues with glog redefining this constant
+#ifdef ERROR
+#undef ERROR
+#endif
+
+#include <glog/logging.h>
+
+#include "DatabaseManager/DatabaseImplementation.h"
+#include "DatabaseManager/DatabaseImplementationSnapshot.h"
+#include "DatabaseManager/DatabaseResult.h"
+
+
+DatabaseWorldImage::DatabaseWorldImage(const std::string& filename)
+    : filename_(filename)
+    , writer_(std::make_shared<DatabaseSnapshotWriter>())
+    , state_(kLoading)
+    , pending_(0)
+    , changed_(0)
+{
+    writing_ = false;
+}
+
+
+DatabaseWorldImage::~DatabaseWorldImage() {
+    if (write_thread_.joinable()) {
+        write_thread_.join();
+    }
+}
+
+
+bool DatabaseWorldImage::map() {
+    std::unique_ptr<DatabaseImplementationSnapshot> image(new DatabaseImplementationSnapshot(filename_));
+
+    if (!image->isOpen()) {
+        LOG(WARNING) << "No usable world image " << filename_ << ", loading the world from the database";
+        return false;
+    }
+
+    LOG(INFO) << "Mapped world image " << filename_ << " with " << image->getTables().size() << " queries";
+
+    image_ = std::move(image);
+    return true;
+}
+
+
+bool DatabaseWorldImage::isLoading() const {
+    return state_ == kLoading;
+}
+
+
+bool DatabaseWorldImage::isRefreshing() const {
+    return state_ == kRefreshing;
+}
+
+
+DatabaseResult* DatabaseWorldImage::serve(const std::string& sql) {
+    if (state_ != kLoading || !image_) {
+        return nullptr;
+    }
+
+    return image_->executeSql(sql);
+}
+
+
+void DatabaseWorldImage::record(const std::string& sql, DatabaseResult* result) {
+    if (state_ == kIdle) {
+        return;
+    }
+
+    uint32_t columns = 0;
+    std::vector<std::string> cells;
+
+    if (DatabaseSnapshotWriter::readResult(result, columns, cells)) {
+        if (state_ == kRefreshing && image_ && !matchesImage_(sql, columns, cells)) {
+            ++changed_;
+        }
+
+        writer_->addTable(sql, columns, cells);
+    }
+
+    if (state_ != kRefreshing || !pending_ || --pending_) {
+        return;
+    }
+
+    if (image_) {
+        finishValidation_();
+        return;
+    }
+
+    write_();
+}
+
+
+std::vector<std::string> DatabaseWorldImage::finishLoad(ValidatedCallback callback) {
+    if (state_ != kLoading) {
+        return std::vector<std::string>();
+    }
+
+    writer_->getQueries(queries_);
+
+    if (!image_) {
+        write_();
+
+        if (callback) {
+            callback(true);
+        }
+
+        return std::vector<std::string>();
+    }
+
+    // validate what was served, the rows read back replace the served ones
+    state_ = kRefreshing;
+    changed_ = 0;
+    pending_ = static_cast<uint32_t>(queries_.size());
+    validated_ = callback;
+
+    if (!pending_) {
+        finishValidation_();
+    }
+
+    return queries_;
+}
+
+
+bool DatabaseWorldImage::writeNow(DatabaseImplementation& impl) {
+    if (state_ == kLoading || queries_.empty()) {
+        return false;
+    }
+
+    // a pass still in flight is superseded, its rows are older than these
+    if (write_thread_.joinable()) {
+        write_thread_.join();
+    }
+
+    state_ = kIdle;
+
+    DatabaseSnapshotWriter writer;
+
+    for (std::vector<std::string>::const_iterator it = queries_.begin(); it != queries_.end(); ++it) {
+        DatabaseResult* result = impl.executeSql(*it);
+
+        uint32_t columns = 0;
+        std::vector<std::string> cells;
+
+        if (DatabaseSnapshotWriter::readResult(result, columns, cells)) {
+            writer.addTable(*it, columns, cells);
+        }
+
+        if (result) {
+            impl.destroyResult(result);
+        }
+    }
+
+    bool written = writer.write(filename_);
+    LOG_IF(INFO, written) << "Wrote world image " << filename_ << " with " << writer.getTableCount() << " queries";
+
+    return written;
+}
+
+
+std::vector<std::string> DatabaseWorldImage::startRefresh() {
+    if (state_ != kIdle || writing_ || queries_.empty()) {
+        return std::vector<std::string>();
+    }
+
+    writer_ = std::make_shared<DatabaseSnapshotWriter>();
+
+    state_ = kRefreshing;
+    changed_ = 0;
+    pending_ = static_cast<uint32_t>(queries_.size());
+
+    return queries_;
+}
+
+
+bool DatabaseWorldImage::isWorldQuery(const std::string& sql) {
+    std::string::size_type start = sql.find_first_not_of(" \t\r\n(");
+
+    if (start == std::string::npos || sql.length() - start < 6) {
+        return false;
+    }
+
+    for (std::string::size_type i = 0; i < 6; ++i) {
+        if (::tolower(static_cast<unsigned char>(sql[start + i])) != "select"[i]) {
+            return false;
+        }
+    }
+
+    return sql.find("sf_") == std::string::npos;
+}
+
+
+bool DatabaseWorldImage::matchesImage_(const std::string& sql, uint32_t columns, const std::vector<std::string>& cells) const {
+    const DatabaseImplementationSnapshot::TableMap& tables = image_->getTables();
+    DatabaseImplementationSnapshot::TableMap::const_iterator it = tables.find(sql);
+
+    if (it == tables.end()) {
+        return false;
+    }
+
+    const DatabaseSnapshotTable& table = it->second;
+
+    if (table.columns != columns || uint64_t(table.rows) * table.columns != cells.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < cells.size(); ++i) {
+        uint32_t length = table.offsets[i + 1] - table.offsets[i];
+
+        if (cells[i].length() != length || memcmp(cells[i].data(), table.data + table.offsets[i], length) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void DatabaseWorldImage::finishValidation_() {
+    // the validation pass of a warm boot is complete, the image isn't needed anymore
+    image_.reset();
+
+    bool valid = !changed_;
+
+    if (valid) {
+        LOG(INFO) << "World image validated, all " << queries_.size() << " queries matched the database";
+        write_();
+    } else {
+        LOG(ERROR) << "World image was stale, " << changed_ << " of " << queries_.size() 
+                   << " queries changed since it was written. Discarding " << filename_;
+        discard_();
+    }
+
+    ValidatedCallback callback;
+    callback.swap(validated_);
+
+    if (callback) {
+        callback(valid);
+    }
+}
+
+
+void DatabaseWorldImage::discard_() {
+    state_ = kIdle;
+
+    // the world was built from these rows, nothing may refresh or write them
+    queries_.clear();
+    writer_ = std::make_shared<DatabaseSnapshotWriter>();
+
+    if (std::remove(filename_.c_str()) != 0) {
+        LOG(WARNING) << "Unable to delete stale world image " << filename_;
+    }
+}
+
+
+void DatabaseWorldImage::write_() {
+    state_ = kIdle;
+
+    // startRefresh doesn't begin a pass before the last write is done
+    if (write_thread_.joinable()) {
+        write_thread_.join();
+    }
+
+    // the thread owns this capture, the next pass records into a new writer
+    std::shared_ptr<DatabaseSnapshotWriter> writer;
+    writer.swap(writer_);
+
+    std::string filename = filename_;
+
+    writing_ = true;
+    write_thread_ = boost::thread([this, writer, filename] () {
+        bool written = writer->write(filename);
+        LOG_IF(INFO, written) << "Wrote world image " << filename << " with " << writer->getTableCount() << " queries";
+
+        writing_ = false;
+    });
+}
@@ -0,0 +1,173 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_DATABASEMANAGER_DATABASEWORLDIMAGE_H
+#define ANH_DATABASEMANAGER_DATABASEWORLDIMAGE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <tbb/atomic.h>
+
+class DatabaseImplementation;
+class DatabaseImplementationSnapshot;
+class DatabaseResult;
+class DatabaseSnapshotWriter;
+
+/*! Keeps an image of the rows a zone builds its world from, so a restarted
+* zone can load the world without a round trip per object.
+*
+* While the world loads every object query is recorded. On a warm boot the
+* queries are answered from the image of the previous run instead, only
+* queries the image doesn't hold at all go to the database. A row that changed
+* since the image was written is therefore served in its old state, and an
+* object that was created or moved is missing from the container it is in now.
+*
+* Once the world is loaded all recorded queries are run against the database
+* again. The zone only goes online if every one of them matched the image. A
+* stale image is deleted and the warm boot is aborted, the next start loads
+* the world from the database.
+*
+* A zone that is online refreshes the image periodically in the background
+* and writes it one last time on a clean shutdown, after all of its writes
+* reached the database. The file uses the static data snapshot format, a new
+* image is written to a temporary file and swapped in with a rename, so a 
+* crash while writing leaves the old image intact.
+*/
+class DatabaseWorldImage : private boost::noncopyable {
+public:
+    /*! Invoked once a served image was validated.
+    *
+    * \param valid False if the database no longer matched the image.
+    */
+    typedef std::function<void (bool valid)> ValidatedCallback;
+
+    /*! \param filename The image file.
+    */
+    explicit DatabaseWorldImage(const std::string& filename);
+    ~DatabaseWorldImage();
+
+    /*! Maps the image written by an earlier run, world load queries are
+    * served from it until finishLoad is called.
+    *
+    * \return Returns true if a valid image was mapped.
+    */
+    bool map();
+
+    /*! Returns true while the world is loading.
+    */
+    bool isLoading() const;
+
+    /*! Returns true while the rows of a refresh pass are coming in.
+    */
+    bool isRefreshing() const;
+
+    /*! Serves a world load query from the mapped image.
+    *
+    * \return Returns the result or a null pointer if the image doesn't hold
+    *   the query (or none is mapped).
+    */
+    DatabaseResult* serve(const std::string& sql);
+
+    /*! Records the result of a world load or refresh query.
+    *
+    * \param sql The exact query text.
+    * \param result The result, may be a null pointer for a failed query.
+    */
+    void record(const std::string& sql, DatabaseResult* result);
+
+    /*! Ends the world load. 
+    *
+    * \param callback Invoked once the served image was validated, right away
+    *   after a cold load.
+    *
+    * \return Returns the queries that have to be run again to validate a 
+    *   served image. After a cold load the recorded image is written right
+    *   away and nothing is returned.
+    */
+    std::vector<std::string> finishLoad(ValidatedCallback callback);
+
+    /*! Starts a refresh pass.
+    *
+    * \return Returns the queries to run again, nothing while the world loads,
+    *   an earlier pass is incomplete or its image is still being written.
+    */
+    std::vector<std::string> startRefresh();
+
+    /*! Runs every recorded query on the given connection and writes the image
+    * before returning, used on shutdown. Does nothing while the world loads
+    * or after a stale image was discarded.
+    *
+    * \param impl The connection to read the rows with.
+    *
+    * \return Returns true if the image was written.
+    */
+    bool writeNow(DatabaseImplementation& impl);
+
+    /*! Returns true if the given query is part of world loading, only plain
+    * reads qualify. Stored functions may change data and are never recorded.
+    */
+    static bool isWorldQuery(const std::string& sql);
+
+private:
+    enum State {
+        kIdle,
+        kLoading,
+        kRefreshing
+    };
+
+    bool matchesImage_(const std::string& sql, uint32_t columns, const std::vector<std::string>& cells) const;
+    void finishValidation_();
+    void discard_();
+    void write_();
+
+    std::string filename_;
+
+    std::unique_ptr<DatabaseImplementationSnapshot> image_;
+    std::shared_ptr<DatabaseSnapshotWriter> writer_;
+
+    // the queries of the last complete capture
+    std::vector<std::string> queries_;
+
+    State state_;
+    uint32_t pending_;
+    uint32_t changed_;
+
+    ValidatedCallback validated_;
+
+    boost::thread write_thread_;
+    tbb::atomic<bool> writing_;
+};
+
+#endif // ANH_DATABASEMANAGER_DATABASEWORLDIMAGE_H
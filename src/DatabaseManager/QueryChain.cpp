@@ -0,0 +1,115 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "DatabaseManager/QueryChain.h"
+
+#include "DatabaseManager/Database.h"
+
+
+std::shared_ptr<QueryChain> QueryChain::create(Database* database) {
+    return std::shared_ptr<QueryChain>(new QueryChain(database));
+}
+
+
+QueryChain::QueryChain(Database* database)
+    : database_(database)
+{}
+
+
+QueryChain& QueryChain::then(const std::string& sql, StepCallback callback) {
+    Step step;
+    step.builder = [sql] () { return sql; };
+    step.callback = callback;
+
+    steps_.push_back(step);
+    return *this;
+}
+
+
+QueryChain& QueryChain::thenBuild(QueryBuilder builder, StepCallback callback) {
+    Step step;
+    step.builder = builder;
+    step.callback = callback;
+
+    steps_.push_back(step);
+    return *this;
+}
+
+
+QueryChain& QueryChain::finally(std::function<void ()> handler) {
+    finally_ = handler;
+    return *this;
+}
+
+
+void QueryChain::execute() {
+    runNextStep_();
+}
+
+
+void QueryChain::runNextStep_() {
+    // Skip over any steps that decided they have nothing to do.
+    while (!steps_.empty()) {
+        Step step = steps_.front();
+        steps_.pop_front();
+
+        std::string sql = step.builder();
+        if (sql.empty()) {
+            continue;
+        }
+
+        // The lambda holds a reference to the chain until the query completes,
+        // this is what keeps the chain alive between steps.
+        std::shared_ptr<QueryChain> self = shared_from_this();
+        StepCallback callback = step.callback;
+
+        database_->executeAsyncSql(sql, [self, callback] (DatabaseResult* result) {
+            if (callback && !callback(result)) {
+                self->finish_();
+                return;
+            }
+
+            self->runNextStep_();
+        });
+
+        return;
+    }
+
+    finish_();
+}
+
+
+void QueryChain::finish_() {
+    steps_.clear();
+
+    if (finally_) {
+        std::function<void ()> handler = finally_;
+        finally_ = nullptr;
+        handler();
+    }
+}
@@ -0,0 +1,117 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_DATABASEMANAGER_QUERYCHAIN_H
+#define ANH_DATABASEMANAGER_QUERYCHAIN_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+class Database;
+class DatabaseResult;
+
+/*! A sequence of asynchronus queries where each step is only sent to the
+* database once the previous one has completed. Every callback runs on the 
+* thread that calls Database::process(), so a step can read the results of 
+* an earlier query and decide what to write next without ever blocking the
+* main loop (read-then-update).
+*
+* The chain keeps itself alive until its last step has completed, callers
+* only need to hold on to it while adding steps:
+*
+* \code
+* QueryChain::create(database)
+*     ->then("SELECT credits FROM ...", [&credits] (DatabaseResult* result) { ...; return true; })
+*     .thenBuild([&credits] () { return "UPDATE ..."; })
+*     .finally([] () { ... })
+*     .execute();
+* \endcode
+*/
+class QueryChain : public std::enable_shared_from_this<QueryChain>, private boost::noncopyable
+{
+public:
+    /*! Invoked with the result of a step, returning false ends the chain 
+    * early (the finally handler is still invoked).
+    */
+    typedef std::function<bool (DatabaseResult*)> StepCallback;
+
+    /*! Builds the sql of a step at the time it is executed, returning an 
+    * empty string skips the step.
+    */
+    typedef std::function<std::string ()> QueryBuilder;
+
+    /*! Creates a new, empty chain.
+    *
+    * \param database The database to run the queries on.
+    */
+    static std::shared_ptr<QueryChain> create(Database* database);
+
+    /*! Appends a query with a fixed sql string.
+    *
+    * \param sql The sql query to run.
+    * \param callback Invoked with the result of the query, may be empty.
+    */
+    QueryChain& then(const std::string& sql, StepCallback callback = nullptr);
+
+    /*! Appends a query whose sql depends on the results of earlier steps.
+    *
+    * \param builder Invoked once all earlier steps completed to build the sql.
+    * \param callback Invoked with the result of the query, may be empty.
+    */
+    QueryChain& thenBuild(QueryBuilder builder, StepCallback callback = nullptr);
+
+    /*! Sets a handler invoked once the chain has run to completion or was
+    * ended early by a step.
+    */
+    QueryChain& finally(std::function<void ()> handler);
+
+    /*! Starts executing the chain. Steps must not be added afterwards.
+    */
+    void execute();
+
+private:
+    struct Step {
+        QueryBuilder builder;
+        StepCallback callback;
+    };
+
+    explicit QueryChain(Database* database);
+
+    void runNextStep_();
+    void finish_();
+
+    Database* database_;
+    std::deque<Step> steps_;
+    std::function<void ()> finally_;
+};
+
+#endif // ANH_DATABASEMANAGER_QUERYCHAIN_H
@@ -0,0 +1,225 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "DatabaseManager/DatabaseImplementationSnapshot.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseCallback.h"
+#include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+#include "DatabaseManager/DatabaseResult.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+const char kSkillQuery[] = "SELECT skill_id, name FROM galaxy.skills ORDER BY skill_id";
+const char kChecksumQuery[] = "CHECKSUM TABLE galaxy.skills";
+
+std::string tempPath(const char* name) {
+    static int count = 0;
+
+    std::stringstream path;
+    path << "/tmp/anh_" << name << "_" << getpid() << "_" << ++count;
+    return path.str();
+}
+
+std::vector<std::string> cells(const char* first, const char* second) {
+    std::vector<std::string> result;
+    result.push_back(first);
+    result.push_back(second);
+    return result;
+}
+
+std::string cell(const DatabaseSnapshotTable& table, uint32_t row, uint32_t column) {
+    uint32_t n = row * table.columns + column;
+    return std::string(table.data + table.offsets[n], table.offsets[n + 1] - table.offsets[n]);
+}
+
+/*! Loads a static table through the old callback interface, the way the
+* game data managers do.
+*/
+class StaticLoader : public DatabaseCallback {
+public:
+    StaticLoader() : done_(false) {}
+
+    void handleDatabaseJobComplete(void* ref, DatabaseResult* result) {
+        done_ = true;
+    }
+
+    bool done_;
+};
+
+class DatabaseSnapshotTest : public testing::Test {
+protected:
+    DatabaseSnapshotTest()
+        : config_(1, 1, "global", "galaxy", "config")
+        , filename_(tempPath("static_snapshot"))
+    {
+        memory_.setResult(kSkillQuery, 2, cells("1", "combat_brawler_novice"));
+        memory_.setResult(kChecksumQuery, 2, cells("galaxy.skills", "1234"));
+    }
+
+    ~DatabaseSnapshotTest() {
+        std::remove(filename_.c_str());
+    }
+
+    void exportSnapshot() {
+        Database database(memory_.getFactory(), config_);
+        database.startStaticSnapshotExport(filename_);
+
+        StaticLoader loader;
+        database.executeStaticSqlAsync(&loader, nullptr, kSkillQuery);
+
+        for (int i = 0; i < 2000 && !loader.done_; ++i) {
+            database.process();
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+
+        ASSERT_TRUE(loader.done_);
+        ASSERT_TRUE(database.finishStaticSnapshotExport());
+    }
+
+    DatabaseImplementationMemory memory_;
+    DatabaseConfig config_;
+    std::string filename_;
+};
+
+/*! A written snapshot parses back to the same tables, cells, source tables
+* and fingerprint.
+*/
+TEST_F(DatabaseSnapshotTest, WrittenSnapshotsParseBack) {
+    DatabaseSnapshotWriter writer;
+
+    std::vector<std::string> rows;
+    rows.push_back("1");
+    rows.push_back("");
+    rows.push_back("22");
+    rows.push_back("odd length");
+    writer.addTable("SELECT a, b FROM galaxy.one", 2, rows);
+    writer.addTable("SELECT a FROM galaxy.empty", 1, std::vector<std::string>());
+
+    std::vector<std::string> source;
+    source.push_back("galaxy.empty");
+    source.push_back("galaxy.one");
+    writer.setSource(source, 0x0123456789abcdefULL);
+
+    ASSERT_TRUE(writer.write(filename_));
+
+    DatabaseImplementationSnapshot snapshot(filename_);
+    ASSERT_TRUE(snapshot.isOpen());
+
+    EXPECT_EQ(0x0123456789abcdefULL, snapshot.getFingerprint());
+    EXPECT_EQ(source, snapshot.getSourceTables());
+    ASSERT_EQ(2u, snapshot.getTables().size());
+
+    const DatabaseSnapshotTable& one = snapshot.getTables().find("SELECT a, b FROM galaxy.one")->second;
+    ASSERT_EQ(2u, one.columns);
+    ASSERT_EQ(2u, one.rows);
+    EXPECT_EQ("1", cell(one, 0, 0));
+    EXPECT_EQ("", cell(one, 0, 1));
+    EXPECT_EQ("22", cell(one, 1, 0));
+    EXPECT_EQ("odd length", cell(one, 1, 1));
+
+    EXPECT_EQ(0u, snapshot.getTables().find("SELECT a FROM galaxy.empty")->second.rows);
+}
+
+/*! Files of an older layout and cut off files are ignored.
+*/
+TEST_F(DatabaseSnapshotTest, OldAndTruncatedFilesAreIgnored) {
+    {
+        std::ofstream file(filename_.c_str(), std::ios::binary);
+        const char header[16] = { 'A', 'N', 'H', 'S', 'D', 'A', 'T', 'A', 1, 0, 0, 0, 0, 0, 0, 0 };
+        file.write(header, sizeof(header));
+    }
+
+    EXPECT_FALSE(DatabaseImplementationSnapshot(filename_).isOpen());
+
+    DatabaseSnapshotWriter writer;
+    writer.addTable(kSkillQuery, 2, cells("1", "combat_brawler_novice"));
+    ASSERT_TRUE(writer.write(filename_));
+
+    std::ifstream written(filename_.c_str(), std::ios::binary | std::ios::ate);
+    ASSERT_EQ(0, truncate(filename_.c_str(), static_cast<off_t>(written.tellg()) - 4));
+    EXPECT_FALSE(DatabaseImplementationSnapshot(filename_).isOpen());
+}
+
+/*! The tables of FROM and JOIN clauses are found, with or without a schema,
+* alias or comma list.
+*/
+TEST(DatabaseSnapshotWriterTests, ReadsTheTablesAQueryReads) {
+    std::set<std::string> tables;
+
+    DatabaseSnapshotWriter::readSourceTables("SELECT * FROM galaxy.skills ORDER BY skill_id", "galaxy", tables);
+    DatabaseSnapshotWriter::readSourceTables("SELECT a.name FROM galaxy.draft_schematic_attribute_manipulation as dsam"
+        " INNER JOIN galaxy.attributes AS a ON (dsam.attribute = a.id)"
+        " INNER JOIN `draft_schematics` ON (1)", "galaxy", tables);
+    DatabaseSnapshotWriter::readSourceTables("select x from conversation_option_batches b, conversation_options"
+        " where b.id = conversation_options.id", "other", tables);
+
+    std::set<std::string> expected;
+    expected.insert("galaxy.skills");
+    expected.insert("galaxy.draft_schematic_attribute_manipulation");
+    expected.insert("galaxy.attributes");
+    expected.insert("galaxy.draft_schematics");
+    expected.insert("other.conversation_option_batches");
+    expected.insert("other.conversation_options");
+
+    EXPECT_EQ(expected, tables);
+}
+
+/*! An export records the fingerprint of the tables it read, a snapshot is
+* only served while the database still has the same fingerprint.
+*/
+TEST_F(DatabaseSnapshotTest, SnapshotsOfChangedTablesAreNotLoaded) {
+    exportSnapshot();
+
+    DatabaseImplementationSnapshot snapshot(filename_);
+    ASSERT_TRUE(snapshot.isOpen());
+    ASSERT_EQ(1u, snapshot.getSourceTables().size());
+    EXPECT_EQ("galaxy.skills", snapshot.getSourceTables()[0]);
+
+    {
+        Database database(memory_.getFactory(), config_);
+        EXPECT_TRUE(database.loadStaticSnapshot(filename_));
+    }
+
+    memory_.setResult(kChecksumQuery, 2, cells("galaxy.skills", "5678"));
+
+    Database database(memory_.getFactory(), config_);
+    EXPECT_FALSE(database.loadStaticSnapshot(filename_));
+}
+
+/*! A new export does not carry over the queries of an out of date file.
+*/
+TEST_F(DatabaseSnapshotTest, ExportsDropOutOfDateQueries) {
+    {
+        DatabaseSnapshotWriter writer;
+        writer.addTable("SELECT * FROM galaxy.xp_types", 1, std::vector<std::string>(1, "1"));
+
+        std::vector<std::string> source(1, "galaxy.xp_types");
+        writer.setSource(source, 1);
+        ASSERT_TRUE(writer.write(filename_));
+    }
+
+    exportSnapshot();
+
+    DatabaseImplementationSnapshot snapshot(filename_);
+    ASSERT_TRUE(snapshot.isOpen());
+    EXPECT_EQ(1u, snapshot.getTables().size());
+    EXPECT_EQ(1u, snapshot.getTables().count(kSkillQuery));
+}
+
+}
@@ -0,0 +1,117 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "DatabaseManager/Database.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+#include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+const char kInsertPrefix[] = "INSERT INTO galaxy.items (id,parent_id) VALUES ";
+
+class DatabaseTest : public testing::Test {
+protected:
+    DatabaseTest()
+        : config_(4, 4, "global", "galaxy", "config")
+    {}
+
+    DatabaseImplementationMemory memory_;
+    DatabaseConfig config_;
+};
+
+/*! Rows queued before a worker picks up their statement go out together.
+*/
+TEST_F(DatabaseTest, BatchesInsertRowsWithTheSamePrefix) {
+    Database database(memory_.getFactory(), config_);
+
+    database.executeAsyncInsertRow(kInsertPrefix, "(1,10)");
+    database.executeAsyncInsertRow(kInsertPrefix, "(2,10)");
+    database.executeAsyncInsertRow("INSERT INTO galaxy.waypoints (waypoint_id) VALUES ", "(3)");
+    database.drain();
+
+    std::vector<std::string> queries = memory_.getQueries();
+    ASSERT_EQ(2u, queries.size());
+    EXPECT_EQ(std::string(kInsertPrefix) + "(1,10),(2,10)", queries[0]);
+    EXPECT_EQ("INSERT INTO galaxy.waypoints (waypoint_id) VALUES (3)", queries[1]);
+}
+
+/*! A full statement is closed, the next row starts a new one.
+*/
+TEST_F(DatabaseTest, LimitsTheRowsPerInsert) {
+    Database database(memory_.getFactory(), config_);
+
+    for (uint32_t i = 0; i <= Database::kMaxInsertRows; ++i) {
+        database.executeAsyncInsertRow(kInsertPrefix, "(1,10)");
+    }
+
+    database.drain();
+
+    std::vector<std::string> queries = memory_.getQueries();
+    ASSERT_EQ(2u, queries.size());
+    EXPECT_EQ(std::string(kInsertPrefix) + "(1,10)", queries[1]);
+}
+
+/*! An update queued after a row is not sent before the insert completed,
+* even with idle workers around.
+*/
+TEST_F(DatabaseTest, LaterQueriesWaitForTheInsert) {
+    boost::mutex mutex;
+    bool insert_done = false;
+    bool update_first = false;
+
+    memory_.setHandler([&] (const std::string& sql, uint32_t& columns, std::vector<std::string>& cells) -> bool {
+        // give the update every chance to overtake the insert
+        if (sql.find("INSERT") == 0) {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+        }
+
+        boost::mutex::scoped_lock lock(mutex);
+
+        if (sql.find("INSERT") == 0) {
+            insert_done = true;
+        } else if (!insert_done) {
+            update_first = true;
+        }
+
+        return false;
+    });
+
+    Database database(memory_.getFactory(), config_);
+
+    database.executeAsyncInsertRow(kInsertPrefix, "(1,10)");
+    database.executeAsyncSql("UPDATE galaxy.items SET parent_id=11 WHERE id=1");
+    database.drain();
+
+    EXPECT_TRUE(insert_done);
+    EXPECT_FALSE(update_first);
+}
+
+/*! Draining runs the callbacks of the queued queries and whatever they queue
+* in turn before returning.
+*/
+TEST_F(DatabaseTest, DrainRunsQueuedQueriesAndTheirCallbacks) {
+    Database database(memory_.getFactory(), config_);
+    bool done = false;
+
+    database.executeAsyncSql("SELECT 1", [&] (DatabaseResult*) {
+        database.executeAsyncSql("SELECT 2", [&] (DatabaseResult*) {
+            done = true;
+        });
+    });
+
+    database.drain();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(2u, memory_.getQueries().size());
+}
+
+}
@@ -0,0 +1,208 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "DatabaseManager/DatabaseWorldImage.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+#include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseCallback.h"
+#include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+#include "DatabaseManager/DatabaseResult.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+const char kContainerQuery[] = "SELECT id FROM items WHERE parent_id=1";
+
+std::string tempPath(const char* name) {
+    static int count = 0;
+
+    std::stringstream path;
+    path << "/tmp/anh_" << name << "_" << getpid() << "_" << ++count;
+    return path.str();
+}
+
+bool exists(const std::string& filename) {
+    return std::ifstream(filename.c_str()).good();
+}
+
+std::vector<std::string> cells(const char* first, const char* second) {
+    std::vector<std::string> result;
+    result.push_back(first);
+    result.push_back(second);
+    return result;
+}
+
+/*! Loads the children of one container through the old callback interface,
+* the way the object factories do.
+*/
+class ContainerLoader : public DatabaseCallback {
+public:
+    ContainerLoader() : done_(false) {}
+
+    void handleDatabaseJobComplete(void* ref, DatabaseResult* result) {
+        DataBinding binding(1);
+        binding.addField(DFT_uint64, 0, 8);
+
+        for (uint64_t i = 0, count = result->getRowCount(); i < count; ++i) {
+            uint64_t id = 0;
+            result->getNextRow(&binding, &id);
+            ids_.push_back(id);
+        }
+
+        done_ = true;
+    }
+
+    std::vector<uint64_t> ids_;
+    bool done_;
+};
+
+class DatabaseWorldImageTest : public testing::Test {
+protected:
+    DatabaseWorldImageTest()
+        : config_(1, 1, "global", "galaxy", "config")
+        , filename_(tempPath("world_image"))
+    {
+        memory_.setResult(kContainerQuery, 1, cells("10", "11"));
+    }
+
+    ~DatabaseWorldImageTest() {
+        std::remove(filename_.c_str());
+    }
+
+    bool processUntil(Database& database, const bool& done) {
+        for (int i = 0; i < 2000 && !done; ++i) {
+            database.process();
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+
+        return done;
+    }
+
+    std::vector<uint64_t> loadWorld(Database& database) {
+        ContainerLoader loader;
+        database.executeSqlAsync(&loader, nullptr, kContainerQuery);
+
+        EXPECT_TRUE(processUntil(database, loader.done_));
+        return loader.ids_;
+    }
+
+    /*! Ends the load and returns whether the world may go online.
+    */
+    bool finishLoad(Database& database) {
+        bool done = false;
+        bool valid = false;
+
+        database.finishWorldImageLoad([&] (bool is_valid) { valid = is_valid; done = true; });
+
+        EXPECT_TRUE(processUntil(database, done));
+        return valid;
+    }
+
+    size_t queriesSent() const {
+        return memory_.getQueries().size();
+    }
+
+    void coldBoot() {
+        Database database(memory_.getFactory(), config_);
+
+        ASSERT_FALSE(database.startWorldImage(filename_, true));
+        loadWorld(database);
+        ASSERT_TRUE(finishLoad(database));
+
+        // the image is written in the background, destroying the database waits for it
+    }
+
+    DatabaseImplementationMemory memory_;
+    DatabaseConfig config_;
+    std::string filename_;
+};
+
+/*! A warm boot serves the rows a cold boot captured without sending the 
+* queries, then validates them against the database before going online.
+*/
+TEST_F(DatabaseWorldImageTest, WarmBootServesTheCapturedRows) {
+    coldBoot();
+    ASSERT_TRUE(exists(filename_));
+
+    Database database(memory_.getFactory(), config_);
+    ASSERT_TRUE(database.startWorldImage(filename_, true));
+
+    size_t sent = queriesSent();
+    std::vector<uint64_t> ids = loadWorld(database);
+
+    ASSERT_EQ(2u, ids.size());
+    EXPECT_EQ(10u, ids[0]);
+    EXPECT_EQ(11u, ids[1]);
+    EXPECT_EQ(sent, queriesSent());
+
+    EXPECT_TRUE(finishLoad(database));
+    EXPECT_EQ(sent + 1, queriesSent());
+}
+
+/*! An item moved into the container after the image was written makes the
+* validation fail, the image is deleted so the next boot is a cold one.
+*/
+TEST_F(DatabaseWorldImageTest, StaleImageAbortsTheWarmBoot) {
+    coldBoot();
+    memory_.setResult(kContainerQuery, 1, cells("10", "12"));
+
+    Database database(memory_.getFactory(), config_);
+    ASSERT_TRUE(database.startWorldImage(filename_, true));
+    loadWorld(database);
+
+    EXPECT_FALSE(finishLoad(database));
+    EXPECT_FALSE(exists(filename_));
+
+    // nothing built from the stale rows is ever written back
+    database.writeWorldImage();
+    EXPECT_FALSE(exists(filename_));
+}
+
+/*! The image written on shutdown holds the rows as they are at that point,
+* the next warm boot serves and validates those.
+*/
+TEST_F(DatabaseWorldImageTest, ShutdownWritesTheCurrentRows) {
+    {
+        Database database(memory_.getFactory(), config_);
+        ASSERT_FALSE(database.startWorldImage(filename_, true));
+        loadWorld(database);
+        ASSERT_TRUE(finishLoad(database));
+
+        memory_.setResult(kContainerQuery, 1, cells("10", "12"));
+        database.writeWorldImage();
+    }
+
+    Database database(memory_.getFactory(), config_);
+    ASSERT_TRUE(database.startWorldImage(filename_, true));
+
+    std::vector<uint64_t> ids = loadWorld(database);
+    ASSERT_EQ(2u, ids.size());
+    EXPECT_EQ(12u, ids[1]);
+
+    EXPECT_TRUE(finishLoad(database));
+}
+
+/*! Queries that may change data are never served from an image.
+*/
+TEST(DatabaseWorldImageQueryTests, OnlyPlainReadsAreWorldQueries) {
+    EXPECT_TRUE(DatabaseWorldImage::isWorldQuery("SELECT id FROM items"));
+    EXPECT_TRUE(DatabaseWorldImage::isWorldQuery(" (select id FROM items)"));
+    EXPECT_FALSE(DatabaseWorldImage::isWorldQuery("UPDATE items SET parent_id=1"));
+    EXPECT_FALSE(DatabaseWorldImage::isWorldQuery("SELECT sf_DefaultHarvesterUpdateDeed(1)"));
+}
+
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "DatabaseManager/QueryChain.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+#include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+#include "DatabaseManager/DatabaseResult.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+class QueryChainTest : public testing::Test {
+protected:
+    QueryChainTest()
+        : config_(1, 1, "global", "galaxy", "config")
+        , database_(memory_.getFactory(), config_)
+    {}
+
+    // Callbacks only run from process(), pump it like a main loop would.
+    bool processUntil(const bool& done) {
+        for (int i = 0; i < 2000 && !done; ++i) {
+            database_.process();
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+
+        return done;
+    }
+
+    DatabaseImplementationMemory memory_;
+    DatabaseConfig config_;
+    Database database_;
+};
+
+/*! A step is only sent once the previous one completed, so its sql can be
+* built from the earlier results (read-then-update).
+*/
+TEST_F(QueryChainTest, BuildsLaterStepsFromEarlierResults) {
+    memory_.setResult("SELECT credits FROM banks WHERE id=1", 1, std::vector<std::string>(1, "500"));
+
+    uint32_t credits = 0;
+    bool done = false;
+
+    DataBinding* binding = database_.createDataBinding(1);
+    binding->addField(DFT_uint32, 0, 4);
+
+    QueryChain::create(&database_)
+        ->then("SELECT credits FROM banks WHERE id=1", [&] (DatabaseResult* result) {
+            result->getNextRow(binding, &credits);
+            return true;
+        })
+        .thenBuild([&] () {
+            std::stringstream sql;
+            sql << "UPDATE banks SET credits=" << credits - 100 << " WHERE id=1";
+            return sql.str();
+        })
+        .finally([&] () { done = true; })
+        .execute();
+
+    ASSERT_TRUE(processUntil(done));
+    database_.destroyDataBinding(binding);
+
+    std::vector<std::string> queries = memory_.getQueries();
+    ASSERT_EQ(2u, queries.size());
+    EXPECT_EQ("SELECT credits FROM banks WHERE id=1", queries[0]);
+    EXPECT_EQ("UPDATE banks SET credits=400 WHERE id=1", queries[1]);
+}
+
+/*! A step returning false ends the chain, the remaining steps are never sent
+* but the finally handler still runs.
+*/
+TEST_F(QueryChainTest, StepReturningFalseEndsTheChain) {
+    bool done = false;
+
+    QueryChain::create(&database_)
+        ->then("SELECT id FROM items WHERE id=7", [] (DatabaseResult* result) {
+            return result->getRowCount() != 0;
+        })
+        .then("DELETE FROM items WHERE id=7")
+        .finally([&] () { done = true; })
+        .execute();
+
+    ASSERT_TRUE(processUntil(done));
+
+    std::vector<std::string> queries = memory_.getQueries();
+    ASSERT_EQ(1u, queries.size());
+    EXPECT_EQ("SELECT id FROM items WHERE id=7", queries[0]);
+}
+
+/*! A builder returning an empty string skips its step.
+*/
+TEST_F(QueryChainTest, EmptyBuilderSkipsTheStep) {
+    bool done = false;
+
+    QueryChain::create(&database_)
+        ->then("UPDATE a SET b=1")
+        .thenBuild([] () { return std::string(); })
+        .then("UPDATE a SET b=2")
+        .finally([&] () { done = true; })
+        .execute();
+
+    ASSERT_TRUE(processUntil(done));
+
+    std::vector<std::string> queries = memory_.getQueries();
+    ASSERT_EQ(2u, queries.size());
+    EXPECT_EQ("UPDATE a SET b=1", queries[0]);
+    EXPECT_EQ("UPDATE a SET b=2", queries[1]);
+}
+
+/*! The chain keeps itself alive while queries are in flight, the caller does
+* not have to hold on to it after execute().
+*/
+TEST_F(QueryChainTest, KeepsItselfAliveUntilFinished) {
+    bool done = false;
+    std::weak_ptr<QueryChain> weak;
+
+    {
+        std::shared_ptr<QueryChain> chain = QueryChain::create(&database_);
+        weak = chain;
+
+        chain->then("UPDATE a SET b=1").then("UPDATE a SET b=2").finally([&] () { done = true; });
+        chain->execute();
+    }
+
+    EXPECT_FALSE(weak.expired());
+    ASSERT_TRUE(processUntil(done));
+    EXPECT_TRUE(weak.expired());
+}
+
+/*! An empty chain finishes right away.
+*/
+TEST_F(QueryChainTest, EmptyChainFinishesImmediately) {
+    bool done = false;
+
+    QueryChain::create(&database_)->finally([&] () { done = true; }).execute();
+
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(memory_.getQueries().empty());
+}
+
+}
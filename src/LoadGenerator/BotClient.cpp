@@ -0,0 +1,525 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "LoadGenerator/BotClient.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// Fix for issues with glog redefining this constant
+#ifdef ERROR
+#undef ERROR
+#endif
+#include <glog/logging.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "LoadGenerator/LatencyStats.h"
+
+#include "NetworkManager/Message.h"
+#include "NetworkManager/MessageFactory.h"
+#include "NetworkManager/MessageOpcodes.h"
+#include "NetworkManager/Service.h"
+#include "NetworkManager/Session.h"
+
+#include "ZoneServer/ObjectControllerOpcodes.h"
+#include "ZoneServer/ZoneOpcodes.h"
+
+#include "Utils/bstring.h"
+
+namespace {
+
+// The version string the live client sends with opLoginClientId.
+const char* kClientVersion = "20050408-18:00";
+
+// Limit for the remembered attack targets so a busy zone doesn't grow us unbounded.
+const size_t kMaxTargets = 64;
+
+uint64 MicrosecondsNow()
+{
+    static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds();
+}
+
+}
+
+//======================================================================================================================
+
+BotClient::BotClient(uint32 index, Service* service, const std::string& username, const std::string& password,
+                     const BotScript& script, LatencyStats* stats)
+    : mLoginLink(this, BOTLINK_Login)
+    , mConnectionLink(this, BOTLINK_Connection)
+    , mScript(script)
+    , mUsername(username)
+    , mPassword(password)
+    , mService(service)
+    , mStats(stats)
+    , mCharacterId(0)
+    , mNextMove(0)
+    , mNextChat(0)
+    , mNextAttack(0)
+    , mPosX(0.0f)
+    , mPosY(0.0f)
+    , mPosZ(0.0f)
+    , mHeading(0.0f)
+    , mIndex(index)
+    , mAccountId(0)
+    , mMoveCount(0)
+    , mCommandSequence(0)
+    , mConnectTimeout(0)
+    , mConnectionPort(0)
+    , mState(BOTSTATE_Idle)
+{
+}
+
+//======================================================================================================================
+
+BotClient::~BotClient()
+{
+}
+
+//======================================================================================================================
+
+void BotClient::Stop()
+{
+    mState = BOTSTATE_Stopped;
+
+    if(mConnectionLink.getSession())
+    {
+        mConnectionLink.Disconnect(0);
+    }
+
+    if(mLoginLink.getSession())
+    {
+        mLoginLink.Disconnect(0);
+    }
+}
+
+//======================================================================================================================
+
+void BotClient::Start(const std::string& loginAddress, uint16 loginPort,
+                      const std::string& connectionAddress, uint16 connectionPort, uint32 connectTimeout)
+{
+    mConnectionAddress  = connectionAddress;
+    mConnectionPort     = connectionPort;
+    mConnectTimeout     = connectTimeout;
+
+    _startTimer("connect");
+    mService->ConnectAsync(&mLoginLink, loginAddress.c_str(), loginPort, mConnectTimeout);
+
+    mState = BOTSTATE_Connecting;
+}
+
+//======================================================================================================================
+
+void BotClient::Process(uint64 now)
+{
+    if(mState != BOTSTATE_InWorld)
+    {
+        return;
+    }
+
+    if(now >= mNextMove)
+    {
+        mNextMove = now + mScript.mMoveInterval;
+        _sendMove();
+    }
+
+    if(mScript.mChatInterval && now >= mNextChat)
+    {
+        mNextChat = now + mScript.mChatInterval;
+        _sendChat();
+    }
+
+    if(mScript.mAttackInterval && now >= mNextAttack)
+    {
+        mNextAttack = now + mScript.mAttackInterval;
+        _sendAttack();
+    }
+}
+
+//======================================================================================================================
+
+void BotClient::handleConnect(BotLink* link)
+{
+    // stopped or failed while the connect was under way
+    if(mState == BOTSTATE_Stopped || mState == BOTSTATE_Failed)
+    {
+        link->Disconnect(0);
+        return;
+    }
+
+    if(link->getType() == BOTLINK_Login)
+    {
+        _stopTimer("connect");
+
+        gMessageFactory->StartMessage();
+        gMessageFactory->addUint32(opLoginClientId);
+        gMessageFactory->addString(mUsername.c_str());
+        gMessageFactory->addString(mPassword.c_str());
+        gMessageFactory->addString(kClientVersion);
+
+        _startTimer("login");
+        _send(mLoginLink, gMessageFactory->EndMessage(), 4);
+
+        mState = BOTSTATE_LoginSent;
+        return;
+    }
+
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opClientIdMsg);
+    gMessageFactory->addUint32(0);
+    gMessageFactory->addUint32(static_cast<uint32>(mSessionToken.size()) + 4);
+    gMessageFactory->addData(&mSessionToken[0], static_cast<uint16>(mSessionToken.size()));
+    gMessageFactory->addUint32(mAccountId);
+
+    _startTimer("cluster-auth");
+    _send(mConnectionLink, gMessageFactory->EndMessage(), 4);
+
+    mState = BOTSTATE_ClientIdSent;
+}
+
+//======================================================================================================================
+
+void BotClient::handleMessage(BotLink* link, Message* message)
+{
+    uint32 opcode = message->getUint32();
+
+    switch(opcode)
+    {
+    case opLoginClientToken:
+        _handleLoginClientToken(message);
+        break;
+
+    case opEnumerateCharacterId:
+        _handleEnumerateCharacterId(message);
+        break;
+
+    case opClientPermissionsMessage:
+        _handleClientPermissions(message);
+        break;
+
+    case opCmdStartScene:
+        _handleCmdStartScene(message);
+        break;
+
+    case opSceneCreateObjectByCrc:
+        _handleSceneCreateObject(message);
+        break;
+
+    case opObjControllerMessage:
+        _handleObjController(message);
+        break;
+
+    case opErrorMessage:
+    {
+        // The loginserver reports queue positions as error messages titled "Login Queue" while
+        // we wait for authentication, those are progress and not a failure.
+        BString errType;
+        message->getStringAnsi(errType);
+
+        if(mState < BOTSTATE_CharacterList && strcmp(errType.getAnsi(), "Login Queue") == 0)
+        {
+            break;
+        }
+
+        _fail("server sent opErrorMessage");
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+//======================================================================================================================
+
+void BotClient::handleDisconnect(BotLink* link)
+{
+    link->setSession(0);
+
+    if(mState == BOTSTATE_Stopped)
+    {
+        return;
+    }
+
+    // Dropping the login link is part of the normal handover.
+    if(link->getType() == BOTLINK_Connection || mState < BOTSTATE_ClientIdSent)
+    {
+        _fail("session disconnected");
+    }
+}
+
+//======================================================================================================================
+
+void BotClient::_handleLoginClientToken(Message* message)
+{
+    // The token is opaque to us. The ConnectionServer only reads the account id
+    // that trails it, so keep the whole blob and replay it verbatim.
+    uint32 dataSize = message->getUint32();
+
+    if(dataSize < 4)
+    {
+        _fail("malformed opLoginClientToken");
+        return;
+    }
+
+    mSessionToken.assign(message->getData() + message->getIndex(),
+                         message->getData() + message->getIndex() + dataSize - 4);
+    message->setIndex(message->getIndex() + static_cast<uint16>(dataSize - 4));
+
+    mAccountId = message->getUint32();
+
+    _stopTimer("login");
+    mState = BOTSTATE_CharacterList;
+}
+
+//======================================================================================================================
+
+void BotClient::_handleEnumerateCharacterId(Message* message)
+{
+    uint32 count = message->getUint32();
+
+    if(!count)
+    {
+        _fail("account has no characters, load the fixture first");
+        return;
+    }
+
+    BString name;
+    message->getStringUnicode16(name);
+    message->getUint32();                   // base model crc
+    mCharacterId = message->getUint64();
+
+    // Hand over to the cluster, the client id goes out once the session is
+    // accepted. The login link stays open until the ConnectionServer has
+    // accepted us, otherwise the LoginServer clears account_authenticated
+    // underneath the handover.
+    mService->ConnectAsync(&mConnectionLink, mConnectionAddress.c_str(), mConnectionPort, mConnectTimeout);
+}
+
+//======================================================================================================================
+
+void BotClient::_handleClientPermissions(Message* message)
+{
+    _stopTimer("cluster-auth");
+
+    mLoginLink.Disconnect(0);
+
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opSelectCharacter);
+    gMessageFactory->addUint64(mCharacterId);
+
+    _startTimer("zone-in");
+    _send(mConnectionLink, gMessageFactory->EndMessage(), 4);
+
+    mState = BOTSTATE_SelectSent;
+}
+
+//======================================================================================================================
+
+void BotClient::_handleCmdStartScene(Message* message)
+{
+    BString terrain;
+
+    message->getUint8();
+    mCharacterId = message->getUint64();
+    message->getStringAnsi(terrain);
+    mPosX = message->getFloat();
+    mPosY = message->getFloat();
+    mPosZ = message->getFloat();
+
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opCmdSceneReady);
+    _send(mConnectionLink, gMessageFactory->EndMessage(), 4);
+
+    _stopTimer("zone-in");
+
+    // spread the bots out so they don't all act on the same tick
+    mNextMove   = 0;
+    mNextChat   = mScript.mChatInterval ? (mIndex * 97) % mScript.mChatInterval : 0;
+    mNextAttack = mScript.mAttackInterval ? (mIndex * 193) % mScript.mAttackInterval : 0;
+
+    mState = BOTSTATE_InWorld;
+}
+
+//======================================================================================================================
+
+void BotClient::_handleSceneCreateObject(Message* message)
+{
+    uint64 objectId = message->getUint64();
+
+    if(objectId != mCharacterId && mTargets.size() < kMaxTargets)
+    {
+        mTargets.push_back(objectId);
+    }
+}
+
+//======================================================================================================================
+
+void BotClient::_handleObjController(Message* message)
+{
+    message->getUint32();
+    uint32 subOpcode = message->getUint32();
+
+    if(subOpcode != opCommandQueueRemove)
+    {
+        return;
+    }
+
+    message->getUint64();                   // our object id
+    message->getUint32();
+    uint32 sequence = message->getUint32();
+
+    SequenceMap::iterator it = mPendingCommands.find(sequence);
+
+    if(it != mPendingCommands.end())
+    {
+        mStats->Record("command", MicrosecondsNow() - it->second);
+        mPendingCommands.erase(it);
+    }
+}
+
+//======================================================================================================================
+
+void BotClient::_sendMove()
+{
+    // wander on a small circle around the spawn point
+    mHeading += 0.2f;
+    mPosX += std::cos(mHeading) * 2.0f;
+    mPosZ += std::sin(mHeading) * 2.0f;
+
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opObjControllerMessage);
+    gMessageFactory->addUint32(0x00000023);
+    gMessageFactory->addUint32(opDataTransform);
+    gMessageFactory->addUint64(mCharacterId);
+    gMessageFactory->addUint32(static_cast<uint32>(MicrosecondsNow() / 1000));
+    gMessageFactory->addUint32(++mMoveCount);
+    gMessageFactory->addFloat(0.0f);
+    gMessageFactory->addFloat(std::sin(mHeading / 2.0f));
+    gMessageFactory->addFloat(0.0f);
+    gMessageFactory->addFloat(std::cos(mHeading / 2.0f));
+    gMessageFactory->addFloat(mPosX);
+    gMessageFactory->addFloat(mPosY);
+    gMessageFactory->addFloat(mPosZ);
+    gMessageFactory->addFloat(2.0f);
+
+    _send(mConnectionLink, gMessageFactory->EndMessage(), 5);
+}
+
+//======================================================================================================================
+
+void BotClient::_sendChat()
+{
+    std::wostringstream text;
+    text << L"0 0 0 0 0 load bot " << mIndex << L" checking in";
+
+    _sendCommand(opOCspatialchatinternal, 0, text.str());
+}
+
+//======================================================================================================================
+
+void BotClient::_sendAttack()
+{
+    if(mTargets.empty())
+    {
+        return;
+    }
+
+    _sendCommand(opOCattack, mTargets[std::rand() % mTargets.size()], L"");
+}
+
+//======================================================================================================================
+
+void BotClient::_sendCommand(uint32 command, uint64 targetId, const std::wstring& arguments)
+{
+    uint32 sequence = ++mCommandSequence;
+
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opObjControllerMessage);
+    gMessageFactory->addUint32(0x00000023);
+    gMessageFactory->addUint32(opCommandQueueEnqueue);
+    gMessageFactory->addUint64(mCharacterId);
+    gMessageFactory->addUint32(0);
+    gMessageFactory->addUint32(sequence);
+    gMessageFactory->addUint32(command);
+    gMessageFactory->addUint64(targetId);
+    gMessageFactory->addString(arguments);
+
+    mPendingCommands[sequence] = MicrosecondsNow();
+    _send(mConnectionLink, gMessageFactory->EndMessage(), 5);
+}
+
+//======================================================================================================================
+
+void BotClient::_send(BotLink& link, Message* message, uint8 priority)
+{
+    if(!link.getSession())
+    {
+        gMessageFactory->DestroyMessage(message);
+        return;
+    }
+
+    link.SendChannelA(message, priority, false);
+}
+
+//======================================================================================================================
+
+void BotClient::_startTimer(const std::string& metric)
+{
+    mTimers[metric] = MicrosecondsNow();
+}
+
+//======================================================================================================================
+
+void BotClient::_stopTimer(const std::string& metric)
+{
+    TimerMap::iterator it = mTimers.find(metric);
+
+    if(it != mTimers.end())
+    {
+        mStats->Record(metric, MicrosecondsNow() - it->second);
+        mTimers.erase(it);
+    }
+}
+
+//======================================================================================================================
+
+void BotClient::_fail(const char* reason)
+{
+    if(mState == BOTSTATE_Failed || mState == BOTSTATE_Stopped)
+    {
+        return;
+    }
+
+    LOG(WARNING) << "Bot " << mUsername << " failed: " << reason;
+    mState = BOTSTATE_Failed;
+}
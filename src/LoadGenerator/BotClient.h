@@ -0,0 +1,189 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_LOADGENERATOR_BOTCLIENT_H
+#define ANH_LOADGENERATOR_BOTCLIENT_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "NetworkManager/NetworkClient.h"
+#include "Utils/typedefs.h"
+
+class BotClient;
+class LatencyStats;
+class Message;
+class Service;
+
+//======================================================================================================================
+
+enum BotState
+{
+    BOTSTATE_Idle,
+    BOTSTATE_Connecting,
+    BOTSTATE_LoginSent,
+    BOTSTATE_CharacterList,
+    BOTSTATE_ClientIdSent,
+    BOTSTATE_SelectSent,
+    BOTSTATE_InWorld,
+    BOTSTATE_Failed,
+    BOTSTATE_Stopped
+};
+
+enum BotLinkType
+{
+    BOTLINK_Login,
+    BOTLINK_Connection
+};
+
+//======================================================================================================================
+
+/*! \brief One of the two SOE sessions a bot holds.
+ *
+ * A bot talks to the LoginServer and the ConnectionServer at the same time
+ * during the handover, so each session gets its own NetworkClient that
+ * forwards to the owning bot.
+ */
+class BotLink : public NetworkClient
+{
+public:
+    BotLink(BotClient* owner, BotLinkType type) : mOwner(owner), mType(type) {}
+
+    BotClient*  getOwner() {
+        return mOwner;
+    }
+    BotLinkType getType() {
+        return mType;
+    }
+
+private:
+    BotClient*  mOwner;
+    BotLinkType mType;
+};
+
+//======================================================================================================================
+
+/*! \brief Timing knobs for the scripted in-world behaviour. All values in ms. */
+struct BotScript
+{
+    uint32 mMoveInterval;
+    uint32 mChatInterval;
+    uint32 mAttackInterval;
+};
+
+//======================================================================================================================
+
+/*! \brief A scripted headless game client.
+ *
+ * Walks through the same message sequence as the real client: login
+ * (opLoginClientId), cluster handover (opClientIdMsg), character select and
+ * zone-in (opSelectCharacter / opCmdSceneReady), then loops moving, chatting
+ * and attacking whatever the zone streamed to it. Every request/response pair
+ * is timed into the shared LatencyStats.
+ */
+class BotClient
+{
+public:
+    BotClient(uint32 index, Service* service, const std::string& username, const std::string& password,
+              const BotScript& script, LatencyStats* stats);
+    ~BotClient();
+
+    /*! Starts connecting the login session, the credentials go out once it is
+     * accepted. Either session fails the bot when it isn't accepted within
+     * connectTimeout ms.
+     */
+    void    Start(const std::string& loginAddress, uint16 loginPort,
+                  const std::string& connectionAddress, uint16 connectionPort, uint32 connectTimeout);
+
+    /*! Disconnects both sessions. The bot must outlive the resulting disconnect callbacks. */
+    void    Stop();
+
+    /*! Runs the scripted behaviour that is due at the given time (ms). */
+    void    Process(uint64 now);
+
+    void    handleConnect(BotLink* link);
+    void    handleMessage(BotLink* link, Message* message);
+    void    handleDisconnect(BotLink* link);
+
+    BotState getState() const {
+        return mState;
+    }
+
+private:
+    void    _handleLoginClientToken(Message* message);
+    void    _handleEnumerateCharacterId(Message* message);
+    void    _handleClientPermissions(Message* message);
+    void    _handleCmdStartScene(Message* message);
+    void    _handleSceneCreateObject(Message* message);
+    void    _handleObjController(Message* message);
+
+    void    _sendMove();
+    void    _sendChat();
+    void    _sendAttack();
+    void    _sendCommand(uint32 command, uint64 targetId, const std::wstring& arguments);
+
+    void    _send(BotLink& link, Message* message, uint8 priority);
+    void    _startTimer(const std::string& metric);
+    void    _stopTimer(const std::string& metric);
+    void    _fail(const char* reason);
+
+    typedef std::map<std::string, uint64>  TimerMap;
+    typedef std::map<uint32, uint64>       SequenceMap;
+
+    BotLink                 mLoginLink;
+    BotLink                 mConnectionLink;
+    BotScript               mScript;
+    TimerMap                mTimers;
+    SequenceMap             mPendingCommands;
+    std::vector<uint64>     mTargets;
+    std::vector<uint8>      mSessionToken;
+    std::string             mUsername;
+    std::string             mPassword;
+    std::string             mConnectionAddress;
+    Service*                mService;
+    LatencyStats*           mStats;
+    uint64                  mCharacterId;
+    uint64                  mNextMove;
+    uint64                  mNextChat;
+    uint64                  mNextAttack;
+    float                   mPosX;
+    float                   mPosY;
+    float                   mPosZ;
+    float                   mHeading;
+    uint32                  mIndex;
+    uint32                  mAccountId;
+    uint32                  mMoveCount;
+    uint32                  mCommandSequence;
+    uint32                  mConnectTimeout;
+    uint16                  mConnectionPort;
+    BotState                mState;
+};
+
+#endif // ANH_LOADGENERATOR_BOTCLIENT_H
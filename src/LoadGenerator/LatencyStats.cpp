@@ -0,0 +1,90 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "LoadGenerator/LatencyStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+void LatencyStats::Record(const std::string& metric, uint64_t microseconds)
+{
+    samples_[metric].push_back(microseconds);
+}
+
+size_t LatencyStats::Count(const std::string& metric) const
+{
+    SampleMap::const_iterator it = samples_.find(metric);
+    return (it == samples_.end()) ? 0 : it->second.size();
+}
+
+uint64_t LatencyStats::Percentile(const std::string& metric, double percentile) const
+{
+    SampleMap::const_iterator it = samples_.find(metric);
+    if (it == samples_.end() || it->second.empty()) {
+        return 0;
+    }
+
+    std::vector<uint64_t> sorted(it->second);
+    std::sort(sorted.begin(), sorted.end());
+
+    percentile = std::max(0.0, std::min(100.0, percentile));
+
+    // nearest-rank: the smallest sample with at least percentile% of samples <= it
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+    if (rank > 0) {
+        --rank;
+    }
+
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void LatencyStats::Report(std::ostream& out) const
+{
+    out << std::left << std::setw(16) << "metric"
+        << std::right << std::setw(10) << "count"
+        << std::setw(12) << "p50(ms)"
+        << std::setw(12) << "p90(ms)"
+        << std::setw(12) << "p99(ms)"
+        << std::setw(12) << "max(ms)" << "\n";
+
+    std::for_each(samples_.begin(), samples_.end(), [this, &out] (const SampleMap::value_type& entry) {
+        out << std::left << std::setw(16) << entry.first
+            << std::right << std::setw(10) << entry.second.size()
+            << std::fixed << std::setprecision(2)
+            << std::setw(12) << Percentile(entry.first, 50.0) / 1000.0
+            << std::setw(12) << Percentile(entry.first, 90.0) / 1000.0
+            << std::setw(12) << Percentile(entry.first, 99.0) / 1000.0
+            << std::setw(12) << Percentile(entry.first, 100.0) / 1000.0 << "\n";
+    });
+}
+
+void LatencyStats::Clear()
+{
+    samples_.clear();
+}
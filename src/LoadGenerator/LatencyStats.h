@@ -0,0 +1,77 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_LOADGENERATOR_LATENCYSTATS_H
+#define ANH_LOADGENERATOR_LATENCYSTATS_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*! \brief Collects latency samples for named client operations.
+ *
+ * Samples are stored raw (in microseconds) so that exact percentiles can be
+ * computed at report time. A load run records at most a few samples per bot
+ * per second, which keeps the memory cost negligible.
+ */
+class LatencyStats
+{
+public:
+    /*! Adds a sample for the given metric.
+     *
+     * \param metric Name of the measured operation (e.g. "login", "zone-in").
+     * \param microseconds The measured round trip.
+     */
+    void Record(const std::string& metric, uint64_t microseconds);
+
+    /*! \returns The number of samples recorded for a metric. */
+    size_t Count(const std::string& metric) const;
+
+    /*! Returns the sample at the given percentile using the nearest-rank method.
+     *
+     * \param metric Name of the measured operation.
+     * \param percentile Value in the range [0, 100].
+     * \returns The percentile in microseconds, or 0 if no samples were recorded.
+     */
+    uint64_t Percentile(const std::string& metric, double percentile) const;
+
+    /*! Writes a p50/p90/p99/max table of every metric to the stream. */
+    void Report(std::ostream& out) const;
+
+    /*! Discards all samples. */
+    void Clear();
+
+private:
+    typedef std::map<std::string, std::vector<uint64_t>> SampleMap;
+
+    SampleMap samples_;
+};
+
+#endif // ANH_LOADGENERATOR_LATENCYSTATS_H
@@ -0,0 +1,342 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "LoadGenerator/LoadGenerator.h"
+
+// Fix for issues with glog redefining this constant
+#ifdef ERROR
+#undef ERROR
+#endif
+#include <glog/logging.h>
+
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+
+#include <boost/thread/thread.hpp>
+
+#include "Common/BuildInfo.h"
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseManager.h"
+#include "DatabaseManager/DataBinding.h"
+
+#include "NetworkManager/Message.h"
+#include "NetworkManager/MessageFactory.h"
+#include "NetworkManager/NetworkManager.h"
+#include "NetworkManager/Service.h"
+#include "NetworkManager/Session.h"
+
+#include "Utils/clock.h"
+
+namespace {
+
+// how often the server counters are read back, keep it at or below the CounterInterval of the servers
+const uint64 kCounterPollInterval = 5000;
+
+}
+
+//======================================================================================================================
+LoadGenerator::LoadGenerator(int argc, char* argv[])
+    : BaseServer()
+    , mNetworkManager(0)
+    , mDatabaseManager(0)
+    , mDatabase(0)
+    , mCounterBinding(0)
+    , mService(0)
+    , mLastCounterPoll(0)
+    , mCounterPollPending(false)
+{
+    Anh_Utils::Clock::Init();
+    LOG(WARNING) << "Load Generator Startup";
+
+    configuration_options_description_.add_options()
+    ("LoginAddress", boost::program_options::value<std::string>()->default_value("127.0.0.1"), "Address of the LoginServer.")
+    ("LoginPort", boost::program_options::value<uint16_t>()->default_value(44990), "Port of the LoginServer.")
+    ("ConnectionAddress", boost::program_options::value<std::string>()->default_value("127.0.0.1"), "Address of the ConnectionServer client service.")
+    ("ConnectionPort", boost::program_options::value<uint16_t>()->default_value(44991), "Port of the ConnectionServer client service.")
+    ("ConnectTimeout", boost::program_options::value<uint32_t>()->default_value(10), "Seconds a bot waits for a session to be accepted before it fails.")
+    ("BotCount", boost::program_options::value<uint32_t>()->default_value(100), "Number of bots to run.")
+    ("BotRampPerSecond", boost::program_options::value<uint32_t>()->default_value(20), "Number of bots started per second.")
+    ("BotAccountPrefix", boost::program_options::value<std::string>()->default_value("loadbot"), "Bot accounts are named <prefix><index>, see tools/loadgen/loadgen_fixture.sql.")
+    ("BotPassword", boost::program_options::value<std::string>()->default_value("loadbot"), "Password shared by all bot accounts.")
+    ("BotMoveInterval", boost::program_options::value<uint32_t>()->default_value(500), "Milliseconds between movement updates.")
+    ("BotChatInterval", boost::program_options::value<uint32_t>()->default_value(10000), "Milliseconds between spatial chat messages, 0 disables chat.")
+    ("BotAttackInterval", boost::program_options::value<uint32_t>()->default_value(3000), "Milliseconds between attack commands, 0 disables combat.")
+    ("RunDuration", boost::program_options::value<uint32_t>()->default_value(300), "Seconds to run before the final report.")
+    ("ReportInterval", boost::program_options::value<uint32_t>()->default_value(30), "Seconds between intermediate reports.")
+    ;
+
+    // Load Configuration Options
+    std::list<std::string> config_files;
+    config_files.push_back("config/general.cfg");
+    config_files.push_back("config/loadgenerator.cfg");
+    LoadOptions_(argc, argv, config_files);
+
+    mBotCount                   = configuration_variables_map_["BotCount"].as<uint32_t>();
+    mRampPerSecond              = std::max<uint32_t>(1, configuration_variables_map_["BotRampPerSecond"].as<uint32_t>());
+    mRunDuration                = configuration_variables_map_["RunDuration"].as<uint32_t>() * 1000;
+    mReportInterval             = configuration_variables_map_["ReportInterval"].as<uint32_t>() * 1000;
+    mConnectTimeout             = configuration_variables_map_["ConnectTimeout"].as<uint32_t>() * 1000;
+    mScript.mMoveInterval       = configuration_variables_map_["BotMoveInterval"].as<uint32_t>();
+    mScript.mChatInterval       = configuration_variables_map_["BotChatInterval"].as<uint32_t>();
+    mScript.mAttackInterval     = configuration_variables_map_["BotAttackInterval"].as<uint32_t>();
+
+    MessageFactory::getSingleton(configuration_variables_map_["GlobalMessageHeap"].as<uint32_t>());
+
+    mNetworkManager = new NetworkManager( NetworkConfig(configuration_variables_map_["ReliablePacketSizeServerToServer"].as<uint16_t>(),
+        configuration_variables_map_["UnreliablePacketSizeServerToServer"].as<uint16_t>(),
+        configuration_variables_map_["ReliablePacketSizeServerToClient"].as<uint16_t>(),
+        configuration_variables_map_["UnreliablePacketSizeServerToClient"].as<uint16_t>(),
+        configuration_variables_map_["ServerPacketWindowSize"].as<uint32_t>(),
+        configuration_variables_map_["ClientPacketWindowSize"].as<uint32_t>(),
+        configuration_variables_map_["UdpBufferSize"].as<uint32_t>()));
+
+    // the bot sessions bring their own sockets, the one of the service itself stays unused
+    mService = mNetworkManager->GenerateService((char*)configuration_variables_map_["BindAddress"].as<std::string>().c_str(), 0,
+               configuration_variables_map_["ServiceMessageHeap"].as<uint32_t>()*1024, false, true);
+    mService->AddNetworkCallback(this);
+
+    mDatabaseManager = new DatabaseManager(DatabaseConfig(configuration_variables_map_["DBMinThreads"].as<uint32_t>(), configuration_variables_map_["DBMaxThreads"].as<uint32_t>(), configuration_variables_map_["DBGlobalSchema"].as<std::string>(), configuration_variables_map_["DBGalaxySchema"].as<std::string>(), configuration_variables_map_["DBConfigSchema"].as<std::string>()));
+
+    mDatabase = mDatabaseManager->connect(DBTYPE_MYSQL,
+                                          (char*)(configuration_variables_map_["DBServer"].as<std::string>()).c_str(),
+                                          configuration_variables_map_["DBPort"].as<uint16_t>(),
+                                          (char*)(configuration_variables_map_["DBUser"].as<std::string>()).c_str(),
+                                          (char*)(configuration_variables_map_["DBPass"].as<std::string>()).c_str(),
+                                          (char*)(configuration_variables_map_["DBName"].as<std::string>()).c_str());
+
+    mCounterBinding = mDatabase->createDataBinding(4);
+    mCounterBinding->addField(DFT_string, offsetof(ServerCounterSample, mName), 33, 0);
+    mCounterBinding->addField(DFT_uint64, offsetof(ServerCounterSample, mReceived), 8, 1);
+    mCounterBinding->addField(DFT_uint64, offsetof(ServerCounterSample, mSent), 8, 2);
+    mCounterBinding->addField(DFT_uint64, offsetof(ServerCounterSample, mTime), 8, 3);
+
+    mBots.reserve(mBotCount);
+
+    mStartTime  = Anh_Utils::Clock::getSingleton()->getLocalTime();
+    mLastReport = mStartTime;
+
+    LOG(WARNING) << "Load Generator - Build " << GetBuildString().c_str();
+    LOG(WARNING) << "Running " << mBotCount << " bots against login " << configuration_variables_map_["LoginAddress"].as<std::string>()
+                 << ":" << configuration_variables_map_["LoginPort"].as<uint16_t>();
+}
+
+//======================================================================================================================
+LoadGenerator::~LoadGenerator()
+{
+    LOG(WARNING) << "Load Generator shutting down...";
+
+    for(BotList::iterator it = mBots.begin(); it != mBots.end(); ++it)
+    {
+        (*it)->Stop();
+    }
+
+    // give the disconnects a chance to go out before the service is torn down
+    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+    mNetworkManager->Process();
+
+    mNetworkManager->DestroyService(mService);
+
+    for(BotList::iterator it = mBots.begin(); it != mBots.end(); ++it)
+    {
+        delete (*it);
+    }
+
+    delete mNetworkManager;
+
+    // finishes an outstanding counter poll before its binding goes away
+    mDatabase->drain();
+    mDatabase->destroyDataBinding(mCounterBinding);
+
+    delete mDatabaseManager;
+
+    MessageFactory::getSingleton()->destroySingleton();
+
+    LOG(WARNING) << "Load Generator Shutdown complete";
+}
+
+//======================================================================================================================
+void LoadGenerator::Process()
+{
+    uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+    _startNextBot(now);
+
+    mNetworkManager->Process();
+    mDatabaseManager->process();
+    gMessageFactory->Process();
+
+    _pollCounters(now);
+
+    for(BotList::iterator it = mBots.begin(); it != mBots.end(); ++it)
+    {
+        (*it)->Process(now);
+    }
+
+    if(mReportInterval && (now - mLastReport) >= mReportInterval)
+    {
+        Report();
+    }
+}
+
+//======================================================================================================================
+bool LoadGenerator::IsFinished() const
+{
+    return (Anh_Utils::Clock::getSingleton()->getLocalTime() - mStartTime) >= mRunDuration;
+}
+
+//======================================================================================================================
+void LoadGenerator::Report()
+{
+    uint64 now      = Anh_Utils::Clock::getSingleton()->getLocalTime();
+    uint32 inWorld  = 0;
+    uint32 failed   = 0;
+
+    for(BotList::iterator it = mBots.begin(); it != mBots.end(); ++it)
+    {
+        if((*it)->getState() == BOTSTATE_InWorld)
+            ++inWorld;
+        else if((*it)->getState() == BOTSTATE_Failed)
+            ++failed;
+    }
+
+    std::ostringstream out;
+    out << "\n==== load report after " << (now - mStartTime) / 1000 << "s ====\n"
+        << "bots: " << mBots.size() << " started, " << inWorld << " in world, " << failed << " failed\n";
+
+    // rates between the samples the servers wrote around the last report and now
+    if(mLatestCounters.empty())
+    {
+        out << "server throughput: no samples, set CounterInterval for the servers\n";
+    }
+
+    for(CounterMap::iterator it = mLatestCounters.begin(); it != mLatestCounters.end(); ++it)
+    {
+        CounterMap::iterator reported = mReportedCounters.find(it->first);
+
+        // a server that restarted counts from zero again, its next sample is the new base
+        if(reported == mReportedCounters.end() || it->second.mTime <= reported->second.mTime
+                || it->second.mReceived < reported->second.mReceived || it->second.mSent < reported->second.mSent)
+        {
+            out << it->first << ": waiting for a second sample\n";
+            continue;
+        }
+
+        uint64 elapsed = it->second.mTime - reported->second.mTime;
+
+        out << it->first << ": " << ((it->second.mReceived - reported->second.mReceived) * 1000) / elapsed << " msg/s in, "
+            << ((it->second.mSent - reported->second.mSent) * 1000) / elapsed << " msg/s out\n";
+    }
+
+    mStats.Report(out);
+
+    std::cout << out.str() << std::endl;
+
+    mLastReport         = now;
+    mReportedCounters   = mLatestCounters;
+}
+
+//======================================================================================================================
+void LoadGenerator::handleSessionConnected(NetworkClient* client)
+{
+    BotLink* link = static_cast<BotLink*>(client);
+    link->getOwner()->handleConnect(link);
+}
+
+//======================================================================================================================
+void LoadGenerator::handleSessionDisconnect(NetworkClient* client)
+{
+    BotLink* link = static_cast<BotLink*>(client);
+    link->getOwner()->handleDisconnect(link);
+}
+
+//======================================================================================================================
+void LoadGenerator::handleSessionMessage(NetworkClient* client, Message* message)
+{
+    BotLink* link = static_cast<BotLink*>(client);
+    link->getOwner()->handleMessage(link, message);
+
+    client->getSession()->DestroyIncomingMessage(message);
+}
+
+//======================================================================================================================
+void LoadGenerator::_startNextBot(uint64 now)
+{
+    // number of bots that should be running by now according to the ramp
+    uint64 due = ((now - mStartTime) * mRampPerSecond) / 1000 + 1;
+
+    if(mBots.size() >= mBotCount || mBots.size() >= due)
+    {
+        return;
+    }
+
+    uint32 index = static_cast<uint32>(mBots.size());
+
+    std::ostringstream username;
+    username << configuration_variables_map_["BotAccountPrefix"].as<std::string>() << index;
+
+    BotClient* bot = new BotClient(index, mService, username.str(), configuration_variables_map_["BotPassword"].as<std::string>(), mScript, &mStats);
+    mBots.push_back(bot);
+
+    bot->Start(configuration_variables_map_["LoginAddress"].as<std::string>(), configuration_variables_map_["LoginPort"].as<uint16_t>(),
+               configuration_variables_map_["ConnectionAddress"].as<std::string>(), configuration_variables_map_["ConnectionPort"].as<uint16_t>(),
+               mConnectTimeout);
+}
+
+//======================================================================================================================
+void LoadGenerator::_pollCounters(uint64 now)
+{
+    if(mCounterPollPending || (now - mLastCounterPoll) < kCounterPollInterval)
+    {
+        return;
+    }
+
+    mCounterPollPending = true;
+    mLastCounterPoll    = now;
+
+    std::stringstream sql;
+    sql << "SELECT server_name, messages_received, messages_sent, sample_time FROM " << mDatabase->galaxy() << ".server_counters;";
+
+    mDatabase->executeAsyncSql<ServerCounterSample>(sql.str(), mCounterBinding, [=] (std::vector<ServerCounterSample>& rows) {
+        mCounterPollPending = false;
+
+        for(std::vector<ServerCounterSample>::iterator it = rows.begin(); it != rows.end(); ++it)
+        {
+            ServerCounterSample& latest = mLatestCounters[it->mName];
+
+            // the first sample of a server is the base for its first rate
+            if(!mReportedCounters.count(it->mName))
+            {
+                mReportedCounters[it->mName] = *it;
+            }
+
+            latest = *it;
+        }
+    });
+}
@@ -0,0 +1,117 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_LOADGENERATOR_LOADGENERATOR_H
+#define ANH_LOADGENERATOR_LOADGENERATOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common/Server.h"
+#include "NetworkManager/NetworkCallback.h"
+#include "Utils/typedefs.h"
+
+#include "LoadGenerator/BotClient.h"
+#include "LoadGenerator/LatencyStats.h"
+
+class Database;
+class DatabaseManager;
+class DataBinding;
+class NetworkManager;
+class Service;
+
+//======================================================================================================================
+
+/*! \brief A row of the server_counters table the servers write every CounterInterval seconds. */
+struct ServerCounterSample
+{
+    char    mName[33];
+    uint64  mReceived;
+    uint64  mSent;
+    uint64  mTime;
+};
+
+//======================================================================================================================
+
+/*! \brief Drives scripted bot clients against a running cluster.
+ *
+ * All bots share one client Service, each bot session connects asynchronously
+ * on a udp port of its own since the servers key their sessions by remote
+ * endpoint. Bots are started at BotRampPerSecond, play their script for
+ * RunDuration seconds and a latency report is printed every ReportInterval
+ * seconds and once more at shutdown. The throughput in the report is the one
+ * the servers count themselves, read from the server_counters table.
+ */
+class LoadGenerator : public common::BaseServer, public NetworkCallback
+{
+public:
+    LoadGenerator(int argc, char* argv[]);
+    ~LoadGenerator();
+
+    void    Process();
+
+    /*! \returns True once RunDuration has elapsed. */
+    bool    IsFinished() const;
+
+    /*! Prints the latency percentiles seen so far and the server side message rates since the last report. */
+    void    Report();
+
+    virtual void    handleSessionConnected(NetworkClient* client);
+    virtual void    handleSessionDisconnect(NetworkClient* client);
+    virtual void    handleSessionMessage(NetworkClient* client, Message* message);
+
+private:
+    void    _startNextBot(uint64 now);
+    void    _pollCounters(uint64 now);
+
+    typedef std::vector<BotClient*>                     BotList;
+    typedef std::map<std::string, ServerCounterSample>  CounterMap;
+
+    BotList             mBots;
+    LatencyStats        mStats;
+    BotScript           mScript;
+    CounterMap          mLatestCounters;
+    CounterMap          mReportedCounters;
+    NetworkManager*     mNetworkManager;
+    DatabaseManager*    mDatabaseManager;
+    Database*           mDatabase;
+    DataBinding*        mCounterBinding;
+    Service*            mService;
+    uint64              mStartTime;
+    uint64              mLastReport;
+    uint64              mLastCounterPoll;
+    uint64              mRunDuration;
+    uint64              mReportInterval;
+    uint32              mBotCount;
+    uint32              mRampPerSecond;
+    uint32              mConnectTimeout;
+    bool                mCounterPollPending;
+};
+
+#endif // ANH_LOADGENERATOR_LOADGENERATOR_H
@@ -0,0 +1,52 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "LoadGenerator/LatencyStats.h"
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+/// Percentiles of an unknown metric are reported as zero rather than failing.
+TEST(LatencyStatsTests, UnknownMetricReportsZero) {
+    LatencyStats stats;
+
+    EXPECT_EQ(0, stats.Count("login"));
+    EXPECT_EQ(0, stats.Percentile("login", 99.0));
+}
+
+/// Percentiles use the nearest-rank method over the recorded samples.
+TEST(LatencyStatsTests, PercentilesUseNearestRank) {
+    LatencyStats stats;
+
+    // record 1..100 in reverse to make sure ordering does not matter
+    for (uint64_t i = 100; i > 0; --i) {
+        stats.Record("zone-in", i);
+    }
+
+    EXPECT_EQ(100, stats.Count("zone-in"));
+    EXPECT_EQ(1, stats.Percentile("zone-in", 0.0));
+    EXPECT_EQ(50, stats.Percentile("zone-in", 50.0));
+    EXPECT_EQ(90, stats.Percentile("zone-in", 90.0));
+    EXPECT_EQ(99, stats.Percentile("zone-in", 99.0));
+    EXPECT_EQ(100, stats.Percentile("zone-in", 100.0));
+}
+
+/// Clearing the stats discards all previously recorded samples.
+TEST(LatencyStatsTests, ClearDiscardsSamples) {
+    LatencyStats stats;
+    stats.Record("chat", 10);
+    stats.Clear();
+
+    EXPECT_EQ(0, stats.Count("chat"));
+
+    std::ostringstream out;
+    stats.Report(out);
+    EXPECT_EQ(std::string::npos, out.str().find("chat"));
+}
+
+}  // namespace
@@ -25,26 +25,63 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 ---------------------------------------------------------------------------------------
 */
 
-#ifndef ANH_ZONESERVER_EV_POSTURE_H
-#define ANH_ZONESERVER_EV_POSTURE_H
 
-#include "EnqueueValidator.h"
-#include "Common/Event.h"
+#include "LoadGenerator/LoadGenerator.h"
 
-class ObjectController;
-class ObjectControllerCmdProperties;
+// Fix for issues with glog redefining this constant
+#ifdef ERROR
+#undef ERROR
+#endif
+#include <glog/logging.h>
 
-//=======================================================================
+#include <iostream>
 
-class EVPosture : public EnqueueValidator
-{
-public:
-    EVPosture(ObjectController* controller);
-    virtual ~EVPosture();
+#include <boost/thread/thread.hpp>
 
-    virtual bool validate(uint32 &reply1, uint32 &reply2, uint64 targetId, uint32 opcode, ObjectControllerCmdProperties*& cmdProperties);
-};
+#include "Utils/utils.h"
 
-//=======================================================================
+//======================================================================================================================
+LoadGenerator* gLoadGenerator = 0;
+
+//======================================================================================================================
+int main(int argc, char* argv[])
+{
+    // Initialize the google logging.
+    google::InitGoogleLogging(argv[0]);
 
+#ifndef _WIN32
+    google::InstallFailureSignalHandler();
 #endif
+
+    FLAGS_log_dir = "./logs";
+    FLAGS_stderrthreshold = 1;
+
+    //set stdout buffers to 0 to force instant flush
+    setvbuf( stdout, NULL, _IONBF, 0);
+
+    try {
+        gLoadGenerator = new LoadGenerator(argc, argv);
+
+        // Main loop
+        while (!gLoadGenerator->IsFinished())
+        {
+            gLoadGenerator->Process();
+
+            if(Anh_Utils::kbhit())
+                if(std::cin.get() == 'q')
+                    break;
+
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+
+        gLoadGenerator->Report();
+
+        // Shutdown things
+        delete gLoadGenerator;
+    } catch( std::exception& e ) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -46,6 +46,16 @@ struct AccountData
     int8					mCsr;
 };
 
+//======================================================================================================================
+// One row of a batched account lookup, mLoginId tells which queued client it belongs to.
+struct AccountLookupData
+{
+    uint32                mLoginId;
+    uint64_t              mId;
+    int8                  mUsername[32];
+    uint32                mCharsAllowed;
+    int8                  mCsr;
+};
 
 //======================================================================================================================
 class ServerData
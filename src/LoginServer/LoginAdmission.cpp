@@ -0,0 +1,126 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "LoginAdmission.h"
+
+#include <cstddef>
+
+//======================================================================================================================
+LoginAdmission::LoginAdmission(uint32 queueSize, uint32 batchSize, uint32 batchesInFlight) :
+    mQueueSize(queueSize),
+    mBatchSize(batchSize ? batchSize : 1),
+    mBatchesInFlight(0),
+    mMaxBatchesInFlight(batchesInFlight ? batchesInFlight : 1)
+{
+}
+
+//======================================================================================================================
+bool LoginAdmission::Enqueue(uint32 loginId)
+{
+    if(mQueue.size() >= mQueueSize)
+    {
+        return false;
+    }
+
+    mQueue.push_back(loginId);
+    return true;
+}
+
+//======================================================================================================================
+std::vector<uint32> LoginAdmission::NextBatch(const LoginWaiting& isWaiting)
+{
+    std::vector<uint32> loginIds;
+
+    if(!HasFreeSlot())
+    {
+        return loginIds;
+    }
+
+    while(loginIds.size() < mBatchSize && !mQueue.empty())
+    {
+        uint32 loginId = mQueue.front();
+        mQueue.pop_front();
+
+        // clients that went away while they were waiting are dropped
+        if(isWaiting(loginId))
+        {
+            loginIds.push_back(loginId);
+        }
+    }
+
+    if(!loginIds.empty())
+    {
+        ++mBatchesInFlight;
+    }
+
+    return loginIds;
+}
+
+//======================================================================================================================
+void LoginAdmission::BatchDone(void)
+{
+    if(mBatchesInFlight)
+    {
+        --mBatchesInFlight;
+    }
+}
+
+//======================================================================================================================
+LoginBatch::LoginBatch(const std::vector<uint32>& loginIds) :
+    mLoginIds(loginIds),
+    mLookupsPending(0)
+{
+}
+
+//======================================================================================================================
+bool LoginBatch::LookupDone(void)
+{
+    return mLookupsPending && --mLookupsPending == 0;
+}
+
+//======================================================================================================================
+void LoginBatch::AddRow(const AccountLookupData& row)
+{
+    mAccounts.insert(std::make_pair(row.mLoginId, row));
+}
+
+//======================================================================================================================
+const AccountLookupData* LoginBatch::getAccount(uint32 loginId) const
+{
+    std::unordered_map<uint32, AccountLookupData>::const_iterator account = mAccounts.find(loginId);
+
+    if(account == mAccounts.end())
+    {
+        return NULL;
+    }
+
+    return &(*account).second;
+}
+
+//======================================================================================================================
+
@@ -0,0 +1,113 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_LOGINSERVER_LOGINADMISSION_H
+#define ANH_LOGINSERVER_LOGINADMISSION_H
+
+#include "Utils/typedefs.h"
+
+#include "AccountData.h"
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+//======================================================================================================================
+
+typedef std::deque<uint32>                  LoginQueue;         // login ids waiting for authentication
+typedef std::function<bool (uint32)>        LoginWaiting;       // whether the client of a login id is still around
+
+//======================================================================================================================
+//
+// The bounded queue of logins waiting for their account lookup. Logins are looked up batchSize at a time,
+// with at most batchesInFlight batches running against the database.
+//
+class LoginAdmission
+{
+public:
+
+    LoginAdmission(uint32 queueSize, uint32 batchSize, uint32 batchesInFlight);
+
+    // false once the queue is full, the login is turned away
+    bool                    Enqueue(uint32 loginId);
+
+    // takes the next batch of logins whose clients are still waiting, ids of departed clients are dropped on the way.
+    // Empty when every lookup slot is taken or nobody is waiting, otherwise the batch holds a slot until BatchDone.
+    std::vector<uint32>     NextBatch(const LoginWaiting& isWaiting);
+    void                    BatchDone(void);
+
+    bool                    HasFreeSlot(void) const { return mBatchesInFlight < mMaxBatchesInFlight; }
+    uint32                  getBatchesInFlight(void) const { return mBatchesInFlight; }
+
+    const LoginQueue&       getQueue(void) const { return mQueue; }
+    void                    Clear(void) { mQueue.clear(); }
+
+private:
+
+    LoginQueue              mQueue;
+    uint32                  mQueueSize;
+    uint32                  mBatchSize;
+    uint32                  mBatchesInFlight;
+    uint32                  mMaxBatchesInFlight;
+};
+
+//======================================================================================================================
+//
+// The account rows of one batch. A batch is looked up by several queries, it is complete once all of them
+// came back. A login without a row failed.
+//
+class LoginBatch
+{
+public:
+
+    explicit LoginBatch(const std::vector<uint32>& loginIds);
+
+    void                    AddLookup(void) { ++mLookupsPending; }
+
+    // true when this was the last lookup of the batch
+    bool                    LookupDone(void);
+
+    void                    AddRow(const AccountLookupData& row);
+
+    // NULL when the login failed
+    const AccountLookupData* getAccount(uint32 loginId) const;
+
+    const std::vector<uint32>& getLoginIds(void) const { return mLoginIds; }
+
+private:
+
+    std::vector<uint32>                         mLoginIds;
+    std::unordered_map<uint32, AccountLookupData> mAccounts;
+    uint32                                      mLookupsPending;
+};
+
+//======================================================================================================================
+
+#endif // ANH_LOGINSERVER_LOGINADMISSION_H
+
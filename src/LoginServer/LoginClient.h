@@ -36,6 +36,7 @@ enum LoginClientState
 {
     LCSTATE_ClientCreated,
     LCSTATE_ServerHelloSent,
+    LCSTATE_QueuedAuth,
     LCSTATE_QueryAuth,
     LCSTATE_QueryServerList,
     LCSTATE_QueryCharacterList,
@@ -51,7 +52,7 @@ enum LoginClientState
 class LoginClient : public NetworkClient
 {
 public:
-    LoginClient(void) : mState(LCSTATE_ClientCreated) {};
+    LoginClient(void) : mState(LCSTATE_ClientCreated), mAccountId(0), mLoginId(0), mSessionKeyLogin(false) {};
     virtual                     ~LoginClient(void) {};
 
     LoginClientState            getState(void)                            {
@@ -60,6 +61,12 @@ public:
     uint32                      getAccountId(void)                        {
         return mAccountId;
     };
+    uint32                      getLoginId(void)                          {
+        return mLoginId;
+    };
+    bool                        getSessionKeyLogin(void)                  {
+        return mSessionKeyLogin;
+    };
     BString&                     getUsername(void)                         {
         return mUsername;
     };
@@ -79,6 +86,12 @@ public:
     void                        setAccountId(uint32 id)                   {
         mAccountId = id;
     };
+    void                        setLoginId(uint32 id)                     {
+        mLoginId = id;
+    };
+    void                        setSessionKeyLogin(bool sessionKey)       {
+        mSessionKeyLogin = sessionKey;
+    };
     void                        setUsername(BString username)              {
         mUsername = username;
     };
@@ -94,6 +107,8 @@ public:
 private:
     LoginClientState            mState;
     uint32                      mAccountId;
+    uint32                      mLoginId;
+    bool                        mSessionKeyLogin;
     BString                      mUsername;
     BString                      mPassword;
     uint32                      mCharsAllowed;
@@ -52,45 +52,91 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stdio.h>
 #include <string.h>
 
+#include <memory>
+#include <sstream>
+
+// title of the error message we use to tell queued clients where they are, the client shows it as a dialog
+static const char* const LoginQueueTitle = "Login Queue";
+
+// how often queued clients are told their position, in ms
+static const uint64 LoginQueueNoticeInterval = 20000;
+
 
 //======================================================================================================================
-LoginManager::LoginManager(Database* database) :
+LoginManager::LoginManager(Database* database, uint32 queueSize, uint32 batchSize, uint32 batchesInFlight) :
     mDatabase(database),
     // mClock(0),
     mSendServerList(false),
+    mAdmission(queueSize, batchSize, batchesInFlight),
+    mAccountLookupBinding(0),
+    mAccountBinding(0),
+    mNextLoginId(0),
+    mAdmittedSinceNotice(0),
+    mAdmissionRate(0.0f),
+    mLastQueueNotice(0),
     mLastStatusQuery(0),
     mLastHeartbeat(0),
     mNumClientsProcessed(0),
     mLoginClientPool(sizeof(LoginClient))
 {
+    // every batched lookup binds its rows with this, so it has to live as long as we do
+    mAccountLookupBinding = mDatabase->createDataBinding(5);
+    mAccountLookupBinding->addField(DFT_uint32, offsetof(AccountLookupData, mLoginId), 4);
+    mAccountLookupBinding->addField(DFT_int64, offsetof(AccountLookupData, mId), 8);
+    mAccountLookupBinding->addField(DFT_string, offsetof(AccountLookupData, mUsername), 32);
+    mAccountLookupBinding->addField(DFT_uint32, offsetof(AccountLookupData, mCharsAllowed), 4);
+    mAccountLookupBinding->addField(DFT_uint8, offsetof(AccountLookupData, mCsr), 1);
+
+    // the row sp_ReturnUserAccount returns
+    mAccountBinding = mDatabase->createDataBinding(8);
+    mAccountBinding->addField(DFT_int64, offsetof(AccountData, mId), 8);
+    mAccountBinding->addField(DFT_string, offsetof(AccountData, mUsername), 32);
+    mAccountBinding->addField(DFT_string, offsetof(AccountData, mPassword), 32);
+    mAccountBinding->addField(DFT_uint32, offsetof(AccountData, mAccountId), 4);
+    mAccountBinding->addField(DFT_uint8, offsetof(AccountData, mBanned), 1);
+    mAccountBinding->addField(DFT_uint8, offsetof(AccountData, mActive), 1);
+    mAccountBinding->addField(DFT_uint32,offsetof(AccountData, mCharsAllowed), 4);
+    mAccountBinding->addField(DFT_uint8, offsetof(AccountData, mCsr), 1);
 }
 
 //======================================================================================================================
 LoginManager::~LoginManager(void)
 {
-    LoginClientList::iterator iter = mLoginClientList.begin();
+    // the loginserver clears every account flag on startup, so the order doesn't matter any longer
+    mAuthenticationsInFlight.clear();
+    _flushLogouts();
 
-    while(iter != mLoginClientList.end())
-    {
-        iter = mLoginClientList.erase(iter);
-    }
+    mLoginClients.clear();
+    mAdmission.Clear();
+
+    mDatabase->destroyDataBinding(mAccountLookupBinding);
+    mDatabase->destroyDataBinding(mAccountBinding);
 }
 
 //======================================================================================================================
 void LoginManager::Process(void)
 {
-    // Update our galaxy status list once in a while.
-    if ((Anh_Utils::Clock::getSingleton()->getLocalTime() - mLastStatusQuery) > 5000)
+    uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+    // Update our galaxy status list once in a while. Logins are served from this cache, so keep it
+    // fresh while there are clients around and relax when nobody is looking.
+    uint64 statusInterval = mLoginClients.empty() ? 30000 : 5000;
+
+    if ((now - mLastStatusQuery) > statusInterval)
     {
-        mLastStatusQuery = Anh_Utils::Clock::getSingleton()->getLocalTime();
+        mLastStatusQuery = now;
         mDatabase->executeProcedureAsync(this, (void*)1, "CALL %s.sp_ReturnGalaxyStatus;",mDatabase->galaxy());
     }
 
+    _processLoginQueue(now);
+    _flushLogouts();
+
     // Heartbeat once in awhile
-    if ((Anh_Utils::Clock::getSingleton()->getLocalTime() - mLastHeartbeat) > 180000)//main loop every 10mins
+    if ((now - mLastHeartbeat) > 180000)//main loop every 10mins
     {
-        mLastHeartbeat = Anh_Utils::Clock::getSingleton()->getLocalTime();
-        LOG(INFO) << "LoginServer Heartbeat. Total clients (non-unique) processed since boot [" << mNumClientsProcessed << "]";
+        mLastHeartbeat = now;
+        LOG(INFO) << "LoginServer Heartbeat. Total clients (non-unique) processed since boot [" << mNumClientsProcessed << "]"
+                  << " queued logins [" << mAdmission.getQueue().size() << "]";
     }
 }
 
@@ -101,8 +147,9 @@ NetworkClient* LoginManager::handleSessionConnect(Session* session, Service* ser
 
     newClient->setSession(session);
     newClient->setState(LCSTATE_ServerHelloSent);
+    newClient->setLoginId(++mNextLoginId);
 
-    mLoginClientList.push_back(newClient);
+    mLoginClients.insert(std::make_pair(newClient->getLoginId(), newClient));
     mNumClientsProcessed++;
 
     return newClient;
@@ -113,22 +160,18 @@ void LoginManager::handleSessionDisconnect(NetworkClient* client)
 {
     LoginClient* loginClient = reinterpret_cast<LoginClient*>(client);
 
-    // Client has disconnected.  Update the db to show they are no longer authenticated.
-    mDatabase->executeProcedureAsync(0, 0, "UPDATE %s.account SET account_authenticated = 0 WHERE account_id=%u;",mDatabase->galaxy(), loginClient->getAccountId());
-
-    LoginClientList::iterator iter = mLoginClientList.begin();
-
-    while(iter != mLoginClientList.end())
+    // Client has disconnected.  Update the db to show they are no longer authenticated, the updates
+    // are collected and sent as one statement per tick.
+    if(loginClient->getAccountId())
     {
-        if(loginClient == (*iter))
-        {
-            mLoginClientPool.free(*iter);
-            mLoginClientList.erase(iter);
-            break;
-        }
-
-        ++iter;
+        mPendingLogouts.push_back(loginClient->getAccountId());
     }
+
+    // A queued login id stays in the queue, it is skipped once it comes up and the client is gone.
+    mLoginClients.erase(loginClient->getLoginId());
+
+    loginClient->~LoginClient();
+    mLoginClientPool.free(loginClient);
 }
 
 //======================================================================================================================
@@ -190,12 +233,6 @@ void LoginManager::handleDatabaseJobComplete(void* ref, DatabaseResult* result)
 
     switch (client->getState())
     {
-    case LCSTATE_QueryAuth:
-    {
-        // Check authentication
-        _authenticateClient(client, result);
-        break;
-    }
     case LCSTATE_QueryServerList:
     {
         // Auth was successful, now send the server list.
@@ -268,100 +305,308 @@ void LoginManager::_handleLoginClientId(LoginClient* client, Message* message)
         client->Disconnect(0);
         return;
     }
-    
+
+    // a client resending its credentials while it is queued keeps its place
+    if(client->getState() != LCSTATE_ServerHelloSent)
+    {
+        return;
+    }
+
     LOG(INFO) << "Login request for account: [" << username.getAnsi() << "]";
 
     client->setUsername(username);
     client->setPassword(password);
 
-    int8 sql[512],*sqlPointer;
+    // no username means a session key login from the ANH launcher, the key is sent as password
+    client->setSessionKeyLogin(strlen(username.getAnsi()) == 0);
 
-    if (strlen(username.getAnsi()) == 0) //SessionID Login With ANH Launcher
+    // After a galaxy restart everybody logs in at once. Rather than stacking up queries until the
+    // database times out we turn people away once the queue is full.
+    if(!mAdmission.Enqueue(client->getLoginId()))
     {
-        sprintf(sql,"SELECT account_id, account_username, account_password, account_station_id, account_banned, account_active,account_characters_allowed,"
-                "account_session_key, account_csr FROM account WHERE account_banned=0 AND account_authenticated=0 AND account_loggedin=0 AND account_session_key='");
-        // sprintf(sql,"SELECT account_id, account_username, account_password, account_station_id, account_banned, account_active,account_characters_allowed,"
-        //"account_session_key, account_csr FROM account WHERE account_banned=0 AND account_authenticated=0 AND account_loggedin=0 AND account_session_key=' AND session_key='");
-        sqlPointer = sql + strlen(sql);
-        sqlPointer += mDatabase->escapeString(sqlPointer,password.getAnsi(),password.getLength());
-        *sqlPointer++ = '\'';
-        *sqlPointer++ = '\0';
+        LOG(WARNING) << "Login queue full, turning away account: [" << username.getAnsi() << "]";
+        _sendLoginFailed(client, LoginQueueTitle, "The galaxy is busy, please try again in a few minutes.");
+        return;
     }
-    else //	regular login the client login screen
+
+    client->setState(LCSTATE_QueuedAuth);
+
+    // it only waits when every lookup slot is taken, let it know
+    if(!mAdmission.HasFreeSlot())
     {
-        //the problem with the marked authentication is, that if a connection drops without a sessiondisconnect packet
-        //the connection to the loginserver cannot be established anymore - need to have the sessiontimeout think of that
+        _sendQueuePosition(client, static_cast<uint32>(mAdmission.getQueue().size()));
+    }
+}
 
-        sprintf(sql,"CALL %s.sp_ReturnUserAccount('",mDatabase->galaxy());
+//======================================================================================================================
+void LoginManager::_processLoginQueue(uint64 now)
+{
+    while(mAdmission.HasFreeSlot() && !mAdmission.getQueue().empty())
+    {
+        _dispatchLoginBatch();
+    }
 
-        sqlPointer = sql + strlen(sql);
-        sqlPointer += mDatabase->escapeString(sqlPointer,username.getAnsi(),username.getLength());
-        strcat(sql,"' , '");
-        sqlPointer = sql + strlen(sql);
-        sqlPointer += mDatabase->escapeString(sqlPointer,password.getAnsi(),password.getLength());
-        *sqlPointer++ = '\'';
-        *sqlPointer++ = ')';
-        *sqlPointer++ = '\0';
+    if((now - mLastQueueNotice) >= LoginQueueNoticeInterval)
+    {
+        _sendQueuePositions(now);
     }
+}
 
-// Setup an async query for checking authentication.
-    client->setState(LCSTATE_QueryAuth);
-    mDatabase->executeProcedureAsync(this,client,sql);
-    
+//======================================================================================================================
+//
+// Looks up the next batch of queued logins. Username logins still go through sp_ReturnUserAccount, one call
+// per login, as the procedure does more than read the account. Session key logins are plain selects, they share
+// a single query where every select is tagged with its login id, so the rows can be matched back.
+//
+void LoginManager::_dispatchLoginBatch(void)
+{
+    std::vector<uint32> loginIds = mAdmission.NextBatch([this] (uint32 loginId) {
+        return mLoginClients.count(loginId) != 0;
+    });
+
+    if(loginIds.empty())
+    {
+        return;
+    }
+
+    std::shared_ptr<LoginBatch> batch = std::make_shared<LoginBatch>(loginIds);
+    std::stringstream sessionKeys;
+    bool anySessionKeys = false;
+
+    for(std::vector<uint32>::const_iterator id = loginIds.begin(); id != loginIds.end(); ++id)
+    {
+        LoginClient* client = mLoginClients[*id];
+        client->setState(LCSTATE_QueryAuth);
+
+        if(client->getSessionKeyLogin())
+        {
+            sessionKeys << (anySessionKeys ? " UNION ALL " : "")
+                        << "(SELECT " << *id << ", account_id, account_username, account_characters_allowed, account_csr FROM "
+                        << mDatabase->galaxy() << ".account WHERE account_banned=0 AND account_authenticated=0 AND account_loggedin=0"
+                        << " AND account_session_key='" << mDatabase->escapeString(client->getPassword().getAnsi()) << "')";
+            anySessionKeys = true;
+            continue;
+        }
+
+        std::stringstream sql;
+        sql << "CALL " << mDatabase->galaxy() << ".sp_ReturnUserAccount('" << mDatabase->escapeString(client->getUsername().getAnsi())
+            << "' , '" << mDatabase->escapeString(client->getPassword().getAnsi()) << "')";
+
+        uint32 loginId = *id;
+        batch->AddLookup();
+
+        mDatabase->executeAsyncProcedure(sql.str(), [=] (DatabaseResult* result) {
+            if(result && result->getRowCount())
+            {
+                AccountData data;
+                result->getNextRow(mAccountBinding, (void*)&data);
+
+                AccountLookupData row;
+                row.mLoginId = loginId;
+                row.mId = data.mId;
+                row.mCharsAllowed = data.mCharsAllowed;
+                row.mCsr = data.mCsr;
+                strncpy(row.mUsername, data.mUsername, sizeof(row.mUsername));
+
+                batch->AddRow(row);
+            }
+
+            if(batch->LookupDone())
+            {
+                _authenticateBatch(*batch);
+            }
+        });
+    }
+
+    if(anySessionKeys)
+    {
+        batch->AddLookup();
+
+        mDatabase->executeAsyncSql<AccountLookupData>(sessionKeys.str(), mAccountLookupBinding, [=] (std::vector<AccountLookupData>& rows) {
+            for(std::vector<AccountLookupData>::const_iterator row = rows.begin(); row != rows.end(); ++row)
+            {
+                batch->AddRow(*row);
+            }
+
+            if(batch->LookupDone())
+            {
+                _authenticateBatch(*batch);
+            }
+        });
+    }
 }
 
 //======================================================================================================================
-void LoginManager::_authenticateClient(LoginClient* client, DatabaseResult* result)
+void LoginManager::_authenticateBatch(const LoginBatch& batch)
 {
-    AccountData data;
-    
-    // This DataBinding code I'm not sure where to put atm.  I've thought about a base class for any objects that want
-    // DataBinding, but I don't want to go overboard on abstraction.  Any suggestions would be appreciated.  :)
-    DataBinding* binding = mDatabase->createDataBinding(8);
-    binding->addField(DFT_int64, offsetof(AccountData, mId), 8);
-    binding->addField(DFT_string, offsetof(AccountData, mUsername), 32);
-    binding->addField(DFT_string, offsetof(AccountData, mPassword), 32);
-    binding->addField(DFT_uint32, offsetof(AccountData, mAccountId), 4);
-    binding->addField(DFT_uint8, offsetof(AccountData, mBanned), 1);
-    binding->addField(DFT_uint8, offsetof(AccountData, mActive), 1);
-    binding->addField(DFT_uint32,offsetof(AccountData, mCharsAllowed), 4);
-    binding->addField(DFT_uint8, offsetof(AccountData, mCsr), 1);
-        
-    if (result->getRowCount())
+    mAdmission.BatchDone();
+
+    const std::vector<uint32>& loginIds = batch.getLoginIds();
+
+    std::stringstream authenticated;
+    std::vector<uint32> accountIds;
+    bool anyAuthenticated = false;
+
+    for(std::vector<uint32>::const_iterator id = loginIds.begin(); id != loginIds.end(); ++id)
     {
-        result->getNextRow(binding, (void*)&data);
-        client->setAccountId(data.mId);
-        client->setCharsAllowed(data.mCharsAllowed);
-        client->setCsr(data.mCsr);
-        
-        LOG(INFO) << "Login: AccountId: " << data.mId << " Name: " << data.mUsername;
+        LoginClientMap::iterator iter = mLoginClients.find(*id);
+
+        if(iter == mLoginClients.end())
+        {
+            continue;
+        }
+
+        LoginClient* client = (*iter).second;
+        const AccountLookupData* data = batch.getAccount(*id);
+
+        if(!data)
+        {
+            LOG(WARNING) << " Login failed for username: " << client->getUsername().getAnsi();
+            _sendLoginFailed(client, "@cpt_login_fail", "@msg_login_fail");
+            continue;
+        }
+
+        client->setAccountId(static_cast<uint32>(data->mId));
+        client->setCharsAllowed(data->mCharsAllowed);
+        client->setCsr(data->mCsr);
+
+        LOG(INFO) << "Login: AccountId: " << data->mId << " Name: " << data->mUsername;
+
+        authenticated << (anyAuthenticated ? "," : "") << client->getAccountId();
+        accountIds.push_back(client->getAccountId());
+        anyAuthenticated = true;
 
         _sendAuthSucceeded(client);
+        ++mAdmittedSinceNotice;
     }
-    else
+
+    // Update the account records so we know they authenticated properly. The workers may run this and a
+    // logout of the same account in any order, so the logout is held back until this one is written.
+    if(anyAuthenticated)
     {
-        Message* newMessage;
+        for(std::vector<uint32>::const_iterator id = accountIds.begin(); id != accountIds.end(); ++id)
+        {
+            ++mAuthenticationsInFlight[*id];
+        }
 
-        BString errType, errMsg;
-        errType = "@cpt_login_fail";
-        errMsg = "@msg_login_fail";
+        std::stringstream sql;
+        sql << "UPDATE " << mDatabase->galaxy() << ".account SET account_authenticated = 1 WHERE account_id IN (" << authenticated.str() << ");";
+        mDatabase->executeAsyncSql(sql.str(), [=] (DatabaseResult* result) {
+            for(std::vector<uint32>::const_iterator id = accountIds.begin(); id != accountIds.end(); ++id)
+            {
+                std::unordered_map<uint32, uint32>::iterator inFlight = mAuthenticationsInFlight.find(*id);
 
-        LOG(WARNING) << " Login failed for username: " <<  client->getUsername().getAnsi() << " password: ********" << client->getPassword().getAnsi();
+                if(inFlight != mAuthenticationsInFlight.end() && --(*inFlight).second == 0)
+                {
+                    mAuthenticationsInFlight.erase(inFlight);
+                }
+            }
+        });
+    }
+}
 
-        gMessageFactory->StartMessage();
-        gMessageFactory->addUint32(opErrorMessage);
-        gMessageFactory->addString(errType);
-        gMessageFactory->addString(errMsg);
-        gMessageFactory->addUint8(0);
+//======================================================================================================================
+//
+// Tells everybody still waiting where they are, the estimate comes from how many logins got through lately.
+//
+void LoginManager::_sendQueuePositions(uint64 now)
+{
+    if(mLastQueueNotice)
+    {
+        float seconds = static_cast<float>(now - mLastQueueNotice) / 1000.0f;
+        float rate = static_cast<float>(mAdmittedSinceNotice) / seconds;
+
+        mAdmissionRate = (mAdmissionRate > 0.0f) ? (0.7f * mAdmissionRate + 0.3f * rate) : rate;
+    }
+
+    mAdmittedSinceNotice = 0;
+    mLastQueueNotice = now;
+
+    uint32 position = 0;
+
+    LoginQueue::const_iterator iter = mAdmission.getQueue().begin();
+
+    while(iter != mAdmission.getQueue().end())
+    {
+        LoginClientMap::iterator client = mLoginClients.find(*iter);
+
+        if(client != mLoginClients.end())
+        {
+            _sendQueuePosition((*client).second, ++position);
+        }
+
+        ++iter;
+    }
+}
 
-        newMessage = gMessageFactory->EndMessage();
+//======================================================================================================================
+void LoginManager::_sendQueuePosition(LoginClient* client, uint32 position)
+{
+    std::stringstream text;
+    text << "You are number " << position << " in the login queue.";
 
-        client->SendChannelA(newMessage, 3,false);
-        client->Disconnect(6);
+    if(mAdmissionRate > 0.0f)
+    {
+        text << " Estimated wait: " << static_cast<uint32>(position / mAdmissionRate) + 1 << " seconds.";
     }
 
-    // Destroy our database object
-    mDatabase->destroyDataBinding(binding);
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opErrorMessage);
+    gMessageFactory->addString(LoginQueueTitle);
+    gMessageFactory->addString(text.str());
+    gMessageFactory->addUint8(0);
+
+    client->SendChannelA(gMessageFactory->EndMessage(), 3, false);
+}
+
+//======================================================================================================================
+void LoginManager::_sendLoginFailed(LoginClient* client, const BString& errType, const BString& errMsg)
+{
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opErrorMessage);
+    gMessageFactory->addString(errType);
+    gMessageFactory->addString(errMsg);
+    gMessageFactory->addUint8(0);
+
+    client->SendChannelA(gMessageFactory->EndMessage(), 3, false);
+    client->Disconnect(6);
+}
+
+//======================================================================================================================
+void LoginManager::_flushLogouts(void)
+{
+    if(mPendingLogouts.empty())
+    {
+        return;
+    }
+
+    std::stringstream sql;
+    sql << "UPDATE " << mDatabase->galaxy() << ".account SET account_authenticated = 0 WHERE account_id IN (";
+
+    std::vector<uint32> held;
+    bool any = false;
+
+    for(std::vector<uint32>::const_iterator id = mPendingLogouts.begin(); id != mPendingLogouts.end(); ++id)
+    {
+        // still waiting for its authenticated = 1, it would be overwritten by it
+        if(mAuthenticationsInFlight.count(*id))
+        {
+            held.push_back(*id);
+            continue;
+        }
+
+        sql << (any ? "," : "") << *id;
+        any = true;
+    }
+
+    sql << ");";
+
+    if(any)
+    {
+        mDatabase->executeAsyncSql(sql.str());
+    }
+
+    mPendingLogouts.swap(held);
 }
 
 //======================================================================================================================
@@ -389,14 +634,44 @@ void LoginManager::_sendAuthSucceeded(LoginClient* client)
     Message* message = gMessageFactory->EndMessage();
     client->SendChannelA(message, 4,false);
 
-    // Update the account record so we know they authenticated properly.
-    mDatabase->executeSqlAsync(0, 0, "UPDATE %s.account SET account_authenticated = 1 WHERE account_id = %u;",mDatabase->galaxy(), client->getAccountId());
+    // The galaxy status cache has everything the server list needs, only ask the database
+    // when it has not been filled yet.
+    if(!mServerDataList.empty())
+    {
+        _sendServerList(client);
+
+        client->setState(LCSTATE_QueryCharacterList);
+        mDatabase->executeProcedureAsync(this, (void*)client, "CALL %s.sp_ReturnAccountCharacters(%u);",mDatabase->galaxy(), client->getAccountId());
+        return;
+    }
 
     // Execute our query for sending the server list.
     client->setState(LCSTATE_QueryServerList);
     mDatabase->executeProcedureAsync(this, (void*)client, "CALL %s.sp_ReturnServerList;",mDatabase->galaxy());
 }
 
+//======================================================================================================================
+void LoginManager::_sendServerList(LoginClient* client)
+{
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opLoginEnumCluster);
+    gMessageFactory->addUint32(mServerDataList.size());           // Number of servers in the list.
+
+    ServerDataList::iterator iter;
+    for (iter = mServerDataList.begin(); iter != mServerDataList.end(); iter++)
+    {
+        gMessageFactory->addUint32((*iter)->mId);                   // Server Id.
+        gMessageFactory->addString((*iter)->mName);                 // Server name
+        gMessageFactory->addUint32(0xffff8f80);
+    }
+    gMessageFactory->addUint32(client->getCharsAllowed());
+
+    client->SendChannelA(gMessageFactory->EndMessage(), 3, false);
+
+    // Now send the current status.
+    _sendServerStatus(client);
+}
+
 //======================================================================================================================
 void LoginManager::_sendServerList(LoginClient* client, DatabaseResult* result)
 {
@@ -517,8 +792,9 @@ void LoginManager::_sendDeleteCharacterReply(uint32 result,LoginClient* client)
 
     // Set the account authenticated to 0 (the server will attempt to relogin for any further processing).
     // Set the state to the end state to prevent character deletion infinite loop.
+    // Goes out with the logouts, so it is ordered after the authentication of the account.
     client->setState(LCSTATE_End);
-    mDatabase->executeProcedureAsync(0, 0, "UPDATE %s.account SET account_authenticated = 0 WHERE account_id = %u;",mDatabase->galaxy(), client->getAccountId());
+    mPendingLogouts.push_back(client->getAccountId());
  
 }
 
@@ -613,11 +889,15 @@ void LoginManager::_updateServerStatus(DatabaseResult* result)
 
     if (mSendServerList)
     {
-        LoginClientList::iterator it = mLoginClientList.begin();
+        LoginClientMap::iterator it = mLoginClients.begin();
 
-        while(it != mLoginClientList.end())
+        while(it != mLoginClients.end())
         {
-            _sendServerStatus((*it));
+            // clients still waiting for authentication get the status along with their server list
+            if((*it).second->getState() >= LCSTATE_QueryServerList)
+            {
+                _sendServerStatus((*it).second);
+            }
 
             ++it;
         }
@@ -685,24 +965,9 @@ void LoginManager::_getLauncherSessionKey(LoginClient* client, DatabaseResult* r
     }
     else
     {
-        Message* newMessage;
-
-        BString errType, errMsg;
-        errType = "@cpt_login_fail";
-        errMsg = "@msg_login_fail";
-
-        DLOG(INFO) << " Login failed for username: "  << client->getUsername().getAnsi() <<", password: ********" << client->getPassword().getAnsi();
-
-        gMessageFactory->StartMessage();
-        gMessageFactory->addUint32(opErrorMessage);
-        gMessageFactory->addString(errType);
-        gMessageFactory->addString(errMsg);
-        gMessageFactory->addUint8(0);
-
-        newMessage = gMessageFactory->EndMessage();
+        DLOG(INFO) << " Login failed for username: "  << client->getUsername().getAnsi();
 
-        client->SendChannelA(newMessage, 3,false);
-        client->Disconnect(6);
+        _sendLoginFailed(client, "@cpt_login_fail", "@msg_login_fail");
     }
 
     // Destroy our database object
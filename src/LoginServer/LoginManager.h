@@ -35,14 +35,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/typedefs.h"
 #include "Utils/bstring.h"
 
+#include "LoginAdmission.h"
+
 #include <boost/pool/pool.hpp>
 
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 
 //======================================================================================================================
 
 class Database;
+class DataBinding;
 class LoginClient;
 class ServerData;
 class Message;
@@ -54,8 +59,8 @@ enum AuthResult
     AUTHRESULT_AuthBanned
 };
 
-typedef std::list<LoginClient*>      LoginClientList;
-typedef std::list<ServerData*>       ServerDataList;
+typedef std::unordered_map<uint32, LoginClient*>  LoginClientMap;     // by login id
+typedef std::list<ServerData*>                    ServerDataList;
 
 //======================================================================================================================
 
@@ -74,7 +79,9 @@ class LoginManager : public NetworkCallback, public DatabaseCallback
 {
 public:
 
-    LoginManager(Database* database);
+    // queueSize bounds the logins waiting for authentication, they are looked up batchSize at a time
+    // with at most batchesInFlight lookups running against the database.
+    LoginManager(Database* database, uint32 queueSize, uint32 batchSize, uint32 batchesInFlight);
     ~LoginManager(void);
 
     void                    Process(void);
@@ -94,9 +101,16 @@ private:
 
 
     void                    _handleLoginClientId(LoginClient* client, Message* message);
-    void                    _authenticateClient(LoginClient* client, DatabaseResult* result);
+    void                    _processLoginQueue(uint64 now);
+    void                    _dispatchLoginBatch(void);
+    void                    _authenticateBatch(const LoginBatch& batch);
+    void                    _sendQueuePositions(uint64 now);
+    void                    _sendQueuePosition(LoginClient* client, uint32 position);
+    void                    _sendLoginFailed(LoginClient* client, const BString& errType, const BString& errMsg);
+    void                    _flushLogouts(void);
     void                    _sendAuthSucceeded(LoginClient* client);
     void                    _sendCharacterList(LoginClient* client, DatabaseResult* result);
+    void                    _sendServerList(LoginClient* client);
     void                    _sendServerList(LoginClient* client, DatabaseResult* result);
     void                    _sendServerStatus(LoginClient* client);
     void                    _updateServerStatus(DatabaseResult* result);
@@ -110,10 +124,22 @@ private:
     Database*	            mDatabase;
     // Anh_Utils::Clock*       mClock;
 
-    LoginClientList         mLoginClientList;
+    LoginClientMap          mLoginClients;
     ServerDataList          mServerDataList;
     bool                    mSendServerList;
 
+    // admission pipeline
+    LoginAdmission          mAdmission;
+    DataBinding*            mAccountLookupBinding;
+    DataBinding*            mAccountBinding;
+    std::vector<uint32>     mPendingLogouts;
+    // account id -> authenticated = 1 updates not written yet, logouts of these accounts wait for them
+    std::unordered_map<uint32, uint32>  mAuthenticationsInFlight;
+    uint32                  mNextLoginId;
+    uint32                  mAdmittedSinceNotice;
+    float                   mAdmissionRate;         // logins per second, smoothed
+    uint64                  mLastQueueNotice;
+
     uint64                  mLastStatusQuery;
     uint64                  mLastHeartbeat;
     uint32					mNumClientsProcessed;
@@ -35,6 +35,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 #include "LoginManager.h"
 #include "Common/BuildInfo.h"
@@ -50,6 +51,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <boost/thread/thread.hpp>
 #include "Utils/clock.h"
+#include "Utils/Reactor.h"
 
 //======================================================================================================================
 LoginServer* gLoginServer = 0;
@@ -58,17 +60,29 @@ LoginServer* gLoginServer = 0;
 //======================================================================================================================
 LoginServer::LoginServer(int argc, char* argv[]) 
 	: BaseServer()
+    , mReactor(0)
     , mNetworkManager(0)
+    , mCounterInterval(0)
+    , mLastCounterWrite(0)
 {
     Anh_Utils::Clock::Init();
     LOG(WARNING) << "Login Server Startup";
 
+	configuration_options_description_.add_options()
+		("LoginQueueSize", boost::program_options::value<uint32_t>()->default_value(5000), "logins that may wait for authentication before new ones are turned away")
+		("LoginBatchSize", boost::program_options::value<uint32_t>()->default_value(50), "queued logins looked up per account query")
+		("LoginBatchesInFlight", boost::program_options::value<uint32_t>()->default_value(2), "account queries allowed to run at the same time")
+	;
+
 	// Load Configuration Options
 	std::list<std::string> config_files;
 	config_files.push_back("config/general.cfg");
 	config_files.push_back("config/loginserver.cfg");
 	LoadOptions_(argc, argv, config_files);
 
+    mReactor = new utils::Reactor(configuration_variables_map_["MainLoopTickInterval"].as<uint32_t>());
+    mCounterInterval = uint64(configuration_variables_map_["CounterInterval"].as<uint32_t>()) * 1000;
+
     // Initialize our modules.
 
 	MessageFactory::getSingleton(configuration_variables_map_["GlobalMessageHeap"].as<uint32_t>());
@@ -80,11 +94,14 @@ LoginServer::LoginServer(int argc, char* argv[])
 		configuration_variables_map_["ServerPacketWindowSize"].as<uint32_t>(), 
 		configuration_variables_map_["ClientPacketWindowSize"].as<uint32_t>(),
 		configuration_variables_map_["UdpBufferSize"].as<uint32_t>()));
+    mNetworkManager->setReactor(mReactor);
 
     LOG(WARNING) << "Config port set to " << configuration_variables_map_["BindPort"].as<uint16>();
     mService = mNetworkManager->GenerateService((char*)configuration_variables_map_["BindAddress"].as<std::string>().c_str(), configuration_variables_map_["BindPort"].as<uint16_t>(),configuration_variables_map_["ServiceMessageHeap"].as<uint32_t>()*1024,false);
+    mService->setCountMessages(mCounterInterval != 0);
 
 	mDatabaseManager = new DatabaseManager(DatabaseConfig(configuration_variables_map_["DBMinThreads"].as<uint32_t>(), configuration_variables_map_["DBMaxThreads"].as<uint32_t>(), configuration_variables_map_["DBGlobalSchema"].as<std::string>(), configuration_variables_map_["DBGalaxySchema"].as<std::string>(), configuration_variables_map_["DBConfigSchema"].as<std::string>()));
+    mDatabaseManager->setReactor(mReactor);
 
     // Connect to our database and pass it off to our modules.
     mDatabase = mDatabaseManager->connect(DBTYPE_MYSQL,
@@ -107,7 +124,10 @@ LoginServer::LoginServer(int argc, char* argv[])
     (void)MessageFactory::getSingleton();		// Use this a marker of where the factory is instanced.
     // The code itself here is not needed, since it will instance itself at first use.
 
-    mLoginManager = new LoginManager(mDatabase);
+    mLoginManager = new LoginManager(mDatabase,
+                                     configuration_variables_map_["LoginQueueSize"].as<uint32_t>(),
+                                     configuration_variables_map_["LoginBatchSize"].as<uint32_t>(),
+                                     configuration_variables_map_["LoginBatchesInFlight"].as<uint32_t>());
 
     // Let our network Service know about our callbacks
     mService->AddNetworkCallback(mLoginManager);
@@ -140,6 +160,8 @@ LoginServer::~LoginServer(void)
 
     delete mDatabaseManager;
 
+    delete mReactor;
+
     LOG(WARNING) << "LoginServer Shutdown complete";
 }
 
@@ -150,6 +172,26 @@ void LoginServer::Process(void)
     mDatabaseManager->process();
     mLoginManager->Process();
     gMessageFactory->Process();
+
+    if (mCounterInterval && Anh_Utils::Clock::getSingleton()->getLocalTime() - mLastCounterWrite > mCounterInterval)
+    {
+        mLastCounterWrite = Anh_Utils::Clock::getSingleton()->getLocalTime();
+        _writeCounters();
+    }
+}
+
+//======================================================================================================================
+//
+// the load generator reports the server side throughput from these
+//
+
+void LoginServer::_writeCounters(void)
+{
+    std::stringstream sql;
+    sql << "REPLACE INTO " << mDatabase->galaxy() << ".server_counters VALUES ('login', "
+        << mService->getMessagesReceived() << ", " << mService->getMessagesSent() << ", " << mLastCounterWrite << ");";
+
+    mDatabase->executeAsyncSql(sql);
 }
 
 
@@ -184,16 +226,18 @@ int main(int argc, char* argv[])
 		// Since startup completed successfully, now set the atexit().  Otherwise we try to gracefully shutdown a failed startup, which usually fails anyway.
 		//atexit(handleExit);
 
-		// Main loop
+		utils::Reactor* reactor = gLoginServer->getReactor();
+
+		// Main loop, sleeps until there is network or database work or a tick is due
 		while (!exit)
 		{
+			reactor->Wait();
+
 			gLoginServer->Process();
 
 			if(Anh_Utils::kbhit())
 				if(std::cin.get() == 'q')
 					break;
-
-			boost::this_thread::sleep(boost::posix_time::milliseconds(10));
 		}
 
 		// Shutdown things
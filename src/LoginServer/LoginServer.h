@@ -31,6 +31,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/typedefs.h"
 #include "Common/Server.h"
 
+namespace utils {
+class Reactor;
+}
+
 class NetworkManager;
 class Service;
 class LoginManager;
@@ -47,12 +51,21 @@ public:
 
     void	Process(void);
 
+    utils::Reactor*	getReactor() {
+        return mReactor;
+    }
+
 private:
+    void	_writeCounters(void);
+
+    utils::Reactor*									mReactor;
     NetworkManager*									mNetworkManager;
     Service*										mService;
     DatabaseManager*								mDatabaseManager;
     Database*										mDatabase;
     LoginManager*									mLoginManager;
+    uint64											mCounterInterval;
+    uint64											mLastCounterWrite;
 };
 
 
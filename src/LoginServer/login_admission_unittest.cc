@@ -0,0 +1,153 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "LoginServer/LoginAdmission.h"
+
+#include <cstring>
+#include <set>
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+bool everybodyWaits(uint32 loginId) {
+    return true;
+}
+
+AccountLookupData accountRow(uint32 login_id, uint64_t account_id) {
+    AccountLookupData row;
+    memset(&row, 0, sizeof(row));
+    row.mLoginId = login_id;
+    row.mId = account_id;
+    return row;
+}
+
+/*! Logins past the queue size are turned away, a batch frees no room in the
+* queue for them until it was taken.
+*/
+TEST(LoginAdmissionTests, TurnsAwayLoginsWhenTheQueueIsFull) {
+    LoginAdmission admission(3, 2, 1);
+
+    EXPECT_TRUE(admission.Enqueue(1));
+    EXPECT_TRUE(admission.Enqueue(2));
+    EXPECT_TRUE(admission.Enqueue(3));
+    EXPECT_FALSE(admission.Enqueue(4));
+    EXPECT_EQ(3u, admission.getQueue().size());
+
+    std::vector<uint32> batch = admission.NextBatch(everybodyWaits);
+    ASSERT_EQ(2u, batch.size());
+    EXPECT_EQ(1u, batch[0]);
+    EXPECT_EQ(2u, batch[1]);
+
+    EXPECT_TRUE(admission.Enqueue(4));
+    EXPECT_TRUE(admission.Enqueue(5));
+    EXPECT_FALSE(admission.Enqueue(6));
+}
+
+/*! Logins whose client went away while queued are dropped from the queue and
+* don't take a place in the batch.
+*/
+TEST(LoginAdmissionTests, SkipsDepartedClients) {
+    LoginAdmission admission(10, 2, 2);
+
+    for (uint32 id = 1; id <= 5; ++id) {
+        admission.Enqueue(id);
+    }
+
+    std::set<uint32> departed;
+    departed.insert(1);
+    departed.insert(3);
+
+    LoginWaiting waiting = [&departed] (uint32 loginId) { return departed.count(loginId) == 0; };
+
+    std::vector<uint32> batch = admission.NextBatch(waiting);
+    ASSERT_EQ(2u, batch.size());
+    EXPECT_EQ(2u, batch[0]);
+    EXPECT_EQ(4u, batch[1]);
+    ASSERT_EQ(1u, admission.getQueue().size());
+    EXPECT_EQ(5u, admission.getQueue().front());
+
+    // nobody left waiting, no batch and no slot taken
+    departed.insert(5);
+    EXPECT_TRUE(admission.NextBatch(waiting).empty());
+    EXPECT_TRUE(admission.getQueue().empty());
+    EXPECT_EQ(1u, admission.getBatchesInFlight());
+}
+
+/*! Every batch holds a lookup slot until it is done, no batch is handed out
+* while all of them are taken.
+*/
+TEST(LoginAdmissionTests, LimitsTheBatchesInFlight) {
+    LoginAdmission admission(10, 1, 2);
+
+    for (uint32 id = 1; id <= 4; ++id) {
+        admission.Enqueue(id);
+    }
+
+    EXPECT_EQ(1u, admission.NextBatch(everybodyWaits).size());
+    EXPECT_EQ(1u, admission.NextBatch(everybodyWaits).size());
+    EXPECT_FALSE(admission.HasFreeSlot());
+    EXPECT_TRUE(admission.NextBatch(everybodyWaits).empty());
+    EXPECT_EQ(2u, admission.getQueue().size());
+
+    admission.BatchDone();
+    EXPECT_TRUE(admission.HasFreeSlot());
+
+    std::vector<uint32> batch = admission.NextBatch(everybodyWaits);
+    ASSERT_EQ(1u, batch.size());
+    EXPECT_EQ(3u, batch[0]);
+
+    // a stray BatchDone doesn't hand out more slots than configured
+    admission.BatchDone();
+    admission.BatchDone();
+    admission.BatchDone();
+    EXPECT_EQ(0u, admission.getBatchesInFlight());
+}
+
+/*! A batch of 0 logins or 0 slots would never admit anybody, both are
+* treated as 1.
+*/
+TEST(LoginAdmissionTests, TreatsZeroSizesAsOne) {
+    LoginAdmission admission(10, 0, 0);
+
+    admission.Enqueue(1);
+    admission.Enqueue(2);
+
+    EXPECT_EQ(1u, admission.NextBatch(everybodyWaits).size());
+    EXPECT_FALSE(admission.HasFreeSlot());
+}
+
+/*! A batch is complete once its last lookup came back, a login without an
+* account row failed.
+*/
+TEST(LoginBatchTests, LoginsWithoutARowFail) {
+    std::vector<uint32> login_ids;
+    login_ids.push_back(7);
+    login_ids.push_back(8);
+    login_ids.push_back(9);
+
+    LoginBatch batch(login_ids);
+    batch.AddLookup();
+    batch.AddLookup();
+
+    batch.AddRow(accountRow(7, 1007));
+    EXPECT_FALSE(batch.LookupDone());
+
+    batch.AddRow(accountRow(9, 1009));
+    EXPECT_TRUE(batch.LookupDone());
+
+    // only the last lookup completes the batch
+    EXPECT_FALSE(batch.LookupDone());
+
+    ASSERT_TRUE(batch.getAccount(7) != NULL);
+    EXPECT_EQ(1007u, batch.getAccount(7)->mId);
+    EXPECT_TRUE(batch.getAccount(8) == NULL);
+    ASSERT_TRUE(batch.getAccount(9) != NULL);
+    EXPECT_EQ(1009u, batch.getAccount(9)->mId);
+
+    EXPECT_EQ(login_ids, batch.getLoginIds());
+}
+
+}
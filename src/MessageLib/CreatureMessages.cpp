@@ -1420,6 +1420,54 @@ void MessageLib::sendCurrentHitpointDeltasCreo6_Single(CreatureObject* creatureO
     _sendToInRange(mMessageFactory->EndMessage(),creatureObject,5);
 }
 
+//======================================================================================================================
+//
+// Creature Deltas Type 6
+// update: curent hitpoints, every bar set in barMask (bit n = bar n) in one list update
+//
+
+void MessageLib::sendCurrentHitpointDeltasCreo6_Bars(CreatureObject* creatureObject,uint32 barMask)
+{
+    Ham*	ham = creatureObject->getHam();
+
+    if(ham == NULL || !barMask)
+        return;
+
+    uint32 barCount = 0;
+    for(uint8 barIndex = 0; barIndex < 9; barIndex++)
+    {
+        if(barMask & (1 << barIndex))
+            barCount++;
+    }
+
+    mMessageFactory->StartMessage();
+    mMessageFactory->addUint32(opDeltasMessage);
+    mMessageFactory->addUint64(creatureObject->getId());
+    mMessageFactory->addUint32(opCREO);
+    mMessageFactory->addUint8(6);
+
+    mMessageFactory->addUint32(12 + (barCount * 7));
+    mMessageFactory->addUint16(1);
+    mMessageFactory->addUint16(13);
+
+    // the list counter advances once per changed bar
+    ham->advanceCurrentHitpointsUpdateCounter(barCount);
+    mMessageFactory->addUint32(barCount);
+    mMessageFactory->addUint32(ham->getCurrentHitpointsUpdateCounter());
+
+    for(uint8 barIndex = 0; barIndex < 9; barIndex++)
+    {
+        if(!(barMask & (1 << barIndex)))
+            continue;
+
+        mMessageFactory->addUint8(2);
+        mMessageFactory->addUint16(barIndex);
+        mMessageFactory->addInt32(ham->getPropertyValue(barIndex,HamProperty_CurrentHitpoints));
+    }
+
+    _sendToInRange(mMessageFactory->EndMessage(),creatureObject,5);
+}
+
 //======================================================================================================================
 //
 // Creature Deltas Type 6
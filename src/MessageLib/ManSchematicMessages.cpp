@@ -137,16 +137,18 @@ bool MessageLib::sendBaselinesMSCO_3(ManufacturingSchematic* manSchem,PlayerObje
             //=============================0
             // see whether the attribute has any component values which need adding in the preview
 
+            float attributeValue = 0.0f;
+            (*it).second.as(attributeValue);
+
             if(manSchem->hasPPAttribute(gWorldManager->getAttributeKey((*it).first)))
             {
-                float attributeValue = boost::lexical_cast<float,std::string>((*it).second);
                 float attributeAddValue = manSchem->getPPAttribute<float>(gWorldManager->getAttributeKey((*it).first));
                 DLOG(INFO) << "MessageLib::sendBaselinesMSCO_3 Attribute Add Value";
                 DLOG(INFO) << "MessageLib::sendBaselinesMSCO_3 we will add " << attributeAddValue << " to " << gWorldManager->getAttributeKey((*it).first).getAnsi();
                 mMessageFactory->addFloat(attributeValue+attributeAddValue);
             }
             else
-                mMessageFactory->addFloat(boost::lexical_cast<float,std::string>((*it).second));
+                mMessageFactory->addFloat(attributeValue);
 
             ++it;
         }
@@ -1163,14 +1165,16 @@ bool MessageLib::sendDeltasMSCO_3(ManufacturingSchematic* manSchem,PlayerObject*
 
         mMessageFactory->addString(gWorldManager->getAttributeKey((*it).first));
 
+        float attributeValue = 0.0f;
+        (*it).second.as(attributeValue);
+
         if(manSchem->hasPPAttribute(gWorldManager->getAttributeKey((*it).first)))
         {
-            float attributeValue = boost::lexical_cast<float,std::string>((*it).second);
             float attributeAddValue = manSchem->getPPAttribute<float>(gWorldManager->getAttributeKey((*it).first));
             mMessageFactory->addFloat(attributeValue+attributeAddValue);
         }
         else
-            mMessageFactory->addFloat(boost::lexical_cast<float,std::string>((*it).second));
+            mMessageFactory->addFloat(attributeValue);
 
         //mMessageFactory->addFloat(boost::lexical_cast<float,std::string>((*it).second));
 
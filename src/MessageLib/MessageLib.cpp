@@ -186,7 +186,10 @@ bool MessageLib::_checkDistance(const glm::vec3& mPosition1, Object* object, uin
 // broadcasts a message to all players in range of the given player
 // we use our registered playerlist here so it will be pretty fast :)
 void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object, unsigned char priority, bool to_self) {
-    gContainerManager->sendToRegisteredPlayers(object, [=] (PlayerObject* const recipient) {
+    std::vector<uint32> recipients;
+    DispatchClient* client = NULL;
+
+    gContainerManager->sendToRegisteredPlayers(object, [=, &recipients, &client] (PlayerObject* const recipient) {
         //thats something for debugmode only
         if(!_checkPlayer(recipient)) {
             //an invalid player at this point is like armageddon and Ultymas birthday combined at one time
@@ -196,11 +199,8 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
         }
 
         if(_checkDistance(recipient->mPosition, object, mMessageFactory->HeapWarningLevel())) {
-            // clone our message
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            recipient->getClient()->SendChannelAUnreliable(mMessageFactory->EndMessage(), recipient->getAccountId(), CR_Client, priority);
+            client = recipient->getClient();
+            recipients.push_back(recipient->getAccountId());
         }
     });
 
@@ -208,15 +208,12 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
         const PlayerObject* const player = dynamic_cast<const PlayerObject*>(object);
 
         if(_checkPlayer(player)) {
-            player->getClient()->SendChannelAUnreliable(message, player->getAccountId(), CR_Client, priority);
+            client = player->getClient();
+            recipients.push_back(player->getAccountId());
         }
-		else
-			mMessageFactory->DestroyMessage(message);
-    } else {
-        // If the message is sent to self then the process of sending destroys it
-        // otherwise we have to destroy it ourselves.
-        mMessageFactory->DestroyMessage(message);
     }
+
+    _sendMulticast(message, client, recipients, priority, true);
 }
 
 void MessageLib::_sendToInRangeUnreliableChat(Message* message, const CreatureObject* object, unsigned char priority, uint32_t crc) {
@@ -351,14 +348,15 @@ void MessageLib::_sendToInRange(Message* message, Object* const object, unsigned
     ObjectListType in_range_players;
 	mGrid->GetPlayerViewingRangeCellContents(object->getGridBucket(), &in_range_players);
 
-    std::for_each(in_range_players.begin(), in_range_players.end(), [=] (Object* object) {
+    std::vector<uint32> recipients;
+    recipients.reserve(in_range_players.size() + 1);
+    DispatchClient* client = NULL;
+
+    std::for_each(in_range_players.begin(), in_range_players.end(), [=, &recipients, &client] (Object* object) {
         PlayerObject* player = static_cast<PlayerObject*>(object);
         if(_checkPlayer(player)) {
-            // clone our message
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            player->getClient()->SendChannelA(mMessageFactory->EndMessage(), player->getAccountId(), CR_Client, priority);
+            client = player->getClient();
+            recipients.push_back(player->getAccountId());
         }
     });
 
@@ -366,15 +364,12 @@ void MessageLib::_sendToInRange(Message* message, Object* const object, unsigned
         const PlayerObject* const player = dynamic_cast<const PlayerObject*>(object);
 
         if(_checkPlayer(player)) {
-            player->getClient()->SendChannelA(message, player->getAccountId(), CR_Client, priority);
+            client = player->getClient();
+            recipients.push_back(player->getAccountId());
         }
-		else
-			mMessageFactory->DestroyMessage(message);
-    } else {
-        // If the message is sent to self then the process of sending destroys it
-        // otherwise we have to destroy it ourselves.
-        mMessageFactory->DestroyMessage(message);
     }
+
+    _sendMulticast(message, client, recipients, priority);
 }
 
 //======================================================================================================================
@@ -392,18 +387,19 @@ void MessageLib::_sendToInstancedPlayers(Message* message, unsigned char priorit
     ObjectListType in_range_players;
     mGrid->GetPlayerViewingRangeCellContents(mGrid->getCellId(position.x, position.z), &in_range_players);
 
-    std::for_each(in_range_players.begin(), in_range_players.end(), [=] (Object* object) {
+    std::vector<uint32> recipients;
+    recipients.reserve(in_range_players.size());
+    DispatchClient* client = NULL;
+
+    std::for_each(in_range_players.begin(), in_range_players.end(), [=, &recipients, &client] (Object* object) {
         PlayerObject* player = dynamic_cast<PlayerObject*>(object);
         if (_checkPlayer(player)) {
-            // Clone the message.
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            (player->getClient())->SendChannelA(mMessageFactory->EndMessage(), player->getAccountId(), CR_Client, priority);
+            client = player->getClient();
+            recipients.push_back(player->getAccountId());
         }
     });
 
-    mMessageFactory->DestroyMessage(message);
+    _sendMulticast(message, client, recipients, priority);
 }
 //======================================================================================================================
 //
@@ -420,7 +416,11 @@ void MessageLib::_sendToInstancedPlayersUnreliable(Message* message, unsigned ch
     ObjectListType in_range_players;
 	mGrid->GetPlayerViewingRangeCellContents(player->getGridBucket(), &in_range_players);
 
-    std::for_each(in_range_players.begin(), in_range_players.end(), [=] (Object* object) {
+    std::vector<uint32> recipients;
+    recipients.reserve(in_range_players.size());
+    DispatchClient* client = NULL;
+
+    std::for_each(in_range_players.begin(), in_range_players.end(), [=, &recipients, &client] (Object* object) {
         PlayerObject* in_range_player = static_cast<PlayerObject*>(object);
 
         if((player->getGroupId() != 0) && (in_range_player->getGroupId() != player->getGroupId())) {
@@ -429,17 +429,12 @@ void MessageLib::_sendToInstancedPlayersUnreliable(Message* message, unsigned ch
         }
 
         if (_checkPlayer(in_range_player)) {
-            // Clone the message.
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            in_range_player->getClient()->SendChannelAUnreliable(
-                mMessageFactory->EndMessage(),
-                in_range_player->getAccountId(), CR_Client, priority);
+            client = in_range_player->getClient();
+            recipients.push_back(in_range_player->getAccountId());
         }
     });
 
-    mMessageFactory->DestroyMessage(message);
+    _sendMulticast(message, client, recipients, priority, true);
 }
 
 //======================================================================================================================
@@ -449,26 +444,33 @@ void MessageLib::_sendToInstancedPlayersUnreliable(Message* message, unsigned ch
 void MessageLib::_sendToAll(Message* message, unsigned char priority, bool unreliable) const {
     const PlayerAccMap* const players = gWorldManager->getPlayerAccMap();
 
-    std::for_each(players->begin(), players->end(), [=] (const std::pair<uint32_t, const PlayerObject*>& element) {
+    std::vector<uint32> recipients;
+    recipients.reserve(players->size());
+    DispatchClient* client = NULL;
+
+    std::for_each(players->begin(), players->end(), [=, &recipients, &client] (const std::pair<uint32_t, const PlayerObject*>& element) {
         const PlayerObject* const player = element.second;
 
         if(_checkPlayer(player)) {
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            if(unreliable) {
-                player->getClient()->SendChannelAUnreliable(
-                    mMessageFactory->EndMessage(),
-                    player->getAccountId(), CR_Client, priority);
-            } else {
-                player->getClient()->SendChannelA(
-                    mMessageFactory->EndMessage(),
-                    player->getAccountId(), CR_Client, priority);
-            }
+            client = player->getClient();
+            recipients.push_back(player->getAccountId());
         }
     });
 
-    mMessageFactory->DestroyMessage(message);
+    _sendMulticast(message, client, recipients, priority, unreliable);
+}
+
+//======================================================================================================================
+//
+// All zone clients share the session to the connectionserver, so any of them can carry the envelope.
+//
+void MessageLib::_sendMulticast(Message* message, DispatchClient* client, const std::vector<uint32>& accountIds, unsigned char priority, bool unreliable) const {
+    if(!client || accountIds.empty()) {
+        mMessageFactory->DestroyMessage(message);
+        return;
+    }
+
+    client->SendChannelAMulticast(message, accountIds, priority, unreliable);
 }
 
 
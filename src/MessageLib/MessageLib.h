@@ -430,6 +430,7 @@ public:
     void				sendBaseHitpointDeltasCreo1_Single(CreatureObject* creatureObject,uint8 barIndex);
 
     void				sendCurrentHitpointDeltasCreo6_Single(CreatureObject* creatureObject,uint8 barIndex);
+    void				sendCurrentHitpointDeltasCreo6_Bars(CreatureObject* creatureObject,uint32 barMask);
     void				sendCurrentHitpointDeltasCreo6_Full(CreatureObject* creatureObject);
     void				sendWoundUpdateCreo3(CreatureObject* creatureObject,uint8 barIndex);
     void				sendBFUpdateCreo3(CreatureObject* playerObject);
@@ -674,6 +675,9 @@ private:
 	void				_sendToInstancedPlayersUnreliable(Message* message, unsigned char priority, const PlayerObject* const player) const;
 	void				_sendToInstancedPlayers(Message* message, unsigned char priority, PlayerObject* const player) const;
 	void				_sendToAll(Message* message, unsigned char priority, bool unreliable = false) const;
+
+	// hands the message to the connectionserver once for all accounts instead of cloning it per recipient
+	void				_sendMulticast(Message* message, DispatchClient* client, const std::vector<uint32>& accountIds, unsigned char priority, bool unreliable = false) const;
    
     /**
      * Sends a spatial message to in-range players.
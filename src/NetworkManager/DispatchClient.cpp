@@ -28,8 +28,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //#include <WINSOCK2.h>
 #include "DispatchClient.h"
 #include "Message.h"
+#include "MessageFactory.h"
+#include "MessageOpcodes.h"
+#include "MulticastEnvelope.h"
 #include "NetworkManager/Session.h"
 
+#include <algorithm>
+
+
+const uint32 DispatchClient::MaxMulticastRecipients;
 
 //======================================================================================================================
 
@@ -53,3 +60,30 @@ void DispatchClient::SendChannelAUnreliable(Message* message, uint32 accountId,
 
 //======================================================================================================================
 
+void DispatchClient::SendChannelAMulticast(Message* message, const std::vector<uint32>& accountIds, uint8 priority, bool unreliable)
+{
+    uint32 sent = 0;
+
+    while(sent < accountIds.size())
+    {
+        uint32 count = std::min<uint32>(static_cast<uint32>(accountIds.size()) - sent, MaxMulticastRecipients);
+
+        Message* envelope = MulticastEnvelope::Build(message, &accountIds[sent], static_cast<uint16>(count), priority, unreliable);
+
+        if(unreliable)
+        {
+            SendChannelAUnreliable(envelope, 0, CR_Connection, priority);
+        }
+        else
+        {
+            SendChannelA(envelope, 0, CR_Connection, priority);
+        }
+
+        sent += count;
+    }
+
+    gMessageFactory->DestroyMessage(message);
+}
+
+//======================================================================================================================
+
@@ -31,6 +31,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/NetworkClient.h"
 #include "Utils/typedefs.h"
 
+#include <vector>
+
 
 //======================================================================================================================
 
@@ -40,6 +42,15 @@ public:
 
     virtual void	SendChannelA(Message* message, uint32 accountId, uint8 serverId, uint8 priority);
     virtual void	SendChannelAUnreliable(Message* message, uint32 accountId, uint8 serverId, uint8 priority);
+
+    // Sends the same message to every account in accountIds. The payload crosses the link to the connectionserver
+    // once, wrapped in an opClusterMulticast envelope, and is fanned out to the client sessions there.
+    // Takes ownership of message. Any client sharing the session to the connectionserver can be used to send.
+    void			SendChannelAMulticast(Message* message, const std::vector<uint32>& accountIds, uint8 priority, bool unreliable = false);
+
+    // recipients per envelope, larger lists get split so the envelope stays well inside a message
+    static const uint32 MaxMulticastRecipients = 512;
+
     void			setAccountId(uint32 id) {
         mAccountId = id;
     };
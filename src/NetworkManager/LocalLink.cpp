@@ -0,0 +1,535 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "LocalLink.h"
+
+#include <glog/logging.h>
+
+#include "MessageFactory.h"
+
+#include "NetworkManager/Message.h"
+
+#include "Utils/clock.h"
+
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <cstring>
+
+#if defined(MSG_NOSIGNAL)
+#define LOCALLINK_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define LOCALLINK_SEND_FLAGS 0
+#endif
+
+//======================================================================================================================
+
+// room for two full frames, so a frame split by the kernel can always be completed
+static const uint32 kReadBufferSize = 2 * (LocalLink::HeaderSize + 0xffff);
+
+//======================================================================================================================
+
+LocalLink::LocalLink(int socket, Session* session, int wakeSocket) :
+    mOutgoingOffset(0),
+    mSession(session),
+    mReadBuffer(0),
+    mReadStart(0),
+    mReadEnd(0),
+    mCloseTime(0),
+    mSocket(socket),
+    mWakeSocket(wakeSocket),
+    mClosed(false),
+    mShutdown(false),
+    mReadError(false),
+    mDead(false)
+{
+    mReadBuffer = new int8[kReadBufferSize];
+
+    SetNonBlocking(mSocket);
+}
+
+//======================================================================================================================
+
+LocalLink::~LocalLink()
+{
+    CloseSocket(mSocket);
+
+    delete [] mReadBuffer;
+}
+
+//======================================================================================================================
+
+bool LocalLink::isSupported()
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    return true;
+#else
+    return false;
+#endif
+}
+
+//======================================================================================================================
+
+int LocalLink::Connect(const std::string& path, uint32 address, uint16 port)
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    sockaddr_un remote;
+    if(path.size() >= sizeof(remote.sun_path))
+    {
+        LOG(WARNING) << "Local transport path too long: " << path;
+        return -1;
+    }
+
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(s < 0)
+    {
+        return -1;
+    }
+
+    memset(&remote, 0, sizeof(remote));
+    remote.sun_family = AF_UNIX;
+    strcpy(remote.sun_path, path.c_str());
+
+    // non blocking, a listener whose backlog is full fails the connect and we stay on udp instead of hanging
+    if(!SetNonBlocking(s) || connect(s, (sockaddr*)&remote, sizeof(remote)) != 0)
+    {
+        LOG(WARNING) << "Local transport connect to " << path << " failed: " << strerror(errno);
+        close(s);
+        return -1;
+    }
+
+    // handshake, address and port are kept in network order just like an udp session sees them
+    int8 handshake[HandshakeSize];
+    memset(handshake, 0, sizeof(handshake));
+    memcpy(handshake, &address, 4);
+    memcpy(handshake + 4, &port, 2);
+
+    // fits any socket buffer of a fresh connection, a short write means the link is unusable anyway
+    if(send(s, handshake, sizeof(handshake), LOCALLINK_SEND_FLAGS) != sizeof(handshake))
+    {
+        close(s);
+        return -1;
+    }
+
+    return s;
+#else
+    return -1;
+#endif
+}
+
+//======================================================================================================================
+
+int LocalLink::Listen(const std::string& path)
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    sockaddr_un local;
+    if(path.size() >= sizeof(local.sun_path))
+    {
+        LOG(WARNING) << "Local transport path too long: " << path;
+        return -1;
+    }
+
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(s < 0)
+    {
+        return -1;
+    }
+
+    memset(&local, 0, sizeof(local));
+    local.sun_family = AF_UNIX;
+    strcpy(local.sun_path, path.c_str());
+
+    // a stale socket file from a previous run would make bind fail
+    unlink(path.c_str());
+
+    if((bind(s, (sockaddr*)&local, sizeof(local)) != 0) || (listen(s, 16) != 0) || !SetNonBlocking(s))
+    {
+        LOG(WARNING) << "Local transport listen on " << path << " failed: " << strerror(errno);
+        close(s);
+        return -1;
+    }
+
+    return s;
+#else
+    return -1;
+#endif
+}
+
+//======================================================================================================================
+
+int LocalLink::Accept(int listenSocket)
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    while(true)
+    {
+        int s = accept(listenSocket, 0, 0);
+
+        if(s < 0 && errno == EINTR)
+            continue;
+
+        if(s >= 0 && !SetNonBlocking(s))
+        {
+            close(s);
+            continue;
+        }
+
+        return s;
+    }
+#else
+    return -1;
+#endif
+}
+
+//======================================================================================================================
+
+int LocalLink::ReadHandshake(int socket, int8* handshake, uint32& received, uint32& address, uint16& port)
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    while(received < HandshakeSize)
+    {
+        ssize_t r = recv(socket, handshake + received, HandshakeSize - received, 0);
+
+        if(r < 0 && errno == EINTR)
+            continue;
+
+        if(r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+
+        if(r <= 0)
+            return -1;
+
+        received += r;
+    }
+
+    memcpy(&address, handshake, 4);
+    memcpy(&port, handshake + 4, 2);
+
+    return 1;
+#else
+    return -1;
+#endif
+}
+
+//======================================================================================================================
+
+void LocalLink::CloseSocket(int socket)
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    if(socket >= 0)
+    {
+        shutdown(socket, SHUT_RDWR);
+        close(socket);
+    }
+#endif
+}
+
+//======================================================================================================================
+
+bool LocalLink::SetNonBlocking(int socket)
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    int flags = fcntl(socket, F_GETFL, 0);
+
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+#else
+    return false;
+#endif
+}
+
+//======================================================================================================================
+
+bool LocalLink::Send(Message* message)
+{
+    if(mClosed)
+    {
+        return false;
+    }
+
+    uint32 size = message->getSize();
+    uint32 accountId = message->getAccountId();
+
+    boost::mutex::scoped_lock lk(mWriteMutex);
+
+    if(mOutgoing.size() - mOutgoingOffset + HeaderSize + size > MaxPendingOutput)
+    {
+        lk.unlock();
+
+        LOG(WARNING) << "Local transport peer stopped reading, dropping link";
+        Shutdown();
+        return false;
+    }
+
+    bool idle = (mOutgoingOffset == mOutgoing.size());
+
+    size_t frame = mOutgoing.size();
+    mOutgoing.resize(frame + HeaderSize + size);
+
+    int8* header = &mOutgoing[frame];
+    memcpy(header, &size, 4);
+    header[4] = message->getPriority();
+    header[5] = message->getRouted() ? 1 : 0;
+    header[6] = message->getDestinationId();
+    header[7] = message->getFastpath() ? 1 : 0;
+    memcpy(header + 8, &accountId, 4);
+    memcpy(header + HeaderSize, message->getData(), size);
+
+    // with output already queued the reading thread is polling for writability and writes this one as well
+    if(!idle)
+    {
+        return true;
+    }
+
+    if(!_write())
+    {
+        lk.unlock();
+
+        Shutdown();
+        return false;
+    }
+
+    if(mOutgoingOffset != mOutgoing.size())
+    {
+        _wake();
+    }
+
+    return true;
+}
+
+//======================================================================================================================
+
+bool LocalLink::Flush()
+{
+    boost::mutex::scoped_lock lk(mWriteMutex);
+
+    return _write();
+}
+
+//======================================================================================================================
+
+bool LocalLink::hasPendingOutput()
+{
+    boost::mutex::scoped_lock lk(mWriteMutex);
+
+    return mOutgoingOffset != mOutgoing.size();
+}
+
+//======================================================================================================================
+
+void LocalLink::Close()
+{
+    if(mClosed)
+    {
+        return;
+    }
+
+    mCloseTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+    mClosed = true;
+
+    // the reading thread shuts the socket down once the queued output is written
+    _wake();
+}
+
+//======================================================================================================================
+
+void LocalLink::Shutdown()
+{
+    mClosed = true;
+
+    if(mShutdown)
+    {
+        return;
+    }
+
+    mShutdown = true;
+
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    // wakes up the reading thread, the socket itself is closed in the destructor
+    shutdown(mSocket, SHUT_RDWR);
+#endif
+}
+
+//======================================================================================================================
+
+bool LocalLink::Fill()
+{
+    if(mReadError)
+    {
+        return false;
+    }
+
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    if(mReadStart)
+    {
+        memmove(mReadBuffer, mReadBuffer + mReadStart, mReadEnd - mReadStart);
+        mReadEnd -= mReadStart;
+        mReadStart = 0;
+    }
+
+    while(mReadEnd < kReadBufferSize)
+    {
+        ssize_t r = recv(mSocket, mReadBuffer + mReadEnd, kReadBufferSize - mReadEnd, 0);
+
+        if(r < 0 && errno == EINTR)
+            continue;
+
+        if(r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+
+        if(r <= 0)
+            return false;
+
+        mReadEnd += r;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+//======================================================================================================================
+
+bool LocalLink::hasPendingFrame() const
+{
+    if(mReadError || mReadEnd - mReadStart < HeaderSize)
+    {
+        return false;
+    }
+
+    uint32 size;
+    memcpy(&size, mReadBuffer + mReadStart, 4);
+
+    return size <= 0xffff && mReadEnd - mReadStart >= HeaderSize + size;
+}
+
+//======================================================================================================================
+
+bool LocalLink::NextMessage(MessageFactory* factory, Message*& message)
+{
+    if(mReadError || mReadEnd - mReadStart < HeaderSize)
+    {
+        return false;
+    }
+
+    int8* header = mReadBuffer + mReadStart;
+
+    uint32 size;
+    uint32 accountId;
+
+    memcpy(&size, header, 4);
+    memcpy(&accountId, header + 8, 4);
+
+    if(size > 0xffff)
+    {
+        LOG(WARNING) << "Local transport frame of " << size << " bytes, dropping link";
+
+        mReadError = true;
+        return false;
+    }
+
+    if(mReadEnd - mReadStart < HeaderSize + size)
+    {
+        return false;
+    }
+
+    factory->StartMessage();
+    factory->addData(header + HeaderSize, static_cast<uint16>(size));
+    message = factory->EndMessage();
+
+    message->setPriority(static_cast<uint8>(header[4]));
+    message->setRouted(header[5] != 0);
+    message->setDestinationId(static_cast<uint8>(header[6]));
+    message->setFastpath(header[7] != 0);
+    message->setAccountId(accountId);
+
+    mReadStart += HeaderSize + size;
+
+    return true;
+}
+
+
+//======================================================================================================================
+
+bool LocalLink::_write()
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    while(mOutgoingOffset < mOutgoing.size())
+    {
+        ssize_t r = send(mSocket, &mOutgoing[mOutgoingOffset], mOutgoing.size() - mOutgoingOffset, LOCALLINK_SEND_FLAGS);
+
+        if(r < 0 && errno == EINTR)
+            continue;
+
+        if(r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        if(r <= 0)
+            return false;
+
+        mOutgoingOffset += r;
+    }
+
+    // keep the buffer, it is reused for the next burst
+    if(mOutgoingOffset == mOutgoing.size())
+    {
+        mOutgoing.clear();
+        mOutgoingOffset = 0;
+    }
+    else if(mOutgoingOffset > mOutgoing.size() / 2)
+    {
+        mOutgoing.erase(mOutgoing.begin(), mOutgoing.begin() + mOutgoingOffset);
+        mOutgoingOffset = 0;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+//======================================================================================================================
+
+void LocalLink::_wake()
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    if(mWakeSocket >= 0)
+    {
+        // a full pipe already has the thread awake, so a failed write is fine
+        int8 wake = 0;
+        ssize_t r = write(mWakeSocket, &wake, 1);
+        (void)r;
+    }
+#endif
+}
+
+//======================================================================================================================
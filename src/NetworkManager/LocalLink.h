@@ -0,0 +1,158 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_NETWORKMANAGER_LOCALLINK_H
+#define ANH_NETWORKMANAGER_LOCALLINK_H
+
+#include "Utils/typedefs.h"
+#include <boost/thread/mutex.hpp>
+#include <string>
+#include <vector>
+
+//======================================================================================================================
+
+class MessageFactory;
+class Message;
+class Session;
+
+//======================================================================================================================
+//
+// Stream link between two server processes on the same host.
+//
+// Backend servers running next to the connectionserver can talk to it over a unix domain socket instead of the
+// udp session layer. The kernel already guarantees ordered, lossless delivery there, so messages are written as
+// a small frame (routing header + payload) - there is no packetizing, compression, crc, sequencing or resending
+// involved.
+//
+// The socket never blocks. Send writes what the kernel takes right away and queues the rest, the LocalLinkThread
+// of the owning service writes the queue once the peer reads again and reads incoming frames. Two servers sending
+// to each other while neither reads can so never stall their main loops.
+//
+// Only available on posix platforms, on windows isSupported() returns false and the udp path is used.
+//
+
+class LocalLink
+{
+public:
+
+    // frame header: size(4) priority(1) routed(1) destination(1) fastpath(1) accountId(4)
+    static const uint32 HeaderSize = 12;
+
+    // handshake: address(4) port(2) padding(2)
+    static const uint32 HandshakeSize = 8;
+
+    // a peer that leaves this much of our output unread is considered hung and the link is dropped
+    static const uint32 MaxPendingOutput = 32 * 1024 * 1024;
+
+    // wakeSocket is written to whenever output got queued, so the reading thread starts polling for writability
+    LocalLink(int socket, Session* session, int wakeSocket);
+    ~LocalLink();
+
+    static bool         isSupported();
+
+    // connects to a listening local link, sending our service address and port as handshake. Fails instead of
+    // waiting when the listener is not accepting
+    static int          Connect(const std::string& path, uint32 address, uint16 port);
+    static int          Listen(const std::string& path);
+    // accepts the next waiting link, -1 when there is none. Its handshake is read by ReadHandshake
+    static int          Accept(int listenSocket);
+    // reads the handshake of an accepted link as far as it arrived
+    // returns 1 once complete, 0 when more has to arrive and -1 when the link went down
+    static int          ReadHandshake(int socket, int8* handshake, uint32& received, uint32& address, uint16& port);
+    static void         CloseSocket(int socket);
+    static bool         SetNonBlocking(int socket);
+
+    // queues the message, false when the link is down
+    bool                Send(Message* message);
+
+    // writes queued output as far as the socket takes it, false when the link broke
+    bool                Flush();
+    bool                hasPendingOutput();
+
+    // reads what arrived so far, false when the link went down or sent a broken frame
+    bool                Fill();
+    // takes the next complete frame read by Fill, false when there is none
+    bool                NextMessage(MessageFactory* factory, Message*& message);
+    bool                hasPendingFrame() const;
+    bool                hasReadError() const {
+        return mReadError;
+    }
+
+    // refuses further sends, the reading thread writes the queued output and shuts the socket down afterwards
+    void                Close();
+    // shuts the socket down, the reading thread then reports the session as disconnecting
+    void                Shutdown();
+
+    Session*            getSession() {
+        return mSession;
+    }
+    int                 getSocket() {
+        return mSocket;
+    }
+    bool                isClosed() {
+        return mClosed;
+    }
+    bool                isShutdown() {
+        return mShutdown;
+    }
+    uint64              getCloseTime() {
+        return mCloseTime;
+    }
+    bool                isDead() {
+        return mDead;
+    }
+    void                setDead() {
+        mDead = true;
+    }
+
+private:
+
+    bool                _write();
+    void                _wake();
+
+    boost::mutex        mWriteMutex;
+
+    std::vector<int8>   mOutgoing;
+    uint32              mOutgoingOffset;
+
+    Session*            mSession;
+    int8*               mReadBuffer;
+    uint32              mReadStart;
+    uint32              mReadEnd;
+    uint64              mCloseTime;
+    int                 mSocket;
+    int                 mWakeSocket;
+    bool volatile       mClosed;
+    bool volatile       mShutdown;
+    bool                mReadError;
+    bool                mDead;      // disconnect got reported, only touched by the reading thread
+};
+
+//======================================================================================================================
+
+#endif //ANH_NETWORKMANAGER_LOCALLINK_H
@@ -0,0 +1,463 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "LocalLinkThread.h"
+
+#include <glog/logging.h>
+
+#include "LocalLink.h"
+#include "MessageFactory.h"
+#include "Service.h"
+#include "Session.h"
+
+#include "NetworkManager/Message.h"
+
+#include "Utils/clock.h"
+
+#if defined(__GNUC__)
+// GCC implements tr1 in the <tr1/*> headers. This does not conform to the TR1
+// spec, which requires the header without the tr1/ prefix.
+#include <tr1/functional>
+#else
+#include <functional>
+#endif
+
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+//======================================================================================================================
+
+// frames handled per link before the other links get their turn
+static const uint32 kMaxFramesPerRead = 64;
+
+// an accepted link that did not send its handshake within this many ms is dropped
+static const uint64 kHandshakeTimeout = 5000;
+
+// a closed link gets this many ms to write its queued output before it is shut down regardless
+static const uint64 kCloseTimeout = 5000;
+
+//======================================================================================================================
+
+LocalLinkThread::LocalLinkThread(Service* service, uint32 mfHeapSize) :
+    mService(service),
+    mMessageFactory(0),
+    mListenSocket(-1),
+    mExit(false)
+{
+    mWakeSockets[0] = -1;
+    mWakeSockets[1] = -1;
+
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    if(pipe(mWakeSockets) != 0 || !LocalLink::SetNonBlocking(mWakeSockets[0]) || !LocalLink::SetNonBlocking(mWakeSockets[1]))
+    {
+        LOG(WARNING) << "Service " << service->getId() << ": local link wake pipe failed, queued output waits for the next poll";
+    }
+#endif
+
+    mMessageFactory = new MessageFactory(mfHeapSize, service->getId());
+
+    boost::thread t(std::tr1::bind(&LocalLinkThread::run, this));
+    mThread = boost::move(t);
+}
+
+//======================================================================================================================
+
+LocalLinkThread::~LocalLinkThread()
+{
+    mExit = true;
+
+    mThread.interrupt();
+    mThread.join();
+
+    if(mListenSocket >= 0)
+    {
+        LocalLink::CloseSocket(mListenSocket);
+
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+        unlink(mPath.c_str());
+#endif
+    }
+
+    for(PendingLocalLinkList::iterator it = mPendingLinks.begin(); it != mPendingLinks.end(); ++it)
+    {
+        LocalLink::CloseSocket(it->mSocket);
+    }
+
+    while(!mLinks.empty())
+    {
+        DestroySession(mLinks.front()->getSession());
+    }
+
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    for(uint32 i = 0; i < 2; i++)
+    {
+        if(mWakeSockets[i] >= 0)
+            close(mWakeSockets[i]);
+    }
+#endif
+
+    delete mMessageFactory;
+}
+
+//======================================================================================================================
+
+bool LocalLinkThread::Listen(const std::string& path)
+{
+    int s = LocalLink::Listen(path);
+
+    if(s < 0)
+    {
+        return false;
+    }
+
+    mPath = path;
+
+    boost::mutex::scoped_lock lk(mLinkMutex);
+    mListenSocket = s;
+
+    return true;
+}
+
+//======================================================================================================================
+
+Session* LocalLinkThread::Connect(const std::string& path, uint32 address, uint16 port)
+{
+    int s = LocalLink::Connect(path, address, port);
+
+    if(s < 0)
+    {
+        return 0;
+    }
+
+    // the peer sends nothing back, the link is usable as soon as the socket connected
+    Session* session = _createSession(s, 0, 0);
+    session->setStatus(SSTAT_Connected);
+
+    return session;
+}
+
+//======================================================================================================================
+
+void LocalLinkThread::DestroySession(Session* session)
+{
+    LocalLink* link = session->getLocalLink();
+
+    boost::mutex::scoped_lock lk(mLinkMutex);
+    mLinks.remove(link);
+    lk.unlock();
+
+    delete link;
+
+    session->setLocalLink(0);
+    delete session;
+}
+
+//======================================================================================================================
+
+void LocalLinkThread::run()
+{
+#if(ANH_PLATFORM != ANH_PLATFORM_WIN32)
+    std::vector<pollfd>		fds;
+    std::vector<LocalLink*>	polled;
+    std::vector<LocalLink*>	buffered;
+
+    while(!mExit)
+    {
+        uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+        // the stream cant drop messages like udp does, so rather hold the senders back than overrun our heap.
+        // Our own output keeps flowing meanwhile, the peer may well wait for it to free its own heap
+        bool reading = mMessageFactory->getHeapsize() < 95.0;
+
+        if(!reading)
+        {
+            mMessageFactory->Process();
+        }
+
+        fds.clear();
+        polled.clear();
+        buffered.clear();
+
+        pollfd wake = {mWakeSockets[0], POLLIN, 0};
+        fds.push_back(wake);
+
+        for(PendingLocalLinkList::iterator it = mPendingLinks.begin(); it != mPendingLinks.end();)
+        {
+            if(now - it->mAcceptTime > kHandshakeTimeout)
+            {
+                LOG(WARNING) << "Service " << mService->getId() << ": local link sent no handshake within " << kHandshakeTimeout << "ms, dropping it";
+
+                LocalLink::CloseSocket(it->mSocket);
+                it = mPendingLinks.erase(it);
+                continue;
+            }
+
+            pollfd pfd = {it->mSocket, POLLIN, 0};
+            fds.push_back(pfd);
+            ++it;
+        }
+
+        uint32 pendingCount = mPendingLinks.size();
+
+        boost::mutex::scoped_lock lk(mLinkMutex);
+
+        bool listening = mListenSocket >= 0;
+
+        if(listening)
+        {
+            pollfd pfd = {mListenSocket, POLLIN, 0};
+            fds.push_back(pfd);
+        }
+
+        uint32 firstLink = fds.size();
+
+        for(LocalLinkList::iterator it = mLinks.begin(); it != mLinks.end(); ++it)
+        {
+            LocalLink* link = *it;
+
+            if(link->isDead())
+                continue;
+
+            bool output = link->hasPendingOutput();
+
+            // a closed link writes its queued output first, but a peer that stopped reading doesnt hold it up forever
+            if(link->isClosed() && !link->isShutdown() && (!output || now - link->getCloseTime() > kCloseTimeout))
+            {
+                link->Shutdown();
+            }
+
+            short events = 0;
+
+            if(reading)
+                events |= POLLIN;
+
+            if(output && !link->isShutdown())
+                events |= POLLOUT;
+
+            if(!events)
+                continue;
+
+            if(reading && link->hasPendingFrame())
+                buffered.push_back(link);
+
+            pollfd pfd = {link->getSocket(), events, 0};
+            fds.push_back(pfd);
+            polled.push_back(link);
+        }
+
+        lk.unlock();
+
+        // links connected from our side are only picked up here, so dont wait too long
+        int timeout = !buffered.empty() ? 0 : (reading ? 100 : 1);
+
+        if(poll(&fds[0], fds.size(), timeout) < 0)
+        {
+            continue;
+        }
+
+        if(fds[0].revents)
+        {
+            int8 drain[64];
+            while(read(mWakeSockets[0], drain, sizeof(drain)) > 0);
+        }
+
+        // links accepted this round are appended, so only the polled ones are looked at
+        PendingLocalLinkList::iterator pending = mPendingLinks.begin();
+
+        for(uint32 i = 0; i < pendingCount; i++)
+        {
+            if(fds[1 + i].revents && _readHandshake(*pending))
+                pending = mPendingLinks.erase(pending);
+            else
+                ++pending;
+        }
+
+        if(listening && fds[1 + pendingCount].revents)
+        {
+            _acceptLinks();
+        }
+
+        for(uint32 i = firstLink; i < fds.size(); i++)
+        {
+            LocalLink* link = polled[i - firstLink];
+
+            if(fds[i].revents & POLLOUT)
+                _writeLink(link);
+
+            if(reading && (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                _readLink(link);
+        }
+
+        // frames left over from the last read because the per link limit was reached
+        for(uint32 i = 0; i < buffered.size(); i++)
+        {
+            _readLink(buffered[i]);
+        }
+    }
+#endif
+}
+
+//======================================================================================================================
+
+Session* LocalLinkThread::_createSession(int socket, uint32 address, uint16 port)
+{
+    Session* session = new Session();
+
+    session->setService(mService);
+    session->setMessageFactory(mMessageFactory);
+    session->setAddress(address);
+    session->setPort(port);
+
+    LocalLink* link = new LocalLink(socket, session, mWakeSockets[1]);
+    session->setLocalLink(link);
+
+    boost::mutex::scoped_lock lk(mLinkMutex);
+    mLinks.push_back(link);
+
+    return session;
+}
+
+//======================================================================================================================
+
+void LocalLinkThread::_acceptLinks()
+{
+    while(true)
+    {
+        int s = LocalLink::Accept(mListenSocket);
+
+        if(s < 0)
+        {
+            return;
+        }
+
+        PendingLocalLink pending;
+        pending.mAcceptTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+        pending.mSocket = s;
+        pending.mReceived = 0;
+
+        // the handshake usually arrived together with the connect
+        if(!_readHandshake(pending))
+        {
+            mPendingLinks.push_back(pending);
+        }
+    }
+}
+
+//======================================================================================================================
+
+bool LocalLinkThread::_readHandshake(PendingLocalLink& pending)
+{
+    uint32 address;
+    uint16 port;
+
+    int result = LocalLink::ReadHandshake(pending.mSocket, pending.mHandshake, pending.mReceived, address, port);
+
+    if(result == 0)
+    {
+        return false;
+    }
+
+    if(result < 0)
+    {
+        LocalLink::CloseSocket(pending.mSocket);
+        return true;
+    }
+
+    // the peer sent the address and port of its udp service, so the server lookup works just like for udp
+    Session* session = _createSession(pending.mSocket, address, port);
+    session->setStatus(SSTAT_Connecting);
+
+    LOG(INFO) << "Service " << mService->getId() << ": new local link from " << session->getAddressString() << ":" << session->getPortHost();
+
+    mService->AddSessionToProcessQueue(session);
+
+    return true;
+}
+
+//======================================================================================================================
+
+void LocalLinkThread::_readLink(LocalLink* link)
+{
+    // the service may have destroyed the session meanwhile
+    boost::mutex::scoped_lock lk(mLinkMutex);
+
+    if(link->isDead() || std::find(mLinks.begin(), mLinks.end(), link) == mLinks.end())
+    {
+        return;
+    }
+
+    Session* session = link->getSession();
+
+    bool alive = link->Fill();
+
+    for(uint32 i = 0; i < kMaxFramesPerRead && mMessageFactory->getHeapsize() < 95.0; i++)
+    {
+        Message* message = 0;
+
+        if(!link->NextMessage(mMessageFactory, message))
+            break;
+
+        session->_addIncomingMessage(message, message->getPriority());
+    }
+
+    // frames that arrived before the link went down are handed on first
+    if((!alive || link->hasReadError()) && !link->hasPendingFrame())
+    {
+        // let the service run the disconnect callbacks, it destroys the session afterwards
+        link->setDead();
+
+        session->setStatus(SSTAT_Disconnecting);
+        mService->AddSessionToProcessQueue(session);
+    }
+}
+
+//======================================================================================================================
+
+void LocalLinkThread::_writeLink(LocalLink* link)
+{
+    boost::mutex::scoped_lock lk(mLinkMutex);
+
+    if(link->isDead() || std::find(mLinks.begin(), mLinks.end(), link) == mLinks.end())
+    {
+        return;
+    }
+
+    // the peer is gone, reading the link reports it
+    if(!link->Flush())
+    {
+        link->Shutdown();
+    }
+}
+
+//======================================================================================================================
@@ -0,0 +1,110 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_NETWORKMANAGER_LOCALLINKTHREAD_H
+#define ANH_NETWORKMANAGER_LOCALLINKTHREAD_H
+
+#include "Utils/typedefs.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <list>
+#include <string>
+
+//======================================================================================================================
+
+class LocalLink;
+class MessageFactory;
+class Service;
+class Session;
+
+typedef std::list<LocalLink*>	LocalLinkList;
+
+//======================================================================================================================
+
+// an accepted link whose handshake did not arrive completely yet
+class PendingLocalLink
+{
+public:
+    uint64				mAcceptTime;
+    int					mSocket;
+    uint32				mReceived;
+    int8				mHandshake[8];
+};
+
+typedef std::list<PendingLocalLink>	PendingLocalLinkList;
+
+//======================================================================================================================
+//
+// Reads all local links of a service and writes the output they queued, the local counterpart of the
+// SocketReadThread and SocketWriteThread. Owns the message heap incoming messages are built on, so messages stay
+// valid after their link is gone.
+//
+
+class LocalLinkThread
+{
+public:
+
+    LocalLinkThread(Service* service, uint32 mfHeapSize);
+    ~LocalLinkThread();
+
+    void				run();
+
+    // accepts links from other processes, they are handed to the service as connecting sessions
+    bool				Listen(const std::string& path);
+
+    // returns a connected session or 0 if nobody listens on path
+    Session*			Connect(const std::string& path, uint32 address, uint16 port);
+
+    // called by the service once the disconnect got processed
+    void				DestroySession(Session* session);
+
+private:
+
+    Session*			_createSession(int socket, uint32 address, uint16 port);
+    void				_acceptLinks();
+    bool				_readHandshake(PendingLocalLink& pending);
+    void				_readLink(LocalLink* link);
+    void				_writeLink(LocalLink* link);
+
+    boost::mutex		mLinkMutex;
+    boost::thread		mThread;
+
+    LocalLinkList		mLinks;
+    PendingLocalLinkList	mPendingLinks;	// only touched by our thread
+    std::string			mPath;
+    Service*			mService;
+    MessageFactory*		mMessageFactory;
+    int					mListenSocket;
+    int					mWakeSockets[2];	// links write to the second one when they queued output
+    bool volatile		mExit;
+};
+
+//======================================================================================================================
+
+#endif //ANH_NETWORKMANAGER_LOCALLINKTHREAD_H
+
@@ -0,0 +1,97 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "MulticastEnvelope.h"
+#include "Message.h"
+#include "MessageFactory.h"
+#include "MessageOpcodes.h"
+
+//======================================================================================================================
+
+Message* MulticastEnvelope::Build(Message* payload, const uint32* accountIds, uint16 count, uint8 priority, bool unreliable)
+{
+    gMessageFactory->StartMessage();
+    gMessageFactory->addUint32(opClusterMulticast);
+    gMessageFactory->addUint8(priority);
+    gMessageFactory->addUint8(unreliable ? 1 : 0);
+    gMessageFactory->addUint16(count);
+
+    for(uint16 i = 0; i < count; ++i)
+    {
+        gMessageFactory->addUint32(accountIds[i]);
+    }
+
+    gMessageFactory->addData(payload->getData(), payload->getSize());
+
+    return gMessageFactory->EndMessage();
+}
+
+//======================================================================================================================
+
+bool MulticastEnvelope::Read(Message* message)
+{
+    if(message->getIndex() + 4u > message->getSize())
+    {
+        return false;
+    }
+
+    mPriority   = message->getUint8();
+    mUnreliable = message->getUint8() != 0;
+
+    uint16 count = message->getUint16();
+    uint32 payloadStart = message->getIndex() + count * 4u;
+
+    if(payloadStart > message->getSize())
+    {
+        return false;
+    }
+
+    mAccountIds.resize(count);
+
+    for(uint16 i = 0; i < count; ++i)
+    {
+        mAccountIds[i] = message->getUint32();
+    }
+
+    mPayload     = message->getData() + payloadStart;
+    mPayloadSize = static_cast<uint16>(message->getSize() - payloadStart);
+
+    return true;
+}
+
+//======================================================================================================================
+
+Message* MulticastEnvelope::CopyPayload(void) const
+{
+    gMessageFactory->StartMessage();
+    gMessageFactory->addData(mPayload, mPayloadSize);
+
+    return gMessageFactory->EndMessage();
+}
+
+//======================================================================================================================
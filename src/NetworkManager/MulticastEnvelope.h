@@ -0,0 +1,100 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_NETWORKMANAGER_MULTICASTENVELOPE_H
+#define ANH_NETWORKMANAGER_MULTICASTENVELOPE_H
+
+#include "Utils/typedefs.h"
+
+#include <vector>
+
+class Message;
+
+//======================================================================================================================
+//
+// The opClusterMulticast envelope a backend server sends to the connectionserver to reach many clients at once.
+//
+// envelope: opcode(4) priority(1) unreliable(1) count(2) accountIds(4 * count) payload
+//
+
+class MulticastEnvelope
+{
+public:
+
+    MulticastEnvelope(void) : mPriority(0), mUnreliable(false), mPayload(0), mPayloadSize(0) {}
+
+    // builds the envelope for count accounts, the payload is copied
+    static Message*			Build(Message* payload, const uint32* accountIds, uint16 count, uint8 priority, bool unreliable);
+
+    // reads the envelope following the opcode, false when the message is too short for what it claims to hold.
+    // The payload is not copied, it is valid as long as the message is.
+    bool					Read(Message* message);
+
+    // the clients of the recipients, lookup gives NULL for accounts that logged out in the meantime
+    template<typename Client, typename Lookup>
+    std::vector<Client*>	FindRecipients(Lookup lookup) const;
+
+    // a copy of the payload for one recipient
+    Message*				CopyPayload(void) const;
+
+    uint8					getPriority(void) const { return mPriority; }
+    bool					getUnreliable(void) const { return mUnreliable; }
+    const std::vector<uint32>& getAccountIds(void) const { return mAccountIds; }
+    uint16					getPayloadSize(void) const { return mPayloadSize; }
+
+private:
+
+    uint8					mPriority;
+    bool					mUnreliable;
+    std::vector<uint32>		mAccountIds;
+    const int8*				mPayload;
+    uint16					mPayloadSize;
+};
+
+//======================================================================================================================
+
+template<typename Client, typename Lookup>
+std::vector<Client*> MulticastEnvelope::FindRecipients(Lookup lookup) const
+{
+    std::vector<Client*> recipients;
+    recipients.reserve(mAccountIds.size());
+
+    for(std::vector<uint32>::const_iterator it = mAccountIds.begin(); it != mAccountIds.end(); ++it)
+    {
+        if(Client* client = lookup(*it))
+        {
+            recipients.push_back(client);
+        }
+    }
+
+    return recipients;
+}
+
+//======================================================================================================================
+
+#endif // ANH_NETWORKMANAGER_MULTICASTENVELOPE_H
@@ -44,6 +44,7 @@ public:
     virtual NetworkClient*  handleSessionConnect(Session* session, Service* service)            {
         return (NetworkClient*)-1;
     };
+    virtual void            handleSessionConnected(NetworkClient* client)                       {};
     virtual void            handleSessionDisconnect(NetworkClient* client)                      {};
     virtual void            handleSessionMessage(NetworkClient* client, Message* message)       {};
 
@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "NetworkClient.h"
+#include "LocalLink.h"
 #include "Session.h"
 
 #include "NetworkManager/Message.h"
@@ -56,5 +57,10 @@ void NetworkClient::SendChannelAUnreliable(Message* message, uint8 priority)
 void NetworkClient::Disconnect(uint8 reason)
 {
     mSession->setCommand(SCOM_Disconnect);
+
+    if(mSession->getLocalLink())
+    {
+        mSession->getLocalLink()->Close();
+    }
 }
 
@@ -42,6 +42,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 NetworkManager::NetworkManager(const NetworkConfig& network_configuration) 
 	: mServiceIdIndex(1)
 	, network_configuration_(network_configuration)
+	, mReactor(0)
 {
     
 }
@@ -70,8 +71,10 @@ void NetworkManager::Process(void)
 
         if(service)
         {
-            service->Process();
+            // clear the flag first, sessions queued while we process get the service queued again
+            // instead of waiting for the next unrelated wakeup
             service->setQueued(false);
+            service->Process();
         }
     }
 
@@ -80,11 +83,11 @@ void NetworkManager::Process(void)
 
 //======================================================================================================================
 
-Service* NetworkManager::GenerateService(int8* address, uint16 port,uint32 mfHeapSize,  bool serverservice)
+Service* NetworkManager::GenerateService(int8* address, uint16 port,uint32 mfHeapSize,  bool serverservice, bool ownSockets)
 {
     Service* newService = 0;
 
-    newService = new Service(this, serverservice, mServiceIdIndex++, address, port,mfHeapSize, network_configuration_);
+    newService = new Service(this, serverservice, mServiceIdIndex++, address, port,mfHeapSize, network_configuration_, ownSockets);
 
     return newService;
 }
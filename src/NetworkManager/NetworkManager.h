@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <queue>
 #include "Utils/concurrent_queue.h"
+#include "Utils/Reactor.h"
 #include "Utils/typedefs.h"
 #include "NetworkConfig.h"
 #include "Service.h"
@@ -56,7 +57,8 @@ public:
 
     void		Process(void);
 
-    Service*	GenerateService(int8* address, uint16 port,uint32 mfHeapSize, bool serverservice);
+    // ownSockets is for clients that hold many sessions to one server, like the load generator bots
+    Service*	GenerateService(int8* address, uint16 port,uint32 mfHeapSize, bool serverservice, bool ownSockets = false);
     void		DestroyService(Service* service);
     Client*		Connect(void);
 
@@ -65,10 +67,16 @@ public:
 
     void		AddServiceToProcessQueue(Service* service);
 
+    // the main loop gets woken up whenever a service has sessions to process
+    void		setReactor(utils::Reactor* reactor) {
+        mReactor = reactor;
+    }
+
 private:
 
     ServiceQueue		mServiceProcessQueue;
 	NetworkConfig		network_configuration_;
+    utils::Reactor*		mReactor;
 
     uint32			mServiceIdIndex;
 };
@@ -84,6 +92,11 @@ inline void NetworkManager::AddServiceToProcessQueue(Service* service)
 
         mServiceProcessQueue.push(service);
     }
+
+    if(mReactor)
+    {
+        mReactor->Signal();
+    }
 }
 
 //======================================================================================================================
@@ -29,6 +29,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <glog/logging.h>
 
+#include "LocalLink.h"
+#include "LocalLinkThread.h"
 #include "NetworkCallback.h"
 #include "NetworkClient.h"
 #include "NetworkManager.h"
@@ -69,7 +71,7 @@ bool Service::mSocketsSubsystemInitComplete = false;
 
 //======================================================================================================================
 
-Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id, int8* localAddress, uint16 localPort,uint32 mfHeapSize, NetworkConfig& network_configuration) :
+Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id, int8* localAddress, uint16 localPort,uint32 mfHeapSize, NetworkConfig& network_configuration, bool ownSockets) :
     mNetworkManager(networkManager),
     mSocketReadThread(0),
     mSocketWriteThread(0),
@@ -79,7 +81,13 @@ Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id,
     mLocalAddress(0),
     mLocalPort(0),
     mQueued(false),
-    mServerService(serverservice)
+    mServerService(serverservice),
+    mOwnSockets(ownSockets),
+    mCountMessages(false),
+    mLocalLinkThread(0),
+    mMessageHeapSize(mfHeapSize),
+    mMessagesReceived(0),
+    mMessagesSent(0)
 {
     mCallBack = NULL;
     mId = id;
@@ -152,7 +160,7 @@ Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id,
 
     // Create our read/write socket classes
     mSocketWriteThread = new SocketWriteThread(mLocalSocket,this,mServerService, network_configuration);
-    mSocketReadThread = new SocketReadThread(mLocalSocket, mSocketWriteThread,this,mfHeapSize, mServerService, network_configuration);
+    mSocketReadThread = new SocketReadThread(mLocalSocket, mSocketWriteThread,this,mfHeapSize, mServerService, mOwnSockets, network_configuration);
 
     // Query the stack for the actual address and port we got and store it in the service.
     //getsockname(mLocalSocket, (sockaddr*)&server, &serverLen);
@@ -175,9 +183,15 @@ Service::~Service(void)
 
     while(mSessionProcessQueue.pop(session))
     {
-		mSocketReadThread->RemoveAndDestroySession(session);
+        if(!session->getLocalLink())
+        {
+            mSocketReadThread->RemoveAndDestroySession(session);
+        }
     }
 
+    // takes the remaining local sessions down with it
+    delete mLocalLinkThread;
+
     delete mSocketWriteThread;
     delete mSocketReadThread;
 
@@ -219,8 +233,17 @@ void Service::Process()
 
         session->setInIncomingQueue(false);
 
+        // an async connect went through, the client gets its session now
+        if(session->getNotifyConnect() && session->getStatus() == SSTAT_Connected)
+        {
+            session->setNotifyConnect(false);
+            session->getClient()->setSession(session);
+
+            mCallBack->handleSessionConnected(session->getClient());
+        }
+
         // Check to see if we're in the process of connecting or disconnecting.
-        if(session->getStatus() == SSTAT_Connecting)
+        if(session->getStatus() == SSTAT_Connecting && !session->getNotifyConnect())
         {
             //for(NetworkCallbackList::iterator iter = mNetworkCallbackList.begin(); iter != mNetworkCallbackList.end(); ++iter)
             //{
@@ -238,6 +261,11 @@ void Service::Process()
             {
                 // Remove the session, they don't want it.
                 session->setCommand(SCOM_Disconnect);
+
+                if(session->getLocalLink())
+                {
+                    session->getLocalLink()->Close();
+                }
             }
             //}
         }
@@ -258,10 +286,22 @@ void Service::Process()
             // We're now dis connected.
             session->setStatus(SSTAT_Disconnected);
 
+            // local links have no write thread running the session down, so we are done with it here
+            if(session->getLocalLink())
+            {
+                mLocalLinkThread->DestroySession(session);
+            }
+
             continue;
         }
         else if(session->getStatus() == SSTAT_Destroy)
         {
+            if(session->getLocalLink())
+            {
+                mLocalLinkThread->DestroySession(session);
+                continue;
+            }
+
             mSocketReadThread->RemoveAndDestroySession(session);
 
 
@@ -302,6 +342,12 @@ void Service::Process()
         }
 
     }
+
+    if(mCountMessages)
+    {
+        mMessagesReceived += messages;
+    }
+
 	/*
 	if((this->mServerService) && sessionCount)	{
 			DLOG(INFO) << "Service::Process() END";
@@ -342,6 +388,84 @@ void Service::Connect(NetworkClient* client, const int8* address, uint16 port)
 
 //======================================================================================================================
 
+void Service::ConnectAsync(NetworkClient* client, const int8* address, uint16 port, uint32 timeout)
+{
+    // the read thread of other services never looks at queued connects
+    if(!mOwnSockets)
+    {
+        LOG(ERROR) << "Service " << mId << ": async connects need a service with own sockets";
+        return;
+    }
+
+    LOG(INFO) << "New connection to " << address << " on port " << port;
+
+    mSocketReadThread->QueueOutgoingConnection(client, address, port, timeout);
+}
+
+//======================================================================================================================
+
+bool Service::ListenLocal(const std::string& path)
+{
+    if(path.empty())
+    {
+        return false;
+    }
+
+    if(!LocalLink::isSupported())
+    {
+        LOG(WARNING) << "Local transport is not supported on this platform, using udp only";
+        return false;
+    }
+
+    if(!_getLocalLinkThread()->Listen(path))
+    {
+        return false;
+    }
+
+    LOG(INFO) << "Service " << mId << ": accepting local links on " << path;
+
+    return true;
+}
+
+//======================================================================================================================
+
+bool Service::ConnectLocal(NetworkClient* client, const std::string& path)
+{
+    if(path.empty() || !LocalLink::isSupported())
+    {
+        return false;
+    }
+
+    // the peer identifies us by the address and port of our udp service
+    Session* session = _getLocalLinkThread()->Connect(path, mLocalAddress, mLocalPort);
+
+    if(!session)
+    {
+        return false;
+    }
+
+    LOG(INFO) << "New local connection to " << path;
+
+    session->setClient(client);
+    client->setSession(session);
+
+    return true;
+}
+
+//======================================================================================================================
+
+LocalLinkThread* Service::_getLocalLinkThread()
+{
+    if(!mLocalLinkThread)
+    {
+        mLocalLinkThread = new LocalLinkThread(this, mMessageHeapSize);
+    }
+
+    return mLocalLinkThread;
+}
+
+//======================================================================================================================
+
 void Service::AddSessionToProcessQueue(Session* session)
 {
     if(!session->getInIncomingQueue())
@@ -32,11 +32,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/ConcurrentQueue.h"
 
 #include "NetworkConfig.h"
+#include <atomic>
 #include <list>
+#include <string>
 
 
 //======================================================================================================================
 
+class LocalLinkThread;
 class NetworkClient;
 class Session;
 class SocketReadThread;
@@ -55,13 +58,22 @@ class Service
 {
 public:
 
-    Service(NetworkManager* networkManager, bool serverservice, uint32 id, int8* localAddress, uint16 localPort,uint32 mfHeapSize, NetworkConfig& network_configuration);
+    Service(NetworkManager* networkManager, bool serverservice, uint32 id, int8* localAddress, uint16 localPort,uint32 mfHeapSize, NetworkConfig& network_configuration, bool ownSockets = false);
     ~Service(void);
 
     void	Process();
 
     void	Connect(NetworkClient* client, const int8* address, uint16 port);
 
+    // connects without blocking, the callback gets handleSessionConnected once the remote side answered
+    // or handleSessionDisconnect when it did not within timeout ms. Only for services created with ownSockets,
+    // the session gets a udp port of its own so one service can hold any number of sessions to the same remote service
+    void	ConnectAsync(NetworkClient* client, const int8* address, uint16 port, uint32 timeout);
+
+    // local stream links for servers sharing a host, see LocalLink
+    bool	ListenLocal(const std::string& path);
+    bool	ConnectLocal(NetworkClient* client, const std::string& path);
+
     void	AddSessionToProcessQueue(Session* session);
     //void	AddNetworkCallback(NetworkCallback* callback){ mNetworkCallbackList.push_back(callback); }
     void	AddNetworkCallback(NetworkCallback* callback) {
@@ -79,6 +91,21 @@ public:
     void	setId(uint32 id) {
         mId = id;
     };
+
+    // messages handed to and taken from our clients since counting was turned on
+    void	setCountMessages(bool count) {
+        mCountMessages = count;
+    }
+    uint64	getMessagesReceived() {
+        return mMessagesReceived;
+    }
+    uint64	getMessagesSent() {
+        return mMessagesSent;
+    }
+    void	countMessageSent() {
+        if(mCountMessages)
+            ++mMessagesSent;
+    }
     void	setQueued(bool b) {
         mQueued = b;
     }
@@ -88,6 +115,8 @@ public:
 
 private:
 
+    LocalLinkThread*		_getLocalLinkThread();
+
     NetworkCallback*		mCallBack;
     //NetworkCallbackList		mNetworkCallbackList;
 
@@ -107,6 +136,14 @@ private:
     uint16					mLocalPort;
     bool volatile			mQueued;
     bool					mServerService;	//marks us as the serverservice / clientservice
+    bool					mOwnSockets;	//sessions of async connects get a socket of their own, for bots
+    bool					mCountMessages;
+
+    LocalLinkThread*		mLocalLinkThread;	//created when the first local link is set up
+    uint32					mMessageHeapSize;
+
+    std::atomic<uint64>		mMessagesReceived;
+    std::atomic<uint64>		mMessagesSent;
 
     static bool				mSocketsSubsystemInitComplete;
 };
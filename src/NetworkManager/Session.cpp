@@ -49,6 +49,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <glog/logging.h>
 
+#include "NetworkManager/LocalLink.h"
 #include "NetworkManager/MessageFactory.h"
 #include "NetworkManager/NetworkClient.h"
 #include "NetworkManager/Packet.h"
@@ -66,6 +67,7 @@ Session::Session(void) :
     mSocketWriteThread(0),
     mPacketFactory(0),
     mMessageFactory(0),
+    mLocalLink(0),
 // mClock(0),
     mId(0),
     mAddress(0),
@@ -83,6 +85,9 @@ Session::Session(void) :
     mRoutedFragmentedPacketCurrentSequence(0),
     mConnectStartEvent(0),
     mLastConnectRequestSent(0),
+    mConnectTimeout(60000),
+    mNotifyConnect(false),
+    mOwnSocket(INVALID_SOCKET),
     mLastPacketReceived(0),
     mLastPacketSent(0),
     mLastRoundtripTime(0),
@@ -514,6 +519,16 @@ void Session::SendChannelA(Message* message)
         return;
     }
 
+    mService->countMessageSent();
+
+    //local links frame the message right away - no packets, no resends
+    if(mLocalLink)
+    {
+        mLocalLink->Send(message);
+        message->setPendingDelete(true);
+        return;
+    }
+
     //the connectionserver puts a lot of fastpaths here  - so just put them were they belong
     //this alone takes roughly 5% cpu off of the connectionserver
     if(message->getFastpath()&& (message->getSize() < mMaxUnreliableSize))	{
@@ -535,6 +550,18 @@ void Session::SendChannelAUnreliable(Message* message)
 {
     message->mSession = this;
 
+    if(mLocalLink)
+    {
+        if(mStatus == SSTAT_Connected)
+        {
+            mService->countMessageSent();
+            mLocalLink->Send(message);
+        }
+
+        message->setPendingDelete(true);
+        return;
+    }
+
     //check whether we are disconnecting
     if((mMessageFactory->getHeapsize() > 95.0) || (mStatus != SSTAT_Connected))
     {
@@ -542,6 +569,8 @@ void Session::SendChannelAUnreliable(Message* message)
         return;
     }
 
+    mService->countMessageSent();
+
     if(message->getSize() > mMaxUnreliableSize)	//I send the attribute messages as unreliables	 but they can be to big!!
     {
         message->setFastpath(false);	  //send it as reliable if its to big
@@ -644,6 +673,12 @@ void Session::HandleSessionPacket(Packet* packet)
         packet->getUint32();                          // unkown
         mEncryptKey = ntohl(packet->getUint32());     // Encryption key
         mPacketFactory->DestroyPacket(packet);
+
+        // let the service hand us to our client
+        if(mNotifyConnect)
+        {
+            mService->AddSessionToProcessQueue(this);
+        }
         return;
     }
 
@@ -2160,10 +2195,21 @@ void Session::_processConnectCommand(void)
     // Otherwise, see if we need to send another request packet, or if our timeout expired
     if (mStatus == SSTAT_Connecting && mCommand == SCOM_Connect)
     {
+        // an async connect gives up as soon as its timeout expired, the service reports it as a disconnect
+        if (mNotifyConnect && Anh_Utils::Clock::getSingleton()->getLocalTime() - mConnectStartEvent > mConnectTimeout)
+        {
+            LOG(INFO) << "Connect timed out after " << mConnectTimeout << "ms";
+
+            mStatus = SSTAT_Disconnecting;
+            mCommand = SCOM_None;
+            mService->AddSessionToProcessQueue(this);
+            return;
+        }
+
         if (Anh_Utils::Clock::getSingleton()->getLocalTime() - mLastConnectRequestSent > 5000)  // Send a request packet every 5 seconds
         {
             // If we hit our timeout, then cancel the connect
-            if (Anh_Utils::Clock::getSingleton()->getLocalTime() - mConnectStartEvent > 60000)   // Timeout at 30 seconds
+            if (Anh_Utils::Clock::getSingleton()->getLocalTime() - mConnectStartEvent > mConnectTimeout)
             {
                 // Cancel our connect command and put us in a back in an uninit state
                 mStatus = SSTAT_Initialize;
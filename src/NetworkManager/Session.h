@@ -39,6 +39,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/ConcurrentQueue.h"
 
 #include "NetworkManager/Message.h"
+#include "NetworkManager/Socket.h"
 
 //======================================================================================================================
 
@@ -50,6 +51,8 @@ class PacketFactory;
 class MessageFactory;
 class Packet;
 class SessionPacket;
+class LocalLink;
+class LocalLinkThread;
 
 //======================================================================================================================
 
@@ -85,6 +88,8 @@ enum SessionCommand
 
 class Session
 {
+    friend class LocalLinkThread;
+
 public:
     Session(void);
     ~Session(void);
@@ -214,6 +219,33 @@ public:
         return mServerService;
     }
 
+    // set when the session runs over a local stream link instead of udp
+    void                        setLocalLink(LocalLink* link)                   {
+        mLocalLink = link;
+    }
+    LocalLink*                  getLocalLink(void)                              {
+        return mLocalLink;
+    }
+
+    // set for connects made through Service::ConnectAsync
+    void                        setConnectTimeout(uint32 timeout)               {
+        mConnectTimeout = timeout;
+    }
+    void                        setNotifyConnect(bool notify)                   {
+        mNotifyConnect = notify;
+    }
+    bool                        getNotifyConnect(void)                          {
+        return mNotifyConnect;
+    }
+
+    // a udp socket of our own, INVALID_SOCKET when we share the socket of the service
+    void                        setOwnSocket(SOCKET socket)                     {
+        mOwnSocket = socket;
+    }
+    SOCKET                      getOwnSocket(void)                              {
+        return mOwnSocket;
+    }
+
     uint64					  mLastPacketDestroyed;
     uint64					  mHash;
 
@@ -273,6 +305,7 @@ private:
     SocketWriteThread*          mSocketWriteThread;
     PacketFactory*              mPacketFactory;
     MessageFactory*             mMessageFactory;
+    LocalLink*                  mLocalLink;
     // Anh_Utils::Clock*           mClock;
 
 
@@ -296,6 +329,9 @@ private:
 
     uint64                      mConnectStartEvent;       // For SCOM_Connect commands
     uint64                      mLastConnectRequestSent;
+    uint32                      mConnectTimeout;
+    bool volatile               mNotifyConnect;           // the service reports the outcome of the connect
+    SOCKET                      mOwnSocket;
 
     uint64                      mLastPacketReceived;      // General session timeout
     uint64                      mLastPacketSent;          // General session timeout
@@ -34,6 +34,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //#define socklen_t int
 #else
 #define SOCKET unsigned int
+#define INVALID_SOCKET -1
 
 #endif //WIN32
 
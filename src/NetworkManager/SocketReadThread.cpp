@@ -53,9 +53,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #if defined(_MSC_VER)
 #define socklen_t int
+#define poll WSAPoll
 #else
+#include <poll.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#include <unistd.h>
 
 #define INVALID_SOCKET	-1
 #define SOCKET_ERROR	-1
@@ -64,14 +67,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 //======================================================================================================================
 
-SocketReadThread::SocketReadThread(SOCKET socket, SocketWriteThread* writeThread, Service* service,uint32 mfHeapSize, bool serverservice, NetworkConfig& network_configuration) :
+SocketReadThread::SocketReadThread(SOCKET socket, SocketWriteThread* writeThread, Service* service,uint32 mfHeapSize, bool serverservice, bool ownSockets, NetworkConfig& network_configuration) :
     mReceivePacket(0),
     mDecompressPacket(0),
     mSessionFactory(0),
     mPacketFactory(0),
     mCompCryptor(0),
     mSocket(0),
-    mIsRunning(false)
+    mIsRunning(false),
+    mOwnSockets(ownSockets)
 {
     if(serverservice)
     {
@@ -123,6 +127,22 @@ SocketReadThread::~SocketReadThread()
     mThread.interrupt();
     mThread.join();
 
+    PendingConnection* connection = 0;
+    while(mPendingConnections.pop(connection))
+    {
+        delete connection;
+    }
+
+    for(SocketSessionMap::iterator it = mSocketSessionMap.begin(); it != mSocketSessionMap.end(); ++it)
+    {
+        closesocket(it->first);
+    }
+
+    for(std::vector<SOCKET>::iterator it = mClosedSockets.begin(); it != mClosedSockets.end(); ++it)
+    {
+        closesocket(*it);
+    }
+
     delete mPacketFactory;
     delete mSessionFactory;
 
@@ -135,12 +155,14 @@ SocketReadThread::~SocketReadThread()
 
 void SocketReadThread::run(void)
 {
-    struct sockaddr_in  from;
-    uint32              address, fromLen = sizeof(from), count;
-    int16               recvLen = 0;
-    uint16              port = 0;
-    uint16              decompressLen = 0;
-    Session*            session;
+    // bot services read a socket per session, see _runOwnSockets
+    if(mOwnSockets)
+    {
+        _runOwnSockets();
+        return;
+    }
+
+    uint32              count;
     fd_set              socketSet;
     struct              timeval tv;
 
@@ -152,32 +174,7 @@ void SocketReadThread::run(void)
     while(!mExit)
     {
         // Check to see if *WE* are about to connect to a remote server
-        if(mNewConnection.mPort != 0)
-        {
-            LOG(INFO) << "Connecting to remote server";
-            Session* newSession = mSessionFactory->CreateSession();
-            newSession->setCommand(SCOM_Connect);
-            newSession->setAddress(inet_addr(mNewConnection.mAddress));
-            newSession->setPort(htons(mNewConnection.mPort));
-            newSession->setResendWindowSize(mSessionResendWindowSize);
-
-            uint64 hash = newSession->getAddress() | (((uint64)newSession->getPort()) << 32);
-
-            mNewConnection.mSession = newSession;
-            mNewConnection.mPort = 0;
-
-            // Add the new session to the main process list
-            {
-                boost::mutex::scoped_lock lk(mSocketReadMutex);
-
-                mAddressSessionMap.insert(std::make_pair(hash,newSession));
-            }
-            mSocketWriteThread->NewSession(newSession);
-        }
-
-        // Reset our internal members so we can use the packet again.
-        mReceivePacket->Reset();
-        mDecompressPacket->Reset();
+        _openNewConnection();
 
         // Build a new fd_set structure
         FD_SET(mSocket, &socketSet);
@@ -190,258 +187,383 @@ void SocketReadThread::run(void)
 
         if(count && FD_ISSET(mSocket, &socketSet))
         {
-            //LOG(INFO) << "Message received on port " << port;
-            // Read any incoming packets.
-            recvLen = recvfrom(mSocket, mReceivePacket->getData(),(int) mMessageMaxSize, 0, (sockaddr*)&from, reinterpret_cast<socklen_t*>(&fromLen));
+            _receive(mSocket);
+        }
 
-            if(recvLen <= 0)
-            {
-#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+        boost::this_thread::sleep(boost::posix_time::microseconds(10));
+    }
 
-                int errorNr = 0;
-                errorNr = WSAGetLastError();
+    // Shutdown internally
+    _shutdown();
+}
 
-                char errorMsg[512];
+//======================================================================================================================
 
-                if(FormatMessage(FORMAT_MESSAGE_FROM_SYSTEM, NULL, errorNr, MAKELANGID(LANG_NEUTRAL,SUBLANG_DEFAULT),(LPTSTR)errorMsg, (sizeof(errorMsg) / sizeof(TCHAR)) - 1, NULL))
-                {
-                    LOG(WARNING) << "Error(recvFrom): " << errorMsg;
-                }
-                else
-                {
-                    LOG(WARNING) << "Error(recvFrom): " << errorNr;
-                }
-#endif
-                continue;
-            }
+void SocketReadThread::_runOwnSockets(void)
+{
+    int32               count;
+    std::vector<pollfd> pollSockets;
 
-            if(recvLen > mMessageMaxSize)
-            {
-                LOG(INFO) << "Socket Read Thread Received Size > mMessageMaxSize: " << recvLen;
-            }
+    // Call our internal _startup method
+    _startup();
 
-            // Get our remote Address and port
-            address		= from.sin_addr.s_addr;
-            port		= from.sin_port;
+    while(!mExit)
+    {
+        _openNewConnection();
 
-            uint64 hash = address | (((uint64)port) << 32);
+        // Connects queued by Service::ConnectAsync
+        PendingConnection* connection = 0;
 
-            // Grab our packet type
-            mReceivePacket->Reset();           // Reset our internal members so we can use the packet again.
-            mReceivePacket->setSize(recvLen); // crc is subtracted by the decryption
+        while(mPendingConnections.pop(connection))
+        {
+            _openConnection(connection);
+            delete connection;
+        }
 
-            uint8  packetTypeLow	= mReceivePacket->peekUint8();
-            uint16 packetType		= mReceivePacket->getUint16();
+        // Our own socket first, then those of the sessions that have one
+        pollSockets.resize(1);
+        pollSockets[0].fd = mSocket;
+        pollSockets[0].events = POLLIN;
 
+        {
             boost::mutex::scoped_lock lk(mSocketReadMutex);
 
-            AddressSessionMap::iterator i = mAddressSessionMap.find(hash);
+            // sockets of destroyed sessions are closed here, where nobody waits on them
+            for(std::vector<SOCKET>::iterator it = mClosedSockets.begin(); it != mClosedSockets.end(); ++it)
+            {
+                closesocket(*it);
+            }
+            mClosedSockets.clear();
 
-            if(i != mAddressSessionMap.end())
+            for(SocketSessionMap::iterator it = mSocketSessionMap.begin(); it != mSocketSessionMap.end(); ++it)
             {
-                session = (*i).second;
+                pollfd entry;
+                entry.fd = it->first;
+                entry.events = POLLIN;
+                pollSockets.push_back(entry);
             }
-            else
+        }
+
+        // We're going to block for 1ms at most.
+        count = poll(&pollSockets[0], pollSockets.size(), 1);
+
+        for(size_t i = 0; count > 0 && i < pollSockets.size(); ++i)
+        {
+            if(pollSockets[i].revents & POLLIN)
             {
-                // We should only be creating a new session if it's a session request packet
-                if(packetType == SESSIONOP_SessionRequest)
-                {
-                    session = mSessionFactory->CreateSession();
-                    session->setSocketReadThread(this);
-                    session->setPacketFactory(mPacketFactory);
-                    session->setAddress(address);  // Store the address and port in network order so we don't have to
-                    session->setPort(port);  // convert them all the time.  Only convert for humans.
-                    session->setResendWindowSize(mSessionResendWindowSize);
-
-                    // Insert the session into our address map and process list
-                    mAddressSessionMap.insert(std::make_pair(hash, session));
-                    mSocketWriteThread->NewSession(session);
-                    session->mHash = hash;
-
-                    LOG(INFO) << "Added Service " << mSessionFactory->getService()->getId() << ": New Session(" 
-                    <<inet_ntoa(from.sin_addr) << ", " << ntohs(session->getPort()) << "), AddressMap: " << mAddressSessionMap.size();
-                }
-                else
-                {
-                    LOG(WARNING) << "Socket Read Thread Session not found. Type:0x" << packetType;
-
-                    lk.unlock();
-
-                    continue;
-                }
+                _receive(pollSockets[i].fd);
             }
+        }
+
+        boost::this_thread::sleep(boost::posix_time::microseconds(10));
+    }
+
+    // Shutdown internally
+    _shutdown();
+}
+
+//======================================================================================================================
+
+void SocketReadThread::_openNewConnection(void)
+{
+    if(mNewConnection.mPort == 0)
+    {
+        return;
+    }
+
+    LOG(INFO) << "Connecting to remote server";
+    Session* newSession = mSessionFactory->CreateSession();
+    newSession->setCommand(SCOM_Connect);
+    newSession->setAddress(inet_addr(mNewConnection.mAddress));
+    newSession->setPort(htons(mNewConnection.mPort));
+    newSession->setResendWindowSize(mSessionResendWindowSize);
+
+    uint64 hash = newSession->getAddress() | (((uint64)newSession->getPort()) << 32);
+
+    mNewConnection.mSession = newSession;
+    mNewConnection.mPort = 0;
+
+    // Add the new session to the main process list
+    {
+        boost::mutex::scoped_lock lk(mSocketReadMutex);
+
+        mAddressSessionMap.insert(std::make_pair(hash,newSession));
+    }
+    mSocketWriteThread->NewSession(newSession);
+}
+
+//======================================================================================================================
+
+void SocketReadThread::_receive(SOCKET socket)
+{
+    struct sockaddr_in  from;
+    uint32              address, fromLen = sizeof(from);
+    int16               recvLen = 0;
+    uint16              port = 0;
+    uint16              decompressLen = 0;
+    Session*            session;
+
+    // Reset our internal members so we can use the packet again.
+    mReceivePacket->Reset();
+    mDecompressPacket->Reset();
+
+    //LOG(INFO) << "Message received on port " << port;
+    // Read any incoming packets.
+    recvLen = recvfrom(socket, mReceivePacket->getData(),(int) mMessageMaxSize, 0, (sockaddr*)&from, reinterpret_cast<socklen_t*>(&fromLen));
+
+    if(recvLen <= 0)
+    {
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+
+        int errorNr = 0;
+        errorNr = WSAGetLastError();
+
+        char errorMsg[512];
+
+        if(FormatMessage(FORMAT_MESSAGE_FROM_SYSTEM, NULL, errorNr, MAKELANGID(LANG_NEUTRAL,SUBLANG_DEFAULT),(LPTSTR)errorMsg, (sizeof(errorMsg) / sizeof(TCHAR)) - 1, NULL))
+        {
+            LOG(WARNING) << "Error(recvFrom): " << errorMsg;
+        }
+        else
+        {
+            LOG(WARNING) << "Error(recvFrom): " << errorNr;
+        }
+#endif
+        return;
+    }
+
+    if(recvLen > mMessageMaxSize)
+    {
+        LOG(INFO) << "Socket Read Thread Received Size > mMessageMaxSize: " << recvLen;
+    }
+
+    // Get our remote Address and port
+    address		= from.sin_addr.s_addr;
+    port		= from.sin_port;
+
+    uint64 hash = address | (((uint64)port) << 32);
+
+    // Grab our packet type
+    mReceivePacket->Reset();           // Reset our internal members so we can use the packet again.
+    mReceivePacket->setSize(recvLen); // crc is subtracted by the decryption
+
+    uint8  packetTypeLow	= mReceivePacket->peekUint8();
+    uint16 packetType		= mReceivePacket->getUint16();
+
+    boost::mutex::scoped_lock lk(mSocketReadMutex);
+
+    AddressSessionMap::iterator i = mAddressSessionMap.find(hash);
+
+    if(mOwnSockets && socket != mSocket)
+    {
+        // a session with a socket of its own only talks to the remote side it connected to
+        SocketSessionMap::iterator own = mSocketSessionMap.find(socket);
+
+        if(own == mSocketSessionMap.end() || own->second->getAddress() != address || own->second->getPort() != port)
+        {
+            return;
+        }
+
+        session = own->second;
+    }
+    else if(i != mAddressSessionMap.end())
+    {
+        session = (*i).second;
+    }
+    else
+    {
+        // We should only be creating a new session if it's a session request packet
+        if(packetType == SESSIONOP_SessionRequest)
+        {
+            session = mSessionFactory->CreateSession();
+            session->setSocketReadThread(this);
+            session->setPacketFactory(mPacketFactory);
+            session->setAddress(address);  // Store the address and port in network order so we don't have to
+            session->setPort(port);  // convert them all the time.  Only convert for humans.
+            session->setResendWindowSize(mSessionResendWindowSize);
+
+            // Insert the session into our address map and process list
+            mAddressSessionMap.insert(std::make_pair(hash, session));
+            mSocketWriteThread->NewSession(session);
+            session->mHash = hash;
+
+            LOG(INFO) << "Added Service " << mSessionFactory->getService()->getId() << ": New Session(" 
+            <<inet_ntoa(from.sin_addr) << ", " << ntohs(session->getPort()) << "), AddressMap: " << mAddressSessionMap.size();
+        }
+        else
+        {
+            LOG(WARNING) << "Socket Read Thread Session not found. Type:0x" << packetType;
 
             lk.unlock();
 
-            // I don't like any of the code below, but it's going to take me a bit to work out a good way to handle decompression
-            // and decryption.  It's dependent on session layer protocol information, which should not be looked at here.  Should
-            // be placed in Session, though I'm not sure how or where yet.
-            // Set the size of the packet
+            return;
+        }
+    }
+
+    lk.unlock();
+
+    // I don't like any of the code below, but it's going to take me a bit to work out a good way to handle decompression
+    // and decryption.  It's dependent on session layer protocol information, which should not be looked at here.  Should
+    // be placed in Session, though I'm not sure how or where yet.
+    // Set the size of the packet
+
+    // Validate our date header.  If it's not a valid header, drop it.
+    if(packetType > 0x00ff && (packetType & 0x00ff) == 0 && session != NULL)
+    {
+        switch(packetType)
+        {
+        case SESSIONOP_Disconnect:
+        case SESSIONOP_DataAck1:
+        case SESSIONOP_DataAck2:
+        case SESSIONOP_DataAck3:
+        case SESSIONOP_DataAck4:
+        case SESSIONOP_DataOrder1:
+        case SESSIONOP_DataOrder2:
+        case SESSIONOP_DataOrder3:
+        case SESSIONOP_DataOrder4:
+        case SESSIONOP_Ping:
+        {
+            // Before we do anything else, check the CRC.
+            uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());  // - 2 crc
+
+            uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
+            uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
 
-            // Validate our date header.  If it's not a valid header, drop it.
-            if(packetType > 0x00ff && (packetType & 0x00ff) == 0 && session != NULL)
+            if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
             {
-                switch(packetType)
-                {
-                case SESSIONOP_Disconnect:
-                case SESSIONOP_DataAck1:
-                case SESSIONOP_DataAck2:
-                case SESSIONOP_DataAck3:
-                case SESSIONOP_DataAck4:
-                case SESSIONOP_DataOrder1:
-                case SESSIONOP_DataOrder2:
-                case SESSIONOP_DataOrder3:
-                case SESSIONOP_DataOrder4:
-                case SESSIONOP_Ping:
-                {
-                    // Before we do anything else, check the CRC.
-                    uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());  // - 2 crc
-
-                    uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
-                    uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
-
-                    if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-                    {
-                        // CRC mismatch.  Dropping packet.
-                        //gLogger->hexDump(mReceivePacket->getData(),mReceivePacket->getSize());
-                        DLOG(INFO) << "DIS/ACK/ORDER/PING dropped.";
-                        continue;
-                    }
-
-                    // Decrypt the packet
-                    mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());
-
-                    // Send the packet to the session.
-                    session->HandleSessionPacket(mReceivePacket);
-                    mReceivePacket = mPacketFactory->CreatePacket();
-                }
-                break;
+                // CRC mismatch.  Dropping packet.
+                //gLogger->hexDump(mReceivePacket->getData(),mReceivePacket->getSize());
+                DLOG(INFO) << "DIS/ACK/ORDER/PING dropped.";
+                return;
+            }
 
-                case SESSIONOP_MultiPacket:
-                case SESSIONOP_NetStatRequest:
-                case SESSIONOP_NetStatResponse:
-                case SESSIONOP_DataChannel1:
-                case SESSIONOP_DataChannel2:
-                case SESSIONOP_DataChannel3:
-                case SESSIONOP_DataChannel4:
-                case SESSIONOP_DataFrag1:
-                case SESSIONOP_DataFrag2:
-                case SESSIONOP_DataFrag3:
-                case SESSIONOP_DataFrag4:
-                {
-                    // Before we do anything else, check the CRC.
-                    uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
-
-                    uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
-                    uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
-
-                    if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-                    {
-                        // CRC mismatch.  Dropping packet.
-
-                       LOG(INFO) << "Socket Read Thread: Reliable Packet dropped." << packetType << " CRC mismatch.";
-                        mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
-                        continue;
-                    }
-
-                    // Decrypt the packet
-                    mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
-
-                    // Decompress the packet
-                    decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 2, recvLen - 5, mDecompressPacket->getData() + 2, mDecompressPacket->getMaxPayload() - 5);
-
-                    if(decompressLen > 0)
-                    {
-                        mDecompressPacket->setIsCompressed(true);
-                        mDecompressPacket->setSize(decompressLen + 2); // add the packet header size
-                        *((uint16*)(mDecompressPacket->getData())) = *((uint16*)mReceivePacket->getData());
-                        session->HandleSessionPacket(mDecompressPacket);
-                        mDecompressPacket = mPacketFactory->CreatePacket();
-
-                        break;
-                    }
-                    else
-                    {
-                        // we have to remove comp/crc
-                        mReceivePacket->setSize(mReceivePacket->getSize() - 3);
-                    }
-                }
-
-                case SESSIONOP_SessionRequest:
-                case SESSIONOP_SessionResponse:
-                case SESSIONOP_FatalError:
-                case SESSIONOP_FatalErrorResponse:
-                    //case SESSIONOP_Reset:
-                {
-                    // Send the packet to the session.
-
-                    session->HandleSessionPacket(mReceivePacket);
-                    mReceivePacket = mPacketFactory->CreatePacket();
-                }
-                break;
+            // Decrypt the packet
+            mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());
 
-                default:
-                {
-                    DLOG(INFO) << "SocketReadThread: Dont know what todo with this packet! --tmr <3";
-                }
-                break;
+            // Send the packet to the session.
+            session->HandleSessionPacket(mReceivePacket);
+            mReceivePacket = mPacketFactory->CreatePacket();
+        }
+        break;
+
+        case SESSIONOP_MultiPacket:
+        case SESSIONOP_NetStatRequest:
+        case SESSIONOP_NetStatResponse:
+        case SESSIONOP_DataChannel1:
+        case SESSIONOP_DataChannel2:
+        case SESSIONOP_DataChannel3:
+        case SESSIONOP_DataChannel4:
+        case SESSIONOP_DataFrag1:
+        case SESSIONOP_DataFrag2:
+        case SESSIONOP_DataFrag3:
+        case SESSIONOP_DataFrag4:
+        {
+            // Before we do anything else, check the CRC.
+            uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
+
+            uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
+            uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
 
-                } //end switch(sessionOp)
+            if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
+            {
+                // CRC mismatch.  Dropping packet.
+
+               LOG(INFO) << "Socket Read Thread: Reliable Packet dropped." << packetType << " CRC mismatch.";
+                mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
+                return;
             }
-            // Validate that our data is actually fastpath
-            else if(packetTypeLow < 0x0d && session != NULL) // highest fastpath I've seen is 0x0b -tmr
+
+            // Decrypt the packet
+            mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
+
+            // Decompress the packet
+            decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 2, recvLen - 5, mDecompressPacket->getData() + 2, mDecompressPacket->getMaxPayload() - 5);
+
+            if(decompressLen > 0)
             {
-                // Before we do anything else, check the CRC.
-                uint32	packetCrc	= mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
-                uint8	crcLow		= (uint8)*(mReceivePacket->getData() + recvLen - 1);
-                uint8	crcHigh		= (uint8)*(mReceivePacket->getData() + recvLen - 2);
-
-                if(crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-                {
-                    // CRC mismatch.  Dropping packet.
-                    LOG(INFO) << "Packet dropped.  CRC mismatch.";
-                    continue;
-                }
-
-                // It's a 'fastpath' packet.  Send it directly up the data channel
-                mCompCryptor->Decrypt(mReceivePacket->getData() + 1, recvLen - 3, session->getEncryptKey());  // don't hardcode the header buffer or CRc len.
-
-                // Decompress the packet
-                decompressLen	= 0;
-                uint8 compFlag	= (uint8)*(mReceivePacket->getData() + recvLen - 3);
-
-                if(compFlag == 1)
-                {
-                    decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 1, recvLen - 4, mDecompressPacket->getData() + 1, mDecompressPacket->getMaxPayload() - 4);
-                }
-
-                if(decompressLen > 0)
-                {
-                    mDecompressPacket->setIsCompressed(true);
-                    mDecompressPacket->setSize(decompressLen + 1); // add the packet header size
-
-                    *((uint8*)(mDecompressPacket->getData())) = *((uint8*)mReceivePacket->getData());
-
-                    // send the packet up the stack
-                    session->HandleFastpathPacket(mDecompressPacket);
-                    mDecompressPacket = mPacketFactory->CreatePacket();
-                }
-                else
-                {
-                    // send the packet up the stack, remove comp/crc
-                    mReceivePacket->setSize(mReceivePacket->getSize() - 3);
-
-                    session->HandleFastpathPacket(mReceivePacket);
-                    mReceivePacket = mPacketFactory->CreatePacket();
-                }
+                mDecompressPacket->setIsCompressed(true);
+                mDecompressPacket->setSize(decompressLen + 2); // add the packet header size
+                *((uint16*)(mDecompressPacket->getData())) = *((uint16*)mReceivePacket->getData());
+                session->HandleSessionPacket(mDecompressPacket);
+                mDecompressPacket = mPacketFactory->CreatePacket();
+
+                break;
+            }
+            else
+            {
+                // we have to remove comp/crc
+                mReceivePacket->setSize(mReceivePacket->getSize() - 3);
             }
         }
 
-        boost::this_thread::sleep(boost::posix_time::microseconds(10));
+        case SESSIONOP_SessionRequest:
+        case SESSIONOP_SessionResponse:
+        case SESSIONOP_FatalError:
+        case SESSIONOP_FatalErrorResponse:
+            //case SESSIONOP_Reset:
+        {
+            // Send the packet to the session.
+
+            session->HandleSessionPacket(mReceivePacket);
+            mReceivePacket = mPacketFactory->CreatePacket();
+        }
+        break;
+
+        default:
+        {
+            DLOG(INFO) << "SocketReadThread: Dont know what todo with this packet! --tmr <3";
+        }
+        break;
+
+        } //end switch(sessionOp)
     }
+    // Validate that our data is actually fastpath
+    else if(packetTypeLow < 0x0d && session != NULL) // highest fastpath I've seen is 0x0b -tmr
+    {
+        // Before we do anything else, check the CRC.
+        uint32	packetCrc	= mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
+        uint8	crcLow		= (uint8)*(mReceivePacket->getData() + recvLen - 1);
+        uint8	crcHigh		= (uint8)*(mReceivePacket->getData() + recvLen - 2);
 
-    // Shutdown internally
-    _shutdown();
+        if(crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
+        {
+            // CRC mismatch.  Dropping packet.
+            LOG(INFO) << "Packet dropped.  CRC mismatch.";
+            return;
+        }
+
+        // It's a 'fastpath' packet.  Send it directly up the data channel
+        mCompCryptor->Decrypt(mReceivePacket->getData() + 1, recvLen - 3, session->getEncryptKey());  // don't hardcode the header buffer or CRc len.
+
+        // Decompress the packet
+        decompressLen	= 0;
+        uint8 compFlag	= (uint8)*(mReceivePacket->getData() + recvLen - 3);
+
+        if(compFlag == 1)
+        {
+            decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 1, recvLen - 4, mDecompressPacket->getData() + 1, mDecompressPacket->getMaxPayload() - 4);
+        }
+
+        if(decompressLen > 0)
+        {
+            mDecompressPacket->setIsCompressed(true);
+            mDecompressPacket->setSize(decompressLen + 1); // add the packet header size
+
+            *((uint8*)(mDecompressPacket->getData())) = *((uint8*)mReceivePacket->getData());
+
+            // send the packet up the stack
+            session->HandleFastpathPacket(mDecompressPacket);
+            mDecompressPacket = mPacketFactory->CreatePacket();
+        }
+        else
+        {
+            // send the packet up the stack, remove comp/crc
+            mReceivePacket->setSize(mReceivePacket->getSize() - 3);
+
+            session->HandleFastpathPacket(mReceivePacket);
+            mReceivePacket = mPacketFactory->CreatePacket();
+        }
+    }
 }
 
 //======================================================================================================================
@@ -460,12 +582,91 @@ void SocketReadThread::NewOutgoingConnection(const int8* address, uint16 port)
 
 //======================================================================================================================
 
+void SocketReadThread::QueueOutgoingConnection(NetworkClient* client, const int8* address, uint16 port, uint32 timeout)
+{
+    PendingConnection* connection = new PendingConnection();
+    connection->mAddress = address;
+    connection->mClient = client;
+    connection->mTimeout = timeout;
+    connection->mPort = port;
+
+    mPendingConnections.push(connection);
+}
+
+//======================================================================================================================
+
+void SocketReadThread::_openConnection(PendingConnection* connection)
+{
+    SOCKET socket = ::socket(PF_INET, SOCK_DGRAM, 0);
+
+    // port 0 lets the os pick a free port
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = 0;
+    local.sin_addr.s_addr = INADDR_ANY;
+
+    if(socket != INVALID_SOCKET && ::bind(socket, (struct sockaddr*)&local, sizeof(local)) != 0)
+    {
+        closesocket(socket);
+        socket = INVALID_SOCKET;
+    }
+
+    // without a socket of its own the session shares ours, one such session per remote endpoint
+    if(socket == INVALID_SOCKET)
+    {
+        LOG(WARNING) << "Could not open a socket for the connection to " << connection->mAddress << ":" << connection->mPort;
+    }
+
+    Session* newSession = mSessionFactory->CreateSession();
+    newSession->setCommand(SCOM_Connect);
+    newSession->setAddress(inet_addr(connection->mAddress.c_str()));
+    newSession->setPort(htons(connection->mPort));
+    newSession->setResendWindowSize(mSessionResendWindowSize);
+    newSession->setConnectTimeout(connection->mTimeout);
+    newSession->setNotifyConnect(true);
+    newSession->setOwnSocket(socket);
+
+    // the client only gets the session once it is connected, but hears about a failed connect
+    newSession->setClient(connection->mClient);
+
+    {
+        boost::mutex::scoped_lock lk(mSocketReadMutex);
+
+        if(socket != INVALID_SOCKET)
+        {
+            mSocketSessionMap.insert(std::make_pair(socket, newSession));
+        }
+        else
+        {
+            uint64 hash = newSession->getAddress() | (((uint64)newSession->getPort()) << 32);
+            mAddressSessionMap.insert(std::make_pair(hash, newSession));
+        }
+    }
+
+    mSocketWriteThread->NewSession(newSession);
+}
+
+//======================================================================================================================
+
 void SocketReadThread::RemoveAndDestroySession(Session* session)
 {
     if (! session) {
         return;
     }
 
+    // sessions with a socket of their own are not in the address map
+    if(session->getOwnSocket() != INVALID_SOCKET)
+    {
+        boost::mutex::scoped_lock lk(mSocketReadMutex);
+
+        mSocketSessionMap.erase(session->getOwnSocket());
+        mClosedSockets.push_back(session->getOwnSocket());
+
+        mSessionFactory->DestroySession(session);
+        return;
+    }
+
     // Find and remove the session from the address map.
     uint64 hash = session->getAddress() | (((uint64)session->getPort()) << 32);
 
@@ -29,11 +29,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define ANH_NETWORKMANAGER_SOCKETREADTHREAD_H
 
 #include "Utils/typedefs.h"
+#include "Utils/ConcurrentQueue.h"
 #include "NetworkConfig.h"
+#include "Socket.h"
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 #include <list>
 #include <map>
+#include <string>
+#include <vector>
 
 //======================================================================================================================
 
@@ -42,6 +46,7 @@ class PacketFactory;
 class SessionFactory;
 class MessageFactory;
 class CompCryptor;
+class NetworkClient;
 class Session;
 class Service;
 class Packet;
@@ -50,6 +55,7 @@ class Packet;
 
 typedef std::list<Session*>			SessionList;
 typedef std::map<uint64,Session*>	AddressSessionMap;
+typedef std::map<SOCKET,Session*>	SocketSessionMap;
 
 
 //======================================================================================================================
@@ -65,15 +71,31 @@ public:
 
 //======================================================================================================================
 
+class PendingConnection
+{
+public:
+
+    std::string       mAddress;
+    NetworkClient*    mClient;
+    uint32            mTimeout;
+    uint16            mPort;
+};
+
+typedef utils::ConcurrentQueue<PendingConnection*>	PendingConnectionQueue;
+
+//======================================================================================================================
+
 class SocketReadThread
 {
 public:
-    SocketReadThread(SOCKET socket, SocketWriteThread* writeThread, Service* service,uint32 mfHeapSize, bool serverservice, NetworkConfig& network_configuration_);
+    SocketReadThread(SOCKET socket, SocketWriteThread* writeThread, Service* service,uint32 mfHeapSize, bool serverservice, bool ownSockets, NetworkConfig& network_configuration_);
     ~SocketReadThread();
 
     virtual void					run();
 
     void                          NewOutgoingConnection(const int8* address, uint16 port);
+    // bot services only, the session gets a udp socket of its own
+    void                          QueueOutgoingConnection(NetworkClient* client, const int8* address, uint16 port, uint32 timeout);
     void                          RemoveAndDestroySession(Session* session);
 
     NewConnection*                getNewConnectionInfo(void)  {
@@ -91,6 +113,11 @@ protected:
     void                          _startup(void);
     void                          _shutdown(void);
 
+    void                          _runOwnSockets(void);
+    void                          _openNewConnection(void);
+    void                          _openConnection(PendingConnection* connection);
+    void                          _receive(SOCKET socket);
+
     Packet*                       mReceivePacket;
     Packet*                       mDecompressPacket;
 
@@ -105,12 +132,16 @@ protected:
     SOCKET                        mSocket;
 
     bool							mIsRunning;
+    bool                          mOwnSockets;     // sessions connected through ConnectAsync read and write their own socket
 
     uint32						mSessionResendWindowSize;
 
     boost::thread 				mThread;
     boost::mutex					mSocketReadMutex;
     AddressSessionMap             mAddressSessionMap;
+    SocketSessionMap              mSocketSessionMap;
+    std::vector<SOCKET>           mClosedSockets;
+    PendingConnectionQueue        mPendingConnections;
 
     bool							mExit;
 };
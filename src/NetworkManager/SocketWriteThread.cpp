@@ -298,7 +298,9 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
     }
 
     //LOG(INFO) << "Sending message to " << session->getAddressString() << " on port " << ntohs(session->getPort());
-    sent = sendto(mSocket, mSendBuffer, outLen, 0, &toAddr, toLen);
+    SOCKET socket = session->getOwnSocket() != INVALID_SOCKET ? session->getOwnSocket() : mSocket;
+
+    sent = sendto(socket, mSendBuffer, outLen, 0, &toAddr, toLen);
 
     if (sent < 0)
     {
@@ -0,0 +1,275 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "NetworkManager/LocalLink.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "NetworkManager/Message.h"
+#include "NetworkManager/MessageFactory.h"
+#include "NetworkManager/NetworkConfig.h"
+#include "NetworkManager/NetworkManager.h"
+#include "NetworkManager/Service.h"
+
+#include "Utils/clock.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+std::string tempPath(const char* name) {
+    std::stringstream path;
+    path << "/tmp/anh_" << name << "_" << getpid();
+    return path.str();
+}
+
+class LocalLinkTest : public testing::Test {
+protected:
+    LocalLinkTest()
+        : factory_(0)
+        , near_(0)
+        , far_(0)
+    {
+        Anh_Utils::Clock::Init();
+        factory_ = new MessageFactory(32 * 1024 * 1024);
+
+        int sockets[2];
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+
+        near_ = new LocalLink(sockets[0], 0, -1);
+        far_ = new LocalLink(sockets[1], 0, -1);
+    }
+
+    ~LocalLinkTest() {
+        delete near_;
+        delete far_;
+        delete factory_;
+    }
+
+    // sends a message of the given size carrying its sequence in the payload and routing header
+    bool send(LocalLink* link, uint32 sequence, uint16 size) {
+        factory_->StartMessage();
+        factory_->addUint32(sequence);
+
+        for (uint16 i = 4; i < size; ++i) {
+            factory_->addUint8(static_cast<uint8>(sequence + i));
+        }
+
+        Message* message = factory_->EndMessage();
+        message->setAccountId(sequence * 3);
+        message->setRouted(true);
+        message->setDestinationId(static_cast<uint8>(sequence));
+        message->setPriority(5);
+
+        bool sent = link->Send(message);
+        factory_->DestroyMessage(message);
+
+        return sent;
+    }
+
+    // writes queued output of the sender and reads the receiver until count messages arrived
+    uint32 receive(LocalLink* sender, LocalLink* receiver, uint32 count, uint16 size) {
+        uint32 received = 0;
+
+        for (int round = 0; round < 100000 && received < count; ++round) {
+            if (!sender->Flush() || !receiver->Fill()) {
+                break;
+            }
+
+            Message* message = 0;
+
+            while (receiver->NextMessage(factory_, message)) {
+                EXPECT_EQ(size, message->getSize());
+                EXPECT_EQ(received, message->getUint32());
+                EXPECT_EQ(received * 3, message->getAccountId());
+                EXPECT_TRUE(message->getRouted());
+                EXPECT_EQ(static_cast<uint8>(received), message->getDestinationId());
+                EXPECT_EQ(5, message->getPriority());
+
+                factory_->DestroyMessage(message);
+                ++received;
+            }
+        }
+
+        return received;
+    }
+
+    MessageFactory* factory_;
+    LocalLink* near_;
+    LocalLink* far_;
+};
+
+/*! Two links sending to each other while neither reads queue their output
+* instead of blocking, the queued frames arrive intact and in order once the
+* other side reads again.
+*/
+TEST_F(LocalLinkTest, SendingToAPeerThatDoesNotReadNeverBlocks) {
+    const uint32 count = 2000;
+
+    for (uint32 i = 0; i < count; ++i) {
+        ASSERT_TRUE(send(near_, i, 1000));
+        ASSERT_TRUE(send(far_, i, 1000));
+    }
+
+    EXPECT_TRUE(near_->hasPendingOutput());
+    EXPECT_TRUE(far_->hasPendingOutput());
+
+    EXPECT_EQ(count, receive(near_, far_, count, 1000));
+    EXPECT_EQ(count, receive(far_, near_, count, 1000));
+
+    EXPECT_FALSE(near_->hasPendingOutput());
+    EXPECT_FALSE(far_->hasPendingOutput());
+    EXPECT_FALSE(near_->hasPendingFrame());
+}
+
+/*! Frames split across reads are put together again, a partial frame is not
+* handed out.
+*/
+TEST_F(LocalLinkTest, PartialFramesWaitForTheirRest) {
+    ASSERT_TRUE(send(near_, 0, 0xffff));
+    ASSERT_TRUE(send(near_, 1, 0xffff));
+    ASSERT_TRUE(send(near_, 2, 0xffff));
+
+    EXPECT_EQ(3u, receive(near_, far_, 3, 0xffff));
+}
+
+/*! A frame longer than any message breaks the link once the reader got to it.
+*/
+TEST_F(LocalLinkTest, OversizedFramesBreakTheLink) {
+    int8 header[LocalLink::HeaderSize];
+    memset(header, 0, sizeof(header));
+
+    uint32 size = 0x10000;
+    memcpy(header, &size, 4);
+
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(header)), ::send(near_->getSocket(), header, sizeof(header), 0));
+
+    Message* message = 0;
+    EXPECT_TRUE(far_->Fill());
+    EXPECT_FALSE(far_->NextMessage(factory_, message));
+    EXPECT_TRUE(far_->hasReadError());
+    EXPECT_FALSE(far_->Fill());
+}
+
+/*! A closed link refuses further messages but keeps what it queued, the
+* socket only goes down once it is shut down.
+*/
+TEST_F(LocalLinkTest, ClosedLinksKeepTheirQueuedOutput) {
+    for (uint32 i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(send(near_, i, 1000));
+    }
+
+    near_->Close();
+    EXPECT_FALSE(send(near_, 1000, 1000));
+    EXPECT_TRUE(near_->hasPendingOutput());
+    EXPECT_FALSE(near_->isShutdown());
+
+    EXPECT_EQ(1000u, receive(near_, far_, 1000, 1000));
+
+    near_->Shutdown();
+    EXPECT_FALSE(far_->Fill());
+}
+
+/*! The connecting side hands its address and port over in the handshake.
+*/
+TEST(LocalLinkHandshakeTests, AcceptedLinksReadTheHandshake) {
+    std::string path = tempPath("locallink_handshake");
+
+    int listener = LocalLink::Listen(path);
+    ASSERT_GE(listener, 0);
+
+    EXPECT_LT(LocalLink::Accept(listener), 0);
+
+    int connected = LocalLink::Connect(path, 0x0100007f, 0x1234);
+    ASSERT_GE(connected, 0);
+
+    int accepted = LocalLink::Accept(listener);
+    ASSERT_GE(accepted, 0);
+
+    int8 handshake[LocalLink::HandshakeSize];
+    uint32 received = 0;
+    uint32 address = 0;
+    uint16 port = 0;
+
+    EXPECT_EQ(1, LocalLink::ReadHandshake(accepted, handshake, received, address, port));
+    EXPECT_EQ(0x0100007fu, address);
+    EXPECT_EQ(0x1234, port);
+
+    LocalLink::CloseSocket(connected);
+    LocalLink::CloseSocket(accepted);
+    LocalLink::CloseSocket(listener);
+    unlink(path.c_str());
+}
+
+/*! A handshake arriving in pieces is read as far as it got, a link that goes
+* down before it is complete is reported.
+*/
+TEST(LocalLinkHandshakeTests, PartialHandshakesWaitForTheirRest) {
+    int sockets[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+    ASSERT_TRUE(LocalLink::SetNonBlocking(sockets[1]));
+
+    int8 handshake[LocalLink::HandshakeSize];
+    uint32 received = 0;
+    uint32 address = 0;
+    uint16 port = 0;
+
+    EXPECT_EQ(0, LocalLink::ReadHandshake(sockets[1], handshake, received, address, port));
+
+    int8 part[3] = {1, 2, 3};
+    ASSERT_EQ(3, ::send(sockets[0], part, sizeof(part), 0));
+
+    EXPECT_EQ(0, LocalLink::ReadHandshake(sockets[1], handshake, received, address, port));
+    EXPECT_EQ(3u, received);
+
+    close(sockets[0]);
+    EXPECT_EQ(-1, LocalLink::ReadHandshake(sockets[1], handshake, received, address, port));
+
+    close(sockets[1]);
+}
+
+/*! A peer that connects but never sends its handshake does not hold up the
+* service, its link is dropped after the handshake timeout.
+*/
+TEST(LocalLinkHandshakeTests, LinksWithoutHandshakeAreDropped) {
+    Anh_Utils::Clock::Init();
+    MessageFactory::getSingleton(8192);
+
+    NetworkManager network_manager(NetworkConfig(1400, 1400, 496, 496, 800, 800, 8192));
+    Service* service = network_manager.GenerateService((char*)"127.0.0.1", 0, 1024 * 1024, false);
+
+    std::string path = tempPath("locallink_timeout");
+    ASSERT_TRUE(service->ListenLocal(path));
+
+    sockaddr_un remote;
+    memset(&remote, 0, sizeof(remote));
+    remote.sun_family = AF_UNIX;
+    strcpy(remote.sun_path, path.c_str());
+
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_EQ(0, connect(s, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)));
+
+    // still waiting for the handshake
+    pollfd pfd = {s, POLLIN, 0};
+    EXPECT_EQ(0, poll(&pfd, 1, 3000));
+
+    // dropped once the timeout passed
+    ASSERT_EQ(1, poll(&pfd, 1, 5000));
+
+    char byte;
+    EXPECT_EQ(0, recv(s, &byte, 1, 0));
+
+    close(s);
+    network_manager.DestroyService(service);
+}
+
+}
@@ -0,0 +1,218 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "NetworkManager/MulticastEnvelope.h"
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "NetworkManager/DispatchClient.h"
+#include "NetworkManager/Message.h"
+#include "NetworkManager/MessageFactory.h"
+#include "NetworkManager/MessageOpcodes.h"
+
+#include "Utils/clock.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+struct SentEnvelope {
+    Message* message;
+    uint32 account_id;
+    uint8 server_id;
+    uint8 priority;
+    bool unreliable;
+};
+
+// keeps what SendChannelAMulticast hands to the link instead of sending it
+class CapturingDispatchClient : public DispatchClient {
+public:
+    virtual void SendChannelA(Message* message, uint32 accountId, uint8 serverId, uint8 priority) {
+        SentEnvelope sent = { message, accountId, serverId, priority, false };
+        sent_.push_back(sent);
+    }
+
+    virtual void SendChannelAUnreliable(Message* message, uint32 accountId, uint8 serverId, uint8 priority) {
+        SentEnvelope sent = { message, accountId, serverId, priority, true };
+        sent_.push_back(sent);
+    }
+
+    std::vector<SentEnvelope> sent_;
+};
+
+struct Client {
+    uint32 account_id;
+};
+
+class MulticastEnvelopeTest : public testing::Test {
+protected:
+    MulticastEnvelopeTest() {
+        Anh_Utils::Clock::Init();
+        MessageFactory::getSingleton(8 * 1024);
+    }
+
+    ~MulticastEnvelopeTest() {
+        for (std::vector<SentEnvelope>::iterator it = client_.sent_.begin(); it != client_.sent_.end(); ++it) {
+            gMessageFactory->DestroyMessage(it->message);
+        }
+    }
+
+    Message* payload() {
+        gMessageFactory->StartMessage();
+        gMessageFactory->addUint32(0xcafef00d);
+
+        for (uint8 i = 0; i < 100; ++i) {
+            gMessageFactory->addUint8(i);
+        }
+
+        return gMessageFactory->EndMessage();
+    }
+
+    // reads an envelope the way the connectionserver gets it, after the opcode
+    bool read(Message* message, MulticastEnvelope& envelope) {
+        message->ResetIndex();
+        EXPECT_EQ(static_cast<uint32>(opClusterMulticast), message->getUint32());
+
+        return envelope.Read(message);
+    }
+
+    CapturingDispatchClient client_;
+};
+
+/*! Recipients past MaxMulticastRecipients go into further envelopes. Read
+* back, the envelopes name every account once, in order, and each carries the
+* whole payload and the send options.
+*/
+TEST_F(MulticastEnvelopeTest, SplitsAtMaxRecipientsAndReadsBack) {
+    const uint32 max = DispatchClient::MaxMulticastRecipients;
+
+    std::vector<uint32> account_ids;
+    for (uint32 i = 0; i < 2 * max + 76; ++i) {
+        account_ids.push_back(1000 + i * 7);
+    }
+
+    Message* original = payload();
+    std::vector<int8> expected(original->getData(), original->getData() + original->getSize());
+
+    client_.SendChannelAMulticast(original, account_ids, 3, true);
+
+    ASSERT_EQ(3u, client_.sent_.size());
+
+    std::vector<uint32> read_ids;
+    const uint32 counts[] = { max, max, 76 };
+
+    for (size_t i = 0; i < client_.sent_.size(); ++i) {
+        const SentEnvelope& sent = client_.sent_[i];
+
+        EXPECT_EQ(static_cast<uint8>(CR_Connection), sent.server_id);
+        EXPECT_EQ(0u, sent.account_id);
+        EXPECT_EQ(3, sent.priority);
+        EXPECT_TRUE(sent.unreliable);
+
+        MulticastEnvelope envelope;
+        ASSERT_TRUE(read(sent.message, envelope));
+
+        EXPECT_EQ(3, envelope.getPriority());
+        EXPECT_TRUE(envelope.getUnreliable());
+        EXPECT_EQ(counts[i], envelope.getAccountIds().size());
+        read_ids.insert(read_ids.end(), envelope.getAccountIds().begin(), envelope.getAccountIds().end());
+
+        Message* copy = envelope.CopyPayload();
+        ASSERT_EQ(expected.size(), copy->getSize());
+        EXPECT_EQ(0, memcmp(&expected[0], copy->getData(), expected.size()));
+        gMessageFactory->DestroyMessage(copy);
+    }
+
+    EXPECT_EQ(account_ids, read_ids);
+}
+
+/*! A list that fits sends a single reliable envelope, an empty list sends
+* nothing.
+*/
+TEST_F(MulticastEnvelopeTest, SendsOneEnvelopeForShortLists) {
+    client_.SendChannelAMulticast(payload(), std::vector<uint32>(1, 42), 5);
+
+    ASSERT_EQ(1u, client_.sent_.size());
+    EXPECT_FALSE(client_.sent_[0].unreliable);
+
+    MulticastEnvelope envelope;
+    ASSERT_TRUE(read(client_.sent_[0].message, envelope));
+    EXPECT_FALSE(envelope.getUnreliable());
+    EXPECT_EQ(std::vector<uint32>(1, 42), envelope.getAccountIds());
+
+    client_.SendChannelAMulticast(payload(), std::vector<uint32>(), 5);
+    EXPECT_EQ(1u, client_.sent_.size());
+}
+
+/*! An envelope cut short within its header or its recipient list is
+* rejected, one cut within the payload still reads but carries less payload.
+*/
+TEST_F(MulticastEnvelopeTest, RejectsTruncatedEnvelopes) {
+    std::vector<uint32> account_ids;
+    for (uint32 i = 0; i < 10; ++i) {
+        account_ids.push_back(i + 1);
+    }
+
+    client_.SendChannelAMulticast(payload(), account_ids, 5);
+    ASSERT_EQ(1u, client_.sent_.size());
+
+    Message* message = client_.sent_[0].message;
+    uint16 size = message->getSize();
+    const uint16 payload_start = 4 + 4 + 10 * 4;
+
+    // the opcode alone, half the header, all but the last account id
+    const uint16 cuts[] = { 4, 6, payload_start - 1 };
+
+    for (size_t i = 0; i < sizeof(cuts) / sizeof(cuts[0]); ++i) {
+        message->setSize(cuts[i]);
+
+        MulticastEnvelope envelope;
+        EXPECT_FALSE(read(message, envelope)) << "cut at " << cuts[i];
+    }
+
+    message->setSize(payload_start + 2);
+
+    MulticastEnvelope short_payload;
+    ASSERT_TRUE(read(message, short_payload));
+    EXPECT_EQ(2u, short_payload.getPayloadSize());
+
+    message->setSize(size);
+}
+
+/*! Accounts without a client, logged out since the backend sent, are
+* skipped and the others still get the message.
+*/
+TEST_F(MulticastEnvelopeTest, SkipsAccountsThatLoggedOut) {
+    std::vector<uint32> account_ids;
+    for (uint32 i = 1; i <= 6; ++i) {
+        account_ids.push_back(i);
+    }
+
+    client_.SendChannelAMulticast(payload(), account_ids, 5);
+
+    MulticastEnvelope envelope;
+    ASSERT_TRUE(read(client_.sent_[0].message, envelope));
+
+    std::map<uint32, Client> online;
+    const uint32 online_ids[] = { 1, 3, 4, 6 };
+    for (size_t i = 0; i < sizeof(online_ids) / sizeof(online_ids[0]); ++i) {
+        Client client = { online_ids[i] };
+        online[online_ids[i]] = client;
+    }
+
+    std::vector<Client*> recipients = envelope.FindRecipients<Client>([&online] (uint32 account_id) -> Client* {
+        std::map<uint32, Client>::iterator it = online.find(account_id);
+        return (it != online.end()) ? &it->second : NULL;
+    });
+
+    ASSERT_EQ(4u, recipients.size());
+    for (size_t i = 0; i < recipients.size(); ++i) {
+        EXPECT_EQ(online_ids[i], recipients[i]->account_id);
+    }
+}
+
+}
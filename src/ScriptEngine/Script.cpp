@@ -56,7 +56,7 @@ Script::Script(ScriptEngine* scriptEngine) :
     mTime(0),
     mWaitFrame(0)
 {
-    mThreadState = lua_newthread(mEngine->getMasterState());
+    mThreadState = mEngine->acquireThread(mThreadRef);
 
     lua_pushlightuserdata(mEngine->getMasterState(),mThreadState);
     lua_pushlightuserdata(mEngine->getMasterState(),this);
@@ -79,7 +79,8 @@ void Script::run()
     assert(mEngine->getMasterState() && "Invalid engine master state");
     assert(mThreadState && "Invalid thread state");
 
-    if(luaL_loadfile(mThreadState,mFile) == 0)
+    // compiled once per file, every instance shares the chunk
+    if(mEngine->loadFile(mThreadState,mFile))
     {
         _resumeScript(0);
     }
@@ -96,7 +97,7 @@ void Script::runFile(const int8 *fileName)
     assert(mEngine->getMasterState() && "Invalid engine master state");
     assert(mThreadState && "Invalid thread state");
 
-    if(luaL_loadfile(mThreadState,fileName) == 0)
+    if(mEngine->loadFile(mThreadState,fileName))
     {
         _resumeScript(0);
     }
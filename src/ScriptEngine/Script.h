@@ -110,6 +110,7 @@ private:
     Tutorial*			mTutorial;
 
     lua_State*		mThreadState;
+    int				mThreadRef;
     uint32			mPriority;
     int8			mFile[256];
     int8			mLastError[256];
@@ -0,0 +1,267 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "ScriptCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+#include <boost/thread/thread.hpp>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+extern "C"
+{
+#include "lua.h"
+#include "lualib.h"
+#include "lauxlib.h"
+}
+
+// Fix for issues with glog redefining this constant
+#ifdef ERROR
+#undef ERROR
+#endif
+
+#include <glog/logging.h>
+
+#include "Common/Crc.h"
+
+namespace {
+
+// lua_dump writer, collects the bytecode of a chunk
+int writeChunk(lua_State* l, const void* data, size_t size, void* out)
+{
+    static_cast<std::string*>(out)->append(static_cast<const char*>(data), size);
+    return 0;
+}
+
+bool isBytecode(const std::string& chunk)
+{
+    return !chunk.empty() && chunk[0] == LUA_SIGNATURE[0];
+}
+
+}
+
+//======================================================================================================================
+
+ScriptCache::ScriptCache(lua_State* masterState, const std::string& directory)
+    : mMasterState(masterState)
+    , mDirectory(directory)
+{
+    if(mDirectory.empty())
+        return;
+
+#ifdef _WIN32
+    _mkdir(mDirectory.c_str());
+#else
+    mkdir(mDirectory.c_str(), 0755);
+#endif
+}
+
+//======================================================================================================================
+
+ScriptCache::~ScriptCache()
+{
+    // the chunks go away with the master state
+}
+
+//======================================================================================================================
+
+bool ScriptCache::load(lua_State* state, const int8* fileName)
+{
+    ChunkMap::iterator it = mChunks.find(fileName);
+
+    if(it == mChunks.end())
+    {
+        if(!_compile(fileName))
+        {
+            // hand the error message to the caller, like luaL_loadfile would
+            lua_xmove(mMasterState, state, 1);
+            return false;
+        }
+
+        it = mChunks.insert(std::make_pair(std::string(fileName), luaL_ref(mMasterState, LUA_REGISTRYINDEX))).first;
+    }
+
+    // threads share the registry of the master state
+    lua_rawgeti(state, LUA_REGISTRYINDEX, it->second);
+
+    return true;
+}
+
+//======================================================================================================================
+
+void ScriptCache::clear()
+{
+    ChunkMap::iterator it = mChunks.begin();
+
+    while(it != mChunks.end())
+    {
+        luaL_unref(mMasterState, LUA_REGISTRYINDEX, it->second);
+        ++it;
+    }
+
+    mChunks.clear();
+}
+
+//======================================================================================================================
+
+bool ScriptCache::_compile(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+
+    if(!file)
+    {
+        lua_pushfstring(mMasterState, "cannot open %s", fileName.c_str());
+        return false;
+    }
+
+    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // luaL_loadfile skips a leading # line, keep its newline so line numbers don't shift
+    if(!source.empty() && source[0] == '#')
+    {
+        source.erase(0, source.find('\n') == std::string::npos ? source.size() : source.find('\n'));
+    }
+
+    std::string chunkName = "@" + fileName;
+    std::string cacheName;
+
+    // precompiled files don't need another copy
+    bool useDiskCache = isDiskCacheEnabled() && !isBytecode(source);
+
+    if(useDiskCache)
+    {
+        // the file name is part of the key, it ends up in the error messages of the chunk
+        cacheName = _getCacheName(fileName + '\0' + source);
+
+        if(_loadBytecode(cacheName, chunkName))
+            return true;
+    }
+
+    if(luaL_loadbuffer(mMasterState, source.data(), source.size(), chunkName.c_str()) != 0)
+        return false;
+
+    if(useDiskCache)
+        _storeBytecode(cacheName);
+
+    return true;
+}
+
+//======================================================================================================================
+
+bool ScriptCache::_loadBytecode(const std::string& cacheName, const std::string& chunkName)
+{
+    std::ifstream file(cacheName.c_str(), std::ios::in | std::ios::binary);
+
+    if(!file)
+        return false;
+
+    std::string bytecode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // never run a cache file as source
+    if(!isBytecode(bytecode))
+    {
+        LOG(WARNING) << "ScriptCache::_loadBytecode: discarding invalid cache file " << cacheName;
+        return false;
+    }
+
+    // lua refuses bytecode of a different version or number type
+    if(luaL_loadbuffer(mMasterState, bytecode.data(), bytecode.size(), chunkName.c_str()) != 0)
+    {
+        LOG(WARNING) << "ScriptCache::_loadBytecode: discarding stale cache file " << cacheName << " : " << lua_tostring(mMasterState, -1);
+        lua_pop(mMasterState, 1);
+        return false;
+    }
+
+    return true;
+}
+
+//======================================================================================================================
+
+void ScriptCache::_storeBytecode(const std::string& cacheName)
+{
+    std::string bytecode;
+
+    // dumps the chunk on top of the stack and leaves it there
+    if(lua_dump(mMasterState, writeChunk, &bytecode) != 0 || bytecode.empty())
+        return;
+
+    // write to a private file first and rename it, other zones may be reading the same cache
+    std::ostringstream tempName;
+#ifdef _WIN32
+    tempName << cacheName << "." << _getpid() << "." << boost::this_thread::get_id();
+#else
+    tempName << cacheName << "." << getpid() << "." << boost::this_thread::get_id();
+#endif
+
+    {
+        std::ofstream file(tempName.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if(file)
+            file.write(bytecode.data(), bytecode.size());
+
+        if(!file)
+        {
+            LOG(WARNING) << "ScriptCache::_storeBytecode: unable to write " << tempName.str();
+            file.close();
+            std::remove(tempName.str().c_str());
+            return;
+        }
+    }
+
+    if(std::rename(tempName.str().c_str(), cacheName.c_str()) != 0)
+    {
+        // someone else got there first
+        std::remove(tempName.str().c_str());
+    }
+}
+
+//======================================================================================================================
+
+std::string ScriptCache::_getCacheName(const std::string& key) const
+{
+    std::ostringstream name;
+
+    name << mDirectory << "/" << std::hex << std::setfill('0')
+         << std::setw(8) << common::memcrc(key) << "-" << key.size() << ".luac";
+
+    return name.str();
+}
+
+//======================================================================================================================
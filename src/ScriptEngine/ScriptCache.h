@@ -0,0 +1,86 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_SCRIPTENGINE_SCRIPTCACHE_H
+#define ANH_SCRIPTENGINE_SCRIPTCACHE_H
+
+#include <map>
+#include <string>
+
+#include "Utils/typedefs.h"
+
+typedef struct lua_State lua_State;
+
+//======================================================================================================================
+//
+// Compiles every script file once. The main chunk of a file is kept in the
+// registry of the master state, scripts push it onto their own thread and run
+// it from there, so all instances of a script share one function prototype.
+//
+// With a directory set, compiled chunks are also written to disk under the
+// checksum of their name and source, the next boot loads the bytecode instead of
+// parsing the file. Editing a script changes its checksum, stale entries are
+// simply never read again. An empty directory disables the disk cache.
+//
+
+class ScriptCache
+{
+public:
+
+    ScriptCache(lua_State* masterState, const std::string& directory);
+    ~ScriptCache();
+
+    bool			isDiskCacheEnabled() const { return !mDirectory.empty(); }
+
+    // pushes the main chunk of fileName onto state, like luaL_loadfile
+    // on failure the error message is pushed instead and false is returned
+    bool			load(lua_State* state, const int8* fileName);
+
+    // forgets all compiled chunks, scripts changed on disk are compiled again on their next load
+    void			clear();
+
+private:
+
+    // leaves the compiled chunk or the error message on the master state
+    bool			_compile(const std::string& fileName);
+
+    bool			_loadBytecode(const std::string& cacheName, const std::string& chunkName);
+    void			_storeBytecode(const std::string& cacheName);
+
+    std::string		_getCacheName(const std::string& key) const;
+
+    typedef std::map<std::string,int>	ChunkMap;
+
+    lua_State*		mMasterState;
+    std::string		mDirectory;
+    ChunkMap		mChunks;
+};
+
+//======================================================================================================================
+
+#endif
@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ScriptEngine.h"
 
 #include "Script.h"
+#include "ScriptCache.h"
 #include "ScriptEngineLib.h"
 
 #include "glue_files/tolua++.h"
@@ -50,9 +51,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 bool			ScriptEngine::mInsFlag    = false;
 ScriptEngine*	ScriptEngine::mSingleton  = NULL;
 
+// finished threads kept for reuse, a thread costs about a kilobyte
+static const size_t	kMaxIdleThreads = 64;
+
 //======================================================================================================================
 
-ScriptEngine::ScriptEngine() :
+ScriptEngine::ScriptEngine(const std::string& scriptCache) :
     mScriptPool(sizeof(Script))
 {
     mMasterState = luaL_newstate();
@@ -66,6 +70,8 @@ ScriptEngine::ScriptEngine() :
     // our custom libs
     tolua_LuaInterface_open(mMasterState);
 
+    mScriptCache = new ScriptCache(mMasterState, scriptCache);
+
     // We do have a global clock object, don't use seperate clock and times for every process.
     // mClock = new Anh_Utils::Clock();
 
@@ -74,11 +80,11 @@ ScriptEngine::ScriptEngine() :
 
 //======================================================================================================================
 
-ScriptEngine*	ScriptEngine::Init()
+ScriptEngine*	ScriptEngine::Init(const std::string& scriptCache)
 {
     if(!mInsFlag)
     {
-        mSingleton = new ScriptEngine();
+        mSingleton = new ScriptEngine(scriptCache);
         mInsFlag = true;
         return mSingleton;
     }
@@ -93,6 +99,8 @@ ScriptEngine::~ScriptEngine()
     mInsFlag = false;
     // delete(mSingleton);
     mSingleton = NULL;
+
+    delete mScriptCache;
 }
 
 //======================================================================================================================
@@ -111,6 +119,9 @@ void ScriptEngine::shutdown()
 
     lk.unlock();
 
+    mScriptCache->clear();
+    mIdleThreads.clear();
+
     if(mMasterState)
     {
         lua_close(mMasterState);
@@ -168,6 +179,7 @@ void ScriptEngine::removeScript(Script* script)
         {
             DLOG(INFO) << "ScriptEngine::removeScript found a script";
             (*it)->mState = SS_Not_Loaded;
+            releaseThread((*it)->mThreadState,(*it)->mThreadRef);
             mScriptPool.free(*it);
             mScripts.erase(it);
             break;
@@ -178,6 +190,60 @@ void ScriptEngine::removeScript(Script* script)
 
 //======================================================================================================================
 
+bool ScriptEngine::loadFile(lua_State* state,const int8* fileName)
+{
+    return mScriptCache->load(state,fileName);
+}
+
+//======================================================================================================================
+//
+// threads are anchored in the registry, a thread left on the master stack is never collected
+//
+
+lua_State* ScriptEngine::acquireThread(int& threadRef)
+{
+    if(!mIdleThreads.empty())
+    {
+        threadRef = mIdleThreads.back();
+        mIdleThreads.pop_back();
+
+        lua_rawgeti(mMasterState,LUA_REGISTRYINDEX,threadRef);
+        lua_State* thread = lua_tothread(mMasterState,-1);
+        lua_pop(mMasterState,1);
+
+        return thread;
+    }
+
+    lua_State* thread = lua_newthread(mMasterState);
+    threadRef = luaL_ref(mMasterState,LUA_REGISTRYINDEX);
+
+    return thread;
+}
+
+//======================================================================================================================
+
+void ScriptEngine::releaseThread(lua_State* thread,int threadRef)
+{
+    // the thread no longer belongs to a script
+    lua_pushlightuserdata(mMasterState,thread);
+    lua_pushnil(mMasterState);
+    lua_settable(mMasterState,LUA_GLOBALSINDEX);
+
+    // only a thread that ran to its end can run another chunk, suspended or failed ones are dropped
+    lua_Debug ar;
+    if(lua_status(thread) == 0 && !lua_getstack(thread,0,&ar) && mIdleThreads.size() < kMaxIdleThreads)
+    {
+        lua_settop(thread,0);
+        mIdleThreads.push_back(threadRef);
+    }
+    else
+    {
+        luaL_unref(mMasterState,LUA_REGISTRYINDEX,threadRef);
+    }
+}
+
+//======================================================================================================================
+
 // Access member data from script class.
 
 //======================================================================================================================
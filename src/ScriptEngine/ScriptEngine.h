@@ -43,9 +43,12 @@ extern "C"
 #include <boost/pool/pool.hpp>
 #include <boost/thread/mutex.hpp>
 #include <list>
+#include <string>
+#include <vector>
 
 #define	 gScriptEngine	ScriptEngine::getSingletonPtr()
 
+class ScriptCache;
 class Tutorial;
 
 typedef std::list<Script*>	ScriptList;
@@ -59,7 +62,8 @@ public:
     static ScriptEngine*	getSingletonPtr() {
         return mSingleton;
     }
-    static ScriptEngine*	Init();
+    // scriptCache is the directory compiled scripts are kept in, empty keeps them in memory only
+    static ScriptEngine*	Init(const std::string& scriptCache = "");
 
     lua_State*				getMasterState() {
         return mMasterState;
@@ -68,6 +72,13 @@ public:
     Script*					createScript();
     void					removeScript(Script* script);
 
+    // pushes the compiled main chunk of a script file, see ScriptCache::load
+    bool					loadFile(lua_State* state,const int8* fileName);
+
+    // threads of finished scripts are handed to the next script instead of creating a new one
+    lua_State*				acquireThread(int& threadRef);
+    void					releaseThread(lua_State* thread,int threadRef);
+
     void 					shutdown();
     void 					process();
 
@@ -77,7 +88,7 @@ public:
 
 private:
 
-    ScriptEngine();
+    explicit ScriptEngine(const std::string& scriptCache);
 
     static ScriptEngine*	mSingleton;
     static bool				mInsFlag;
@@ -89,6 +100,9 @@ private:
 
     ScriptList				mScripts;
     boost::pool<boost::default_user_allocator_malloc_free>	mScriptPool;
+
+    ScriptCache*			mScriptCache;
+    std::vector<int>		mIdleThreads;
 };
 
 //======================================================================================================================
@@ -27,43 +27,84 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Utils/ActiveObject.h"
 
-#ifdef _WIN32
-#include <windows.h>
-#endif
-
-using boost::thread;
+#include "Utils/Executor.h"
 
 namespace utils {
 
-ActiveObject::ActiveObject() : done_(false) {
-    thread_ = std::move(thread([=] { this->Run(); }));
+namespace {
+
+// The most messages handled in one go before the strand makes room for others.
+const uint32_t kMessageBatch = 64;
+
+}  // namespace
 
-#ifdef _WIN32
-    HANDLE mtheHandle = thread_.native_handle();
-    SetPriorityClass(mtheHandle,REALTIME_PRIORITY_CLASS);
-#endif
+ActiveObject::ActiveObject()
+    : executor_(Executor::Default()) {
+    pending_ = 0;
+}
+
+ActiveObject::ActiveObject(Executor& executor)
+    : executor_(executor) {
+    pending_ = 0;
 }
 
 ActiveObject::~ActiveObject() {
-    Send([&] { done_ = true; });
-    thread_.join();
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    while (pending_ != 0) {
+        condition_.wait(lock);
+    }
 }
 
 void ActiveObject::Send(Message message) {
-    message_queue_.push(message);
-    condition_.notify_one();
+    message_queue_.push(std::move(message));
+
+    // Only the send that finds the strand idle schedules it, that keeps a
+    // single Run() in flight and the messages in order.
+    if (pending_.fetch_and_increment() == 0) {
+        executor_.Post([this] { Run(); });
+    }
 }
 
 void ActiveObject::Run() {
     Message message;
 
-    boost::unique_lock<boost::mutex> lock(mutex_);
-    while (! done_) {
-        if (condition_.timed_wait(lock, boost::get_system_time() + boost::posix_time::milliseconds(1),
-        		[this, &message] { return message_queue_.try_pop(message); })) {
-        	message();
+    for (uint32_t handled = 1; ; ++handled) {
+        // Every counted message has been pushed already.
+        message_queue_.try_pop(message);
+
+        message();
+        message = nullptr;
+
+        if (Finish_()) {
+            return;
+        }
+
+        if (handled == kMessageBatch) {
+            executor_.Post([this] { Run(); });
+            return;
         }
     }
 }
 
+bool ActiveObject::Finish_() {
+    // While more messages are queued the count can not reach zero under us,
+    // only Run() ever lowers it.
+    if (pending_ > 1) {
+        --pending_;
+        return false;
+    }
+
+    // The last message is accounted for under the lock so the destructor can
+    // not return before this notification is done with the object.
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    if (--pending_ != 0) {
+        return false;
+    }
+
+    condition_.notify_all();
+    return true;
+}
+
 }  // namespace utils
@@ -32,22 +32,26 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <memory>
 
 #include <boost/thread.hpp>
+#include <tbb/atomic.h>
 #include <tbb/concurrent_queue.h>
 
 /// The utils namespace hosts a number of useful utility classes intended to
 /// be used and reused in domain specific classes.
 namespace utils {
 
+class Executor;
+
 /**
  * There are many times when it makes sense to break an object off and run it
  * concurrently while the rest of the application runs. The ActiveObject is a
  * reusable facility that encourages the encapsulation of data by using asynchronus
- * messages to process requests in a private thread. This implementation is based
- * on a design discussed by Herb Sutter.
+ * messages to process requests serially, away from the calling thread. This
+ * implementation is based on a design discussed by Herb Sutter.
  *
- * Note that using an ActiveObject can result in up to 100% of the otherwise unused cpu
- * being consumed. This is intentional as ActiveObjects should primarily be targeted at
- * uses where being highly response is a priority.
+ * ActiveObjects no longer own a thread. Each one is a strand on an Executor:
+ * messages run one at a time and in the order they were sent, but on whichever
+ * worker of the pool picks the strand up. An idle ActiveObject costs no thread
+ * and no cpu, sending to it wakes a sleeping worker.
  *
  * @see http://www.drdobbs.com/go-parallel/article/showArticle.jhtml?articleID=225700095
  */
@@ -59,30 +63,42 @@ public:
     typedef std::function<void()> Message;
 
 public:
-    /// Default constructor kicks off the private thread that listens for incoming messages.
+    /// Default constructor runs the messages on the process-wide Executor::Default().
     ActiveObject();
 
-    /// Default destructor sends an end message and waits for the private thread to complete.
+    /**
+     * Runs the messages on the given executor instead of the shared one.
+     *
+     * \param executor The executor to run messages on, it must outlive the ActiveObject.
+     */
+    explicit ActiveObject(Executor& executor);
+
+    /// Default destructor waits for every message sent so far to be handled. It
+    /// must not be called from one of the ActiveObject's own messages.
     ~ActiveObject();
 
     /**
-     * Sends a message to be handled by the ActiveObject's private thread.
+     * Sends a message to be handled by the ActiveObject.
      *
-     * \param message The message to process on the private thread.
+     * \param message The message to process.
      */
     void Send(Message message);
 
 private:
-    /// Runs the ActiveObject's message loop until an end message is received.
+    /// Handles queued messages until the queue is empty or the batch limit is
+    /// reached, in which case the strand is posted again to let others run.
     void Run();
 
+    /// Accounts for a handled message, returns true if it was the last one queued.
+    bool Finish_();
+
+    Executor& executor_;
+
     tbb::concurrent_queue<Message> message_queue_;
+    tbb::atomic<uint32_t> pending_;
 
-    boost::thread thread_;
     boost::condition_variable condition_;
     boost::mutex mutex_;
-    
-    bool done_;
 };
 
 }
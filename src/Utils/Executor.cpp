@@ -0,0 +1,188 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "Utils/Executor.h"
+
+#include <algorithm>
+
+namespace utils {
+
+namespace {
+
+/// Identifies the executor and worker the current thread belongs to.
+struct CurrentWorker {
+    CurrentWorker(const Executor* executor_, uint32_t index_)
+        : executor(executor_)
+        , index(index_) {}
+
+    const Executor* executor;
+    uint32_t index;
+};
+
+boost::thread_specific_ptr<CurrentWorker> current_worker;
+
+}  // namespace
+
+Executor::Executor(uint32_t thread_count)
+    : stopping_(false) {
+    if (!thread_count) {
+        thread_count = std::max(boost::thread::hardware_concurrency(), 1u);
+    }
+
+    next_worker_ = 0;
+    pending_ = 0;
+    sleeping_ = 0;
+
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+
+    // Only start the threads once every worker exists, they steal from each other.
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        workers_[i]->thread = boost::thread([this, i] { Run_(i); });
+    }
+}
+
+Executor::~Executor() {
+    {
+        boost::lock_guard<boost::mutex> lock(idle_mutex_);
+        stopping_ = true;
+    }
+
+    idle_condition_.notify_all();
+
+    std::for_each(workers_.begin(), workers_.end(), [] (const std::unique_ptr<Worker>& worker) {
+        worker->thread.join();
+    });
+}
+
+Executor& Executor::Default() {
+    static Executor executor;
+    return executor;
+}
+
+void Executor::Post(Task task) {
+    // Count the task before it is queued, a worker that finds pending_ raised
+    // but the task not yet queued simply looks again.
+    ++pending_;
+
+    CurrentWorker* current = current_worker.get();
+    uint32_t index;
+
+    if (current && current->executor == this) {
+        index = current->index;
+    } else {
+        index = next_worker_.fetch_and_increment() % thread_count();
+    }
+
+    Worker* worker = workers_[index].get();
+
+    {
+        boost::lock_guard<boost::mutex> lock(worker->mutex);
+        worker->tasks.push_back(std::move(task));
+    }
+
+    // Workers register as sleeping before their last look at pending_, so
+    // either that look sees this task or this check sees the sleeper.
+    if (sleeping_) {
+        boost::lock_guard<boost::mutex> lock(idle_mutex_);
+        idle_condition_.notify_one();
+    }
+}
+
+void Executor::Run_(uint32_t index) {
+    current_worker.reset(new CurrentWorker(this, index));
+
+    Task task;
+
+    for (;;) {
+        if (PopLocal_(index, task) || Steal_(index, task)) {
+            --pending_;
+
+            task();
+            task = nullptr;
+
+            continue;
+        }
+
+        if (!Wait_()) {
+            break;
+        }
+    }
+}
+
+bool Executor::PopLocal_(uint32_t index, Task& task) {
+    Worker* worker = workers_[index].get();
+
+    boost::lock_guard<boost::mutex> lock(worker->mutex);
+
+    if (worker->tasks.empty()) {
+        return false;
+    }
+
+    task = std::move(worker->tasks.front());
+    worker->tasks.pop_front();
+
+    return true;
+}
+
+bool Executor::Steal_(uint32_t index, Task& task) {
+    uint32_t count = thread_count();
+
+    for (uint32_t i = 1; i < count; ++i) {
+        Worker* victim = workers_[(index + i) % count].get();
+
+        boost::lock_guard<boost::mutex> lock(victim->mutex);
+
+        if (!victim->tasks.empty()) {
+            task = std::move(victim->tasks.back());
+            victim->tasks.pop_back();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Executor::Wait_() {
+    boost::unique_lock<boost::mutex> lock(idle_mutex_);
+
+    ++sleeping_;
+
+    while (pending_ <= 0 && !stopping_) {
+        idle_condition_.wait(lock);
+    }
+
+    --sleeping_;
+
+    // Keep running until everything posted before the stop has been run.
+    return pending_ > 0 || !stopping_;
+}
+
+}  // namespace utils
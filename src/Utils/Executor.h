@@ -0,0 +1,120 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_UTILS_EXECUTOR_H_
+#define SRC_UTILS_EXECUTOR_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include <tbb/atomic.h>
+
+namespace utils {
+
+/**
+ * A work-stealing thread pool that runs short tasks on a fixed set of worker
+ * threads. Every worker owns a deque of tasks which it runs in posting order,
+ * tasks posted from a worker stay on that worker and tasks posted from any
+ * other thread are spread over the workers. A worker that runs out of tasks
+ * steals the newest tasks of the other workers before going to sleep.
+ *
+ * Workers sleep on a condition variable while there is no work at all and are
+ * woken by the next post, there is no polling.
+ *
+ * Executor::Default() is the process-wide pool sized to the number of cores,
+ * it backs every ActiveObject that is not given a pool of its own. Work that
+ * blocks for long periods (database queries for example) belongs on a separate
+ * Executor so it cannot starve the shared one.
+ */
+class Executor : private boost::noncopyable {
+public:
+    typedef std::function<void()> Task;
+
+public:
+    /**
+     * Starts the worker threads.
+     *
+     * \param thread_count The number of workers to start, 0 starts one per core.
+     */
+    explicit Executor(uint32_t thread_count = 0);
+
+    /// Runs the remaining tasks and waits for the workers to exit.
+    ~Executor();
+
+    /// \returns The process-wide executor shared by all ActiveObjects.
+    static Executor& Default();
+
+    /**
+     * Queues a task to be run on one of the workers. Tasks posted from a
+     * worker of this executor are queued on that worker.
+     *
+     * \param task The task to run.
+     */
+    void Post(Task task);
+
+    /// \returns The number of worker threads.
+    uint32_t thread_count() const { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+    struct Worker {
+        boost::mutex mutex;
+        std::deque<Task> tasks;
+        boost::thread thread;
+    };
+
+    /// Runs the tasks of one worker until the executor is stopped.
+    void Run_(uint32_t index);
+
+    /// Takes the oldest task of a worker's own deque.
+    bool PopLocal_(uint32_t index, Task& task);
+
+    /// Takes the newest task of any other worker's deque.
+    bool Steal_(uint32_t index, Task& task);
+
+    /// Sleeps until a task is posted, returns false once the executor stops.
+    bool Wait_();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    tbb::atomic<uint32_t> next_worker_;
+    tbb::atomic<int32_t> pending_;
+    tbb::atomic<uint32_t> sleeping_;
+
+    boost::mutex idle_mutex_;
+    boost::condition_variable idle_condition_;
+    bool stopping_;
+};
+
+}  // namespace utils
+
+#endif  // SRC_UTILS_EXECUTOR_H_
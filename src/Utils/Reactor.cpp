@@ -0,0 +1,105 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "Utils/Reactor.h"
+
+namespace utils {
+
+Reactor::Reactor(uint32_t tick_interval, uint32_t max_catch_up)
+    : interval_(boost::posix_time::milliseconds(tick_interval ? tick_interval : 1))
+    , tick_count_(0)
+    , dropped_ticks_(0)
+    , signal_count_(0)
+    , tick_interval_(tick_interval ? tick_interval : 1)
+    , max_catch_up_(max_catch_up ? max_catch_up : 1)
+    , pending_(false)
+    , waiting_(false) {
+    next_tick_ = boost::get_system_time() + interval_;
+}
+
+Reactor::~Reactor() {}
+
+void Reactor::Signal() {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if (pending_) {
+        return;
+    }
+
+    pending_ = true;
+
+    // Only pay for the notify when the main loop is actually asleep.
+    if (waiting_) {
+        condition_.notify_one();
+    }
+}
+
+uint32_t Reactor::Wait() {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    boost::system_time now = boost::get_system_time();
+
+    waiting_ = true;
+
+    while (!pending_ && now < next_tick_) {
+        condition_.timed_wait(lock, next_tick_);
+        now = boost::get_system_time();
+    }
+
+    waiting_ = false;
+
+    if (pending_) {
+        pending_ = false;
+        ++signal_count_;
+    }
+
+    return AdvanceTicks_(now);
+}
+
+uint32_t Reactor::AdvanceTicks_(const boost::system_time& now) {
+    if (now < next_tick_) {
+        return 0;
+    }
+
+    uint64_t elapsed = static_cast<uint64_t>((now - next_tick_).total_milliseconds()) / tick_interval_ + 1;
+    uint32_t ticks = static_cast<uint32_t>(elapsed < max_catch_up_ ? elapsed : max_catch_up_);
+
+    if (elapsed > ticks) {
+        // Too far behind, give up on the missed steps and restart the schedule from now.
+        dropped_ticks_ += elapsed - ticks;
+        next_tick_ = now + interval_;
+    } else {
+        next_tick_ += boost::posix_time::milliseconds(static_cast<int64_t>(ticks) * tick_interval_);
+    }
+
+    tick_count_ += ticks;
+
+    return ticks;
+}
+
+}  // namespace utils
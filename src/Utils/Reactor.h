@@ -0,0 +1,100 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_UTILS_REACTOR_H_
+#define SRC_UTILS_REACTOR_H_
+
+#include <cstdint>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread_time.hpp>
+
+namespace utils {
+
+/**
+ * Drives a server main loop without polling.
+ *
+ * The main thread blocks in Wait() until another thread calls Signal() (the network
+ * layer when a session has messages, the database layer when a query completed) or
+ * until the next simulation tick is due, whichever comes first. Ticks are fixed
+ * steps of tick_interval milliseconds; Wait() reports how many of them elapsed so the
+ * caller can run its simulation the right number of times. When the server falls
+ * behind by more than max_catch_up ticks the excess is dropped instead of being run
+ * in a burst.
+ */
+class Reactor {
+public:
+    explicit Reactor(uint32_t tick_interval, uint32_t max_catch_up = 5);
+    ~Reactor();
+
+    /// Wakes up the main loop, can be called from any thread.
+    void Signal();
+
+    /**
+     * Blocks until signalled or until the next tick is due.
+     *
+     * @return The number of simulation ticks to run, 0 when woken up for io only.
+     */
+    uint32_t Wait();
+
+    uint32_t tick_interval() const { return tick_interval_; }
+
+    /// Total ticks handed out by Wait().
+    uint64_t tick_count() const { return tick_count_; }
+
+    /// Ticks skipped because the loop fell too far behind.
+    uint64_t dropped_ticks() const { return dropped_ticks_; }
+
+    /// Number of times Wait() returned because of Signal().
+    uint64_t signal_count() const { return signal_count_; }
+
+private:
+    // Counts the ticks elapsed up to now and advances the schedule.
+    uint32_t AdvanceTicks_(const boost::system_time& now);
+
+    boost::mutex mutex_;
+    boost::condition_variable condition_;
+
+    boost::system_time next_tick_;
+    boost::posix_time::time_duration interval_;
+
+    uint64_t tick_count_;
+    uint64_t dropped_ticks_;
+    uint64_t signal_count_;
+
+    uint32_t tick_interval_;
+    uint32_t max_catch_up_;
+
+    bool pending_;
+    bool waiting_;
+};
+
+}  // namespace utils
+
+#endif  // SRC_UTILS_REACTOR_H_
@@ -0,0 +1,256 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "Utils/SlabAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+namespace utils {
+
+namespace {
+
+/// Blocks and slab headers are padded to this, enough for any fundamental type.
+const std::size_t kAlignment = 16;
+
+std::size_t AlignUp(std::size_t size) {
+    return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+}  // namespace
+
+struct SlabAllocator::Slab {
+    SlabAllocator* owner;
+    SlabList* list;
+    Slab* prev;
+    Slab* next;
+
+    /// Blocks that were handed out and returned.
+    void* free;
+
+    /// Blocks in use, and blocks never handed out start at bumped.
+    uint32_t used;
+    uint32_t bumped;
+};
+
+/// Every block starts with the slab it belongs to.
+struct SlabAllocator::BlockHeader {
+    Slab* slab;
+};
+
+// Constant expressions, so they are set before any static constructor runs.
+const std::size_t SlabAllocator::kSlabHeaderSize = (sizeof(Slab) + kAlignment - 1) & ~(kAlignment - 1);
+const std::size_t SlabAllocator::kBlockHeaderSize = (sizeof(BlockHeader) + kAlignment - 1) & ~(kAlignment - 1);
+
+SlabAllocator::SlabAllocator(std::size_t block_size, uint32_t blocks_per_slab, uint32_t spare_slabs)
+    : block_size_(std::max<std::size_t>(block_size, sizeof(void*)))
+    , stride_(kBlockHeaderSize + AlignUp(block_size_))
+    , blocks_per_slab_(blocks_per_slab)
+    , spare_slabs_(spare_slabs)
+    , live_blocks_(0)
+    , peak_blocks_(0)
+    , allocations_(0)
+{
+    if (!blocks_per_slab_) {
+        blocks_per_slab_ = std::max<uint32_t>(8, static_cast<uint32_t>(kDefaultSlabBytes / stride_));
+    }
+}
+
+SlabAllocator::~SlabAllocator() {
+    SlabList* lists[] = { &partial_, &full_, &empty_ };
+
+    for (SlabList* list : lists) {
+        while (list->head) {
+            Slab* slab = list->head;
+
+            Unlink_(*list, slab);
+            DestroySlab_(slab);
+        }
+    }
+}
+
+void* SlabAllocator::Allocate() {
+    Slab* slab = partial_.head;
+
+    if (!slab) {
+        slab = empty_.head;
+
+        if (slab) {
+            Unlink_(empty_, slab);
+        } else {
+            slab = CreateSlab_();
+        }
+
+        Link_(partial_, slab);
+    }
+
+    char* block;
+
+    if (slab->free) {
+        block = static_cast<char*>(slab->free);
+        slab->free = *reinterpret_cast<void**>(block);
+    } else {
+        block = reinterpret_cast<char*>(slab) + kSlabHeaderSize + slab->bumped * stride_ + kBlockHeaderSize;
+        reinterpret_cast<BlockHeader*>(block - kBlockHeaderSize)->slab = slab;
+        ++slab->bumped;
+    }
+
+    if (++slab->used == blocks_per_slab_) {
+        Unlink_(partial_, slab);
+        Link_(full_, slab);
+    }
+
+    ++allocations_;
+    peak_blocks_ = std::max(peak_blocks_, ++live_blocks_);
+
+    return block;
+}
+
+void SlabAllocator::Deallocate(void* block) {
+    if (!block) {
+        return;
+    }
+
+    Slab* slab = reinterpret_cast<BlockHeader*>(static_cast<char*>(block) - kBlockHeaderSize)->slab;
+    assert(slab->owner == this && "block returned to the wrong SlabAllocator");
+
+    *reinterpret_cast<void**>(block) = slab->free;
+    slab->free = block;
+
+    if (slab->used-- == blocks_per_slab_) {
+        Unlink_(full_, slab);
+        Link_(partial_, slab);
+    }
+
+    --live_blocks_;
+
+    if (slab->used) {
+        return;
+    }
+
+    Unlink_(partial_, slab);
+
+    if (empty_.size < spare_slabs_) {
+        Link_(empty_, slab);
+    } else {
+        DestroySlab_(slab);
+    }
+}
+
+uint32_t SlabAllocator::ReleaseEmptySlabs(uint32_t keep) {
+    uint32_t released = 0;
+
+    while (empty_.size > keep) {
+        Slab* slab = empty_.head;
+
+        Unlink_(empty_, slab);
+        DestroySlab_(slab);
+
+        ++released;
+    }
+
+    return released;
+}
+
+SlabAllocator* SlabAllocator::Owner(void* block) {
+    return reinterpret_cast<BlockHeader*>(static_cast<char*>(block) - kBlockHeaderSize)->slab->owner;
+}
+
+SlabAllocator::Stats SlabAllocator::stats() const {
+    Stats stats;
+
+    stats.block_size = static_cast<uint32_t>(block_size_);
+    stats.blocks_per_slab = blocks_per_slab_;
+    stats.slabs = partial_.size + full_.size + empty_.size;
+    stats.empty_slabs = empty_.size;
+    stats.live_blocks = live_blocks_;
+    stats.peak_blocks = peak_blocks_;
+    stats.allocations = allocations_;
+
+    return stats;
+}
+
+SlabAllocator::Slab* SlabAllocator::CreateSlab_() {
+    void* memory = std::malloc(kSlabHeaderSize + blocks_per_slab_ * stride_);
+
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+
+    Slab* slab = static_cast<Slab*>(memory);
+
+    slab->owner = this;
+    slab->list = nullptr;
+    slab->prev = nullptr;
+    slab->next = nullptr;
+    slab->free = nullptr;
+    slab->used = 0;
+    slab->bumped = 0;
+
+    return slab;
+}
+
+void SlabAllocator::DestroySlab_(Slab* slab) {
+    std::free(slab);
+}
+
+void SlabAllocator::Link_(SlabList& list, Slab* slab) {
+    slab->list = &list;
+    slab->prev = nullptr;
+    slab->next = list.head;
+
+    if (list.head) {
+        list.head->prev = slab;
+    }
+
+    list.head = slab;
+    ++list.size;
+}
+
+void SlabAllocator::Unlink_(SlabList& list, Slab* slab) {
+    assert(slab->list == &list);
+
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        list.head = slab->next;
+    }
+
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+
+    slab->list = nullptr;
+    slab->prev = nullptr;
+    slab->next = nullptr;
+    --list.size;
+}
+
+}  // namespace utils
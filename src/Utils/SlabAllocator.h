@@ -0,0 +1,133 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_UTILS_SLABALLOCATOR_H_
+#define SRC_UTILS_SLABALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/noncopyable.hpp>
+
+namespace utils {
+
+/**
+ * Hands out blocks of a single size carved from large slabs. Objects that are
+ * created and destroyed in waves (npcs, loot) end up packed together instead
+ * of being scattered over the C heap between long lived allocations, and a
+ * slab whose objects are all gone can be given back as a whole.
+ *
+ * New blocks fill partially used slabs before an empty one is touched, so the
+ * live objects stay packed into as few slabs as possible. A few empty slabs are
+ * kept for the next spawn wave, ReleaseEmptySlabs gives back the rest.
+ *
+ * A SlabAllocator is not thread safe, callers that share one have to lock.
+ */
+class SlabAllocator : private boost::noncopyable {
+public:
+    struct Stats {
+        uint32_t block_size;
+        uint32_t blocks_per_slab;
+        uint32_t slabs;
+        uint32_t empty_slabs;
+        uint64_t live_blocks;
+        uint64_t peak_blocks;
+        uint64_t allocations;
+    };
+
+    /// Slabs are sized to hold at least this many bytes of blocks.
+    static const std::size_t kDefaultSlabBytes = 64 * 1024;
+
+public:
+    /**
+     * \param block_size The size of every block handed out.
+     * \param blocks_per_slab The number of blocks in a slab, 0 picks enough to
+     *      fill kDefaultSlabBytes.
+     * \param spare_slabs The number of empty slabs kept around when blocks are freed.
+     */
+    explicit SlabAllocator(std::size_t block_size, uint32_t blocks_per_slab = 0, uint32_t spare_slabs = 1);
+
+    /// Frees every slab, blocks still in use become invalid.
+    ~SlabAllocator();
+
+    /// \returns A block of block_size bytes, aligned for any fundamental type.
+    void* Allocate();
+
+    /// Returns a block handed out by this allocator.
+    void Deallocate(void* block);
+
+    /**
+     * Frees empty slabs.
+     *
+     * \param keep The number of empty slabs to hold on to.
+     * \returns The number of slabs freed.
+     */
+    uint32_t ReleaseEmptySlabs(uint32_t keep = 0);
+
+    /// \returns The allocator that handed out the block.
+    static SlabAllocator* Owner(void* block);
+
+    Stats stats() const;
+
+private:
+    struct Slab;
+    struct BlockHeader;
+
+    static const std::size_t kSlabHeaderSize;
+    static const std::size_t kBlockHeaderSize;
+
+    struct SlabList {
+        SlabList() : head(nullptr), size(0) {}
+
+        Slab* head;
+        uint32_t size;
+    };
+
+    Slab* CreateSlab_();
+    void DestroySlab_(Slab* slab);
+
+    void Link_(SlabList& list, Slab* slab);
+    void Unlink_(SlabList& list, Slab* slab);
+
+    std::size_t block_size_;
+    std::size_t stride_;
+    uint32_t blocks_per_slab_;
+    uint32_t spare_slabs_;
+
+    SlabList partial_;
+    SlabList full_;
+    SlabList empty_;
+
+    uint64_t live_blocks_;
+    uint64_t peak_blocks_;
+    uint64_t allocations_;
+};
+
+}  // namespace utils
+
+#endif  // SRC_UTILS_SLABALLOCATOR_H_
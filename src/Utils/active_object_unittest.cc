@@ -4,9 +4,14 @@
 
 #include "Utils/ActiveObject.h"
 
+#include <memory>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <boost/thread.hpp>
 
+#include "Utils/Executor.h"
+
 // Wrapping tests in an anonymous namespace prevents potential name conflicts
 namespace {
 
@@ -58,5 +63,66 @@ TEST(ActiveObjectTests, CanMakeAsyncCallToHostObject) {
     EXPECT_EQ(true, future.get());
 }
 
+/*! Active objects share the threads of their executor, this test makes sure
+* that many of them on a small executor still handle their own messages one at
+* a time and in the order they were sent.
+*/
+TEST(ActiveObjectTests, MessagesRunInOrderOnSharedExecutor) {
+    const int kObjects = 16;
+    const int kMessages = 1000;
+
+    utils::Executor executor(2);
+    std::vector<std::vector<int>> received(kObjects);
+
+    {
+        std::vector<std::unique_ptr<utils::ActiveObject>> objects;
+
+        for (int i = 0; i < kObjects; ++i) {
+            objects.push_back(std::unique_ptr<utils::ActiveObject>(new utils::ActiveObject(executor)));
+        }
+
+        for (int message = 0; message < kMessages; ++message) {
+            for (int i = 0; i < kObjects; ++i) {
+                std::vector<int>* log = &received[i];
+                objects[i]->Send([log, message] { log->push_back(message); });
+            }
+        }
+
+        // Destroying the objects waits for their queued messages.
+    }
+
+    for (int i = 0; i < kObjects; ++i) {
+        ASSERT_EQ(static_cast<size_t>(kMessages), received[i].size());
+
+        for (int message = 0; message < kMessages; ++message) {
+            EXPECT_EQ(message, received[i][message]);
+        }
+    }
+}
+
+/*! Messages sent from within a message are handled by the same object after
+* the current one, this is how most active objects reschedule themselves. The
+* destructor waits for those nested messages as well.
+*/
+TEST(ActiveObjectTests, MessageCanSendToItsOwnObject) {
+    utils::Executor executor(2);
+    std::vector<int> received;
+
+    {
+        utils::ActiveObject active_obj(executor);
+
+        active_obj.Send([&] {
+            received.push_back(1);
+            active_obj.Send([&] { received.push_back(3); });
+            received.push_back(2);
+        });
+    }
+
+    ASSERT_EQ(3u, received.size());
+    EXPECT_EQ(1, received[0]);
+    EXPECT_EQ(2, received[1]);
+    EXPECT_EQ(3, received[2]);
+}
+
 }  // namespace
 
@@ -0,0 +1,100 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "Utils/Executor.h"
+
+#include <set>
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+#include <tbb/atomic.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+/*! An executor created without a thread count starts one worker per core.
+*/
+TEST(ExecutorTests, DefaultsToOneWorkerPerCore) {
+    utils::Executor executor;
+
+    EXPECT_EQ(std::max(boost::thread::hardware_concurrency(), 1u), executor.thread_count());
+}
+
+/*! Every task posted before the executor is destroyed is run, including tasks
+* posted by other tasks.
+*/
+TEST(ExecutorTests, RunsAllTasksBeforeShutdown) {
+    tbb::atomic<int> ran;
+    ran = 0;
+
+    {
+        utils::Executor executor(4);
+
+        for (int i = 0; i < 100; ++i) {
+            executor.Post([&] {
+                ++ran;
+
+                executor.Post([&] { ++ran; });
+            });
+        }
+    }
+
+    EXPECT_EQ(200, ran);
+}
+
+/*! Tasks posted from a worker queue up on that worker, idle workers have to
+* steal them. A task that blocks its worker must not hold up the tasks it has
+* posted.
+*/
+TEST(ExecutorTests, IdleWorkersStealQueuedTasks) {
+    boost::promise<void> stolen;
+    boost::unique_future<void> stolen_future = stolen.get_future();
+
+    boost::promise<void> finished;
+    boost::unique_future<void> finished_future = finished.get_future();
+
+    // Declared last so the workers are joined before the promises go away.
+    utils::Executor executor(2);
+
+    executor.Post([&] {
+        // Queued behind this task on the same worker, only the other worker can run it.
+        executor.Post([&] { stolen.set_value(); });
+
+        stolen_future.wait();
+        finished.set_value();
+    });
+
+    finished_future.wait();
+    EXPECT_TRUE(stolen_future.is_ready());
+}
+
+/*! Posting from outside the executor spreads the tasks over the workers.
+*/
+TEST(ExecutorTests, PostsFromOutsideAreSpreadOverWorkers) {
+    boost::mutex mutex;
+    std::set<boost::thread::id> threads;
+    boost::barrier barrier(5);
+
+    {
+        utils::Executor executor(4);
+
+        // Each task holds its worker until all four have started.
+        for (int i = 0; i < 4; ++i) {
+            executor.Post([&] {
+                {
+                    boost::lock_guard<boost::mutex> lock(mutex);
+                    threads.insert(boost::this_thread::get_id());
+                }
+
+                barrier.wait();
+            });
+        }
+
+        barrier.wait();
+    }
+
+    EXPECT_EQ(4u, threads.size());
+}
+
+}  // namespace
@@ -0,0 +1,63 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "Utils/Reactor.h"
+
+#include <gtest/gtest.h>
+#include <boost/thread.hpp>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+/*! A signal raised before waiting wakes the loop right away without a tick.
+*/
+TEST(ReactorTests, SignalWakesWithoutTick) {
+    utils::Reactor reactor(1000);
+
+    reactor.Signal();
+
+    EXPECT_EQ(0, reactor.Wait());
+    EXPECT_EQ(1, reactor.signal_count());
+}
+
+/*! A signal from another thread ends a wait long before the tick is due.
+*/
+TEST(ReactorTests, SignalFromOtherThreadEndsWait) {
+    utils::Reactor reactor(10000);
+
+    boost::thread signaller([&reactor] {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+        reactor.Signal();
+    });
+
+    boost::system_time start = boost::get_system_time();
+    EXPECT_EQ(0, reactor.Wait());
+    EXPECT_GT(1000, (boost::get_system_time() - start).total_milliseconds());
+
+    signaller.join();
+}
+
+/*! Without any signal the loop wakes up for the next tick.
+*/
+TEST(ReactorTests, IdleWaitReturnsOneTick) {
+    utils::Reactor reactor(20);
+
+    EXPECT_EQ(1, reactor.Wait());
+    EXPECT_EQ(1, reactor.tick_count());
+    EXPECT_EQ(0, reactor.signal_count());
+}
+
+/*! Missed ticks are handed out together, up to the catch up limit, the rest is dropped.
+*/
+TEST(ReactorTests, CatchUpIsCapped) {
+    utils::Reactor reactor(10, 3);
+
+    boost::this_thread::sleep(boost::posix_time::milliseconds(105));
+
+    EXPECT_EQ(3, reactor.Wait());
+    EXPECT_LE(7, reactor.dropped_ticks());
+    EXPECT_EQ(3, reactor.tick_count());
+}
+
+}  // namespace
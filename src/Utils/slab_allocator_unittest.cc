@@ -0,0 +1,118 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "Utils/SlabAllocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+using utils::SlabAllocator;
+
+/*! Blocks are distinct, aligned and usable for their full size.
+*/
+TEST(SlabAllocatorTests, HandsOutDistinctAlignedBlocks) {
+    SlabAllocator allocator(40, 8);
+    std::set<void*> blocks;
+
+    for (int i = 0; i < 20; ++i) {
+        void* block = allocator.Allocate();
+
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % 16);
+        std::memset(block, i, 40);
+
+        blocks.insert(block);
+    }
+
+    EXPECT_EQ(20u, blocks.size());
+    EXPECT_EQ(20u, allocator.stats().live_blocks);
+    EXPECT_EQ(3u, allocator.stats().slabs);
+
+    for (void* block : blocks) {
+        EXPECT_EQ(&allocator, SlabAllocator::Owner(block));
+        allocator.Deallocate(block);
+    }
+
+    EXPECT_EQ(0u, allocator.stats().live_blocks);
+    EXPECT_EQ(20u, allocator.stats().peak_blocks);
+}
+
+/*! A returned block is reused before a new slab is cut.
+*/
+TEST(SlabAllocatorTests, ReusesReturnedBlocks) {
+    SlabAllocator allocator(64, 4);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 4; ++i) {
+        blocks.push_back(allocator.Allocate());
+    }
+
+    allocator.Deallocate(blocks[2]);
+
+    EXPECT_EQ(blocks[2], allocator.Allocate());
+    EXPECT_EQ(1u, allocator.stats().slabs);
+}
+
+/*! Slabs that empty out are kept up to the spare count, the rest are freed
+* straight away and the spares go on ReleaseEmptySlabs.
+*/
+TEST(SlabAllocatorTests, ReleasesEmptySlabs) {
+    SlabAllocator allocator(32, 4, 1);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 12; ++i) {
+        blocks.push_back(allocator.Allocate());
+    }
+
+    EXPECT_EQ(3u, allocator.stats().slabs);
+
+    for (void* block : blocks) {
+        allocator.Deallocate(block);
+    }
+
+    EXPECT_EQ(1u, allocator.stats().slabs);
+    EXPECT_EQ(1u, allocator.stats().empty_slabs);
+
+    EXPECT_EQ(1u, allocator.ReleaseEmptySlabs());
+    EXPECT_EQ(0u, allocator.stats().slabs);
+
+    // Still usable after giving everything back.
+    void* block = allocator.Allocate();
+    EXPECT_EQ(1u, allocator.stats().slabs);
+    allocator.Deallocate(block);
+}
+
+/*! After a despawn wave the survivors keep their slabs, new blocks fill the
+* holes in the partly used slabs before another slab is cut.
+*/
+TEST(SlabAllocatorTests, FillsPartialSlabsBeforeCuttingNewOnes) {
+    SlabAllocator allocator(128, 8, 0);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 64; ++i) {
+        blocks.push_back(allocator.Allocate());
+    }
+
+    // Every other block goes away.
+    for (size_t i = 0; i < blocks.size(); i += 2) {
+        allocator.Deallocate(blocks[i]);
+    }
+
+    EXPECT_EQ(8u, allocator.stats().slabs);
+
+    for (int i = 0; i < 32; ++i) {
+        allocator.Allocate();
+    }
+
+    EXPECT_EQ(8u, allocator.stats().slabs);
+    EXPECT_EQ(64u, allocator.stats().live_blocks);
+}
+
+}  // namespace
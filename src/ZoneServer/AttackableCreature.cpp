@@ -365,24 +365,18 @@ bool AttackableCreature::setTargetDefenderWithinWeaponRange(void)
     ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
     while (defenderIt != this->getDefenders()->end())
     {
-        if (CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
+        if (this->isDefenderStandingInRange(*defenderIt, this->getWeaponMaxRange()))
         {
-            if (!defenderCreature->isIncapacitated() && !defenderCreature->isDead())
+            // Do only attack objects that have build up enough aggro.
+            if (this->attackerHaveAggro(*defenderIt))
             {
-                if (gWorldManager->objectsInRange(this->getId(), *defenderIt, this->getWeaponMaxRange()))
+                if (this->getTargetId() != *defenderIt)
                 {
-                    // Do only attack objects that have build up enough aggro.
-                    if (this->attackerHaveAggro(defenderCreature->getId()))
-                    {
-                        if (this->getTargetId() != *defenderIt)
-                        {
-                            this->setTarget(*defenderIt);
-                            // TEST ERU gMessageLib->sendTargetUpdateDeltasCreo6(this);
-                        }
-                        foundTarget = true;
-                        break;
-                    }
+                    this->setTarget(*defenderIt);
+                    // TEST ERU gMessageLib->sendTargetUpdateDeltasCreo6(this);
                 }
+                foundTarget = true;
+                break;
             }
         }
         ++defenderIt;
@@ -419,25 +413,18 @@ bool AttackableCreature::setTargetDefenderWithinMaxRange(void)
     ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
     while (defenderIt != this->getDefenders()->end())
     {
-        if (CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
+        if (this->isDefenderStandingNearHome(*defenderIt, this->getStalkerDistanceMax() + this->getWeaponMaxRange()))
         {
-            if (!defenderCreature->isIncapacitated() && !defenderCreature->isDead())
+            // Do only attack objects that have build up enough aggro.
+            if (this->attackerHaveAggro(*defenderIt))
             {
-                if (gWorldManager->objectsInRange(this->getHomePosition(), this->getCellIdForSpawn(), *defenderIt,
-                                                  this->getStalkerDistanceMax() + this->getWeaponMaxRange()))
+                if (this->getTargetId() != (*defenderIt))
                 {
-                    // Do only attack objects that have build up enough aggro.
-                    if (this->attackerHaveAggro(defenderCreature->getId()))
-                    {
-                        if (this->getTargetId() != (*defenderIt))
-                        {
-                            this->setTarget(*defenderIt);
-                            // TEST ERU gMessageLib->sendTargetUpdateDeltasCreo6(this);
-                        }
-                        foundTarget = true;
-                        break;
-                    }
+                    this->setTarget(*defenderIt);
+                    // TEST ERU gMessageLib->sendTargetUpdateDeltasCreo6(this);
                 }
+                foundTarget = true;
+                break;
             }
         }
         ++defenderIt;
@@ -452,20 +439,55 @@ bool AttackableCreature::setTargetDefenderWithinMaxRange(void)
 
 bool AttackableCreature::isTargetWithinMaxRange(uint64 targetId)
 {
-    bool foundTarget = false;
+    return this->isDefenderStandingNearHome(targetId, this->getStalkerDistanceMax() + this->getWeaponMaxRange());
+}
+
+//=============================================================================
+//
+//	Defender checks run every ai tick for every defender.
+//	Creatures in the world are answered from the hot state store, anything else
+//	falls back to the object itself.
+//
+
+bool AttackableCreature::isDefenderStandingInRange(uint64 defenderId, float range)
+{
+    zone::CreatureHotStore& hotStore = zone::CreatureHotStore::Instance();
+    zone::CreatureHotStore::Handle self = hotStore.Find(this->getId());
+    zone::CreatureHotStore::Handle defender = hotStore.Find(defenderId);
+
+    if (self && defender)
+    {
+        return !hotStore.IsDown(defender) && hotStore.InRange(self, defender, range);
+    }
+
+    CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById(defenderId));
+    if (!defenderCreature || defenderCreature->isIncapacitated() || defenderCreature->isDead())
+    {
+        return false;
+    }
+    return gWorldManager->objectsInRange(this->getId(), defenderId, range);
+}
+
+bool AttackableCreature::isDefenderStandingNearHome(uint64 defenderId, float range)
+{
+    zone::CreatureHotStore& hotStore = zone::CreatureHotStore::Instance();
 
-    if (CreatureObject* creature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById(targetId)))
+    if (zone::CreatureHotStore::Handle defender = hotStore.Find(defenderId))
     {
-        if (!creature->isIncapacitated() && !creature->isDead())
+        if (hotStore.IsDown(defender))
         {
-            if (gWorldManager->objectsInRange(this->getHomePosition(), this->getCellIdForSpawn(), targetId,
-                                              this->getStalkerDistanceMax() + this->getWeaponMaxRange()))
-            {
-                foundTarget = true;
-            }
+            return false;
         }
     }
-    return foundTarget;
+    else
+    {
+        CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById(defenderId));
+        if (!defenderCreature || defenderCreature->isIncapacitated() || defenderCreature->isDead())
+        {
+            return false;
+        }
+    }
+    return gWorldManager->objectsInRange(this->getHomePosition(), this->getCellIdForSpawn(), defenderId, range);
 }
 
 bool AttackableCreature::isTargetValid() {
@@ -486,18 +508,15 @@ uint64 AttackableCreature::getDefenderOutOfAggroRange(void)
     ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
     while (defenderIt != this->getDefenders()->end())
     {
-        if (CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
+        // only creatures can run out of range, other defenders stay
+        if (zone::CreatureHotStore::Instance().Find(*defenderIt) ||
+                dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
         {
-            // if (!defenderCreature->isIncapacitated() && !defenderCreature->isDead())
-            //if (!defenderCreature->isDead())
-            //{
-            if (defenderCreature->isIncapacitated() || defenderCreature->isDead() ||
-                    (!gWorldManager->objectsInRange(this->getId(), defenderCreature->getId(), this->getMaxAggroRange())))
+            if (!this->isDefenderStandingInRange(*defenderIt, this->getMaxAggroRange()))
             {
-                targetOutOfRange = defenderCreature->getId();
+                targetOutOfRange = *defenderIt;
                 break;
             }
-            // }
         }
         ++defenderIt;
     }
@@ -231,6 +231,10 @@ private:
     bool	targetOutsideRoamingLimit(void) const;
     bool	isTargetWithinMaxRange(uint64 targetId);
 
+    // defender is neither incapacitated nor dead and within range of us or of our spawn point
+    bool	isDefenderStandingInRange(uint64 defenderId, float range);
+    bool	isDefenderStandingNearHome(uint64 defenderId, float range);
+
     float	getWeaponMaxRange(void) const {
         return mWeaponMaxRange;
     }
@@ -0,0 +1,280 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "ZoneServer/AttributeMap.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct AttributeKeyLess
+{
+    bool operator()(const AttributeMap::value_type& lhs, uint32 rhs) const { return lhs.first < rhs; }
+};
+
+// cheap check so we only try to parse things that look like numbers
+bool looksNumeric(const std::string& value, bool& isInteger)
+{
+    if(value.empty() || value.length() > 24)
+        return false;
+
+    isInteger = true;
+
+    for(std::string::size_type i = 0; i < value.length(); ++i)
+    {
+        char c = value[i];
+
+        if(c >= '0' && c <= '9')
+            continue;
+
+        if(c == '-' || c == '+')
+        {
+            if(i != 0 && value[i-1] != 'e')
+                return false;
+        }
+        else if(c == '.' || c == 'e')
+            isInteger = false;
+        else
+            return false;
+    }
+
+    return true;
+}
+
+// the shortest text that reads back as the same float
+std::string formatFloat(float value)
+{
+    char buffer[32];
+
+    for(int precision = 1; precision < 9; ++precision)
+    {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+
+        if(strtof(buffer, 0) == value)
+            return buffer;
+    }
+
+    snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+std::string formatInt(int64 value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+    return buffer;
+}
+
+}
+
+//=============================================================================
+
+AttributeValue::AttributeValue()
+    : mType(Type_Int)
+{
+    mInt = 0;
+}
+
+//=============================================================================
+
+AttributeValue::AttributeValue(const std::string& value)
+    : mType(Type_Int)
+{
+    _assign(value);
+}
+
+//=============================================================================
+
+AttributeValue::AttributeValue(const AttributeValue& other)
+    : mType(other.mType)
+{
+    if(mType == Type_String)
+        mString = new std::string(*other.mString);
+    else
+        mInt = other.mInt;
+}
+
+//=============================================================================
+
+AttributeValue::~AttributeValue()
+{
+    _release();
+}
+
+//=============================================================================
+
+AttributeValue& AttributeValue::operator=(const AttributeValue& other)
+{
+    if(this == &other)
+        return *this;
+
+    if(other.mType == Type_String)
+    {
+        std::string* copy = new std::string(*other.mString);
+        _release();
+        mString = copy;
+    }
+    else
+    {
+        _release();
+        mInt = other.mInt;
+    }
+
+    mType = other.mType;
+    return *this;
+}
+
+//=============================================================================
+
+AttributeValue& AttributeValue::operator=(const std::string& value)
+{
+    _release();
+    _assign(value);
+    return *this;
+}
+
+//=============================================================================
+
+std::string AttributeValue::toString() const
+{
+    switch(mType)
+    {
+    case Type_Int:
+        return formatInt(mInt);
+    case Type_Float:
+        return formatFloat(mFloat);
+    case Type_String:
+    default:
+        return *mString;
+    }
+}
+
+//=============================================================================
+// expects the old value to be released
+
+void AttributeValue::_assign(const std::string& value)
+{
+    bool isInteger;
+
+    if(looksNumeric(value, isInteger))
+    {
+        char* end = 0;
+
+        if(isInteger)
+        {
+            long long parsed = strtoll(value.c_str(), &end, 10);
+
+            if(*end == 0 && formatInt(parsed) == value)
+            {
+                mType	= Type_Int;
+                mInt	= parsed;
+                return;
+            }
+        }
+        else
+        {
+            float parsed = strtof(value.c_str(), &end);
+
+            if(*end == 0 && formatFloat(parsed) == value)
+            {
+                mType	= Type_Float;
+                mFloat	= parsed;
+                return;
+            }
+        }
+    }
+
+    mType	= Type_String;
+    mString	= new std::string(value);
+}
+
+//=============================================================================
+
+void AttributeValue::_release()
+{
+    if(mType == Type_String)
+        delete mString;
+
+    mType	= Type_Int;
+    mInt	= 0;
+}
+
+//=============================================================================
+
+AttributeMap::iterator AttributeMap::find(uint32 key)
+{
+    iterator it = std::lower_bound(mValues.begin(), mValues.end(), key, AttributeKeyLess());
+
+    if(it != mValues.end() && it->first == key)
+        return it;
+
+    return mValues.end();
+}
+
+//=============================================================================
+
+AttributeMap::const_iterator AttributeMap::find(uint32 key) const
+{
+    const_iterator it = std::lower_bound(mValues.begin(), mValues.end(), key, AttributeKeyLess());
+
+    if(it != mValues.end() && it->first == key)
+        return it;
+
+    return mValues.end();
+}
+
+//=============================================================================
+
+std::pair<AttributeMap::iterator,bool> AttributeMap::insert(const std::pair<uint32,std::string>& value)
+{
+    iterator it = std::lower_bound(mValues.begin(), mValues.end(), value.first, AttributeKeyLess());
+
+    if(it != mValues.end() && it->first == value.first)
+        return std::make_pair(it, false);
+
+    it = mValues.insert(it, value_type(value.first, AttributeValue(value.second)));
+    return std::make_pair(it, true);
+}
+
+//=============================================================================
+
+AttributeMap::size_type AttributeMap::erase(uint32 key)
+{
+    iterator it = find(key);
+
+    if(it == mValues.end())
+        return 0;
+
+    mValues.erase(it);
+    return 1;
+}
+
+//=============================================================================
+
@@ -0,0 +1,229 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_ZONESERVER_ATTRIBUTEMAP_H
+#define ANH_ZONESERVER_ATTRIBUTEMAP_H
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include "Utils/typedefs.h"
+
+//=============================================================================
+//
+// An attribute value as loaded from item_attributes. Values that are plain
+// numbers are kept as int64 / float so reads do not have to parse them again,
+// everything else is kept as the original string. A number is only stored
+// typed when formatting it again gives back the exact same text, that way
+// the attribute lists we send to clients stay unchanged. Floats are formatted
+// with the fewest digits that read back as the same float, so "0.3" is a
+// float while "0.30" stays a string.
+//
+// Reading a typed value converts it directly. A conversion lexical_cast would
+// reject fails here as well, like a float read as an integer or a value out
+// of the range of the requested type.
+//
+
+class AttributeValue
+{
+public:
+
+    enum Type
+    {
+        Type_Int	= 0,
+        Type_Float	= 1,
+        Type_String	= 2
+    };
+
+    AttributeValue();
+    AttributeValue(const std::string& value);
+    AttributeValue(const AttributeValue& other);
+    ~AttributeValue();
+
+    AttributeValue&	operator=(const AttributeValue& other);
+    AttributeValue&	operator=(const std::string& value);
+
+    Type			getType() const { return mType; }
+
+    // formats the value, only needed when attribute lists are sent or saved
+    std::string		toString() const;
+
+    template<typename T> bool as(T& out) const
+    {
+        return _as(out, boost::integral_constant<int,
+                   boost::is_same<T,bool>::value ? 0 :
+                   boost::is_integral<T>::value ? 1 :
+                   boost::is_floating_point<T>::value ? 2 :
+                   boost::is_same<T,std::string>::value ? 3 : 4>());
+    }
+
+private:
+
+    void			_assign(const std::string& value);
+    void			_release();
+
+    // only strings are parsed, typed values are converted directly
+    template<typename T> bool _lexicalCast(T& out) const
+    {
+        try
+        {
+            out = boost::lexical_cast<T>(mType == Type_String ? *mString : toString());
+            return true;
+        }
+        catch(boost::bad_lexical_cast &)
+        {
+            return false;
+        }
+    }
+
+    // bool
+    template<typename T> bool _as(T& out, boost::integral_constant<int,0>) const
+    {
+        if(mType == Type_String)
+            return _lexicalCast(out);
+
+        if(mType == Type_Int && (mInt == 0 || mInt == 1))
+        {
+            out = (mInt == 1);
+            return true;
+        }
+
+        return false;
+    }
+
+    // integral types
+    template<typename T> bool _as(T& out, boost::integral_constant<int,1>) const
+    {
+        if(mType == Type_String)
+            return _lexicalCast(out);
+
+        if(mType == Type_Int
+                && (mInt >= 0 || std::numeric_limits<T>::is_signed)
+                && (mInt < 0 || static_cast<uint64>(mInt) <= static_cast<uint64>(std::numeric_limits<T>::max()))
+                && (mInt >= 0 || mInt >= static_cast<int64>(std::numeric_limits<T>::min())))
+        {
+            out = static_cast<T>(mInt);
+            return true;
+        }
+
+        return false;
+    }
+
+    // floating point types
+    template<typename T> bool _as(T& out, boost::integral_constant<int,2>) const
+    {
+        switch(mType)
+        {
+        case Type_Int:
+            out = static_cast<T>(mInt);
+            return true;
+        case Type_Float:
+            out = static_cast<T>(mFloat);
+            return true;
+        case Type_String:
+        default:
+            return _lexicalCast(out);
+        }
+    }
+
+    // std::string
+    template<typename T> bool _as(T& out, boost::integral_constant<int,3>) const
+    {
+        out = toString();
+        return true;
+    }
+
+    // anything else goes through lexical_cast
+    template<typename T> bool _as(T& out, boost::integral_constant<int,4>) const
+    {
+        return _lexicalCast(out);
+    }
+
+    Type			mType;
+
+    union
+    {
+        int64			mInt;
+        float			mFloat;
+        std::string*	mString;
+    };
+};
+
+//=============================================================================
+//
+// Attributes of an object keyed by the crc of their name. Objects carry a
+// handful of attributes each, so a sorted vector is both smaller and faster
+// to search than a std::map. The interface follows std::map for the parts
+// the zone uses.
+//
+
+class AttributeMap
+{
+public:
+
+    typedef std::pair<uint32,AttributeValue>	value_type;
+    typedef std::vector<value_type>				Container;
+    typedef Container::iterator					iterator;
+    typedef Container::const_iterator			const_iterator;
+    typedef Container::size_type				size_type;
+
+    iterator			begin() { return mValues.begin(); }
+    iterator			end() { return mValues.end(); }
+    const_iterator		begin() const { return mValues.begin(); }
+    const_iterator		end() const { return mValues.end(); }
+
+    size_type			size() const { return mValues.size(); }
+    bool				empty() const { return mValues.empty(); }
+    void				clear() { mValues.clear(); }
+
+    iterator			find(uint32 key);
+    const_iterator		find(uint32 key) const;
+
+    // does not overwrite an existing key, like std::map::insert
+    std::pair<iterator,bool>	insert(const std::pair<uint32,std::string>& value);
+
+    void				erase(iterator it) { mValues.erase(it); }
+    size_type			erase(uint32 key);
+
+private:
+
+    Container			mValues;
+};
+
+//=============================================================================
+
+#endif
+
@@ -36,6 +36,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/DatabaseManager.h"
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/QueryChain.h"
 
 // Fix for issues with glog redefining this constant
 #ifdef _WIN32
@@ -305,7 +306,7 @@ bool BuffManager::SaveBuffsAsync(WMAsyncContainer* asyncContainer,DatabaseCallba
     return(buffCount>0);
 
 }
-void BuffManager::SaveBuffs(PlayerObject* playerObject, uint64 currenttime)
+void BuffManager::SaveBuffs(PlayerObject* playerObject, uint64 currenttime, QueryChain& chain)
 {
     //RemovedDeleted Buffs
     playerObject->CleanUpBuffs();
@@ -318,7 +319,7 @@ void BuffManager::SaveBuffs(PlayerObject* playerObject, uint64 currenttime)
         if(!temp->GetIsMarkedForDeletion())
         {
             //Save to DB, and remove from the Process Queue
-            AddBuffToDB(temp, currenttime);
+            AddBuffToDB(temp, currenttime, chain);
             gWorldManager->removeBuffToProcess(temp->GetID());
         }
 
@@ -489,10 +490,10 @@ bool BuffManager::AddBuffToDB(WMAsyncContainer* asyncContainer,DatabaseCallback*
 }
 
 //=============================================================================
-//saves the buff to db sync
+//appends the queries saving the buff to the chain
 //
 
-void BuffManager::AddBuffToDB(Buff* buff, uint64 currenttime)
+void BuffManager::AddBuffToDB(Buff* buff, uint64 currenttime, QueryChain& chain)
 {
     //If we have been passed a null Buff
     if(!buff)
@@ -503,9 +504,6 @@ void BuffManager::AddBuffToDB(Buff* buff, uint64 currenttime)
         return;
 
 
-    buffAsyncContainer* envelope	= new buffAsyncContainer();
-    envelope->mQueryType	= BMQuery_Null;
-
     /*TODO Should I Reset the Stat here on the player so it doesn't get double buffed
     	For now, this is dealt with by removing hte modifiers when saving Player HAM to DB,
     	but this might not be the best long term solution
@@ -538,9 +536,8 @@ void BuffManager::AddBuffToDB(Buff* buff, uint64 currenttime)
         sprintf(sql+strlen(sql), "%"PRIu64",", currenttime);
         sprintf(sql+strlen(sql), "%"PRIu64");", buff->GetStartGlobalTick());
 
-        //Lloydyboy Changed Save SQL back to Sync, not ASync to ensure this is saved, before new zone loads
-        //mDatabase->ExecuteSqlAsync(this,envelope,sql);
-        mDatabase->destroyResult(mDatabase->executeSynchSql(sql));
+        // Chained rather than async so the caller knows when it is saved, before the new zone loads
+        chain.then(sql);
 
         int8 sql2[550];
         sprintf(sql2, "INSERT INTO %s.character_buff_attributes (buff_id,character_id,type,initial,tick,final) VALUES",mDatabase->galaxy());
@@ -577,12 +574,7 @@ void BuffManager::AddBuffToDB(Buff* buff, uint64 currenttime)
             it++;
         }
 
-        //Lloydyboy Changed Save SQL back to Sync, not ASync to ensure this is saved, before new zone loads
-        //mDatabase->ExecuteSqlAsync(this,envelope,sql2);
-        
-		//then just put the notification of the new zone into the callback handler ?
-		//having the zone wait for synch db calls everytime someone travels is simply stupid
-        mDatabase->destroyResult(mDatabase->executeSynchSql(sql2));
+        chain.then(sql2);
     }
 }
 
@@ -42,6 +42,7 @@ class DatabaseCallback;
 class DatabaseResult;
 class CreatureObject;
 class PlayerObject;
+class QueryChain;
 class QueryContainerBase;
 class WMAsyncContainer;
 struct buffAsyncContainer;
@@ -70,7 +71,7 @@ public:
     }
 
     void		handleDatabaseJobComplete(void* ref,DatabaseResult* result);
-    void		SaveBuffs(PlayerObject* playerObject, uint64 currenttime);
+    void		SaveBuffs(PlayerObject* playerObject, uint64 currenttime, QueryChain& chain);
     bool		SaveBuffsAsync(WMAsyncContainer* asyncContainer,DatabaseCallback* callback, PlayerObject* playerObject, uint64 currenttime);
     void		LoadBuffs(PlayerObject* playerObject, uint64 currenttime);
     void		LoadBuffAttributes(buffAsyncContainer* envelope);
@@ -83,7 +84,7 @@ private:
 
 
     bool		AddBuffToDB(WMAsyncContainer* asyncContainer,DatabaseCallback* callback, Buff* buff, uint64 currenttime);
-    void		AddBuffToDB(Buff* buff, uint64 currenttime);
+    void		AddBuffToDB(Buff* buff, uint64 currenttime, QueryChain& chain);
 
 
     static		BuffManager*	mSingleton;
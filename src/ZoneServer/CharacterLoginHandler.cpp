@@ -27,7 +27,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "ZoneServer/CharacterLoginHandler.h"
 
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 // Fix for issues with glog redefining this constant
@@ -41,6 +43,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/rand.h"
 
 #include "DatabaseManager/Database.h"
+#include "DatabaseManager/QueryChain.h"
 
 #include "NetworkManager/DispatchClient.h"
 #include "NetworkManager/Message.h"
@@ -460,17 +463,33 @@ void CharacterLoginHandler::_processClusterZoneTransferApprovedByPosition(Messag
         //playerObject->states.setPosture(CreaturePosture_Upright);
 
         // Save our player.
-        gWorldManager->savePlayerSync(playerObject->getAccountId(),false);
+        std::shared_ptr<QueryChain> chain = QueryChain::create(mDatabase);
+        gWorldManager->savePlayerToChain(playerObject, *chain);
 
         // Now update the DB with the new location/planetId
-        mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.characters SET parent_id=0,x='%f', y='0', z='%f', planet_id='%u' WHERE id='%"PRIu64"';",mDatabase->galaxy(),x,z,planetId,playerObject->getId()));
+        std::stringstream sql;
+        sql << std::setprecision(std::numeric_limits<float>::max_digits10);
+        sql << "UPDATE " << mDatabase->galaxy() << ".characters SET parent_id=0, x=" << x << ", y=0, z=" << z 
+            << ", planet_id=" << planetId << " WHERE id=" << playerObject->getId() << ";";
+        chain->then(sql.str());
 
+        // The new zone loads the character from the db, only hand it over once everything is written.
+        uint32 accountId = playerObject->getAccountId();
 
-        gMessageLib->sendClusterZoneTransferCharacter(playerObject,planetId);
+        chain->finally([accountId, planetId] () {
+            PlayerObject* playerObject = gWorldManager->getPlayerByAccId(accountId);
+            if (!playerObject) {
+                return;
+            }
 
-        playerObject->setConnectionState(PlayerConnState_LinkDead);
-        // playerObject->setClient(NULL);
-        gWorldManager->destroyObject(playerObject);
+            gMessageLib->sendClusterZoneTransferCharacter(playerObject,planetId);
+
+            playerObject->setConnectionState(PlayerConnState_LinkDead);
+            // playerObject->setClient(NULL);
+            gWorldManager->destroyObject(playerObject);
+        });
+
+        chain->execute();
     }
 }
 
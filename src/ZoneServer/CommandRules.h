@@ -0,0 +1,188 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_ZONESERVER_COMMANDRULES_H_
+#define SRC_ZONESERVER_COMMANDRULES_H_
+
+#include <cstdint>
+
+namespace zone {
+
+/**
+ * \brief The validation rules of one command, compiled once when the command
+ * table is loaded.
+ *
+ * Every queued command used to walk a list of validator objects on enqueue and
+ * again on execution. The rules keep what those validators read from the
+ * command properties as masks plus a set of flags naming the checks the
+ * command needs at all, so most commands are validated with a posture bit
+ * test and a couple of state mask tests.
+ *
+ * The state and locomotion tests are kept exactly as the validators had them,
+ * clients depend on the replies they produce.
+ */
+class CommandRules {
+public:
+    enum Result {
+        kPassed = 0,
+        kWrongState,
+        kWrongLocomotion
+    };
+
+    CommandRules()
+        : posture_mask_(0)
+        , states_(0)
+        , locomotion_mask_(0)
+        , ability_crc_(0)
+        , weapon_group_(0)
+        , health_cost_(0)
+        , action_cost_(0)
+        , mind_cost_(0)
+        , checks_(0) {}
+
+    void Compile(uint64_t posture_mask, uint64_t states, uint64_t locomotion_mask, uint32_t ability_crc,
+                 uint32_t weapon_group, int32_t health_cost, int32_t action_cost, int32_t mind_cost) {
+        posture_mask_ = posture_mask;
+        states_ = states;
+        locomotion_mask_ = locomotion_mask;
+        ability_crc_ = ability_crc;
+        weapon_group_ = weapon_group;
+        health_cost_ = health_cost;
+        action_cost_ = action_cost;
+        mind_cost_ = mind_cost;
+
+        checks_ = 0;
+
+        if (ability_crc) {
+            checks_ |= kCheckAbility;
+        }
+
+        if (states) {
+            checks_ |= kCheckStates;
+        }
+
+        if (locomotion_mask) {
+            checks_ |= kCheckLocomotion;
+        }
+
+        if (weapon_group) {
+            checks_ |= kCheckWeapon;
+        }
+
+        if (health_cost || action_cost || mind_cost) {
+            checks_ |= kCheckHam;
+        }
+    }
+
+    /** The posture has to be one the command allows. */
+    bool PostureAllowed(uint32_t posture) const {
+        uint64_t bit = static_cast<uint64_t>(1u << posture);
+        return (posture_mask_ & bit) == bit;
+    }
+
+    bool RequiresAbility() const {
+        return (checks_ & kCheckAbility) != 0;
+    }
+
+    bool RequiresWeapon() const {
+        return (checks_ & kCheckWeapon) != 0;
+    }
+
+    bool HasHamCost() const {
+        return (checks_ & kCheckHam) != 0;
+    }
+
+    /** The equipped weapon group must be part of the required groups. */
+    bool WeaponAllowed(uint32_t weapon_group) const {
+        return (weapon_group & weapon_group_) == weapon_group;
+    }
+
+    /**
+     * States and locomotion as checked before a command is queued.
+     */
+    Result CheckEnqueueStates(uint64_t action, uint32_t posture) const {
+        if ((checks_ & kCheckStates) && (action & states_) == states_) {
+            return kWrongState;
+        }
+
+        if ((checks_ & kCheckLocomotion) && (locomotion_mask_ & posture) != 0) {
+            return kWrongLocomotion;
+        }
+
+        return kPassed;
+    }
+
+    /**
+     * States as checked again right before a queued command runs.
+     */
+    Result CheckProcessStates(uint64_t action, uint32_t posture) const {
+        if (!(checks_ & kCheckStates) || (action & states_) == 0) {
+            return kPassed;
+        }
+
+        if ((action & states_) == states_) {
+            return kWrongState;
+        }
+
+        if (posture_mask_ && (posture_mask_ & posture) != 0) {
+            return kWrongLocomotion;
+        }
+
+        return kPassed;
+    }
+
+    uint64_t posture_mask() const { return posture_mask_; }
+    uint64_t states() const { return states_; }
+    uint32_t ability_crc() const { return ability_crc_; }
+    int32_t health_cost() const { return health_cost_; }
+    int32_t action_cost() const { return action_cost_; }
+    int32_t mind_cost() const { return mind_cost_; }
+
+private:
+    enum Check {
+        kCheckAbility    = 0x01,
+        kCheckStates     = 0x02,
+        kCheckLocomotion = 0x04,
+        kCheckWeapon     = 0x08,
+        kCheckHam        = 0x10
+    };
+
+    uint64_t posture_mask_;
+    uint64_t states_;
+    uint64_t locomotion_mask_;
+    uint32_t ability_crc_;
+    uint32_t weapon_group_;
+    int32_t health_cost_;
+    int32_t action_cost_;
+    int32_t mind_cost_;
+    uint8_t checks_;
+};
+
+}  // namespace zone
+
+#endif  // SRC_ZONESERVER_COMMANDRULES_H_
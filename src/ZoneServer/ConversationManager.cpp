@@ -56,7 +56,7 @@ ConversationManager::ConversationManager(Database* database) :
     mActiveConversationPool(sizeof(ActiveConversation)),
     mDBAsyncPool(sizeof(CVAsyncContainer))
 {
-    mDatabase->executeSqlAsync(this,new(mDBAsyncPool.malloc()) CVAsyncContainer(ConvQuery_Conversations),"SELECT id FROM %s.conversations ORDER BY id",mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.malloc()) CVAsyncContainer(ConvQuery_Conversations),"SELECT id FROM %s.conversations ORDER BY id",mDatabase->galaxy());
     
 }
 
@@ -112,7 +112,7 @@ void ConversationManager::handleDatabaseJobComplete(void* ref, DatabaseResult* r
             asCont = new(mDBAsyncPool.malloc()) CVAsyncContainer(ConvQuery_Pages);
             asCont->mConversation = conv;
 
-            mDatabase->executeSqlAsync(this,asCont,"SELECT * FROM %s.conversation_pages WHERE conversation_id=%u ORDER BY page",mDatabase->galaxy(), insertId);
+            mDatabase->executeStaticSqlAsync(this,asCont,"SELECT * FROM %s.conversation_pages WHERE conversation_id=%u ORDER BY page",mDatabase->galaxy(), insertId);
             
         }
 
@@ -158,13 +158,13 @@ void ConversationManager::handleDatabaseJobComplete(void* ref, DatabaseResult* r
             asCont = new(mDBAsyncPool.malloc()) CVAsyncContainer(ConvQuery_Page_OptionBatch);
             asCont->mConversationPage = page;
 
-            mDatabase->executeSqlAsync(this,asCont,"SELECT conversation_options.id,conversation_options.customText,conversation_options.stf_file,"
-                                       "conversation_options.stf_variable,conversation_options.event,conversation_options.pageLink "
-                                       "FROM "
-                                       "conversation_option_batches "
-                                       "INNER JOIN conversation_options ON (conversation_option_batches.option_id = conversation_options.id) "
-                                       "WHERE "
-                                       "(conversation_option_batches.id = %u) ORDER BY conversation_option_batches.option_id", batchId);
+            mDatabase->executeStaticSqlAsync(this,asCont,"SELECT conversation_options.id,conversation_options.customText,conversation_options.stf_file,"
+                                             "conversation_options.stf_variable,conversation_options.event,conversation_options.pageLink "
+                                             "FROM "
+                                             "conversation_option_batches "
+                                             "INNER JOIN conversation_options ON (conversation_option_batches.option_id = conversation_options.id) "
+                                             "WHERE "
+                                             "(conversation_option_batches.id = %u) ORDER BY conversation_option_batches.option_id", batchId);
            
         }
 
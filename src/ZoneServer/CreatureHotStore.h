@@ -0,0 +1,335 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef SRC_ZONESERVER_CREATUREHOTSTORE_H_
+#define SRC_ZONESERVER_CREATUREHOTSTORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ZoneServer/CreatureEnums.h"
+
+namespace zone {
+
+/**
+ * \brief Dense copy of the creature state that is read every tick.
+ *
+ * Position, cell, building, grid bucket, posture and the state bitmask of every
+ * creature live in parallel arrays, one row per creature, so range and target
+ * checks walk a few flat arrays instead of chasing CreatureObject pointers
+ * through the object map.
+ *
+ * A creature owns a handle for its whole life. Rows are kept dense: releasing
+ * a handle moves the last row into the hole, the handle of the moved row stays
+ * valid. Handles carry a generation so a released one never aliases the
+ * creature that reuses its slot.
+ *
+ * CreatureObject stays authoritative. It writes its posture and states through
+ * to the store and the spatial index pushes position, cell and grid bucket on
+ * every world update.
+ */
+class CreatureHotStore {
+public:
+    typedef uint32_t Handle;
+
+    static const Handle kInvalidHandle = 0;
+
+    /** The store of this zone process. */
+    static CreatureHotStore& Instance() {
+        static CreatureHotStore store;
+        return store;
+    }
+
+    CreatureHotStore() {
+        // row 0 of the slots is never used, so 0 stays the invalid handle
+        slots_.push_back(Slot());
+    }
+
+    /** Adds a row for a creature that has no id yet. */
+    Handle Create() {
+        uint32_t slot;
+
+        if (!free_slots_.empty()) {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(Slot());
+        }
+
+        slots_[slot].row = static_cast<uint32_t>(ids_.size());
+        slots_[slot].live = true;
+
+        Handle handle = MakeHandle_(slot, slots_[slot].generation);
+
+        ids_.push_back(0);
+        x_.push_back(0.0f);
+        y_.push_back(0.0f);
+        z_.push_back(0.0f);
+        parent_ids_.push_back(0);
+        building_ids_.push_back(0);
+        grid_buckets_.push_back(0);
+        postures_.push_back(0);
+        states_.push_back(0);
+        handles_.push_back(handle);
+
+        return handle;
+    }
+
+    /** Drops the row of the handle, the last row moves into its place. */
+    void Release(Handle handle) {
+        if (!IsValid(handle)) {
+            return;
+        }
+
+        Slot& slot = slots_[SlotOf_(handle)];
+        uint32_t row = slot.row;
+        uint32_t last = static_cast<uint32_t>(ids_.size()) - 1;
+
+        if (ids_[row]) {
+            auto it = by_id_.find(ids_[row]);
+
+            if (it != by_id_.end() && it->second == handle) {
+                by_id_.erase(it);
+            }
+        }
+
+        if (row != last) {
+            ids_[row] = ids_[last];
+            x_[row] = x_[last];
+            y_[row] = y_[last];
+            z_[row] = z_[last];
+            parent_ids_[row] = parent_ids_[last];
+            building_ids_[row] = building_ids_[last];
+            grid_buckets_[row] = grid_buckets_[last];
+            postures_[row] = postures_[last];
+            states_[row] = states_[last];
+            handles_[row] = handles_[last];
+
+            slots_[SlotOf_(handles_[row])].row = row;
+        }
+
+        ids_.pop_back();
+        x_.pop_back();
+        y_.pop_back();
+        z_.pop_back();
+        parent_ids_.pop_back();
+        building_ids_.pop_back();
+        grid_buckets_.pop_back();
+        postures_.pop_back();
+        states_.pop_back();
+        handles_.pop_back();
+
+        slot.live = false;
+        slot.generation = (slot.generation + 1) & kGenerationMask;
+        free_slots_.push_back(SlotOf_(handle));
+    }
+
+    bool IsValid(Handle handle) const {
+        uint32_t slot = SlotOf_(handle);
+
+        return slot != 0 && slot < slots_.size() && slots_[slot].live &&
+               slots_[slot].generation == GenerationOf_(handle);
+    }
+
+    /** Makes the creature findable by its object id. */
+    void Bind(Handle handle, uint64_t id) {
+        uint32_t row = Row(handle);
+
+        if (ids_[row] == id) {
+            return;
+        }
+
+        if (ids_[row]) {
+            by_id_.erase(ids_[row]);
+        }
+
+        ids_[row] = id;
+
+        if (id) {
+            by_id_[id] = handle;
+        }
+    }
+
+    /** The handle of the creature with the given object id, or kInvalidHandle. */
+    Handle Find(uint64_t id) const {
+        auto it = by_id_.find(id);
+        return (it != by_id_.end()) ? it->second : kInvalidHandle;
+    }
+
+    /** The dense row of a valid handle. */
+    uint32_t Row(Handle handle) const {
+        return slots_[SlotOf_(handle)].row;
+    }
+
+    size_t size() const {
+        return ids_.size();
+    }
+
+    /**
+     * \param building_id The building owning the cell, 0 when outside.
+     */
+    void SetPosition(Handle handle, float x, float y, float z, uint64_t parent_id, uint64_t building_id, uint32_t grid_bucket) {
+        uint32_t row = Row(handle);
+
+        x_[row] = x;
+        y_[row] = y;
+        z_[row] = z;
+        parent_ids_[row] = parent_id;
+        building_ids_[row] = building_id;
+        grid_buckets_[row] = grid_bucket;
+    }
+
+    void SetPosture(Handle handle, uint32_t posture) {
+        postures_[Row(handle)] = posture;
+    }
+
+    void SetState(Handle handle, uint64_t state) {
+        states_[Row(handle)] = state;
+    }
+
+    uint64_t parent_id(Handle handle) const { return parent_ids_[Row(handle)]; }
+    uint64_t building_id(Handle handle) const { return building_ids_[Row(handle)]; }
+    uint32_t posture(Handle handle) const { return postures_[Row(handle)]; }
+    uint64_t state(Handle handle) const { return states_[Row(handle)]; }
+
+    /** True for incapacitated and dead creatures. */
+    bool IsDown(Handle handle) const {
+        uint32_t posture = postures_[Row(handle)];
+        return posture == CreaturePosture_Incapacitated || posture == CreaturePosture_Dead;
+    }
+
+    /**
+     * Same rules as WorldManager::objectsInRange: both outside or in the same
+     * cell, or in cells of the same building, and no further apart than range.
+     */
+    bool InRange(Handle first, Handle second, float range) const {
+        uint32_t a = Row(first);
+        uint32_t b = Row(second);
+
+        if (parent_ids_[a] != parent_ids_[b]) {
+            if (!parent_ids_[a] || !parent_ids_[b] || !building_ids_[a] ||
+                building_ids_[a] != building_ids_[b]) {
+                return false;
+            }
+        }
+
+        return Within_(x_[a], y_[a], z_[a], b, range);
+    }
+
+    /** Range check from a point outside of any building. */
+    bool InRangeOutside(float x, float y, float z, Handle handle, float range) const {
+        uint32_t row = Row(handle);
+
+        if (parent_ids_[row]) {
+            return false;
+        }
+
+        return Within_(x, y, z, row, range);
+    }
+
+    /**
+     * Calls visitor(handle) for every creature outside of buildings that is
+     * standing and within range of x/z on the ground plane. This walks the
+     * position and posture columns front to back.
+     */
+    template<typename Visitor>
+    void ForEachStandingOutside(float x, float z, float range, Visitor visitor) const {
+        float range_squared = range * range;
+        size_t count = ids_.size();
+
+        for (size_t row = 0; row < count; ++row) {
+            float dx = x_[row] - x;
+            float dz = z_[row] - z;
+
+            if (dx * dx + dz * dz > range_squared || parent_ids_[row]) {
+                continue;
+            }
+
+            if (postures_[row] == CreaturePosture_Incapacitated || postures_[row] == CreaturePosture_Dead) {
+                continue;
+            }
+
+            visitor(handles_[row]);
+        }
+    }
+
+private:
+    static const uint32_t kSlotBits = 24;
+    static const uint32_t kSlotMask = (1u << kSlotBits) - 1;
+    static const uint32_t kGenerationMask = 0xff;
+
+    struct Slot {
+        Slot() : row(0), generation(0), live(false) {}
+
+        uint32_t row;
+        uint32_t generation;
+        bool live;
+    };
+
+    static Handle MakeHandle_(uint32_t slot, uint32_t generation) {
+        return (generation << kSlotBits) | slot;
+    }
+
+    static uint32_t SlotOf_(Handle handle) {
+        return handle & kSlotMask;
+    }
+
+    static uint32_t GenerationOf_(Handle handle) {
+        return handle >> kSlotBits;
+    }
+
+    bool Within_(float x, float y, float z, uint32_t row, float range) const {
+        float dx = x_[row] - x;
+        float dy = y_[row] - y;
+        float dz = z_[row] - z;
+
+        return dx * dx + dy * dy + dz * dz <= range * range;
+    }
+
+    // columns, one entry per live creature
+    std::vector<uint64_t> ids_;
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> z_;
+    std::vector<uint64_t> parent_ids_;
+    std::vector<uint64_t> building_ids_;
+    std::vector<uint32_t> grid_buckets_;
+    std::vector<uint32_t> postures_;
+    std::vector<uint64_t> states_;
+    std::vector<Handle> handles_;
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    std::unordered_map<uint64_t, Handle> by_id_;
+};
+
+}  // namespace zone
+
+#endif  // SRC_ZONESERVER_CREATUREHOTSTORE_H_
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "AttackableStaticNpc.h"
 #include "Buff.h"
 #include "BuildingObject.h"
+#include "CellObject.h"
 #include "EntertainerManager.h"
 #include "IncapRecoveryEvent.h"
 #include "PlayerObject.h"
@@ -115,6 +116,8 @@ CreatureObject::CreatureObject()
     states.blockLocomotion = false;
     states.blockPosture    = false;
 
+    states.hotHandle       = zone::CreatureHotStore::Instance().Create();
+
     // register event functions
     registerEventFunction(this,&CreatureObject::onIncapRecovery);
 
@@ -126,6 +129,58 @@ CreatureObject::CreatureObject()
 CreatureObject::~CreatureObject()
 {
     mBuffList.clear();
+
+    zone::CreatureHotStore::Instance().Release(states.hotHandle);
+}
+
+//=============================================================================
+//
+// called by the spatial index whenever we are added or moved
+// the cell lookup for the building only happens when we changed cells
+//
+
+void CreatureObject::syncHotState()
+{
+    zone::CreatureHotStore& store = zone::CreatureHotStore::Instance();
+    zone::CreatureHotStore::Handle handle = states.hotHandle;
+
+    if(!store.IsValid(handle))
+        return;
+
+    store.Bind(handle, getId());
+
+    uint64 buildingId = store.building_id(handle);
+
+    if(getParentId() != store.parent_id(handle))
+    {
+        buildingId = 0;
+
+        if(getParentId())
+        {
+            CellObject* cell = dynamic_cast<CellObject*>(gWorldManager->getObjectById(getParentId()));
+            if(cell)
+                buildingId = cell->getParentId();
+        }
+    }
+
+    store.SetPosition(handle, mPosition.x, mPosition.y, mPosition.z, getParentId(), buildingId, getGridBucket());
+
+    // the factories bind posture and states straight into the struct
+    store.SetPosture(handle, states.posture);
+    store.SetState(handle, states.action);
+}
+
+//=============================================================================
+//
+// called by the spatial index when we are removed from the world
+//
+
+void CreatureObject::unbindHotState()
+{
+    zone::CreatureHotStore& store = zone::CreatureHotStore::Instance();
+
+    if(store.IsValid(states.hotHandle))
+        store.Bind(states.hotHandle, 0);
 }
 
 //=============================================================================
@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "MovingObject.h"
 #include "SkillManager.h"
 #include "CreatureEnums.h"
+#include "CreatureHotStore.h"
 #include <map>
 #include <list>
 
@@ -68,6 +69,11 @@ class CreatureObject : public MovingObject
         // inherited from moving object
         virtual void		updateMovementProperties();
 
+        // pushes position, cell, grid bucket, posture and states into the hot state store
+        void				syncHotState();
+        // drops our id from the hot state store, lookups fall back to the object until we are synced again
+        void				unbindHotState();
+
         Ham*				getHam(){ return &mHam; }
 
         BString				getFirstName() const { return mFirstName; }
@@ -171,12 +177,14 @@ class CreatureObject : public MovingObject
             bool              blockPosture;
             bool              blockAction;
             bool              blockLocomotion;
+            // row of this creature in the hot state store
+            zone::CreatureHotStore::Handle hotHandle;
 
             void            blockLayers() { blockPosture = true; blockAction = true; blockLocomotion = true; }
             void            unblock() { blockPosture = false; blockAction = false; blockLocomotion = false; }
             // posture states
             uint32_t        getPosture() { return posture; } 
-            void            setPosture(uint32_t pos) { posture = pos; }
+            void            setPosture(uint32_t pos) { posture = pos; if(hotHandle) zone::CreatureHotStore::Instance().SetPosture(hotHandle, pos); }
             bool			checkPosture(uint32_t pos) const { return (posture == pos); }
             // locomotion states
             uint32_t        getLocomotion() { return locomotion; }
@@ -184,13 +192,14 @@ class CreatureObject : public MovingObject
             bool			checkLocomotion(uint32_t loco) const { return (locomotion == loco); }
             // action states
             uint64_t        getAction(){return action;}
-            void            toggleActionOn(CreatureState state){ action = action | state; }
-            void            toggleActionOff(CreatureState state){ action = action & ~ state; }
+            void            toggleActionOn(CreatureState state){ action = action | state; _syncAction(); }
+            void            toggleActionOff(CreatureState state){ action = action & ~ state; _syncAction(); }
             bool            checkState(CreatureState state){ return ((action & state) == state); }
             bool            checkStates(uint64_t states){ return ((action & states) == states); }
             bool            checkStatesEither(uint64_t states){ return ((action & states) != 0); }
             // clear states, do not call directly
-            void            clearAllStates() { action = CreatureState_ClearState;}
+            void            clearAllStates() { action = CreatureState_ClearState; _syncAction(); }
+            void            _syncAction() { if(hotHandle) zone::CreatureHotStore::Instance().SetState(hotHandle, action); }
         } states;
 
         // factions
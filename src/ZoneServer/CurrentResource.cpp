@@ -34,11 +34,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <glog/logging.h>
 
+#include <boost/interprocess/mapped_region.hpp>
+
 
 //=============================================================================
 
 CurrentResource::CurrentResource(bool writeResourceMaps, std::string zoneName) 
 	: Resource()
+	, mDistribution(NULL)
+	, mDistributionStride(0)
 	, mWriteResourceMaps(writeResourceMaps)
 	, mZoneName(zoneName)
 {
@@ -55,13 +59,45 @@ CurrentResource::~CurrentResource()
 float CurrentResource::getDistribution(int x,int z)
 {
     // translates to 1:32
-    return mResourceDistributionMap.GetValue((x >> 6),(z >> 6));
+    x >>= 6;
+    z >>= 6;
+
+    // same as NoiseMap::GetValue, outside of the map we are at the border value
+    if(!mDistribution || x < 0 || z < 0 || x >= kDistributionMapSize || z >= kDistributionMapSize)
+        return 0.0f;
+
+    return mDistribution[x + mDistributionStride * z];
 }
 
 //=============================================================================
 
-void CurrentResource::buildDistributionMap()
+void CurrentResource::buildDistributionMap(const ResourceMapCache* cache)
 {
+    _verifyNoiseSettings();
+
+    // every spawn gets its own pattern, the same one after each restart
+    mNoiseModule.SetSeed(static_cast<int>(mId ^ (mId >> 32)));
+    mNoiseModule.SetPersistence(mNoiseMapPersistence);
+    mNoiseModule.SetOctaveCount(mNoiseMapOctaves);
+    mNoiseModule.SetFrequency(mNoiseMapFrequency);
+
+    ResourceMapKey key = _getMapKey();
+
+    // the bitmap writer needs the noise map itself, so always generate when writing them
+    if(cache && !mWriteResourceMaps)
+    {
+        mCachedDistributionMap = cache->load(key);
+
+        if(mCachedDistributionMap)
+        {
+            mDistribution		= ResourceMapCache::getValues(*mCachedDistributionMap);
+            mDistributionStride	= kDistributionMapSize;
+
+            DLOG(INFO) << "Loaded cached DistributionMap for " << mName.getAnsi();
+            return;
+        }
+    }
+
     noise::utils::NoiseMapBuilderPlane	mapBuilder;
     noise::module::ScaleBias			flattenModule;
 
@@ -69,50 +105,78 @@ void CurrentResource::buildDistributionMap()
     flattenModule.SetScale(mNoiseMapScale);
     flattenModule.SetBias(mNoiseMapBias);
 
-    _verifyNoiseSettings();
-
-    mNoiseModule.SetPersistence(mNoiseMapPersistence);
-    mNoiseModule.SetOctaveCount(mNoiseMapOctaves);
-    mNoiseModule.SetFrequency(mNoiseMapFrequency);
-
     mapBuilder.SetSourceModule(flattenModule);
     mapBuilder.SetDestNoiseMap(mResourceDistributionMap);
 
     // translates to 1:32
-    mapBuilder.SetDestSize(512,512);
+    mapBuilder.SetDestSize(kDistributionMapSize,kDistributionMapSize);
     mapBuilder.SetBounds(mNoiseMapBoundsX1,mNoiseMapBoundsX2,mNoiseMapBoundsY1,mNoiseMapBoundsY2);
 
     LOG(INFO) << "Building DistributionMap for " << mName.getAnsi() << " " << mType->getName().getAnsi();
     mapBuilder.Build();
 
+    mDistribution		= mResourceDistributionMap.GetConstSlabPtr();
+    mDistributionStride	= mResourceDistributionMap.GetStride();
+
+    if(cache)
+        cache->store(key,mDistribution,mDistributionStride);
+
     if(mWriteResourceMaps)
-    {
-        BString fileName = (int8*)(mZoneName).c_str();
-        fileName << "_" << mName.getAnsi() << ".bmp";
-
-        LOG(INFO) << "Writing File " << fileName.getAnsi();
-
-        noise::utils::RendererImage renderer;
-        noise::utils::Image image;
-        renderer.SetSourceNoiseMap(mResourceDistributionMap);
-        renderer.SetDestImage(image);
-
-        renderer.ClearGradient();
-        renderer.AddGradientPoint(-1.0000,noise::utils::Color(0,0,0,255));
-        renderer.AddGradientPoint(-0.9999,noise::utils::Color(0,0,0,255));
-        renderer.AddGradientPoint(0.0000,noise::utils::Color(255,255,0,255));
-        renderer.AddGradientPoint(1.0000,noise::utils::Color(255,0,0,255));
-
-        renderer.EnableLight();
-        renderer.SetLightContrast(1.5);
-        renderer.SetLightBrightness(2.0);
-        renderer.Render();
-
-        noise::utils::WriterBMP writer;
-        writer.SetSourceImage(image);
-        writer.SetDestFilename(fileName.getAnsi());
-        writer.WriteDestFile();
-    }
+        _writeMapImage();
+}
+
+//=============================================================================
+
+void CurrentResource::_writeMapImage()
+{
+    BString fileName = (int8*)(mZoneName).c_str();
+    fileName << "_" << mName.getAnsi() << ".bmp";
+
+    LOG(INFO) << "Writing File " << fileName.getAnsi();
+
+    noise::utils::RendererImage renderer;
+    noise::utils::Image image;
+    renderer.SetSourceNoiseMap(mResourceDistributionMap);
+    renderer.SetDestImage(image);
+
+    renderer.ClearGradient();
+    renderer.AddGradientPoint(-1.0000,noise::utils::Color(0,0,0,255));
+    renderer.AddGradientPoint(-0.9999,noise::utils::Color(0,0,0,255));
+    renderer.AddGradientPoint(0.0000,noise::utils::Color(255,255,0,255));
+    renderer.AddGradientPoint(1.0000,noise::utils::Color(255,0,0,255));
+
+    renderer.EnableLight();
+    renderer.SetLightContrast(1.5);
+    renderer.SetLightBrightness(2.0);
+    renderer.Render();
+
+    noise::utils::WriterBMP writer;
+    writer.SetSourceImage(image);
+    writer.SetDestFilename(fileName.getAnsi());
+    writer.WriteDestFile();
+}
+
+//=============================================================================
+
+ResourceMapKey CurrentResource::_getMapKey() const
+{
+    ResourceMapKey key;
+
+    key.mResourceId		= mId;
+    key.mSeed			= mNoiseModule.GetSeed();
+    key.mOctaves		= mNoiseMapOctaves;
+    key.mFrequency		= mNoiseMapFrequency;
+    key.mPersistence	= mNoiseMapPersistence;
+    key.mScale			= mNoiseMapScale;
+    key.mBias			= mNoiseMapBias;
+    key.mBoundsX1		= mNoiseMapBoundsX1;
+    key.mBoundsX2		= mNoiseMapBoundsX2;
+    key.mBoundsY1		= mNoiseMapBoundsY1;
+    key.mBoundsY2		= mNoiseMapBoundsY2;
+    key.mWidth			= kDistributionMapSize;
+    key.mHeight			= kDistributionMapSize;
+
+    return key;
 }
 
 //=============================================================================
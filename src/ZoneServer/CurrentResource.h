@@ -31,10 +31,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/typedefs.h"
 #include "Resource.h"
 #include "ZoneServer/noiseutils.h"
+#include "ZoneServer/ResourceMapCache.h"
 #include <noise/noise.h>
 #include <string>
 
 
+//=============================================================================
+
+// distribution maps are generated at 512x512, which translates to 1:32 on the planet
+const int kDistributionMapSize = 512;
+
 //=============================================================================
 
 class CurrentResource : public Resource
@@ -46,13 +52,18 @@ public:
     CurrentResource(bool writeResourceMaps, std::string zoneName);
     ~CurrentResource();
 
-    void	buildDistributionMap();
+    // uses the cached map for our noise settings if there is one, otherwise generates and stores it
+    // safe to call for different resources at the same time
+    void	buildDistributionMap(const ResourceMapCache* cache = NULL);
 
     float	getDistribution(int x,int z);
 
 private:
 
     void	_verifyNoiseSettings();
+    void	_writeMapImage();
+
+    ResourceMapKey	_getMapKey() const;
 
     double	mNoiseMapBoundsX1,mNoiseMapBoundsX2;
     double	mNoiseMapBoundsY1,mNoiseMapBoundsY2;
@@ -66,6 +77,9 @@ private:
 
     noise::module::Perlin	mNoiseModule;
     noise::utils::NoiseMap	mResourceDistributionMap;
+    ResourceMapCache::MappedMap	mCachedDistributionMap;
+    const float*			mDistribution;
+    int						mDistributionStride;
 	bool					mWriteResourceMaps;
 	std::string				mZoneName;
 };
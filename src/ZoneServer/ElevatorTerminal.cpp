@@ -64,6 +64,7 @@ void ElevatorTerminal::handleObjectMenuSelect(uint8 messageType,Object* srcObjec
         playerObject->mDirection = mDstDirUp;
         playerObject->mPosition  = mDstPosUp;
         playerObject->setParentId(mDstCellUp);
+        playerObject->syncHotState();
         playerObject->updatePosition(mDstCellUp,mDstPosUp);
 
 
@@ -80,6 +81,7 @@ void ElevatorTerminal::handleObjectMenuSelect(uint8 messageType,Object* srcObjec
         playerObject->mDirection = mDstDirDown;
         playerObject->mPosition  = mDstPosDown;
         playerObject->setParentId(mDstCellDown);
+        playerObject->syncHotState();
 
         playerObject->updatePosition(mDstCellDown,mDstPosDown);
 
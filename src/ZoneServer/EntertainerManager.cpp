@@ -83,20 +83,20 @@ EntertainerManager::EntertainerManager(Database* database,MessageDispatch* dispa
 
     // load our performance Data
     asyncContainer = new EntertainerManagerAsyncContainer(EMQuery_LoadPerformances, 0);
-    mDatabase->executeSqlAsync(this,asyncContainer,"SELECT performanceName, instrumentAudioId, InstrumenType, danceVisualId,	actionPointPerLoop"
-                                                   ",loopDuration,	florushXpMod,	healMindWound,	healShockWound, MusicVisualId FROM %s.entertainer_performances",
-                                                   mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,asyncContainer,"SELECT performanceName, instrumentAudioId, InstrumenType, danceVisualId,	actionPointPerLoop"
+                                                         ",loopDuration,	florushXpMod,	healMindWound,	healShockWound, MusicVisualId FROM %s.entertainer_performances",
+                                                         mDatabase->galaxy());
 
 
     // load our attribute data for ID
     asyncContainer = new EntertainerManagerAsyncContainer(EMQuery_LoadIDAttributes, 0);
-    mDatabase->executeSqlAsync(this,asyncContainer,"SELECT CustomizationCRC, SpeciesCRC, Atr1ID, Atr1Name, Atr2ID, Atr2Name, XP, Hair, divider FROM %s.id_attributes",
-                                                   mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,asyncContainer,"SELECT CustomizationCRC, SpeciesCRC, Atr1ID, Atr1Name, Atr2ID, Atr2Name, XP, Hair, divider FROM %s.id_attributes",
+                                                         mDatabase->galaxy());
 
 
     // load our holoemote Data
     asyncContainer = new EntertainerManagerAsyncContainer(EMQuery_LoadHoloEmotes, 0);
-    mDatabase->executeSqlAsync(this,asyncContainer,"SELECT crc, effect_id, name FROM %s.holoemote",mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,asyncContainer,"SELECT crc, effect_id, name FROM %s.holoemote",mDatabase->galaxy());
 
 }
 
@@ -2507,6 +2507,7 @@ bool EntertainerManager::approachInstrument(PlayerObject* entertainer, uint64 in
 
                     entertainer->mPosition = instrument->mPosition;
                     entertainer->mDirection = instrument->mDirection;
+                    entertainer->syncHotState();
 
                     entertainer->updatePosition(instrument->getParentId(),instrument->mPosition);
 
@@ -109,7 +109,7 @@ void FactoryCrate::sendAttributes(PlayerObject* playerObject)
 
         gMessageFactory->addString(gWorldManager->getAttributeKey((*mapIt).first));
 
-        value = (*mapIt).second.c_str();
+        value = (*mapIt).second.toString().c_str();
         value.convert(BSTRType_Unicode16);
 
         gMessageFactory->addString(value);
@@ -130,7 +130,7 @@ void FactoryCrate::sendAttributes(PlayerObject* playerObject)
 
         gMessageFactory->addString(gWorldManager->getAttributeKey((*mapIt).first));
 
-        value = (*mapIt).second.c_str();
+        value = (*mapIt).second.toString().c_str();
         value.convert(BSTRType_Unicode16);
 
         gMessageFactory->addString(value);
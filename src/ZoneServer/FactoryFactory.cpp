@@ -321,7 +321,6 @@ void FactoryFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
         asynContainer->mClient = asyncContainer->mClient;
         asynContainer->mId		= factory->getId();
 
-
         mDatabase->executeSqlAsync(this,asynContainer,"SELECT attributes.name,sa.value,attributes.internal"
                                    " FROM %s.structure_attributes sa"
                                    " INNER JOIN %s.attributes ON (sa.attribute_id = attributes.id)"
@@ -239,17 +239,15 @@ void Food::_handleBuff(PlayerObject* playerObject)
 
     while(it != mAttributeMap.end())
     {
-        uint32 amount = 0;
-        try
+        float value = 0.0f;
+
+        //skip past attributes we don't want to handle (such as string names etc)
+        if(it->second.as(value))
         {
-            amount =static_cast<uint32>(boost::lexical_cast<float>(it->second));
+            uint32 amount = static_cast<uint32>(value);
             BuffAttribute* foodAttribute = new BuffAttribute(it->first, +(int)amount,0,-(int)amount);
             mBuff->AddAttribute(foodAttribute);
         }
-        catch(boost::bad_lexical_cast &)
-        {
-            //skip past as these are attributes we don't want to handle (such as string names etc)
-        }
 
         ++it;
     }
@@ -128,7 +128,6 @@ public:
 
     void			calcAllModifiedHitPoints();
 
-    bool			regenerate(uint64 time,void*);
     uint64			getLastRegenTick() {
         return mLastRegenTick;
     }
@@ -141,6 +140,7 @@ public:
     int32			getHealthRegenRate();
     int32			getActionRegenRate();
     int32			getMindRegenRate();
+    int32			getForceRegenRate();
 
     uint64			getTaskId() {
         return mTaskId;
@@ -188,11 +188,6 @@ public:
 
 private:
 
-    bool			_regenHealth();
-    bool			_regenAction();
-    bool			_regenMind();
-    bool			_regenForce();
-
     CreatureObject*	mParent;
 
     uint64			mLastRegenTick;
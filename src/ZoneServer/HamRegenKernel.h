@@ -0,0 +1,107 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+
+#ifndef SRC_ZONESERVER_HAMREGENKERNEL_H_
+#define SRC_ZONESERVER_HAMREGENKERNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANH_HAM_REGEN_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace zone {
+
+/**
+ * Advances a run of ham pools by one regeneration tick, one pool at a time.
+ * The reference for RegenerateHamPools, which must give the same results.
+ */
+inline void RegenerateHamPoolsScalar(int32_t* current, const int32_t* max, const int32_t* rate, uint8_t* changed, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (current[i] < max[i] && rate[i] > 0) {
+            int32_t sum = current[i] + rate[i];
+            current[i] = (sum > max[i]) ? max[i] : sum;
+            changed[i] = 1;
+        } else {
+            changed[i] = 0;
+        }
+    }
+}
+
+/**
+ * Advances a run of ham pools by one regeneration tick.
+ *
+ * A pool below its maximum gains its rate, capped at the maximum. Pools that
+ * are full or have no positive rate are left alone. This is the rule
+ * HamProperty::updateCurrentHitpoints applies to a regeneration step, done four
+ * pools at a time where SSE2 is available.
+ *
+ * \param current The current values, updated in place.
+ * \param max The maximum of each pool.
+ * \param rate The amount each pool regenerates per tick.
+ * \param changed Set to 1 for every pool whose value changed, 0 otherwise.
+ * \param count The number of pools.
+ */
+inline void RegenerateHamPools(int32_t* current, const int32_t* max, const int32_t* rate, uint8_t* changed, size_t count) {
+    size_t i = 0;
+
+#ifdef ANH_HAM_REGEN_SSE2
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + i));
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(max + i));
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rate + i));
+
+        // min(current + rate, max), SSE2 has no 32 bit min.
+        __m128i sum = _mm_add_epi32(c, r);
+        __m128i over = _mm_cmpgt_epi32(sum, m);
+        __m128i capped = _mm_or_si128(_mm_and_si128(over, m), _mm_andnot_si128(over, sum));
+
+        __m128i apply = _mm_and_si128(_mm_cmplt_epi32(c, m), _mm_cmpgt_epi32(r, zero));
+        __m128i result = _mm_or_si128(_mm_and_si128(apply, capped), _mm_andnot_si128(apply, c));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(current + i), result);
+
+        int lanes = _mm_movemask_ps(_mm_castsi128_ps(apply));
+        changed[i]     = static_cast<uint8_t>(lanes & 1);
+        changed[i + 1] = static_cast<uint8_t>((lanes >> 1) & 1);
+        changed[i + 2] = static_cast<uint8_t>((lanes >> 2) & 1);
+        changed[i + 3] = static_cast<uint8_t>((lanes >> 3) & 1);
+    }
+#endif
+
+    RegenerateHamPoolsScalar(current + i, max + i, rate + i, changed + i, count - i);
+}
+
+}  // namespace zone
+
+#endif  // SRC_ZONESERVER_HAMREGENKERNEL_H_
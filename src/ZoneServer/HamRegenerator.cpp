@@ -0,0 +1,211 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "ZoneServer/HamRegenerator.h"
+
+#include <algorithm>
+
+#include "MessageLib/MessageLib.h"
+#include "ZoneServer/CreatureObject.h"
+#include "ZoneServer/Ham.h"
+#include "ZoneServer/HamRegenKernel.h"
+#include "ZoneServer/PlayerObject.h"
+
+namespace zone {
+
+namespace {
+
+// Creatures handled per pass over the arrays, small enough for the arrays and
+// the creatures' hams to stay in the first level cache.
+const size_t kChunkSize = 256;
+
+}  // namespace
+
+HamRegenerator::HamRegenerator(uint64_t tick_interval)
+    : next_id_(1)
+    , tick_interval_(tick_interval)
+    , last_tick_(0) {
+    for (int pool = 0; pool < kPoolCount; ++pool) {
+        current_[pool].resize(kChunkSize);
+        max_[pool].resize(kChunkSize);
+        rate_[pool].resize(kChunkSize);
+        changed_[pool].resize(kChunkSize);
+    }
+}
+
+HamRegenerator::~HamRegenerator() {}
+
+uint64_t HamRegenerator::Add(Ham* ham) {
+    uint64_t id = next_id_++;
+
+    // The parent's type is fixed, look it up once instead of casting every tick.
+    CreatureObject* parent = ham->getParent();
+    PlayerObject* player = (parent && parent->getType() == ObjType_Player) ? static_cast<PlayerObject*>(parent) : nullptr;
+
+    slots_[id] = hams_.size();
+
+    hams_.push_back(ham);
+    players_.push_back(player);
+    ids_.push_back(id);
+
+    return id;
+}
+
+void HamRegenerator::Remove(uint64_t id) {
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+        return;
+    }
+
+    RemoveSlot_(it->second);
+}
+
+bool HamRegenerator::IsRegenerating(uint64_t id) const {
+    return slots_.find(id) != slots_.end();
+}
+
+void HamRegenerator::Process(uint64_t current_time) {
+    if (current_time - last_tick_ < tick_interval_) {
+        return;
+    }
+
+    last_tick_ = current_time;
+
+    Tick_();
+}
+
+void HamRegenerator::Tick_() {
+    size_t count = hams_.size();
+
+    finished_.clear();
+
+    for (size_t begin = 0; begin < count; begin += kChunkSize) {
+        size_t chunk = std::min(kChunkSize, count - begin);
+
+        Gather_(begin, chunk);
+
+        for (int pool = 0; pool < kPoolCount; ++pool) {
+            RegenerateHamPools(&current_[pool][0], &max_[pool][0], &rate_[pool][0], &changed_[pool][0], chunk);
+        }
+
+        for (size_t lane = 0; lane < chunk; ++lane) {
+            if (Apply_(begin + lane, lane)) {
+                finished_.push_back(begin + lane);
+            }
+        }
+    }
+
+    // Remove from the back, removing a slot moves the last one into it and
+    // that one is never a finished slot still to be removed.
+    for (auto it = finished_.rbegin(); it != finished_.rend(); ++it) {
+        hams_[*it]->setTaskId(0);
+        RemoveSlot_(*it);
+    }
+}
+
+void HamRegenerator::Gather_(size_t begin, size_t count) {
+    for (size_t lane = 0; lane < count; ++lane) {
+        Ham* ham = hams_[begin + lane];
+
+        current_[kHealth][lane] = ham->mHealth.getCurrentHitPoints();
+        max_[kHealth][lane] = ham->mHealth.getModifiedHitPoints();
+        rate_[kHealth][lane] = ham->getHealthRegenRate();
+
+        current_[kAction][lane] = ham->mAction.getCurrentHitPoints();
+        max_[kAction][lane] = ham->mAction.getModifiedHitPoints();
+        rate_[kAction][lane] = ham->getActionRegenRate();
+
+        current_[kMind][lane] = ham->mMind.getCurrentHitPoints();
+        max_[kMind][lane] = ham->mMind.getModifiedHitPoints();
+        rate_[kMind][lane] = ham->getMindRegenRate();
+
+        current_[kForce][lane] = ham->getCurrentForce();
+        max_[kForce][lane] = ham->getMaxForce();
+        rate_[kForce][lane] = ham->getForceRegenRate();
+    }
+}
+
+bool HamRegenerator::Apply_(size_t slot, size_t lane) {
+    Ham* ham = hams_[slot];
+    uint32_t bars = 0;
+
+    if (changed_[kHealth][lane]) {
+        ham->mHealth.setCurrentHitPoints(current_[kHealth][lane]);
+        bars |= 1 << HamBar_Health;
+    }
+
+    if (changed_[kAction][lane]) {
+        ham->mAction.setCurrentHitPoints(current_[kAction][lane]);
+        bars |= 1 << HamBar_Action;
+    }
+
+    if (changed_[kMind][lane]) {
+        ham->mMind.setCurrentHitPoints(current_[kMind][lane]);
+        bars |= 1 << HamBar_Mind;
+    }
+
+    if (bars) {
+        gMessageLib->sendCurrentHitpointDeltasCreo6_Bars(ham->getParent(), bars);
+    }
+
+    if (changed_[kForce][lane]) {
+        ham->setCurrentForce(current_[kForce][lane]);
+
+        if (players_[slot]) {
+            gMessageLib->sendUpdateCurrentForce(players_[slot]);
+        }
+    }
+
+    for (int pool = 0; pool < kPoolCount; ++pool) {
+        if (current_[pool][lane] < max_[pool][lane]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void HamRegenerator::RemoveSlot_(size_t slot) {
+    size_t last = hams_.size() - 1;
+
+    slots_.erase(ids_[slot]);
+
+    if (slot != last) {
+        hams_[slot] = hams_[last];
+        players_[slot] = players_[last];
+        ids_[slot] = ids_[last];
+
+        slots_[ids_[slot]] = slot;
+    }
+
+    hams_.pop_back();
+    players_.pop_back();
+    ids_.pop_back();
+}
+
+}  // namespace zone
@@ -0,0 +1,131 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+
+#ifndef SRC_ZONESERVER_HAMREGENERATOR_H_
+#define SRC_ZONESERVER_HAMREGENERATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Ham;
+class PlayerObject;
+
+namespace zone {
+
+/**
+ * \brief Regenerates the ham of every wounded creature in one batch per tick.
+ *
+ * The regenerating creatures are kept in one flat list. Once a tick their
+ * health, action, mind and force pools are copied into one array per pool,
+ * a chunk of creatures at a time, advanced together by RegenerateHamPools and
+ * the changed values written back while the creatures are still in cache.
+ * Every creature then sends a single deltas message for all of its changed
+ * bars. Creatures leave the batch once all pools are full.
+ *
+ * The Ham stays the owner of its values, they change between ticks through
+ * damage, healing and buffs, so the arrays are refilled every tick.
+ *
+ * This replaces the scheduler task every wounded creature used to hold.
+ */
+class HamRegenerator {
+public:
+    /**
+     * \param tick_interval The time between two regeneration ticks in ms.
+     */
+    explicit HamRegenerator(uint64_t tick_interval = 1000);
+    ~HamRegenerator();
+
+    /**
+     * Starts regenerating a ham, it stays in the batch until it's full or removed.
+     *
+     * \returns The id to remove the ham with, never 0.
+     */
+    uint64_t Add(Ham* ham);
+
+    void Remove(uint64_t id);
+
+    bool IsRegenerating(uint64_t id) const;
+
+    /**
+     * Runs a regeneration tick once the tick interval has passed.
+     *
+     * \param current_time The current local time in ms.
+     */
+    void Process(uint64_t current_time);
+
+    size_t size() const { return hams_.size(); }
+
+private:
+    // Disable compiler generated methods.
+    HamRegenerator(const HamRegenerator&);
+    const HamRegenerator& operator=(const HamRegenerator&);
+
+    enum Pool {
+        kHealth = 0,
+        kAction,
+        kMind,
+        kForce,
+        kPoolCount
+    };
+
+    void Tick_();
+
+    /// Copies the pools of the slots [begin, begin + count) into the arrays.
+    void Gather_(size_t begin, size_t count);
+
+    /// Writes a slot's changed pools back and sends the updates, returns true
+    /// once all of its pools are full.
+    bool Apply_(size_t slot, size_t lane);
+
+    void RemoveSlot_(size_t slot);
+
+    std::vector<Ham*> hams_;
+    std::vector<PlayerObject*> players_;
+    std::vector<uint64_t> ids_;
+
+    // One chunk of pools, lane n holds the slot at the chunk's start + n.
+    std::vector<int32_t> current_[kPoolCount];
+    std::vector<int32_t> max_[kPoolCount];
+    std::vector<int32_t> rate_[kPoolCount];
+    std::vector<uint8_t> changed_[kPoolCount];
+
+    std::vector<size_t> finished_;
+
+    std::unordered_map<uint64_t, size_t> slots_;
+
+    uint64_t next_id_;
+    uint64_t tick_interval_;
+    uint64_t last_tick_;
+};
+
+}  // namespace zone
+
+#endif  // SRC_ZONESERVER_HAMREGENERATOR_H_
@@ -43,6 +43,7 @@ Heightmap::Heightmap(const char* planet_name, uint16 resolution)
     , mCacheHeight(0)
     , mCacheWidth(0)
     , mCacheResoulutionDivider(3)
+    , mContext(zone::WorldContext::Current())
     , WIDTH(15361)
     , HEIGHT(15361)
     , mReady(false)
@@ -96,23 +97,27 @@ Heightmap::~Heightmap()
         mHeightmapCache = NULL;
     }
 
-    mInstance = NULL;
+    if (mContext->heightmap() == this)
+    {
+        mContext->heightmap(NULL);
+    }
 }
 
 //=============================================================================
 
-Heightmap*	Heightmap::mInstance = NULL;
 bool Heightmap::mCacheAvaliable = false;
 
 //======================================================================================================================
 
 Heightmap* Heightmap::Instance(uint16 resolution)
 {
-    if (!mInstance)
+    zone::WorldContext* context = zone::WorldContext::Current();
+
+    if (!context->heightmap())
     {
-        mInstance = new Heightmap(gWorldManager->getPlanetNameThis(), resolution);
+        context->heightmap(new Heightmap(gWorldManager->getPlanetNameThis(), resolution));
     }
-    return mInstance;
+    return context->heightmap();
 }
 
 //=============================================================================
@@ -157,6 +162,9 @@ void Heightmap::fillInIterator(HeightResultMap::iterator it)
 
 void Heightmap::RunThread()
 {
+    // the job callbacks use the managers of the world that created us
+    zone::ScopedWorldContext context(mContext);
+
     // create a height-map cashe.
     DLOG(WARNING) << "Height map resolution = " << mResolution;
 
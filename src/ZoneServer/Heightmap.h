@@ -34,6 +34,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <boost/thread/thread.hpp>
 #include <string>
 #include "HeightmapAsyncContainer.h"
+#include "WorldContext.h"
 #include <queue>
 
 class Heightmap
@@ -42,14 +43,16 @@ class Heightmap
 public:
     static Heightmap*  Instance(uint16 resolution);
     static Heightmap*  getSingletonPtr() {
-        return mInstance;
+        return zone::WorldContext::Current()->heightmap();
     }
     static void deleter(void)
     {
-        if (mInstance)
+        zone::WorldContext* context = zone::WorldContext::Current();
+
+        if (context->heightmap())
         {
-            delete mInstance;
-            mInstance = 0;
+            delete context->heightmap();
+            context->heightmap(NULL);
         }
     }
 
@@ -125,8 +128,8 @@ private:
 
 protected:
 
-    static Heightmap*  mInstance;
-    // static bool        mInsFlag;
+    // the world this heightmap belongs to, its job thread runs bound to it
+    zone::WorldContext* mContext;
     std::string mFilename;
     FILE * hmp; //file pointer to the highmap
 
@@ -122,44 +122,6 @@ void HouseFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
 
         mDatabase->destroyDataBinding(cellBinding);
 
-        //read in admin list - do houses only have an admin list ???
-        QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,HOFQuery_AdminData,asyncContainer->mClient);
-        asContainer->mObject = house;
-
-        int8 sql[1024];
-        sprintf(sql,"SELECT PlayerID FROM %s.structure_admin_data WHERE StructureID = %"PRIu64" AND AdminType like 'ADMIN';",mDatabase->galaxy(),house->getId());
-        mDatabase->executeSqlAsync(this,asContainer,sql);
-        
-
-    }
-    break;
-
-    case HOFQuery_AdminData:
-    {
-        HouseObject*	house = dynamic_cast<HouseObject*>(asyncContainer->mObject);
-
-
-        struct adminStruct
-        {
-            uint64 playerID;
-            BString adminList;
-        };
-
-        adminStruct adminData;
-
-        DataBinding*	adminBinding = mDatabase->createDataBinding(1);
-        adminBinding->addField(DFT_uint64,offsetof(adminStruct,playerID),8,0);
-
-        uint64 count = result->getRowCount();
-
-        for(uint32 j = 0; j < count; j++)
-        {
-            result->getNextRow(adminBinding,&adminData);
-            house->addHousingAdminEntry(adminData.playerID);
-        }
-
-        mDatabase->destroyDataBinding(adminBinding);
-
     }
     break;
 
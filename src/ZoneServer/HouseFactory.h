@@ -48,7 +48,6 @@ enum HOFQuery
 {
     HOFQuery_MainData					= 1,
     HOFQuery_AttributeData				= 2,
-    HOFQuery_AdminData					= 3,
     HOFQuery_CellData					= 4
 
 
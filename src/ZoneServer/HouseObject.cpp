@@ -147,18 +147,7 @@ void HouseObject::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
 
 bool HouseObject::hasAdmin(uint64 id)
 {
-    ObjectIDList		adminList =	getHousingList();
-
-    ObjectIDList::iterator it =	 adminList.begin();
-
-    while (it != adminList.end())
-    {
-        if( id == (*it))
-            return true;
-
-        it++;
-    }
-    return false;
+    return hasAdminRights(id);
 }
 
 
@@ -175,7 +175,7 @@ void Instrument::sendAttributes(PlayerObject* playerObject)
 
         gMessageFactory->addString(gWorldManager->getAttributeKey((*mapIt).first));
 
-        value = (*mapIt).second.c_str();
+        value = (*mapIt).second.toString().c_str();
         value.convert(BSTRType_Unicode16);
 
         gMessageFactory->addString(value);
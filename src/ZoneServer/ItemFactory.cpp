@@ -55,13 +55,62 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ChanceCube.h"
 #include "WorldManager.h"
 #include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseImplementationSnapshot.h"
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/QueryChain.h"
 #include "WorldConfig.h"
 
 #include "Utils/utils.h"
 
 #include <cassert>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include <boost/lexical_cast.hpp>
+
+#include <cppconn/resultset.h>
+#include <cppconn/resultset_metadata.h>
+
+//=============================================================================
+//
+// the item load queries, prototypes are read with the same ones
+//
+
+static const char* kItemMainDataQuery =
+    "SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
+    "items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
+    "item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
+    "item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
+    "item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container "
+    "FROM %s.items "
+    "INNER JOIN %s.item_types ON (items.item_type = item_types.id) "
+    "LEFT JOIN %s.item_customization ON (items.id = item_customization.id)"
+    "WHERE items.id = %"PRIu64"";
+
+static const char* kItemAttributesQuery =
+    "SELECT attributes.name,item_attributes.value,attributes.internal"
+    " FROM %s.item_attributes"
+    " INNER JOIN %s.attributes ON (item_attributes.attribute_id = attributes.id)"
+    " WHERE item_attributes.item_id = %"PRIu64" ORDER BY item_attributes.order";
+
+// columns of the items table a copy of a prototype may change and their cell
+// in the main data query
+static const struct
+{
+    const char*	mColumn;
+    uint32		mCell;
+} kPrototypeColumns[] =
+{
+    { "id",			0 },
+    { "parent_id",	1 },
+    { "x",			9 },
+    { "y",			10 },
+    { "z",			11 },
+    { "planet_id",	12 },
+    { "customName",	13 }
+};
 
 //=============================================================================
 
@@ -85,6 +134,7 @@ ItemFactory*	ItemFactory::Init(Database* database)
 //=============================================================================
 
 ItemFactory::ItemFactory(Database* database) : FactoryBase(database)
+    , mPrototypeReader(new DatabaseImplementationSnapshot())
 {
     _setupDatabindings();
 }
@@ -121,10 +171,7 @@ void ItemFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
             asContainer->mObject = item;
             asContainer->mDepth = asyncContainer->mDepth;
 
-            mDatabase->executeSqlAsync(this,asContainer,"SELECT attributes.name,item_attributes.value,attributes.internal"
-                                       " FROM %s.item_attributes"
-                                       " INNER JOIN %s.attributes ON (item_attributes.attribute_id = attributes.id)"
-                                       " WHERE item_attributes.item_id = %"PRIu64" ORDER BY item_attributes.order",
+            mDatabase->executeSqlAsync(this,asContainer,kItemAttributesQuery,
                                        mDatabase->galaxy(),mDatabase->galaxy(),item->getId());
                }
     }
@@ -226,16 +273,8 @@ void ItemFactory::requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint
     QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,ItemFactoryQuery_MainData,client,id);
     asContainer->mDepth = 0;
 
-    mDatabase->executeSqlAsync(this,asContainer,
-                               "SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
-                               "items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
-                               "item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
-                               "item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
-                               "item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container "
-                               "FROM %s.items "
-                               "INNER JOIN %s.item_types ON (items.item_type = item_types.id) "
-                               "LEFT JOIN %s.item_customization ON (items.id = item_customization.id)"
-                               "WHERE items.id = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),id);
+    mDatabase->executeSqlAsync(this,asContainer,kItemMainDataQuery,
+                               mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),id);
    
 }
 
@@ -246,21 +285,231 @@ void ItemFactory::requestContainerContent(ObjectFactoryCallback* ofCallback,uint
     QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,ItemFactoryQuery_MainData,client,id);
     asContainer->mDepth = depth;
 
-    mDatabase->executeSqlAsync(this,asContainer,
-                               "SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
-                               "items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
-                               "item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
-                               "item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
-                               "item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container "
-                               "FROM %s.items "
-                               "INNER JOIN %s.item_types ON (items.item_type = item_types.id) "
-                               "LEFT JOIN %s.item_customization ON (items.id = item_customization.id)"
-                               "WHERE items.id = %"PRIu64"",mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),id);
+    mDatabase->executeSqlAsync(this,asContainer,kItemMainDataQuery,
+                               mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),id);
   
 }
 
 //=============================================================================
 
+bool ItemFactory::hasPrototype(const std::string& key) const
+{
+    return mPrototypes.find(key) != mPrototypes.end();
+}
+
+//=============================================================================
+//
+// reads the rows the database created for the item before anything else can
+// change them, then builds the item from the same rows
+//
+
+void ItemFactory::requestPrototype(ObjectFactoryCallback* ofCallback,uint64 id,const std::string& key)
+{
+    std::shared_ptr<ItemPrototype> prototype = std::make_shared<ItemPrototype>();
+    int8 sql[2048];
+
+    std::shared_ptr<QueryChain> chain = QueryChain::create(mDatabase);
+
+    sprintf(sql,"SELECT * FROM %s.items WHERE id=%"PRIu64"",mDatabase->galaxy(),id);
+    chain->then(sql,[=] (DatabaseResult* result) {
+        return _readPrototypeRows(result,prototype->mItem) && !prototype->mItem.mValues.empty();
+    });
+
+    sprintf(sql,"SELECT * FROM %s.item_attributes WHERE item_id=%"PRIu64" ORDER BY item_attributes.order",mDatabase->galaxy(),id);
+    chain->then(sql,[=] (DatabaseResult* result) {
+        return _readPrototypeRows(result,prototype->mItemAttributes);
+    });
+
+    sprintf(sql,"SELECT * FROM %s.item_customization WHERE id=%"PRIu64"",mDatabase->galaxy(),id);
+    chain->then(sql,[=] (DatabaseResult* result) {
+        return _readPrototypeRows(result,prototype->mItemCustomization);
+    });
+
+    sprintf(sql,kItemMainDataQuery,mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),id);
+    chain->then(sql,[=] (DatabaseResult* result) -> bool {
+        uint32 columns;
+        return DatabaseSnapshotWriter::readResult(result,columns,prototype->mMainData) && !prototype->mMainData.empty();
+    });
+
+    sprintf(sql,kItemAttributesQuery,mDatabase->galaxy(),mDatabase->galaxy(),id);
+    chain->then(sql,[=] (DatabaseResult* result) -> bool {
+        prototype->mComplete = DatabaseSnapshotWriter::readResult(result,prototype->mAttributeColumns,prototype->mAttributes);
+        return true;
+    });
+
+    chain->finally([=] () {
+        if(!prototype->mComplete)
+        {
+            LOG(WARNING) << "Unable to read the prototype " << key << " from item " << id;
+            requestObject(ofCallback,id,0,0,0);
+            return;
+        }
+
+        // an item created for the same key in the meantime may have won the race
+        mPrototypes.insert(std::make_pair(key,prototype));
+
+        ofCallback->handleObjectReady(_createFromPrototype(*prototype,ColumnValues()),NULL);
+    });
+
+    chain->execute();
+}
+
+//=============================================================================
+
+Item* ItemFactory::createFromPrototype(const std::string& key,uint64 id,uint64 parentId,uint16 planetId,const glm::vec3& position,const BString& customName)
+{
+    std::stringstream coordinate;
+    coordinate << std::setprecision(std::numeric_limits<float>::max_digits10);
+
+    BString name(customName);
+    name.convert(BSTRType_ANSI);
+
+    ColumnValues values;
+    values["id"]			= boost::lexical_cast<std::string>(id);
+    values["parent_id"]		= boost::lexical_cast<std::string>(parentId);
+    values["planet_id"]		= boost::lexical_cast<std::string>(planetId);
+    values["customName"]	= name.getAnsi();
+
+    coordinate << position.x;
+    values["x"] = coordinate.str();
+    coordinate.str(std::string());
+    coordinate << position.y;
+    values["y"] = coordinate.str();
+    coordinate.str(std::string());
+    coordinate << position.z;
+    values["z"] = coordinate.str();
+
+    return _copyPrototype(key,values);
+}
+
+//=============================================================================
+
+Item* ItemFactory::_copyPrototype(const std::string& key,const ColumnValues& values)
+{
+    PrototypeMap::iterator it = mPrototypes.find(key);
+
+    if(it == mPrototypes.end())
+        return NULL;
+
+    const ItemPrototype& prototype = *(it->second);
+
+    _insertPrototypeRows("items",prototype.mItem,values);
+
+    ColumnValues rowId;
+    rowId["item_id"] = values.find("id")->second;
+    _insertPrototypeRows("item_attributes",prototype.mItemAttributes,rowId);
+
+    rowId.clear();
+    rowId["id"] = values.find("id")->second;
+    _insertPrototypeRows("item_customization",prototype.mItemCustomization,rowId);
+
+    return _createFromPrototype(prototype,values);
+}
+
+//=============================================================================
+//
+// runs the prototype's load results through the regular item setup
+//
+
+Item* ItemFactory::_createFromPrototype(const ItemPrototype& prototype,const ColumnValues& values)
+{
+    std::vector<std::string> mainData(prototype.mMainData);
+
+    for(uint32 i = 0; i < sizeof(kPrototypeColumns) / sizeof(kPrototypeColumns[0]); ++i)
+    {
+        ColumnValues::const_iterator it = values.find(kPrototypeColumns[i].mColumn);
+
+        if(it != values.end())
+            mainData[kPrototypeColumns[i].mCell] = it->second;
+    }
+
+    DatabaseMemoryTable mainTable(static_cast<uint32>(mainData.size()),mainData);
+    DatabaseMemoryTable attributeTable(prototype.mAttributeColumns,prototype.mAttributes);
+
+    DatabaseResult* result = mPrototypeReader->executeTable(mainTable.getTable());
+    Item* item = _createItem(result);
+    mDatabase->destroyResult(result);
+
+    result = mPrototypeReader->executeTable(attributeTable.getTable());
+    _buildAttributeMap(item,result);
+    mDatabase->destroyResult(result);
+
+    // the rows of a new item are queued before this, updates it triggers go out after them
+    _postProcessAttributes(item);
+
+    return item;
+}
+
+//=============================================================================
+
+bool ItemFactory::_readPrototypeRows(DatabaseResult* result,PrototypeRows& rows)
+{
+    if(!result || !result->getResultSet())
+        return false;
+
+    std::unique_ptr<sql::ResultSet>& result_set = result->getResultSet();
+    sql::ResultSetMetaData* meta_data = result_set->getMetaData();
+    uint32 columns = meta_data->getColumnCount();
+
+    for(uint32 i = 1; i <= columns; ++i)
+        rows.mColumns.push_back(meta_data->getColumnLabel(i));
+
+    while(result_set->next())
+    {
+        for(uint32 i = 1; i <= columns; ++i)
+        {
+            if(result_set->isNull(i))
+                rows.mValues.push_back("NULL");
+            else
+                rows.mValues.push_back("'" + mDatabase->escapeString(result_set->getString(i)) + "'");
+        }
+    }
+
+    return true;
+}
+
+//=============================================================================
+
+void ItemFactory::_insertPrototypeRows(const char* table,const PrototypeRows& rows,const ColumnValues& values)
+{
+    uint32 columns = static_cast<uint32>(rows.mColumns.size());
+
+    if(!columns || rows.mValues.empty())
+        return;
+
+    std::stringstream prefix;
+    prefix << "INSERT INTO " << mDatabase->galaxy() << "." << table << " (";
+
+    for(uint32 i = 0; i < columns; ++i)
+        prefix << (i ? "," : "") << "`" << rows.mColumns[i] << "`";
+
+    prefix << ") VALUES ";
+
+    for(uint32 first = 0; first < rows.mValues.size(); first += columns)
+    {
+        std::stringstream row;
+        row << "(";
+
+        for(uint32 i = 0; i < columns; ++i)
+        {
+            ColumnValues::const_iterator it = values.find(rows.mColumns[i]);
+
+            row << (i ? "," : "");
+
+            if(it != values.end())
+                row << "'" << mDatabase->escapeString(it->second) << "'";
+            else
+                row << rows.mValues[first + i];
+        }
+
+        row << ")";
+
+        mDatabase->executeAsyncInsertRow(prefix.str(),row.str());
+    }
+}
+
+//=============================================================================
+
 Item* ItemFactory::_createItem(DatabaseResult* result)
 {
     Item*			item;
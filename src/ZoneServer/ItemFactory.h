@@ -28,8 +28,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ANH_ZONESERVER_ITEM_FACTORY_H
 #define ANH_ZONESERVER_ITEM_FACTORY_H
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
 #include "FactoryBase.h"
 #include "ObjectFactoryCallback.h"
+#include "Utils/bstring.h"
 
 #define		gItemFactory	ItemFactory::getSingletonPtr()
 
@@ -37,6 +45,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 class Item;
 class Database;
+class DatabaseImplementationSnapshot;
 class DataBinding;
 class DispatchClient;
 class ObjectFactoryCallback;
@@ -70,10 +79,52 @@ public:
     void					requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
     void					requestContainerContent(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client, uint32 depth = 0);
 
+    // Items created from reserved ids are copies of a prototype, the first item
+    // the database created for the same key. Only use keys whose stored function
+    // creates the same rows every time, a random roll would be copied forever.
+    bool					hasPrototype(const std::string& key) const;
+
+    // loads a freshly created item and keeps its rows as the prototype of key
+    void					requestPrototype(ObjectFactoryCallback* ofCallback,uint64 id,const std::string& key);
+
+    // copies the prototype into a new item and queues the inserts of its rows
+    Item*					createFromPrototype(const std::string& key,uint64 id,uint64 parentId,uint16 planetId,const glm::vec3& position,const BString& customName);
+
 private:
 
+    // rows of one table as sql literals, row by row
+    struct PrototypeRows
+    {
+        std::vector<std::string>	mColumns;
+        std::vector<std::string>	mValues;
+    };
+
+    struct ItemPrototype
+    {
+        ItemPrototype() : mAttributeColumns(0), mComplete(false) {}
+
+        // results of the item load queries, as cell text
+        std::vector<std::string>	mMainData;
+        uint32						mAttributeColumns;
+        std::vector<std::string>	mAttributes;
+
+        PrototypeRows				mItem;
+        PrototypeRows				mItemAttributes;
+        PrototypeRows				mItemCustomization;
+
+        bool						mComplete;
+    };
+
+    typedef std::map<std::string,std::string>						ColumnValues;
+    typedef std::map<std::string,std::shared_ptr<ItemPrototype> >	PrototypeMap;
+
     ItemFactory(Database* database);
 
+    Item*					_copyPrototype(const std::string& key,const ColumnValues& values);
+    Item*					_createFromPrototype(const ItemPrototype& prototype,const ColumnValues& values);
+    bool					_readPrototypeRows(DatabaseResult* result,PrototypeRows& rows);
+    void					_insertPrototypeRows(const char* table,const PrototypeRows& rows,const ColumnValues& values);
+
     void					_postProcessAttributes(Object* object);
 
     void					_setupDatabindings();
@@ -86,6 +137,9 @@ private:
 
     DataBinding*			mItemIdentifierBinding;
     DataBinding*			mItemBinding;
+
+    PrototypeMap			mPrototypes;
+    std::unique_ptr<DatabaseImplementationSnapshot>	mPrototypeReader;
 };
 
 //=============================================================================
@@ -216,7 +216,7 @@ void ManufacturingSchematic::sendAttributes(PlayerObject* playerObject)
 
         gMessageFactory->addString(gWorldManager->getAttributeKey((*mapIt).first));
 
-        value = (*mapIt).second.c_str();
+        value = (*mapIt).second.toString().c_str();
         value.convert(BSTRType_Unicode16);
 
         gMessageFactory->addString(value);
@@ -239,7 +239,7 @@ void ManufacturingSchematic::sendAttributes(PlayerObject* playerObject)
 
         gMessageFactory->addString(gWorldManager->getAttributeKey((*mapIt).first));
 
-        value = (*mapIt).second.c_str();
+        value = (*mapIt).second.toString().c_str();
         value.convert(BSTRType_Unicode16);
 
         gMessageFactory->addString(value);
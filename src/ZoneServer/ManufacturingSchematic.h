@@ -323,14 +323,12 @@ T	ManufacturingSchematic::getPPAttribute(BString key) const
 
     if(it != mPPAttributeMap.end())
     {
-        try
-        {
-            return(boost::lexical_cast<T>((*it).second));
-        }
-        catch(boost::bad_lexical_cast &)
-        {
-            DLOG(INFO) << "ManufacturingSchematic::getPPAttribute: cast failed " << key.getAnsi();
-        }
+        T value;
+
+        if((*it).second.as(value))
+            return(value);
+
+        DLOG(INFO) << "ManufacturingSchematic::getPPAttribute: cast failed " << key.getAnsi();
     }
     else
         DLOG(INFO) << "ManufacturingSchematic::getPPAttribute: could not find " << key.getAnsi();
@@ -342,18 +340,16 @@ T	ManufacturingSchematic::getPPAttribute(BString key) const
 template<typename T>
 T	ManufacturingSchematic::getPPAttribute(uint32 keyCrc) const
 {
-    AttributeMap::iterator it = mPPAttributeMap.find(keyCrc);
+    AttributeMap::const_iterator it = mPPAttributeMap.find(keyCrc);
 
     if(it != mPPAttributeMap.end())
     {
-        try
-        {
-            return(boost::lexical_cast<T>((*it).second));
-        }
-        catch(boost::bad_lexical_cast &)
-        {
-            DLOG(INFO) << "ManufacturingSchematic::getPPAttribute: cast failed " << keyCrc;
-        }
+        T value;
+
+        if((*it).second.as(value))
+            return(value);
+
+        DLOG(INFO) << "ManufacturingSchematic::getPPAttribute: cast failed " << keyCrc;
     }
     else
         DLOG(INFO) << "ManufacturingSchematic::getPPAttribute: could not find " << keyCrc;
@@ -38,6 +38,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "ZoneServer/ContainerManager.h"
 #include "ZoneServer/CraftingTool.h"
+#include "ZoneServer/ObjectHeap.h"
 #include "ZoneServer/PlayerObject.h"
 #include "ZoneServer/WorldManager.h"
 #include "ZoneServer/ZoneOpcodes.h"
@@ -114,6 +115,22 @@ Object::~Object()
     mData.erase(mData.begin(), mData.end());
 }
 
+//=============================================================================
+//
+// the size handed to operator delete is the one of the most derived class,
+// as the destructor is virtual
+//
+
+void* Object::operator new(std::size_t size)
+{
+    return zone::ObjectHeap::Instance().Allocate(size);
+}
+
+void Object::operator delete(void* object, std::size_t size)
+{
+    zone::ObjectHeap::Instance().Deallocate(object, size);
+}
+
 //=============================================================================
 
 glm::vec3 Object::getWorldPosition() const
@@ -292,7 +309,7 @@ void Object::sendAttributes(PlayerObject* playerObject)
         //see if we have to format it properly
 
         gMessageFactory->addString(gWorldManager->getAttributeKey((*mapIt).first));
-        value = (*mapIt).second.c_str();
+        value = (*mapIt).second.toString().c_str();
         if(gWorldManager->getAttributeKey((*mapIt).first).getCrc() == BString("duration").getCrc())
         {
             uint32 time;
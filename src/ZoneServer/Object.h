@@ -48,6 +48,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <glog/logging.h>
 
+#include "AttributeMap.h"
 #include "ObjectController.h"
 #include "RadialMenu.h"
 #include "UICallback.h"
@@ -59,7 +60,6 @@ class Object;
 class PlayerObject;
 class CreatureObject;
 
-typedef std::map<uint32,std::string>	AttributeMap;
 typedef std::shared_ptr<RadialMenu>	RadialMenuPtr;
 // typedef std::vector<uint64>				ObjectIDList;
 typedef std::list<uint64>				ObjectIDList;
@@ -215,6 +215,10 @@ public:
 		
 	virtual ~Object();
 
+	// game objects live in the slabs of the zone::ObjectHeap, every subclass included
+	static void*				operator new(std::size_t size);
+	static void					operator delete(void* object, std::size_t size);
+
     /*! Retrieve the world position of an object. Important for ranged lookups that need
         *  to include objects inside and outside of buildings.
         *
@@ -427,14 +431,12 @@ T	Object::getAttribute(BString key) const
 
     if(it != mAttributeMap.end())
     {
-        try
-        {
-            return(boost::lexical_cast<T>((*it).second));
-        }
-        catch(boost::bad_lexical_cast &)
-        {
-            DLOG(INFO) << "Object::getAttribute: cast failed " << key.getAnsi();
-        }
+        T value;
+
+        if((*it).second.as(value))
+            return(value);
+
+        DLOG(INFO) << "Object::getAttribute: cast failed " << key.getAnsi();
     }
     else
         DLOG(INFO) << "Object::getAttribute: could not find " << key.getAnsi();
@@ -469,18 +471,16 @@ T	Object::getAttribute(BString key) const
 template<typename T>
 T	Object::getAttribute(uint32 keyCrc) const
 {
-    AttributeMap::iterator it = mAttributeMap.find(keyCrc);
+    AttributeMap::const_iterator it = mAttributeMap.find(keyCrc);
 
     if(it != mAttributeMap.end())
     {
-        try
-        {
-            return(boost::lexical_cast<T>((*it).second));
-        }
-        catch(boost::bad_lexical_cast &)
-        {
-            DLOG(INFO) << "Object::getAttribute: cast failed " << keyCrc;
-        }
+        T value;
+
+        if((*it).second.as(value))
+            return(value);
+
+        DLOG(INFO) << "Object::getAttribute: cast failed " << keyCrc;
     }
     else
         DLOG(INFO) << "Object::getAttribute: could not find " << keyCrc;
@@ -498,14 +498,12 @@ T	Object::getInternalAttribute(BString key)
 
     if(it != mInternalAttributeMap.end())
     {
-        try
-        {
-            return(boost::lexical_cast<T>((*it).second));
-        }
-        catch(boost::bad_lexical_cast &)
-        {
-            DLOG(INFO) << "Object::getInternalAttribute: cast failed " << key.getAnsi();
-        }
+        T value;
+
+        if((*it).second.as(value))
+            return(value);
+
+        DLOG(INFO) << "Object::getInternalAttribute: cast failed " << key.getAnsi();
     }
     else
         DLOG(INFO) << "Object::getInternalAttribute: could not find " << key.getAnsi();
@@ -26,24 +26,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 #include "CombatManager.h"
 #include "EVQueueSize.h"
-#include "EVCmdProperty.h"
-#include "EVAbility.h"
-#include "EVState.h"
 #include "EVSurveySample.h"
-#include "EVWeapon.h"
-#include "EVPosture.h"
+#include "Item.h"
 #include "ObjectController.h"
 #include "ObjectControllerOpcodes.h"
 #include "ObjectControllerCommandMap.h"
 #include "objcontrollercommandmessage.h"
 #include "PlayerObject.h"
-#include "PVHam.h"
-#include "PVPosture.h"
-#include "PVState.h"
+#include "ProcessValidator.h"
 #include "StateManager.h"
 #include "WorldConfig.h"
 #include "WorldManager.h"
 #include "SpatialIndexManager.h"
+#include "Weapon.h"
 
 #include "MessageLib/MessageLib.h"
 
@@ -91,6 +86,9 @@ ObjectController::ObjectController()
     , mInUseCommandQueue(false)
     , mRemoveCommandQueue(false)
     , mUpdatingObjects(false)
+    , mLookupCommands(false)
+    , mEnqueueRules(false)
+    , mProcessRules(false)
 {}
 
 //=============================================================================
@@ -115,6 +113,9 @@ ObjectController::ObjectController(Object* object)
     , mInUseCommandQueue(false)
     , mRemoveCommandQueue(false)
     , mUpdatingObjects(false)
+    , mLookupCommands(false)
+    , mEnqueueRules(false)
+    , mProcessRules(false)
 {}
 
 //=============================================================================
@@ -842,33 +843,42 @@ void ObjectController::removeMsgFromCommandQueueBySequence(uint32 sequence)
 
 bool ObjectController::_validateEnqueueCommand(uint32 &reply1,uint32 &reply2,uint64 targetId,uint32 opcode,ObjectControllerCmdProperties*& cmdProperties)
 {
+    if(!mLookupCommands && mEnqueueValidators.empty())
+    {
+        return(true);
+    }
+
+    PlayerObject* player = dynamic_cast<PlayerObject*>(mObject);
+
+    if(this->getCommandQueue()->size() >= COMMAND_QUEUE_MAX_SIZE)
+    {
+        gMessageLib->SendSystemMessage(::common::OutOfBand("client", "too_many_commands_queued_generic"),player);
+        return(false);
+    }
+
+    bool valid = _checkEnqueueRules(reply1,reply2,opcode,cmdProperties);
+
     EnqueueValidators::iterator it = mEnqueueValidators.begin();
 
-    while(it != mEnqueueValidators.end())
+    while(valid && it != mEnqueueValidators.end())
     {
-        PlayerObject* player = dynamic_cast<PlayerObject*>(mObject);
-        if(this->getCommandQueue()->size() >= COMMAND_QUEUE_MAX_SIZE)
-        {
-            gMessageLib->SendSystemMessage(::common::OutOfBand("client", "too_many_commands_queued_generic"),player);
-            return(false);
-        }
-        if(!((*it)->validate(reply1,reply2,targetId,opcode,cmdProperties)))
+        valid = (*it)->validate(reply1,reply2,targetId,opcode,cmdProperties);
+        ++it;
+    }
+
+    if(!valid)
+    {
+        if(opcode == opOCRequestCraftingSession)
         {
-            if(opcode == opOCRequestCraftingSession)
-            {
-                gMessageLib->sendCraftAcknowledge(opCraftCancelResponse,0,0,player);
-            }
-            // we still failed the check but we're not sending anything back
-            // send this generic message
-            if((reply1 == 0 && reply2 == 0))
-                gMessageLib->SendSystemMessage(::common::OutOfBand("error_message", "wrong_state"), player);
-            return(false);
+            gMessageLib->sendCraftAcknowledge(opCraftCancelResponse,0,0,player);
         }
-
-        ++it;
+        // we still failed the check but we're not sending anything back
+        // send this generic message
+        if((reply1 == 0 && reply2 == 0))
+            gMessageLib->SendSystemMessage(::common::OutOfBand("error_message", "wrong_state"), player);
     }
 
-    return(true);
+    return(valid);
 }
 
 //=============================================================================
@@ -879,25 +889,177 @@ bool ObjectController::_validateEnqueueCommand(uint32 &reply1,uint32 &reply2,uin
 
 bool ObjectController::_validateProcessCommand(uint32 &reply1,uint32 &reply2,uint64 targetId,uint32 opcode,ObjectControllerCmdProperties*& cmdProperties)
 {
+    bool valid = _checkProcessRules(reply1,reply2,cmdProperties);
+
     ProcessValidators::iterator it = mProcessValidators.begin();
 
-    while(it != mProcessValidators.end())
+    while(valid && it != mProcessValidators.end())
+    {
+        valid = (*it)->validate(reply1,reply2,targetId,opcode,cmdProperties);
+        ++it;
+    }
+
+    if(!valid)
     {
-        if(!((*it)->validate(reply1,reply2,targetId,opcode,cmdProperties)))
+        PlayerObject* player = dynamic_cast<PlayerObject*>(mObject);
+        if(opcode == opOCRequestCraftingSession)
         {
-            PlayerObject* player = dynamic_cast<PlayerObject*>(mObject);
-            if(opcode == opOCRequestCraftingSession)
+            gMessageLib->sendCraftAcknowledge(opCraftCancelResponse,0,0,player);
+        }
+        // we still failed the check but we're not sending anything back
+        // send this generic message
+        if(! (reply1 && reply2) )
+            gMessageLib->SendSystemMessage(::common::OutOfBand("error_message", "wrong_state"), player);
+    }
+
+    return(valid);
+}
+
+//=============================================================================
+//
+// command lookup, posture, ability, states and weapon
+// in the order the enqueue validators used to run them
+//
+
+bool ObjectController::_checkEnqueueRules(uint32 &reply1,uint32 &reply2,uint32 opcode,ObjectControllerCmdProperties*& cmdProperties)
+{
+    if(!mLookupCommands)
+    {
+        return(true);
+    }
+
+    // get the command properties
+    CmdPropertyMap::iterator it = gObjControllerCmdPropertyMap.find(opcode);
+
+    if(it == gObjControllerCmdPropertyMap.end())
+    {
+        // don't want to parse the annoying error, lets log it though
+        // @todo find root cause of why command isn't in the map
+        DLOG(INFO) <<  "Unknown command found " << opcode;
+        reply1 = 0;
+        reply2 = 1;
+
+        return(false);
+    }
+
+    cmdProperties = (*it).second;
+
+    if(!mEnqueueRules)
+    {
+        return(true);
+    }
+
+    CreatureObject*				creature	= static_cast<CreatureObject*>(mObject);
+    const zone::CommandRules&	rules		= cmdProperties->mRules;
+    uint32						posture		= creature->states.getPosture();
+
+    if(!rules.PostureAllowed(posture))
+    {
+        reply1 = kCannotDoWhileLocomotion;
+        reply2 = getPostureValidator(posture);
+        return(false);
+    }
+
+    if(rules.RequiresAbility() && !creature->verifyAbility(rules.ability_crc()))
+    {
+        reply1 = kInsufficientAbilities;
+        reply2 = 0;
+        return(false);
+    }
+
+    switch(rules.CheckEnqueueStates(creature->states.getAction(),posture))
+    {
+    case zone::CommandRules::kWrongState:
+        reply1 = kCannotDoWhileState;
+        reply2 = getLowestCommonBit(creature->states.getAction(),rules.states());
+        return(false);
+
+    case zone::CommandRules::kWrongLocomotion:
+        reply1 = kCannotDoWhileLocomotion;
+        reply2 = getPostureValidator(creature->states.getLocomotion());
+        return(false);
+
+    default:
+        break;
+    }
+
+    if(rules.RequiresWeapon())
+    {
+        // check our equipped weapon
+        uint32 weaponGroup = WeaponGroup_Unarmed;
+
+        if(Item* weapon = dynamic_cast<Item*>(creature->getEquipManager()->getEquippedObject(CreatureEquipSlot_Hold_Left)))
+        {
+            // could be an instrument
+            if(weapon->getItemFamily() == ItemFamily_Weapon)
+            {
+                weaponGroup = dynamic_cast<Weapon*>(weapon)->getGroup();
+            }
+        }
+
+        if(!rules.WeaponAllowed(weaponGroup))
+        {
+            reply1 = 0;
+            reply2 = 1;
+
+            if(PlayerObject* player = dynamic_cast<PlayerObject*>(creature))
             {
-                gMessageLib->sendCraftAcknowledge(opCraftCancelResponse,0,0,player);
+                gMessageLib->SendSystemMessage(::common::OutOfBand("cbt_spam", "no_attack_wrong_weapon"), player);
             }
-            // we still failed the check but we're not sending anything back
-            // send this generic message
-            if(! (reply1 && reply2) )
-                gMessageLib->SendSystemMessage(::common::OutOfBand("error_message", "wrong_state"), player);
+
             return(false);
         }
+    }
 
-        ++it;
+    return(true);
+}
+
+//=============================================================================
+//
+// posture, ham and states right before a queued command runs
+//
+
+bool ObjectController::_checkProcessRules(uint32 &reply1,uint32 &reply2,ObjectControllerCmdProperties* cmdProperties)
+{
+    if(!mProcessRules || !cmdProperties)
+    {
+        return(true);
+    }
+
+    CreatureObject*				creature	= static_cast<CreatureObject*>(mObject);
+    const zone::CommandRules&	rules		= cmdProperties->mRules;
+    uint32						posture		= creature->states.getPosture();
+
+    if(!rules.PostureAllowed(posture))
+    {
+        reply1 = kCannotDoWhileLocomotion;
+        reply2 = getLowestCommonBit(posture,rules.posture_mask());
+        return(false);
+    }
+
+    // checkMainPools will return true is the 0 <= 0 so if a creature is incapacitated or dead
+    // this will return false, when it should not. IE: if the action costs no HAM.
+    if(rules.HasHamCost() && !creature->getHam()->checkMainPools(rules.health_cost(),rules.action_cost(),rules.mind_cost()))
+    {
+        reply1 = 0;
+        reply2 = 0;
+        return(false);
+    }
+
+    switch(rules.CheckProcessStates(creature->states.getAction(),posture))
+    {
+    case zone::CommandRules::kWrongState:
+        reply1 = kCannotDoWhileState;
+        reply2 = getLowestCommonBit(creature->states.getAction(),rules.states());
+        return(false);
+
+    case zone::CommandRules::kWrongLocomotion:
+        reply1 = kCannotDoWhileLocomotion;
+        reply2 = getPostureValidator(creature->states.getLocomotion());
+        return(false);
+
+    default:
+        break;
     }
 
     return(true);
@@ -908,11 +1070,14 @@ bool ObjectController::_validateProcessCommand(uint32 &reply1,uint32 &reply2,uin
 // setup enqueue cmd validators
 // make sure to keep the order sane
 // http://wiki.swganh.org/index.php/CommandQueueRemove_(00000117)
+// the command lookup and the posture, ability, state and weapon checks are
+// compiled into the command rules, see _checkEnqueueRules
+//
 
 void ObjectController::initEnqueueValidators()
 {
     //mEnqueueValidators.push_back(new EVQueueSize(this));
-    mEnqueueValidators.push_back(new EVCmdProperty(this));
+    mLookupCommands = true;
 
     switch(mObject->getType())
     {
@@ -923,10 +1088,7 @@ void ObjectController::initEnqueueValidators()
     case ObjType_NPC:
     case ObjType_Creature:
     {
-        mEnqueueValidators.push_back(new EVPosture(this));
-        mEnqueueValidators.push_back(new EVAbility(this));
-        mEnqueueValidators.push_back(new EVState(this));
-        mEnqueueValidators.push_back(new EVWeapon(this));
+        mEnqueueRules = true;
         //mEnqueueValidators.push_back(new EVTarget(this));
     }
     break;
@@ -940,6 +1102,8 @@ void ObjectController::initEnqueueValidators()
 //
 // setup process cmd validators
 // make sure to keep the order sane
+// the posture, ham and state checks are compiled into the command rules,
+// see _checkProcessRules
 //
 
 void ObjectController::initProcessValidators()
@@ -950,9 +1114,7 @@ void ObjectController::initProcessValidators()
     case ObjType_NPC:
     case ObjType_Creature:
     {
-        mProcessValidators.push_back(new PVPosture(this));
-        mProcessValidators.push_back(new PVHam(this));
-        mProcessValidators.push_back(new PVState(this));
+        mProcessRules = true;
     }
     break;
 
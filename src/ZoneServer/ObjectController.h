@@ -333,6 +333,10 @@ private:
     bool	_validateEnqueueCommand(uint32 &reply1,uint32 &reply2,uint64 targetId,uint32 opcode,ObjectControllerCmdProperties*& cmdProperties);
     bool	_validateProcessCommand(uint32 &reply1,uint32 &reply2,uint64 targetId,uint32 opcode,ObjectControllerCmdProperties*& cmdProperties);
 
+    // compiled command rules, run ahead of any registered validators
+    bool	_checkEnqueueRules(uint32 &reply1,uint32 &reply2,uint32 opcode,ObjectControllerCmdProperties*& cmdProperties);
+    bool	_checkProcessRules(uint32 &reply1,uint32 &reply2,ObjectControllerCmdProperties* cmdProperties);
+
     // process queues
     bool	_processCommandQueue();
     bool	_processEventQueue();
@@ -818,6 +822,11 @@ private:
 		bool				mInUseCommandQueue;
 		bool				mRemoveCommandQueue;
 		bool				mUpdatingObjects;
+
+		// set up by initEnqueueValidators / initProcessValidators
+		bool				mLookupCommands;
+		bool				mEnqueueRules;
+		bool				mProcessRules;
 };
 
 //=======================================================================
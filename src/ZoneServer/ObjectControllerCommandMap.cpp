@@ -63,13 +63,13 @@ ObjectControllerCommandMap::ObjectControllerCommandMap(Database* database) :
     RegisterCppHooks_();
 
     // load the property map
-    mDatabase->executeSqlAsync(this,NULL,"SELECT commandname,characterability,deny_in_states,healthcost,actioncost,mindcost,"
-                               "animationCrc,addtocombatqueue,defaulttime,scripthook,requiredweapongroup,"
-                               "cbt_spam,trail1,trail2,commandgroup,allowInPosture,"
-                               "health_hit_chance,action_hit_chance,mind_hit_chance,"
-                               "knockdown_chance,dizzy_chance,blind_chance,stun_chance,intimidate_chance,"
-                               "posture_down_chance,extended_range,damage_multiplier,delay_multiplier,deny_in_locomotion"
-                               " FROM command_table");
+    mDatabase->executeStaticSqlAsync(this,NULL,"SELECT commandname,characterability,deny_in_states,healthcost,actioncost,mindcost,"
+                                     "animationCrc,addtocombatqueue,defaulttime,scripthook,requiredweapongroup,"
+                                     "cbt_spam,trail1,trail2,commandgroup,allowInPosture,"
+                                     "health_hit_chance,action_hit_chance,mind_hit_chance,"
+                                     "knockdown_chance,dizzy_chance,blind_chance,stun_chance,intimidate_chance,"
+                                     "posture_down_chance,extended_range,damage_multiplier,delay_multiplier,deny_in_locomotion"
+                                     " FROM command_table");
    
 }
 
@@ -161,6 +161,11 @@ void ObjectControllerCommandMap::handleDatabaseJobComplete(void* ref,DatabaseRes
             commandProperties->mAbilityCrc = commandProperties->mAbilityStr.getCrc();
         }
 
+        commandProperties->mRules.Compile(commandProperties->mPostureMask,commandProperties->mStates,
+                                          commandProperties->mLocomotionMask,commandProperties->mAbilityCrc,
+                                          commandProperties->mRequiredWeaponGroup,commandProperties->mHealthCost,
+                                          commandProperties->mActionCost,commandProperties->mMindCost);
+
         // if set, load up the script
         if(commandProperties->mScriptHook.getLength())
         {
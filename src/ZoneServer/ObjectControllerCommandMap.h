@@ -41,6 +41,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/typedefs.h"
 #include "ScriptEngine/ScriptEventListener.h"
 #include "DatabaseManager/DatabaseCallback.h"
+#include "ZoneServer/CommandRules.h"
 
 
 //======================================================================================================================
@@ -141,6 +142,9 @@ public:
     uint64	mPostureMask;
     uint64	mLocomotionMask;
 
+    // validation rules, compiled from the above when loaded
+    zone::CommandRules	mRules;
+
     // combat
     uint32	mAnimationCrc;
     uint32	mRequiredWeaponGroup;
@@ -28,6 +28,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ObjectFactory.h"
 
 #include <assert.h>
+#include <iomanip>
+#include <limits>
 
 #include <cppconn/resultset.h>
 
@@ -56,17 +58,22 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "FactoryFactory.h"
 #include "IntangibleObject.h"
 #include "IntangibleFactory.h"
+#include "ItemFactory.h"
 #include "ManufacturingSchematic.h"
 #include "ObjectFactoryCallback.h"
+#include "ObjectIdAllocator.h"
 #include "PlayerObject.h"
 #include "Inventory.h"
 #include "PlayerObjectFactory.h"
 #include "RegionFactory.h"
+#include "ResourceContainer.h"
+#include "ResourceContainerFactory.h"
 #include "ResourceManager.h"
 #include "StructureManager.h"
 #include "TangibleFactory.h"
 #include "TravelMapHandler.h"
 #include "WaypointFactory.h"
+#include "WaypointObject.h"
 #include "WorldManager.h"
 
 using std::stringstream;
@@ -78,11 +85,11 @@ ObjectFactory*		ObjectFactory::mSingleton  = NULL;
 
 //======================================================================================================================
 
-ObjectFactory*	ObjectFactory::Init(Database* database)
+ObjectFactory*	ObjectFactory::Init(Database* database, uint32 objectIdBlockSize)
 {
     if(!mInsFlag)
     {
-        mSingleton = new ObjectFactory(database);
+        mSingleton = new ObjectFactory(database, objectIdBlockSize);
         mInsFlag = true;
         return mSingleton;
     }
@@ -92,8 +99,9 @@ ObjectFactory*	ObjectFactory::Init(Database* database)
 
 //=============================================================================
 
-ObjectFactory::ObjectFactory(Database* database) :
+ObjectFactory::ObjectFactory(Database* database, uint32 objectIdBlockSize) :
     mDatabase(database),
+    mIdAllocator(new ObjectIdAllocator(database, objectIdBlockSize)),
     mDbAsyncPool(sizeof(OFAsyncContainer))
 {
     mPlayerObjectFactory	= PlayerObjectFactory::Init(mDatabase);
@@ -121,6 +129,50 @@ ObjectFactory::~ObjectFactory()
 void ObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
 {}
 
+//=============================================================================
+//
+// objects created from reserved ids are handed out on the next tick, like the
+// ones the database created, callers never see them inside their request
+//
+
+void ObjectFactory::process()
+{
+    if(mReadyObjects.empty())
+        return;
+
+    ReadyObjectList readyObjects;
+    readyObjects.swap(mReadyObjects);
+
+    for(ReadyObjectList::iterator it = readyObjects.begin(); it != readyObjects.end(); ++it)
+        (*it).mOfCallback->handleObjectReady((*it).mObject,(*it).mClient);
+}
+
+//=============================================================================
+
+void ObjectFactory::_objectReady(ObjectFactoryCallback* ofCallback,Object* object,DispatchClient* client)
+{
+    ReadyObject readyObject;
+    readyObject.mOfCallback	= ofCallback;
+    readyObject.mObject		= object;
+    readyObject.mClient		= client;
+
+    mReadyObjects.push_back(readyObject);
+}
+
+//=============================================================================
+//
+// loads an item the database created, the first one of a schematic becomes the
+// prototype later items of that schematic are copied from
+//
+
+void ObjectFactory::_requestNewItem(ObjectFactoryCallback* ofCallback,uint64 id,const std::string& prototypeKey)
+{
+    if(mIdAllocator->isEnabled() && !gItemFactory->hasPrototype(prototypeKey))
+        gItemFactory->requestPrototype(ofCallback,id,prototypeKey);
+    else
+        mTangibleFactory->requestObject(ofCallback,id,TanGroup_Item,0,0);
+}
+
 //=============================================================================
 //
 // create a new manufacture schematic with default values
@@ -178,6 +230,23 @@ void ObjectFactory::requestNewClonedItem(ObjectFactoryCallback* ofCallback,uint6
 //
 void ObjectFactory::requestNewDefaultItem(ObjectFactoryCallback* ofCallback, uint32 schemCrc, uint64 parentId, uint16 planetId, const glm::vec3& position, const BString& customName)
 {
+    // Only items of a schematic are copied from a prototype. They are the crafting session's
+    // temporary item, everything it rolls is overwritten by assembly and experimentation, so
+    // the defaults are assumed to be the same for every item of a schematic. Loot and other
+    // default items by type, and clones of a live template, always go through the database.
+    stringstream key;
+    key << "schematic:" << schemCrc;
+    std::string prototypeKey(key.str());
+
+    if(gItemFactory->hasPrototype(prototypeKey))
+    {
+        if(uint64 id = mIdAllocator->takeId())
+        {
+            _objectReady(ofCallback,gItemFactory->createFromPrototype(prototypeKey,id,parentId,planetId,position,customName),NULL);
+            return;
+        }
+    }
+
     BString newBStr(customName);
     newBStr.convert(BSTRType_ANSI);
     std::string name(mDatabase->escapeString(newBStr.getAnsi()));
@@ -198,7 +267,7 @@ void ObjectFactory::requestNewDefaultItem(ObjectFactoryCallback* ofCallback, uin
             return;
         }
 
-        mTangibleFactory->requestObject(ofCallback,result_set->getUInt64(1),TanGroup_Item,0, 0);
+        _requestNewItem(ofCallback,result_set->getUInt64(1),prototypeKey);
     });
 }
 
@@ -312,6 +381,21 @@ void ObjectFactory::requestNewTravelTicket(ObjectFactoryCallback* ofCallback,Tic
 //
 void ObjectFactory::requestNewResourceContainer(ObjectFactoryCallback* ofCallback,uint64 resourceId,uint64 parentId,uint16 planetId,uint32 amount)
 {
+    if(uint64 id = mIdAllocator->takeId())
+    {
+        stringstream prefix;
+        prefix << "INSERT INTO " << mDatabase->galaxy() << ".resource_containers"
+               << " (id,parent_id,resource_id,oX,oY,oZ,oW,x,y,z,planet_id,amount) VALUES ";
+
+        stringstream row;
+        row << "(" << id << "," << parentId << "," << resourceId << ",0,0,0,1,0,0,0,"
+            << planetId << "," << amount << ")";
+        mDatabase->executeAsyncInsertRow(prefix.str(),row.str());
+
+        _objectReady(ofCallback,gResourceContainerFactory->createResourceContainer(id,resourceId,parentId,amount),NULL);
+        return;
+    }
+
     stringstream query_stream;
     query_stream << "SELECT "<<mDatabase->galaxy() << ".sf_ResourceContainerCreate("
                  << resourceId << "," << parentId << ","
@@ -627,6 +711,25 @@ void ObjectFactory::requestNewWaypoint(ObjectFactoryCallback* ofCallback,BString
     BString newBStr(name);
     newBStr.convert(BSTRType_ANSI);
     std::string strName(mDatabase->escapeString(newBStr.getAnsi()));
+
+    if(uint64 id = mIdAllocator->takeId())
+    {
+        WaypointObject* waypoint = gWaypointFactory->createWaypoint(id,ownerId,newBStr,coords,planetId,wpType);
+
+        stringstream prefix;
+        prefix << "INSERT INTO " << mDatabase->galaxy() << ".waypoints"
+               << " (waypoint_id,owner_id,x,y,z,name,planet_id,active,type) VALUES ";
+
+        stringstream row;
+        row << std::setprecision(std::numeric_limits<float>::max_digits10);
+        row << "(" << id << "," << ownerId << "," << coords.x << "," << coords.y << "," << coords.z << ",'"
+            << strName << "'," << planetId << "," << (int)waypoint->getActive() << "," << (int)wpType << ")";
+        mDatabase->executeAsyncInsertRow(prefix.str(),row.str());
+
+        _objectReady(ofCallback,waypoint,player ? player->getClient() : NULL);
+        return;
+    }
+
     stringstream query_stream;
     query_stream << "SELECT "<<mDatabase->galaxy() << ".sf_WaypointCreate('" << strName << "',"
                  << ownerId << "," << coords.x << "," << coords.y << ","
@@ -34,6 +34,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/bstring.h"
 #include "Utils/typedefs.h"
 
+#include <string>
+#include <vector>
+
 #include <glm/glm.hpp>
 #include <boost/pool/pool.hpp>
 
@@ -51,6 +54,7 @@ class FactoryFactory;
 class IntangibleFactory;
 class OFAsyncContainer;
 class Object;
+class ObjectIdAllocator;
 class ObjectFactoryCallback;
 class PlayerObject;
 class PlayerObjectFactory;
@@ -83,7 +87,7 @@ public:
     static ObjectFactory*	getSingletonPtr() {
         return mSingleton;
     }
-    static ObjectFactory*	Init(Database* database);
+    static ObjectFactory*	Init(Database* database, uint32 objectIdBlockSize);
 
     ~ObjectFactory();
 
@@ -91,6 +95,9 @@ public:
 
     void					requestObject(ObjectType objType,uint16 subGroup,uint16 subType,ObjectFactoryCallback* ofCallback,uint64 id,DispatchClient* client = 0);
 
+    // hands objects created from reserved ids to their callbacks
+    void					process();
+
     // create new objects in the database
     void					requestNewClonedItem(ObjectFactoryCallback* ofCallback,uint64 templateId,uint64 parentId);//creates a clone item after a tangible template - out of a crate for exampl
     void					requestNewDefaultItem(ObjectFactoryCallback* ofCallback,uint32 schemCrc,uint64 parentId,uint16 planetId, const glm::vec3& position, const BString& customName = "");
@@ -117,7 +124,19 @@ public:
 
 private:
 
-    ObjectFactory(Database* database);
+    ObjectFactory(Database* database, uint32 objectIdBlockSize);
+
+    struct ReadyObject
+    {
+        ObjectFactoryCallback*	mOfCallback;
+        Object*					mObject;
+        DispatchClient*			mClient;
+    };
+
+    typedef std::vector<ReadyObject>	ReadyObjectList;
+
+    void					_objectReady(ObjectFactoryCallback* ofCallback,Object* object,DispatchClient* client);
+    void					_requestNewItem(ObjectFactoryCallback* ofCallback,uint64 id,const std::string& prototypeKey);
 
     static ObjectFactory*	mSingleton;
     static bool			mInsFlag;
@@ -135,6 +154,9 @@ private:
     FactoryFactory*			mFactoryFactory;
     HouseFactory*			mHouseFactory;
 
+    ObjectIdAllocator*		mIdAllocator;
+    ReadyObjectList			mReadyObjects;
+
     boost::pool<boost::default_user_allocator_malloc_free>	mDbAsyncPool;
 };
 
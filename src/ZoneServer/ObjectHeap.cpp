@@ -0,0 +1,139 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "ZoneServer/ObjectHeap.h"
+
+#include <new>
+
+#include <glog/logging.h>
+
+namespace zone {
+
+namespace {
+
+std::size_t ClassIndex(std::size_t size) {
+    return (size + ObjectHeap::kGranularity - 1) / ObjectHeap::kGranularity;
+}
+
+}  // namespace
+
+ObjectHeap& ObjectHeap::Instance() {
+    // Never destroyed, objects freed during static destruction still need it.
+    static ObjectHeap* heap = new ObjectHeap();
+    return *heap;
+}
+
+ObjectHeap::ObjectHeap()
+    : classes_(kMaxPooledSize / kGranularity + 1)
+{}
+
+void* ObjectHeap::Allocate(std::size_t size) {
+    if (size > kMaxPooledSize) {
+        return ::operator new(size);
+    }
+
+    std::size_t index = ClassIndex(size);
+    SizeClass& size_class = classes_[index];
+
+    boost::mutex::scoped_lock lock(size_class.mutex);
+
+    if (!size_class.slabs) {
+        size_class.slabs.reset(new utils::SlabAllocator(index * kGranularity, 0, kSpareSlabs));
+    }
+
+    return size_class.slabs->Allocate();
+}
+
+void ObjectHeap::Deallocate(void* object, std::size_t size) {
+    if (!object) {
+        return;
+    }
+
+    if (size > kMaxPooledSize) {
+        ::operator delete(object);
+        return;
+    }
+
+    SizeClass& size_class = classes_[ClassIndex(size)];
+
+    boost::mutex::scoped_lock lock(size_class.mutex);
+    size_class.slabs->Deallocate(object);
+}
+
+uint32_t ObjectHeap::Trim(uint32_t spare_slabs) {
+    uint32_t released = 0;
+
+    for (SizeClass& size_class : classes_) {
+        boost::mutex::scoped_lock lock(size_class.mutex);
+
+        if (size_class.slabs) {
+            released += size_class.slabs->ReleaseEmptySlabs(spare_slabs);
+        }
+    }
+
+    return released;
+}
+
+std::vector<ObjectHeap::ClassStats> ObjectHeap::Stats() {
+    std::vector<ClassStats> stats;
+
+    for (std::size_t index = 0; index < classes_.size(); ++index) {
+        SizeClass& size_class = classes_[index];
+
+        boost::mutex::scoped_lock lock(size_class.mutex);
+
+        if (size_class.slabs) {
+            ClassStats class_stats;
+            class_stats.object_size = index * kGranularity;
+            class_stats.slabs = size_class.slabs->stats();
+
+            stats.push_back(class_stats);
+        }
+    }
+
+    return stats;
+}
+
+void ObjectHeap::LogStats() {
+    std::vector<ClassStats> stats = Stats();
+
+    for (auto& class_stats : stats) {
+        if (!class_stats.slabs.live_blocks) {
+            continue;
+        }
+
+        uint64_t capacity = static_cast<uint64_t>(class_stats.slabs.slabs) * class_stats.slabs.blocks_per_slab;
+
+        LOG(INFO) << "ObjectHeap: " << class_stats.object_size << " byte objects: "
+                  << class_stats.slabs.live_blocks << "/" << capacity << " in use in "
+                  << class_stats.slabs.slabs << " slabs, peak " << class_stats.slabs.peak_blocks
+                  << ", " << class_stats.slabs.allocations << " allocated";
+    }
+}
+
+}  // namespace zone
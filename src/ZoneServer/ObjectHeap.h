@@ -0,0 +1,106 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef SRC_ZONESERVER_OBJECTHEAP_H_
+#define SRC_ZONESERVER_OBJECTHEAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "Utils/SlabAllocator.h"
+
+namespace zone {
+
+/**
+ * \brief Slab backed storage for every game object of the zone.
+ *
+ * Object routes its operator new and delete here. Objects are grouped into
+ * size classes 16 bytes apart, each class draws from its own SlabAllocator, so
+ * the npcs of a spawn region and the loot they drop are packed together
+ * instead of fragmenting the C heap between long lived buildings and players.
+ * Objects larger than kMaxPooledSize go to the regular heap.
+ *
+ * A class holds on to up to kSpareSlabs empty slabs while objects come and go,
+ * so a burst of deaths and respawns does not bounce slabs through malloc. Trim
+ * gives back the empty slabs once a despawn wave is done, the statistics show
+ * how full every class is.
+ */
+class ObjectHeap : private boost::noncopyable {
+public:
+    static const std::size_t kGranularity = 16;
+    static const std::size_t kMaxPooledSize = 4096;
+    static const uint32_t kSpareSlabs = 4;
+
+    struct ClassStats {
+        std::size_t object_size;
+        utils::SlabAllocator::Stats slabs;
+    };
+
+public:
+    /** The heap of this zone process, it lives until the process exits. */
+    static ObjectHeap& Instance();
+
+    ObjectHeap();
+
+    /** \returns Storage for an object of the given size. */
+    void* Allocate(std::size_t size);
+
+    /** Returns the storage of an object, size has to match the allocation. */
+    void Deallocate(void* object, std::size_t size);
+
+    /**
+     * Frees the empty slabs of every size class.
+     *
+     * \param spare_slabs The number of empty slabs every class holds on to.
+     * \returns The number of slabs freed.
+     */
+    uint32_t Trim(uint32_t spare_slabs = 0);
+
+    /** \returns The statistics of the size classes that were ever used. */
+    std::vector<ClassStats> Stats();
+
+    /** Logs the occupancy of every size class with live objects. */
+    void LogStats();
+
+private:
+    struct SizeClass {
+        boost::mutex mutex;
+        std::unique_ptr<utils::SlabAllocator> slabs;
+    };
+
+    std::vector<SizeClass> classes_;
+};
+
+}  // namespace zone
+
+#endif  // SRC_ZONESERVER_OBJECTHEAP_H_
@@ -0,0 +1,134 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "ObjectIdAllocator.h"
+
+#include <cstddef>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#undef ERROR
+#endif
+#include <glog/logging.h>
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DataBinding.h"
+
+//=============================================================================
+
+ObjectIdAllocator::ObjectIdAllocator(Database* database, uint32 blockSize) :
+    mDatabase(database),
+    mBlockSize(blockSize),
+    mLowWater(blockSize / 4),
+    mAvailable(0),
+    mRequestPending(false)
+{
+    mBlockBinding = mDatabase->createDataBinding(1);
+    mBlockBinding->addField(DFT_uint64,offsetof(ReservedBlock,mFirstId),8,0);
+
+    if(mBlockSize)
+        _requestBlock();
+}
+
+//=============================================================================
+
+ObjectIdAllocator::~ObjectIdAllocator()
+{
+    mDatabase->destroyDataBinding(mBlockBinding);
+}
+
+//=============================================================================
+
+uint64 ObjectIdAllocator::takeId()
+{
+    if(!mAvailable)
+    {
+        _requestBlock();
+        return 0;
+    }
+
+    IdRange& range = mRanges.front();
+    uint64 id = range.first;
+
+    ++range.first;
+    if(--range.second == 0)
+        mRanges.pop_front();
+
+    if(--mAvailable <= mLowWater)
+        _requestBlock();
+
+    return id;
+}
+
+//=============================================================================
+//
+// sf_ReserveObjectIds moves the galaxy wide id counter past count ids and
+// returns the first one, the block belongs to this process from then on
+//
+
+void ObjectIdAllocator::_requestBlock()
+{
+    if(!mBlockSize || mRequestPending)
+        return;
+
+    mRequestPending = true;
+
+    std::stringstream query_stream;
+    query_stream << "SELECT " << mDatabase->galaxy() << ".sf_ReserveObjectIds(" << mBlockSize << ")";
+
+    uint32 count = mBlockSize;
+    mDatabase->executeAsyncSql<ReservedBlock>(query_stream.str(), mBlockBinding, [=] (std::vector<ReservedBlock>& rows) {
+        mRequestPending = false;
+
+        if (rows.empty() || !rows[0].mFirstId) {
+            LOG(WARNING) << "Unable to reserve a block of " << count << " object ids";
+            return;
+        }
+
+        _handleBlock(rows[0].mFirstId, count);
+    });
+}
+
+//=============================================================================
+
+void ObjectIdAllocator::_handleBlock(uint64 firstId, uint32 count)
+{
+    // blocks handed out back to back are merged into one range
+    if(!mRanges.empty() && mRanges.back().first + mRanges.back().second == firstId)
+        mRanges.back().second += count;
+    else
+        mRanges.push_back(IdRange(firstId, count));
+
+    mAvailable += count;
+
+    DLOG(INFO) << "Reserved object ids " << firstId << " - " << (firstId + count - 1);
+}
+
+//=============================================================================
+
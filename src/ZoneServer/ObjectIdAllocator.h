@@ -25,25 +25,64 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 ---------------------------------------------------------------------------------------
 */
 
-#ifndef ANH_ZONESERVER_EV_ABILITY_H
-#define ANH_ZONESERVER_EV_ABILITY_H
 
-#include "EnqueueValidator.h"
+#ifndef ANH_ZONESERVER_OBJECTIDALLOCATOR_H
+#define ANH_ZONESERVER_OBJECTIDALLOCATOR_H
 
-class ObjectController;
-class ObjectControllerCmdProperties;
+#include <deque>
+#include <utility>
 
-//=======================================================================
+#include "Utils/typedefs.h"
 
-class EVAbility : public EnqueueValidator
+class Database;
+class DataBinding;
+
+//=============================================================================
+//
+// Hands out object ids from blocks reserved in the galaxy database, so new
+// persistent objects can be created in memory without waiting for the
+// stored function that inserts their row.
+// A new block is requested in the background once the ids left drop below
+// the low water mark. If the allocator runs dry, takeId() returns 0 and the
+// caller falls back to the database create path.
+//
+
+class ObjectIdAllocator
 {
 public:
-    explicit EVAbility(ObjectController* controller);
-    virtual ~EVAbility();
 
-    virtual bool validate(uint32 &reply1, uint32 &reply2, uint64 targetId, uint32 opcode, ObjectControllerCmdProperties*& cmdProperties);
+    ObjectIdAllocator(Database* database, uint32 blockSize);
+    ~ObjectIdAllocator();
+
+    bool			isEnabled() const { return mBlockSize != 0; }
+    uint32			getAvailable() const { return mAvailable; }
+
+    // returns the next reserved id, 0 if none is left
+    uint64			takeId();
+
+private:
+
+    typedef std::pair<uint64,uint32>	IdRange;	// first id, count
+    typedef std::deque<IdRange>			IdRangeList;
+
+    struct ReservedBlock
+    {
+        uint64	mFirstId;
+    };
+
+    void			_requestBlock();
+    void			_handleBlock(uint64 firstId, uint32 count);
+
+    Database*		mDatabase;
+    DataBinding*	mBlockBinding;
+    IdRangeList		mRanges;
+    uint32			mBlockSize;
+    uint32			mLowWater;
+    uint32			mAvailable;
+    bool			mRequestPending;
 };
 
-//=======================================================================
+//=============================================================================
 
 #endif
+
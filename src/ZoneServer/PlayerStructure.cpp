@@ -39,6 +39,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/Transaction.h"
 //=============================================================================
 
 PlayerStructure::PlayerStructure() : TangibleObject()
@@ -48,8 +49,6 @@ PlayerStructure::PlayerStructure() : TangibleObject()
     mWillRedeed		= false;
 
     mState			= 0;
-
-    mHousingAdminList.clear();
 }
 
 //=============================================================================
@@ -294,8 +293,11 @@ void PlayerStructure::handleUIEvent(BString strCharacterCash, BString strHarvest
         bank->credits(bankFunds);
         inventory->setCredits(inventoryFunds);
 
-        gWorldManager->getDatabase()->destroyResult(gWorldManager->getDatabase()->executeSynchSql("UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",gWorldManager->getDatabase()->galaxy(),bank->credits(),bank->getId()));
-        gWorldManager->getDatabase()->destroyResult(gWorldManager->getDatabase()->executeSynchSql("UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",gWorldManager->getDatabase()->galaxy(),inventory->getCredits(),inventory->getId()));
+        Database* database = gWorldManager->getDatabase();
+        Transaction* transaction = database->startTransaction(NULL,NULL);
+        transaction->addQuery("UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",database->galaxy(),bank->credits(),bank->getId());
+        transaction->addQuery("UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",database->galaxy(),inventory->getCredits(),inventory->getId());
+        transaction->execute();
 
         //send the appropriate deltas.
         gMessageLib->sendInventoryCreditsUpdate(player);
@@ -509,14 +511,5 @@ void PlayerStructure::handleUIEvent(uint32 action,int32 element,BString inputStr
 
 bool PlayerStructure::hasAdminRights(uint64 id)
 {
-    ObjectIDList::iterator it = mHousingAdminList.begin();
-
-    while(it != mHousingAdminList.end())
-    {
-        if((*it) == id)
-            return(true);
-
-        ++it;
-    }
-    return false;
+    return mPermissions.isOnPermissionList(StructurePermission_Admin,id,BString());
 }
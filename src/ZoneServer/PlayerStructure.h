@@ -274,15 +274,8 @@ public:
         mStructureHopperList.clear();
     }
 
-    // thats the structures admin list
-    ObjectIDList			getHousingList() {
-        return mHousingAdminList;
-    }
-    void					addHousingAdminEntry(uint64 id) {
-        mHousingAdminList.push_back(id);
-    }
-    void					resetHousingAdminList() {
-        mHousingAdminList.clear();
+    StructurePermissions&	getPermissions() {
+        return mPermissions;
     }
     bool					hasAdminRights(uint64 id);
 
@@ -333,7 +326,7 @@ private:
     timerTodoStruct				mTTS;
     BString						mOName;
 
-    ObjectIDList				mHousingAdminList;
+    StructurePermissions		mPermissions;
     BStringVector				mStructureBanList;
     BStringVector				mStructureEntryList;
     BStringVector				mStructureAdminList;
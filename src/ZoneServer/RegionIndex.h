@@ -0,0 +1,196 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+
+#ifndef SRC_ZONESERVER_REGIONINDEX_H_
+#define SRC_ZONESERVER_REGIONINDEX_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace zone {
+
+/**
+ * \brief The area a region covers on the x/z plane, edges included.
+ */
+struct RegionBounds {
+    RegionBounds()
+        : min_x(0.0f), min_z(0.0f), max_x(0.0f), max_z(0.0f) {}
+
+    RegionBounds(float min_x_, float min_z_, float max_x_, float max_z_)
+        : min_x(min_x_), min_z(min_z_), max_x(max_x_), max_z(max_z_) {}
+
+    /**
+     * The bounds of a region placed at x/z. Regions extend by their height
+     * along x and by their width along z.
+     */
+    static RegionBounds FromExtents(float x, float z, float width, float height) {
+        return RegionBounds(x, z, x + height, z + width);
+    }
+
+    bool Contains(float x, float z) const {
+        return x >= min_x && x <= max_x && z >= min_z && z <= max_z;
+    }
+
+    float min_x;
+    float min_z;
+    float max_x;
+    float max_z;
+};
+
+/**
+ * \brief Finds the regions covering a point without looking at the others.
+ *
+ * The map is cut into square buckets. A region is listed, with a copy of its
+ * bounds, in every bucket it overlaps, so a point query only tests the few
+ * regions sharing the point's bucket and never leaves that bucket's array.
+ * Lookups by id go through a hash of the bounds.
+ *
+ * Points and regions outside of the map are clamped to the edge buckets.
+ */
+class RegionIndex {
+public:
+    /**
+     * \param map_extent The width of the square map, which is centered on 0.
+     * \param bucket_size The edge length of a bucket.
+     */
+    RegionIndex(float map_extent, float bucket_size)
+        : half_extent_(map_extent / 2.0f)
+        , bucket_size_(bucket_size)
+        , buckets_per_side_(static_cast<uint32_t>(map_extent / bucket_size) + 1) {
+        buckets_.resize(buckets_per_side_ * buckets_per_side_);
+    }
+
+    /**
+     * Adds a region, a region already indexed under the id is replaced.
+     */
+    void Insert(uint64_t id, const RegionBounds& bounds) {
+        Remove(id);
+
+        regions_[id] = bounds;
+
+        Entry entry = { id, bounds };
+        ForEachBucket_(bounds, [&entry] (std::vector<Entry>& bucket) {
+            bucket.push_back(entry);
+        });
+    }
+
+    /**
+     * \return Returns false if no region is indexed under the id.
+     */
+    bool Remove(uint64_t id) {
+        auto it = regions_.find(id);
+        if (it == regions_.end()) {
+            return false;
+        }
+
+        ForEachBucket_(it->second, [id] (std::vector<Entry>& bucket) {
+            auto entry = std::find_if(bucket.begin(), bucket.end(), [id] (const Entry& e) {
+                return e.id == id;
+            });
+
+            if (entry != bucket.end()) {
+                *entry = bucket.back();
+                bucket.pop_back();
+            }
+        });
+
+        regions_.erase(it);
+        return true;
+    }
+
+    /**
+     * \return Returns true if the region is indexed and covers the point.
+     */
+    bool Contains(uint64_t id, float x, float z) const {
+        auto it = regions_.find(id);
+        return it != regions_.end() && it->second.Contains(x, z);
+    }
+
+    /**
+     * Calls visitor(id) for every region covering the point. The visitor must
+     * not add or remove regions.
+     */
+    template<typename Visitor>
+    void Query(float x, float z, Visitor visitor) const {
+        const std::vector<Entry>& bucket = buckets_[BucketIndex_(BucketCoord_(x), BucketCoord_(z))];
+
+        for (auto it = bucket.begin(), end = bucket.end(); it != end; ++it) {
+            if (it->bounds.Contains(x, z)) {
+                visitor(it->id);
+            }
+        }
+    }
+
+    size_t size() const { return regions_.size(); }
+
+private:
+    struct Entry {
+        uint64_t id;
+        RegionBounds bounds;
+    };
+
+    uint32_t BucketCoord_(float value) const {
+        float offset = (value + half_extent_) / bucket_size_;
+
+        if (offset <= 0.0f) {
+            return 0;
+        }
+
+        return std::min(static_cast<uint32_t>(offset), buckets_per_side_ - 1);
+    }
+
+    uint32_t BucketIndex_(uint32_t column, uint32_t row) const {
+        return row * buckets_per_side_ + column;
+    }
+
+    template<typename Function>
+    void ForEachBucket_(const RegionBounds& bounds, Function function) {
+        uint32_t max_row = BucketCoord_(bounds.max_z);
+        uint32_t max_column = BucketCoord_(bounds.max_x);
+
+        for (uint32_t row = BucketCoord_(bounds.min_z); row <= max_row; ++row) {
+            for (uint32_t column = BucketCoord_(bounds.min_x); column <= max_column; ++column) {
+                function(buckets_[BucketIndex_(column, row)]);
+            }
+        }
+    }
+
+    float half_extent_;
+    float bucket_size_;
+    uint32_t buckets_per_side_;
+
+    std::vector<std::vector<Entry>> buckets_;
+    std::unordered_map<uint64_t, RegionBounds> regions_;
+};
+
+}  // namespace zone
+
+#endif  // SRC_ZONESERVER_REGIONINDEX_H_
@@ -132,6 +132,35 @@ void ResourceContainerFactory::requestObject(ObjectFactoryCallback* ofCallback,u
     
 }
 
+//=============================================================================
+
+ResourceContainer* ResourceContainerFactory::createResourceContainer(uint64 id,uint64 resourceId,uint64 parentId,uint32 amount)
+{
+    ResourceContainer*	resourceContainer = new ResourceContainer();
+
+    resourceContainer->setId(id);
+    resourceContainer->setParentId(parentId);
+    resourceContainer->mResourceId	= resourceId;
+    resourceContainer->mAmount		= amount;
+
+    Resource* resource = gResourceManager->getResourceById(resourceId);
+
+    if(resource != nullptr)
+    {
+        resourceContainer->setResource(resource);
+        resourceContainer->setModelString((resource->getType())->getContainerModel().getAnsi());
+    } else {
+    	LOG(WARNING) << "Resource not found [" << resourceId << "]";
+    }
+
+    resourceContainer->mMaxCondition = 100;
+
+    // a new container has no attribute rows to load
+    resourceContainer->setLoadState(LoadState_Loaded);
+
+    return resourceContainer;
+}
+
 //=============================================================================>>
 
 ResourceContainer* ResourceContainerFactory::_createResourceContainer(DatabaseResult* result)
@@ -64,6 +64,9 @@ public:
     void			handleDatabaseJobComplete(void* ref,DatabaseResult* result);
     void			requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
 
+    // builds a container for an id whose row is still to be written
+    ResourceContainer*	createResourceContainer(uint64 id,uint64 resourceId,uint64 parentId,uint32 amount);
+
 private:
 
     ResourceContainerFactory(Database* database);
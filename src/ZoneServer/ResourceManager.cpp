@@ -32,6 +32,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #endif
 #include <glog/logging.h>
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
 #include "CurrentResource.h"
 #include "ResourceCategory.h"
 #include "ResourceType.h"
@@ -46,11 +49,13 @@ ResourceManager*	ResourceManager::mSingleton = NULL;
 
 //======================================================================================================================
 
-ResourceManager::ResourceManager(Database* database,uint32 zoneId, bool writeResourceMaps, std::string zoneName) :
+ResourceManager::ResourceManager(Database* database,uint32 zoneId, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName) :
     mDatabase(database),
     mZoneId(zoneId),
 	mZoneName(zoneName),
 	mWriteResourceMaps(writeResourceMaps),
+    mResourceMapThreads(resourceMapThreads),
+    mResourceMapCache(resourceMapCache, zoneName),
     mDBAsyncPool(sizeof(RMAsyncContainer))
 {
     // init our tree with a root
@@ -69,18 +74,18 @@ ResourceManager::ResourceManager(Database* database,uint32 zoneId, bool writeRes
     _setupDatabindings();
 
     // load resource types
-    mDatabase->executeSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) RMAsyncContainer(RMQuery_ResourceTypes),
-                               "SELECT id,category_id,namefile_name,type_name,type_swg,tang,bazaar_catID,type FROM %s.resource_template ORDER BY id",mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) RMAsyncContainer(RMQuery_ResourceTypes),
+                                     "SELECT id,category_id,namefile_name,type_name,type_swg,tang,bazaar_catID,type FROM %s.resource_template ORDER BY id",mDatabase->galaxy());
  
 }
 
 //======================================================================================================================
 
-ResourceManager* ResourceManager::Init(Database* database,uint32 zoneId, bool writeResourceMaps, std::string zoneName)
+ResourceManager* ResourceManager::Init(Database* database,uint32 zoneId, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName)
 {
     if(mInsFlag == false)
     {
-        mSingleton = new ResourceManager(database,zoneId, writeResourceMaps, zoneName);
+        mSingleton = new ResourceManager(database,zoneId, writeResourceMaps, resourceMapThreads, resourceMapCache, zoneName);
         mInsFlag = true;
         return mSingleton;
     }
@@ -223,7 +228,7 @@ void ResourceManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result
         }
 
         // query categories
-        mDatabase->executeSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) RMAsyncContainer(RMQuery_Categories),"SELECT * FROM %s.resource_categories ORDER BY id",mDatabase->galaxy());
+        mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) RMAsyncContainer(RMQuery_Categories),"SELECT * FROM %s.resource_categories ORDER BY id",mDatabase->galaxy());
     }
     break;
 
@@ -293,7 +298,8 @@ void ResourceManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result
 
     case RMQuery_CurrentResources:
     {
-        CurrentResource* resource;
+        CurrentResource*	resource;
+        CurrentResourceList	resources;
 
         uint64 count = result->getRowCount();
         for(uint64 i = 0; i < count; i++)
@@ -303,12 +309,23 @@ void ResourceManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result
             result->getNextRow(mCurrentResourceBinding,resource);
             resource->mType = getResourceTypeById(resource->mTypeId);
             resource->mCurrent = 1;
-            resource->buildDistributionMap();
+            resources.push_back(resource);
 			mResourceIdMap.insert(std::make_pair(resource->mId,resource));
             mResourceCRCNameMap.insert(std::make_pair(resource->mName.getCrc(),resource));
             (getResourceCategoryById(resource->mType->mCatId))->insertResource(resource);
         }
 
+        _buildDistributionMaps(resources);
+
+        // the cached maps of despawned resources are never read again
+        std::vector<ResourceMapKey> mapKeys;
+        for(CurrentResourceList::iterator it = resources.begin(); it != resources.end(); ++it)
+        {
+            mapKeys.push_back((*it)->_getMapKey());
+        }
+
+        mResourceMapCache.removeSuperseded(mapKeys);
+
         LOG_IF(INFO, count) << "Generated " << count << " resource maps";
 
         // query old and current resources not from this planet
@@ -446,3 +463,46 @@ void ResourceManager::releaseAllPoolsMemory()
 {
     mDBAsyncPool.release_memory();
 }
+
+//======================================================================================================================
+
+void ResourceManager::_buildDistributionMaps(CurrentResourceList& resources)
+{
+    uint32 threadCount = mResourceMapThreads;
+
+    if(!threadCount)
+        threadCount = boost::thread::hardware_concurrency();
+
+    if(threadCount > resources.size())
+        threadCount = static_cast<uint32>(resources.size());
+
+    // every map has its own noise module and destination, so they can be built side by side
+    if(threadCount <= 1)
+    {
+        _buildDistributionMapRange(&resources,0,1);
+        return;
+    }
+
+    boost::thread_group workers;
+
+    for(uint32 i = 0; i < threadCount; i++)
+    {
+        workers.create_thread(boost::bind(&ResourceManager::_buildDistributionMapRange,this,&resources,i,threadCount));
+    }
+
+    workers.join_all();
+}
+
+//======================================================================================================================
+
+void ResourceManager::_buildDistributionMapRange(CurrentResourceList* resources, uint32 first, uint32 step)
+{
+    const ResourceMapCache* cache = mResourceMapCache.isEnabled() ? &mResourceMapCache : NULL;
+
+    for(size_t i = first; i < resources->size(); i += step)
+    {
+        (*resources)[i]->buildDistributionMap(cache);
+    }
+}
+
+//======================================================================================================================
@@ -32,12 +32,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Utils/typedefs.h"
 #include <map>
+#include <vector>
 #include <boost/pool/pool.hpp>
 #include "DatabaseManager/DatabaseCallback.h"
+#include "ZoneServer/ResourceMapCache.h"
 
 
 //======================================================================================================================
 
+class CurrentResource;
 class Database;
 class DatabaseCallback;
 class DatabaseResult;
@@ -63,6 +66,7 @@ typedef std::map<uint32,ResourceCategory*>	ResourceCategoryMap;
 typedef std::map<uint32,ResourceType*>		ResourceTypeMap;
 typedef std::map<uint64,Resource*>			ResourceIdMap;
 typedef std::map<uint32,Resource*>			ResourceCRCNameMap;
+typedef std::vector<CurrentResource*>		CurrentResourceList;
 
 //======================================================================================================================
 
@@ -86,7 +90,7 @@ class ResourceManager : public DatabaseCallback
 public:
 
     ~ResourceManager();
-    static ResourceManager*		Init(Database* database,uint32 zoneId, bool writeResourceMaps, std::string zoneName);
+    static ResourceManager*		Init(Database* database,uint32 zoneId, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName);
     static ResourceManager*		getSingletonPtr() {
         return mSingleton;
     }
@@ -109,11 +113,15 @@ public:
 
 private:
 
-    ResourceManager(Database* database,uint32 zoneId, bool writeResourceMaps, std::string zoneName);
+    ResourceManager(Database* database,uint32 zoneId, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName);
 
     void						_setupDatabindings();
     void						_destroyDatabindings();
 
+    // generates or loads the distribution maps, spread over mResourceMapThreads threads
+    void						_buildDistributionMaps(CurrentResourceList& resources);
+    void						_buildDistributionMapRange(CurrentResourceList* resources, uint32 first, uint32 step);
+
     static bool					mInsFlag;
     static ResourceManager*		mSingleton;
 
@@ -127,6 +135,8 @@ private:
     uint32						mZoneId;
 	std::string					mZoneName;
 	bool						mWriteResourceMaps;
+    uint32						mResourceMapThreads;
+    ResourceMapCache			mResourceMapCache;
 
     boost::pool<boost::default_user_allocator_malloc_free>				mDBAsyncPool;
 
@@ -0,0 +1,341 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "ZoneServer/ResourceMapCache.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/thread.hpp>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+// Fix for issues with glog redefining this constant
+#ifdef _WIN32
+#undef ERROR
+#endif
+
+#include <glog/logging.h>
+
+namespace {
+
+const uint32 kCacheMagic	= 0x50414d52;	// "RMAP"
+const uint32 kCacheVersion	= 2;
+
+// starts every cache file, the values follow directly after it
+// every member is naturally aligned, so there is no padding to end up in the file
+struct ResourceMapHeader
+{
+    uint32	mMagic;
+    uint32	mVersion;
+    uint64	mResourceId;
+    int32	mSeed;
+    uint32	mOctaves;
+    double	mFrequency;
+    double	mPersistence;
+    double	mScale;
+    double	mBias;
+    double	mBoundsX1,mBoundsX2;
+    double	mBoundsY1,mBoundsY2;
+    uint32	mWidth,mHeight;
+};
+
+ResourceMapHeader buildHeader(const ResourceMapKey& key)
+{
+    ResourceMapHeader header;
+    memset(&header, 0, sizeof(header));
+
+    header.mMagic		= kCacheMagic;
+    header.mVersion		= kCacheVersion;
+    header.mResourceId	= key.mResourceId;
+    header.mSeed		= key.mSeed;
+    header.mOctaves		= key.mOctaves;
+    header.mFrequency	= key.mFrequency;
+    header.mPersistence	= key.mPersistence;
+    header.mScale		= key.mScale;
+    header.mBias		= key.mBias;
+    header.mBoundsX1	= key.mBoundsX1;
+    header.mBoundsX2	= key.mBoundsX2;
+    header.mBoundsY1	= key.mBoundsY1;
+    header.mBoundsY2	= key.mBoundsY2;
+    header.mWidth		= key.mWidth;
+    header.mHeight		= key.mHeight;
+
+    return header;
+}
+
+// the rest of a file name after "<zone>_", "<resource id>_<hex hash>.rmap"
+bool isCacheFileSuffix(const std::string& suffix)
+{
+    size_t i = 0;
+
+    if(i == suffix.length() || !isdigit(static_cast<unsigned char>(suffix[i])))
+        return false;
+
+    while(i < suffix.length() && isdigit(static_cast<unsigned char>(suffix[i])))
+        ++i;
+
+    if(i == suffix.length() || suffix[i++] != '_' || i == suffix.length() || !isxdigit(static_cast<unsigned char>(suffix[i])))
+        return false;
+
+    while(i < suffix.length() && isxdigit(static_cast<unsigned char>(suffix[i])))
+        ++i;
+
+    return suffix.compare(i, std::string::npos, ".rmap") == 0;
+}
+
+}
+
+//=============================================================================
+
+ResourceMapCache::ResourceMapCache(const std::string& directory, const std::string& zoneName)
+    : mDirectory(directory)
+    , mZoneName(zoneName)
+{
+    if(mDirectory.empty())
+        return;
+
+#ifdef _WIN32
+    _mkdir(mDirectory.c_str());
+#else
+    mkdir(mDirectory.c_str(), 0755);
+#endif
+}
+
+//=============================================================================
+
+ResourceMapCache::~ResourceMapCache()
+{
+}
+
+//=============================================================================
+
+ResourceMapCache::MappedMap ResourceMapCache::load(const ResourceMapKey& key) const
+{
+    if(!isEnabled())
+        return MappedMap();
+
+    std::string			fileName	= _getFileName(key);
+    ResourceMapHeader	header		= buildHeader(key);
+    size_t				dataSize	= static_cast<size_t>(key.mWidth) * key.mHeight * sizeof(float);
+
+    // file_mapping throws on a missing file, which is the common case on a first boot
+    if(!std::ifstream(fileName.c_str()))
+        return MappedMap();
+
+    try
+    {
+        boost::interprocess::file_mapping file(fileName.c_str(), boost::interprocess::read_only);
+        MappedMap region(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+
+        if(region->get_size() != sizeof(header) + dataSize || memcmp(region->get_address(), &header, sizeof(header)) != 0)
+        {
+            LOG(WARNING) << "ResourceMapCache::load: discarding stale cache file " << fileName;
+            return MappedMap();
+        }
+
+        return region;
+    }
+    catch(boost::interprocess::interprocess_exception& e)
+    {
+        LOG(WARNING) << "ResourceMapCache::load: unable to map " << fileName << " : " << e.what();
+    }
+
+    return MappedMap();
+}
+
+//=============================================================================
+
+bool ResourceMapCache::store(const ResourceMapKey& key, const float* values, int stride) const
+{
+    if(!isEnabled())
+        return false;
+
+    std::string			fileName	= _getFileName(key);
+    ResourceMapHeader	header		= buildHeader(key);
+
+    // write to a private file first and rename it, other zones may be reading the same cache
+    std::ostringstream tempName;
+#ifdef _WIN32
+    tempName << fileName << "." << _getpid() << "." << boost::this_thread::get_id();
+#else
+    tempName << fileName << "." << getpid() << "." << boost::this_thread::get_id();
+#endif
+
+    {
+        std::ofstream file(tempName.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if(!file)
+        {
+            LOG(WARNING) << "ResourceMapCache::store: unable to write " << tempName.str();
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for(uint32 row = 0; row < key.mHeight; ++row)
+        {
+            file.write(reinterpret_cast<const char*>(values + static_cast<size_t>(row) * stride), key.mWidth * sizeof(float));
+        }
+
+        if(!file)
+        {
+            LOG(WARNING) << "ResourceMapCache::store: unable to write " << tempName.str();
+            file.close();
+            std::remove(tempName.str().c_str());
+            return false;
+        }
+    }
+
+    if(std::rename(tempName.str().c_str(), fileName.c_str()) != 0)
+    {
+        // someone else got there first
+        std::remove(tempName.str().c_str());
+    }
+
+    return true;
+}
+
+//=============================================================================
+
+const float* ResourceMapCache::getValues(const boost::interprocess::mapped_region& region)
+{
+    return reinterpret_cast<const float*>(static_cast<const int8*>(region.get_address()) + sizeof(ResourceMapHeader));
+}
+
+//=============================================================================
+
+void ResourceMapCache::removeSuperseded(const std::vector<ResourceMapKey>& current) const
+{
+    if(!isEnabled())
+        return;
+
+    std::set<std::string> keep;
+
+    for(std::vector<ResourceMapKey>::const_iterator it = current.begin(); it != current.end(); ++it)
+    {
+        std::string fileName = _getFileName(*it);
+        keep.insert(fileName.substr(mDirectory.length() + 1));
+    }
+
+    std::vector<std::string> superseded;
+
+#ifdef _WIN32
+    std::string			pattern = mDirectory + "/*.rmap";
+    struct _finddata_t	entry;
+    intptr_t			handle	= _findfirst(pattern.c_str(), &entry);
+
+    if(handle != -1)
+    {
+        do
+        {
+            if(_isOwnFile(entry.name) && !keep.count(entry.name))
+                superseded.push_back(entry.name);
+        }
+        while(_findnext(handle, &entry) == 0);
+
+        _findclose(handle);
+    }
+#else
+    if(DIR* dir = opendir(mDirectory.c_str()))
+    {
+        while(struct dirent* entry = readdir(dir))
+        {
+            if(_isOwnFile(entry->d_name) && !keep.count(entry->d_name))
+                superseded.push_back(entry->d_name);
+        }
+
+        closedir(dir);
+    }
+#endif
+
+    for(std::vector<std::string>::const_iterator it = superseded.begin(); it != superseded.end(); ++it)
+    {
+        std::string fileName = mDirectory + "/" + *it;
+
+        // zones already mapping the file keep their pages until they unmap it
+        if(std::remove(fileName.c_str()) != 0)
+            LOG(WARNING) << "ResourceMapCache::removeSuperseded: unable to delete " << fileName;
+    }
+
+    LOG_IF(INFO, !superseded.empty()) << "Deleted " << superseded.size() << " superseded resource maps of " << mZoneName;
+}
+
+//=============================================================================
+
+bool ResourceMapCache::_isOwnFile(const std::string& name) const
+{
+    // other zones share the directory, their files are left alone
+    return name.length() > mZoneName.length() + 1
+        && name.compare(0, mZoneName.length(), mZoneName) == 0
+        && name[mZoneName.length()] == '_'
+        && isCacheFileSuffix(name.substr(mZoneName.length() + 1));
+}
+
+//=============================================================================
+
+std::string ResourceMapCache::_getFileName(const ResourceMapKey& key) const
+{
+    ResourceMapHeader	header	= buildHeader(key);
+    const uint8*		bytes	= reinterpret_cast<const uint8*>(&header);
+
+    // FNV-1a over the key, collisions are caught by the header check in load()
+    uint64 hash = 14695981039346656037ULL;
+
+    for(size_t i = 0; i < sizeof(header); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    // one file per spawned resource of the zone, a respawn or new noise settings supersede it
+    std::ostringstream name;
+    name << mDirectory << "/" << mZoneName << "_" << key.mResourceId << "_" << std::hex << hash << ".rmap";
+
+    return name.str();
+}
+
+//=============================================================================
+
@@ -0,0 +1,107 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_ZONESERVER_RESOURCEMAPCACHE_H
+#define ANH_ZONESERVER_RESOURCEMAPCACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Utils/typedefs.h"
+
+namespace boost {
+namespace interprocess {
+class mapped_region;
+}
+}
+
+//=============================================================================
+//
+// Everything that influences the output of a resource distribution map,
+// and the spawned resource it belongs to.
+//
+
+struct ResourceMapKey
+{
+    uint64	mResourceId;
+    int32	mSeed;
+    uint32	mOctaves;
+    double	mFrequency;
+    double	mPersistence;
+    double	mScale;
+    double	mBias;
+    double	mBoundsX1,mBoundsX2;
+    double	mBoundsY1,mBoundsY2;
+    uint32	mWidth,mHeight;
+};
+
+//=============================================================================
+//
+// Keeps generated resource distribution maps on disk, one file per zone and
+// spawned resource. Cached maps are memory mapped read only, so a restart does
+// not have to run the noise generator again. An empty directory disables the cache.
+//
+
+class ResourceMapCache
+{
+public:
+
+    typedef std::unique_ptr<boost::interprocess::mapped_region> MappedMap;
+
+    ResourceMapCache(const std::string& directory, const std::string& zoneName);
+    ~ResourceMapCache();
+
+    bool			isEnabled() const { return !mDirectory.empty(); }
+
+    // maps the cached file for key, returns an empty pointer if there is no valid one
+    MappedMap		load(const ResourceMapKey& key) const;
+
+    // writes width * height values, rows are stride values apart
+    bool			store(const ResourceMapKey& key, const float* values, int stride) const;
+
+    // deletes the files of our zone that belong to none of the given keys,
+    // those of despawned resources or of changed noise settings
+    void			removeSuperseded(const std::vector<ResourceMapKey>& current) const;
+
+    // the map values inside a region returned by load()
+    static const float*	getValues(const boost::interprocess::mapped_region& region);
+
+private:
+
+    std::string		_getFileName(const ResourceMapKey& key) const;
+    bool			_isOwnFile(const std::string& name) const;
+
+    std::string		mDirectory;
+    std::string		mZoneName;
+};
+
+//=============================================================================
+
+#endif
+
@@ -59,12 +59,12 @@ SchematicManager::SchematicManager(Database* database)
 {
     // load skillschematicgroups
     //gLogger->log(LogManager::DEBUG,"Started Loading Schematic Groups.");
-    mDatabase->executeSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_SchematicGroups),"SELECT * FROM %s.schematic_groups ORDER BY id",mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_SchematicGroups),"SELECT * FROM %s.schematic_groups ORDER BY id",mDatabase->galaxy());
     
 
     // load experimentation groups
     //gLogger->log(LogManager::DEBUG,"Finished Loading Experimentation Groups.");
-    mDatabase->executeSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_ExperimentationGroups),"SELECT * FROM %s.draft_experiment_groups ORDER BY id",mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_ExperimentationGroups),"SELECT * FROM %s.draft_experiment_groups ORDER BY id",mDatabase->galaxy());
     
 }
 
@@ -150,7 +150,7 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
 
         DLOG(INFO) <<  "Started Loading Schematics";
         asContainer = new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_GroupSchematics);
-        mDatabase->executeSqlAsync(this,asContainer,"SELECT object_string,weightsbatch_id,complexity,datasize,subCategory,craftEnabled,group_id FROM %s.draft_schematics",mDatabase->galaxy());
+        mDatabase->executeStaticSqlAsync(this,asContainer,"SELECT object_string,weightsbatch_id,complexity,datasize,subCategory,craftEnabled,group_id FROM %s.draft_schematics",mDatabase->galaxy());
     }
     break;
 
@@ -221,7 +221,7 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
                 " INNER JOIN %s.schem_crc ON (draft_schematics_slots.schematic_id = schem_crc.crc)"
                 " INNER JOIN %s.draft_schematics ON (schem_crc.object_string = draft_schematics.object_string)",
                 mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
-        mDatabase->executeSqlAsync(this,asContainer,sql);
+        mDatabase->executeStaticSqlAsync(this,asContainer,sql);
         
 
 
@@ -233,7 +233,7 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
                 " INNER JOIN %s.draft_assembly_batches ON (draft_weights.assembly_batch_id = draft_assembly_batches.id)"
                 " ORDER BY draft_weights.id",
                 mDatabase->galaxy(),mDatabase->galaxy());
-        mDatabase->executeSqlAsync(this,asContainer,sql);
+        mDatabase->executeStaticSqlAsync(this,asContainer,sql);
         
 
         DLOG(INFO) << "Started Loading Schematic Experimentation Batches.";
@@ -246,7 +246,7 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
                 " ORDER BY draft_experiment_batches.list_id ",
                 mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
 
-        mDatabase->executeSqlAsync(this,asContainer,sql);
+        mDatabase->executeStaticSqlAsync(this,asContainer,sql);
         
 
         DLOG(INFO) << "Started Loading Schematic Crafting Batches.";
@@ -258,7 +258,7 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
                 " INNER JOIN %s.draft_schematics ON(draft_weights.id = draft_schematics.weightsbatch_id) "
                 " ORDER BY draft_craft_batches.list_id ",
                 mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
-        mDatabase->executeSqlAsync(this,asContainer,sql);
+        mDatabase->executeStaticSqlAsync(this,asContainer,sql);
         
 
         if(!--mGroupLoadCount)
@@ -343,12 +343,12 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
         // query list items
         ScMAsyncContainer* asContainer = new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_SchematicAssemblyWeights);
         
-        mDatabase->executeSqlAsync(this,asContainer,"SELECT datatype,distribution,draft_weights.id,draft_assembly_batches.list_id"
-                                   " FROM %s.draft_assembly_lists"
-                                   " INNER JOIN %s.draft_assembly_batches ON(draft_assembly_batches.list_id = draft_assembly_lists.id)"
-                                   " INNER JOIN %s.draft_weights ON(draft_weights.assembly_batch_id = draft_assembly_batches.id)"
-                                   " ORDER BY draft_weights.id",
-                                   mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
+        mDatabase->executeStaticSqlAsync(this,asContainer,"SELECT datatype,distribution,draft_weights.id,draft_assembly_batches.list_id"
+                                         " FROM %s.draft_assembly_lists"
+                                         " INNER JOIN %s.draft_assembly_batches ON(draft_assembly_batches.list_id = draft_assembly_lists.id)"
+                                         " INNER JOIN %s.draft_weights ON(draft_weights.assembly_batch_id = draft_assembly_batches.id)"
+                                         " ORDER BY draft_weights.id",
+                                         mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
         mDatabase->destroyDataBinding(binding);
         }
     break;
@@ -384,12 +384,12 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
         }
         // query list items
         ScMAsyncContainer* asContainer = new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_SchematicExperimentWeights);
-        mDatabase->executeSqlAsync(this,asContainer,"SELECT datatype,distribution,draft_weights.id,draft_experiment_batches.list_id "
-                                   " FROM %s.draft_experiment_lists "
-                                   " INNER JOIN %s.draft_experiment_batches ON(draft_experiment_batches.list_id = draft_experiment_lists.id)"
-                                   " INNER JOIN %s.draft_weights ON (draft_weights.experiment_batch_id = draft_experiment_batches.id)"
-                                   " ORDER BY draft_weights.id",
-                                   mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
+        mDatabase->executeStaticSqlAsync(this,asContainer,"SELECT datatype,distribution,draft_weights.id,draft_experiment_batches.list_id "
+                                         " FROM %s.draft_experiment_lists "
+                                         " INNER JOIN %s.draft_experiment_batches ON(draft_experiment_batches.list_id = draft_experiment_lists.id)"
+                                         " INNER JOIN %s.draft_weights ON (draft_weights.experiment_batch_id = draft_experiment_batches.id)"
+                                         " ORDER BY draft_weights.id",
+                                         mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
        
         mDatabase->destroyDataBinding(binding);
     }
@@ -426,37 +426,37 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
 
         // query weight distribution
         ScMAsyncContainer* asContainer = new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_SchematicCraftWeights);
-        mDatabase->executeSqlAsync(this,asContainer,"SELECT type,distribution,draft_weights.id,draft_craft_batches.list_id "
-                                   " FROM %s.draft_craft_attribute_weights"
-                                   " INNER JOIN %s.draft_craft_batches ON(draft_craft_attribute_weights.id = draft_craft_batches.list_id)"
-                                   " INNER JOIN %s.draft_weights ON(draft_weights.craft_batch_id = draft_craft_batches.id)"
-                                   " ORDER BY draft_weights.id",
-                                   mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
+        mDatabase->executeStaticSqlAsync(this,asContainer,"SELECT type,distribution,draft_weights.id,draft_craft_batches.list_id "
+                                         " FROM %s.draft_craft_attribute_weights"
+                                         " INNER JOIN %s.draft_craft_batches ON(draft_craft_attribute_weights.id = draft_craft_batches.list_id)"
+                                         " INNER JOIN %s.draft_weights ON(draft_weights.craft_batch_id = draft_craft_batches.id)"
+                                         " ORDER BY draft_weights.id",
+                                         mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
        
 
 
 
         // query attribute links and ranges
         asContainer = new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_SchematicCraftAttributeLinks);
-        mDatabase->executeSqlAsync(this,asContainer,
-                                   "SELECT attributes.name,dcial.item_attribute,dcial.attribute_min,dcial.attribute_max,dcial.attribute_type,draft_craft_batches.id,dcial.list_id "
-                                   " FROM %s.draft_craft_item_attribute_link as dcial"
-                                   " INNER JOIN %s.attributes ON (dcial.item_attribute = attributes.id)"
-                                   " INNER JOIN %s.draft_craft_batches ON(dcial.list_id = draft_craft_batches.list_id)"
-                                   " ORDER BY draft_craft_batches.id",
-                                   mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
+        mDatabase->executeStaticSqlAsync(this,asContainer,
+                                         "SELECT attributes.name,dcial.item_attribute,dcial.attribute_min,dcial.attribute_max,dcial.attribute_type,draft_craft_batches.id,dcial.list_id "
+                                         " FROM %s.draft_craft_item_attribute_link as dcial"
+                                         " INNER JOIN %s.attributes ON (dcial.item_attribute = attributes.id)"
+                                         " INNER JOIN %s.draft_craft_batches ON(dcial.list_id = draft_craft_batches.list_id)"
+                                         " ORDER BY draft_craft_batches.id",
+                                         mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
         
 
         // query attribute weighting for component crafting
         asContainer = new(mDBAsyncPool.ordered_malloc()) ScMAsyncContainer(ScMQuery_SchematicCraftAttributeWeights);
         //gLogger->log(LogManager::DEBUG,"Started Loading Schematic Craft Attribute Weights.");
-        mDatabase->executeSqlAsync(this,asContainer,
-                                   "SELECT dsam.Attribute, dsam.AffectedAttribute, dsam.Manipulation, a.name, b.name,draft_schematics.weightsbatch_id "
-                                   " FROM %s.draft_schematic_attribute_manipulation as dsam"
-                                   " INNER JOIN %s.attributes as a ON (dsam.attribute = a.id)"
-                                   " INNER JOIN %s.attributes as b ON (dsam.affectedattribute = b.id)"
-                                   " INNER JOIN %s.draft_schematics ON(dsam.Draft_Schematic = draft_schematics.weightsbatch_id)",
-                                   mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
+        mDatabase->executeStaticSqlAsync(this,asContainer,
+                                         "SELECT dsam.Attribute, dsam.AffectedAttribute, dsam.Manipulation, a.name, b.name,draft_schematics.weightsbatch_id "
+                                         " FROM %s.draft_schematic_attribute_manipulation as dsam"
+                                         " INNER JOIN %s.attributes as a ON (dsam.attribute = a.id)"
+                                         " INNER JOIN %s.attributes as b ON (dsam.affectedattribute = b.id)"
+                                         " INNER JOIN %s.draft_schematics ON(dsam.Draft_Schematic = draft_schematics.weightsbatch_id)",
+                                         mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
         mDatabase->destroyDataBinding(binding);
        
         //gLogger->log(LogManager::DEBUG,"Finished Loading %u Schematic Crafting Batches out of %u.",num,count);
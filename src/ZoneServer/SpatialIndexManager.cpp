@@ -46,21 +46,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 //======================================================================================================================
 
-bool					SpatialIndexManager::mInsFlag    = false;
-SpatialIndexManager*	SpatialIndexManager::mSingleton  = NULL;
-//======================================================================================================================
-
-
 SpatialIndexManager*	SpatialIndexManager::Init(Database* database)
 {
-    if(!mInsFlag)
+    zone::WorldContext* context = zone::WorldContext::Current();
+
+    if(!context->spatial_index_manager())
     {
-        mSingleton = new SpatialIndexManager();
-        mInsFlag = true;
-        return mSingleton;
+        context->spatial_index_manager(new SpatialIndexManager());
     }
-    else
-        return mSingleton;
+
+    return context->spatial_index_manager();
 }
 
 void SpatialIndexManager::Shutdown()
@@ -91,6 +86,8 @@ bool SpatialIndexManager::_AddObject(Object *newObject)
         return false;
     }
 
+    _syncHotState(newObject);
+
 	if(newObject->getType() == ObjType_Player)	{
 		//enforce proper handling of players!!
 		PlayerObject* player = static_cast<PlayerObject*>(newObject);
@@ -127,6 +124,8 @@ bool SpatialIndexManager::_AddObject(PlayerObject *player)
         return false;
     }
 
+    _syncHotState(player);
+
     //now create it for everyone around and around for it
 
     ObjectListType playerList;
@@ -196,10 +195,35 @@ void SpatialIndexManager::UpdateObject(Object *updateObject)
         }
     }
     
+    _syncHotState(updateObject);
+
     // Make sure to update any regions the object may be entering or leaving.
     getGrid()->updateRegions(updateObject);
 }
 
+//=============================================================================
+//
+// keeps the dense creature rows in step with the grid
+//
+
+void SpatialIndexManager::_syncHotState(Object* object)
+{
+    uint32 type = object->getType();
+
+    if((type == ObjType_Creature) || (type == ObjType_NPC) || (type == ObjType_Player))	{
+        static_cast<CreatureObject*>(object)->syncHotState();
+    }
+}
+
+void SpatialIndexManager::_unbindHotState(Object* object)
+{
+    uint32 type = object->getType();
+
+    if((type == ObjType_Creature) || (type == ObjType_NPC) || (type == ObjType_Player))	{
+        static_cast<CreatureObject*>(object)->unbindHotState();
+    }
+}
+
 
 
 void SpatialIndexManager::RemoveRegion(std::shared_ptr<RegionObject> remove_region)
@@ -225,6 +249,8 @@ void SpatialIndexManager::RemoveObjectFromWorld(Object *removeObject)
 
     DLOG(INFO) << "SpatialIndexManager::RemoveObjectFromWorld:: Object : " << removeObject->getId();
 
+    _unbindHotState(removeObject);
+
     //were in a container - get us out
     if(removeObject->getParentId())	{
         Object* container = gWorldManager->getObjectById(removeObject->getParentId());
@@ -264,6 +290,8 @@ void SpatialIndexManager::RemoveObjectFromWorld(PlayerObject *removePlayer)
 {
     DLOG(INFO) << "SpatialIndexManager::RemoveObjectFromWorld:: Player : " << removePlayer->getId();
 
+    _unbindHotState(removePlayer);
+
     //remove us from the grid
     _RemoveObjectFromGrid(removePlayer);
 
@@ -292,6 +320,8 @@ void SpatialIndexManager::RemoveObjectFromWorld(CreatureObject *removeCreature)
 {
     DLOG(INFO) << "SpatialIndexManager::RemoveObjectFromWorld:: Creature : " << removeCreature->getId();
 
+    _unbindHotState(removeCreature);
+
     //remove us from the grid
     _RemoveObjectFromGrid(removeCreature);
 
@@ -47,6 +47,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "MessageLib/MessageLib.h"
 
 #include "Object.h"
+#include "WorldContext.h"
 #include "WorldManagerEnums.h"
 #include "Zmap.h"
 
@@ -78,7 +79,7 @@ class SpatialIndexManager : public DatabaseCallback, public TimerCallback
 {
 	public:
 
-		static SpatialIndexManager*	getSingletonPtr() { return mSingleton; }
+		static SpatialIndexManager*	getSingletonPtr() { return zone::WorldContext::Current()->spatial_index_manager(); }
 		static SpatialIndexManager*	Init(Database* database);
 		
 		void					Shutdown();
@@ -157,6 +158,10 @@ class SpatialIndexManager : public DatabaseCallback, public TimerCallback
 		bool					_AddObject(Object* newObject);
 		bool					_AddObject(PlayerObject *newObject);
 
+		//mirrors position and grid bucket of creatures into the hot state store
+		void					_syncHotState(Object* object);
+		void					_unbindHotState(Object* object);
+
 		//Update functions for spawn and despawn
 		void					_UpdateBackCells(Object* updateObject,uint32);
 		void					_UpdateFrontCells(Object* updateObject, uint32);
@@ -167,9 +172,6 @@ class SpatialIndexManager : public DatabaseCallback, public TimerCallback
 		
 		
 
-		static SpatialIndexManager*		mSingleton;
-		static bool						mInsFlag;
-
 		
 		
 		Database*						mDatabase;
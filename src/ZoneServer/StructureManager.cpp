@@ -175,11 +175,34 @@ void StructureManager::updateKownPlayerPermissions(PlayerStructure* structure)
 	}
 }
 
+//=======================================================================================================================
+//reads all permission lists of a structure into memory
+//=======================================================================================================================
+void StructureManager::loadPermissionLists(PlayerStructure* structure)
+{
+    StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(Structure_Query_LoadPermissions, 0);
+    asyncContainer->mStructureId = structure->getId();
+
+    mDatabase->executeSqlAsync(this,asyncContainer,"SELECT sad.PlayerID, sad.AdminType, c.firstname FROM %s.structure_admin_data sad INNER JOIN %s.characters c ON (c.id = sad.PlayerID) WHERE sad.StructureID = %"PRIu64";",mDatabase->galaxy(),mDatabase->galaxy(),structure->getId());
+}
+
 //=======================================================================================================================
 //checks for a name on a permission list
 //=======================================================================================================================
 void StructureManager::checkNameOnPermissionList(uint64 structureId, uint64 playerId, BString name, BString list, StructureAsyncCommand command)
 {
+    // once the structures lists are in memory we answer right away
+    // the return values are the same sf_CheckPermissionList gives
+    PlayerStructure*		structure = dynamic_cast<PlayerStructure*>(gWorldManager->getObjectById(structureId));
+    StructurePermissionList	permissionList;
+
+    if(structure && structure->getPermissions().getPermissionsLoaded() && StructurePermissions::getPermissionList(list,permissionList))
+    {
+        uint32 returnValue = structure->getPermissions().checkPermission(structure->getOwner(),permissionList,playerId,name);
+
+        _processPermissionCheck(dynamic_cast<PlayerObject*>(gWorldManager->getObjectById(playerId)),command,returnValue);
+        return;
+    }
 
     StructureManagerAsyncContainer* asyncContainer;
 
@@ -225,6 +248,7 @@ void StructureManager::removeNamefromPermissionList(uint64 structureId, uint64 p
 
     asyncContainer->mStructureId = structureId;
     asyncContainer->mPlayerId = playerId;
+    asyncContainer->mList = list;
     sprintf(asyncContainer->name,"%s",name.getAnsi());
 
     // 0 is sucess
@@ -251,6 +275,7 @@ void StructureManager::addNametoPermissionList(uint64 structureId, uint64 player
 
     asyncContainer->mStructureId = structureId;
     asyncContainer->mPlayerId = playerId;
+    asyncContainer->mList = list;
     sprintf(asyncContainer->name,"%s",name.getAnsi());
 
     mDatabase->executeSqlAsync(this,asyncContainer,"SELECT %s.sf_AddPermissionList(%"PRIu64",'%s','%s')",mDatabase->galaxy(),structureId,playerName,list.getAnsi());
@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "DatabaseManager/DatabaseCallback.h"
 #include "ObjectFactoryCallback.h"
+#include "StructurePermissions.h"
 #include "TangibleEnums.h"
 #include "WorldManager.h"
 #include "Utils/Scheduler.h"
@@ -89,7 +90,7 @@ enum Structure_QueryType
     Structure_UpdateAttributes					=	20,
     Structure_Query_Entry_Permission_Data		=	21,
     Structure_Query_Ban_Permission_Data			=	22,
-    Structure_Query_UpdateAdminPermission		=	23,
+    Structure_Query_LoadPermissions				=	23,
 
     Structure_Query_NoBuildRegionData			=	24
 
@@ -250,6 +251,8 @@ public:
     PlayerObject*				builder;
     StructureAsyncCommand		command;
 
+    BString						mList;
+
 };
 
 class Type_QueryContainer
@@ -304,6 +307,9 @@ public:
 
     void					updateKownPlayerPermissions(PlayerStructure* structure);
 
+    // (re)reads the structures permission lists into memory
+    void					loadPermissionLists(PlayerStructure* structure);
+
     //=========================================================
 
     StructureDeedLink*		getDeedData(uint32 type);	//returns the data associated with a certain deed
@@ -407,10 +413,11 @@ private:
     void				_HandleStructureTransferLotsRecipient(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
     void				_HandleQueryLoadDeedData(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
     void				_HandleRemovePermission(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
-    void				_HandleUpdateAdminPermission(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
+    void				_HandleLoadPermissions(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
     void				_HandleAddPermission(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
     void				_HandleNonPersistantLoadStructureItem(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
     void				_HandleCheckPermission(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
+    void				_processPermissionCheck(PlayerObject* player, StructureAsyncCommand command, uint32 returnValue);
     void				_HandleUpdateAttributes(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result);
 
     void				_HandleNoBuildRegionData(StructureManagerAsyncContainer* asyncContainer, DatabaseResult* result);
@@ -552,14 +552,17 @@ void StructureManager::_HandleRemovePermission(StructureManagerAsyncContainer* a
         name.convert(BSTRType_Unicode16);
         gMessageLib->SendSystemMessage(::common::OutOfBand("player_structure", "player_removed", L"", L"", name.getUnicode16()), player);
 
-        if(HouseObject*	house = dynamic_cast<HouseObject*>(gWorldManager->getObjectById(asynContainer->mStructureId)))
+        //update the in memory lists right away, permission checks are done on them
+        StructurePermissionList permissionList;
+        PlayerStructure* structure = dynamic_cast<PlayerStructure*>(gWorldManager->getObjectById(asynContainer->mStructureId));
+        if(structure && StructurePermissions::getPermissionList(asynContainer->mList,permissionList))
         {
-            updateKownPlayerPermissions(house);
-            StructureManagerAsyncContainer* asContainer = new StructureManagerAsyncContainer(Structure_Query_UpdateAdminPermission,NULL);
-            asContainer->mStructureId = asynContainer->mStructureId;
+            structure->getPermissions().removePermission(permissionList,BString(asynContainer->name));
+        }
 
-            gWorldManager->getDatabase()->executeSqlAsync(this,asContainer,"SELECT PlayerID FROM %s.structure_admin_data WHERE StructureID = %"PRIu64" AND AdminType like 'ADMIN';",mDatabase->galaxy(),asContainer->mStructureId);
-            
+        if(HouseObject*	house = dynamic_cast<HouseObject*>(structure))
+        {
+            updateKownPlayerPermissions(house);
         }
     }
 
@@ -600,36 +603,45 @@ void StructureManager::_HandleRemovePermission(StructureManagerAsyncContainer* a
 
 //==================================================================================================
 //
-// after adding a name to the admin list we read it in again (as ID though)
-// so dropping / picking up items in cells works
+// reads the permission lists of a structure into memory, when the structure gets loaded
+// and after a name was added so we learn the characters id
+// permission checks and dropping / picking up items in cells work on these lists
 
-void StructureManager::_HandleUpdateAdminPermission(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result)
+void StructureManager::_HandleLoadPermissions(StructureManagerAsyncContainer* asynContainer,DatabaseResult* result)
 {
-    HouseObject*	house = dynamic_cast<HouseObject*>(gWorldManager->getObjectById(asynContainer->mStructureId));
+    // the structure may have been packed up or deleted while the query was in flight
+    PlayerStructure* structure = dynamic_cast<PlayerStructure*>(gWorldManager->getObjectById(asynContainer->mStructureId));
 
-    struct adminStruct
+    if(!structure)
     {
-        uint64 playerID;
-    };
+        DLOG(INFO) << "StructureManager::_HandleLoadPermissions structure " << asynContainer->mStructureId << " is gone";
+        return;
+    }
 
-    adminStruct adminData;
+    Type_QueryContainer permission;
 
-    DataBinding*	adminBinding = mDatabase->createDataBinding(1);
-    adminBinding->addField(DFT_uint64,offsetof(adminStruct,playerID),8,0);
+    DataBinding*	binding = mDatabase->createDataBinding(3);
+    binding->addField(DFT_uint64,offsetof(Type_QueryContainer,mId),8,0);
+    binding->addField(DFT_bstring,offsetof(Type_QueryContainer,mString),64,1);
+    binding->addField(DFT_bstring,offsetof(Type_QueryContainer,mValue),64,2);
 
     uint64 count = result->getRowCount();
-    house->resetHousingAdminList();
+    structure->getPermissions().resetPermissions();
 
-    for(uint32 j = 0; j < count; j++)
+    for(uint64 j = 0; j < count; j++)
     {
-        result->getNextRow(adminBinding,&adminData);
-        house->addHousingAdminEntry(adminData.playerID);
+        result->getNextRow(binding,&permission);
 
-        //now that we added it to the list we need to update the players delta
+        StructurePermissionList permissionList;
+        if(StructurePermissions::getPermissionList(permission.mString,permissionList))
+        {
+            structure->getPermissions().addPermission(permissionList,permission.mId,permission.mValue);
+        }
     }
 
-    mDatabase->destroyDataBinding(adminBinding);
+    structure->getPermissions().setPermissionsLoaded(true);
 
+    mDatabase->destroyDataBinding(binding);
 }
 
 //==================================================================================================
@@ -667,16 +679,20 @@ void StructureManager::_HandleAddPermission(StructureManagerAsyncContainer* asyn
         name.convert(BSTRType_Unicode16);
         gMessageLib->SendSystemMessage(::common::OutOfBand("player_structure", "player_added", L"", L"", name.getUnicode16()), player);
 
-        //now read in the (admin) list again if its a playerHouse
-        //we need to keep them in memory to handle drop/pickup in cells
-        if(HouseObject*	house = dynamic_cast<HouseObject*>(gWorldManager->getObjectById(asynContainer->mStructureId)))
+        //add the name to the in memory list right away, the checks are done on it
+        //then read the lists in again to learn the characters id
+        //we need the ids to handle drop/pickup in cells
+        StructurePermissionList permissionList;
+        PlayerStructure* structure = dynamic_cast<PlayerStructure*>(gWorldManager->getObjectById(asynContainer->mStructureId));
+        if(structure && StructurePermissions::getPermissionList(asynContainer->mList,permissionList))
         {
-            updateKownPlayerPermissions(house);
-            StructureManagerAsyncContainer* asContainer = new StructureManagerAsyncContainer(Structure_Query_UpdateAdminPermission,NULL);
-            asContainer->mStructureId = asynContainer->mStructureId;
+            structure->getPermissions().addPermission(permissionList,0,BString(asynContainer->name));
+            loadPermissionLists(structure);
+        }
 
-            gWorldManager->getDatabase()->executeSqlAsync(this,asContainer,"SELECT PlayerID FROM %s.structure_admin_data WHERE StructureID = %"PRIu64" AND AdminType like 'ADMIN';",mDatabase->galaxy(),asContainer->mStructureId);
-            
+        if(HouseObject*	house = dynamic_cast<HouseObject*>(structure))
+        {
+            updateKownPlayerPermissions(house);
         }
     }
 
@@ -786,6 +802,23 @@ void StructureManager::_HandleCheckPermission(StructureManagerAsyncContainer* as
         return;
     }
     result->getNextRow(binding,&returnValue);
+
+    _processPermissionCheck(player,asynContainer->command,returnValue);
+
+    mDatabase->destroyDataBinding(binding);
+}
+
+//==================================================================================================
+//
+// acts on the outcome of a permission check, either from the db or the in memory lists
+
+void StructureManager::_processPermissionCheck(PlayerObject* player, StructureAsyncCommand command, uint32 returnValue)
+{
+    if(!player)
+    {
+        return;
+    }
+
     // 0 is on List
     // 1 name doesnt exist
     // 2 name not on list
@@ -795,38 +828,28 @@ void StructureManager::_HandleCheckPermission(StructureManagerAsyncContainer* as
     {
         // call processing handler
         // 3 means structure Owner
-        processVerification(asynContainer->command,(returnValue == 3));
-
-    }
-
-    if(returnValue == 1)
-    {
-        BString name;
-        name = asynContainer->name;
-        name.convert(BSTRType_ANSI);
+        processVerification(command,(returnValue == 3));
 
     }
 
     if(returnValue == 2)
     {
-        if(asynContainer->command.Command == Structure_Command_CellEnter )
+        if(command.Command == Structure_Command_CellEnter )
         {
             //the structure is private - we are not on the access list :(
-            if(BuildingObject* building = dynamic_cast<BuildingObject*>(gWorldManager->getObjectById(asynContainer->command.StructureId)))
+            if(BuildingObject* building = dynamic_cast<BuildingObject*>(gWorldManager->getObjectById(command.StructureId)))
                 building->updateCellPermissions(player,false);
         }
-        else if(asynContainer->command.Command == Structure_Command_CellEnterDenial)
+        else if(command.Command == Structure_Command_CellEnterDenial)
         {
             //in case the structure was private before we are now be allowed to enter
             //as we are not banned
-            if(BuildingObject* building = dynamic_cast<BuildingObject*>(gWorldManager->getObjectById(asynContainer->command.StructureId)))
+            if(BuildingObject* building = dynamic_cast<BuildingObject*>(gWorldManager->getObjectById(command.StructureId)))
                 building->updateCellPermissions(player,true);
         }
         else
             gMessageLib->SendSystemMessage(::common::OutOfBand("player_structure", "not_admin"), player);
     }
-
-    mDatabase->destroyDataBinding(binding);
 }
 
 //==================================================================================================
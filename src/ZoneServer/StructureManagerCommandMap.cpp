@@ -59,7 +59,7 @@ StructureManagerCommandMapClass::StructureManagerCommandMapClass()
     mCommandMap.insert(std::make_pair(Structure_StructureTransfer_Lots_Recipient,&StructureManager::_HandleStructureTransferLotsRecipient));
     mCommandMap.insert(std::make_pair(Structure_Query_LoadDeedData,&StructureManager::_HandleQueryLoadDeedData));
     mCommandMap.insert(std::make_pair(Structure_Query_Remove_Permission,&StructureManager::_HandleRemovePermission));
-    mCommandMap.insert(std::make_pair(Structure_Query_UpdateAdminPermission,&StructureManager::_HandleUpdateAdminPermission));
+    mCommandMap.insert(std::make_pair(Structure_Query_LoadPermissions,&StructureManager::_HandleLoadPermissions));
     mCommandMap.insert(std::make_pair(Structure_Query_Add_Permission,&StructureManager::_HandleAddPermission));
     mCommandMap.insert(std::make_pair(Structure_Query_LoadstructureItem,&StructureManager::_HandleNonPersistantLoadStructureItem));
     mCommandMap.insert(std::make_pair(Structure_Query_Check_Permission,&StructureManager::_HandleCheckPermission));
@@ -0,0 +1,150 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#include "StructurePermissions.h"
+
+#include <cstring>
+
+//=============================================================================
+// names on the lists are first names, compared case insensitive like the db does
+//
+
+static uint32 permissionNameCrc(BString name)
+{
+    name.convert(BSTRType_ANSI);
+    name.toLower();
+
+    return name.getCrc();
+}
+
+//=============================================================================
+
+StructurePermissions::StructurePermissions()
+    : mPermissionsLoaded(false)
+{
+}
+
+//=============================================================================
+
+bool StructurePermissions::getPermissionList(BString list, StructurePermissionList& permissionList)
+{
+    list.convert(BSTRType_ANSI);
+    list.toUpper();
+
+    if(strcmp(list.getAnsi(),"ADMIN") == 0)
+        permissionList = StructurePermission_Admin;
+    else if(strcmp(list.getAnsi(),"ENTRY") == 0)
+        permissionList = StructurePermission_Entry;
+    else if(strcmp(list.getAnsi(),"BAN") == 0)
+        permissionList = StructurePermission_Ban;
+    else if(strcmp(list.getAnsi(),"HOPPER") == 0)
+        permissionList = StructurePermission_Hopper;
+    else
+        return false;
+
+    return true;
+}
+
+//=============================================================================
+
+void StructurePermissions::addPermission(StructurePermissionList list, uint64 playerId, BString name)
+{
+    PermissionList& permissions = mLists[list];
+
+    if(name.getLength())
+    {
+        uint32 crc = permissionNameCrc(name);
+
+        // a name added again, by the reload after an add, brings its character id
+        std::map<uint32, uint64>::iterator it = permissions.mNames.find(crc);
+        if(it != permissions.mNames.end() && it->second != playerId)
+            permissions.mIds.erase(it->second);
+
+        permissions.mNames[crc] = playerId;
+    }
+
+    if(playerId)
+        permissions.mIds.insert(playerId);
+}
+
+//=============================================================================
+
+void StructurePermissions::removePermission(StructurePermissionList list, BString name)
+{
+    PermissionList& permissions = mLists[list];
+
+    std::map<uint32, uint64>::iterator it = permissions.mNames.find(permissionNameCrc(name));
+    if(it == permissions.mNames.end())
+        return;
+
+    permissions.mIds.erase(it->second);
+    permissions.mNames.erase(it);
+}
+
+//=============================================================================
+
+void StructurePermissions::resetPermissions()
+{
+    for(uint32 i = 0; i < StructurePermission_Count; i++)
+    {
+        mLists[i].mIds.clear();
+        mLists[i].mNames.clear();
+    }
+}
+
+//=============================================================================
+
+bool StructurePermissions::isOnPermissionList(StructurePermissionList list, uint64 playerId, BString name) const
+{
+    const PermissionList& permissions = mLists[list];
+
+    if(playerId && permissions.mIds.find(playerId) != permissions.mIds.end())
+        return true;
+
+    if(name.getLength() && permissions.mNames.find(permissionNameCrc(name)) != permissions.mNames.end())
+        return true;
+
+    return false;
+}
+
+//=============================================================================
+
+uint32 StructurePermissions::checkPermission(uint64 ownerId, StructurePermissionList list, uint64 playerId, BString name) const
+{
+    if(ownerId == playerId)
+        return 3;
+
+    if(isOnPermissionList(list,playerId,name))
+        return 0;
+
+    // admins may always enter
+    if((list == StructurePermission_Entry) && isOnPermissionList(StructurePermission_Admin,playerId,name))
+        return 0;
+
+    return 2;
+}
@@ -0,0 +1,98 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+#ifndef ANH_ZONESERVER_STRUCTUREPERMISSIONS_H
+#define ANH_ZONESERVER_STRUCTUREPERMISSIONS_H
+
+#include <map>
+#include <set>
+
+#include "Utils/bstring.h"
+#include "Utils/typedefs.h"
+
+//=============================================================================
+// the permission lists of structure_admin_data
+
+enum StructurePermissionList
+{
+    StructurePermission_Admin			=	0,
+    StructurePermission_Entry			=	1,
+    StructurePermission_Ban				=	2,
+    StructurePermission_Hopper			=	3,
+
+    StructurePermission_Count			=	4
+};
+
+//=============================================================================
+//
+// in memory copy of a structures permission lists, loaded with the structure
+// and kept in sync on add / remove so permission checks dont need the db
+//
+
+class StructurePermissions
+{
+public:
+
+    StructurePermissions();
+
+    // maps the list names the db and the commands use to the list
+    static bool				getPermissionList(BString list, StructurePermissionList& permissionList);
+
+    void					addPermission(StructurePermissionList list, uint64 playerId, BString name);
+    void					removePermission(StructurePermissionList list, BString name);
+    void					resetPermissions();
+    bool					isOnPermissionList(StructurePermissionList list, uint64 playerId, BString name) const;
+
+    // answers like sf_CheckPermissionList
+    // 0 name on list
+    // 1 name doesnt exist, never returned as callers check their own name
+    // 2 name not on list
+    // 3 owner
+    uint32					checkPermission(uint64 ownerId, StructurePermissionList list, uint64 playerId, BString name) const;
+
+    bool					getPermissionsLoaded() const {
+        return mPermissionsLoaded;
+    }
+    void					setPermissionsLoaded(bool loaded) {
+        mPermissionsLoaded = loaded;
+    }
+
+private:
+
+    // one permission list, entries are matched by character id or by name
+    struct PermissionList
+    {
+        std::set<uint64>			mIds;
+        std::map<uint32, uint64>	mNames;		// name crc, character id
+    };
+
+    PermissionList				mLists[StructurePermission_Count];
+    bool						mPermissionsLoaded;
+};
+
+#endif
@@ -82,34 +82,34 @@ TravelMapHandler::TravelMapHandler(Database* database, MessageDispatch* dispatch
     mMessageDispatch->RegisterMessageCallback(opTutorialServerStatusReply, std::bind(&TravelMapHandler::_processTutorialTravelList, this, std::placeholders::_1, std::placeholders::_2));
 
     // load our points in world
-    mDatabase->executeSqlAsync(this,new(mDBAsyncPool.malloc()) TravelMapAsyncContainer(TMQuery_PointsInWorld),
-                               "SELECT DISTINCT(terminals.dataStr),terminals.x,terminals.y,terminals.z,terminals.dataInt1,"
-                               "terminals.dataInt2,terminals.planet_id,"
-                               "spawn_shuttle.X,spawn_shuttle.Y,spawn_shuttle.Z"
-                               " FROM %s.terminals"
-                               " INNER JOIN %s.spawn_shuttle ON (terminals.dataInt3 = spawn_shuttle.id)"
-                               " WHERE terminals.terminal_type = 16 AND"
-                               " terminals.parent_id = 0"
-                               " GROUP BY terminals.dataStr",
-                               mDatabase->galaxy(),mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.malloc()) TravelMapAsyncContainer(TMQuery_PointsInWorld),
+                                     "SELECT DISTINCT(terminals.dataStr),terminals.x,terminals.y,terminals.z,terminals.dataInt1,"
+                                     "terminals.dataInt2,terminals.planet_id,"
+                                     "spawn_shuttle.X,spawn_shuttle.Y,spawn_shuttle.Z"
+                                     " FROM %s.terminals"
+                                     " INNER JOIN %s.spawn_shuttle ON (terminals.dataInt3 = spawn_shuttle.id)"
+                                     " WHERE terminals.terminal_type = 16 AND"
+                                     " terminals.parent_id = 0"
+                                     " GROUP BY terminals.dataStr",
+                                     mDatabase->galaxy(),mDatabase->galaxy());
    
 
     // load travel points in cells
-    mDatabase->executeSqlAsync(this,new(mDBAsyncPool.malloc()) TravelMapAsyncContainer(TMQuery_PointsInCells),
-                               "SELECT DISTINCT(terminals.dataStr),terminals.planet_id,terminals.dataInt1,terminals.dataInt2,"
-                               "buildings.x,buildings.y,buildings.z,spawn_shuttle.X,spawn_shuttle.Y,spawn_shuttle.Z"
-                               " FROM %s.terminals"
-                               " INNER JOIN %s.spawn_shuttle ON (terminals.dataInt3 = spawn_shuttle.id)"
-                               " INNER JOIN %s.cells ON (terminals.parent_id = cells.id)"
-                               " INNER JOIN %s.buildings ON (cells.parent_id = buildings.id)"
-                               " WHERE"
-                               " (terminals.terminal_type = 16) AND"
-                               " (terminals.parent_id <> 0)"
-                               " GROUP BY terminals.dataStr",
-                               mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.malloc()) TravelMapAsyncContainer(TMQuery_PointsInCells),
+                                     "SELECT DISTINCT(terminals.dataStr),terminals.planet_id,terminals.dataInt1,terminals.dataInt2,"
+                                     "buildings.x,buildings.y,buildings.z,spawn_shuttle.X,spawn_shuttle.Y,spawn_shuttle.Z"
+                                     " FROM %s.terminals"
+                                     " INNER JOIN %s.spawn_shuttle ON (terminals.dataInt3 = spawn_shuttle.id)"
+                                     " INNER JOIN %s.cells ON (terminals.parent_id = cells.id)"
+                                     " INNER JOIN %s.buildings ON (cells.parent_id = buildings.id)"
+                                     " WHERE"
+                                     " (terminals.terminal_type = 16) AND"
+                                     " (terminals.parent_id <> 0)"
+                                     " GROUP BY terminals.dataStr",
+                                     mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy(),mDatabase->galaxy());
    
     // load planet routes and base prices
-    mDatabase->executeSqlAsync(this,new(mDBAsyncPool.malloc()) TravelMapAsyncContainer(TMQuery_PlanetRoutes),"SELECT * FROM %s.travel_planet_routes",mDatabase->galaxy());
+    mDatabase->executeStaticSqlAsync(this,new(mDBAsyncPool.malloc()) TravelMapAsyncContainer(TMQuery_PlanetRoutes),"SELECT * FROM %s.travel_planet_routes",mDatabase->galaxy());
    
 }
 
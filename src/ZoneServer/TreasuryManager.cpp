@@ -37,6 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/Transaction.h"
 
 
 //======================================================================================================================
@@ -128,10 +129,11 @@ void TreasuryManager::bankDepositAll(PlayerObject* playerObject)
                 // inventory = 0
                 bank->credits(bank->credits() + credits);
                 inventory->setCredits(0);
-                // save to the db
-                mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),bank->credits(),bank->getId()));
-
-                mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),inventory->getCredits(),inventory->getId()));
+                // save to the db, both sides in one transaction
+                Transaction* transaction = mDatabase->startTransaction(NULL,NULL);
+                transaction->addQuery("UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),bank->credits(),bank->getId());
+                transaction->addQuery("UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),inventory->getCredits(),inventory->getId());
+                transaction->execute();
 
 
                 //send the appropriate deltas.
@@ -166,10 +168,11 @@ void TreasuryManager::bankWithdrawAll(PlayerObject* playerObject)
                 inventory->setCredits(inventory->getCredits() + bank->credits());
                 bank->credits(0);
 
-                // save to the db
-                mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),bank->credits(),bank->getId()));
-
-                mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),inventory->getCredits(),inventory->getId()));
+                // save to the db, both sides in one transaction
+                Transaction* transaction = mDatabase->startTransaction(NULL,NULL);
+                transaction->addQuery("UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),bank->credits(),bank->getId());
+                transaction->addQuery("UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),inventory->getCredits(),inventory->getId());
+                transaction->execute();
 
 
                 //send the appropriate deltas.
@@ -326,7 +329,7 @@ void TreasuryManager::bankJoin(PlayerObject* playerObject)
 
 void TreasuryManager::saveAndUpdateInventoryCredits(PlayerObject* playerObject)
 {
-    mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),dynamic_cast<Inventory*>(playerObject->getEquipManager()->getEquippedObject(CreatureEquipSlot_Inventory))->getCredits(),playerObject->getId() + 1));
+    mDatabase->executeSqlAsync(NULL,NULL,"UPDATE %s.inventories SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),dynamic_cast<Inventory*>(playerObject->getEquipManager()->getEquippedObject(CreatureEquipSlot_Inventory))->getCredits(),playerObject->getId() + 1);
 
     gMessageLib->sendInventoryCreditsUpdate(playerObject);
 }
@@ -335,7 +338,7 @@ void TreasuryManager::saveAndUpdateInventoryCredits(PlayerObject* playerObject)
 
 void TreasuryManager::saveAndUpdateBankCredits(PlayerObject* playerObject)
 {
-    mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),dynamic_cast<Bank*>(playerObject->getEquipManager()->getEquippedObject(CreatureEquipSlot_Bank))->credits(), playerObject->getId() + 4));
+    mDatabase->executeSqlAsync(NULL,NULL,"UPDATE %s.banks SET credits=%u WHERE id=%"PRIu64"",mDatabase->galaxy(),dynamic_cast<Bank*>(playerObject->getEquipManager()->getEquippedObject(CreatureEquipSlot_Bank))->credits(), playerObject->getId() + 4);
 
     gMessageLib->sendBankCreditsUpdate(playerObject);
 }
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "WorldConfig.h"
 #include "ObjectFactoryCallback.h"
 #include "WaypointObject.h"
+#include "WorldManager.h"
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
@@ -123,6 +124,25 @@ WaypointObject* WaypointFactory::_createWaypoint(DatabaseResult* result)
 
 //=============================================================================
 
+WaypointObject* WaypointFactory::createWaypoint(uint64 id,uint64 ownerId,const BString& name,const glm::vec3& coords,uint16 planetId,uint8 wpType)
+{
+    WaypointObject*	waypoint = new WaypointObject();
+
+    waypoint->mId		= id;
+    waypoint->mParentId	= ownerId;
+    waypoint->mCoords	= coords;
+    waypoint->mName		= name;
+    waypoint->mModel	= gWorldManager->getPlanetNameById(static_cast<uint8>(planetId));
+    waypoint->mWPType	= wpType;
+
+    waypoint->mName.convert(BSTRType_Unicode16);
+    waypoint->setPlanetCRC(waypoint->getModelString().getCrc());
+
+    return waypoint;
+}
+
+//=============================================================================
+
 void WaypointFactory::_setupDatabindings()
 {
     mWaypointBinding = mDatabase->createDataBinding(9);
@@ -28,6 +28,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ANH_ZONESERVER_WAYPOINT_OBJECT_FACTORY_H
 #define ANH_ZONESERVER_WAYPOINT_OBJECT_FACTORY_H
 
+#include <glm/glm.hpp>
+
 #include "FactoryBase.h"
 
 #define	 gWaypointFactory	WaypointFactory::getSingletonPtr()
@@ -63,6 +65,9 @@ public:
     void			handleDatabaseJobComplete(void* ref,DatabaseResult* result);
     void			requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
 
+    // builds a waypoint for an id whose row is still to be written
+    WaypointObject*	createWaypoint(uint64 id,uint64 ownerId,const BString& name,const glm::vec3& coords,uint16 planetId,uint8 wpType);
+
 private:
 
     WaypointFactory(Database* database);
@@ -25,42 +25,51 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 ---------------------------------------------------------------------------------------
 */
 
-#include "EVCmdProperty.h"
-#include "ObjectController.h"
-#include "ObjectControllerCommandMap.h"
-
-// Fix for issues with glog redefining this constant
-#ifdef ERROR
-#undef ERROR
-#endif
-
-#include <glog/logging.h>
-
-EVCmdProperty::EVCmdProperty(ObjectController* controller)
-    : EnqueueValidator(controller)
-{}
-
-EVCmdProperty::~EVCmdProperty()
-{}
-
-bool EVCmdProperty::validate(uint32 &reply1,uint32 &reply2,uint64 targetId,uint32 opcode,ObjectControllerCmdProperties*& cmdProperties)
-{
-    // get the command properties
-    CmdPropertyMap::iterator it = gObjControllerCmdPropertyMap.find(opcode);
-
-    if(it == gObjControllerCmdPropertyMap.end())
-    {
-        // don't want to parse the annoying error, lets log it though
-        // @todo find root cause of why command isn't in the map
-        DLOG(INFO) <<  "Unknown command found " << opcode;
-        reply1 = 0;
-        reply2 = 1;
-
-        return(false);
+
+
+#include "ZoneServer/WorldContext.h"
+
+#include <boost/thread/tss.hpp>
+
+namespace zone {
+
+namespace {
+
+// the contexts are owned elsewhere, a thread exiting must not delete its own
+void KeepContext(WorldContext*) {}
+
+boost::thread_specific_ptr<WorldContext> current_context(&KeepContext);
+
+}  // namespace
+
+WorldContext WorldContext::default_;
+tbb::atomic<bool> WorldContext::any_bound_;
+
+void WorldContext::Bind(WorldContext* context) {
+    // the default needs no binding, one world zones keep the fast path
+    if (context == &default_) {
+        context = nullptr;
+    }
+
+    if (context) {
+        any_bound_ = true;
     }
 
-    cmdProperties = ((*it).second);
+    current_context.reset(context);
+}
+
+WorldContext* WorldContext::CurrentBound_() {
+    WorldContext* context = current_context.get();
+    return context ? context : &default_;
+}
+
+ScopedWorldContext::ScopedWorldContext(WorldContext* context)
+    : previous_(current_context.get()) {
+    WorldContext::Bind(context);
+}
 
-    return(true);
+ScopedWorldContext::~ScopedWorldContext() {
+    WorldContext::Bind(previous_);
 }
 
+}  // namespace zone
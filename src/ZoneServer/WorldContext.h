@@ -0,0 +1,132 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+
+
+#ifndef SRC_ZONESERVER_WORLDCONTEXT_H_
+#define SRC_ZONESERVER_WORLDCONTEXT_H_
+
+#include <tbb/atomic.h>
+
+class Heightmap;
+class SpatialIndexManager;
+class WorldManager;
+
+namespace zone {
+
+/**
+ * \brief The managers that make up one simulated world.
+ *
+ * gWorldManager, gSpatialIndexManager and gHeightmap resolve through the
+ * context of the calling thread. A thread that was never bound to a context
+ * uses the process default, so a ZoneServer hosting one planet behaves exactly
+ * as it did with the singletons.
+ *
+ * A thread that simulates another world binds that world's context first,
+ * e.g. with a ScopedWorldContext at the top of its loop. Threads the managers
+ * start for themselves bind the context they were created in.
+ *
+ * The context does not own the managers, each manager's Init and shutdown
+ * code still decides their lifetime.
+ */
+class WorldContext {
+public:
+    WorldContext()
+        : world_manager_(nullptr)
+        , spatial_index_manager_(nullptr)
+        , heightmap_(nullptr) {}
+
+    /// The context bound to the calling thread, or the process default.
+    static WorldContext* Current() {
+        // skips the thread local lookup until some thread binds a context
+        return any_bound_ ? CurrentBound_() : &default_;
+    }
+
+    static WorldContext* Default() {
+        return &default_;
+    }
+
+    /// Binds the calling thread to a context, nullptr goes back to the default.
+    static void Bind(WorldContext* context);
+
+    WorldManager* world_manager() const {
+        return world_manager_;
+    }
+
+    void world_manager(WorldManager* world_manager) {
+        world_manager_ = world_manager;
+    }
+
+    SpatialIndexManager* spatial_index_manager() const {
+        return spatial_index_manager_;
+    }
+
+    void spatial_index_manager(SpatialIndexManager* spatial_index_manager) {
+        spatial_index_manager_ = spatial_index_manager;
+    }
+
+    Heightmap* heightmap() const {
+        return heightmap_;
+    }
+
+    void heightmap(Heightmap* heightmap) {
+        heightmap_ = heightmap;
+    }
+
+private:
+    WorldContext(const WorldContext&);
+    WorldContext& operator=(const WorldContext&);
+
+    static WorldContext* CurrentBound_();
+
+    static WorldContext default_;
+    static tbb::atomic<bool> any_bound_;
+
+    WorldManager* world_manager_;
+    SpatialIndexManager* spatial_index_manager_;
+    Heightmap* heightmap_;
+};
+
+/**
+ * \brief Binds the calling thread to a context for the lifetime of the object
+ * and restores the previous binding afterwards.
+ */
+class ScopedWorldContext {
+public:
+    explicit ScopedWorldContext(WorldContext* context);
+    ~ScopedWorldContext();
+
+private:
+    ScopedWorldContext(const ScopedWorldContext&);
+    ScopedWorldContext& operator=(const ScopedWorldContext&);
+
+    WorldContext* previous_;
+};
+
+}  // namespace zone
+
+#endif  // SRC_ZONESERVER_WORLDCONTEXT_H_
@@ -62,6 +62,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ConversationManager.h"
 #include "CraftingSessionFactory.h"
 #include "CraftingTool.h"
+#include "CreatureHotStore.h"
 #include "CreatureSpawnRegion.h"
 #include "FactoryFactory.h"
 #include "FactoryObject.h"
@@ -71,6 +72,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "GroupObject.h"
 #include "HarvesterFactory.h"
 #include "HarvesterObject.h"
+#include "HamRegenerator.h"
 #include "Heightmap.h"
 #include "Inventory.h"
 #include "MissionManager.h"
@@ -78,6 +80,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NpcManager.h"
 #include "NPCObject.h"
 #include "ObjectFactory.h"
+#include "ObjectHeap.h"
 #include "PlayerObject.h"
 #include "PlayerStructure.h"
 #include "ResourceManager.h"
@@ -95,11 +98,8 @@ using std::shared_ptr;
 
 //======================================================================================================================
 
-bool			WorldManager::mInsFlag    = false;
-WorldManager*	WorldManager::mSingleton  = NULL;
-//======================================================================================================================
 
-WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, std::string zoneName)
+WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName)
     : mWM_DB_AsyncPool(sizeof(WMAsyncContainer))
     , mDatabase(database)
     , mZoneServer(zoneServer)
@@ -120,7 +120,7 @@ WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* databa
     // create schedulers
     mSubsystemScheduler		= new Anh_Utils::Scheduler();
     mObjControllerScheduler = new Anh_Utils::Scheduler();
-    mHamRegenScheduler		= new Anh_Utils::Scheduler();
+    mHamRegenerator			= new zone::HamRegenerator();
     mStomachFillingScheduler= new Anh_Utils::Scheduler();
     mPlayerScheduler		= new Anh_Utils::Scheduler();
     mEntertainerScheduler	= new Anh_Utils::Scheduler();
@@ -140,10 +140,10 @@ WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* databa
     //the resourcemanager gets accessed by lowlevel functions to check the IDs we get send by the client
     //it will have to be initialized in the tutorial, too
     if(zoneId != 41) {
-		ResourceManager::Init(database,mZoneId, writeResourceMaps, zoneName);
+		ResourceManager::Init(database,mZoneId, writeResourceMaps, resourceMapThreads, resourceMapCache, zoneName);
     } else {
         //by not assigning a db we force the resourcemanager to not load db data
-        ResourceManager::Init(NULL,mZoneId, writeResourceMaps, zoneName);
+        ResourceManager::Init(NULL,mZoneId, writeResourceMaps, resourceMapThreads, resourceMapCache, zoneName);
     }
     TreasuryManager::Init(database);
     ConversationManager::Init(database);
@@ -179,16 +179,17 @@ WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* databa
 
 //======================================================================================================================
 
-WorldManager*	WorldManager::Init(uint32 zoneId,ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, std::string zoneName)
+WorldManager*	WorldManager::Init(uint32 zoneId,ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName)
 {
-    if(!mInsFlag)
+    // one world manager per world context, the calling thread's context gets it
+    zone::WorldContext* context = zone::WorldContext::Current();
+
+    if(!context->world_manager())
     {
-        mSingleton = new WorldManager(zoneId,zoneServer,database, heightmapResolution, writeResourceMaps, zoneName);
-        mInsFlag = true;
-        return mSingleton;
+        context->world_manager(new WorldManager(zoneId,zoneServer,database, heightmapResolution, writeResourceMaps, resourceMapThreads, resourceMapCache, zoneName));
     }
-    else
-        return mSingleton;
+
+    return context->world_manager();
 }
 
 //======================================================================================================================
@@ -219,7 +220,7 @@ void WorldManager::Shutdown()
     delete(mNpcManagerScheduler);
     delete(mObjControllerScheduler);
     delete(mStomachFillingScheduler);
-    delete(mHamRegenScheduler);
+    delete(mHamRegenerator);
     delete(mMissionScheduler);
     delete(mPlayerScheduler);
     //delete(mImagedesignerScheduler);
@@ -277,14 +278,20 @@ void WorldManager::Shutdown()
 	// shutdown SI
 	gSpatialIndexManager->Shutdown();
 	//delete(mSpatialIndex);
+
+	// hand back what the structures left empty and report what is still alive
+	zone::ObjectHeap::Instance().Trim();
+	zone::ObjectHeap::Instance().LogStats();
 }
 
 //======================================================================================================================
 
 WorldManager::~WorldManager()
 {
-    mInsFlag = false;
-    delete(mSingleton);
+    zone::WorldContext* context = zone::WorldContext::Current();
+
+    if(context->world_manager() == this)
+        context->world_manager(NULL);
 }
 //======================================================================================================================
 
@@ -402,7 +409,7 @@ void WorldManager::Process()
 
 void WorldManager::_processSchedulers()
 {
-    mHamRegenScheduler->process();
+    mHamRegenerator->Process(Anh_Utils::Clock::getSingleton()->getLocalTime());
     mStomachFillingScheduler->process();
     mSubsystemScheduler->process();
     mObjControllerScheduler->process();
@@ -977,7 +984,7 @@ bool WorldManager::checkStomachTask(uint64 id)
 //
 uint64 WorldManager::addCreatureHamToProccess(Ham* ham)
 {
-    return((mHamRegenScheduler->addTask(fastdelegate::MakeDelegate(ham,&Ham::regenerate),1,1000,NULL)));
+    return(mHamRegenerator->Add(ham));
 }
 
 
@@ -988,7 +995,7 @@ uint64 WorldManager::addCreatureHamToProccess(Ham* ham)
 
 void WorldManager::removeCreatureHamToProcess(uint64 taskId)
 {
-    mHamRegenScheduler->removeTask(taskId);
+    mHamRegenerator->Remove(taskId);
 }
 
 
@@ -996,7 +1003,7 @@ void WorldManager::removeCreatureHamToProcess(uint64 taskId)
 
 bool WorldManager::checkTask(uint64 id)
 {
-    return mHamRegenScheduler->checkTask(id);
+    return mHamRegenerator->IsRegenerating(id);
 }
 
 
@@ -1234,10 +1241,20 @@ uint64 WorldManager::addBuffToProcess(Buff* buff)
 //
 //	return true if object are withing range.
 //  Both objects need to be inside the same building or both object outside, to be concidered to be in range.
+//  Two creatures are answered from the hot state store without touching the objects.
 //
 
 bool WorldManager::objectsInRange(uint64 obj1Id, uint64 obj2Id, float range)
 {
+    zone::CreatureHotStore& hotStore = zone::CreatureHotStore::Instance();
+    zone::CreatureHotStore::Handle hot1 = hotStore.Find(obj1Id);
+    zone::CreatureHotStore::Handle hot2 = hotStore.Find(obj2Id);
+
+    if (hot1 && hot2)
+    {
+        return hotStore.InRange(hot1, hot2, range);
+    }
+
     bool inRange = true;
 
     Object* obj1 = dynamic_cast<Object*>(this->getObjectById(obj1Id));
@@ -1285,6 +1302,16 @@ bool WorldManager::objectsInRange(uint64 obj1Id, uint64 obj2Id, float range)
 
 bool WorldManager::objectsInRange(const glm::vec3& obj1Position,  uint64 obj1ParentId, uint64 obj2Id, float range)
 {
+    if (obj1ParentId == 0)
+    {
+        zone::CreatureHotStore& hotStore = zone::CreatureHotStore::Instance();
+
+        if (zone::CreatureHotStore::Handle hot2 = hotStore.Find(obj2Id))
+        {
+            return hotStore.InRangeOutside(obj1Position.x, obj1Position.y, obj1Position.z, hot2, range);
+        }
+    }
+
     bool inRange = true;
 
     // Object* obj1 = dynamic_cast<Object*>(this->getObjectById(obj1Id));
@@ -60,6 +60,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ZoneServer/Weather.h"
 #include "ZoneServer/WorldManagerEnums.h"
 #include "ZoneServer/RegionObject.h"
+#include "ZoneServer/WorldContext.h"
 
 //======================================================================================================================
 
@@ -79,6 +80,7 @@ class ZoneServer;
 class Ham;
 class Buff;
 class MissionObject;
+class QueryChain;
 class Stomach;
 
 //======================================================================================================================
@@ -90,6 +92,11 @@ class Scheduler;
 class VariableTimeScheduler;
 }
 
+namespace zone
+{
+class HamRegenerator;
+}
+
 // pwns all objects
 typedef boost::ptr_unordered_map<uint64,Object>			ObjectMap;
 
@@ -177,9 +184,9 @@ class WorldManager : public ObjectFactoryCallback, public DatabaseCallback, publ
 public:
 
     static WorldManager*	getSingletonPtr() {
-        return mSingleton;
+        return zone::WorldContext::Current()->world_manager();
     }
-    static WorldManager*	Init(uint32 zoneId, ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, std::string zoneName);
+    static WorldManager*	Init(uint32 zoneId, ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName);
     void					Shutdown();
 
     void					Process();
@@ -265,8 +272,8 @@ public:
     // saves a player asyncronously to the database
     void					savePlayer(uint32 accId,bool remove, WMLogOut mLogout, CharacterLoadingContainer* clContainer = NULL);
 
-    // saves a player synched to the database
-    void					savePlayerSync(uint32 accId,bool remove);
+    // appends the queries saving a player to a chain, the save is complete once the chain reaches them
+    void					savePlayerToChain(PlayerObject* playerObject, QueryChain& chain);
 
     // checks if the player save timer is up
     bool					checkSavePlayer(PlayerObject* playerObject);
@@ -441,7 +448,7 @@ public:
     AttributeIDMap				mObjectAttributeIDMap;
 private:
 
-    WorldManager(uint32 zoneId, ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, std::string zoneName);
+    WorldManager(uint32 zoneId, ZoneServer* zoneServer,Database* database, uint16 heightmapResolution, bool writeResourceMaps, uint32 resourceMapThreads, std::string resourceMapCache, std::string zoneName);
 
     // load the global ObjectControllerCommandMap, maps command crcs to ObjController function pointers
     void	_loadObjControllerCommandMap();
@@ -517,9 +524,6 @@ private:
     */
     void storeCharacterAttributes_(PlayerObject* player_object, bool remove, WMLogOut logout_type, CharacterLoadingContainer* clContainer);
 
-    static WorldManager*		mSingleton;
-    static bool					mInsFlag;
-
     boost::pool<boost::default_user_allocator_malloc_free>	mWM_DB_AsyncPool;
 
     AdminRequestHandlers		mAdminRequestHandlers;
@@ -557,7 +561,7 @@ private:
     Database*								mDatabase;
     Anh_Utils::Scheduler*		mEntertainerScheduler;
     Anh_Utils::Scheduler*		mScoutScheduler;
-    Anh_Utils::Scheduler*		mHamRegenScheduler;
+    zone::HamRegenerator*		mHamRegenerator;
     Anh_Utils::Scheduler*		mStomachFillingScheduler;
     Anh_Utils::Scheduler*		mMissionScheduler;
     Anh_Utils::Scheduler*		mNpcManagerScheduler;
@@ -70,11 +70,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NpcManager.h"
 #include "NPCObject.h"
 #include "ObjectFactory.h"
+#include "ObjectHeap.h"
 #include "PlayerStructure.h"
 #include "ResourceManager.h"
 #include "SchematicManager.h"
 #include "Shuttle.h"
 #include "SpawnPoint.h"
+#include "StructureManager.h"
 #include "Terminal.h"
 #include "TicketCollector.h"
 #include "TreasuryManager.h"
@@ -193,6 +195,10 @@ bool WorldManager::addObject(Object* object,bool manual)
 			//create the building in the world
 			gSpatialIndexManager->createInWorld(object);
 
+			//read in the admin, entry, ban and hopper lists, the structure can be looked up by the time they arrive
+			if(PlayerStructure* structure = dynamic_cast<PlayerStructure*>(object))
+				gStructureManager->loadPermissionLists(structure);
+
 		}
 		break;
 
@@ -203,6 +209,10 @@ bool WorldManager::addObject(Object* object,bool manual)
 			
 			//create the building in the world
 			gSpatialIndexManager->createInWorld(object);
+
+			//only player houses have permission lists
+			if(HouseObject* house = dynamic_cast<HouseObject*>(object))
+				gStructureManager->loadPermissionLists(house);
 		}
 		break;
 
@@ -571,6 +581,8 @@ void WorldManager::eraseObject(uint64 key)
 //======================================================================================================================
 bool WorldManager::_handleGeneralObjectTimers(uint64 callTime, void* ref)
 {
+    uint32 despawned = 0;
+
     CreatureObjectDeletionMap::iterator it = mCreatureObjectDeletionMap.begin();
     while (it != mCreatureObjectDeletionMap.end())
     {
@@ -585,6 +597,7 @@ bool WorldManager::_handleGeneralObjectTimers(uint64 callTime, void* ref)
                 NpcManager::Instance()->handleExpiredCreature((*it).first);
                 this->destroyObject(creature);
                 mCreatureObjectDeletionMap.erase(it++);
+                ++despawned;
             }
             else
             {
@@ -598,6 +611,16 @@ bool WorldManager::_handleGeneralObjectTimers(uint64 callTime, void* ref)
         }
     }
 
+    // a despawn wave leaves empty slabs behind, keep one per size class for the respawns
+    if (despawned)
+    {
+        uint32 released = zone::ObjectHeap::Instance().Trim(1);
+        if (released)
+        {
+            DLOG(INFO) << "WorldManager::_handleGeneralObjectTimers: released " << released << " object slabs after " << despawned << " despawns";
+        }
+    }
+
     PlayerObjectReviveMap::iterator reviveIt = mPlayerObjectReviveMap.begin();
     while (reviveIt != mPlayerObjectReviveMap.end())
     {
@@ -27,6 +27,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "WorldManager.h"
 
+#include <iomanip>
+#include <limits>
 #include <sstream>
 
 #include "Utils/Scheduler.h"
@@ -37,6 +39,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/QueryChain.h"
 
 #include "MessageLib/MessageLib.h"
 
@@ -188,47 +191,55 @@ void WorldManager::storeCharacterAttributes_(PlayerObject* player_object, bool r
 }
 //======================================================================================================================
 
-void WorldManager::savePlayerSync(uint32 accId,bool remove)
+void WorldManager::savePlayerToChain(PlayerObject* playerObject, QueryChain& chain)
 {
-    PlayerObject* playerObject = getPlayerByAccId(accId);
     Ham* ham = playerObject->getHam();
 
-    mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.characters SET parent_id=%"PRIu64",oX=%f,oY=%f,oZ=%f,oW=%f,x=%f,y=%f,z=%f,planet_id=%u WHERE id=%"PRIu64"",
-                              mDatabase->galaxy(),playerObject->getParentId()
-                             ,playerObject->mDirection.x,playerObject->mDirection.y,playerObject->mDirection.z,playerObject->mDirection.w
-                             ,playerObject->mPosition.x,playerObject->mPosition.y,playerObject->mPosition.z
-                             ,mZoneId,playerObject->getId()));
-
-
-    mDatabase->destroyResult(mDatabase->executeSynchSql("UPDATE %s.character_attributes SET health_current=%u,action_current=%u,mind_current=%u"
-                             ",health_wounds=%u,strength_wounds=%u,constitution_wounds=%u,action_wounds=%u,quickness_wounds=%u"
-                             ",stamina_wounds=%u,mind_wounds=%u,focus_wounds=%u,willpower_wounds=%u,battlefatigue=%u,posture=%u,moodId=%u,title=\'%s\'"
-                             ",character_flags=%u,states=%"PRIu64",language=%u, group_id=%"PRIu64" WHERE character_id=%"PRIu64"",
-                             mDatabase->galaxy(),ham->mHealth.getCurrentHitPoints() - ham->mHealth.getModifier(), //Llloydyboy Added the -Modifier so that when buffs are reinitialised, it doesn't screw up HAM
-                             ham->mAction.getCurrentHitPoints() - ham->mAction.getModifier(), //Llloydyboy Added the -Modifier so that when buffs are reinitialised, it doesn't screw up HAM
-                             ham->mMind.getCurrentHitPoints() - ham->mMind.getModifier(),	 //Llloydyboy Added the -Modifier so that when buffs are reinitialised, it doesn't screw up HAM
-                             ham->mHealth.getWounds(),
-                             ham->mStrength.getWounds(),
-                             ham->mConstitution.getWounds(),
-                             ham->mAction.getWounds(),
-                             ham->mQuickness.getWounds(),
-                             ham->mStamina.getWounds(),
-                             ham->mMind.getWounds(),
-                             ham->mFocus.getWounds(),
-                             ham->mWillpower.getWounds(),
-                             ham->getBattleFatigue(),
-                             playerObject->states.getPosture(),
-                             playerObject->getMoodId(),
-                             playerObject->getTitle().getAnsi(),
-                             playerObject->getPlayerFlags(),
-                             playerObject->states.getAction(),
-                             playerObject->getLanguage(),
-                             playerObject->getGroupId(),
-                             playerObject->getId()));
-
-    gBuffManager->SaveBuffs(playerObject, GetCurrentGlobalTick());
-    if(remove)
-        destroyObject(playerObject);
+    stringstream position_stream;
+
+    // the stream default of 6 significant digits would round the floats, write them exactly
+    position_stream << std::setprecision(std::numeric_limits<float>::max_digits10);
+
+    position_stream << "UPDATE "<<mDatabase->galaxy()<<".characters SET parent_id=" << playerObject->getParentId() << ", "
+                    << "oX=" << playerObject->mDirection.x << ", "
+                    << "oY=" << playerObject->mDirection.y << ", "
+                    << "oZ=" << playerObject->mDirection.z << ", "
+                    << "oW=" << playerObject->mDirection.w << ", "
+                    << "x=" << playerObject->mPosition.x << ", "
+                    << "y=" << playerObject->mPosition.y << ", "
+                    << "z=" << playerObject->mPosition.z << ", "
+                    << "planet_id=" << mZoneId << " "
+                    << "WHERE id=" << playerObject->getId();
+
+    chain.then(position_stream.str());
+
+    stringstream attribute_stream;
+
+    attribute_stream << "UPDATE "<<mDatabase->galaxy()<<".character_attributes SET health_current=" << (ham->mHealth.getCurrentHitPoints() - ham->mHealth.getModifier()) << ", "
+                     << "action_current=" << (ham->mAction.getCurrentHitPoints() - ham->mAction.getModifier()) << ", "
+                     << "mind_current=" << (ham->mMind.getCurrentHitPoints() - ham->mMind.getModifier()) << ", "
+                     << "health_wounds=" << ham->mHealth.getWounds() << ", "
+                     << "strength_wounds=" << ham->mStrength.getWounds() << ", "
+                     << "constitution_wounds=" << ham->mConstitution.getWounds() << ", "
+                     << "action_wounds=" << ham->mAction.getWounds() << ", "
+                     << "quickness_wounds=" << ham->mQuickness.getWounds() << ", "
+                     << "stamina_wounds=" << ham->mStamina.getWounds() << ", "
+                     << "mind_wounds=" << ham->mMind.getWounds() << ", "
+                     << "focus_wounds=" << ham->mFocus.getWounds() << ", "
+                     << "willpower_wounds=" << ham->mWillpower.getWounds() << ", "
+                     << "battlefatigue=" << ham->getBattleFatigue() << ", "
+                     << "posture=" << playerObject->states.getPosture() << ", "
+                     << "moodId=" << static_cast<uint16_t>(playerObject->getMoodId()) << ", "
+                     << "title='" << mDatabase->escapeString(playerObject->getTitle().getAnsi()) << "', "
+                     << "character_flags=" << playerObject->getPlayerFlags() << ", "
+                     << "states=" << playerObject->states.getAction() << ", "
+                     << "language=" << playerObject->getLanguage() << ", "
+                     << "group_id=" << playerObject->getGroupId() << " "
+                     << "WHERE character_id=" << playerObject->getId();
+
+    chain.then(attribute_stream.str());
+
+    gBuffManager->SaveBuffs(playerObject, GetCurrentGlobalTick(), chain);
 }
 
 //======================================================================================================================
@@ -17,8 +17,13 @@ using std::shared_ptr;
 
 zmap* zmap::ZMAP = NULL;
 
+// Edge length of the region index buckets. Badge and camp regions fit into
+// one or four of them, city and spawn regions span a few dozen.
+static const float REGION_BUCKET_SIZE = 128.0f;
+
 
 zmap::zmap()
+    : mRegionIndex(static_cast<float>(MAPWIDTH), REGION_BUCKET_SIZE)
 {
     mCurrentSubCellID = 0;
 
@@ -57,7 +62,6 @@ zmap::~zmap()
             (*it).second->Creatures.clear();
             (*it).second->Players.clear();
             (*it).second->Objects.clear();
-            (*it).second->SubCells.clear();
 
             delete(	ZMapCells[i]);
             i++;
@@ -69,6 +73,9 @@ zmap::~zmap()
 void zmap::updateRegions(Object* object) {
 	// Check the regions the object is currently in and remove any it's no longer in.
 	Uint64Set& region_set = object->zmapSubCells;
+
+    float x = object->mPosition.x;
+    float z = object->mPosition.z;
     
     auto region_set_end = region_set.end();
     auto region_set_it = region_set.begin();
@@ -81,7 +88,7 @@ void zmap::updateRegions(Object* object) {
             continue;
         }
 
-        if (! isObjectInRegionBoundary_(object, region)) {
+        if (! mRegionIndex.Contains(region->getId(), x, z)) {
             region->onObjectLeave(object);
             region_set.erase(region_set_it++);
             continue;
@@ -90,123 +97,48 @@ void zmap::updateRegions(Object* object) {
         ++region_set_it;
     }
 
-    // Now check for any new regions the object may have entered.
-    auto it = ZMapCells.find(object->getGridBucket());
-    if (it == ZMapCells.end()) {
-        assert(false && "Object has reference to an invalid grid bucket!");
-        return;
-    }
-
-    SharedObjectListType& list = (*it).second->SubCells;
-    for_each(list.begin(), list.end(), [this, &region_set, object] (shared_ptr<Object> list_object) {
-        shared_ptr<RegionObject> region = std::static_pointer_cast<RegionObject>(list_object);
+    // Now check for any new regions the object may have entered. Only the
+    // regions sharing the object's bucket are looked at, the enter handlers
+    // run after the query as they may add or remove regions.
+    std::vector<uint64> entered;
 
-        // If the object is not already in the region and is now within 
-        // the region's bounds, add it.
-        if (region_set.find(region->getId()) == region_set.end() && isObjectInRegionBoundary_(object, region)) {
-            object->zmapSubCells.insert(region->getId());
-            region->onObjectEnter(object);
+    mRegionIndex.Query(x, z, [&region_set, &entered] (uint64_t region_id) {
+        if (region_set.find(region_id) == region_set.end()) {
+            entered.push_back(region_id);
         }
     });
-}
 
-bool zmap::isObjectInRegionBoundary_(Object* object, shared_ptr<RegionObject> region) {
-	float x = object->mPosition.x;
-	float z = object->mPosition.z;
+    for_each(entered.begin(), entered.end(), [this, &region_set, object] (uint64 region_id) {
+        auto region = findRegion(region_id);
 
-	if(((x >= region->mPosition.x) && (x <= (region->mPosition.x + region->getHeight()))) &&
-		((z >= region->mPosition.z) && (z <= (region->mPosition.z + region->getWidth())))) 
-    {
-        return true;
-    }
-    
-    return false;
+        if (region) {
+            region_set.insert(region_id);
+            region->onObjectEnter(object);
+        }
+    });
 }
 
 
 void zmap::addRegion(std::shared_ptr<RegionObject> region) {
-    uint32_t low_x = region->mPosition.x;
-    uint32_t low_z = region->mPosition.z;
-    uint32_t width = region->getWidth();
-    uint32_t height = region->getHeight();
-
-    uint32_t lowerLeft	= _getCellId(low_x,			low_z);
-    uint32_t lowerRight	= _getCellId(low_x+width,	low_z);
-    uint32_t upperLeft	= _getCellId(low_x,			low_z+height);
-    uint32_t upperRight	= _getCellId(low_x+width,	low_z+height);
-
-    int cellCountZ = (upperLeft - lowerLeft)/GRIDWIDTH;
-    int cellCountX = (lowerRight - lowerLeft);
-	assert(cellCountX >= 0);
-	assert(cellCountZ >= 0);
-
-    for (int i=0; i <= cellCountZ; ++i) {
-        for (int j=0; j <= cellCountX; ++j) {
-            auto it = ZMapCells.find((lowerLeft + j + i * GRIDWIDTH));
-            (*it).second->SubCells.push_back(region);
-        }
-    }
-
-	subCells.insert(std::make_pair(region->getId(), region));
-
-    return;
+    mRegionIndex.Insert(region->getId(), zone::RegionBounds::FromExtents(region->mPosition.x, region->mPosition.z,
+                        region->getWidth(), region->getHeight()));
+	mRegions[region->getId()] = region;
 }
 
 std::shared_ptr<RegionObject> zmap::findRegion(uint64_t region_id) {
-    auto it = find_if(subCells.begin(), subCells.end(), [region_id] (const SubCellMap::value_type& map_entry) {
-        return map_entry.second->getId() == region_id;
-    });
+    auto it = mRegions.find(region_id);
 
-    // If we found the region in the cell map return it, otherwise return a nullptr.
-    return (it != subCells.end()) ? (*it).second : nullptr;
+    // If we found the region in the region map return it, otherwise return a nullptr.
+    return (it != mRegions.end()) ? (*it).second : nullptr;
 }
 
 bool zmap::isObjectInRegion(Object* object, uint64 region_id) {
-    auto it = find_if(subCells.begin(), subCells.end(), [this, object, region_id] (const SubCellMap::value_type& map_entry) {
-        return isObjectInRegionBoundary_(object, map_entry.second);
-    });
-
-    // If we found the region in the cell map return it, otherwise return a nullptr.
-    return it != subCells.end();
+    return mRegionIndex.Contains(region_id, object->mPosition.x, object->mPosition.z);
 }
 
 void zmap::RemoveRegion(uint64 regionId) {
-    SubCellMap::iterator it	 = subCells.begin();
-    SubCellMap::iterator end = subCells.end();
-
-    while(it != end)    {
-		if((*it).second->getId() == regionId)        {
-            //get cells
-			uint32 lowerLeft  = _getCellId((*it).second->mPosition.x, (*it).second->mPosition.z);
-			uint32 lowerRight = _getCellId((*it).second->mPosition.x + (*it).second->getWidth(),	(*it).second->mPosition.z);
-			uint32 upperLeft  = _getCellId((*it).second->mPosition.x, (*it).second->mPosition.z + (*it).second->getHeight());
-			uint32 upperRight = _getCellId((*it).second->mPosition.x + (*it).second->getWidth(),	(*it).second->mPosition.z + (*it).second->getHeight());
-
-            unsigned int cellCountZ = (lowerLeft - upperLeft)/GRIDWIDTH;
-            unsigned int cellCountX = (lowerLeft - lowerRight);
-
-            for(unsigned int i=0; i < cellCountZ; i++)	{
-                for(unsigned int j=0; j < cellCountX; j++)	{
-                    std::map<uint32, ObjectStruct*>::iterator it = ZMapCells.find((lowerLeft + j + i * GRIDWIDTH));
-
-                    SharedObjectListType			cellList	= (*it).second->SubCells;
-                    SharedObjectListType::iterator	CellListit	= cellList.begin();
-
-                    while(CellListit != cellList.begin())	{
-						if((*CellListit)->getId() == regionId)	{
-                            cellList.erase(CellListit);
-                            break;
-                        }
-                        CellListit++;
-                    }
-                }
-            }
-
-            it = subCells.erase(it);
-			continue;
-        }
-        ++it;
-    }
+    mRegionIndex.Remove(regionId);
+    mRegions.erase(regionId);
 }
 
 uint32 zmap::_getCellId(float x, float z)
@@ -276,11 +208,10 @@ void zmap::RemoveObject(Object *removeObject)
     while(set_it != region_set->end())    {
         auto region = findRegion(*set_it);
 
-        if (!region) {
-		    region_set->erase(set_it++);		
+        if (region) {
+		    region->onObjectLeave(removeObject);
         }
 
-		region->onObjectLeave(removeObject);
 		region_set->erase(set_it++);	
     }
 
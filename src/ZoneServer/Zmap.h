@@ -7,10 +7,13 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "Utils/typedefs.h"
 
+#include "ZoneServer/RegionIndex.h"
+
 class Object;
 class RegionObject;
 
@@ -34,7 +37,7 @@ enum qtype	{
 typedef std::list<Object*> ObjectListType;
 typedef std::list<std::shared_ptr<Object>> SharedObjectListType;
 typedef std::set<Object*> ObjectSet;
-typedef std::multimap<uint32, std::shared_ptr<RegionObject>> SubCellMap;
+typedef std::unordered_map<uint64, std::shared_ptr<RegionObject>> RegionIdMap;
 
 enum BucketType {
 	Bucket_Creatures = 1,
@@ -47,7 +50,6 @@ public:
 	ObjectListType       Objects;
 	ObjectListType       Creatures;
 	ObjectListType       Players;
-	SharedObjectListType SubCells;
 };
 
 class zmap {
@@ -127,8 +129,6 @@ public:
 private:
 
 	uint32		_getCellId(float x, float z);
-	
-	bool		isObjectInRegionBoundary_(Object* object, std::shared_ptr<RegionObject> region);
 
 	//This is the actual Hashtable that stores the data
 	typedef std::map<uint32, ObjectListType>		MapHandler;
@@ -152,7 +152,10 @@ protected:
 	//FILE*			ZoneLogs;
 
 	static zmap*	ZMAP;
-	SubCellMap		subCells;
+
+	// regions by id, and their bounds bucketed by position for the movement checks
+	RegionIdMap			mRegions;
+	zone::RegionIndex	mRegionIndex;
 
 
 };
@@ -83,6 +83,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Common/EventDispatcher.h"
 #include "Utils/utils.h"
 #include "Utils/clock.h"
+#include "Utils/Reactor.h"
 #include "Utils/Singleton.h"
 
 #include "ZoneServer/HamService.h"
@@ -109,7 +110,13 @@ ZoneServer* gZoneServer = NULL;
 ZoneServer::ZoneServer(int argc, char* argv[])
     : BaseServer()
     , mLastHeartbeat(0)
+    , mLastWorldImageRefresh(0)
+    , mWorldImageInterval(0)
+    , mCounterInterval(0)
+    , mLastCounterWrite(0)
+    , mShutdownRequested(false)
     , event_dispatcher_(make_shared<EventDispatcher>())
+    , mReactor(0)
     , mNetworkManager(0)
     , mDatabaseManager(0)
     , mRouterService(0)
@@ -121,7 +128,16 @@ ZoneServer::ZoneServer(int argc, char* argv[])
     configuration_options_description_.add_options()
     ("ZoneName", boost::program_options::value<std::string>())
     ("writeResourceMaps", boost::program_options::value<bool>())
+    ("resourceMapThreads", boost::program_options::value<uint32>()->default_value(0))
+    ("resourceMapCache", boost::program_options::value<std::string>()->default_value(""))
     ("heightMapResolution", boost::program_options::value<uint16>()->default_value(3))
+    ("objectIdBlockSize", boost::program_options::value<uint32>()->default_value(0))
+    ("staticDataSnapshot", boost::program_options::value<std::string>()->default_value(""))
+    ("exportStaticData", boost::program_options::value<bool>()->default_value(false))
+    ("worldImage", boost::program_options::value<std::string>()->default_value(""))
+    ("worldImageWarmBoot", boost::program_options::value<bool>()->default_value(false))
+    ("worldImageInterval", boost::program_options::value<uint32>()->default_value(15))
+    ("scriptCache", boost::program_options::value<std::string>()->default_value(""))
     ;
 
     // This is to retrieve the ZoneName
@@ -149,6 +165,9 @@ ZoneServer::ZoneServer(int argc, char* argv[])
     // Create and startup our core services.
     mDatabaseManager = new DatabaseManager(DatabaseConfig(configuration_variables_map_["DBMinThreads"].as<uint32_t>(), configuration_variables_map_["DBMaxThreads"].as<uint32_t>(), configuration_variables_map_["DBGlobalSchema"].as<std::string>(), configuration_variables_map_["DBGalaxySchema"].as<std::string>(), configuration_variables_map_["DBConfigSchema"].as<std::string>()));
 
+    mReactor = new utils::Reactor(configuration_variables_map_["MainLoopTickInterval"].as<uint32_t>());
+    mDatabaseManager->setReactor(mReactor);
+
     // Startup our core modules
     MessageFactory::getSingleton(configuration_variables_map_["GlobalMessageHeap"].as<uint32_t>());
 
@@ -159,6 +178,7 @@ ZoneServer::ZoneServer(int argc, char* argv[])
                                           configuration_variables_map_["ServerPacketWindowSize"].as<uint32_t>(),
                                           configuration_variables_map_["ClientPacketWindowSize"].as<uint32_t>(),
                                           configuration_variables_map_["UdpBufferSize"].as<uint32_t>()));
+    mNetworkManager->setReactor(mReactor);
 
     // Connect to the DB and start listening for the RouterServer.
     mDatabase = mDatabaseManager->connect(DBTYPE_MYSQL,
@@ -168,10 +188,32 @@ ZoneServer::ZoneServer(int argc, char* argv[])
                                           (char*)(configuration_variables_map_["DBPass"].as<std::string>()).c_str(),
                                           (char*)(configuration_variables_map_["DBName"].as<std::string>()).c_str());
 
+    // read-only game data comes from the snapshot when there is one, an export
+    // run loads everything from the db and writes the snapshot once the world is up
+    std::string staticDataSnapshot = configuration_variables_map_["staticDataSnapshot"].as<std::string>();
+    if (!staticDataSnapshot.empty())
+    {
+        if (configuration_variables_map_["exportStaticData"].as<bool>())
+            mDatabase->startStaticSnapshotExport(staticDataSnapshot);
+        else
+            mDatabase->loadStaticSnapshot(staticDataSnapshot);
+    }
+
+    // the rows the world is built from are captured into an image, a warm boot
+    // builds the world from the image of the last run and validates it afterwards
+    std::string worldImage = configuration_variables_map_["worldImage"].as<std::string>();
+    if (!worldImage.empty())
+    {
+        mDatabase->startWorldImage(worldImage, configuration_variables_map_["worldImageWarmBoot"].as<bool>());
+        mWorldImageInterval = uint64(configuration_variables_map_["worldImageInterval"].as<uint32>()) * 60000;
+    }
+
     // increase the server start that will help us to organize our logs to the corresponding serverstarts (mostly for errors)
     mDatabase->executeProcedureAsync(0, 0, "CALL %s.sp_ServerStatusUpdate('%s', NULL, NULL, NULL);", mDatabase->galaxy(), mZoneName.c_str());
 
     mRouterService = mNetworkManager->GenerateService((char*)configuration_variables_map_["BindAddress"].as<std::string>().c_str(), configuration_variables_map_["BindPort"].as<uint16_t>(),configuration_variables_map_["ServiceMessageHeap"].as<uint32_t>()*1024, true);
+    mCounterInterval = uint64(configuration_variables_map_["CounterInterval"].as<uint32_t>()) * 1000;
+    mRouterService->setCountMessages(mCounterInterval != 0);
 
     // Grab our zoneId out of the DB for this zonename.
     uint32 zoneId = 0;
@@ -205,7 +247,7 @@ ZoneServer::ZoneServer(int argc, char* argv[])
     WorldConfig::Init(zoneId,mDatabase,BString(mZoneName.c_str()));
     ObjectControllerCommandMap::Init(mDatabase);
     MessageLib::Init();
-    ObjectFactory::Init(mDatabase);
+    ObjectFactory::Init(mDatabase, configuration_variables_map_["objectIdBlockSize"].as<uint32>());
 
     //attribute commands for food buffs
     FoodCommandMapClass::Init();
@@ -213,7 +255,7 @@ ZoneServer::ZoneServer(int argc, char* argv[])
     //structure manager callback functions
     StructureManagerCommandMapClass::Init();
 
-    WorldManager::Init(zoneId,this,mDatabase, configuration_variables_map_["heightMapResolution"].as<uint16>(), configuration_variables_map_["writeResourceMaps"].as<bool>(), mZoneName);
+    WorldManager::Init(zoneId,this,mDatabase, configuration_variables_map_["heightMapResolution"].as<uint16>(), configuration_variables_map_["writeResourceMaps"].as<bool>(), configuration_variables_map_["resourceMapThreads"].as<uint32>(), configuration_variables_map_["resourceMapCache"].as<std::string>(), mZoneName);
 
     // Init the non persistent factories. For now we take them one-by-one here, until we have a collection of them.
     // We can NOT create these factories among the already existing ones, if we want to have any kind of "ownership structure",
@@ -249,7 +291,7 @@ ZoneServer::ZoneServer(int argc, char* argv[])
 
     ham_service_ = std::unique_ptr<zone::HamService>(new zone::HamService(Singleton<common::EventDispatcher>::Instance(), gObjControllerCmdPropertyMap));
 
-    ScriptEngine::Init();
+    ScriptEngine::Init(configuration_variables_map_["scriptCache"].as<std::string>());
 
     mCharacterLoginHandler = new CharacterLoginHandler(mDatabase, mMessageDispatch);
 
@@ -272,7 +314,17 @@ ZoneServer::~ZoneServer(void)
     delete mObjectControllerDispatch;
     AdminManager::deleteManager();
 
+    // the main loop stopped, run the queued queries while the objects their
+    // callbacks refer to still exist
+    mDatabase->drain();
+
     gWorldManager->Shutdown();	// Should be closed before script engine and script support, due to halting of scripts.
+
+    // then the writes the world queued on its way down
+    mDatabase->drain();
+
+    // the next start can warm boot from the state the world was left in
+    mDatabase->writeWorldImage();
     gScriptEngine->shutdown();
     ScriptSupport::Instance()->destroyInstance();
 
@@ -301,16 +353,40 @@ ZoneServer::~ZoneServer(void)
     // NOW, I can feel that it should be safe to delete the data holding messages.
     gMessageFactory->destroySingleton();
 
+    delete mReactor;
+
     LOG(INFO) << "ZoneServer shutdown complete";
 }
 
 //======================================================================================================================
 
 void ZoneServer::handleWMReady()
+{
+    // all static data has been loaded by now
+    mDatabase->finishStaticSnapshotExport();
+
+    // a world built from a world image only goes online once the image matched the db
+    mDatabase->finishWorldImageLoad([this] (bool valid) {
+        if (!valid)
+        {
+            LOG(ERROR) << "The world was loaded from a stale world image, aborting the warm boot. The next start loads the world from the database";
+            mShutdownRequested = true;
+            return;
+        }
+
+        _goOnline();
+    });
+}
+
+//======================================================================================================================
+
+void ZoneServer::_goOnline(void)
 {
     _updateDBServerList(2);
     LOG(WARNING) << "ZoneServer startup complete";
 
+    mLastWorldImageRefresh = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
     // Connect to the ConnectionServer;
     _connectToConnectionServer();
 }
@@ -319,15 +395,9 @@ void ZoneServer::handleWMReady()
 
 void ZoneServer::Process(void)
 {
-    uint64_t current_timestep = Anh_Utils::Clock::getSingleton()->getGlobalTime();
     // Process our game modules
     mObjectControllerDispatch->Process();
-    gWorldManager->Process();
-    gScriptEngine->process();
     mMessageDispatch->Process();
-    gEventDispatcher.Tick(current_timestep);
-
-    event_dispatcher_->tick(0);
 
     //is there stalling ?
     mRouterService->Process();
@@ -342,6 +412,48 @@ void ZoneServer::Process(void)
     {
         mLastHeartbeat = static_cast<uint32>(Anh_Utils::Clock::getSingleton()->getLocalTime());
     }
+
+    // keep the world image close to the db, set once the world is up
+    if (mWorldImageInterval && mLastWorldImageRefresh && Anh_Utils::Clock::getSingleton()->getLocalTime() - mLastWorldImageRefresh > mWorldImageInterval)
+    {
+        mLastWorldImageRefresh = Anh_Utils::Clock::getSingleton()->getLocalTime();
+        mDatabase->refreshWorldImage();
+    }
+
+    if (mCounterInterval && Anh_Utils::Clock::getSingleton()->getLocalTime() - mLastCounterWrite > mCounterInterval)
+    {
+        mLastCounterWrite = Anh_Utils::Clock::getSingleton()->getLocalTime();
+        _writeCounters();
+    }
+}
+
+//======================================================================================================================
+//
+// the load generator reports the server side throughput from these
+//
+
+void ZoneServer::_writeCounters(void)
+{
+    std::stringstream sql;
+    sql << "REPLACE INTO " << mDatabase->galaxy() << ".server_counters VALUES ('" << mZoneName << "', "
+        << mRouterService->getMessagesReceived() << ", " << mRouterService->getMessagesSent() << ", " << mLastCounterWrite << ");";
+
+    mDatabase->executeAsyncSql(sql);
+}
+
+//======================================================================================================================
+
+void ZoneServer::Tick(void)
+{
+    uint64_t current_timestep = Anh_Utils::Clock::getSingleton()->getGlobalTime();
+
+    // everything that advances game time, the schedulers and event queues check their own deadlines
+    gWorldManager->Process();
+    gObjectFactory->process();
+    gScriptEngine->process();
+    gEventDispatcher.Advance(current_timestep);
+
+    event_dispatcher_->tick(0);
 }
 
 //======================================================================================================================
@@ -385,7 +497,12 @@ void ZoneServer::_connectToConnectionServer(void)
 
     // Now connect to the ConnectionServer
     DispatchClient* client = new DispatchClient();
-    mRouterService->Connect(client, processAddress.mAddress.getAnsi(), processAddress.mPort);
+
+    // prefer the local link when the connectionserver runs on this host
+    if(!mRouterService->ConnectLocal(client, configuration_variables_map_["LocalTransportPath"].as<std::string>()))
+    {
+        mRouterService->Connect(client, processAddress.mAddress.getAnsi(), processAddress.mPort);
+    }
 
     // Send our registration message
     gMessageFactory->StartMessage();
@@ -418,10 +535,14 @@ int main(int argc, char* argv[])
     // Start things up
     gZoneServer = new ZoneServer(argc, argv);
 
-    // Main loop
+    utils::Reactor* reactor = gZoneServer->getReactor();
+
+    // Main loop, sleeps until there is network or database work or the next simulation step is due
     while(1)
     {
-        if(AdminManager::Instance()->shutdownZone())
+        uint32 ticks = reactor->Wait();
+
+        if(AdminManager::Instance()->shutdownZone() || gZoneServer->shutdownRequested())
         {
             break;
         }
@@ -439,10 +560,13 @@ int main(int argc, char* argv[])
         }
 
         gZoneServer->Process();
-        gMessageFactory->Process(); //Garbage Collection
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        for(; ticks > 0; --ticks)
+        {
+            gZoneServer->Tick();
+        }
 
+        gMessageFactory->Process(); //Garbage Collection
     }
 
     // Shut things down
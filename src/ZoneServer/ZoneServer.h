@@ -40,6 +40,10 @@ namespace event_dispatcher {
     class IEventDispatcher;
 }}  // namespace anh::event_dispatcher
 
+namespace utils {
+class Reactor;
+}
+
 class NetworkManager;
 class Service;
 class DatabaseManager;
@@ -78,10 +82,23 @@ public:
     ZoneServer(int argc, char* argv[]);
     ~ZoneServer(void);
 
+    // handles network and database work, runs whenever the reactor wakes up
     void	Process(void);
 
+    // one fixed simulation step, the main loop runs as many as the reactor reports due
+    void	Tick(void);
+
     void	handleWMReady();
 
+    // set when the zone can't go online and has to be stopped
+    bool	shutdownRequested() const {
+        return mShutdownRequested;
+    }
+
+    utils::Reactor*	getReactor() {
+        return mReactor;
+    }
+
     std::string  getZoneName()  {
         return mZoneName;
     }
@@ -93,12 +110,20 @@ private:
     const ZoneServer& operator=(const ZoneServer&);
 
     void	_updateDBServerList(uint32 status);
+    void	_writeCounters(void);
     void	_connectToConnectionServer(void);
+    void	_goOnline(void);
 
     std::string                   mZoneName;
     uint32						  mLastHeartbeat;
+    uint64                        mLastWorldImageRefresh;
+    uint64                        mWorldImageInterval;
+    uint64                        mCounterInterval;
+    uint64                        mLastCounterWrite;
+    bool                          mShutdownRequested;
 
     std::shared_ptr<anh::event_dispatcher::IEventDispatcher> event_dispatcher_;
+    utils::Reactor*               mReactor;
     NetworkManager*               mNetworkManager;
     DatabaseManager*              mDatabaseManager;
 
@@ -0,0 +1,150 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/AttributeMap.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+/*! Numbers are stored typed when formatting them gives back the loaded text,
+* anything else keeps its text.
+*/
+TEST(AttributeValueTests, DetectsTheTypeFromTheText) {
+    EXPECT_EQ(AttributeValue::Type_Int, AttributeValue("12").getType());
+    EXPECT_EQ(AttributeValue::Type_Int, AttributeValue("-5").getType());
+    EXPECT_EQ(AttributeValue::Type_Int, AttributeValue("0").getType());
+
+    EXPECT_EQ(AttributeValue::Type_Float, AttributeValue("0.3").getType());
+    EXPECT_EQ(AttributeValue::Type_Float, AttributeValue("-1.25").getType());
+    EXPECT_EQ(AttributeValue::Type_Float, AttributeValue("3.14159").getType());
+
+    // formatting these again would change the text sent to clients
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("0.30").getType());
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("1.0").getType());
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("007").getType());
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("+5").getType());
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("1e5").getType());
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("99999999999999999999").getType());
+
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("").getType());
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("12 units").getType());
+    EXPECT_EQ(AttributeValue::Type_String, AttributeValue("@obj_attr_n:crafter").getType());
+}
+
+/*! Every value formats back to the text it was loaded from.
+*/
+TEST(AttributeValueTests, FormatsBackToTheLoadedText) {
+    const char* values[] = {"12", "-5", "0.3", "-1.25", "3.14159", "0.30", "1.0", "007", "1e5", "", "text"};
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        EXPECT_EQ(values[i], AttributeValue(values[i]).toString());
+    }
+}
+
+/*! Typed values convert directly to the requested type, conversions
+* lexical_cast would reject fail.
+*/
+TEST(AttributeValueTests, ConvertsTypedValuesDirectly) {
+    float f = 0.0f;
+    EXPECT_TRUE(AttributeValue("0.3").as(f));
+    EXPECT_FLOAT_EQ(0.3f, f);
+
+    EXPECT_TRUE(AttributeValue("12").as(f));
+    EXPECT_FLOAT_EQ(12.0f, f);
+
+    double d = 0.0;
+    EXPECT_TRUE(AttributeValue("-1.25").as(d));
+    EXPECT_DOUBLE_EQ(-1.25, d);
+
+    uint32 u = 0;
+    EXPECT_TRUE(AttributeValue("4000000000").as(u));
+    EXPECT_EQ(4000000000u, u);
+    EXPECT_FALSE(AttributeValue("0.3").as(u));
+    EXPECT_FALSE(AttributeValue("-1").as(u));
+
+    uint8 small = 0;
+    EXPECT_TRUE(AttributeValue("255").as(small));
+    EXPECT_EQ(255, small);
+    EXPECT_FALSE(AttributeValue("256").as(small));
+
+    int32 i = 0;
+    EXPECT_TRUE(AttributeValue("-5").as(i));
+    EXPECT_EQ(-5, i);
+
+    bool b = false;
+    EXPECT_TRUE(AttributeValue("1").as(b));
+    EXPECT_TRUE(b);
+    EXPECT_TRUE(AttributeValue("0").as(b));
+    EXPECT_FALSE(b);
+    EXPECT_FALSE(AttributeValue("2").as(b));
+    EXPECT_FALSE(AttributeValue("0.3").as(b));
+
+    std::string text;
+    EXPECT_TRUE(AttributeValue("0.3").as(text));
+    EXPECT_EQ("0.3", text);
+}
+
+/*! Values kept as text are parsed on read.
+*/
+TEST(AttributeValueTests, ParsesValuesKeptAsText) {
+    float f = 0.0f;
+    EXPECT_TRUE(AttributeValue("0.30").as(f));
+    EXPECT_FLOAT_EQ(0.3f, f);
+
+    uint32 u = 0;
+    EXPECT_TRUE(AttributeValue("007").as(u));
+    EXPECT_EQ(7u, u);
+    EXPECT_FALSE(AttributeValue("text").as(u));
+}
+
+/*! Assigning a new text retypes the value, copies are independent.
+*/
+TEST(AttributeValueTests, AssignmentRetypesTheValue) {
+    AttributeValue value("text");
+
+    value = std::string("0.3");
+    EXPECT_EQ(AttributeValue::Type_Float, value.getType());
+
+    AttributeValue copy(value);
+    value = std::string("more text");
+
+    EXPECT_EQ(AttributeValue::Type_String, value.getType());
+    EXPECT_EQ("0.3", copy.toString());
+
+    copy = value;
+    EXPECT_EQ("more text", copy.toString());
+}
+
+/*! The map stays sorted by key and insert does not overwrite, like std::map.
+*/
+TEST(AttributeMapTests, BehavesLikeAMapKeyedByCrc) {
+    AttributeMap attributes;
+
+    EXPECT_TRUE(attributes.insert(std::make_pair(30u, std::string("3"))).second);
+    EXPECT_TRUE(attributes.insert(std::make_pair(10u, std::string("1"))).second);
+    EXPECT_TRUE(attributes.insert(std::make_pair(20u, std::string("2"))).second);
+    EXPECT_FALSE(attributes.insert(std::make_pair(20u, std::string("4"))).second);
+
+    ASSERT_EQ(3u, attributes.size());
+
+    uint32 key = 0;
+    for (AttributeMap::const_iterator it = attributes.begin(); it != attributes.end(); ++it) {
+        EXPECT_LT(key, it->first);
+        key = it->first;
+    }
+
+    ASSERT_TRUE(attributes.find(20) != attributes.end());
+    EXPECT_EQ("2", attributes.find(20)->second.toString());
+    EXPECT_TRUE(attributes.find(25) == attributes.end());
+
+    EXPECT_EQ(1u, attributes.erase(20));
+    EXPECT_EQ(0u, attributes.erase(20));
+    EXPECT_EQ(2u, attributes.size());
+}
+
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/CommandRules.h"
+
+#include <gtest/gtest.h>
+
+using zone::CommandRules;
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+CommandRules compile(uint64_t posture_mask, uint64_t states, uint64_t locomotion_mask) {
+    CommandRules rules;
+    rules.Compile(posture_mask, states, locomotion_mask, 0, 0, 0, 0, 0);
+    return rules;
+}
+
+// the state and locomotion tests of the removed EVState validator
+CommandRules::Result enqueueValidator(uint64_t states, uint64_t locomotion_mask, uint64_t action, uint32_t posture) {
+    if (states != 0 && (action & states) == states) {
+        return CommandRules::kWrongState;
+    }
+
+    if (locomotion_mask != 0 && (locomotion_mask & posture) != 0) {
+        return CommandRules::kWrongLocomotion;
+    }
+
+    return CommandRules::kPassed;
+}
+
+// the state tests of the removed PVState validator
+CommandRules::Result processValidator(uint64_t posture_mask, uint64_t states, uint64_t action, uint32_t posture) {
+    if (states != 0 && (action & states) != 0) {
+        if ((action & states) == states) {
+            return CommandRules::kWrongState;
+        }
+
+        if (posture_mask != 0 && (posture_mask & posture) != 0) {
+            return CommandRules::kWrongLocomotion;
+        }
+    }
+
+    return CommandRules::kPassed;
+}
+
+/*! Only the checks a command has properties for are flagged.
+*/
+TEST(CommandRulesTests, FlagsOnlyTheChecksACommandNeeds) {
+    CommandRules none;
+    none.Compile(0xffffffff, 0, 0, 0, 0, 0, 0, 0);
+
+    EXPECT_FALSE(none.RequiresAbility());
+    EXPECT_FALSE(none.RequiresWeapon());
+    EXPECT_FALSE(none.HasHamCost());
+    EXPECT_EQ(CommandRules::kPassed, none.CheckEnqueueStates(~0ULL, 3));
+    EXPECT_EQ(CommandRules::kPassed, none.CheckProcessStates(~0ULL, 3));
+
+    CommandRules all;
+    all.Compile(0xffffffff, 0x10, 0x4, 0x1234, 0x2, 0, 0, 25);
+
+    EXPECT_TRUE(all.RequiresAbility());
+    EXPECT_TRUE(all.RequiresWeapon());
+    EXPECT_TRUE(all.HasHamCost());
+    EXPECT_EQ(0x1234u, all.ability_crc());
+    EXPECT_EQ(25, all.mind_cost());
+
+    // compiling again starts over
+    all.Compile(0xffffffff, 0, 0, 0, 0, 0, 0, 0);
+    EXPECT_FALSE(all.RequiresAbility());
+    EXPECT_FALSE(all.RequiresWeapon());
+    EXPECT_FALSE(all.HasHamCost());
+}
+
+/*! A posture passes when its bit is in the mask, weapons when their group is
+* one of the required groups.
+*/
+TEST(CommandRulesTests, ChecksPostureAndWeaponGroup) {
+    CommandRules rules;
+    rules.Compile((1 << 0) | (1 << 8), 0, 0, 0, 0x6, 0, 0, 0);
+
+    EXPECT_TRUE(rules.PostureAllowed(0));
+    EXPECT_TRUE(rules.PostureAllowed(8));
+    EXPECT_FALSE(rules.PostureAllowed(1));
+    EXPECT_FALSE(rules.PostureAllowed(14));
+
+    EXPECT_TRUE(rules.WeaponAllowed(0x2));
+    EXPECT_TRUE(rules.WeaponAllowed(0x4));
+    EXPECT_FALSE(rules.WeaponAllowed(0x1));
+    EXPECT_FALSE(rules.WeaponAllowed(0x3));
+}
+
+/*! The enqueue and process state checks answer like the validators they
+* replaced, for every combination of masks, states and postures tried.
+*/
+TEST(CommandRulesTests, StateChecksMatchTheValidators) {
+    const uint64_t masks[] = { 0, 0x1, 0x6, 0x10, 0x11, 0x3ff, 0x100000000ULL, 0x100000001ULL };
+    const size_t count = sizeof(masks) / sizeof(masks[0]);
+
+    for (size_t s = 0; s < count; ++s) {
+        for (size_t m = 0; m < count; ++m) {
+            CommandRules rules = compile(masks[m], masks[s], masks[m]);
+
+            for (size_t a = 0; a < count; ++a) {
+                for (uint32_t posture = 0; posture < 15; ++posture) {
+                    EXPECT_EQ(enqueueValidator(masks[s], masks[m], masks[a], posture),
+                              rules.CheckEnqueueStates(masks[a], posture))
+                        << "states " << masks[s] << ", mask " << masks[m] << ", action " << masks[a] << ", posture " << posture;
+
+                    EXPECT_EQ(processValidator(masks[m], masks[s], masks[a], posture),
+                              rules.CheckProcessStates(masks[a], posture))
+                        << "states " << masks[s] << ", mask " << masks[m] << ", action " << masks[a] << ", posture " << posture;
+                }
+            }
+        }
+    }
+}
+
+/*! A creature in all required states is refused, one in only some of them is
+* refused before running when its posture hits the posture mask.
+*/
+TEST(CommandRulesTests, RefusesCreaturesInTheCommandsStates) {
+    CommandRules rules = compile(0x2, 0x30, 0x1);
+
+    EXPECT_EQ(CommandRules::kWrongState, rules.CheckEnqueueStates(0x31, 0));
+    EXPECT_EQ(CommandRules::kPassed, rules.CheckEnqueueStates(0x10, 0));
+    EXPECT_EQ(CommandRules::kWrongLocomotion, rules.CheckEnqueueStates(0x10, 1));
+
+    EXPECT_EQ(CommandRules::kWrongState, rules.CheckProcessStates(0x30, 0));
+    EXPECT_EQ(CommandRules::kPassed, rules.CheckProcessStates(0x10, 0));
+    EXPECT_EQ(CommandRules::kWrongLocomotion, rules.CheckProcessStates(0x10, 2));
+    EXPECT_EQ(CommandRules::kPassed, rules.CheckProcessStates(0x1, 2));
+}
+
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/CreatureHotStore.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using zone::CreatureHotStore;
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+/*! A released handle stays invalid once its slot is reused, the new owner of
+* the slot gets a handle of the next generation.
+*/
+TEST(CreatureHotStoreTests, ReusedSlotsGetANewGeneration) {
+    CreatureHotStore store;
+
+    CreatureHotStore::Handle first = store.Create();
+    ASSERT_TRUE(store.IsValid(first));
+    EXPECT_FALSE(store.IsValid(CreatureHotStore::kInvalidHandle));
+
+    store.Release(first);
+    EXPECT_FALSE(store.IsValid(first));
+
+    CreatureHotStore::Handle second = store.Create();
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(store.IsValid(second));
+    EXPECT_FALSE(store.IsValid(first));
+
+    // releasing the stale handle again leaves the new owner alone
+    store.Release(first);
+    EXPECT_TRUE(store.IsValid(second));
+    EXPECT_EQ(1u, store.size());
+}
+
+/*! Releasing a row moves the last one into its place, the moved creature
+* keeps its handle, its id and its state.
+*/
+TEST(CreatureHotStoreTests, ReleaseMovesTheLastRowIntoTheHole) {
+    CreatureHotStore store;
+
+    std::vector<CreatureHotStore::Handle> handles;
+    for (uint64_t id = 1; id <= 3; ++id) {
+        CreatureHotStore::Handle handle = store.Create();
+        store.Bind(handle, id);
+        store.SetPosition(handle, static_cast<float>(id), 0.0f, 0.0f, 0, 0, 0);
+        store.SetPosture(handle, static_cast<uint32_t>(id));
+        handles.push_back(handle);
+    }
+
+    store.Release(handles[0]);
+
+    ASSERT_EQ(2u, store.size());
+    EXPECT_EQ(0u, store.Row(handles[2]));
+    EXPECT_EQ(handles[2], store.Find(3));
+    EXPECT_EQ(3u, store.posture(handles[2]));
+    EXPECT_FALSE(store.Find(1));
+
+    EXPECT_TRUE(store.InRangeOutside(3.0f, 0.0f, 0.0f, handles[2], 0.5f));
+    EXPECT_TRUE(store.InRangeOutside(2.0f, 0.0f, 0.0f, handles[1], 0.5f));
+
+    // releasing the last row moves nothing
+    store.Release(handles[1]);
+    ASSERT_EQ(1u, store.size());
+    EXPECT_EQ(handles[2], store.Find(3));
+}
+
+/*! A creature removed from the world is unbound, lookups by id miss until it
+* is bound again.
+*/
+TEST(CreatureHotStoreTests, UnboundCreaturesAreNotFound) {
+    CreatureHotStore store;
+
+    CreatureHotStore::Handle handle = store.Create();
+    store.Bind(handle, 42);
+    EXPECT_EQ(handle, store.Find(42));
+
+    store.Bind(handle, 0);
+    EXPECT_FALSE(store.Find(42));
+    EXPECT_TRUE(store.IsValid(handle));
+
+    store.Bind(handle, 42);
+    EXPECT_EQ(handle, store.Find(42));
+}
+
+/*! Creatures in cells only see each other inside the same building.
+*/
+TEST(CreatureHotStoreTests, RangeFollowsTheBuilding) {
+    CreatureHotStore store;
+
+    CreatureHotStore::Handle outside = store.Create();
+    CreatureHotStore::Handle cell = store.Create();
+    CreatureHotStore::Handle other_cell = store.Create();
+    CreatureHotStore::Handle down = store.Create();
+
+    store.SetPosition(outside, 0.0f, 0.0f, 0.0f, 0, 0, 0);
+    store.SetPosition(cell, 1.0f, 0.0f, 0.0f, 100, 10, 0);
+    store.SetPosition(other_cell, 2.0f, 0.0f, 0.0f, 101, 10, 0);
+    store.SetPosition(down, 1.0f, 0.0f, 1.0f, 0, 0, 0);
+    store.SetPosture(down, CreaturePosture_Dead);
+
+    EXPECT_FALSE(store.InRange(outside, cell, 10.0f));
+    EXPECT_TRUE(store.InRange(cell, other_cell, 10.0f));
+    EXPECT_FALSE(store.InRange(cell, other_cell, 0.5f));
+    EXPECT_TRUE(store.IsDown(down));
+
+    std::vector<CreatureHotStore::Handle> standing;
+    store.ForEachStandingOutside(0.0f, 0.0f, 10.0f, [&standing] (CreatureHotStore::Handle handle) { standing.push_back(handle); });
+
+    ASSERT_EQ(1u, standing.size());
+    EXPECT_EQ(outside, standing[0]);
+}
+
+}
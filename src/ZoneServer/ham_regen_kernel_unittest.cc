@@ -0,0 +1,113 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/HamRegenKernel.h"
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+// deterministic values in [low, high], the same on every platform
+class Values {
+public:
+    Values() : state_(12345) {}
+
+    int32_t next(int32_t low, int32_t high) {
+        state_ = state_ * 1103515245u + 12345u;
+        return low + static_cast<int32_t>((state_ >> 8) % static_cast<uint32_t>(high - low + 1));
+    }
+
+private:
+    uint32_t state_;
+};
+
+struct Pools {
+    std::vector<int32_t> current;
+    std::vector<int32_t> max;
+    std::vector<int32_t> rate;
+    std::vector<uint8_t> changed;
+};
+
+/*! Full, over full, empty and dead pools, zero and negative rates and rates
+* that would pass the maximum, mixed across and inside SIMD lanes.
+*/
+Pools makePools(size_t count) {
+    Values values;
+    Pools pools;
+
+    for (size_t i = 0; i < count; ++i) {
+        int32_t max = values.next(1, 5000);
+        int32_t current;
+
+        switch (values.next(0, 4)) {
+            case 0: current = max; break;
+            case 1: current = max + values.next(1, 100); break;
+            case 2: current = 0; break;
+            case 3: current = -values.next(1, 100); break;
+            default: current = values.next(0, max); break;
+        }
+
+        int32_t rate;
+
+        switch (values.next(0, 3)) {
+            case 0: rate = 0; break;
+            case 1: rate = -values.next(1, 50); break;
+            case 2: rate = max; break;
+            default: rate = values.next(1, 50); break;
+        }
+
+        pools.current.push_back(current);
+        pools.max.push_back(max);
+        pools.rate.push_back(rate);
+        pools.changed.push_back(0xff);
+    }
+
+    return pools;
+}
+
+/*! The vectorised kernel gives the same values and change flags as the scalar
+* rule, for every length so the lanes and the tail are both covered.
+*/
+TEST(HamRegenKernelTests, MatchesTheScalarRule) {
+    for (size_t count = 0; count <= 67; ++count) {
+        Pools simd = makePools(count);
+        Pools scalar = simd;
+
+        for (int tick = 0; tick < 5; ++tick) {
+            zone::RegenerateHamPools(simd.current.data(), simd.max.data(), simd.rate.data(), simd.changed.data(), count);
+            zone::RegenerateHamPoolsScalar(scalar.current.data(), scalar.max.data(), scalar.rate.data(), scalar.changed.data(), count);
+
+            ASSERT_EQ(scalar.current, simd.current) << count << " pools, tick " << tick;
+            ASSERT_EQ(scalar.changed, simd.changed) << count << " pools, tick " << tick;
+        }
+    }
+}
+
+/*! A pool gains its rate up to the maximum, full pools and pools without a
+* positive rate are not touched.
+*/
+TEST(HamRegenKernelTests, RegeneratesUpToTheMaximum) {
+    int32_t current[] = { 10, 95, 100, 120, 50, 50 };
+    int32_t max[]     = { 100, 100, 100, 100, 100, 100 };
+    int32_t rate[]    = { 10, 10, 10, 10, 0, -5 };
+    uint8_t changed[6];
+
+    zone::RegenerateHamPools(current, max, rate, changed, 6);
+
+    EXPECT_EQ(20, current[0]);
+    EXPECT_EQ(100, current[1]);
+    EXPECT_EQ(100, current[2]);
+    EXPECT_EQ(120, current[3]);
+    EXPECT_EQ(50, current[4]);
+    EXPECT_EQ(50, current[5]);
+
+    uint8_t expected[] = { 1, 1, 0, 0, 0, 0 };
+    EXPECT_EQ(0, memcmp(expected, changed, sizeof(expected)));
+}
+
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/ObjectIdAllocator.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseConfig.h"
+#include "DatabaseManager/DatabaseImplementationMemory.h"
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+const char kReserveQuery[] = "SELECT galaxy.sf_ReserveObjectIds(8)";
+
+/*! Answers every reservation with the next first id of a list, 0 once the
+* list ran out.
+*/
+class ObjectIdAllocatorTest : public testing::Test {
+protected:
+    ObjectIdAllocatorTest()
+        : config_(1, 1, "global", "galaxy", "config")
+        , next_block_(0)
+    {
+        memory_.setHandler([this] (const std::string& sql, uint32_t& columns, std::vector<std::string>& cells) -> bool {
+            if (sql != kReserveQuery) {
+                return false;
+            }
+
+            columns = 1;
+            cells.push_back(next_block_ < blocks_.size() ? blocks_[next_block_] : "0");
+            ++next_block_;
+            return true;
+        });
+    }
+
+    size_t reservations() const {
+        std::vector<std::string> queries = memory_.getQueries();
+        return std::count(queries.begin(), queries.end(), std::string(kReserveQuery));
+    }
+
+    DatabaseImplementationMemory memory_;
+    DatabaseConfig config_;
+    std::vector<std::string> blocks_;
+    size_t next_block_;
+};
+
+/*! The first block is reserved on construction, no id is handed out before
+* it arrived.
+*/
+TEST_F(ObjectIdAllocatorTest, HandsOutTheReservedBlockInOrder) {
+    blocks_.push_back("1000");
+
+    Database database(memory_.getFactory(), config_);
+    ObjectIdAllocator allocator(&database, 8);
+
+    EXPECT_EQ(0u, allocator.takeId());
+
+    database.drain();
+    EXPECT_EQ(8u, allocator.getAvailable());
+
+    for (uint64 id = 1000; id < 1005; ++id) {
+        EXPECT_EQ(id, allocator.takeId());
+    }
+
+    database.drain();
+    EXPECT_EQ(1u, reservations());
+}
+
+/*! Dropping to the low water mark (a quarter of the block) requests the next
+* block, a block directly following the current one continues its range.
+*/
+TEST_F(ObjectIdAllocatorTest, RefillsAtTheLowWaterMark) {
+    blocks_.push_back("1000");
+    blocks_.push_back("1008");
+
+    Database database(memory_.getFactory(), config_);
+    ObjectIdAllocator allocator(&database, 8);
+    database.drain();
+
+    for (uint64 id = 1000; id < 1006; ++id) {
+        allocator.takeId();
+    }
+
+    database.drain();
+    EXPECT_EQ(2u, reservations());
+    EXPECT_EQ(10u, allocator.getAvailable());
+
+    for (uint64 id = 1006; id < 1016; ++id) {
+        EXPECT_EQ(id, allocator.takeId());
+    }
+
+    // dry again, the next request finds no block left
+    database.drain();
+    EXPECT_EQ(0u, allocator.takeId());
+    database.drain();
+}
+
+/*! Blocks that are not adjacent are used one after the other.
+*/
+TEST_F(ObjectIdAllocatorTest, SeparateBlocksAreKeptApart) {
+    blocks_.push_back("1000");
+    blocks_.push_back("5000");
+
+    Database database(memory_.getFactory(), config_);
+    ObjectIdAllocator allocator(&database, 8);
+    database.drain();
+
+    for (uint64 id = 1000; id < 1006; ++id) {
+        allocator.takeId();
+    }
+
+    database.drain();
+
+    EXPECT_EQ(1006u, allocator.takeId());
+    EXPECT_EQ(1007u, allocator.takeId());
+    EXPECT_EQ(5000u, allocator.takeId());
+}
+
+/*! A failed reservation leaves the allocator dry, the next takeId() asks again.
+*/
+TEST_F(ObjectIdAllocatorTest, RetriesAFailedReservation) {
+    Database database(memory_.getFactory(), config_);
+    ObjectIdAllocator allocator(&database, 8);
+    database.drain();
+
+    EXPECT_EQ(0u, allocator.takeId());
+
+    blocks_.push_back("0");
+    blocks_.push_back("2000");
+    database.drain();
+
+    EXPECT_EQ(2u, reservations());
+    EXPECT_EQ(2000u, allocator.takeId());
+}
+
+/*! A block size of 0 turns reservations off.
+*/
+TEST_F(ObjectIdAllocatorTest, DisabledWithoutABlockSize) {
+    Database database(memory_.getFactory(), config_);
+    ObjectIdAllocator allocator(&database, 0);
+    database.drain();
+
+    EXPECT_FALSE(allocator.isEnabled());
+    EXPECT_EQ(0u, allocator.takeId());
+    EXPECT_EQ(0u, reservations());
+}
+
+}
@@ -0,0 +1,146 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/RegionIndex.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using zone::RegionBounds;
+using zone::RegionIndex;
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+std::vector<uint64_t> query(const RegionIndex& index, float x, float z) {
+    std::vector<uint64_t> found;
+
+    index.Query(x, z, [&found] (uint64_t id) {
+        found.push_back(id);
+    });
+
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+/*! A region is found at the points it covers, edges included, and not
+* elsewhere. Removing it removes it from every query.
+*/
+TEST(RegionIndexTests, InsertQueryAndRemove) {
+    RegionIndex index(16384.0f, 128.0f);
+
+    index.Insert(1, RegionBounds(10.0f, 20.0f, 30.0f, 40.0f));
+    index.Insert(2, RegionBounds(25.0f, 35.0f, 50.0f, 60.0f));
+
+    EXPECT_EQ(2u, index.size());
+
+    EXPECT_EQ(std::vector<uint64_t>(1, 1), query(index, 10.0f, 20.0f));
+    EXPECT_EQ(std::vector<uint64_t>(1, 1), query(index, 30.0f, 30.0f));
+    EXPECT_EQ(std::vector<uint64_t>(1, 2), query(index, 50.0f, 60.0f));
+    EXPECT_TRUE(query(index, 9.9f, 20.0f).empty());
+    EXPECT_TRUE(query(index, 30.0f, 60.1f).empty());
+
+    std::vector<uint64_t> both;
+    both.push_back(1);
+    both.push_back(2);
+    EXPECT_EQ(both, query(index, 27.0f, 37.0f));
+
+    EXPECT_TRUE(index.Contains(1, 15.0f, 25.0f));
+    EXPECT_FALSE(index.Contains(1, 45.0f, 25.0f));
+    EXPECT_FALSE(index.Contains(3, 15.0f, 25.0f));
+
+    EXPECT_TRUE(index.Remove(1));
+    EXPECT_FALSE(index.Remove(1));
+    EXPECT_EQ(1u, index.size());
+
+    EXPECT_EQ(std::vector<uint64_t>(1, 2), query(index, 27.0f, 37.0f));
+    EXPECT_TRUE(query(index, 15.0f, 25.0f).empty());
+    EXPECT_FALSE(index.Contains(1, 15.0f, 25.0f));
+}
+
+/*! Inserting under an id already indexed moves the region, it is gone from
+* the buckets of its old bounds.
+*/
+TEST(RegionIndexTests, InsertReplacesTheRegion) {
+    RegionIndex index(16384.0f, 128.0f);
+
+    index.Insert(1, RegionBounds(0.0f, 0.0f, 10.0f, 10.0f));
+    index.Insert(1, RegionBounds(1000.0f, 1000.0f, 1010.0f, 1010.0f));
+
+    EXPECT_EQ(1u, index.size());
+    EXPECT_TRUE(query(index, 5.0f, 5.0f).empty());
+    EXPECT_EQ(std::vector<uint64_t>(1, 1), query(index, 1005.0f, 1005.0f));
+}
+
+/*! A region spanning several buckets, on both sides of the map's center, is
+* found from every bucket it covers and exactly once per query.
+*/
+TEST(RegionIndexTests, FindsRegionsSpanningBucketEdges) {
+    RegionIndex index(16384.0f, 128.0f);
+
+    index.Insert(7, RegionBounds(-300.0f, -140.0f, 260.0f, 129.0f));
+
+    const float xs[] = { -300.0f, -128.0f, -0.5f, 0.0f, 127.9f, 128.0f, 260.0f };
+    const float zs[] = { -140.0f, -128.0f, -1.0f, 0.0f, 128.0f, 129.0f };
+
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i) {
+        for (size_t j = 0; j < sizeof(zs) / sizeof(zs[0]); ++j) {
+            EXPECT_EQ(std::vector<uint64_t>(1, 7), query(index, xs[i], zs[j])) << xs[i] << "/" << zs[j];
+        }
+    }
+
+    EXPECT_TRUE(query(index, -300.1f, 0.0f).empty());
+    EXPECT_TRUE(query(index, 0.0f, 129.1f).empty());
+    EXPECT_TRUE(query(index, 261.0f, -141.0f).empty());
+
+    EXPECT_TRUE(index.Remove(7));
+
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); ++i) {
+        for (size_t j = 0; j < sizeof(zs) / sizeof(zs[0]); ++j) {
+            EXPECT_TRUE(query(index, xs[i], zs[j]).empty());
+        }
+    }
+}
+
+/*! Points and regions past the map's edges land in the edge buckets instead
+* of outside of the grid.
+*/
+TEST(RegionIndexTests, ClampsToTheMapEdges) {
+    RegionIndex index(1024.0f, 128.0f);
+
+    index.Insert(1, RegionBounds(-600.0f, -600.0f, -500.0f, -500.0f));
+    index.Insert(2, RegionBounds(500.0f, 500.0f, 700.0f, 700.0f));
+
+    EXPECT_EQ(std::vector<uint64_t>(1, 1), query(index, -550.0f, -550.0f));
+    EXPECT_EQ(std::vector<uint64_t>(1, 2), query(index, 650.0f, 650.0f));
+    EXPECT_TRUE(query(index, -10000.0f, -10000.0f).empty());
+    EXPECT_TRUE(query(index, 10000.0f, 10000.0f).empty());
+}
+
+/*! Regions extend by their height along x and by their width along z, the
+* axes the region boundary test always used.
+*/
+TEST(RegionIndexTests, RegionsExtendByHeightAlongX) {
+    RegionBounds bounds = RegionBounds::FromExtents(-100.0f, 50.0f, 20.0f, 300.0f);
+
+    EXPECT_EQ(-100.0f, bounds.min_x);
+    EXPECT_EQ(200.0f, bounds.max_x);
+    EXPECT_EQ(50.0f, bounds.min_z);
+    EXPECT_EQ(70.0f, bounds.max_z);
+
+    RegionIndex index(16384.0f, 128.0f);
+    index.Insert(3, bounds);
+
+    // along x the region covers buckets its width alone would not reach
+    EXPECT_TRUE(index.Contains(3, 199.0f, 60.0f));
+    EXPECT_EQ(std::vector<uint64_t>(1, 3), query(index, 199.0f, 60.0f));
+
+    EXPECT_FALSE(index.Contains(3, -90.0f, 71.0f));
+    EXPECT_FALSE(index.Contains(3, -90.0f, 250.0f));
+    EXPECT_TRUE(query(index, -90.0f, 250.0f).empty());
+}
+
+}
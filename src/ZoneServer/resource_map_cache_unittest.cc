@@ -0,0 +1,124 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/ResourceMapCache.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <boost/interprocess/mapped_region.hpp>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+ResourceMapKey key(uint64 resourceId) {
+    ResourceMapKey result;
+    result.mResourceId = resourceId;
+    result.mSeed = 7;
+    result.mOctaves = 4;
+    result.mFrequency = 0.25;
+    result.mPersistence = 0.5;
+    result.mScale = 1.0;
+    result.mBias = 0.0;
+    result.mBoundsX1 = 0.0;
+    result.mBoundsX2 = 8.0;
+    result.mBoundsY1 = 0.0;
+    result.mBoundsY2 = 8.0;
+    result.mWidth = 4;
+    result.mHeight = 2;
+    return result;
+}
+
+size_t countFiles(const std::string& directory, const char* names[], size_t count) {
+    size_t found = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        found += std::ifstream((directory + "/" + names[i]).c_str()).good() ? 1 : 0;
+    }
+
+    return found;
+}
+
+class ResourceMapCacheTest : public testing::Test {
+protected:
+    ResourceMapCacheTest() {
+        std::stringstream directory;
+        directory << "/tmp/anh_resourcemaps_" << getpid();
+        directory_ = directory.str();
+    }
+
+    ~ResourceMapCacheTest() {
+        ResourceMapCache(directory_, "naboo").removeSuperseded(std::vector<ResourceMapKey>());
+        ResourceMapCache(directory_, "corellia").removeSuperseded(std::vector<ResourceMapKey>());
+
+        for (std::vector<std::string>::iterator it = created_.begin(); it != created_.end(); ++it) {
+            std::remove(it->c_str());
+        }
+
+        rmdir(directory_.c_str());
+    }
+
+    // stores a map out of rows wider than the map, like the slab of a noise map
+    void store(const ResourceMapCache& cache, const ResourceMapKey& map_key, float first) {
+        std::vector<float> values(map_key.mWidth * map_key.mHeight * 2, first);
+        ASSERT_TRUE(cache.store(map_key, &values[0], map_key.mWidth * 2));
+    }
+
+    void track(const char* name) {
+        created_.push_back(directory_ + "/" + name);
+    }
+
+    std::string directory_;
+    std::vector<std::string> created_;
+};
+
+/*! A stored map is mapped again for the same key, any other key misses.
+*/
+TEST_F(ResourceMapCacheTest, StoredMapsLoadForTheSameKey) {
+    ResourceMapCache cache(directory_, "naboo");
+    store(cache, key(10), 0.5f);
+
+    ResourceMapCache::MappedMap region = cache.load(key(10));
+    ASSERT_TRUE(region != nullptr);
+    EXPECT_EQ(0.5f, ResourceMapCache::getValues(*region)[7]);
+
+    ResourceMapKey seeded = key(10);
+    seeded.mSeed = 8;
+    EXPECT_FALSE(cache.load(seeded));
+    EXPECT_FALSE(cache.load(key(11)));
+    EXPECT_FALSE(ResourceMapCache(directory_, "corellia").load(key(10)));
+}
+
+/*! Only the files of the zone that belong to no current key are deleted,
+* other zones and unrelated files in the directory are kept.
+*/
+TEST_F(ResourceMapCacheTest, RemovesOnlyTheZonesSupersededMaps) {
+    ResourceMapCache naboo(directory_, "naboo");
+    ResourceMapCache corellia(directory_, "corellia");
+
+    store(naboo, key(10), 1.0f);
+    store(naboo, key(11), 1.0f);
+    store(corellia, key(10), 1.0f);
+
+    const char* others[] = { "naboo_notes.txt", "naboo_2_12_ab.rmap" };
+    for (size_t i = 0; i < 2; ++i) {
+        track(others[i]);
+        std::ofstream((directory_ + "/" + others[i]).c_str()) << "x";
+    }
+
+    naboo.removeSuperseded(std::vector<ResourceMapKey>(1, key(11)));
+
+    EXPECT_FALSE(naboo.load(key(10)));
+    EXPECT_TRUE(naboo.load(key(11)) != nullptr);
+    EXPECT_TRUE(corellia.load(key(10)) != nullptr);
+    EXPECT_EQ(2u, countFiles(directory_, others, 2));
+}
+
+}
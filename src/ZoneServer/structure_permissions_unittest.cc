@@ -0,0 +1,151 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/StructurePermissions.h"
+
+#include <gtest/gtest.h>
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+const uint64 kOwner = 1000;
+
+// the return codes of sf_CheckPermissionList
+const uint32 kOnList = 0;
+const uint32 kNotOnList = 2;
+const uint32 kOwnerCode = 3;
+
+/*! The lists of a structure the way structure_admin_data loads them: an
+* admin, a friend on the entry list and a banned character.
+*/
+StructurePermissions loadedPermissions() {
+    StructurePermissions permissions;
+
+    permissions.addPermission(StructurePermission_Admin, 10, "Admin");
+    permissions.addPermission(StructurePermission_Entry, 20, "Friend");
+    permissions.addPermission(StructurePermission_Ban, 30, "Pest");
+    permissions.addPermission(StructurePermission_Hopper, 40, "Crafter");
+    permissions.setPermissionsLoaded(true);
+
+    return permissions;
+}
+
+/*! The list names the commands and the db use map to the lists, in any case.
+*/
+TEST(StructurePermissionsTests, MapsListNames) {
+    StructurePermissionList list = StructurePermission_Count;
+
+    EXPECT_TRUE(StructurePermissions::getPermissionList("ADMIN", list));
+    EXPECT_EQ(StructurePermission_Admin, list);
+    EXPECT_TRUE(StructurePermissions::getPermissionList("entry", list));
+    EXPECT_EQ(StructurePermission_Entry, list);
+    EXPECT_TRUE(StructurePermissions::getPermissionList("Ban", list));
+    EXPECT_EQ(StructurePermission_Ban, list);
+    EXPECT_TRUE(StructurePermissions::getPermissionList("HOPPER", list));
+    EXPECT_EQ(StructurePermission_Hopper, list);
+
+    EXPECT_FALSE(StructurePermissions::getPermissionList("VENDOR", list));
+    EXPECT_FALSE(StructurePermissions::getPermissionList("", list));
+}
+
+/*! checkPermission answers with the codes sf_CheckPermissionList returns:
+* 3 for the owner, 0 for a name on the list, 2 otherwise. Admins pass the
+* entry list, names are compared case insensitive.
+*/
+TEST(StructurePermissionsTests, AnswersLikeCheckPermissionList) {
+    StructurePermissions permissions = loadedPermissions();
+
+    struct Case {
+        StructurePermissionList list;
+        uint64 player_id;
+        const char* name;
+        uint32 expected;
+    } cases[] = {
+        { StructurePermission_Admin,  kOwner, "Owner",   kOwnerCode },
+        { StructurePermission_Ban,    kOwner, "Owner",   kOwnerCode },
+        { StructurePermission_Admin,  10,     "Admin",   kOnList },
+        { StructurePermission_Admin,  10,     "aDMIN",   kOnList },
+        { StructurePermission_Admin,  20,     "Friend",  kNotOnList },
+        { StructurePermission_Entry,  20,     "Friend",  kOnList },
+        { StructurePermission_Entry,  10,     "Admin",   kOnList },
+        { StructurePermission_Entry,  30,     "Pest",    kNotOnList },
+        { StructurePermission_Ban,    30,     "pest",    kOnList },
+        { StructurePermission_Ban,    10,     "Admin",   kNotOnList },
+        { StructurePermission_Hopper, 40,     "Crafter", kOnList },
+        { StructurePermission_Hopper, 10,     "Admin",   kNotOnList },
+        { StructurePermission_Admin,  99,     "Stranger", kNotOnList },
+        // found by name alone, the id of a name added before the reload is not known yet
+        { StructurePermission_Entry,  0,      "Friend",  kOnList },
+        // and by id alone
+        { StructurePermission_Entry,  20,     "",        kOnList },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        EXPECT_EQ(cases[i].expected, permissions.checkPermission(kOwner, cases[i].list, cases[i].player_id, cases[i].name))
+            << "case " << i;
+    }
+}
+
+/*! Removing a name drops its id with it, so the character is off the list
+* whichever key the next check uses.
+*/
+TEST(StructurePermissionsTests, RemoveDropsIdAndName) {
+    StructurePermissions permissions = loadedPermissions();
+
+    permissions.removePermission(StructurePermission_Entry, "FRIEND");
+
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Entry, 20, ""));
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Entry, 0, "Friend"));
+    EXPECT_EQ(kNotOnList, permissions.checkPermission(kOwner, StructurePermission_Entry, 20, "Friend"));
+
+    // the other lists are untouched, removing an unknown name is harmless
+    permissions.removePermission(StructurePermission_Ban, "Nobody");
+    EXPECT_TRUE(permissions.isOnPermissionList(StructurePermission_Ban, 30, ""));
+    EXPECT_TRUE(permissions.isOnPermissionList(StructurePermission_Admin, 0, "Admin"));
+}
+
+/*! A name added without its id gets the id when the lists are read in again,
+* removing the name afterwards removes both.
+*/
+TEST(StructurePermissionsTests, AddKeepsIdAndNameInSync) {
+    StructurePermissions permissions = loadedPermissions();
+
+    permissions.addPermission(StructurePermission_Entry, 0, "Newcomer");
+    EXPECT_TRUE(permissions.isOnPermissionList(StructurePermission_Entry, 0, "newcomer"));
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Entry, 50, ""));
+
+    permissions.addPermission(StructurePermission_Entry, 50, "Newcomer");
+    EXPECT_TRUE(permissions.isOnPermissionList(StructurePermission_Entry, 50, ""));
+
+    permissions.removePermission(StructurePermission_Entry, "Newcomer");
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Entry, 50, ""));
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Entry, 0, "Newcomer"));
+
+    // a name that now belongs to another character doesn't leave the old id behind
+    permissions.addPermission(StructurePermission_Ban, 31, "Pest");
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Ban, 30, ""));
+    EXPECT_TRUE(permissions.isOnPermissionList(StructurePermission_Ban, 31, ""));
+
+    permissions.removePermission(StructurePermission_Ban, "Pest");
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Ban, 31, ""));
+}
+
+/*! Resetting empties every list, as a reload starts from scratch.
+*/
+TEST(StructurePermissionsTests, ResetEmptiesEveryList) {
+    StructurePermissions permissions = loadedPermissions();
+
+    permissions.resetPermissions();
+
+    for (uint32 list = 0; list < StructurePermission_Count; ++list) {
+        for (uint64 id = 10; id <= 40; id += 10) {
+            EXPECT_FALSE(permissions.isOnPermissionList(static_cast<StructurePermissionList>(list), id, ""));
+        }
+    }
+
+    EXPECT_FALSE(permissions.isOnPermissionList(StructurePermission_Admin, 0, "Admin"));
+    EXPECT_TRUE(permissions.getPermissionsLoaded());
+}
+
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2010 ApathyStudios. All rights reserved.
+// Use of this source code is governed by a GPL-style license that can be
+// found in the COPYING file.
+
+#include "ZoneServer/WorldContext.h"
+
+#include <boost/thread/thread.hpp>
+#include <gtest/gtest.h>
+
+using zone::ScopedWorldContext;
+using zone::WorldContext;
+
+// Wrapping tests in an anonymous namespace prevents potential name conflicts
+namespace {
+
+WorldManager* fakeWorldManager(uintptr_t id) {
+    return reinterpret_cast<WorldManager*>(id);
+}
+
+/*! A thread that never bound a context uses the process default.
+*/
+TEST(WorldContextTests, UnboundThreadsUseTheDefault) {
+    EXPECT_EQ(WorldContext::Default(), WorldContext::Current());
+
+    WorldContext* current = nullptr;
+    boost::thread thread([&current] { current = WorldContext::Current(); });
+    thread.join();
+
+    EXPECT_EQ(WorldContext::Default(), current);
+}
+
+/*! A scoped binding lasts for its scope and restores the previous one, nested
+* bindings included.
+*/
+TEST(WorldContextTests, ScopedBindingRestoresThePreviousContext) {
+    WorldContext rori;
+    WorldContext talus;
+
+    {
+        ScopedWorldContext bind_rori(&rori);
+        EXPECT_EQ(&rori, WorldContext::Current());
+
+        {
+            ScopedWorldContext bind_talus(&talus);
+            EXPECT_EQ(&talus, WorldContext::Current());
+        }
+
+        EXPECT_EQ(&rori, WorldContext::Current());
+    }
+
+    EXPECT_EQ(WorldContext::Default(), WorldContext::Current());
+}
+
+/*! Threads bound to different worlds see their own managers, binding one
+* thread leaves the others alone.
+*/
+TEST(WorldContextTests, ThreadsSeeTheirOwnWorld) {
+    WorldContext rori;
+    WorldContext talus;
+    rori.world_manager(fakeWorldManager(0x10));
+    talus.world_manager(fakeWorldManager(0x20));
+
+    WorldManager* seen_rori = nullptr;
+    WorldManager* seen_talus = nullptr;
+
+    boost::thread rori_thread([&] {
+        ScopedWorldContext bind(&rori);
+        seen_rori = WorldContext::Current()->world_manager();
+    });
+
+    boost::thread talus_thread([&] {
+        ScopedWorldContext bind(&talus);
+        seen_talus = WorldContext::Current()->world_manager();
+    });
+
+    rori_thread.join();
+    talus_thread.join();
+
+    EXPECT_EQ(fakeWorldManager(0x10), seen_rori);
+    EXPECT_EQ(fakeWorldManager(0x20), seen_talus);
+    EXPECT_EQ(WorldContext::Default(), WorldContext::Current());
+}
+
+/*! Binding the default is the same as not binding at all.
+*/
+TEST(WorldContextTests, BindingTheDefaultUnbinds) {
+    WorldContext rori;
+
+    WorldContext::Bind(&rori);
+    EXPECT_EQ(&rori, WorldContext::Current());
+
+    WorldContext::Bind(WorldContext::Default());
+    EXPECT_EQ(WorldContext::Default(), WorldContext::Current());
+
+    WorldContext::Bind(nullptr);
+    EXPECT_EQ(WorldContext::Default(), WorldContext::Current());
+}
+
+}
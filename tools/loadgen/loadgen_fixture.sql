@@ -0,0 +1,65 @@
+--
+-- Bot accounts and characters for the LoadGenerator.
+--
+-- Load into the galaxy schema (swganh by default) and run
+--
+--     CALL sp_LoadGenCreateBots(1000, 'loadbot', 'loadbot', 'tatooine');
+--
+-- Creates <prefix>0 .. <prefix>N-1 accounts with one character each through the
+-- same sp_CharacterCreate path the ChatServer uses, so the characters are real
+-- and zone in like any other. Existing bot accounts are left untouched, which
+-- makes the call safe to repeat with a larger count.
+--
+-- The servers write their message counters into server_counters every
+-- CounterInterval seconds, the LoadGenerator reports the rates from them.
+--
+
+CREATE TABLE IF NOT EXISTS server_counters (
+    server_name VARCHAR(32) NOT NULL PRIMARY KEY,
+    messages_received BIGINT UNSIGNED NOT NULL,
+    messages_sent BIGINT UNSIGNED NOT NULL,
+    sample_time BIGINT UNSIGNED NOT NULL
+);
+
+DELIMITER //
+
+DROP PROCEDURE IF EXISTS sp_LoadGenCreateBots//
+
+CREATE PROCEDURE sp_LoadGenCreateBots(IN bot_count INT, IN prefix VARCHAR(24), IN pass VARCHAR(32), IN start_city VARCHAR(32))
+BEGIN
+    DECLARE i INT DEFAULT 0;
+    DECLARE bot_account INT;
+    DECLARE bot_name VARCHAR(32);
+
+    WHILE i < bot_count DO
+        SET bot_name = CONCAT(prefix, i);
+
+        IF NOT EXISTS (SELECT 1 FROM account WHERE account_username = bot_name) THEN
+            INSERT INTO account (account_username, account_password, account_station_id, account_banned, account_active,
+                                 account_characters_allowed, account_session_key, account_csr, account_authenticated, account_loggedin)
+            VALUES (bot_name, SHA1(pass), 0, 0, 1, 2, '', 0, 0, 0);
+
+            SET bot_account = LAST_INSERT_ID();
+
+            -- character names only allow letters, so encode the index as letters
+            SET @bot_first = CONCAT('Bot', REPLACE(REPLACE(REPLACE(REPLACE(REPLACE(REPLACE(REPLACE(REPLACE(REPLACE(REPLACE(
+                             CAST(i AS CHAR), '0', 'a'), '1', 'b'), '2', 'c'), '3', 'd'), '4', 'e'), '5', 'f'), '6', 'g'), '7', 'h'), '8', 'i'), '9', 'j'));
+
+            -- sp_CharacterCreate takes 115 appearance values followed by hair and base model
+            SET @bot_sql = CONCAT('CALL sp_CharacterCreate(', bot_account, ', 2, ''', @bot_first, ''', NULL, ''crafting_artisan'', ''',
+                                  start_city, ''', 1.0, NULL', REPEAT(', 0', 115),
+                                  ', NULL, 0, 0, ''object/creature/player/shared_human_male.iff'');');
+
+            PREPARE bot_stmt FROM @bot_sql;
+            EXECUTE bot_stmt;
+            DEALLOCATE PREPARE bot_stmt;
+        END IF;
+
+        SET i = i + 1;
+    END WHILE;
+
+    -- a previous aborted run may have left the accounts flagged as online
+    UPDATE account SET account_authenticated = 0, account_loggedin = 0 WHERE account_username LIKE CONCAT(prefix, '%');
+END//
+
+DELIMITER ;